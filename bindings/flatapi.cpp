@@ -24,6 +24,7 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <algorithm>
 
 #include <swversion.h>
 #include <swmgr.h>
@@ -35,6 +36,7 @@
 #include <stringmgr.h>
 #include <swbuf.h>
 #include <swlog.h>
+#include <swmetrics.h>
 #include <localemgr.h>
 #include <utilstr.h>
 #include <rtfhtml.h>
@@ -53,6 +55,7 @@ using sword::VerseKey;
 using sword::SWVersion;
 using sword::SWBuf;
 using sword::TreeKeyIdx;
+using sword::SWMetrics;
 
 
 #define GETSWMGR(handle, failReturn) HandleSWMgr *hmgr = (HandleSWMgr *)handle; if (!hmgr) return failReturn; WebMgr *mgr = hmgr->mgr; if (!mgr) return failReturn;
@@ -64,38 +67,233 @@ using sword::TreeKeyIdx;
 namespace {
 
 
-void clearStringArray(const char ***stringArray) {
-	if (*stringArray) {
-		for (int i = 0; true; ++i) {
-			if ((*stringArray)[i]) {
-				delete [] (*stringArray)[i];
-			}
-			else break;
+// Return values are built in per-handle arenas, one for each call which
+// returns them: the next call clears its arena and builds in the room the
+// last one left, so once warmed up a call allocates nothing.  Strings are
+// kept back to back in one buffer, which the *Table calls hand out as is.
+class StringTable {
+	std::vector<char> strings;
+	std::vector<long> offsets;
+	std::vector<const char *> array;
+	org_crosswire_sword_StringTable table;
+	SWBuf fixed;
+
+public:
+	StringTable() {
+		table.count = 0;
+		table.strings = "";
+		table.offsets = 0;
+	}
+
+	void clear() {
+		strings.clear();
+		offsets.clear();
+		array.clear();
+	}
+
+	// copies a string in and returns its index
+	int add(const char *s, unsigned long len) {
+		offsets.push_back((long)strings.size());
+		strings.insert(strings.end(), s, s + len);
+		strings.push_back(0);
+		return (int)offsets.size() - 1;
+	}
+	int add(const char *s) { return add(s, strlen(s)); }
+	int add(const SWBuf &s) { return add(s.c_str(), s.length()); }
+
+	// as add, with any bytes which aren't UTF-8 replaced; valid text isn't copied twice
+	int addUTF8(const char *s) { return add(assureValidUTF8(s, fixed)); }
+
+	int size() const { return (int)offsets.size(); }
+
+	// only good until the next add or clear; 0 for index -1
+	const char *get(int i) const { return (i < 0) ? 0 : &strings[offsets[i]]; }
+
+	// every string, in an array ended by 0
+	const char **getArray() {
+		array.resize(offsets.size() + 1);
+		for (unsigned int i = 0; i < offsets.size(); ++i) {
+			array[i] = &strings[offsets[i]];
 		}
-		free((*stringArray));
-		(*stringArray) = 0;
+		array[offsets.size()] = 0;
+		return &array[0];
+	}
+
+	const org_crosswire_sword_StringTable *getTable() {
+		table.count = size();
+		table.strings = (strings.size()) ? &strings[0] : "";
+		table.offsets = (offsets.size()) ? &offsets[0] : 0;
+		return &table;
+	}
+};
+
+
+class SearchHitList {
+	StringTable keys;
+	std::vector<long> scores;
+	std::vector<org_crosswire_sword_SearchHit> hits;
+	org_crosswire_sword_SearchHitTable table;
+
+public:
+	SearchHitList() { clear(); }
+
+	void clear() {
+		keys.clear();
+		scores.clear();
+		table.modName = 0;
+	}
+
+	void add(const char *modName, const char *key, long score) {
+		table.modName = modName;
+		keys.addUTF8(key);
+		scores.push_back(score);
+	}
+
+	// an array ended by a hit with a null modName
+	const org_crosswire_sword_SearchHit *getHits() {
+		hits.resize(scores.size() + 1);
+		for (unsigned int i = 0; i < scores.size(); ++i) {
+			// don't alloc this; we have a persistent const char * in SWModule we can just reference
+			hits[i].modName = table.modName;
+			hits[i].key = (char *)keys.get(i);
+			hits[i].score = scores[i];
+		}
+		memset(&hits[scores.size()], 0, sizeof(org_crosswire_sword_SearchHit));
+		return &hits[0];
+	}
+
+	// the same hits, in the same storage
+	const org_crosswire_sword_SearchHitTable *getTable() {
+		table.keys = *keys.getTable();
+		table.scores = (scores.size()) ? &scores[0] : 0;
+		return &table;
+	}
+};
+
+
+class ModInfoList {
+	struct Fields {
+		int name, description, category, language, version, delta, cipherKey;
+		int firstFeature, featureCount;
+	};
+	StringTable strings;
+	std::vector<Fields> fields;
+	std::vector<org_crosswire_sword_ModInfo> infos;
+	std::vector<const char *> features;
+
+public:
+	void clear() {
+		strings.clear();
+		fields.clear();
 	}
-}
 
+	void add(SWModule *module, const char *delta) {
+		SWBuf type = module->getType();
+		SWBuf cat = module->getConfigEntry("Category");
+		SWBuf version = module->getConfigEntry("Version");
+		if (cat.length() > 0) type = cat;
 
-void clearModInfoArray(org_crosswire_sword_ModInfo **modInfo) {
-	if (*modInfo) {
-		for (int i = 0; true; ++i) {
-			if ((*modInfo)[i].name) {
-				delete [] (*modInfo)[i].name;
-				delete [] (*modInfo)[i].description;
-				delete [] (*modInfo)[i].category;
-				delete [] (*modInfo)[i].language;
-				delete [] (*modInfo)[i].version;
-				delete [] (*modInfo)[i].delta;
-				delete [] (*modInfo)[i].cipherKey;
-				clearStringArray(&((*modInfo)[i].features));
+		Fields f;
+		f.name = strings.addUTF8(module->getName());
+		f.description = strings.addUTF8(module->getDescription());
+		f.category = strings.addUTF8(type.c_str());
+		f.language = strings.addUTF8(module->getLanguage());
+		f.version = strings.addUTF8(version.c_str());
+		f.delta = strings.addUTF8(delta);
+		const char *cipherKey = module->getConfigEntry("CipherKey");
+		f.cipherKey = (cipherKey) ? strings.addUTF8(cipherKey) : -1;
+
+		ConfigEntMap::const_iterator start = module->getConfig().lower_bound("Feature");
+		ConfigEntMap::const_iterator end   = module->getConfig().upper_bound("Feature");
+		f.firstFeature = strings.size();
+		for (ConfigEntMap::const_iterator it = start; it != end; ++it) {
+			strings.addUTF8(it->second);
+		}
+		f.featureCount = strings.size() - f.firstFeature;
+		fields.push_back(f);
+	}
+
+	// an array ended by an entry with a null name
+	const org_crosswire_sword_ModInfo *getInfos() {
+		// each module's features, each list ended by 0
+		features.clear();
+		for (unsigned int i = 0; i < fields.size(); ++i) {
+			for (int j = 0; j < fields[i].featureCount; ++j) {
+				features.push_back(strings.get(fields[i].firstFeature + j));
 			}
-			else break;
+			features.push_back(0);
+		}
+
+		infos.resize(fields.size() + 1);
+		const char **featureList = (features.size()) ? &features[0] : 0;
+		for (unsigned int i = 0; i < fields.size(); ++i) {
+			const Fields &f = fields[i];
+			infos[i].name = (char *)strings.get(f.name);
+			infos[i].description = (char *)strings.get(f.description);
+			infos[i].category = (char *)strings.get(f.category);
+			infos[i].language = (char *)strings.get(f.language);
+			infos[i].version = (char *)strings.get(f.version);
+			infos[i].delta = (char *)strings.get(f.delta);
+			infos[i].cipherKey = (char *)strings.get(f.cipherKey);
+			infos[i].features = featureList;
+			featureList += f.featureCount + 1;
+		}
+		memset(&infos[fields.size()], 0, sizeof(org_crosswire_sword_ModInfo));
+		return &infos[0];
+	}
+};
+
+
+class MetricsSampleList {
+	StringTable strings;
+	std::vector<unsigned long> values;
+	std::vector<org_crosswire_sword_MetricsSample> samples;
+
+public:
+	const org_crosswire_sword_MetricsSample *getSamples(const SWMetrics::Snapshot &snapshot) {
+		strings.clear();
+		values.clear();
+		for (unsigned int i = 0; i < snapshot.size(); ++i) {
+			strings.addUTF8(snapshot[i].owner.c_str());
+			strings.add(snapshot[i].filter.c_str());
+			strings.add(snapshot[i].name.c_str());
+			values.push_back(snapshot[i].value);
 		}
-		free((*modInfo));
-		(*modInfo) = 0;
+		samples.resize(values.size() + 1);
+		for (unsigned int i = 0; i < values.size(); ++i) {
+			samples[i].owner = (char *)strings.get(i * 3);
+			samples[i].filter = (char *)strings.get(i * 3 + 1);
+			samples[i].name = (char *)strings.get(i * 3 + 2);
+			samples[i].value = values[i];
+		}
+		memset(&samples[values.size()], 0, sizeof(org_crosswire_sword_MetricsSample));
+		return &samples[0];
 	}
+};
+
+
+// orders entry attributes by type, item and name, as the maps of
+// getEntryAttributes() do
+class AttributeOrder {
+	const EntryAttributeStore &attributes;
+
+public:
+	AttributeOrder(const EntryAttributeStore &attributes) : attributes(attributes) {}
+
+	bool operator ()(unsigned long a, unsigned long b) const {
+		int c = strcmp(attributes.getType(a), attributes.getType(b));
+		if (!c) c = strcmp(attributes.getItem(a), attributes.getItem(b));
+		if (!c) c = strcmp(attributes.getName(a), attributes.getName(b));
+		return c < 0;
+	}
+};
+
+
+// buf, with any bytes which aren't UTF-8 replaced; copied only to fix it
+const char *validUTF8(SWBuf &buf) {
+	SWBuf fixed;
+	if (assureValidUTF8(buf.c_str(), fixed) != buf.c_str()) buf = fixed;
+	return buf.c_str();
 }
 
 
@@ -107,7 +305,7 @@ struct pu {
 void percentUpdate(char percent, void *userData) {
 	struct pu *p = (struct pu *)userData;
 
-	if (percent != p->last) {
+	if (p->progressReporter && percent != p->last) {
 		p->progressReporter((int)percent);
 		p->last = percent;
 	}
@@ -193,57 +391,55 @@ public:
 class HandleSWModule {
 public:
 	SWModule *mod;
-	char *renderBuf;
-	char *stripBuf;
-	char *renderHeader;
-	char *rawEntry;
-	char *configEntry;
+	SWBuf renderBuf;
+	SWBuf stripBuf;
+	SWBuf renderHeader;
+	SWBuf rawEntry;
+	SWBuf configEntry;
 	struct pu peeuuu;
-	org_crosswire_sword_SearchHit *searchHits;
-	const char **entryAttributes;
-	const char **parseKeyList;
-	const char **keyChildren;
-
-	HandleSWModule(SWModule *mod) : searchHits(0), entryAttributes(0), parseKeyList(0), keyChildren(0) {
+	SearchHitList searchHits;
+	StringTable entryAttributes;
+	StringTable parseKeyList;
+	StringTable keyChildren;
+
+	// the paged search in progress, see searchPage / searchNextPage
+	SearchCursor searchCursor;
+	SWBuf searchString;
+	int searchType;
+	long searchFlags;
+	ListKey searchScope;
+	bool searchScoped;
+	org_crosswire_sword_SWModule_SearchHitCallback hitReporter;
+
+	HandleSWModule(SWModule *mod) : searchType(0), searchFlags(0), searchScoped(false), hitReporter(0) {
 		this->mod = mod;
-		this->renderBuf = 0;
-		this->stripBuf = 0;
-		this->renderHeader = 0;
-		this->rawEntry = 0;
-		this->configEntry = 0;
-	}
-	~HandleSWModule() {
-		delete [] renderBuf;
-		delete [] stripBuf;
-		delete [] renderHeader;
-		delete [] rawEntry;
-		delete [] configEntry;
-		clearSearchHits();
-		clearEntryAttributes();
-		clearParseKeyList();
-		clearKeyChildren();
-	}
-
-	void clearSearchHits() {
-		if (searchHits) {
-			for (int i = 0; true; ++i) {
-				if (searchHits[i].modName) {
-					delete [] searchHits[i].key;
-				}
-				else break;
-			}
-			free(searchHits);
-			searchHits = 0;
-		}
 	}
-	void clearEntryAttributes() {
-		clearStringArray(&entryAttributes);
-	}
-	void clearParseKeyList() {
-		clearStringArray(&parseKeyList);
+
+	void setSearchHits(ListKey &result) {
+		searchHits.clear();
+
+		int count = 0;
+		for (result = sword::TOP; !result.popError(); result++) count++;
+
+		// if we're sorted by score, let's re-sort by verse, because Java can always re-sort by score
+		result = sword::TOP;
+		if ((count) && (long)result.getElement()->userData)
+			result.sort();
+
+		int i = 0;
+		for (result = sword::TOP; !result.popError(); result++) {
+			searchHits.add(mod->getName(), result.getShortText(), (long)result.getElement()->userData);
+			// in case we limit count to a max number of hits
+			if (++i >= count) break;
+		}
 	}
-	void clearKeyChildren() {
-		clearStringArray(&keyChildren);
+	static bool reportHit(const SWKey &hit, void *userData) {
+		HandleSWModule *hmod = (HandleSWModule *)userData;
+		if (hmod->hitReporter) {
+			SWBuf fixed;
+			hmod->hitReporter(hmod->mod->getName(), assureValidUTF8(hit.getShortText(), fixed), (long)hit.userData);
+		}
+		return true;
 	}
 };
 
@@ -251,24 +447,18 @@ public:
 class HandleSWMgr {
 public:
 	WebMgr *mgr;
-	org_crosswire_sword_ModInfo *modInfo;
+	ModInfoList modInfo;
 	std::map<SWModule *, HandleSWModule *> moduleHandles;
 	SWBuf filterBuf;
-	static const char **globalOptions;
-	static const char **globalOptionValues;
-	static const char **availableLocales;
+	static StringTable globalOptions;
+	static StringTable globalOptionValues;
+	static StringTable availableLocales;
 
 	HandleSWMgr(WebMgr *mgr) {
 		this->mgr = mgr;
-		this->modInfo = 0;
-	}
-
-	void clearModInfo() {
-		clearModInfoArray(&modInfo);
 	}
 
 	~HandleSWMgr() {
-		clearModInfo();
 		for (std::map<SWModule *, HandleSWModule *>::const_iterator it = moduleHandles.begin(); it != moduleHandles.end(); ++it) {
 			delete it->second;
 		}
@@ -282,37 +472,23 @@ public:
 		}
 		return moduleHandles[mod];
 	}
-
-	static void clearGlobalOptions() {
-		clearStringArray(&globalOptions);
-	}
-
-	static void clearGlobalOptionValues() {
-		clearStringArray(&globalOptionValues);
-	}
-
-	static void clearAvailableLocales() {
-		clearStringArray(&availableLocales);
-	}
 };
 
 
 class HandleInstMgr {
 public:
-	static const char **remoteSources;
+	static StringTable remoteSources;
 	InstallMgr *installMgr;
-	org_crosswire_sword_ModInfo *modInfo;
+	ModInfoList modInfo;
 	std::map<SWModule *, HandleSWModule *> moduleHandles;
 
 	MyStatusReporter statusReporter;
-	HandleInstMgr() : installMgr(0), modInfo(0) {}
+	HandleInstMgr() : installMgr(0) {}
 	HandleInstMgr(InstallMgr *mgr) {
 		this->installMgr = mgr;
-		this->modInfo = 0;
 	}
 
 	~HandleInstMgr() {
-		clearModInfo();
 		for (std::map<SWModule *, HandleSWModule *>::const_iterator it = moduleHandles.begin(); it != moduleHandles.end(); ++it) {
 			delete it->second;
 		}
@@ -326,14 +502,6 @@ public:
 		}
 		return moduleHandles[mod];
 	}
-
-	static void clearRemoteSources() {
-		clearStringArray(&remoteSources);
-	}
-
-	void clearModInfo() {
-		clearModInfoArray(&modInfo);
-	}
 };
 
 org_crosswire_sword_StringMgr_toUpperUTF8 toUpperUTF8 = 0;
@@ -351,38 +519,22 @@ protected:
 };
 
 
-const char **HandleSWMgr::globalOptions = 0;
-const char **HandleSWMgr::globalOptionValues = 0;
-const char **HandleSWMgr::availableLocales = 0;
+StringTable HandleSWMgr::globalOptions;
+StringTable HandleSWMgr::globalOptionValues;
+StringTable HandleSWMgr::availableLocales;
 
-const char **HandleInstMgr::remoteSources = 0;
+StringTable HandleInstMgr::remoteSources;
 
-const char **tmpStringArrayRetVal = 0;
-char *tmpStringRetVal = 0;
+StringTable tmpStringArrayRetVal;
+SWBuf tmpStringRetVal;
+MetricsSampleList metricsSnapshot;
 
 class InitStatics {
 public:
 	InitStatics() {
 
-		HandleSWMgr::globalOptions = 0;
-		HandleSWMgr::globalOptionValues = 0;
-		HandleSWMgr::availableLocales = 0;
-
-		HandleInstMgr::remoteSources = 0;
-
 		if (!StringMgr::hasUTF8Support()) StringMgr::setSystemStringMgr(new FlatStringMgr());
 	}
-	~InitStatics() {
-
-		HandleSWMgr::clearGlobalOptions();
-		HandleSWMgr::clearGlobalOptionValues();
-
-		HandleInstMgr::clearRemoteSources();
-
-		clearStringArray(&tmpStringArrayRetVal);
-		sword::stdstr(&tmpStringRetVal, (const char *)0);
-		
-	}
 } _initStatics;
 
 
@@ -422,6 +574,37 @@ int SWDLLEXPORT org_crosswire_sword_SWLog_getLogLevel() {
 }
 
 
+//
+// SWMetrics methods
+//
+//
+
+void SWDLLEXPORT org_crosswire_sword_SWMetrics_setEnabled(char enabled) {
+	SWMetrics::setEnabled(enabled);
+}
+
+char SWDLLEXPORT org_crosswire_sword_SWMetrics_isEnabled() {
+	return SWMetrics::isEnabled();
+}
+
+void SWDLLEXPORT org_crosswire_sword_SWMetrics_reset() {
+	SWMetrics::reset();
+}
+
+void SWDLLEXPORT org_crosswire_sword_SWMetrics_setReportInterval(unsigned long seconds) {
+	SWMetrics::setReportInterval(seconds);
+}
+
+const struct org_crosswire_sword_MetricsSample * SWDLLEXPORT org_crosswire_sword_SWMetrics_getSnapshot() {
+	return metricsSnapshot.getSamples(SWMetrics::getSnapshot());
+}
+
+const char * SWDLLEXPORT org_crosswire_sword_SWMetrics_getReport() {
+	tmpStringRetVal = SWMetrics::getReport();
+	return validUTF8(tmpStringRetVal);
+}
+
+
 //
 // SWModule methods
 //
@@ -450,7 +633,7 @@ const struct org_crosswire_sword_SearchHit * SWDLLEXPORT org_crosswire_sword_SWM
 
 	GETSWMODULE(hSWModule, 0);
 
-	hmod->clearSearchHits();
+	hmod->searchHits.clear();
 
 	sword::ListKey lscope;
 	sword::ListKey result;
@@ -471,27 +654,90 @@ const struct org_crosswire_sword_SearchHit * SWDLLEXPORT org_crosswire_sword_SWM
 	}
 	else	result = module->search(searchString, searchType, flags, 0, 0, &percentUpdate, &(hmod->peeuuu));
 
-	int count = 0;
-	for (result = sword::TOP; !result.popError(); result++) count++;
+	hmod->setSearchHits(result);
+	return hmod->searchHits.getHits();
+}
+
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    searchPage
+ * Signature: (Ljava/lang/String;IJLjava/lang/String;IJLorg/crosswire/sword/SWModule/SearchHitReporter;Lorg/crosswire/sword/SWModule/SearchProgressReporter;)[Lorg/crosswire/sword/SWModule/SearchHit;
+ */
+const struct org_crosswire_sword_SearchHit * SWDLLEXPORT org_crosswire_sword_SWModule_searchPage
+  (SWHANDLE hSWModule, const char *searchString, int searchType, long flags, const char *scope, int maxHits, long timeBudgetMillis, org_crosswire_sword_SWModule_SearchHitCallback hitReporter, org_crosswire_sword_SWModule_SearchCallback progressReporter) {
+
+	GETSWMODULE(hSWModule, 0);
 
-	// if we're sorted by score, let's re-sort by verse, because Java can always re-sort by score
-	result = sword::TOP;
-	if ((count) && (long)result.getElement()->userData)
-		result.sort();
+	hmod->searchCursor.reset();
+	hmod->searchString = searchString;
+	hmod->searchType = searchType;
+	hmod->searchFlags = flags;
+	hmod->searchScope.clear();
+	hmod->searchScoped = false;
 
-	struct org_crosswire_sword_SearchHit *retVal = (struct org_crosswire_sword_SearchHit *)calloc(count+1, sizeof(struct org_crosswire_sword_SearchHit));
-	
-	int i = 0;
-	for (result = sword::TOP; !result.popError(); result++) {
-		// don't alloc this; we have a persistent const char * in SWModule we can just reference
-		retVal[i].modName = module->getName();
-		stdstr(&(retVal[i].key), assureValidUTF8(result.getShortText()));
-		retVal[i++].score = (long)result.getElement()->userData;
-		// in case we limit count to a max number of hits
-		if (i >= count) break;
-	}
-	hmod->searchHits = retVal;
-	return retVal;
+	if ((scope) && (strlen(scope)) > 0) {
+		sword::SWKey *p = module->createKey();
+		sword::VerseKey *parser = SWDYNAMIC_CAST(VerseKey, p);
+		if (!parser) {
+			delete p;
+			parser = new VerseKey();
+		}
+		*parser = module->getKeyText();
+		hmod->searchScope = parser->parseVerseList(scope, *parser, true);
+		hmod->searchScoped = true;
+		delete parser;
+	}
+
+	return org_crosswire_sword_SWModule_searchNextPage(hSWModule, maxHits, timeBudgetMillis, hitReporter, progressReporter);
+}
+
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    searchNextPage
+ * Signature: (IJLorg/crosswire/sword/SWModule/SearchHitReporter;Lorg/crosswire/sword/SWModule/SearchProgressReporter;)[Lorg/crosswire/sword/SWModule/SearchHit;
+ */
+const struct org_crosswire_sword_SearchHit * SWDLLEXPORT org_crosswire_sword_SWModule_searchNextPage
+  (SWHANDLE hSWModule, int maxHits, long timeBudgetMillis, org_crosswire_sword_SWModule_SearchHitCallback hitReporter, org_crosswire_sword_SWModule_SearchCallback progressReporter) {
+
+	GETSWMODULE(hSWModule, 0);
+
+	hmod->peeuuu.init(progressReporter);
+	hmod->hitReporter = hitReporter;
+	hmod->searchCursor.maxHits = maxHits;
+	hmod->searchCursor.timeBudget = timeBudgetMillis;
+	hmod->searchCursor.hitCallback = &HandleSWModule::reportHit;
+	hmod->searchCursor.hitUserData = hmod;
+
+	sword::ListKey result = module->search(hmod->searchCursor, hmod->searchString, hmod->searchType, hmod->searchFlags, (hmod->searchScoped) ? &(hmod->searchScope) : 0, &percentUpdate, &(hmod->peeuuu));
+
+	hmod->setSearchHits(result);
+	return hmod->searchHits.getHits();
+}
+
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    getSearchHitTable
+ * Signature: ()Lorg/crosswire/sword/SWModule/SearchHitTable;
+ */
+const struct org_crosswire_sword_SearchHitTable * SWDLLEXPORT org_crosswire_sword_SWModule_getSearchHitTable
+  (SWHANDLE hSWModule) {
+
+	GETSWMODULE(hSWModule, 0);
+
+	return hmod->searchHits.getTable();
+}
+
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    isSearchComplete
+ * Signature: ()Z
+ */
+char SWDLLEXPORT org_crosswire_sword_SWModule_isSearchComplete
+  (SWHANDLE hSWModule) {
+
+	GETSWMODULE(hSWModule, 1);
+
+	return hmod->searchCursor.isComplete() ? 1 : 0;
 }
 
 /*
@@ -530,89 +776,76 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWModule_getEntryAttribute
 
 	GETSWMODULE(hSWModule, 0);
 
-	hmod->clearEntryAttributes();
+	hmod->entryAttributes.clear();
 
 	module->renderText();	// force parse
 	std::vector<SWBuf> results;
 
-	sword::AttributeTypeList &entryAttribs = module->getEntryAttributes();
-	sword::AttributeTypeList::const_iterator i1Start, i1End;
-	sword::AttributeList::const_iterator i2Start, i2End;
-	sword::AttributeValue::const_iterator i3Start, i3End;
-
-	if ((level1) && (*level1) && *level1 != '-') {
-		i1Start = entryAttribs.find(level1);
-		i1End = i1Start;
-		if (i1End != entryAttribs.end())
-			++i1End;
-	}
-	else {
-		i1Start = entryAttribs.begin();
-		i1End   = entryAttribs.end();
-	}
-	for (;i1Start != i1End; ++i1Start) {
-		if (level1 && *level1 && *level1 == '-') {
-			results.push_back(i1Start->first);
+	const EntryAttributeStore &attributes = module->getEntryAttributeStore();
+	bool listTypes = (level1 && *level1 == '-');
+	bool listItems = (!listTypes && level2 && *level2 == '-');
+	// allow '-' to get all keys; allow '*' to get all key=value
+	bool listNames = (level3 && *level3 == '-');
+	bool listPairs = (level3 && *level3 == '*');
+	const char *type = (level1 && *level1 && !listTypes) ? level1 : 0;
+	const char *item = (!listTypes && level2 && *level2 && !listItems) ? level2 : 0;
+	const char *name = (!listTypes && !listItems && level3 && *level3 && !listNames && !listPairs) ? level3 : 0;
+
+	// in the order of the maps these used to come from
+	std::vector<unsigned long> found;
+	for (unsigned long i = attributes.find(type, item, name); i < attributes.getCount(); i = attributes.find(type, item, name, i + 1)) {
+		found.push_back(i);
+	}
+	std::sort(found.begin(), found.end(), AttributeOrder(attributes));
+
+	const char *lastType = 0, *lastItem = 0;
+	for (unsigned long f = 0; f < found.size(); ++f) {
+		unsigned long i = found[f];
+		bool newType = (!lastType || strcmp(lastType, attributes.getType(i)));
+		bool newItem = (newType || strcmp(lastItem, attributes.getItem(i)));
+		lastType = attributes.getType(i);
+		lastItem = attributes.getItem(i);
+		if (listTypes) {
+			if (newType) results.push_back(lastType);
+		}
+		else if (listItems) {
+			if (newItem) results.push_back(lastItem);
+		}
+		else if (listNames) {
+			results.push_back(attributes.getName(i));
+		}
+		else if (listPairs) {
+			results.push_back(SWBuf(attributes.getName(i)) + "=" + SWBuf(attributes.getValue(i), attributes.getValueLength(i)));
 		}
 		else {
-			if (level2 && *level2 && *level2 != '-') {
-				i2Start = i1Start->second.find(level2);
-				i2End = i2Start;
-				if (i2End != i1Start->second.end())
-					++i2End;
-			}
-			else {
-				i2Start = i1Start->second.begin();
-				i2End   = i1Start->second.end();
-			}
-			for (;i2Start != i2End; ++i2Start) {
-				if (level2 && *level2 && *level2 == '-') {
-					results.push_back(i2Start->first);
-				}
-				else {
-					// allow '-' to get all keys; allow '*' to get all key=value
-					if (level3 && *level3 && *level3 != '-' && *level3 != '*') {
-						i3Start = i2Start->second.find(level3);
-						i3End = i3Start;
-						if (i3End != i2Start->second.end())
-							++i3End;
-					}
-					else {
-						i3Start = i2Start->second.begin();
-						i3End   = i2Start->second.end();
-					}
-					for (;i3Start != i3End; ++i3Start) {
-						if (level3 && *level3 && *level3 == '-') {
-							results.push_back(i3Start->first);
-						}
-						else if (level3 && *level3 && *level3 == '*') {
-							results.push_back(i3Start->first + "=" + i3Start->second);
-						}
-						else {
-							results.push_back(i3Start->second);
-						}
-					}
-					if (i3Start != i3End)
-						break;
-				}
-			}
-			if (i2Start != i2End)
-				break;
+			results.push_back(SWBuf(attributes.getValue(i), attributes.getValueLength(i)));
 		}
 	}
 
-	const char **retVal = (const char **)calloc(results.size()+1, sizeof(const char *));
 	for (int i = 0; i < (int)results.size(); i++) {
 		if (filteredBool) {
-			stdstr((char **)&(retVal[i]), assureValidUTF8(module->renderText(results[i].c_str())));
+			hmod->entryAttributes.addUTF8(module->renderText(results[i].c_str()));
 		}
 		else {
-			stdstr((char **)&(retVal[i]), assureValidUTF8(results[i].c_str()));
+			hmod->entryAttributes.addUTF8(results[i].c_str());
 		}
 	}
 
-	hmod->entryAttributes = retVal;
-	return retVal;
+	return hmod->entryAttributes.getArray();
+}
+
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    getEntryAttributeTable
+ * Signature: (Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Z)Lorg/crosswire/sword/StringTable;
+ */
+const struct org_crosswire_sword_StringTable * SWDLLEXPORT org_crosswire_sword_SWModule_getEntryAttributeTable
+  (SWHANDLE hSWModule, const char *level1, const char *level2, const char *level3, char filteredBool) {
+
+	GETSWMODULE(hSWModule, 0);
+
+	org_crosswire_sword_SWModule_getEntryAttribute(hSWModule, level1, level2, level3, filteredBool);
+	return hmod->entryAttributes.getTable();
 }
 
 /*
@@ -625,30 +858,35 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWModule_parseKeyList
 
 	GETSWMODULE(hSWModule, 0);
 
-	hmod->clearParseKeyList();
+	hmod->parseKeyList.clear();
 
 	sword::VerseKey *parser = dynamic_cast<VerseKey *>(module->getKey());
-	const char **retVal = 0;
 	if (parser) {
 		sword::ListKey result;
 		result = parser->parseVerseList(keyText, *parser, true);
-		int count = 0;
 		for (result = sword::TOP; !result.popError(); result++) {
-			count++;
-		}
-		retVal = (const char **)calloc(count+1, sizeof(const char *));
-		count = 0;
-		for (result = sword::TOP; !result.popError(); result++) {
-			stdstr((char **)&(retVal[count++]), assureValidUTF8(VerseKey(result).getOSISRef()));
+			hmod->parseKeyList.addUTF8(VerseKey(result).getOSISRef());
 		}
 	}
 	else	{
-		retVal = (const char **)calloc(2, sizeof(const char *));
-		stdstr((char **)&(retVal[0]), assureValidUTF8(keyText));
+		hmod->parseKeyList.addUTF8(keyText);
 	}
 
-	hmod->parseKeyList = retVal;
-	return retVal;
+	return hmod->parseKeyList.getArray();
+}
+
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    parseKeyListTable
+ * Signature: (Ljava/lang/String;)Lorg/crosswire/sword/StringTable;
+ */
+const struct org_crosswire_sword_StringTable * SWDLLEXPORT org_crosswire_sword_SWModule_parseKeyListTable
+  (SWHANDLE hSWModule, const char *keyText) {
+
+	GETSWMODULE(hSWModule, 0);
+
+	org_crosswire_sword_SWModule_parseKeyList(hSWModule, keyText);
+	return hmod->parseKeyList.getTable();
 }
 
 /*
@@ -737,63 +975,47 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWModule_getKeyChildren
 
 	GETSWMODULE(hSWModule, 0);
 
-	hmod->clearKeyChildren();
+	hmod->keyChildren.clear();
 
 	sword::SWKey *key = module->getKey();
-	const char **retVal = 0;
-	int count = 0;
 
 	sword::VerseKey *vkey = SWDYNAMIC_CAST(VerseKey, key);
 	if (vkey) {
-		retVal = (const char **)calloc(12, sizeof(const char *));
 		SWBuf num;
-		num.appendFormatted("%d", vkey->getTestament());
-		stdstr((char **)&(retVal[0]), num.c_str());
-		num = "";
-		num.appendFormatted("%d", vkey->getBook());
-		stdstr((char **)&(retVal[1]), num.c_str());
-		num = "";
-		num.appendFormatted("%d", vkey->getChapter());
-		stdstr((char **)&(retVal[2]), num.c_str());
-		num = "";
-		num.appendFormatted("%d", vkey->getVerse());
-		stdstr((char **)&(retVal[3]), num.c_str());
-		num = "";
-		num.appendFormatted("%d", vkey->getChapterMax());
-		stdstr((char **)&(retVal[4]), num.c_str());
-		num = "";
-		num.appendFormatted("%d", vkey->getVerseMax());
-		stdstr((char **)&(retVal[5]), num.c_str());
-		stdstr((char **)&(retVal[6]), vkey->getBookName());
-		stdstr((char **)&(retVal[7]), vkey->getOSISRef());
-		stdstr((char **)&(retVal[8]), vkey->getShortText());
-		stdstr((char **)&(retVal[9]), vkey->getBookAbbrev());
-		stdstr((char **)&(retVal[10]), vkey->getOSISBookName());
+		num.setFormatted("%d", vkey->getTestament());
+		hmod->keyChildren.add(num);
+		num.setFormatted("%d", vkey->getBook());
+		hmod->keyChildren.add(num);
+		num.setFormatted("%d", vkey->getChapter());
+		hmod->keyChildren.add(num);
+		num.setFormatted("%d", vkey->getVerse());
+		hmod->keyChildren.add(num);
+		num.setFormatted("%d", vkey->getChapterMax());
+		hmod->keyChildren.add(num);
+		num.setFormatted("%d", vkey->getVerseMax());
+		hmod->keyChildren.add(num);
+		hmod->keyChildren.add(vkey->getBookName());
+		hmod->keyChildren.add(vkey->getOSISRef());
+		hmod->keyChildren.add(vkey->getShortText());
+		hmod->keyChildren.add(vkey->getBookAbbrev());
+		hmod->keyChildren.add(vkey->getOSISBookName());
 	}
 	else {
 		TreeKeyIdx *tkey = SWDYNAMIC_CAST(TreeKeyIdx, key);
 		if (tkey) {
 			if (tkey->firstChild()) {
 				do {
-					count++;
-				}
-				while (tkey->nextSibling());
-				tkey->parent();
-			}
-			retVal = (const char **)calloc(count+1, sizeof(const char *));
-			count = 0;
-			if (tkey->firstChild()) {
-				do {
-					stdstr((char **)&(retVal[count++]), assureValidUTF8(tkey->getLocalName()));
+					hmod->keyChildren.addUTF8(tkey->getLocalName());
 				}
 				while (tkey->nextSibling());
 				tkey->parent();
 			}
 		}
+		// other keys have no children to give
+		else return 0;
 	}
 
-	hmod->keyChildren = retVal;
-	return retVal;
+	return hmod->keyChildren.getArray();
 }
 
 /*
@@ -864,7 +1086,7 @@ const char * SWDLLEXPORT org_crosswire_sword_SWModule_getKeyParent
 			retVal = tkey->getText();
 		}
 	}
-	return assureValidUTF8(retVal.c_str());
+	return validUTF8(retVal);
 }
 
 /*
@@ -919,9 +1141,9 @@ const char * SWDLLEXPORT org_crosswire_sword_SWModule_stripText
 
 	GETSWMODULE(hSWModule, 0);
 
-	stdstr(&(hmod->stripBuf), assureValidUTF8((const char *)module->stripText()));
+	hmod->stripBuf = module->stripText();
 
-	return hmod->stripBuf;
+	return validUTF8(hmod->stripBuf);
 }
 
 /*
@@ -934,9 +1156,9 @@ const char * SWDLLEXPORT org_crosswire_sword_SWModule_renderText
 
 	GETSWMODULE(hSWModule, 0);
 
-	stdstr(&(hmod->renderBuf), assureValidUTF8((const char *)module->renderText().c_str()));
+	hmod->renderBuf = module->renderText();
 
-	return hmod->renderBuf;
+	return validUTF8(hmod->renderBuf);
 }
 
 /*
@@ -950,9 +1172,9 @@ const char * SWDLLEXPORT org_crosswire_sword_SWModule_getRenderHeader
 
 	GETSWMODULE(hSWModule, 0);
 
-	stdstr(&(hmod->renderHeader), assureValidUTF8(((const char *)(module->getRenderHeader() ? module->getRenderHeader():""))));
+	hmod->renderHeader = (module->getRenderHeader() ? module->getRenderHeader():"");
 
-	return hmod->renderHeader;
+	return validUTF8(hmod->renderHeader);
 }
 
 /*
@@ -965,9 +1187,9 @@ const char * SWDLLEXPORT org_crosswire_sword_SWModule_getRawEntry
 
 	GETSWMODULE(hSWModule, 0);
 
-	stdstr(&(hmod->rawEntry), assureValidUTF8(((const char *)module->getRawEntry())));
+	hmod->rawEntry = module->getRawEntry();
 
-	return hmod->rawEntry;
+	return validUTF8(hmod->rawEntry);
 }
 
 /*
@@ -995,15 +1217,15 @@ const char * SWDLLEXPORT org_crosswire_sword_SWModule_getConfigEntry
 	GETSWMODULE(hSWModule, 0);
 
 	const char *exists = module->getConfigEntry(key);
-	SWBuf confValue = exists;
+	if (!exists) return 0;
+
+	hmod->configEntry = exists;
 	// special processing if we're requesting About-- kindof cheese
-	if (!strcmp("About", key) && exists) {
-		RTFHTML().processText(confValue);
+	if (!strcmp("About", key)) {
+		RTFHTML().processText(hmod->configEntry);
 	}
-	SWBuf assuredBuf = assureValidUTF8(confValue.c_str());
-	stdstr(&(hmod->configEntry), (exists ? assuredBuf.c_str() : 0));
 
-	return hmod->configEntry;
+	return validUTF8(hmod->configEntry);
 }
 
 /*
@@ -1113,9 +1335,7 @@ const struct org_crosswire_sword_ModInfo * SWDLLEXPORT org_crosswire_sword_SWMgr
 
 	GETSWMGR(hSWMgr, 0);
 
-	sword::SWModule *module = 0;
-
-	hmgr->clearModInfo();
+	hmgr->modInfo.clear();
 
 	int size = 0;
 	for (sword::ModMap::const_iterator it = mgr->getModules().begin(); it != mgr->getModules().end(); ++it) {
@@ -1123,43 +1343,12 @@ const struct org_crosswire_sword_ModInfo * SWDLLEXPORT org_crosswire_sword_SWMgr
 			size++;
 	}
 
-	struct org_crosswire_sword_ModInfo *milist = (struct org_crosswire_sword_ModInfo *)calloc(size+1, sizeof(struct org_crosswire_sword_ModInfo));
 	int i = 0;
 	for (sword::ModMap::const_iterator it = mgr->getModules().begin(); it != mgr->getModules().end(); ++it) {
-		module = it->second;
-		SWBuf type = module->getType();
-		SWBuf cat = module->getConfigEntry("Category");
-		SWBuf version = module->getConfigEntry("Version");
-		if (cat.length() > 0) type = cat;
-		stdstr(&(milist[i].name), assureValidUTF8(module->getName()));
-		stdstr(&(milist[i].description), assureValidUTF8(module->getDescription()));
-		stdstr(&(milist[i].category), assureValidUTF8(type.c_str()));
-		stdstr(&(milist[i].language), assureValidUTF8(module->getLanguage()));
-		stdstr(&(milist[i].version), assureValidUTF8(version.c_str()));
-		stdstr(&(milist[i].delta), "");
-		const char *cipherKey = module->getConfigEntry("CipherKey");
-		if (cipherKey) {
-			stdstr(&(milist[i].cipherKey), assureValidUTF8(cipherKey));
-		}
-		else	milist[i].cipherKey = 0;
-
-		ConfigEntMap::const_iterator start = module->getConfig().lower_bound("Feature");
-		ConfigEntMap::const_iterator end   = module->getConfig().upper_bound("Feature");
-
-		int featureCount = 0;
-		for (ConfigEntMap::const_iterator it = start; it != end; ++it) {
-			++featureCount;
-		}
-		milist[i].features = (const char **)calloc(featureCount+1, sizeof(const char *));
-		featureCount = 0;
-		for (ConfigEntMap::const_iterator it = start; it != end; ++it) {
-			stdstr((char **)&(milist[i].features[featureCount++]), assureValidUTF8(it->second));
-		}
-
+		hmgr->modInfo.add(it->second, "");
 		if (++i >= size) break;
 	}
-	hmgr->modInfo = milist;
-	return milist;
+	return hmgr->modInfo.getInfos();
 }
 
 /*
@@ -1269,22 +1458,14 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWMgr_getGlobalOptions
 
 	GETSWMGR(hSWMgr, 0);
 
-	const char **retVal;
-	hmgr->clearGlobalOptions();
+	hmgr->globalOptions.clear();
 
 	sword::StringList options = mgr->getGlobalOptions();
-	int count = 0;
 	for (sword::StringList::const_iterator it = options.begin(); it != options.end(); ++it) {
-		count++;
-	}
-	retVal = (const char **)calloc(count+1, sizeof(const char *));
-	count = 0;
-	for (sword::StringList::const_iterator it = options.begin(); it != options.end(); ++it) {
-		stdstr((char **)&(retVal[count++]), it->c_str());
+		hmgr->globalOptions.add(*it);
 	}
 
-	hmgr->globalOptions = retVal;
-	return retVal;
+	return hmgr->globalOptions.getArray();
 }
 
 
@@ -1296,30 +1477,19 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWMgr_getGlobalOptions
 const char ** SWDLLEXPORT org_crosswire_sword_SWConfig_getSections
 		(const char *confPath) {
 
-	clearStringArray(&tmpStringArrayRetVal);
-	int count = 0;
-	const char **retVal = 0;
+	tmpStringArrayRetVal.clear();
 	bool exists = FileMgr::existsFile(confPath);
 SWLOGD("libsword: getConfigSections %s at path: %s", exists?"Exists":"Absent", confPath);
 	if (exists) {
 		SWConfig config(confPath);
 		SectionMap::const_iterator sit;
 		for (sit = config.getSections().begin(); sit != config.getSections().end(); ++sit) {
-			count++;
+			tmpStringArrayRetVal.addUTF8(sit->first.c_str());
 		}
-SWLOGD("libsword: %d sections found in config", count);
-		retVal = (const char **)calloc(count+1, sizeof(const char *));
-		count = 0;
-		for (sit = config.getSections().begin(); sit != config.getSections().end(); ++sit) {
-			stdstr((char **)&(retVal[count++]), assureValidUTF8(sit->first.c_str()));
-		}
-	}
-	else {
-		retVal = (const char **)calloc(1, sizeof(const char *));
+SWLOGD("libsword: %d sections found in config", tmpStringArrayRetVal.size());
 	}
 
-	tmpStringArrayRetVal = retVal;
-	return retVal;
+	return tmpStringArrayRetVal.getArray();
 }
 
 
@@ -1332,9 +1502,7 @@ SWLOGD("libsword: %d sections found in config", count);
 const char ** SWDLLEXPORT org_crosswire_sword_SWConfig_getSectionKeys
 		(const char *confPath, const char *section) {
 
-	clearStringArray(&tmpStringArrayRetVal);
-	int count = 0;
-	const char **retVal = 0;
+	tmpStringArrayRetVal.clear();
 	bool exists = FileMgr::existsFile(confPath);
 	if (exists) {
 		SWConfig config(confPath);
@@ -1342,24 +1510,12 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWConfig_getSectionKeys
 		if (sit != config.getSections().end()) {
 			ConfigEntMap::const_iterator it;
 			for (it = sit->second.begin(); it != sit->second.end(); ++it) {
-				count++;
-			}
-			retVal = (const char **)calloc(count+1, sizeof(const char *));
-			count = 0;
-			for (it = sit->second.begin(); it != sit->second.end(); ++it) {
-				stdstr((char **)&(retVal[count++]), assureValidUTF8(it->first.c_str()));
+				tmpStringArrayRetVal.addUTF8(it->first.c_str());
 			}
 		}
-		else {
-			retVal = (const char **)calloc(1, sizeof(const char *));
-		}
-	}
-	else {
-		retVal = (const char **)calloc(1, sizeof(const char *));
 	}
 
-	tmpStringArrayRetVal = retVal;
-	return retVal;
+	return tmpStringArrayRetVal.getArray();
 }
 
 
@@ -1371,7 +1527,6 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWConfig_getSectionKeys
 const char * SWDLLEXPORT org_crosswire_sword_SWConfig_getKeyValue
 		(const char *confPath, const char *section, const char *key) {
 
-	stdstr(&tmpStringRetVal, 0);
 	bool exists = FileMgr::existsFile(confPath);
 	if (exists) {
 		SWConfig config(confPath);
@@ -1379,12 +1534,13 @@ const char * SWDLLEXPORT org_crosswire_sword_SWConfig_getKeyValue
 		if (sit != config.getSections().end()) {
 			ConfigEntMap::const_iterator it = sit->second.find(key);
 			if (it != sit->second.end()) {
-				stdstr(&tmpStringRetVal, assureValidUTF8(it->second.c_str()));
+				tmpStringRetVal = it->second;
+				return validUTF8(tmpStringRetVal);
 			}
 		}
 	}
 
-	return tmpStringRetVal;
+	return 0;
 }
 
 
@@ -1411,9 +1567,7 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWConfig_augmentConfig
 		(const char *confPath, const char *configBlob) {
 
 
-	clearStringArray(&tmpStringArrayRetVal);
-	const char **retVal = 0;
-	int count = 0;
+	tmpStringArrayRetVal.clear();
 
 	SWBuf myBlob = configBlob;
 
@@ -1432,16 +1586,10 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWConfig_augmentConfig
 
 	SectionMap::const_iterator sit;
 	for (sit = newConfig.getSections().begin(); sit != newConfig.getSections().end(); ++sit) {
-		count++;
-	}
-	retVal = (const char **)calloc(count+1, sizeof(const char *));
-	count = 0;
-	for (sit = newConfig.getSections().begin(); sit != newConfig.getSections().end(); ++sit) {
-		stdstr((char **)&(retVal[count++]), assureValidUTF8(sit->first.c_str()));
+		tmpStringArrayRetVal.addUTF8(sit->first.c_str());
 	}
 
-	tmpStringArrayRetVal = retVal;
-	return retVal;
+	return tmpStringArrayRetVal.getArray();
 }
 
 
@@ -1455,22 +1603,14 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWMgr_getGlobalOptionValues
 
 	GETSWMGR(hSWMgr, 0);
 
-	const char **retVal = 0;
-	hmgr->clearGlobalOptionValues();
+	hmgr->globalOptionValues.clear();
 
 	sword::StringList options = mgr->getGlobalOptionValues(option);
-	int count = 0;
-	for (sword::StringList::const_iterator it = options.begin(); it != options.end(); ++it) {
-		count++;
-	}
-	retVal = (const char **)calloc(count+1, sizeof(const char *));
-	count = 0;
 	for (sword::StringList::const_iterator it = options.begin(); it != options.end(); ++it) {
-		stdstr((char **)&(retVal[count++]), it->c_str());
+		hmgr->globalOptionValues.add(*it);
 	}
 
-	hmgr->globalOptionValues = retVal;
-	return retVal;
+	return hmgr->globalOptionValues.getArray();
 }
 
 /*
@@ -1509,21 +1649,13 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWMgr_getAvailableLocales
 
 	GETSWMGR(hSWMgr, 0);
 
-	hmgr->clearAvailableLocales();
+	hmgr->availableLocales.clear();
 	sword::StringList localeNames = LocaleMgr::getSystemLocaleMgr()->getAvailableLocales();
-	const char **retVal = 0;
-	int count = 0;
-	for (sword::StringList::const_iterator it = localeNames.begin(); it != localeNames.end(); ++it) {
-		count++;
-	}
-	retVal = (const char **)calloc(count+1, sizeof(const char *));
-	count = 0;
 	for (sword::StringList::const_iterator it = localeNames.begin(); it != localeNames.end(); ++it) {
-		stdstr((char **)&(retVal[count++]), it->c_str());
+		hmgr->availableLocales.add(*it);
 	}
 
-	hmgr->availableLocales = retVal;
-	return retVal;
+	return hmgr->availableLocales.getArray();
 }
 
 /*
@@ -1654,21 +1786,12 @@ const char ** SWDLLEXPORT org_crosswire_sword_InstallMgr_getRemoteSources
 
 	GETINSTMGR(hInstallMgr, 0);
 
-	hinstmgr->clearRemoteSources();
-	sword::StringList vals = LocaleMgr::getSystemLocaleMgr()->getAvailableLocales();
-	const char **retVal = 0;
-	int count = 0;
+	hinstmgr->remoteSources.clear();
 	for (InstallSourceMap::const_iterator it = installMgr->sources.begin(); it != installMgr->sources.end(); ++it) {
-		count++;
-	}
-	retVal = (const char **)calloc(count+1, sizeof(const char *));
-	count = 0;
-	for (InstallSourceMap::const_iterator it = installMgr->sources.begin(); it != installMgr->sources.end(); ++it) {
-		stdstr((char **)&(retVal[count++]), it->second->caption.c_str());
+		hinstmgr->remoteSources.add(it->second->caption);
 	}
 
-	hinstmgr->remoteSources = retVal;
-	return retVal;
+	return hinstmgr->remoteSources.getArray();
 }
 
 /*
@@ -1700,67 +1823,26 @@ const struct org_crosswire_sword_ModInfo * SWDLLEXPORT org_crosswire_sword_Insta
 	GETINSTMGR(hInstallMgr, 0);
 	GETSWMGR(hSWMgr_deltaCompareTo, 0);
 
-	struct org_crosswire_sword_ModInfo *retVal = 0;
-
-	hinstmgr->clearModInfo();
+	hinstmgr->modInfo.clear();
 
 	InstallSourceMap::const_iterator source = installMgr->sources.find(sourceName);
 	if (source == installMgr->sources.end()) {
-		retVal = (struct org_crosswire_sword_ModInfo *)calloc(1, sizeof(struct org_crosswire_sword_ModInfo));
-		hinstmgr->modInfo = retVal;
-		return retVal;
+		return hinstmgr->modInfo.getInfos();
 	}
 
 	std::map<SWModule *, int> modStats = installMgr->getModuleStatus(*mgr, *source->second->getMgr());
 
-	int size = 0;
-	for (std::map<SWModule *, int>::const_iterator it = modStats.begin(); it != modStats.end(); ++it) {
-		size++;
-	}
-	retVal = (struct org_crosswire_sword_ModInfo *)calloc(size+1, sizeof(struct org_crosswire_sword_ModInfo));
-	int i = 0;
 	for (std::map<SWModule *, int>::const_iterator it = modStats.begin(); it != modStats.end(); ++it) {
-		SWModule *module = it->first;
 		int status = it->second;
 
-		SWBuf version = module->getConfigEntry("Version");
-		SWBuf statusString = " ";
+		const char *statusString = " ";
 		if (status & InstallMgr::MODSTAT_NEW) statusString = "*";
 		if (status & InstallMgr::MODSTAT_OLDER) statusString = "-";
 		if (status & InstallMgr::MODSTAT_UPDATED) statusString = "+";
 
-		SWBuf type = module->getType();
-		SWBuf cat = module->getConfigEntry("Category");
-		if (cat.length() > 0) type = cat;
-
-		stdstr(&(retVal[i].name), assureValidUTF8(module->getName()));
-		stdstr(&(retVal[i].description), assureValidUTF8(module->getDescription()));
-		stdstr(&(retVal[i].category), assureValidUTF8(type.c_str()));
-		stdstr(&(retVal[i].language), assureValidUTF8(module->getLanguage()));
-		stdstr(&(retVal[i].version), assureValidUTF8(version.c_str()));
-		stdstr(&(retVal[i].delta), assureValidUTF8(statusString.c_str()));
-		const char *cipherKey = module->getConfigEntry("CipherKey");
-		if (cipherKey) {
-			stdstr(&(retVal[i].cipherKey), assureValidUTF8(cipherKey));
-		}
-		else	retVal[i].cipherKey = 0;
-
-		ConfigEntMap::const_iterator start = module->getConfig().lower_bound("Feature");
-		ConfigEntMap::const_iterator end   = module->getConfig().upper_bound("Feature");
-
-		int featureCount = 0;
-		for (ConfigEntMap::const_iterator it = start; it != end; ++it) {
-			++featureCount;
-		}
-		retVal[i].features = (const char **)calloc(featureCount+1, sizeof(const char *));
-		featureCount = 0;
-		for (ConfigEntMap::const_iterator it = start; it != end; ++it) {
-			stdstr((char **)&(retVal[i].features[featureCount++]), assureValidUTF8(it->second));
-		}
-		if (++i >= size) break;
+		hinstmgr->modInfo.add(it->first, statusString);
 	}
-	hinstmgr->modInfo = retVal;
-	return retVal;
+	return hinstmgr->modInfo.getInfos();
 }
 
 /*
@@ -23,6 +23,7 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <stdint.h>
 
 #include <jni.h>
 #include <android/log.h>
@@ -80,23 +81,153 @@ namespace {
     typedef map<SWBuf, SWBuf> SearchFilterValuesType;
     SearchFilterValuesType searchFilterValues;
 
-// this method converts a UTF8 encoded SWBuf to a Java String, avoiding a bug in jni NewStringUTF
-    jstring strToUTF8Java(JNIEnv *env, const SWBuf &str) {
-        const SWBuf safeStr = assureValidUTF8(str.c_str());
-        jbyteArray array = env->NewByteArray(safeStr.size());
-        env->SetByteArrayRegion(array, 0, safeStr.size(), (const jbyte *) safeStr.c_str());
-        jstring strEncode = env->NewStringUTF("UTF-8");
-        jclass cls = env->FindClass("java/lang/String");
-        jmethodID ctor = env->GetMethodID(cls, "<init>", "([BLjava/lang/String;)V");
-        jstring object = (jstring) env->NewObject(cls, ctor, array, strEncode);
-
-        env->DeleteLocalRef(strEncode);
+    // the classes, fields and methods we use on nearly every call, looked up
+    // once in JNI_OnLoad and held for as long as we're loaded
+    struct JavaIDs {
+        jclass stringClass;
+        jmethodID stringFromBytes;
+        jmethodID stringToUpperCase;
+        jstring utf8Encoding;
+
+        jclass moduleClass;
+        jfieldID moduleName;
+        jfieldID moduleDescription;
+        jfieldID moduleCategory;
+        jfieldID moduleRemoteSourceName;
+        jfieldID moduleHandle;
+        jfieldID moduleGeneration;
+
+        jclass entryClass;
+        jfieldID entryKey;
+        jfieldID entryText;
+
+        jclass searchHitClass;
+        jfieldID searchHitModName;
+        jfieldID searchHitKey;
+        jfieldID searchHitScore;
+
+        jclass modInfoClass;
+        jfieldID modInfoName;
+        jfieldID modInfoDescription;
+        jfieldID modInfoCategory;
+        jfieldID modInfoLanguage;
+        jfieldID modInfoVersion;
+        jfieldID modInfoDelta;
+        jfieldID modInfoCipherKey;
+        jfieldID modInfoFeatures;
+    } javaIDs;
+
+    // bumped whenever the managers may have dropped or replaced modules, so
+    // the handles held by Java SWModule objects get looked up again
+    jlong moduleGeneration = 1;
+
+    jclass globalClass(JNIEnv *env, const char *name) {
+        jclass local = env->FindClass(name);
+        jclass global = (jclass) env->NewGlobalRef(local);
+        env->DeleteLocalRef(local);
+        return global;
+    }
+
+    void cacheJavaIDs(JNIEnv *env) {
+        JavaIDs &ids = javaIDs;
+
+        ids.stringClass = globalClass(env, "java/lang/String");
+        ids.stringFromBytes = env->GetMethodID(ids.stringClass, "<init>", "([BLjava/lang/String;)V");
+        ids.stringToUpperCase = env->GetMethodID(ids.stringClass, "toUpperCase", "()Ljava/lang/String;");
+        jstring encoding = env->NewStringUTF("UTF-8");
+        ids.utf8Encoding = (jstring) env->NewGlobalRef(encoding);
+        env->DeleteLocalRef(encoding);
+
+        ids.moduleClass = globalClass(env, "org/crosswire/android/sword/SWModule");
+        ids.moduleName = env->GetFieldID(ids.moduleClass, "name", "Ljava/lang/String;");
+        ids.moduleDescription = env->GetFieldID(ids.moduleClass, "description", "Ljava/lang/String;");
+        ids.moduleCategory = env->GetFieldID(ids.moduleClass, "category", "Ljava/lang/String;");
+        ids.moduleRemoteSourceName = env->GetFieldID(ids.moduleClass, "remoteSourceName", "Ljava/lang/String;");
+        ids.moduleHandle = env->GetFieldID(ids.moduleClass, "nativeHandle", "J");
+        ids.moduleGeneration = env->GetFieldID(ids.moduleClass, "nativeGeneration", "J");
+
+        ids.entryClass = globalClass(env, "org/crosswire/android/sword/SWModule$Entry");
+        ids.entryKey = env->GetFieldID(ids.entryClass, "key", "Ljava/lang/String;");
+        ids.entryText = env->GetFieldID(ids.entryClass, "text", "Ljava/lang/String;");
+
+        ids.searchHitClass = globalClass(env, "org/crosswire/android/sword/SWModule$SearchHit");
+        ids.searchHitModName = env->GetFieldID(ids.searchHitClass, "modName", "Ljava/lang/String;");
+        ids.searchHitKey = env->GetFieldID(ids.searchHitClass, "key", "Ljava/lang/String;");
+        ids.searchHitScore = env->GetFieldID(ids.searchHitClass, "score", "J");
+
+        ids.modInfoClass = globalClass(env, "org/crosswire/android/sword/SWMgr$ModInfo");
+        ids.modInfoName = env->GetFieldID(ids.modInfoClass, "name", "Ljava/lang/String;");
+        ids.modInfoDescription = env->GetFieldID(ids.modInfoClass, "description", "Ljava/lang/String;");
+        ids.modInfoCategory = env->GetFieldID(ids.modInfoClass, "category", "Ljava/lang/String;");
+        ids.modInfoLanguage = env->GetFieldID(ids.modInfoClass, "language", "Ljava/lang/String;");
+        ids.modInfoVersion = env->GetFieldID(ids.modInfoClass, "version", "Ljava/lang/String;");
+        ids.modInfoDelta = env->GetFieldID(ids.modInfoClass, "delta", "Ljava/lang/String;");
+        ids.modInfoCipherKey = env->GetFieldID(ids.modInfoClass, "cipherKey", "Ljava/lang/String;");
+        ids.modInfoFeatures = env->GetFieldID(ids.modInfoClass, "features", "[Ljava/lang/String;");
+    }
+
+    void releaseJavaIDs(JNIEnv *env) {
+        env->DeleteGlobalRef(javaIDs.stringClass);
+        env->DeleteGlobalRef(javaIDs.utf8Encoding);
+        env->DeleteGlobalRef(javaIDs.moduleClass);
+        env->DeleteGlobalRef(javaIDs.entryClass);
+        env->DeleteGlobalRef(javaIDs.searchHitClass);
+        env->DeleteGlobalRef(javaIDs.modInfoClass);
+    }
+
+// this method converts a UTF8 encoded string to a Java String, avoiding a bug in jni NewStringUTF
+// which doesn't touch plain ASCII, so that still goes straight through it
+    jstring strToUTF8Java(JNIEnv *env, const char *str) {
+        if (!str) str = "";
+        unsigned long len = strlen(str);
+        if (getASCIILength(str, len) == len) return env->NewStringUTF(str);
+
+        SWBuf fixed;
+        const char *safeStr = assureValidUTF8(str, fixed);
+        if (safeStr != str) len = fixed.size();
+        jbyteArray array = env->NewByteArray(len);
+        env->SetByteArrayRegion(array, 0, len, (const jbyte *) safeStr);
+        jstring object = (jstring) env->NewObject(javaIDs.stringClass, javaIDs.stringFromBytes, array, javaIDs.utf8Encoding);
+
         env->DeleteLocalRef(array);
-        env->DeleteLocalRef(cls);
 
         return object;
     }
 
+    // a String[] of each of strs
+    jobjectArray strsToUTF8Java(JNIEnv *env, const vector<SWBuf> &strs) {
+        jobjectArray ret = (jobjectArray) env->NewObjectArray(strs.size(), javaIDs.stringClass, nullptr);
+        for (int i = 0; i < (int)strs.size(); ++i) {
+            jstring s = strToUTF8Java(env, strs[i].c_str());
+            env->SetObjectArrayElement(ret, i, s);
+            env->DeleteLocalRef(s);
+        }
+        return ret;
+    }
+
+    void setString(JNIEnv *env, jobject object, jfieldID field, const char *str) {
+        jstring s = strToUTF8Java(env, str);
+        env->SetObjectField(object, field, s);
+        env->DeleteLocalRef(s);
+    }
+
+    // remembers on a Java SWModule which native module it stands for, until
+    // the managers change
+    void setModuleHandle(JNIEnv *env, jobject me, SWModule *module) {
+        env->SetLongField(me, javaIDs.moduleHandle, (jlong) (intptr_t) module);
+        env->SetLongField(me, javaIDs.moduleGeneration, moduleGeneration);
+    }
+
+    jobject newModule(JNIEnv *env, SWModule *module, const char *category, const char *remoteSourceName) {
+        jobject retVal = env->AllocObject(javaIDs.moduleClass);
+        setString(env, retVal, javaIDs.moduleName, module->getName());
+        setString(env, retVal, javaIDs.moduleDescription, module->getDescription());
+        setString(env, retVal, javaIDs.moduleCategory, category);
+        if (remoteSourceName) setString(env, retVal, javaIDs.moduleRemoteSourceName, remoteSourceName);
+        setModuleHandle(env, retVal, module);
+        return retVal;
+    }
+
     class InstallStatusReporter : public StatusReporter {
     public:
         JNIEnv *env;
@@ -182,19 +313,8 @@ namespace {
             }
 
             if (myThreadsEnv) {
-                const SWBuf validBuf = assureValidUTF8(buf);
-                unsigned long bufLen = validBuf.size();
-                jbyteArray array = myThreadsEnv->NewByteArray(bufLen);
-                myThreadsEnv->SetByteArrayRegion(array, 0, bufLen,
-                                                 (const jbyte *) validBuf.c_str());
-                jstring strEncode = myThreadsEnv->NewStringUTF("UTF-8");
-                jclass cls = myThreadsEnv->FindClass("java/lang/String");
-                jmethodID ctor = myThreadsEnv->GetMethodID(cls, "<init>",
-                                                           "([BLjava/lang/String;)V");
-                jstring object = (jstring) myThreadsEnv->NewObject(cls, ctor, array, strEncode);
-                jmethodID toUpperCase = myThreadsEnv->GetMethodID(cls, "toUpperCase",
-                                                                  "()Ljava/lang/String;");
-                jstring objectUpper = (jstring) myThreadsEnv->CallObjectMethod(object, toUpperCase);
+                jstring object = strToUTF8Java(myThreadsEnv, buf);
+                jstring objectUpper = (jstring) myThreadsEnv->CallObjectMethod(object, javaIDs.stringToUpperCase);
 
                 const char *ret = (objectUpper ? myThreadsEnv->GetStringUTFChars(objectUpper,
                                                                                  nullptr)
@@ -208,9 +328,6 @@ namespace {
                     myThreadsEnv->ReleaseStringUTFChars(objectUpper, ret);
                 }
 
-                myThreadsEnv->DeleteLocalRef(strEncode);
-                myThreadsEnv->DeleteLocalRef(array);
-                myThreadsEnv->DeleteLocalRef(cls);
                 myThreadsEnv->DeleteLocalRef(objectUpper);
                 myThreadsEnv->DeleteLocalRef(object);
             }
@@ -458,6 +575,7 @@ SWLOGI("setting STORAGE_BASE to: %s", STORAGE_BASE.c_str());
 
 	delete mgr;
 	mgr = nullptr;
+	++moduleGeneration;
 }
 
 
@@ -491,17 +609,17 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWMgr_getModInfo
 
 SWLOGI("getModInfoList returning %d length array\n", size);
 
-	jclass clazzModInfo = env->FindClass("org/crosswire/android/sword/SWMgr$ModInfo");
-	jclass clazzString  = env->FindClass("java/lang/String");
+	jclass clazzModInfo = javaIDs.modInfoClass;
+	jclass clazzString  = javaIDs.stringClass;
 
-	jfieldID nameID     = env->GetFieldID(clazzModInfo, "name",        "Ljava/lang/String;");
-	jfieldID descID     = env->GetFieldID(clazzModInfo, "description", "Ljava/lang/String;");
-	jfieldID catID      = env->GetFieldID(clazzModInfo, "category",    "Ljava/lang/String;");
-	jfieldID langID     = env->GetFieldID(clazzModInfo, "language",    "Ljava/lang/String;");
-	jfieldID versionID  = env->GetFieldID(clazzModInfo, "version",     "Ljava/lang/String;");
-	jfieldID deltaID    = env->GetFieldID(clazzModInfo, "delta",       "Ljava/lang/String;");
-	jfieldID cipherKeyID= env->GetFieldID(clazzModInfo, "cipherKey",   "Ljava/lang/String;");
-	jfieldID featuresID = env->GetFieldID(clazzModInfo, "features",    "[Ljava/lang/String;");
+	jfieldID nameID     = javaIDs.modInfoName;
+	jfieldID descID     = javaIDs.modInfoDescription;
+	jfieldID catID      = javaIDs.modInfoCategory;
+	jfieldID langID     = javaIDs.modInfoLanguage;
+	jfieldID versionID  = javaIDs.modInfoVersion;
+	jfieldID deltaID    = javaIDs.modInfoDelta;
+	jfieldID cipherKeyID= javaIDs.modInfoCipherKey;
+	jfieldID featuresID = javaIDs.modInfoFeatures;
 
 	jobjectArray ret = (jobjectArray) env->NewObjectArray(size, clazzModInfo, nullptr);
 
@@ -575,12 +693,7 @@ JNIEXPORT jobject JNICALL Java_org_crosswire_android_sword_SWMgr_getModuleByName
 		SWBuf type = module->getType();
 		SWBuf cat = module->getConfigEntry("Category");
 		if (cat.length() > 0) type = cat;
-		jfieldID fieldID;
-		jclass clazzSWModule = env->FindClass("org/crosswire/android/sword/SWModule");
-		retVal = env->AllocObject(clazzSWModule); 
-		fieldID = env->GetFieldID(clazzSWModule, "name", "Ljava/lang/String;"); env->SetObjectField(retVal, fieldID, strToUTF8Java(env, module->getName()));
-		fieldID = env->GetFieldID(clazzSWModule, "description", "Ljava/lang/String;"); env->SetObjectField(retVal, fieldID, strToUTF8Java(env, module->getDescription()));
-		fieldID = env->GetFieldID(clazzSWModule, "category", "Ljava/lang/String;"); env->SetObjectField(retVal, fieldID, strToUTF8Java(env, type.c_str()));
+		retVal = newModule(env, module, type.c_str(), nullptr);
 	}
 	return retVal;
 }
@@ -687,7 +800,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWMgr_getGlobalO
 		count++;
 	}
 
-	jclass clazzString = env->FindClass("java/lang/String");
+	jclass clazzString = javaIDs.stringClass;
 	jobjectArray ret = (jobjectArray) env->NewObjectArray(count, clazzString, nullptr);
 
 	count = 0;
@@ -715,7 +828,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWMgr_getExtraCo
 	SWBuf confPath = baseDir + "/extraConfig.conf";
 	int count = 0;
 	bool exists = FileMgr::existsFile(confPath.c_str());
-	jclass clazzString = env->FindClass("java/lang/String");
+	jclass clazzString = javaIDs.stringClass;
 	jobjectArray ret;
 SWLOGI("libsword: extraConfig %s at path: %s", exists?"Exists":"Absent", confPath.c_str());
 	if (exists) {
@@ -761,7 +874,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWMgr_getExtraCo
 	SWBuf confPath = baseDir + "/extraConfig.conf";
 	int count = 0;
 	bool exists = FileMgr::existsFile(confPath.c_str());
-	jclass clazzString = env->FindClass("java/lang/String");
+	jclass clazzString = javaIDs.stringClass;
 	jobjectArray ret;
 	if (exists) {
 		SWConfig config(confPath.c_str());
@@ -891,7 +1004,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWMgr_addExtraCo
 	jobjectArray ret;
 
 	int count = 0;
-	jclass clazzString = env->FindClass("java/lang/String");
+	jclass clazzString = javaIDs.stringClass;
 
 	SWBuf baseDir = STORAGE_BASE;
 	SWBuf tmpConfPath = baseDir + "/tmpConfig.conf";
@@ -986,7 +1099,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWMgr_getGlobalO
 	for (sword::StringList::const_iterator it = options.begin(); it != options.end(); ++it) {
 		count++;
 	}
-	jclass clazzString = env->FindClass("java/lang/String");
+	jclass clazzString = javaIDs.stringClass;
 	jobjectArray ret = (jobjectArray) env->NewObjectArray(count, clazzString, nullptr);
 
 	count = 0;
@@ -1050,7 +1163,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWMgr_getAvailab
 		count++;
 	}
 
-	jclass clazzString = env->FindClass("java/lang/String");
+	jclass clazzString = javaIDs.stringClass;
 	jobjectArray ret = (jobjectArray) env->NewObjectArray(count, clazzString, nullptr);
 
 	count = 0;
@@ -1108,12 +1221,14 @@ SWModule *getModule
 
 	init(env);
 
+	// looked up already, since the managers last changed
+	if (env->GetLongField(me, javaIDs.moduleGeneration) == moduleGeneration) {
+		return (SWModule *)(intptr_t)env->GetLongField(me, javaIDs.moduleHandle);
+	}
+
 	SWModule *module = nullptr;
-	jclass clazzSWModule = env->FindClass("org/crosswire/android/sword/SWModule");
-	jfieldID fieldID = env->GetFieldID(clazzSWModule, "name", "Ljava/lang/String;");
-	jfieldID sourceFieldID = env->GetFieldID(clazzSWModule, "remoteSourceName", "Ljava/lang/String;");
-	jstring modNameJS = (jstring)env->GetObjectField(me, fieldID);
-	jstring sourceNameJS = (jstring)env->GetObjectField(me, sourceFieldID);
+	jstring modNameJS = (jstring)env->GetObjectField(me, javaIDs.moduleName);
+	jstring sourceNameJS = (jstring)env->GetObjectField(me, javaIDs.moduleRemoteSourceName);
 	const char *modName = (modNameJS?env->GetStringUTFChars(modNameJS, nullptr):nullptr);
 	const char *sourceName = (sourceNameJS?env->GetStringUTFChars(sourceNameJS, nullptr):nullptr);
 //SWLOGD("libsword: lookup up module %s from source: %s", modName?modName:"<null>", sourceName?sourceName:"<null>");
@@ -1130,6 +1245,10 @@ SWModule *getModule
 
 	if (modName) env->ReleaseStringUTFChars(modNameJS, modName);
 	if (sourceName) env->ReleaseStringUTFChars(sourceNameJS, sourceName);
+	env->DeleteLocalRef(modNameJS);
+	env->DeleteLocalRef(sourceNameJS);
+
+	setModuleHandle(env, me, module);
 
 	return module;
 }
@@ -1283,6 +1402,108 @@ JNIEXPORT jlong JNICALL Java_org_crosswire_android_sword_SWModule_getEntrySize
 }
 
 
+// the entry attributes of the module's current entry which level1, level2
+// and level3 ask for; see getEntryAttribute in SWModule.java
+static void collectEntryAttributes(SWModule *module, const char *level1, const char *level2, const char *level3, vector<SWBuf> &results) {
+
+	module->renderText();	// force parse
+
+	sword::AttributeTypeList &entryAttribs = module->getEntryAttributes();
+	sword::AttributeTypeList::const_iterator i1Start, i1End;
+	sword::AttributeList::const_iterator i2Start, i2End;
+	sword::AttributeValue::const_iterator i3Start, i3End;
+
+	if ((level1) && (*level1) && *level1 != '-') {
+		i1Start = entryAttribs.find(level1);
+		i1End = i1Start;
+		if (i1End != entryAttribs.end())
+			++i1End;
+	}
+	else {
+		i1Start = entryAttribs.begin();
+		i1End   = entryAttribs.end();
+	}
+	for (;i1Start != i1End; ++i1Start) {
+		if (level1 && *level1 && *level1 == '-') {
+			results.push_back(i1Start->first);
+		}
+		else {
+			if (level2 && *level2 && *level2 != '-') {
+				i2Start = i1Start->second.find(level2);
+				i2End = i2Start;
+				if (i2End != i1Start->second.end())
+					++i2End;
+			}
+			else {
+				i2Start = i1Start->second.begin();
+				i2End   = i1Start->second.end();
+			}
+			for (;i2Start != i2End; ++i2Start) {
+				if (level2 && *level2 && *level2 == '-') {
+					results.push_back(i2Start->first);
+				}
+				else {
+					// allow '-' to get all keys; allow '*' to get all key=value
+					if (level3 && *level3 && *level3 != '-' && *level3 != '*') {
+						i3Start = i2Start->second.find(level3);
+						i3End = i3Start;
+						if (i3End != i2Start->second.end())
+							++i3End;
+					}
+					else {
+						i3Start = i2Start->second.begin();
+						i3End   = i2Start->second.end();
+					}
+					for (;i3Start != i3End; ++i3Start) {
+						if (level3 && *level3 && *level3 == '-') {
+							results.push_back(i3Start->first);
+						}
+						else if (level3 && *level3 && *level3 == '*') {
+							results.push_back(i3Start->first + "=" + i3Start->second);
+						}
+						else {
+							results.push_back(i3Start->second);
+						}
+					}
+					if (i3Start != i3End)
+						break;
+				}
+			}
+			if (i2Start != i2End)
+				break;
+		}
+	}
+}
+
+
+static jobjectArray entryAttributesToJava(JNIEnv *env, SWModule *module, const vector<SWBuf> &results, bool filtered) {
+	if (!filtered) return strsToUTF8Java(env, results);
+
+	jobjectArray ret = (jobjectArray) env->NewObjectArray(results.size(), javaIDs.stringClass, nullptr);
+	for (int i = 0; i < results.size(); ++i) {
+		SWBuf rendered = module->renderText(results[i].c_str());
+		jstring s = strToUTF8Java(env, rendered.c_str());
+		env->SetObjectArrayElement(ret, i, s);
+		env->DeleteLocalRef(s);
+	}
+	return ret;
+}
+
+
+// each key of keyListText, as parseKeyList gives them, for walking
+// the module over; the module's own key is left alone
+static void parseKeys(SWModule *module, const char *keyListText, vector<SWBuf> &keys) {
+	VerseKey *parser = SWDYNAMIC_CAST(VerseKey, module->getKey());
+	if (parser) {
+		sword::ListKey result;
+		result = parser->parseVerseList(keyListText, *parser, true);
+		for (result = sword::TOP; !result.popError(); result++) {
+			keys.push_back(result.getText());
+		}
+	}
+	else keys.push_back(keyListText);
+}
+
 /*
  * Class:     org_crosswire_android_sword_SWModule
  * Method:    getEntryAttribute
@@ -1299,105 +1520,110 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWModule_getEntr
 	bool filtered = (filteredJS == JNI_TRUE);
 //SWLOGD("calling getEntryAttributes(%s, %s, %s, %s", level1, level2, level3, (filtered?"true":"false"));
 
-	jclass clazzString = env->FindClass("java/lang/String");
 	jobjectArray ret = nullptr;
 
 	SWModule *module = getModule(env, me);
 
 	if (module) {
-
-		module->renderText();	// force parse
 		vector<SWBuf> results;
+		collectEntryAttributes(module, level1, level2, level3, results);
+//SWLOGD("getEntryAttributes: size returned: %d", results.size());
+		ret = entryAttributesToJava(env, module, results, filtered);
+	}
 
-		sword::AttributeTypeList &entryAttribs = module->getEntryAttributes();
-		sword::AttributeTypeList::const_iterator i1Start, i1End;
-		sword::AttributeList::const_iterator i2Start, i2End;
-		sword::AttributeValue::const_iterator i3Start, i3End;
+	env->ReleaseStringUTFChars(level3JS, level3);
+	env->ReleaseStringUTFChars(level2JS, level2);
+	env->ReleaseStringUTFChars(level1JS, level1);
 
-		if ((level1) && (*level1) && *level1 != '-') {
-			i1Start = entryAttribs.find(level1);
-			i1End = i1Start;
-			if (i1End != entryAttribs.end())
-				++i1End;
-		}
-		else {
-			i1Start = entryAttribs.begin();
-			i1End   = entryAttribs.end();
-		}
-		for (;i1Start != i1End; ++i1Start) {
-			if (level1 && *level1 && *level1 == '-') {
-				results.push_back(i1Start->first);
-			}
-			else {
-				if (level2 && *level2 && *level2 != '-') {
-					i2Start = i1Start->second.find(level2);
-					i2End = i2Start;
-					if (i2End != i1Start->second.end())
-						++i2End;
-				}
-				else {
-					i2Start = i1Start->second.begin();
-					i2End   = i1Start->second.end();
-				}
-				for (;i2Start != i2End; ++i2Start) {
-					if (level2 && *level2 && *level2 == '-') {
-						results.push_back(i2Start->first);
-					}
-					else {
-						// allow '-' to get all keys; allow '*' to get all key=value
-						if (level3 && *level3 && *level3 != '-' && *level3 != '*') {
-							i3Start = i2Start->second.find(level3);
-							i3End = i3Start;
-							if (i3End != i2Start->second.end())
-								++i3End;
-						}
-						else {
-							i3Start = i2Start->second.begin();
-							i3End   = i2Start->second.end();
-						}
-						for (;i3Start != i3End; ++i3Start) {
-							if (level3 && *level3 && *level3 == '-') {
-								results.push_back(i3Start->first);
-							}
-							else if (level3 && *level3 && *level3 == '*') {
-								results.push_back(i3Start->first + "=" + i3Start->second);
-							}
-							else {
-								results.push_back(i3Start->second);
-							}
-						}
-						if (i3Start != i3End)
-							break;
-					}
-				}
-				if (i2Start != i2End)
-					break;
-			}
+	return (ret) ? ret : (jobjectArray) env->NewObjectArray(0, javaIDs.stringClass, nullptr);
+}
+
+
+/*
+ * Class:     org_crosswire_android_sword_SWModule
+ * Method:    renderEntries
+ * Signature: (Ljava/lang/String;)[Lorg/crosswire/android/sword/SWModule$Entry;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWModule_renderEntries
+		(JNIEnv *env, jobject me, jstring keyListTextJS) {
+
+	init(env);
+
+	const char *keyListText = env->GetStringUTFChars(keyListTextJS, nullptr);
+
+	SWModule *module = getModule(env, me);
+	jobjectArray ret = nullptr;
+
+	if (module) {
+		vector<SWBuf> keys;
+		parseKeys(module, keyListText, keys);
+
+		SWBuf savedKey = module->getKeyText();
+		ret = (jobjectArray) env->NewObjectArray(keys.size(), javaIDs.entryClass, nullptr);
+		for (int i = 0; i < keys.size(); ++i) {
+			module->setKey(keys[i].c_str());
+			jobject entry = env->AllocObject(javaIDs.entryClass);
+			setString(env, entry, javaIDs.entryKey, module->getKeyText());
+			setString(env, entry, javaIDs.entryText, module->renderText().c_str());
+			env->SetObjectArrayElement(ret, i, entry);
+			env->DeleteLocalRef(entry);
 		}
+		module->setKey(savedKey.c_str());
+	}
 
-		ret = (jobjectArray) env->NewObjectArray(results.size(), clazzString, nullptr);
+	env->ReleaseStringUTFChars(keyListTextJS, keyListText);
 
-//SWLOGD("getEntryAttributes: size returned: %d", results.size());
+	return (ret) ? ret : (jobjectArray) env->NewObjectArray(0, javaIDs.entryClass, nullptr);
+}
 
-		for (int i = 0; i < results.size(); ++i) {
-			jstring s;
-			if (filtered) {
-				SWBuf rendered = module->renderText(results[i].c_str());
-				s = strToUTF8Java(env, rendered.c_str());
-			}
-			else {
-				s = strToUTF8Java(env, results[i].c_str());
-			}
-			env->SetObjectArrayElement(ret, i, s);
-			env->DeleteLocalRef(s);
+
+/*
+ * Class:     org_crosswire_android_sword_SWModule
+ * Method:    getEntryAttributes
+ * Signature: (Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Z)[[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWModule_getEntryAttributes
+		(JNIEnv *env, jobject me, jstring keyListTextJS, jstring level1JS, jstring level2JS, jstring level3JS, jboolean filteredJS) {
+
+	init(env);
+
+	const char *keyListText = env->GetStringUTFChars(keyListTextJS, nullptr);
+	const char *level1 = env->GetStringUTFChars(level1JS, nullptr);
+	const char *level2 = env->GetStringUTFChars(level2JS, nullptr);
+	const char *level3 = env->GetStringUTFChars(level3JS, nullptr);
+	bool filtered = (filteredJS == JNI_TRUE);
+
+	SWModule *module = getModule(env, me);
+	jobjectArray ret = nullptr;
+	jclass clazzStrings = env->FindClass("[Ljava/lang/String;");
+
+	if (module) {
+		vector<SWBuf> keys;
+		parseKeys(module, keyListText, keys);
+
+		SWBuf savedKey = module->getKeyText();
+		ret = (jobjectArray) env->NewObjectArray(keys.size(), clazzStrings, nullptr);
+		vector<SWBuf> results;
+		for (int i = 0; i < keys.size(); ++i) {
+			module->setKey(keys[i].c_str());
+			results.clear();
+			collectEntryAttributes(module, level1, level2, level3, results);
+			jobjectArray attributes = entryAttributesToJava(env, module, results, filtered);
+			env->SetObjectArrayElement(ret, i, attributes);
+			env->DeleteLocalRef(attributes);
 		}
+		module->setKey(savedKey.c_str());
 	}
 
 	env->ReleaseStringUTFChars(level3JS, level3);
 	env->ReleaseStringUTFChars(level2JS, level2);
 	env->ReleaseStringUTFChars(level1JS, level1);
+	env->ReleaseStringUTFChars(keyListTextJS, keyListText);
+
+	if (!ret) ret = (jobjectArray) env->NewObjectArray(0, clazzStrings, nullptr);
+	env->DeleteLocalRef(clazzStrings);
 
-	return (ret) ? ret : (jobjectArray) env->NewObjectArray(0, clazzString, nullptr);
+	return ret;
 }
 
 
@@ -1414,7 +1640,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWModule_parseKe
 	const char *keyListText = env->GetStringUTFChars(keyListTextJS, nullptr);
 
 	SWModule *module = getModule(env, me);
-	jclass clazzString = env->FindClass("java/lang/String");
+	jclass clazzString = javaIDs.stringClass;
 	jobjectArray ret = nullptr;
 
 	if (module) {
@@ -1492,7 +1718,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWModule_getKeyC
 	init(env);
 
 
-	jclass clazzString = env->FindClass("java/lang/String");
+	jclass clazzString = javaIDs.stringClass;
 	jobjectArray ret = nullptr;
 
 	SWModule *module = getModule(env, me);
@@ -1836,7 +2062,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWModule_search
 	const char *expression = env->GetStringUTFChars(expressionJS, nullptr);
 	const char *scope = scopeJS ? env->GetStringUTFChars(scopeJS, nullptr) : nullptr;
 
-	jclass clazzSearchHit = env->FindClass("org/crosswire/android/sword/SWModule$SearchHit");
+	jclass clazzSearchHit = javaIDs.searchHitClass;
 	jobjectArray ret = nullptr;
 
 	SWModule *module = getModule(env, me);
@@ -1894,9 +2120,9 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_SWModule_search
 
 		int i = 0;
 		jstring modName = strToUTF8Java(env, module->getName());
-		jfieldID fieldIDModName = env->GetFieldID(clazzSearchHit, "modName", "Ljava/lang/String;");
-		jfieldID fieldIDKey     = env->GetFieldID(clazzSearchHit, "key"    , "Ljava/lang/String;");
-		jfieldID fieldIDScore   = env->GetFieldID(clazzSearchHit, "score"  , "J");
+		jfieldID fieldIDModName = javaIDs.searchHitModName;
+		jfieldID fieldIDKey     = javaIDs.searchHitKey;
+		jfieldID fieldIDScore   = javaIDs.searchHitScore;
 		for (result = sword::TOP; !result.popError(); result++) {
 			jobject searchHit = env->AllocObject(clazzSearchHit);
 
@@ -1934,6 +2160,7 @@ JNIEXPORT void JNICALL Java_org_crosswire_android_sword_InstallMgr_reInit
 
 	delete installMgr;
 	installMgr = nullptr;
+	++moduleGeneration;
 }
 
 
@@ -1947,6 +2174,9 @@ JNIEXPORT jint JNICALL Java_org_crosswire_android_sword_InstallMgr_syncConfig
 
 	initInstall(env);
 
+	// the sources, and the modules in them, are made anew
+	++moduleGeneration;
+
 	return installMgr->refreshRemoteSourceConfiguration();
 }
 
@@ -1974,6 +2204,7 @@ SWLOGI("uninstallModule %s\n", modName);
 		return -2;
 	}
 	int retVal = installMgr->removeModule(mgr, module->getName());
+	++moduleGeneration;
 
 
 	return retVal;
@@ -1990,7 +2221,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_crosswire_android_sword_InstallMgr_getRe
 
 	initInstall(env);
 
-	jclass clazzString = env->FindClass("java/lang/String");
+	jclass clazzString = javaIDs.stringClass;
 	jobjectArray ret;
 
 	int count = 0;
@@ -2031,6 +2262,8 @@ JNIEXPORT jint JNICALL Java_org_crosswire_android_sword_InstallMgr_refreshRemote
 	}
 
 
+	++moduleGeneration;
+
 	return installMgr->refreshRemoteSource(source->second);
 }
 
@@ -2050,17 +2283,17 @@ SWLOGI("getRemoteModInfoList\n");
 	const char *sourceName = env->GetStringUTFChars(sourceNameJS, nullptr);
 SWLOGI("sourceName: %s\n", sourceName);
 
-	jclass clazzModInfo = env->FindClass("org/crosswire/android/sword/SWMgr$ModInfo");
-	jclass clazzString  = env->FindClass("java/lang/String");
-
-	jfieldID nameID     = env->GetFieldID(clazzModInfo, "name",        "Ljava/lang/String;");
-	jfieldID descID     = env->GetFieldID(clazzModInfo, "description", "Ljava/lang/String;");
-	jfieldID catID      = env->GetFieldID(clazzModInfo, "category",    "Ljava/lang/String;");
-	jfieldID langID     = env->GetFieldID(clazzModInfo, "language",    "Ljava/lang/String;");
-	jfieldID versionID  = env->GetFieldID(clazzModInfo, "version",     "Ljava/lang/String;");
-	jfieldID deltaID    = env->GetFieldID(clazzModInfo, "delta",       "Ljava/lang/String;");
-	jfieldID cipherKeyID= env->GetFieldID(clazzModInfo, "cipherKey",   "Ljava/lang/String;");
-	jfieldID featuresID = env->GetFieldID(clazzModInfo, "features",    "[Ljava/lang/String;");
+	jclass clazzModInfo = javaIDs.modInfoClass;
+	jclass clazzString  = javaIDs.stringClass;
+
+	jfieldID nameID     = javaIDs.modInfoName;
+	jfieldID descID     = javaIDs.modInfoDescription;
+	jfieldID catID      = javaIDs.modInfoCategory;
+	jfieldID langID     = javaIDs.modInfoLanguage;
+	jfieldID versionID  = javaIDs.modInfoVersion;
+	jfieldID deltaID    = javaIDs.modInfoDelta;
+	jfieldID cipherKeyID= javaIDs.modInfoCipherKey;
+	jfieldID featuresID = javaIDs.modInfoFeatures;
 	jobjectArray ret = nullptr;
 	InstallSourceMap::const_iterator source = installMgr->sources.find(sourceName);
 	if (source == installMgr->sources.end()) {
@@ -2174,6 +2407,7 @@ SWLOGI("remoteInstallModule: modName: %s\n", modName);
 	}
 
 	int error = installMgr->installModule(mgr, nullptr, module->getName(), is);
+	++moduleGeneration;
 
 	if (progressReporter) {
 		jclass cls = env->GetObjectClass(progressReporter);
@@ -2225,13 +2459,7 @@ SWLOGI("Couldn't find remote source [%s]\n", sourceName.c_str());
 		SWBuf type = module->getType();
 		SWBuf cat = module->getConfigEntry("Category");
 		if (cat.length() > 0) type = cat;
-		jfieldID fieldID;
-		jclass clazzSWModule = env->FindClass("org/crosswire/android/sword/SWModule");
-		retVal = env->AllocObject(clazzSWModule); 
-		fieldID = env->GetFieldID(clazzSWModule, "name", "Ljava/lang/String;"); env->SetObjectField(retVal, fieldID, strToUTF8Java(env, module->getName()));
-		fieldID = env->GetFieldID(clazzSWModule, "description", "Ljava/lang/String;"); env->SetObjectField(retVal, fieldID, strToUTF8Java(env, module->getDescription()));
-		fieldID = env->GetFieldID(clazzSWModule, "category", "Ljava/lang/String;"); env->SetObjectField(retVal, fieldID, strToUTF8Java(env, type));
-		fieldID = env->GetFieldID(clazzSWModule, "remoteSourceName", "Ljava/lang/String;"); env->SetObjectField(retVal, fieldID, strToUTF8Java(env, sourceName));
+		retVal = newModule(env, module, type, sourceName);
 //SWLOGD("returning remote module [%s]: %s\n", sourceName.c_str(), modName.c_str());
 	}
 
@@ -2365,10 +2593,18 @@ JNIEXPORT void JNICALL Java_org_crosswire_android_sword_SWMgr_stopBibleSync
 
 jint JNI_OnLoad(JavaVM *vm, void *reserved) {
 	javaVM = vm;
+
+	JNIEnv *env = nullptr;
+	if (vm->GetEnv((void **) &env, JNI_VERSION_1_2) != JNI_OK) return -1;
+	cacheJavaIDs(env);
+
 	return JNI_VERSION_1_2;
 }
 
 void JNI_OnUnload(JavaVM *vm, void *reserved) {
+	JNIEnv *env = nullptr;
+	if (vm->GetEnv((void **) &env, JNI_VERSION_1_2) == JNI_OK) releaseJavaIDs(env);
+
 	delete bibleSync;
 	delete installMgr;
 	delete mgr;
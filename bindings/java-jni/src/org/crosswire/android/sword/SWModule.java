@@ -31,6 +31,11 @@ public class SWModule {
 	// if this is a shell module from a remote source...
 	private String remoteSourceName;
 
+	// the native module this names, filled in by the stub on first use
+	// and looked up again whenever nativeGeneration goes stale
+	private long nativeHandle;
+	private long nativeGeneration;
+
 
 	public static final int SEARCHTYPE_REGEX     =  1;
 	public static final int SEARCHTYPE_PHRASE    = -1;
@@ -59,6 +64,11 @@ public class SWModule {
 		public long   score;
 	}
 	
+	public static class Entry {
+		public String key;
+		public String text;
+	}
+
 	public static interface SearchProgressReporter {
 		public void progressReport(int percent);
 	}
@@ -71,6 +81,12 @@ public class SWModule {
 	public native String[]      getEntryAttribute(String level1, String level2, String level3, boolean filtered);
 	public native String[]      parseKeyList(String keyText);
 
+	// Many entries in one call: each key of keyList, as parseKeyList would
+	//	give them, rendered or with its entry attributes.  The module's
+	//	key is left where it was.
+	public native Entry[]       renderEntries(String keyList);
+	public native String[][]    getEntryAttributes(String keyList, String level1, String level2, String level3, boolean filtered);
+
 	// Special values handled for VerseKey modules: [+-][book|chapter]
 	//	(e.g.	"+chapter" will increment the VerseKey 1 chapter)
 	public native void          setKeyText(String key);
@@ -8,6 +8,7 @@
 SET(sword_base_frontend_SOURCES
 	src/frontend/swdisp.cpp
 	src/frontend/swlog.cpp
+	src/frontend/swmetrics.cpp
 )
 SOURCE_GROUP("src\\frontend" FILES ${sword_base_frontend_SOURCES})
 
@@ -36,6 +37,8 @@ SET(sword_base_mgr_SOURCES
 	src/mgr/swcacher.cpp
 	src/mgr/swsearchable.cpp
 	src/mgr/installmgr.cpp
+	src/mgr/modcatalog.cpp
+	src/mgr/moddelta.cpp
 	src/mgr/stringmgr.cpp
 )
 SOURCE_GROUP("src\\mgr" FILES ${sword_base_mgr_SOURCES})
@@ -60,9 +63,15 @@ SET(sword_base_module_SOURCES
 	src/modules/common/zverse4.cpp
 	src/modules/common/zstr.cpp
 	src/modules/common/entriesblk.cpp
+	src/modules/common/entryattridx.cpp
+	src/modules/common/entryattrstore.cpp
+	src/modules/common/searchjournal.cpp
+	src/modules/common/blockprefetcher.cpp
+	src/modules/common/blockwriter.cpp
 	src/modules/common/sapphire.cpp
 	src/modules/filters/swbasicfilter.cpp
 	src/modules/filters/swoptfilter.cpp
+	src/modules/filters/filterpipeline.cpp
 
 	src/modules/filters/gbfhtml.cpp
 	src/modules/filters/gbfxhtml.cpp
@@ -168,12 +177,16 @@ SOURCE_GROUP("src\\modules" FILES ${sword_base_module_SOURCES})
 SET(sword_base_utilfns_SOURCES
 	src/utilfuns/swobject.cpp
 	src/utilfuns/utilstr.cpp
+	src/utilfuns/utf8kernels.cpp
 	src/utilfuns/utilxml.cpp
 	src/utilfuns/swversion.cpp
 	src/utilfuns/swbuf.cpp
 	src/utilfuns/ftpparse.c
 	src/utilfuns/url.cpp
 	src/utilfuns/roman.cpp
+	src/utilfuns/multimatcher.cpp
+	src/utilfuns/xmltokenlist.cpp
+	src/utilfuns/swthread.cpp
 )
 SOURCE_GROUP("src\\utilfns" FILES ${sword_base_utilfns_SOURCES})
 
@@ -272,6 +285,8 @@ SET(sword_icu_found_SOURCES
 
 # Headers
 SET(SWORD_INSTALL_HEADERS
+	include/blockprefetcher.h
+	include/blockwriter.h
 	include/bz2comprs.h
 	include/canon.h
 	include/canon_abbrevs.h
@@ -282,7 +297,10 @@ SET(SWORD_INSTALL_HEADERS
 	include/echomod.h
 	include/encfiltmgr.h
 	include/entriesblk.h
+	include/entryattridx.h
+	include/entryattrstore.h
 	include/femain.h
+	include/filterpipeline.h
 	include/filemgr.h
 	include/versificationmgr.h
 	include/flatapi.h
@@ -317,7 +335,10 @@ SET(SWORD_INSTALL_HEADERS
 	include/localemgr.h
 	include/lzsscomprs.h
 	include/markupfiltmgr.h
+	include/modcatalog.h
+	include/moddelta.h
 	include/multimapwdef.h
+	include/multimatcher.h
 	include/nullim.h
 
 	include/osisenum.h
@@ -358,6 +379,7 @@ SET(SWORD_INSTALL_HEADERS
 	include/rtfplain.h
 	include/sapphire.h
 	include/scsuutf8.h
+	include/searchjournal.h
 	include/strkey.h
 	include/swbasicfilter.h
 	include/swbuf.h
@@ -376,6 +398,7 @@ SET(SWORD_INSTALL_HEADERS
 	include/swlocale.h
 	include/swlog.h
 	include/swmacs.h
+	include/swmetrics.h
 	include/swmgr.h
 	include/stringmgr.h
 	include/swmodule.h
@@ -383,6 +406,7 @@ SET(SWORD_INSTALL_HEADERS
 	include/swobject.h
 	include/swsearchable.h
 	include/swtext.h
+	include/swthread.h
     "${CMAKE_CURRENT_BINARY_DIR}/include/swversion.h"
 	include/sysdata.h
 
@@ -432,7 +456,9 @@ SET(SWORD_INSTALL_HEADERS
 	include/utilxml.h
 
 	include/versekey.h
+	include/verseposition.h
 	include/versetreekey.h
+	include/xmltokenlist.h
 	include/xzcomprs.h
 	include/zcom.h
 	include/zcom4.h
@@ -0,0 +1,120 @@
+/******************************************************************************
+ *
+ * blockprefetcher.h -	class BlockPrefetcher: decompresses the blocks after
+ *			the one a compressed module is reading, on a thread
+ *			of its own, while the entries of the current block
+ *			are being used
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef BLOCKPREFETCHER_H
+#define BLOCKPREFETCHER_H
+
+#include <swbuf.h>
+#include <swthread.h>
+#include <list>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+class SWCompress;
+
+/**
+ * A compressed module reading its blocks one after another, as a search,
+ * an export or a chapter does, tells its prefetcher each time it has to
+ * load one.  Once it has loaded two in a row, the prefetcher reads the
+ * next few blocks and decompresses them on a thread of its own, so when
+ * the reader crosses into the next block it's ready.  Loading any other
+ * block is taken as random access: what was read ahead is dropped and
+ * nothing more is until reading runs forward again.
+ *
+ * Blocks are read from disk on the reader's thread, since FileMgr isn't
+ * thread safe; only decompression runs on the prefetch thread, with its
+ * own copy of the reader's compressor.  Codecs which can't be copied
+ * (see SWCompress::clone()) aren't prefetched.
+ */
+class SWDLLEXPORT BlockPrefetcher {
+
+public:
+	/** reads one block, compressed (and deciphered), on the reader's thread
+	 * @return false if there is no such block
+	 */
+	typedef bool (*BlockReader)(const void *source, char testament, unsigned long block, SWBuf &compressed);
+
+private:
+	struct Block {
+		char testament;
+		unsigned long number;
+		SWBuf data;		// compressed until the prefetch thread gets to it
+		bool decoded;
+	};
+
+	static int depth;
+
+	SWCompress *decoder;
+	SWBuf owner;
+	std::list<Block> blocks;
+	SWThread thread;
+	char lastTestament;
+	unsigned long lastBlock;
+
+	static void decodeBlocks(void *prefetcher);
+
+	// not copyable
+	BlockPrefetcher(const BlockPrefetcher &);
+	BlockPrefetcher &operator =(const BlockPrefetcher &);
+
+public:
+	/**
+	 * @param compressor the reader's compressor, copied for the prefetch thread
+	 */
+	BlockPrefetcher(const SWCompress *compressor);
+
+	/** waits for the prefetch thread, if it is running */
+	~BlockPrefetcher();
+
+	/** sets how many blocks are read ahead of the one in use
+	 * @param count 0 to turn prefetching off; 2 by default
+	 */
+	static void setDepth(int count);
+
+	/** @return how many blocks are read ahead of the one in use */
+	static int getDepth();
+
+	/** Hands over a block, if it was read ahead.  Call each time a block
+	 * has to be loaded, before loading it.
+	 * @param text receives the block, decompressed
+	 * @return true if the block was ready
+	 */
+	bool take(char testament, unsigned long block, SWBuf &text);
+
+	/** Notes that a block was loaded and, if reading is running forward,
+	 * reads ahead of it.
+	 * @param owner what to count decompression against in SWMetrics
+	 * @param reader reads a block for source
+	 */
+	void readAhead(char testament, unsigned long block, const char *owner, BlockReader reader, const void *source);
+
+	/** forgets every block read ahead, e.g., when the module is written to */
+	void clear();
+};
+
+SWORD_NAMESPACE_END
+#endif
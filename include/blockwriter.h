@@ -0,0 +1,126 @@
+/******************************************************************************
+ *
+ * blockwriter.h -	class BlockWriter: compresses the blocks a compressed
+ *			module fills on threads of their own, and writes
+ *			them out in the order they were filled
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef BLOCKWRITER_H
+#define BLOCKWRITER_H
+
+#include <swbuf.h>
+#include <swthread.h>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+class SWCompress;
+
+/**
+ * A compressed module being written, as by an importer, hands each block
+ * it has filled to its writer instead of compressing it there and then.
+ * The writer compresses it on a thread of its own, with its own copy of
+ * the module's compressor, while the module fills the next ones; up to
+ * getThreads() blocks are compressed at once.  The module then writes
+ * the compressed blocks out itself, on its own thread, in the order they
+ * were filled, so its files come out just as if each had been compressed
+ * in turn.
+ *
+ * With fewer than two threads, or a codec which can't be copied (see
+ * SWCompress::clone()), nothing is handed over and the module compresses
+ * each block itself, as it always has.
+ */
+class SWDLLEXPORT BlockWriter {
+
+public:
+	/** writes out one compressed block, on the module's thread
+	 * @param size the size of the block before it was compressed
+	 */
+	typedef void (*BlockCommitter)(const void *module, char testament, long block, unsigned long size, SWBuf &compressed);
+
+private:
+	struct Slot {
+		SWCompress *compressor;
+		SWThread thread;
+		char testament;
+		long block;
+		unsigned long size;
+		SWBuf data;		// compressed once the thread is done with it
+		bool used;
+	};
+
+	static int threads;
+
+	const SWCompress *compressor;
+	BlockCommitter committer;
+	const void *module;
+	Slot *slots;
+	int slotCount;
+	int next;		// the slot the next block goes in: the oldest one pending
+
+	static void compressBlock(void *slot);
+	void commit(Slot &slot);
+
+	// not copyable
+	BlockWriter(const BlockWriter &);
+	BlockWriter &operator =(const BlockWriter &);
+
+public:
+	/**
+	 * @param compressor the module's compressor, copied for each thread
+	 * @param committer writes out a compressed block for module
+	 */
+	BlockWriter(const SWCompress *compressor, BlockCommitter committer, const void *module);
+
+	/** waits for the threads, if any are running; blocks still pending
+	 * are lost, so call finish() first
+	 */
+	~BlockWriter();
+
+	/** sets how many blocks may be compressed at once
+	 * @param count 1 (the default) or less to compress each block in turn
+	 */
+	static void setThreads(int count);
+
+	/** @return how many blocks may be compressed at once */
+	static int getThreads();
+
+	/** Hands over a filled block to be compressed and written out.  If as
+	 * many are already being compressed as there are threads, the oldest
+	 * one is waited for and written out first.
+	 * @param data the block, uncompressed
+	 * @return false if the block wasn't taken; the caller must compress
+	 *	and write it itself
+	 */
+	bool add(char testament, long block, const char *data, unsigned long size);
+
+	/** @return how many blocks handed over for a testament are not yet
+	 * written out, i.e., how many block numbers past the end of the
+	 * block index are taken
+	 */
+	long getPending(char testament) const;
+
+	/** waits for every block handed over and writes them out, in order */
+	void finish();
+};
+
+SWORD_NAMESPACE_END
+#endif
@@ -39,6 +39,7 @@ public:
 
 	virtual void encode(void);
 	virtual void decode(void);
+	virtual SWCompress *clone() const;
 };
 
 SWORD_NAMESPACE_END
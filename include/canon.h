@@ -32,7 +32,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks - initialize static instance for all canonical text names
  *		and chapmax
  */
-struct sbook otbooks[] = {
+const struct sbook otbooks[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -74,7 +74,7 @@ struct sbook otbooks[] = {
   {"Malachi", "Mal", "Mal", 4},
   {"", "", "", 0}
 };
-struct sbook ntbooks[] = {
+const struct sbook ntbooks[] = {
   {"Matthew", "Matt", "Matt", 28},
   {"Mark", "Mark", "Mark", 16},
   {"Luke", "Luke", "Luke", 24},
@@ -109,7 +109,7 @@ struct sbook ntbooks[] = {
  *	Maximum verses per chapter
  */
 
-int vm[] = {
+const int vm[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
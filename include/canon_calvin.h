@@ -64,7 +64,7 @@ SWORD_NAMESPACE_START
  *	Maximum verses per chapter
  */
 
-int vm_calvin[] = {
+const int vm_calvin[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
@@ -289,7 +289,7 @@ int vm_calvin[] = {
   27, 21
 };
 
-unsigned char mappings_calvin[] = {
+const unsigned char mappings_calvin[] = {
     0,
     4,   13,  1,   0,   12,  16,  0,
     4,   13,  2,   0,   13,  1,   0,
@@ -32,7 +32,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_catholic - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_catholic[] = {
+const struct sbook otbooks_catholic[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -86,7 +86,7 @@ struct sbook otbooks_catholic[] = {
  *	Maximum verses per chapter
  */
 
-int vm_catholic[] = {
+const int vm_catholic[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
@@ -46,7 +46,7 @@ SWORD_NAMESPACE_START
  *	Maximum verses per chapter
  */
 
-int vm_darbyfr[] = {
+const int vm_darbyfr[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
@@ -271,7 +271,7 @@ int vm_darbyfr[] = {
   27, 21
 };
 
-unsigned char mappings_darbyfr[] = {
+const unsigned char mappings_darbyfr[] = {
     0,
     3,   5,   20,  0,   6,   1,   0,
     3,   6,   1,   0,   6,   8,   0,
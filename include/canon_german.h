@@ -32,7 +32,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_german - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_german[] = {
+const struct sbook otbooks_german[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -79,7 +79,7 @@ struct sbook otbooks_german[] = {
  *	Maximum verses per chapter
  */
 
-int vm_german[] = {
+const int vm_german[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
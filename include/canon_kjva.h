@@ -32,7 +32,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_kjva - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_kjva[] = {
+const struct sbook otbooks_kjva[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -95,7 +95,7 @@ struct sbook otbooks_kjva[] = {
  *	Maximum verses per chapter
  */
 
-int vm_kjva[] = {
+const int vm_kjva[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
@@ -32,7 +32,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_luther - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_luther[] = {
+const struct sbook otbooks_luther[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -85,7 +85,7 @@ struct sbook otbooks_luther[] = {
   {"", "", "", 0}
 };
 
-struct sbook ntbooks_luther[] = {
+const struct sbook ntbooks_luther[] = {
   {"Matthew", "Matt", "Matt", 28},
   {"Mark", "Mark", "Mark", 16},
   {"Luke", "Luke", "Luke", 24},
@@ -120,7 +120,7 @@ struct sbook ntbooks_luther[] = {
  *	Maximum verses per chapter
  */
 
-int vm_luther[] = {
+const int vm_luther[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
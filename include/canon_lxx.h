@@ -45,7 +45,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_lxx - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_lxx[] = {
+const struct sbook otbooks_lxx[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -112,7 +112,7 @@ struct sbook otbooks_lxx[] = {
 /******************************************************************************
  *	Maximum verses per chapter
  */
-int vm_lxx[] = {
+const int vm_lxx[] = {
   // Genesis
   31, 25, 25, 26, 32, 23, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 39, 18,
@@ -32,7 +32,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_mt - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_mt[] = {
+const struct sbook otbooks_mt[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -81,7 +81,7 @@ struct sbook otbooks_mt[] = {
  *	Maximum verses per chapter
  */
 
-int vm_mt[] = {
+const int vm_mt[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
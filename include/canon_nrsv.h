@@ -40,7 +40,7 @@ SWORD_NAMESPACE_START
  *	Maximum verses per chapter
  */
 
-int vm_nrsv[] = {
+const int vm_nrsv[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
@@ -264,7 +264,7 @@ int vm_nrsv[] = {
   27, 21
 };
 
-unsigned char mappings_nrsv[] = {
+const unsigned char mappings_nrsv[] = {
     0,
     66,  12,  18,  19,  13,  1,   0,
     66,  13,  1,   1,   13,  1,   0,
@@ -31,7 +31,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_nrsva - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_nrsva[] = {
+const struct sbook otbooks_nrsva[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -97,7 +97,7 @@ struct sbook otbooks_nrsva[] = {
  *	Maximum verses per chapter
  */
 
-int vm_nrsva[] = {
+const int vm_nrsva[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
@@ -33,11 +33,11 @@ SWORD_NAMESPACE_START
  * [on]tbooks_null - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_null[] = {
+const struct sbook otbooks_null[] = {
   {"", "", "", 0}
 };
 
-struct sbook ntbooks_null[] = {
+const struct sbook ntbooks_null[] = {
   {"", "", "", 0}
 };
 
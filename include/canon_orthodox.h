@@ -36,7 +36,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_orthodox - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_orthodox[] = {
+const struct sbook otbooks_orthodox[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -98,7 +98,7 @@ struct sbook otbooks_orthodox[] = {
 /******************************************************************************
  *	Maximum verses per chapter
  */
-int vm_orthodox[] = {
+const int vm_orthodox[] = {
   // Genesis
   31, 25, 25, 26, 32, 23, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 39, 18,
@@ -47,7 +47,7 @@ SWORD_NAMESPACE_START
  *	Maximum verses per chapter
  */
 
-int vm_segond[] = {
+const int vm_segond[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
@@ -272,7 +272,7 @@ int vm_segond[] = {
   27, 21
 };
 
-unsigned char mappings_segond[] = {
+const unsigned char mappings_segond[] = {
     0,
     2,   7,   26,  0,   8,   1,   0,
     2,   8,   1,   0,   8,   5,   0,
@@ -39,7 +39,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_synodal - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_synodal[] = {
+const struct sbook otbooks_synodal[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -94,7 +94,7 @@ struct sbook otbooks_synodal[] = {
   {"", "", "", 0}
 };
 
-struct sbook ntbooks_synodal[] = {
+const struct sbook ntbooks_synodal[] = {
   {"Matthew", "Matt", "Matt", 28},
   {"Mark", "Mark", "Mark", 16},
   {"Luke", "Luke", "Luke", 24},
@@ -129,7 +129,7 @@ struct sbook ntbooks_synodal[] = {
  *	Maximum verses per chapter
  */
 
-int vm_synodal[] = {
+const int vm_synodal[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
@@ -393,7 +393,7 @@ int vm_synodal[] = {
   27, 21
 };
 
-unsigned char mappings_synodal[] = {
+const unsigned char mappings_synodal[] = {
     'P', 'r', 'A', 'z', 'a', 'r', 0,
     'S', 'u', 's', 0,
     'B', 'e', 'l', 0,
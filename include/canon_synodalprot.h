@@ -31,7 +31,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_synodalProt - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_synodalProt[] = {
+const struct sbook otbooks_synodalProt[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -80,7 +80,7 @@ struct sbook otbooks_synodalProt[] = {
  *	Maximum verses per chapter
  */
 
-int vm_synodalProt[] = {
+const int vm_synodalProt[] = {
   // Genesis
   31, 25, 24, 26, 32, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
@@ -36,7 +36,7 @@ SWORD_NAMESPACE_START
  * [on]tbooks_vulg - initialize static instance for all canonical
  *		 text names and chapmax
  */
-struct sbook otbooks_vulg[] = {
+const struct sbook otbooks_vulg[] = {
   {"Genesis", "Gen", "Gen", 50},
   {"Exodus", "Exod", "Exod", 40},
   {"Leviticus", "Lev", "Lev", 27},
@@ -86,7 +86,7 @@ struct sbook otbooks_vulg[] = {
   {"", "", "", 0}
 };
 
-struct sbook ntbooks_vulg[] = {
+const struct sbook ntbooks_vulg[] = {
   {"Matthew", "Matt", "Matt", 28},
   {"Mark", "Mark", "Mark", 16},
   {"Luke", "Luke", "Luke", 24},
@@ -126,7 +126,7 @@ struct sbook ntbooks_vulg[] = {
  *	Maximum verses per chapter
  */
 
-int vm_vulg[] = {
+const int vm_vulg[] = {
   // Genesis
   31, 25, 24, 26, 31, 22, 24, 22, 29, 32,
   32, 20, 18, 24, 21, 16, 27, 33, 38, 18,
@@ -386,7 +386,7 @@ int vm_vulg[] = {
   20
 };
 
-unsigned char mappings_vulg[] = {
+const unsigned char mappings_vulg[] = {
      'E', 'p', 'J', 'e', 'r', 0,
      'P', 'r', 'A', 'z', 'a', 'r', 0,
      'S', 'u', 's', 0,
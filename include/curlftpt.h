@@ -34,11 +34,17 @@ class CURL;
 class SWDLLEXPORT CURLFTPTransport : public RemoteTransport {
 	CURL *session;
 
+	char transfer(const char *destPath, const char *sourceURL, SWBuf *destBuf, long offset, long length = 0, const char *resumeValidator = 0);
+	SWBuf fileValidator();
+
 public:
 	CURLFTPTransport(const char *host, StatusReporter *statusReporter = 0);
 	~CURLFTPTransport();
 	
 	virtual char getURL(const char *destPath, const char *sourceURL, SWBuf *destBuf = 0);
+	virtual char resumeURL(const char *destPath, const char *sourceURL, long offset, const char *validator);
+	virtual char getURLRange(const char *sourceURL, long offset, long length, SWBuf *destBuf);
+	virtual RemoteTransport *clone() const;
 };
 
 
@@ -34,12 +34,17 @@ class CURL;
 class SWDLLEXPORT CURLHTTPTransport : public RemoteTransport {
 	CURL *session;
 
+	char transfer(const char *destPath, const char *sourceURL, SWBuf *destBuf, long offset, long length = 0, const char *resumeValidator = 0);
+
 public:
 	CURLHTTPTransport(const char *host, StatusReporter *statusReporter = 0);
 	~CURLHTTPTransport();
 
 	virtual std::vector<struct DirEntry> getDirList(const char *dirURL);
 	virtual char getURL(const char *destPath, const char *sourceURL, SWBuf *destBuf = 0);
+	virtual char resumeURL(const char *destPath, const char *sourceURL, long offset, const char *validator);
+	virtual char getURLRange(const char *sourceURL, long offset, long length, SWBuf *destBuf);
+	virtual RemoteTransport *clone() const;
 };
 
 
@@ -0,0 +1,124 @@
+/******************************************************************************
+ *
+ * entryattridx.h -	class EntryAttributeIndex: a persisted map of entry
+ *			attribute values to the module entries which carry
+ *			them, used to answer entry attribute searches
+ *			without rendering every entry
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef ENTRYATTRIDX_H
+#define ENTRYATTRIDX_H
+
+#include <swbuf.h>
+#include <map>
+#include <vector>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+/**
+ * Maps (attribute type, attribute name, value) to the sorted list of module
+ * indices whose entry attributes carry that value, e.g.,
+ * (Word, Lemma, G3056) -> { 24410, 24412, ... }.  The level between type and
+ * name (the per-entry word or footnote number) is not kept.
+ *
+ * The index records a signature of the module data files it was built from
+ * so a stale index can be detected and ignored.
+ */
+class SWDLLEXPORT EntryAttributeIndex {
+
+public:
+	/** name of the index file inside a module's data directory */
+	static const char *FILENAME;
+
+	/** sorted, unique module indices */
+	typedef std::vector<long> Postings;
+
+private:
+	typedef std::map<SWBuf, Postings> ValueMap;
+	typedef std::map<SWBuf, ValueMap> NameMap;
+	typedef std::map<SWBuf, NameMap> TypeMap;
+
+	SWBuf dataPath;
+	SWBuf signature;
+	TypeMap types;
+
+public:
+	/**
+	 * @param dataPath the module's data directory (AbsoluteDataPath)
+	 */
+	EntryAttributeIndex(const char *dataPath);
+
+	/** Computes a signature of the data files in a module's data directory
+	 * from their names, sizes and modification times, and the content of
+	 * the smaller ones, skipping search framework files and the search
+	 * journal.
+	 */
+	static SWBuf getDataSignature(const char *dataPath);
+
+	/** Records that the entry at module index carries an attribute.
+	 * Adding entries in increasing index order is cheapest.
+	 */
+	void add(const char *type, const char *name, const char *value, long index);
+
+	/** forgets every attribute of the entries at the given sorted, unique
+	 * module indices, e.g., before adding them again once they're edited
+	 */
+	void remove(const Postings &indices);
+
+	/** forget all postings */
+	void clear();
+
+	/** Writes the index, stamped with the current data signature
+	 * @return 0 on success; -1 if the file could not be written
+	 */
+	signed char save();
+
+	/** Reads the index from disk
+	 * @return true if a readable index was found
+	 */
+	bool load();
+
+	/** @return the signature of the data files the index was built from */
+	const SWBuf &getSignature() const { return signature; }
+
+	/** @return true if the data files haven't changed since the index was built */
+	bool isCurrent() const;
+
+	/** Collects the module indices matching an entry attribute query.
+	 *
+	 * @param type attribute type (e.g., Word); empty for any
+	 * @param name attribute name (e.g., Lemma); empty for any
+	 * @param includeComponents also match name components (Lemma.1, Lemma.2, ...)
+	 * @param value value to look for, or 0 to match any entry which has the attribute;
+	 *	an empty value matches only empty attribute values
+	 * @param matchWholeEntry compare the whole value rather than look for a substring
+	 * @param icase ignore case
+	 * @param results receives the sorted, unique matching module indices
+	 */
+	void find(const char *type, const char *name, bool includeComponents, const char *value, bool matchWholeEntry, bool icase, Postings &results) const;
+
+	/** full path of the index file for a module data directory */
+	static SWBuf getIndexPath(const char *dataPath);
+};
+
+SWORD_NAMESPACE_END
+#endif
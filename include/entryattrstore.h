@@ -0,0 +1,141 @@
+/******************************************************************************
+ *
+ * entryattrstore.h -	class EntryAttributeStore: the entry attributes of
+ *			a module's current entry, kept flat, with interned
+ *			names and values in one buffer reused entry to entry
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef ENTRYATTRSTORE_H
+#define ENTRYATTRSTORE_H
+
+#include <swbuf.h>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+typedef std::map < SWBuf, SWBuf, std::less < SWBuf > > AttributeValue;
+typedef std::map < SWBuf, AttributeValue, std::less < SWBuf > > AttributeList;
+typedef std::map < SWBuf, AttributeList, std::less < SWBuf > > AttributeTypeList;
+
+/**
+ * Holds attributes addressed, as in an AttributeTypeList, by a type (e.g.,
+ * Word), an item of that type (the word or footnote number, e.g., 003) and a
+ * name (e.g., Lemma).  Type, item and name are interned, so after the first
+ * few entries setting an attribute allocates nothing; values are copied into
+ * one buffer which clear() empties without giving back.
+ *
+ * Attributes are visited in the order they were first set:
+ *
+ *	for (unsigned long i = store.find("Word"); i < store.getCount(); i = store.find("Word", 0, 0, i + 1)) {
+ *		... store.getItem(i), store.getName(i), store.getValue(i) ...
+ *	}
+ *
+ * Pointers to values are good until the store is next changed; pointers to
+ * types, items and names for the life of the store.
+ */
+class SWDLLEXPORT EntryAttributeStore {
+
+	struct Attribute {
+		int type;
+		int item;
+		int name;
+		bool firstOfItem;
+		unsigned long value;	// offset into values
+		unsigned long length;
+	};
+
+	// interned strings, by id, and an open addressed table of id + 1 by hash
+	std::deque<SWBuf> names;
+	std::vector<int> nameSlots;
+
+	std::vector<Attribute> attributes;
+	std::vector<char> values;
+
+	// open addressed table of attributes by (type, item, name), and by
+	// (type, item, -1) for the first attribute of each item.  A slot is in
+	// use only if its stamp is the current one, so clear() needn't touch
+	// the table.
+	struct Slot {
+		unsigned int stamp;
+		int type;
+		int item;
+		int name;
+		unsigned long index;
+	};
+	std::vector<Slot> slots;
+	unsigned long slotCount;
+	unsigned int stamp;
+
+	int intern(const char *text);
+	int lookUp(const char *text) const;
+	const Slot *findSlot(int type, int item, int name) const;
+	void addSlot(int type, int item, int name, unsigned long index);
+	void growSlots();
+	unsigned long storeValue(const char *value, unsigned long length);
+
+public:
+	EntryAttributeStore();
+
+	/** forgets every attribute, keeping names and buffers for the next entry */
+	void clear();
+
+	/** @return how many attributes there are */
+	unsigned long getCount() const { return (unsigned long)attributes.size(); }
+
+	/** Sets an attribute, replacing any value it had
+	 * @param length of value; -1 if it is NUL terminated
+	 */
+	void set(const char *type, const char *item, const char *name, const char *value, long length = -1);
+
+	/** Appends to an attribute's value, setting it if it has none */
+	void append(const char *type, const char *item, const char *name, const char *value, long length = -1);
+
+	/** @return an attribute's value, or 0 if it isn't set */
+	const char *get(const char *type, const char *item, const char *name) const;
+
+	/** @return the index of the first attribute at or after from of a type, an
+	 * item and a name, any of which may be 0 for any; getCount() if none
+	 */
+	unsigned long find(const char *type, const char *item = 0, const char *name = 0, unsigned long from = 0) const;
+
+	const char *getType(unsigned long i) const { return names[attributes[i].type]; }
+	const char *getItem(unsigned long i) const { return names[attributes[i].item]; }
+	const char *getName(unsigned long i) const { return names[attributes[i].name]; }
+	const char *getValue(unsigned long i) const { return &values[attributes[i].value]; }
+	unsigned long getValueLength(unsigned long i) const { return attributes[i].length; }
+
+	/** @return true if attribute i was the first set of its item, which
+	 * makes visiting those a way to visit each item once
+	 */
+	bool isFirstOfItem(unsigned long i) const { return attributes[i].firstOfItem; }
+
+	/** replaces the contents of map with these attributes */
+	void copyTo(AttributeTypeList &map) const;
+
+	/** replaces these attributes with the contents of map */
+	void assign(const AttributeTypeList &map);
+};
+
+SWORD_NAMESPACE_END
+#endif
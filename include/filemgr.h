@@ -188,6 +188,7 @@ public:
 	static int openFileReadOnly(const char *fName);
 	static void closeFile(int fd);
 	static long write(int fd, const void *buf, long count);
+	static long read(int fd, void *buf, long count);
 
 	static int copyFile(const char *srcFile, const char *destFile);
 	static int copyDir(const char *srcDir, const char *destDir);
@@ -0,0 +1,103 @@
+/******************************************************************************
+ *
+ * filterpipeline.h -	class FilterPipeline: a module's option and strip
+ *			filters compiled into the passes actually needed
+ *			for the current option settings
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef FILTERPIPELINE_H
+#define FILTERPIPELINE_H
+
+#include <swbuf.h>
+#include <xmltokenlist.h>
+#include <list>
+#include <vector>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+class SWKey;
+class SWModule;
+class SWFilter;
+class SWOptionFilter;
+
+typedef std::list < SWFilter * >FilterList;
+typedef std::list < SWOptionFilter * >OptionFilterList;
+
+/**
+ * Runs a list of option filters followed by a list of plain filters, as
+ * SWModule::stripText() does, but:
+ *	- option filters which are inactive at their current setting
+ *	  (SWOptionFilter::isActive()) are not called at all
+ *	- consecutive character filters (SWOptionFilter::isCharFilter()) are
+ *	  fused into a single decode / map / encode pass over the text,
+ *	  which writes what they leave alone, bad UTF-8 included, as
+ *	  their own passes would (SWOptionFilter::isReencoding())
+ *	- consecutive token filters (SWOptionFilter::isTokenFilter()) share
+ *	  one XMLTokenList: the markup is split once, each filter edits the
+ *	  tokens, and the result is joined once
+ *	- the fused pass writes into a scratch buffer kept between calls
+ *
+ * The pipeline is compiled for one snapshot of the filter lists and option
+ * settings; call isCurrent() before use and compile() again when it isn't.
+ */
+class SWDLLEXPORT FilterPipeline {
+
+	struct Stage {
+		SWFilter *filter;				// run as is, or
+		std::vector<const SWOptionFilter *> charFilters;	// fused, if filter is 0, or
+		std::vector<SWOptionFilter *> tokenFilters;	// sharing tokens, if filter is 0
+		bool reencodes;					// if any of charFilters isReencoding()
+	};
+
+	// what we were compiled from, to notice changes
+	std::vector<SWFilter *> sources;
+	std::vector<SWOptionFilter *> sourceOptions;	// sources which are option filters, else 0
+	std::vector<bool> activeSources;
+
+	std::vector<Stage> stages;
+	SWBuf scratch;
+	XMLTokenList tokens;
+	bool compiled;
+
+public:
+	FilterPipeline();
+
+	/** (Re)builds the pipeline for the filters' current option settings
+	 * @param optionFilters run first, in order
+	 * @param filters run afterward, in order; option filters found here are treated as above
+	 */
+	void compile(const OptionFilterList *optionFilters, const FilterList *filters);
+
+	/** @return true if compiled from these same lists and no filter has since
+	 * been switched on or off
+	 */
+	bool isCurrent(const OptionFilterList *optionFilters, const FilterList *filters) const;
+
+	/** runs text through the compiled pipeline */
+	void processText(SWBuf &text, const SWKey *key = 0, const SWModule *module = 0);
+
+	/** @return the number of passes the pipeline makes over a text */
+	int getPassCount() const { return (int)stages.size(); }
+};
+
+SWORD_NAMESPACE_END
+#endif
@@ -51,6 +51,36 @@ struct org_crosswire_sword_SearchHit {
 };
 
 
+/*
+ * Strings stored back to back, each ended by a 0, for the *Table calls,
+ * which hand large results to a binding in one piece: the string at i
+ * starts at strings + offsets[i]
+ */
+struct org_crosswire_sword_StringTable {
+	int count;
+	const char *strings;
+	const long *offsets;
+};
+
+
+/*
+ * The hits of a search as one table; scores[i] goes with keys string i
+ */
+struct org_crosswire_sword_SearchHitTable {
+	const char *modName;
+	struct org_crosswire_sword_StringTable keys;
+	const long *scores;
+};
+
+
+struct org_crosswire_sword_MetricsSample {
+	char *owner;
+	char *filter;
+	char *name;
+	unsigned long value;
+};
+
+
 #undef org_crosswire_sword_SWModule_SEARCHTYPE_REGEX
 #define org_crosswire_sword_SWModule_SEARCHTYPE_REGEX 1L
 #undef org_crosswire_sword_SWModule_SEARCHTYPE_PHRASE
@@ -105,6 +135,49 @@ typedef void (*org_biblesync_MessageReceivedCallback)(char, const char *, const
 const struct org_crosswire_sword_SearchHit * SWDLLEXPORT org_crosswire_sword_SWModule_search
 	(SWHANDLE hSWModule, const char *searchString, int searchType, long flags, const char *scope, org_crosswire_sword_SWModule_SearchCallback progressReporter);
 
+typedef void (*org_crosswire_sword_SWModule_SearchHitCallback)(const char *modName, const char *key, long score);
+
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    searchPage
+ * Signature: (Ljava/lang/String;IJLjava/lang/String;IJLorg/crosswire/sword/SWModule/SearchHitReporter;Lorg/crosswire/sword/SWModule/SearchProgressReporter;)[Lorg/crosswire/sword/SWModule/SearchHit;
+ *
+ * Starts a paged search: returns once maxHits hits have been found, or
+ * timeBudgetMillis have passed, or the search is complete (0 for no limit).
+ * hitReporter (may be 0) is called with each hit as it is found.
+ */
+const struct org_crosswire_sword_SearchHit * SWDLLEXPORT org_crosswire_sword_SWModule_searchPage
+	(SWHANDLE hSWModule, const char *searchString, int searchType, long flags, const char *scope, int maxHits, long timeBudgetMillis, org_crosswire_sword_SWModule_SearchHitCallback hitReporter, org_crosswire_sword_SWModule_SearchCallback progressReporter);
+
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    searchNextPage
+ * Signature: (IJLorg/crosswire/sword/SWModule/SearchHitReporter;Lorg/crosswire/sword/SWModule/SearchProgressReporter;)[Lorg/crosswire/sword/SWModule/SearchHit;
+ *
+ * Continues the last searchPage where it stopped
+ */
+const struct org_crosswire_sword_SearchHit * SWDLLEXPORT org_crosswire_sword_SWModule_searchNextPage
+	(SWHANDLE hSWModule, int maxHits, long timeBudgetMillis, org_crosswire_sword_SWModule_SearchHitCallback hitReporter, org_crosswire_sword_SWModule_SearchCallback progressReporter);
+
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    getSearchHitTable
+ * Signature: ()Lorg/crosswire/sword/SWModule/SearchHitTable;
+ *
+ * The hits the last search, searchPage or searchNextPage returned, in the
+ * same storage, which lasts until the next of them
+ */
+const struct org_crosswire_sword_SearchHitTable * SWDLLEXPORT org_crosswire_sword_SWModule_getSearchHitTable
+	(SWHANDLE hSWModule);
+
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    isSearchComplete
+ * Signature: ()Z
+ */
+char SWDLLEXPORT org_crosswire_sword_SWModule_isSearchComplete
+	(SWHANDLE hSWModule);
+
 /*
  * Class:     org_crosswire_sword_SWModule
  * Method:    error
@@ -129,6 +202,16 @@ long SWDLLEXPORT org_crosswire_sword_SWModule_getEntrySize
 const char ** SWDLLEXPORT org_crosswire_sword_SWModule_getEntryAttribute
 	(SWHANDLE hSWModule, const char *level1, const char *level2, const char *level3, char filteredBool);
 
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    getEntryAttributeTable
+ * Signature: (Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Z)Lorg/crosswire/sword/StringTable;
+ *
+ * As getEntryAttribute, as one table, in the storage getEntryAttribute uses
+ */
+const struct org_crosswire_sword_StringTable * SWDLLEXPORT org_crosswire_sword_SWModule_getEntryAttributeTable
+	(SWHANDLE hSWModule, const char *level1, const char *level2, const char *level3, char filteredBool);
+
 /*
  * Class:     org_crosswire_sword_SWModule
  * Method:    parseKeyList
@@ -137,6 +220,16 @@ const char ** SWDLLEXPORT org_crosswire_sword_SWModule_getEntryAttribute
 const char ** SWDLLEXPORT org_crosswire_sword_SWModule_parseKeyList
 	(SWHANDLE hSWModule, const char *keyText);
 
+/*
+ * Class:     org_crosswire_sword_SWModule
+ * Method:    parseKeyListTable
+ * Signature: (Ljava/lang/String;)Lorg/crosswire/sword/StringTable;
+ *
+ * As parseKeyList, as one table, in the storage parseKeyList uses
+ */
+const struct org_crosswire_sword_StringTable * SWDLLEXPORT org_crosswire_sword_SWModule_parseKeyListTable
+	(SWHANDLE hSWModule, const char *keyText);
+
 /*
  * Class:     org_crosswire_sword_SWModule
  * Method:    setKeyText
@@ -621,6 +714,17 @@ void SWDLLEXPORT org_crosswire_sword_SWLog_logTimedInformation(const char *msg);
 void SWDLLEXPORT org_crosswire_sword_SWLog_setLogLevel(int level);
 int SWDLLEXPORT org_crosswire_sword_SWLog_getLogLevel();
 
+/*
+ * SWMetrics: see swmetrics.h.  A snapshot is an array ended by an entry
+ * with a null owner, and stays valid until the next snapshot is taken.
+ */
+void SWDLLEXPORT org_crosswire_sword_SWMetrics_setEnabled(char enabled);
+char SWDLLEXPORT org_crosswire_sword_SWMetrics_isEnabled();
+void SWDLLEXPORT org_crosswire_sword_SWMetrics_reset();
+void SWDLLEXPORT org_crosswire_sword_SWMetrics_setReportInterval(unsigned long seconds);
+const struct org_crosswire_sword_MetricsSample * SWDLLEXPORT org_crosswire_sword_SWMetrics_getSnapshot();
+const char * SWDLLEXPORT org_crosswire_sword_SWMetrics_getReport();
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,11 +36,13 @@ class SWModule;
 class SWConfig;
 class RemoteTransport;
 class StatusReporter;
+class ModuleCatalog;
 
 /** A remote installation source configuration
 */
 class SWDLLEXPORT InstallSource {
 	SWMgr *mgr;
+	ModuleCatalog *catalog;
 public:
 	InstallSource(const char *type, const char *confEnt = 0);
 	virtual ~InstallSource();
@@ -58,6 +60,10 @@ public:
 	SWBuf localShadow;
 	void *userData;
 	SWMgr *getMgr();
+	/** the modules of this source, from the catalog InstallMgr keeps beside
+	 *  its cached .conf files; cheaper than getMgr() to look through
+	 */
+	const ModuleCatalog *getCatalog();
 	void flush();
 
 	InstallSource *chainedSource;
@@ -82,6 +88,8 @@ protected:
 	SWBuf u, p;
 	bool unverifiedPeerAllowed;
 	bool forgetInstallSource;
+	int maxTransfers;
+	bool deltaUpdates;
 
 	/** override this method and provide your own custom RemoteTransport subclass
 	 */
@@ -97,6 +105,37 @@ protected:
 	 */
 	RemoteTransport *transport;
 
+	/** the transport of the last remoteCopy, kept with its connections for
+	 *  the next one to the same source and user; see idleTransportKey
+	 */
+	RemoteTransport *idleTransport;
+	SWBuf idleTransportKey;
+
+	/** a transport to is, ready to use, and the URL of its host; 0 if its
+	 *  type isn't available.  Give it back with releaseTransport.
+	 */
+	RemoteTransport *acquireTransport(InstallSource *is, SWBuf &urlPrefix);
+	void releaseTransport(InstallSource *is, RemoteTransport *trans);
+
+	/** brings an installed module up to date with a remote source by
+	 *  fetching only the blocks of its data files which changed; see ModuleDelta
+	 * @is - remote installation source from which to update
+	 * @relativePath - the module data path, relative to the source's directory
+	 * @installedPath - the installed module data directory
+	 * @cachePath - a local directory for the module's manifest meanwhile
+	 * @return 0 if the module was updated; nonzero if it wasn't, e.g., because
+	 *	the source has no manifest for it; -3 if the user asked to terminate
+	 */
+	virtual int deltaUpdate(InstallSource *is, const char *relativePath, const char *installedPath, const char *cachePath);
+
+	/** refreshes the cached .conf files of a remote source by fetching its
+	 *  ModuleCatalog, and only those .conf files whose hash changed
+	 * @root - where the source is cached
+	 * @return 0 if the source was refreshed; -1 if the user asked to
+	 *	terminate; 1 if the source has no usable catalog
+	 */
+	virtual int refreshFromCatalog(InstallSource *is, const char *root);
+
 public:
 
 	static bool userDisclaimerConfirmed;
@@ -289,6 +328,17 @@ public:
 	void setTimeoutMillis(long timeoutMillis) { this->timeoutMillis = timeoutMillis; }
 	long getTimeoutMillis() { return timeoutMillis; }
 
+	/** how many files of a module may be downloaded at once; 1 downloads them one after another
+	 */
+	void setMaxTransfers(int maxTransfers) { this->maxTransfers = (maxTransfers > 0) ? maxTransfers : 1; }
+	int getMaxTransfers() { return maxTransfers; }
+
+	/** whether installModule, for a module already installed, first tries
+	 *  to fetch only what changed from a source which offers that
+	 */
+	void setDeltaUpdates(bool deltaUpdates) { this->deltaUpdates = deltaUpdates; }
+	bool isDeltaUpdates() { return deltaUpdates; }
+
 	void setUnverifiedPeerAllowed(bool allowed) { this->unverifiedPeerAllowed = allowed; }
 	void setForgetInstallSource(bool forget) { this->forgetInstallSource = forget; }
 	bool isUnverifiedPeerAllowed() { return unverifiedPeerAllowed; }
@@ -309,6 +359,12 @@ public:
 	 */
 	static std::map<SWModule *, int> getModuleStatus(const SWMgr &base, const SWMgr &other, bool utilModules = false);
 
+	/************************************************************************
+	 * getModuleStatus - as above, for the modules of a catalog, e.g., of an
+	 * 	install source (see InstallSource::getCatalog), by module name
+	 */
+	static std::map<SWBuf, int> getModuleStatus(const SWMgr &base, const ModuleCatalog &other, bool utilModules = false);
+
 	/************************************************************************
 	 * isDefaultModule - allows an installation to provide a set of modules
 	 *   in installMgr.conf like:
@@ -33,11 +33,21 @@
 
 SWORD_NAMESPACE_START
 
+struct VersePosition;
+class VerseKey;
+
 /** ListKey is a container SWKey which faciliates a list of SWKey objects
  */
 class SWDLLEXPORT ListKey : public SWKey {
 
 	void init();
+	void grow();
+
+	// the key of element i, made from positions[i] if not yet made
+	SWKey *getKeyAt(int i) const;
+
+	// makes keys for the positions waiting on versePrototype
+	void makePendingKeys();
 
 protected:
 	int arraypos;
@@ -45,6 +55,18 @@ protected:
 	int arraycnt;
 	SWKey **array;
 
+	/** parallel to array, for elements added as a VersePosition.
+	 * Such an element is left null in array until something needs it
+	 * as an SWKey.  Null until the first VersePosition is added.
+	 */
+	VersePosition *positions;
+
+	/** what the keys of those elements are made from: a VerseKey with
+	 * the locale, intros and auto-normalize of the one the positions
+	 * came from.  Null for a plain VerseKey.
+	 */
+	VerseKey *versePrototype;
+
 public:
 
 	/** initializes instance of ListKey
@@ -122,6 +144,24 @@ public:
 	ListKey & operator <<(const SWKey &ikey) { add(ikey); return *this; }
 	virtual void add(const SWKey &ikey);
 
+	/** Adds a verse, or range of verses, to the list without making a
+	 * VerseKey for it; one is made only when the element is visited or
+	 * asked for.  Unlike add(const SWKey &), the list is not repositioned
+	 * on the new element's text.
+	 * @param pos the verse or range to add
+	 * @param like if given, the key is made like this one (its locale,
+	 *	intros and auto-normalize), else as a plain VerseKey
+	 */
+	void add(const VersePosition &pos, const VerseKey *like = 0);
+
+	/** Gets an element as a VersePosition, without making a VerseKey for it
+	 *
+	 * @param pos receives the position; a range for a bounded VerseKey
+	 * @param element element number to get (or default current)
+	 * @return false if there is no such element, or it is not a verse
+	 */
+	bool getVersePosition(VersePosition &pos, int element = -1) const;
+
 	/** Equates this ListKey to another ListKey object
 	 *
 	 * @param ikey other ListKey object
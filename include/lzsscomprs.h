@@ -39,6 +39,17 @@ public:
 	virtual ~LZSSCompress();
 	virtual void encode(void);
 	virtual void decode(void);
+	virtual SWCompress *clone() const;
+
+	/** How many earlier positions the encoder tries for each match, newest
+	 * first.  More finds longer matches but encodes more slowly.
+	 * @param depth 0 (the default) takes the depth from the level: 4 at
+	 * level 1, doubling to 256 at level 7, then 1024 and, from level 9,
+	 * every position in the window
+	 */
+	void setSearchDepth(int depth);
+	/** @return the search depth encode() uses */
+	int getSearchDepth() const;
 };
 
 SWORD_NAMESPACE_END
@@ -0,0 +1,100 @@
+/******************************************************************************
+ *
+ * modcatalog.h -	class ModuleCatalog: a compact list of the modules whose
+ *			.conf files a mods.d directory holds, published beside
+ *			it in a repository so a source can be refreshed, and
+ *			its modules compared with those installed, without
+ *			fetching or parsing every .conf
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef MODCATALOG_H
+#define MODCATALOG_H
+
+#include <swbuf.h>
+#include <map>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+/**
+ * Each module is listed with the name of the .conf file it came from and a
+ * hash of that file, so two catalogs tell which .conf files differ.
+ */
+class SWDLLEXPORT ModuleCatalog {
+
+public:
+	/** name of the catalog file, beside the mods.d directory it lists */
+	static const char *FILENAME;
+
+	/** one module */
+	struct Entry {
+		SWBuf name;
+		/** the .conf file in mods.d, and a hash of its contents */
+		SWBuf confFile;
+		SWBuf confHash;
+		/** Version, empty if the module gives none */
+		SWBuf version;
+		SWBuf category;
+		SWBuf lang;
+		/** the Feature entries, separated by spaces */
+		SWBuf features;
+		unsigned long installSize;
+		/** the module has a CipherKey entry, and whether it is filled in */
+		bool ciphered;
+		bool keyPresent;
+
+		/** @return true for a module SWMgr puts among its utility modules */
+		bool isUtility() const { return category == "Utility"; }
+	};
+	typedef std::map<SWBuf, Entry> EntryMap;
+
+private:
+	EntryMap entries;
+
+public:
+	/** Fills the catalog from the .conf files of a mods.d directory
+	 * @return 0 on success; -1 if the directory can't be read
+	 */
+	signed char build(const char *modsDir);
+
+	/** Reads a catalog file
+	 * @return true if a readable catalog was found
+	 */
+	bool load(const char *path);
+
+	/** Writes the catalog to a file
+	 * @return 0 on success; -1 if the file could not be written
+	 */
+	signed char save(const char *path) const;
+
+	void clear() { entries.clear(); }
+
+	const EntryMap &getEntries() const { return entries; }
+
+	/** @return the module of that name, or 0 */
+	const Entry *getEntry(const char *name) const;
+
+	/** @return the hash of the contents of a .conf file, as in Entry::confHash */
+	static SWBuf getConfHash(const char *data, unsigned long length);
+};
+
+SWORD_NAMESPACE_END
+#endif
@@ -0,0 +1,85 @@
+/******************************************************************************
+ *
+ * moddelta.h -	class ModuleDelta: block checksums of a module's data files,
+ *			published beside them in a repository, so an installed
+ *			copy of the module can be brought up to date by fetching
+ *			only the blocks which changed
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef MODDELTA_H
+#define MODDELTA_H
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+class RemoteTransport;
+
+/**
+ * The manifest (MANIFEST, a SWConfig) has a section for each file in the
+ * module data directory, giving its size, a hash of the whole file and
+ * the hash of each of its blocks.  The compressed text of zText and zCom
+ * modules (*.?zz) is cut where the blocks listed in its *.?zs index begin
+ * and end, and that of zLD modules (*.zdt) where its *.zdx entries do, so
+ * an edit to one verse or entry changes only the block holding it.  Other
+ * files are cut every ChunkSize bytes.
+ *
+ * To update, each installed file is cut the same way; blocks whose hash is
+ * found in it are copied from it, and the rest fetched by range from the
+ * repository.  The new files are built beside the installed directory,
+ * checked against the manifest, and only then swapped in for it.
+ */
+class SWDLLEXPORT ModuleDelta {
+
+public:
+	/** name of the manifest file inside a module's data directory */
+	static const char *MANIFEST;
+
+	/** size of the blocks files without an index are cut into */
+	static const unsigned long DEFAULT_CHUNK_SIZE;
+
+	/** Writes the manifest for the files of a module data directory
+	 * @param dataPath the module's data directory
+	 * @param chunkSize size of the blocks for files without an index
+	 * @return 0 on success; -1 if the directory can't be read or the
+	 *	manifest written
+	 */
+	static signed char createManifest(const char *dataPath, unsigned long chunkSize = DEFAULT_CHUNK_SIZE);
+
+	/** Brings an installed module data directory up to date with the one
+	 * a manifest describes
+	 * @param transport connection to the repository; its StatusReporter
+	 *	hears of the progress
+	 * @param dataURL URL of the module data directory in the repository
+	 * @param manifestPath local copy of that directory's manifest
+	 * @param installedPath the installed module data directory
+	 * @param fetchedBytes if given, receives how many bytes were fetched
+	 * @return 0 on success, when installedPath holds the new files (and
+	 *	whatever directories it held before, save a search framework,
+	 *	which is dropped with any entry attribute index and search
+	 *	journal, since they index the old text);
+	 *	-1 if the update couldn't be made, leaving installedPath as it was;
+	 *	or an error from the transport
+	 */
+	static signed char update(RemoteTransport *transport, const char *dataURL, const char *manifestPath, const char *installedPath, unsigned long *fetchedBytes = 0);
+};
+
+SWORD_NAMESPACE_END
+#endif
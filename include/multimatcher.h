@@ -0,0 +1,97 @@
+/******************************************************************************
+ *
+ * multimatcher.h -	class MultiMatcher: finds several strings in a text
+ *			in one pass, optionally ignoring case
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef MULTIMATCHER_H
+#define MULTIMATCHER_H
+
+#include <swbuf.h>
+#include <sysdata.h>
+#include <map>
+#include <vector>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+/**
+ * Looks for a set of patterns in any number of texts.
+ *
+ * The patterns are compiled once into an Aho-Corasick automaton over their
+ * UTF-8, so each text is read once, no matter how many patterns there are.
+ * Ignoring case, the automaton is built over the upper cased patterns, and
+ * each text is upper cased a character at a time as it is read, the same
+ * way SWBuf::toUpper() would, so no upper cased copy of it is made.
+ *
+ * Matching case with a single pattern, it is simply looked for with
+ * strstr(), which the C library vectorizes.
+ */
+class SWDLLEXPORT MultiMatcher {
+
+	std::vector<SWBuf> patterns;
+	std::vector<SW_u32> transitions;	// state * 256 + byte -> next state * 256, high bit set if it has outputs; empty when strstr() is used
+	std::vector<int> outputStart;		// patterns recognized in state s: outputs[outputStart[s] .. outputStart[s+1]]
+	std::vector<int> outputs;
+	int patternCount;
+	int emptyPatterns;
+	bool icase;
+
+	// which patterns the current text has matched
+	std::vector<unsigned long> seen;
+	unsigned long generation;
+
+	// upper cased UTF-8 of each code point seen so far, a page of 256 at a time;
+	// each entry is (offset into foldText << 8) | length
+	std::map<SW_u32, std::vector<SW_u32> > foldPages;
+	SW_u32 lastFoldPage;
+	std::vector<SW_u32> *lastFoldEntries;
+	SWBuf foldText;
+
+	void fold(const char *text, SWBuf &folded);
+	const std::vector<SW_u32> &getFoldPage(SW_u32 page);
+	bool recognize(SW_u32 state, int &found, int needed);
+	bool run(const char *text, SW_u32 &state, int &found, int needed);
+
+public:
+	/**
+	 * @param patterns the strings to find
+	 * @param icase ignore case
+	 */
+	MultiMatcher(const std::vector<SWBuf> &patterns, bool icase = false);
+
+	/** @return true if text contains every pattern */
+	bool matchesAll(const char *text);
+
+	/** @return true if text1 + ' ' + text2 contains every pattern; patterns
+	 * must not contain spaces
+	 */
+	bool matchesAll(const char *text1, const char *text2);
+
+	/** @return true if text contains any pattern */
+	bool matchesAny(const char *text);
+
+	/** @return the number of patterns */
+	int getPatternCount() const { return patternCount; }
+};
+
+SWORD_NAMESPACE_END
+#endif
@@ -35,6 +35,9 @@ public:
 	OSISEnum();
 	virtual ~OSISEnum();
 	virtual char processText(SWBuf &text, const SWKey *key = 0, const SWModule *module = 0);
+	virtual bool isActive() const { return !option; }
+	virtual bool isTokenFilter() const { return true; }
+	virtual char processTokens(XMLTokenList &tokens, const SWKey *key = 0, const SWModule *module = 0);
 };
 
 SWORD_NAMESPACE_END
@@ -36,6 +36,9 @@ public:
 	OSISRedLetterWords();
 	virtual ~OSISRedLetterWords();
 	virtual char processText(SWBuf &text, const SWKey *key = 0, const SWModule *module = 0);
+	virtual bool isActive() const { return !option; }
+	virtual bool isTokenFilter() const { return true; }
+	virtual char processTokens(XMLTokenList &tokens, const SWKey *key = 0, const SWModule *module = 0);
 };
 
 SWORD_NAMESPACE_END
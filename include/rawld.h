@@ -55,7 +55,13 @@ public:
 	virtual void setEntry(const char *inbuf, long len = -1);	// Modify current module entry
 	virtual void linkEntry(const SWKey *linkKey);	// Link current module entry to other module entry
 	virtual void deleteEntry();	// Delete current module entry
+	virtual void beginBulkLoad() { beginBuild(); }
+	virtual void endBulkLoad() { endBuild(); }
 	// end write interface ------------------------
+
+	// swcacher interface ----------------------
+	virtual void flush() { flushBuild(); SWLD::flush(); }
+	// end swcacher interface ----------------------
 	virtual long getEntryCount() const;
 	virtual long getEntryForKey(const char *key) const;
 	virtual char *getKeyForEntry(long entry) const;
@@ -39,6 +39,9 @@ private:
 	char *path;
 	bool caseSensitive;
 	mutable long lastoff;	 // for caching and optimizing
+	struct Build;		// index entries collected while building
+	Build *build;
+	void addBuildText(const char *key, const char *buf, long len);
 	
 
 protected:
@@ -57,6 +60,20 @@ public:
 	signed char findOffset(const char *key, SW_u32 *start, SW_u16 *size, long away = 0, SW_u32 *idxoff = 0) const;
 	void readText(SW_u32 start, SW_u16 *size, char **idxbuf, SWBuf &buf) const;
 	static signed char createModule(const char *path);
+
+	/** Starts building, e.g., for an importer adding many entries: the text
+	 * of each entry set from now on is appended to the data file at once,
+	 * but its index entry is held back, and flushBuild() or endBuild()
+	 * merges them all into the index, sorted, in one pass, instead of
+	 * the index being shifted for every new key.  Held back entries
+	 * can't be looked up until then; deleting one flushes them first.
+	 * Keys set more than once are all kept, the latest first.
+	 */
+	void beginBuild();
+	/** writes the index entries held back since beginBuild() */
+	void flushBuild();
+	/** writes the index entries held back and stops building */
+	void endBuild();
 };
 
 SWORD_NAMESPACE_END
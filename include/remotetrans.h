@@ -61,10 +61,27 @@ protected:
 	long timeoutMillis;
 	bool term;
 	bool unverifiedPeerAllowed;
+	int maxTransfers;
 	SWBuf host;
 	SWBuf u;
 	SWBuf p;
 
+	/** names the version of the resource the last transfer fetched (e.g.,
+	 * its size and ETag), for resumeURL to check a later transfer against;
+	 * empty if the transport can't tell.  Real transports set it on each
+	 * transfer, even one broken off.
+	 */
+	SWBuf validator;
+
+	/** transports like this one, from clone(), on which copyDirectory runs
+	 * its other transfers.  They, and their connections, are kept for the
+	 * life of this transport.
+	 */
+	std::vector<RemoteTransport *> pool;
+
+	/** gives other the connection settings of this transport; for clone() */
+	void copySettingsTo(RemoteTransport *other) const;
+
 public:
 	RemoteTransport(const char *host, StatusReporter *statusReporter = 0);
 	virtual ~RemoteTransport();
@@ -85,6 +102,53 @@ public:
 	 */
 	virtual char putURL(const char *destURL, const char *sourcePath, SWBuf *sourceBuf = 0);
 
+	/***********
+	 * override this method in your real impl, if your protocol can pick up
+	 * a transfer part way through
+	 *
+	 * Appends sourceURL, from byte offset on, to the offset bytes already in
+	 * destPath, which an earlier transfer of the version of sourceURL named
+	 * by validator left there.  If sourceURL is no longer that version, or
+	 * that can't be told, fails, leaving destPath as it was.  This default
+	 * fetches the whole of sourceURL into destPath.
+	 * @return as getURL
+	 */
+	virtual char resumeURL(const char *destPath, const char *sourceURL, long offset, const char *validator);
+
+	/***********
+	 * override this method in your real impl, if your protocol can fetch
+	 * part of a resource
+	 *
+	 * Fetches length bytes of sourceURL, from byte offset on, into destBuf.
+	 * This default fetches the whole of sourceURL and keeps the part asked for.
+	 * @return as getURL; -1 also if sourceURL hasn't the bytes asked for
+	 */
+	virtual char getURLRange(const char *sourceURL, long offset, long length, SWBuf *destBuf);
+
+	/***********
+	 * override this method in your real impl, so copyDirectory can run more
+	 * than one transfer at a time
+	 *
+	 * @return a new transport to the same host with the same settings, or 0
+	 *	(the default) if transfers must run one after another
+	 */
+	virtual RemoteTransport *clone() const;
+
+	/** Fetches sourceURL into destPath by way of destPath.part, picking up
+	 * from the .part an earlier, broken off attempt left behind if
+	 * sourceURL hasn't changed since.  The validator of that attempt is
+	 * kept beside it in destPath.part.validator; a .part without one is
+	 * fetched again.
+	 * @return as getURL
+	 */
+	char downloadFile(const char *destPath, const char *sourceURL);
+
+	/** network copy recursively a remote directory, listing it and fetching
+	 * its files on up to getMaxTransfers() connections at once.  While it
+	 * runs, the StatusReporter hears of the progress of the whole copy, on
+	 * the calling thread.
+	 * @return error status 0: OK; -1: operation error, -2: connection error; -3: user requested termination
+	 */
 
 	int copyDirectory(const char *urlPrefix, const char *dir, const char *dest, const char *suffix);
 
@@ -97,7 +161,13 @@ public:
 	void setPasswd(const char *passwd) { p = passwd; }
 	void setUnverifiedPeerAllowed(bool val) { this->unverifiedPeerAllowed = val; }
 	bool isUnverifiedPeerAllowed() { return unverifiedPeerAllowed; }
+	/** how many files copyDirectory may fetch at once; 1 fetches them one after another */
+	void setMaxTransfers(int maxTransfers) { this->maxTransfers = (maxTransfers > 0) ? maxTransfers : 1; }
+	int getMaxTransfers() const { return maxTransfers; }
+	void setStatusReporter(StatusReporter *statusReporter) { this->statusReporter = statusReporter; }
+	StatusReporter *getStatusReporter() const { return statusReporter; }
 	void terminate() { term = true; }
+	bool isTerminated() const { return term; }
 };
 
 
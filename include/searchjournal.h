@@ -0,0 +1,131 @@
+/******************************************************************************
+ *
+ * searchjournal.h -	class SearchJournal: a record, kept beside a module's
+ *			search framework, of the entries edited since the
+ *			framework was built, so it can be brought up to date
+ *			by re-indexing only those entries
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef SEARCHJOURNAL_H
+#define SEARCHJOURNAL_H
+
+#include <swbuf.h>
+#include <vector>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+/**
+ * Edits are journaled as they are made, without stamps; when the module
+ * writes what it holds back (SWModule::flush() or on close) the edits since
+ * the last time are sealed with stamps of the module data files taken
+ * before the first of them and after the write.  The journal begins with
+ * the stamp of the data the search framework was built from.  If the seals
+ * chain from there to the data as it is now, the journaled entries are the
+ * only ones which changed; if anything else touched the data, or edits were
+ * never sealed, the chain is broken and the framework must be rebuilt.
+ *
+ * The journal only exists while a search framework does: edits to a
+ * module without one aren't journaled.
+ */
+class SWDLLEXPORT SearchJournal {
+
+public:
+	/** name of the journal file inside a module's data directory */
+	static const char *FILENAME;
+
+	/** one edited entry */
+	struct Edit {
+		/** module index of the entry; only meaningful for VerseKey modules */
+		long index;
+		/** key text of the entry */
+		SWBuf keyText;
+	};
+	typedef std::vector<Edit> EditList;
+
+private:
+	SWBuf dataPath;
+	SWBuf base;
+	SWBuf last;
+	bool continuous;
+	EditList edits;
+
+public:
+	/**
+	 * @param dataPath the module's data directory (AbsoluteDataPath)
+	 */
+	SearchJournal(const char *dataPath);
+
+	/** full path of the journal file for a module data directory */
+	static SWBuf getJournalPath(const char *dataPath);
+
+	/** @return true if a module data directory has a journal, i.e., a
+	 * search framework whose edits should be journaled
+	 */
+	static bool exists(const char *dataPath);
+
+	/** @return a short stamp of the data files in a module data directory,
+	 * which changes whenever EntryAttributeIndex::getDataSignature() does
+	 */
+	static SWBuf getStamp(const char *dataPath);
+
+	/** @return the stamp of a signature from EntryAttributeIndex::getDataSignature() */
+	static SWBuf getSignatureStamp(const SWBuf &signature);
+
+	/** Starts an empty journal for a search framework just built from, or
+	 * brought up to date with, the data as it is now
+	 * @return 0 on success; -1 if the file could not be written
+	 */
+	static signed char start(const char *dataPath);
+
+	/** Appends an edit to an existing journal; does nothing if there is none */
+	static void record(const char *dataPath, long index, const char *keyText);
+
+	/** Seals the edits appended since the last seal; does nothing if there
+	 * is no journal
+	 * @param before stamp of the data before the first of those edits
+	 * @param after stamp of the data with all of them written
+	 */
+	static void seal(const char *dataPath, const char *before, const char *after);
+
+	/** removes the journal, e.g., with the search framework it belongs to */
+	static void remove(const char *dataPath);
+
+	/** Reads the journal from disk
+	 * @return true if a readable journal was found
+	 */
+	bool load();
+
+	/** @return the stamp of the data the search framework was built from */
+	const SWBuf &getBase() const { return base; }
+
+	/** @return the edits journaled since, in the order they were made */
+	const EditList &getEdits() const { return edits; }
+
+	/** @return true if the journaled edits lead from the data the search
+	 * framework was built from to the data with the given stamp, and
+	 * nothing else changed it
+	 */
+	bool accountsFor(const SWBuf &stamp) const { return continuous && (last == stamp); }
+};
+
+SWORD_NAMESPACE_END
+#endif
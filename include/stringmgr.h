@@ -104,6 +104,19 @@ protected:
 };
 
 
+/** Compares two UTF-8 strings, ignoring case the way StringMgr's own
+ * upperUTF8() upper cases without ICU: a codepoint at a time, from
+ * swtoupperdata.h
+ * @return same as strcmp, by upper cased codepoint
+ */
+SWDLLEXPORT int stricmpUTF8(const char *s1, const char *s2);
+
+/** Finds s2 in s1, ignoring case as stricmpUTF8() does
+ * @return where s2 begins in s1, or 0 if it isn't there
+ */
+SWDLLEXPORT const char *stristrUTF8(const char *s1, const char *s2);
+
+
 inline char *toupperstr(char *t, unsigned int max = 0) {
 	return StringMgr::getSystemStringMgr()->upperUTF8(t, max);
 }
@@ -218,7 +218,8 @@ public:
 			unsigned long len = strlen(newVal) + 1;
 			if (maxSize && maxSize < (len-1)) len = maxSize + 1;
 			assureSize(len);
-			memcpy(buf, newVal, len);
+			// newVal may point into this buffer, e.g., after stripPrefix()
+			memmove(buf, newVal, len);
 			end = buf + (len - 1);
 		}
 		else {
@@ -228,6 +229,19 @@ public:
 		*end = 0;
 	}
 
+	/**
+	* SWBuf::swap - exchanges the contents of this buf with another without
+	* copying, e.g., to trade a filter's output buffer for its input.
+	* @param other the buffer with which to trade contents
+	*/
+	inline void swap(SWBuf &other) {
+		char *tmp;
+		tmp = buf;      buf = other.buf;           other.buf = tmp;
+		tmp = end;      end = other.end;           other.end = tmp;
+		tmp = endAlloc; endAlloc = other.endAlloc; other.endAlloc = tmp;
+		unsigned long tmpSize = allocSize; allocSize = other.allocSize; other.allocSize = tmpSize;
+	}
+
 	/**
 	* SWBuf::setFormatted - sets this buf to a formatted string.
 	* If the allocated memory is bigger than the new string, it will NOT be resized.
@@ -52,6 +52,13 @@ public:
 	virtual void decode(void);	// override to provide compression algorythm
 	virtual void setLevel(int l) {level = l;};
 	virtual int getLevel() {return level;};
+
+	/** @return a new compressor of the same kind and level, which may be
+	 * used on another thread while this one is in use; 0 if that can't be
+	 * done, e.g., because the codec keeps its state in statics.  Kinds
+	 * which don't provide their own return 0.
+	 */
+	virtual SWCompress *clone() const;
 };
 
 SWORD_NAMESPACE_END
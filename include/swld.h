@@ -63,6 +63,18 @@ public:
 	
 	virtual bool hasEntry(const SWKey *k) const;
 
+	/** Starts a bulk load, e.g., for an importer: entries set or linked
+	 * from now on have their text written at once, but the index is only
+	 * brought up to date, sorted, in one pass, by flush() or endBulkLoad()
+	 * (or when the module is deleted), instead of being rewritten for
+	 * every new key.  Until then the new entries can't be looked up.
+	 * Drivers without the support just write each entry as usual.
+	 */
+	virtual void beginBulkLoad() {}
+
+	/** writes what was held back since beginBulkLoad() and ends the bulk load */
+	virtual void endBulkLoad() {}
+
 	// OPERATORS -----------------------------------------------------------------
 	
 	SWMODULE_OPERATORS
@@ -0,0 +1,159 @@
+/******************************************************************************
+ *
+ * swmetrics.h -	class SWMetrics: opt-in counters of what the engine
+ *			does for each module: reads, decompression, cache use,
+ *			filtering and searching
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef SWMETRICS_H
+#define SWMETRICS_H
+
+#include <swbuf.h>
+#include <vector>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+/**
+ * Counts, for each module (the owner), how many entries were read and how
+ * many bytes they held, how many compressed blocks were decompressed and
+ * how long that took, how often the block and file handle caches were hit
+ * or missed, how often and how long each filter ran, and how long searches
+ * took.  File handle use is counted under the owner "FileMgr", as FileMgr
+ * does not know which module a file belongs to.
+ *
+ * Nothing is counted until setEnabled(true) is called, and then only the
+ * cost of a flag test is paid where counting is off.  Building with
+ * STRIPMETRICS defined removes the counting from the library altogether.
+ *
+ * Counting is synchronized, so the engine's own worker threads, or an
+ * application's, may count at once.
+ */
+class SWDLLEXPORT SWMetrics {
+
+	static bool enabled;
+
+public:
+
+	/** what is counted for each owner */
+	enum Counter {
+		ENTRY_READS,		/**< raw entries read */
+		ENTRY_BYTES,		/**< bytes in the raw entries read */
+		BLOCK_DECOMPRESSIONS,	/**< compressed blocks decompressed */
+		DECOMPRESS_MICROS,	/**< microseconds spent decompressing */
+		CACHE_HITS,		/**< reads served from a cached block or open file */
+		CACHE_MISSES,		/**< reads which had to load a block or reopen a file */
+		PREFETCH_HITS,		/**< blocks loaded which had already been read ahead */
+		SEARCHES,		/**< searches run */
+		SEARCH_MICROS,		/**< microseconds spent searching */
+		COUNTER_COUNT
+	};
+
+	/** one counted value, as found in a snapshot */
+	struct Sample {
+		/** module name, or "FileMgr" */
+		SWBuf owner;
+		/** filter class name, or empty for an owner's own counters */
+		SWBuf filter;
+		/** counter name, e.g. "entryReads"; for a filter "calls" or "micros" */
+		SWBuf name;
+		unsigned long value;
+	};
+
+	typedef std::vector<Sample> Snapshot;
+
+	/** times something from construction to destruction into an owner's counter */
+	class SWDLLEXPORT Timer {
+		const char *owner;
+		Counter counter;
+		unsigned long start;
+	public:
+		Timer(const char *owner, Counter counter) : owner(owner), counter(counter), start(enabled ? getMicroseconds() : 0) {}
+		~Timer() { if (enabled && start) add(owner, counter, getMicroseconds() - start); }
+	};
+
+	/** turns counting on or off; counts already taken are kept */
+	static void setEnabled(bool enable) { enabled = enable; }
+
+	/** @return true if counting is on */
+	static bool isEnabled() { return enabled; }
+
+	/** forgets everything counted so far */
+	static void reset();
+
+	/** adds n to an owner's counter */
+	static void add(const char *owner, Counter counter, unsigned long n = 1);
+
+	/** counts one raw entry read for an owner, and the bytes it held */
+	static void addEntryRead(const char *owner, unsigned long bytes) {
+		add(owner, ENTRY_READS);
+		add(owner, ENTRY_BYTES, bytes);
+	}
+
+	/** counts one call of a filter for an owner
+	 * @param filter the filter's class name, as from typeid().name(); the
+	 *	string must outlive the counts, as it is kept and not copied
+	 * @param micros how long the call took
+	 */
+	static void addFilterCall(const char *owner, const char *filter, unsigned long micros);
+
+	/** @return a copy of everything counted so far, in owner order */
+	static Snapshot getSnapshot();
+
+	/** @return the snapshot as text, one "owner[/filter] name=value" line per sample */
+	static SWBuf getReport();
+
+	/** asks for the report to be logged, at SWLog's information level,
+	 * every so often while counting goes on
+	 * @param seconds the least time between reports, or 0 for none
+	 */
+	static void setReportInterval(unsigned long seconds);
+
+	/** @return a free running clock in microseconds, for timing */
+	static unsigned long getMicroseconds();
+
+	/** @return the name used in a snapshot for counter */
+	static const char *getCounterName(Counter counter);
+};
+
+
+/*
+ * Where counting is done in the library, it is done through these macros,
+ * so a build with STRIPMETRICS defined has none of it.
+ */
+#ifndef STRIPMETRICS
+#define SWMETRICS_ADD(owner, counter, n) (SWMetrics::isEnabled() ? SWMetrics::add(owner, SWMetrics::counter, n) : (void)0)
+#define SWMETRICS_ENTRY_READ(owner, bytes) (SWMetrics::isEnabled() ? SWMetrics::addEntryRead(owner, bytes) : (void)0)
+#define SWMETRICS_TIMER(var, owner, counter) SWMetrics::Timer var(owner, SWMetrics::counter)
+#define SWMETRICS_START(var) unsigned long var = (SWMetrics::isEnabled()) ? SWMetrics::getMicroseconds() : 0
+#define SWMETRICS_ADD_SINCE(var, owner, counter) ((var && SWMetrics::isEnabled()) ? SWMetrics::add(owner, SWMetrics::counter, SWMetrics::getMicroseconds() - var) : (void)0)
+#define SWMETRICS_FILTER_SINCE(var, owner, filter) ((var && SWMetrics::isEnabled()) ? SWMetrics::addFilterCall(owner, filter, SWMetrics::getMicroseconds() - var) : (void)0)
+#else
+#define SWMETRICS_ADD(owner, counter, n) (void)0
+#define SWMETRICS_ENTRY_READ(owner, bytes) (void)0
+#define SWMETRICS_TIMER(var, owner, counter) (void)0
+#define SWMETRICS_START(var) (void)0
+#define SWMETRICS_ADD_SINCE(var, owner, counter) (void)0
+#define SWMETRICS_FILTER_SINCE(var, owner, filter) (void)0
+#endif
+
+SWORD_NAMESPACE_END
+#endif
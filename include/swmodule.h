@@ -30,11 +30,13 @@
 
 #include <swcacher.h>
 #include <swsearchable.h>
+#include <entryattrstore.h>
 #ifndef	_WIN32_WCE
 #include <iostream>
 #endif
 
 #include <list>
+#include <vector>
 
 #include <defs.h>
 
@@ -49,6 +51,8 @@ enum {BIB_BIBTEX = 0, /* possible future formats: BIB_MARCXML, BIB_MARC21, BIB_D
 
 class SWOptionFilter;
 class SWFilter;
+class EntryAttributeIndex;
+class FilterPipeline;
 
 
 #define SWMODULE_OPERATORS \
@@ -70,14 +74,55 @@ class SWFilter;
 
 typedef std::list < SWFilter * >FilterList;
 typedef std::list < SWOptionFilter * >OptionFilterList;
-typedef std::map < SWBuf, SWBuf, std::less < SWBuf > > AttributeValue;
-typedef std::map < SWBuf, AttributeValue, std::less < SWBuf > > AttributeList;
-typedef std::map < SWBuf, AttributeList, std::less < SWBuf > > AttributeTypeList;
 
 #define SWTextDirection char
 #define SWTextEncoding char
 #define SWTextMarkup char
 
+/**
+ * Drives a streaming search (see SWModule::search(SearchCursor &, ...)).
+ * Hits are handed to hitCallback as they are found, the search stops once
+ * it has found maxHits or spent timeBudget milliseconds, and the cursor
+ * remembers where it stopped so that the next call, with the same query and
+ * scope, continues from there.
+ */
+class SWDLLEXPORT SearchCursor {
+
+	friend class SWModule;
+
+	SWKey *position;	// next entry to search; 0 if not yet started
+	SWKey *lastKey;		// previous entry, for searches which span 2 entries
+	SWBuf lastBuf;		// ... and its text
+	long highIndex;
+	bool complete;
+
+	// not copyable
+	SearchCursor(const SearchCursor &);
+	SearchCursor &operator =(const SearchCursor &);
+
+public:
+	/** Called with each hit as it is found.  Return false to stop the search;
+	 * it may be continued later like any other page.
+	 */
+	bool (*hitCallback)(const SWKey &hit, void *userData);
+	void *hitUserData;
+
+	/** stop after this many hits in one call; 0 for no limit */
+	int maxHits;
+
+	/** stop after about this many milliseconds in one call; 0 for no limit */
+	long timeBudget;
+
+	SearchCursor(int maxHits = 0, long timeBudget = 0, bool (*hitCallback)(const SWKey &, void *) = 0, void *hitUserData = 0);
+	~SearchCursor();
+
+	/** @return true once the whole scope has been searched */
+	bool isComplete() const { return complete; }
+
+	/** forget any progress so the next search starts from the beginning */
+	void reset();
+};
+
 /**
  * The class SWModule is the base class for all modules used in Sword.
  * It provides functions to look up a text passage, to search in the module,
@@ -114,7 +159,18 @@ protected:
 
 	ConfigEntMap ownConfig;
 	ConfigEntMap *config;
+	mutable EntryAttributeStore entryAttributeStore;
+	/** the view getEntryAttributes() hands out, built only when asked for.
+	 * It's current while it holds what the store does, and handed out
+	 * while a caller may have changed it since the entry was rendered.
+	 * Once getEntryAttributes() has been called it's held, and each render
+	 * of the current entry brings it up to date, as the map filters used
+	 * to fill was
+	 */
 	mutable AttributeTypeList entryAttributes;
+	mutable bool entryAttributesCurrent;
+	mutable bool entryAttributesHandedOut;
+	mutable bool entryAttributesHeld;
 	mutable bool procEntAttr;
 
 	mutable char error;
@@ -154,11 +210,76 @@ protected:
 	/** filters to be executed to decode text for display */
 	FilterList *encodingFilters;
 
+	/** optionFilters and stripFilters compiled for stripText() */
+	FilterPipeline *stripPipeline;
+
+	/** optionFilters and renderFilters compiled for renderText() */
+	FilterPipeline *renderPipeline;
+
 	mutable int entrySize;
 	mutable long entryIndex;	 // internal common storage for index
 
+	/** persisted entry attribute index, loaded on first entry attribute search */
+	EntryAttributeIndex *attributeIndex;
+
+	/** while journaled edits wait for flush() to seal them, the stamp of
+	 * the module data before the first of them, and where it lives
+	 */
+	SWBuf journalBefore;
+	SWBuf journalDataPath;
+
+	/** seals the journaled edits made since the last flush(); see EntryEdit */
+	void sealJournal();
+
 	static void prepText(SWBuf &buf);
 
+	/** @return the entry attribute index for this module if one exists
+	 * and is current with the module data; otherwise 0
+	 */
+	EntryAttributeIndex *getCurrentEntryAttributeIndex();
+
+	/** strips the raw entries handed to one search index worker; see
+	 * createSearchFramework()
+	 */
+	static void stripIndexEntries(void *job);
+
+	/** Adds the entries from the top of the current key to its bottom to
+	 * the external search index.  With edited (sorted module indices),
+	 * only the documents of those entries, and of the chapters they're in,
+	 * are replaced; see updateSearchFramework().
+	 */
+	signed char indexEntries(const std::vector<long> *edited, void (*percent) (char, void *), void *percentUserData);
+
+	/** re-renders the entries at the given sorted module indices into the
+	 * entry attribute index, if it was built from the data stamped base
+	 */
+	signed char updateEntryAttributeIndex(const SWBuf &base, const std::vector<long> &edited);
+
+	/**
+	 * Journals one edit of the current entry for updateSearchFramework().
+	 * The first edit since the last flush() takes a stamp of the module
+	 * data; flush(), or closing the module, seals the edits with a stamp of
+	 * the data they left, so drivers which hold writes back aren't made to
+	 * write each edit.  Writable drivers declare one at the top of
+	 * setEntry(), linkEntry() and deleteEntry().  Nothing is done unless
+	 * the module has a search framework to keep up to date.
+	 */
+	class SWDLLEXPORT EntryEdit {
+		SWModule *module;
+		SWBuf dataPath;
+
+		// not copyable
+		EntryEdit(const EntryEdit &);
+		EntryEdit &operator =(const EntryEdit &);
+	public:
+		EntryEdit(SWModule *module);
+		~EntryEdit();
+	};
+
+	/** the search engine behind both search() methods; cursor may be 0 */
+	ListKey &search(const char *istr, int searchType, int flags, SWKey *scope, bool *justCheckIfSupported,
+			SearchCursor *cursor, void (*percent) (char, void *), void *percentUserData);
+
 
 public:
 	// used for matching whole entry (not substring) in entry attributes searches.
@@ -197,6 +318,11 @@ public:
 	 */
 	virtual ~SWModule();
 
+	/** Seals edits journaled since the last call; drivers which hold
+	 * writes back write them first and then call this
+	 */
+	virtual void flush();
+
 	/** Gets and clears error status
 	 *
 	 * @return error status
@@ -266,6 +392,14 @@ public:
 	 */
 	char setKey(const SWKey &ikey) { return setKey(&ikey); }
 
+	/**
+	 * Positions this module at a verse, without making a VerseKey for it
+	 * when the module's key is already one
+	 * @param pos the verse to go to; mapped if it is in another versification
+	 * @return Error status
+	 */
+	char setKey(const VersePosition &pos);
+
 	/**
 	 * @deprecated Use setKey() instead.
 	 */
@@ -470,6 +604,20 @@ public:
 			void (*percent) (char, void *) = &nullPercent,
 			void *percentUserData = 0);
 
+	/** Searches a module a page at a time, streaming hits as they are found.
+	 * Takes the same query parameters as search() above; pass the same query
+	 * and scope with the same cursor to fetch each following page.  Searches
+	 * of an external search framework return all their hits in one page.
+	 *
+	 * @param cursor hit callback and budgets for this call; records where the search stopped
+	 *
+	 * @return ListKey set to the entry keys found by this call
+	 */
+	ListKey &search(SearchCursor &cursor, const char *istr, int searchType = 0, int flags = 0,
+			SWKey *scope = 0,
+			void (*percent) (char, void *) = &nullPercent,
+			void *percentUserData = 0);
+
 	// for backward compat-- deprecated
 
 	/**
@@ -813,8 +961,26 @@ public:
 	 *	the example examples/cmdline/lookup.cpp is a good utility which
 	 *	displays this information.  It is also useful as an example of how
 	 *	to access such.
+	 *
+	 *	This is a view of getEntryAttributeStore() kept for existing callers.
+	 *	As before the store, a reference to it shows the attributes of
+	 *	the entry rendered last: once this has been called, each render
+	 *	of the current entry rebuilds it.  Changes to it are seen by the
+	 *	store the next time that's asked for.  Filters, and anything run
+	 *	per entry, should use the store or getEntryAttributesView().
+	 */
+	virtual AttributeTypeList &getEntryAttributes() const;
+
+	/** @return the same view as getEntryAttributes(), but built only by
+	 * this call, so renders don't pay for it; a reference kept across
+	 * entries is stale until this is called again
+	 */
+	AttributeTypeList &getEntryAttributesView() const;
+
+	/** @return the attributes of the current entry, as filters set them while
+	 * the entry is rendered; see EntryAttributeStore
 	 */
-	virtual AttributeTypeList &getEntryAttributes() const { return entryAttributes; }
+	EntryAttributeStore &getEntryAttributeStore() const;
 
 	/** Processing Entry Attributes can be expensive.  This method allows
 	 * turning the processing off if they are not desired.  Some internal
@@ -833,12 +999,61 @@ public:
 
 
 	// SWSearchable Interface Impl -----------------------------------------------
+	/** Builds the search index.  Bible and commentary entries are read in
+	 * order on the calling thread and stripped on worker threads, each
+	 * with its own copy of the module, while one writer adds them to the
+	 * index in order.
+	 */
 	virtual signed char createSearchFramework(
 			void (*percent) (char, void *) = &nullPercent,
 			void *percentUserData = 0);
+
+	/** sets how many threads createSearchFramework() strips entries on
+	 * @param count 1 to do everything on the calling thread; 0, the
+	 *	default, for one per processor
+	 */
+	static void setIndexThreads(int count);
+
+	/** @return how many threads createSearchFramework() strips entries on */
+	static int getIndexThreads();
 	virtual void deleteSearchFramework();
 	virtual bool hasSearchFramework();
 
+	/** Brings the search framework up to date with the entries changed by
+	 * setEntry(), linkEntry() and deleteEntry() since it was built.  For
+	 * Bible and commentary modules only those entries, and the chapter
+	 * proximity documents they're part of, are indexed again.  If the
+	 * module data changed in any other way, or there is no search
+	 * framework yet, it is built from scratch.  search() does this itself
+	 * when only journaled edits stand between the index and the data.
+	 *
+	 * @return 0 on success; -1 on failure
+	 */
+	virtual signed char updateSearchFramework(
+			void (*percent) (char, void *) = &nullPercent,
+			void *percentUserData = 0);
+
+	/** @return true if the search framework was built from, or has been
+	 * brought up to date with, the module data as it is now
+	 */
+	virtual bool isSearchFrameworkCurrent();
+
+	/** Builds an index of this module's entry attributes so
+	 * SEARCHTYPE_ENTRYATTR searches needn't render every entry.
+	 * Only Bible and commentary (VerseKey) modules are indexed.
+	 * createSearchFramework() also builds this index.
+	 *
+	 * @return 0 on success; -1 if the index could not be written;
+	 *	1 if this module's key type cannot be indexed
+	 */
+	virtual signed char createEntryAttributeIndex(
+			void (*percent) (char, void *) = &nullPercent,
+			void *percentUserData = 0);
+	virtual void deleteEntryAttributeIndex();
+
+	/** @return true if an entry attribute index exists which is current with the module data */
+	virtual bool hasEntryAttributeIndex() { return getCurrentEntryAttributeIndex() != 0; }
+
 	// OPERATORS -----------------------------------------------------------------
 	SWMODULE_OPERATORS
 
@@ -32,10 +32,13 @@
 
 #include <swfilter.h>
 #include <swbuf.h>
+#include <sysdata.h>
 #include <list>
 
 SWORD_NAMESPACE_START
 
+class XMLTokenList;
+
 /**
 * The type definitoin for option types
 */
@@ -95,6 +98,49 @@ public:
 	 */
 	virtual void setOptionValue(const char *ival);
 
+	/** Some filters change nothing at certain option values (e.g., an
+	 * accent stripper while accents are "On").  Callers may skip such
+	 * filters altogether.
+	 * @return false if processText() would leave text untouched at the current option value
+	 */
+	virtual bool isActive() const { return true; }
+
+	/** Character filters transform each Unicode code point of UTF-8 text
+	 * independently of its neighbors, so several of them can be run
+	 * together in one pass over the text (see FilterPipeline).
+	 * Character filters must leave ASCII (below 0x80) unchanged.
+	 * @return true if this filter implements filterChar()
+	 */
+	virtual bool isCharFilter() const { return false; }
+
+	/** transforms a single code point as processText() would
+	 * @param ch the code point
+	 * @return the replacement code point, or 0 to drop ch
+	 */
+	virtual SW_u32 filterChar(SW_u32 ch) const { return ch; }
+
+	/** how processText() writes the characters it leaves alone
+	 * @return true if it decodes and encodes them again, which writes
+	 *	U+FFFD for bytes which aren't UTF-8 and shortens overlong
+	 *	forms; false if it passes their bytes through as they were
+	 */
+	virtual bool isReencoding() const { return false; }
+
+	/** Token filters can work on markup already split into tags and text,
+	 * so several of them can share one split (see FilterPipeline).
+	 * @return true if this filter implements processTokens()
+	 */
+	virtual bool isTokenFilter() const { return false; }
+
+	/** does to tokens what processText() would do to their text; only
+	 * called while isActive()
+	 * @param tokens the markup, split
+	 * @param key key of the text, if available
+	 * @param module module of the text, if available
+	 * @return 0
+	 */
+	virtual char processTokens(XMLTokenList &tokens, const SWKey *key = 0, const SWModule *module = 0) { return 0; }
+
 };
 
 SWORD_NAMESPACE_END
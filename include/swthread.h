@@ -0,0 +1,117 @@
+/******************************************************************************
+ *
+ * swthread.h -	classes SWMutex and SWThread: the little threading the
+ *			engine does for itself, over POSIX or Windows threads
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef SWTHREAD_H
+#define SWTHREAD_H
+
+#include <defs.h>
+
+/**
+ * Marks a static variable of plain old data as having one copy per thread,
+ * for the few places which hand out pointers into a static buffer.
+ */
+#if defined(_MSC_VER)
+#define SWTHREADLOCAL __declspec(thread)
+#else
+#define SWTHREADLOCAL __thread
+#endif
+
+SWORD_NAMESPACE_START
+
+/**
+ * A lock which one thread at a time may hold.  It is not recursive.
+ */
+class SWDLLEXPORT SWMutex {
+
+	void *handle;
+
+	// not copyable
+	SWMutex(const SWMutex &);
+	SWMutex &operator =(const SWMutex &);
+
+public:
+
+	/** holds a mutex from construction to destruction */
+	class SWDLLEXPORT Locker {
+		SWMutex &mutex;
+		Locker(const Locker &);
+		Locker &operator =(const Locker &);
+	public:
+		Locker(SWMutex &mutex) : mutex(mutex) { mutex.lock(); }
+		~Locker() { mutex.unlock(); }
+	};
+
+	SWMutex();
+	~SWMutex();
+
+	/** waits until no other thread holds the lock, and takes it */
+	void lock();
+
+	/** gives the lock back */
+	void unlock();
+};
+
+
+/**
+ * Runs a function on a thread of its own.
+ */
+class SWDLLEXPORT SWThread {
+
+public:
+	typedef void (*Function)(void *userData);
+
+private:
+	void *handle;
+
+	// not copyable
+	SWThread(const SWThread &);
+	SWThread &operator =(const SWThread &);
+
+public:
+	SWThread();
+
+	/** waits for the thread, if it is still running */
+	~SWThread();
+
+	/** runs function(userData) on a new thread
+	 * @return false if the thread could not be started, or this one
+	 *	has already been started and not yet joined
+	 */
+	bool start(Function function, void *userData);
+
+	/** waits for the thread to finish; does nothing if it was not started */
+	void join();
+
+	/** @return true from start() until join() */
+	bool isStarted() const { return handle != 0; }
+
+	/** @return how many processors there are to run threads on; at least 1 */
+	static int getProcessorCount();
+
+	/** pauses the calling thread for about millis milliseconds */
+	static void sleep(unsigned long millis);
+};
+
+
+SWORD_NAMESPACE_END
+#endif
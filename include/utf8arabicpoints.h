@@ -35,6 +35,9 @@ public:
 	UTF8ArabicPoints();
 	virtual ~UTF8ArabicPoints();
 	virtual char processText(SWBuf &text, const SWKey *key = 0, const SWModule *module = 0);
+	virtual bool isActive() const { return !option; }
+	virtual bool isCharFilter() const { return true; }
+	virtual SW_u32 filterChar(SW_u32 ch) const;
 };
 
 SWORD_NAMESPACE_END
@@ -35,6 +35,10 @@ public:
 	UTF8GreekAccents();
 	virtual ~UTF8GreekAccents();
 	virtual char processText(SWBuf &text, const SWKey *key = 0, const SWModule *module = 0);
+	virtual bool isActive() const { return !option; }
+	virtual bool isCharFilter() const { return true; }
+	virtual SW_u32 filterChar(SW_u32 ch) const;
+	virtual bool isReencoding() const { return true; }
 };
 
 SWORD_NAMESPACE_END
@@ -39,8 +39,11 @@ SE_JAMO, SE_HAN, SE_KANJI
 #define NUMTARGETSCRIPTS 2 //NUMSCRIPTS-3//6
 
 #include <swoptfilter.h>
+#include <swbuf.h>
+#include <swthread.h>
 
 #include <unicode/unistr.h>
+#include <unicode/ucnv.h>
 
 #include <unicode/translit.h>
 
@@ -59,6 +62,11 @@ typedef std::map<const icu::UnicodeString, SWTransData> SWTransMap;
 typedef std::pair<icu::UnicodeString, SWTransData> SWTransPair;
 
 /** This Filter uses ICU for transliteration
+ *
+ * Each transliterator it builds is kept, by ID, for as long as the filter
+ * lives, since building one from its rules costs far more than running
+ * it.  Once built, they and the filter may be used by several threads
+ * at once.
 */
 class SWDLLEXPORT UTF8Transliterator : public SWOptionFilter {
 
@@ -71,6 +79,10 @@ private:
 	static const char optTip[];
 	StringList options;
 
+	UConverter *conv;
+	SWMutex lock;		// guards conv and transCache
+	std::map<SWBuf, icu::Transliterator *> transCache;
+
 #ifdef ICU_CUSTOM_RESOURCE_BUILDING
 	static const char SW_RB_RULE_BASED_IDS[];
 	static const char SW_RB_RULE[];
@@ -84,6 +96,7 @@ private:
 #endif
 	bool addTrans(const char* newTrans, SWBuf* transList);
 	icu::Transliterator *createTrans(const icu::UnicodeString& ID, UTransDirection dir, UErrorCode &status);
+	icu::Transliterator *getTrans(const SWBuf &ID);
 
 public:
 	UTF8Transliterator();
@@ -260,6 +260,69 @@ inline SWBuf *getUTF8FromUniChar(SW_u32 uchar, SWBuf *appendTo) {
  */
 SWBuf assureValidUTF8(const char *buf);
 
+/******************************************************************************
+ * assureValidUTF8 - as above, but only copies the buffer if it has to be fixed
+ *
+ * ENT:	buf - a utf8 buffer
+ *	fixed - receives a fixed copy of buf, if buf isn't valid
+ *
+ * RET:	buf, if it is valid UTF-8, or else fixed
+ */
+const char *assureValidUTF8(const char *buf, SWBuf &fixed);
+
+/******************************************************************************
+ * isValidUTF8 - checks a UTF-8 buffer, accepting just what getUniCharFromUTF8
+ *					does
+ *
+ * ENT:	buf - a utf8 buffer; a NUL in it is taken as any other ASCII char
+ *	len - its length in bytes
+ */
+bool isValidUTF8(const char *buf, unsigned long len);
+
+/******************************************************************************
+ * getASCIILength - counts the 7-bit ASCII bytes at the start of a buffer
+ */
+unsigned long getASCIILength(const char *buf, unsigned long len);
+
+/******************************************************************************
+ * widenASCII - copies the 7-bit ASCII bytes at the start of a buffer into
+ *					UTF-16 or UTF-32 code units
+ *
+ * ENT:	to - room for len code units
+ *
+ * RET:	how many were copied
+ */
+unsigned long widenASCII(const char *buf, unsigned long len, SW_u16 *to);
+unsigned long widenASCII(const char *buf, unsigned long len, SW_u32 *to);
+
+/******************************************************************************
+ * narrowASCII - copies the UTF-16 or UTF-32 code units below 0x80 at the
+ *					start of a buffer into bytes
+ *
+ * ENT:	to - room for len bytes
+ *
+ * RET:	how many were copied
+ */
+unsigned long narrowASCII(const SW_u16 *buf, unsigned long len, char *to);
+unsigned long narrowASCII(const SW_u32 *buf, unsigned long len, char *to);
+
+/******************************************************************************
+ * getUTF8Kernels - names the code the UTF-8 functions above run: "avx2",
+ *					"sse4.1", "neon" or "scalar", the best the CPU can
+ *					do unless set otherwise
+ */
+const char *getUTF8Kernels();
+
+/******************************************************************************
+ * setUTF8Kernels - makes the UTF-8 functions above run a given code, for
+ *					tests and benchmarks; not thread safe
+ *
+ * ENT:	name - as from getUTF8Kernels(), or 0 for the best there is
+ *
+ * RET:	false if the CPU can't run it
+ */
+bool setUTF8Kernels(const char *name);
+
 /****
  * This can be called to convert a UTF8 stream to an SWBuf which manages
  *	a wchar_t[]
@@ -31,6 +31,7 @@
 #include <swmacs.h>
 #include <listkey.h>
 #include <versificationmgr.h>
+#include <verseposition.h>
 
 #include <defs.h>
 
@@ -88,6 +89,9 @@ private:
 
 	mutable VerseComponents lowerBoundComponents, upperBoundComponents;	// if autonorms is off, we can't optimize with index
 
+	// backs getShortText()
+	mutable SWBuf shortText;
+
 protected:
 
 	/** The Testament: 0 - Module Heading; 1 - Old; 2 - New
@@ -157,6 +161,14 @@ public:
 	*/
 	VerseKey(const VerseKey &k);
 
+	/**	VerseKey Constructor - initializes instance of VerseKey
+	* at a VersePosition, in its versification system.  A range
+	* becomes the bounds of the new VerseKey.
+	*
+	* @param pos the verse or range to start at
+	*/
+	VerseKey(const VersePosition &pos);
+
 	/**	VerseKey Destructor
 	* Cleans up an instance of VerseKey
 	*/
@@ -235,6 +247,19 @@ public:
 	*/
 	virtual void setPosition(SW_POSITION newpos);
 
+	/** @return where this key is, as a VersePosition in its
+	* versification system.  Bounds are not included.
+	*/
+	VersePosition getVersePosition() const;
+
+	/** Positions this key at a VersePosition, mapping it from its
+	* versification system if it differs from ours.  Only the start
+	* of a range is used; bounds are left alone.
+	*
+	* @param pos Position to set to.
+	*/
+	void setVersePosition(const VersePosition &pos);
+
 	/** Decrements key a number of verses
 	*
 	* @param steps Number of verses to jump backward
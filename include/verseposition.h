@@ -0,0 +1,62 @@
+/******************************************************************************
+ *
+ * verseposition.h -	struct VersePosition: a verse, or range of verses,
+ *			as a plain value
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef VERSEPOSITION_H
+#define VERSEPOSITION_H
+
+#include <versificationmgr.h>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+/**
+ * Where a verse is, and nothing else: no locale, no key text, no bounds
+ * object.  A VersePosition may be copied with memcpy and kept in arrays,
+ * which makes it the cheap way to pass verses around in loops which would
+ * otherwise clone a VerseKey per verse (e.g., collecting search hits).
+ * A VerseKey can be made from one, or positioned by one, when the text
+ * of the verse is finally wanted.
+ */
+struct SWDLLEXPORT VersePosition {
+	/** the versification system index and end are in */
+	const VersificationMgr::System *system;
+
+	/** VerseKey::getIndex() of the verse, or of the first verse of a range */
+	long index;
+
+	/** VerseKey::getIndex() of the last verse of a range, or -1 for a single verse */
+	long end;
+
+	/** @return true if this is a range of verses */
+	bool isRange() const { return end > index; }
+};
+
+/** @return a VersePosition for a verse, or for a range if end is given */
+inline VersePosition makeVersePosition(const VersificationMgr::System *system, long index, long end = -1) {
+	VersePosition pos = { system, index, end };
+	return pos;
+}
+
+SWORD_NAMESPACE_END
+#endif
@@ -36,6 +36,7 @@ SWORD_NAMESPACE_START
 typedef std::list <SWBuf>StringList;
 
 struct sbook;
+struct VersePosition;
 class TreeKey;
 
 
@@ -84,39 +85,37 @@ public:
 	class SWDLLEXPORT Book {
 	private:
 		friend class System;
-		friend struct BookOffsetLess;
-		class Private;
-		Private *p;
 
 		/** book name */
-		SWBuf longName;
+		const char *longName;
 
 		/** OSIS Abbreviation */
-		SWBuf osisName;
+		const char *osisName;
 
 		/** Preferred Abbreviation */
-		SWBuf prefAbbrev;
+		const char *prefAbbrev;
 
 		/** Maximum chapters in book */
 		unsigned int chapMax;
 
-		void init();
+		/** Array[chapMax] of maximum verses in chapters */
+		const int *verseMax;
+
+		/** Array[chapMax] of the offset of each chapter heading, in the
+		 * table of the System which holds this Book
+		 */
+		const long *chapterOffsets;
 
 	public:
-		Book() { init(); }
-		Book(const Book &other);
-		Book &operator =(const Book &other);
-		Book(const char *longName, const char *osisName, const char *prefAbbrev, int chapMax) {
-			this->longName = longName;
-			this->osisName = osisName;
-			this->prefAbbrev = prefAbbrev;
-			this->chapMax = chapMax;
-			init();
-		}
-		~Book();
-		const char *getLongName() const { return longName.c_str(); }
-		const char *getOSISName() const { return osisName.c_str(); }
-		const char *getPreferredAbbreviation() const { return prefAbbrev.c_str(); }
+		/** a Book only points at its names and verse counts; they must
+		 * live as long as it does (they are the static canon tables
+		 * for the built in systems)
+		 */
+		Book(const char *longName = "", const char *osisName = "", const char *prefAbbrev = "", int chapMax = 0, const int *verseMax = 0)
+			: longName(longName), osisName(osisName), prefAbbrev(prefAbbrev), chapMax(chapMax), verseMax(verseMax), chapterOffsets(0) {}
+		const char *getLongName() const { return longName; }
+		const char *getOSISName() const { return osisName; }
+		const char *getPreferredAbbreviation() const { return prefAbbrev; }
 		int getChapterMax() const { return chapMax; }
 		int getVerseMax(int chapter) const;
 	};
@@ -129,6 +128,7 @@ public:
 		int BMAX[2];
 		long ntStartOffset;
 		void init();
+		void bindBooks();
 	public:
 		System() { this->name = ""; init(); }
 		System(const System &other);
@@ -140,12 +140,17 @@ public:
 		int getBookNumberByOSISName(const char *bookName) const;
 		const Book *getBook(int number) const;
 		int getBookCount() const;
-		void loadFromSBook(const sbook *ot, const sbook *nt, int *chMax, const unsigned char *mappings=NULL);
+		void loadFromSBook(const sbook *ot, const sbook *nt, const int *chMax, const unsigned char *mappings=NULL);
 		long getOffsetFromVerse(int book, int chapter, int verse) const;
 		char getVerseFromOffset(long offset, int *book, int *chapter, int *verse) const;
 		const int *getBMAX() const { return BMAX; };
 		long getNTStartOffset() const { return ntStartOffset; }
 		void translateVerse(const System *dstSys, const char **book, int *chapter, int *verse, int *verse_end) const;
+		/** maps pos, which is in this system, into dstSys
+		 * @return the position in dstSys, a range if the verse became several,
+		 *	or with an index of -1 if dstSys lacks the book
+		 */
+		VersePosition translateVerse(const System *dstSys, const VersePosition &pos) const;
 	};
 
 	VersificationMgr() { init(); }
@@ -154,7 +159,12 @@ public:
 	static void setSystemVersificationMgr(VersificationMgr *newVersificationMgr);
 	const StringList getVersificationSystems() const;
 	const System *getVersificationSystem(const char *name) const;
-	void registerVersificationSystem(const char *name, const sbook *ot, const sbook *nt, int *chMax, const unsigned char *mappings=NULL);
+	/** Registers a versification system.  The tables are used where they
+	 * are, not copied, so they must outlast this manager; the built in
+	 * systems use static ones.  Systems built into the library are
+	 * registered with the system VersificationMgr when first asked for.
+	 */
+	void registerVersificationSystem(const char *name, const sbook *ot, const sbook *nt, const int *chMax, const unsigned char *mappings=NULL);
 	void registerVersificationSystem(const char *name, const TreeKey *);
 };
 
@@ -0,0 +1,109 @@
+/******************************************************************************
+ *
+ * xmltokenlist.h -	class XMLTokenList: markup split once into tags and
+ *			text, to be edited by several filters in turn
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef XMLTOKENLIST_H
+#define XMLTOKENLIST_H
+
+#include <swbuf.h>
+#include <utilxml.h>
+#include <vector>
+
+#include <defs.h>
+
+SWORD_NAMESPACE_START
+
+/**
+ * A flat list of the tags and text runs of a piece of markup, split the
+ * same way SWORD's filters split it themselves (a tag runs from '<' to the
+ * next '>').  Tokens point into one copy of the markup until a filter
+ * changes them; tags are parsed into an XMLTag only when first asked for,
+ * and the parse is kept for the next filter.  getText() puts it all back
+ * together, writing changed tags from their XMLTag.
+ */
+class SWDLLEXPORT XMLTokenList {
+
+	struct Token {
+		unsigned long offset;	// into source; NUL terminated there
+		unsigned long length;
+		bool isTag;
+		int edit;		// index into edits, or -1
+	};
+
+	// what a filter has done to a token
+	struct Edit {
+		SWBuf text;		// replacement text, when hasText
+		bool hasText;
+		XMLTag tag;		// parsed tag, when tagValid
+		bool tagValid;
+		bool tagDirty;		// tag changed since text was last written
+	};
+
+	SWBuf source;
+	std::vector<Token> tokens;
+	std::vector<Edit *> edits;	// kept for reuse between texts
+	int editCount;
+
+	Edit &getEdit(int i);
+
+	// not copyable
+	XMLTokenList(const XMLTokenList &);
+	XMLTokenList &operator =(const XMLTokenList &);
+
+public:
+	XMLTokenList(const char *text = 0);
+	~XMLTokenList();
+
+	/** splits text into tokens, replacing anything held before */
+	void setText(const char *text);
+
+	/** joins tokens back into markup
+	 * @param text receives the markup
+	 * @param start first token to join
+	 * @param end token to stop before, or -1 for all the rest
+	 */
+	void getText(SWBuf &text, int start = 0, int end = -1);
+
+	/** @return the number of tokens */
+	int getCount() const { return (int)tokens.size(); }
+
+	/** @return true if token i is a tag */
+	bool isTag(int i) const { return tokens[i].isTag; }
+
+	/** @return the text of token i; for a tag, what is between its '<' and '>' */
+	const char *getTokenText(int i);
+
+	/** @return true if the text of token i starts with prefix */
+	bool startsWith(int i, const char *prefix);
+
+	/** replaces the text of token i; for a tag, what is between its '<' and '>' */
+	void setTokenText(int i, const char *text);
+
+	/** @return tag i, parsed.  Call tagChanged() after changing it. */
+	XMLTag &getTag(int i);
+
+	/** records that the XMLTag returned by getTag(i) has been changed */
+	void tagChanged(int i);
+};
+
+SWORD_NAMESPACE_END
+#endif
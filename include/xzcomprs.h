@@ -42,6 +42,7 @@ public:
 
 	virtual void encode(void);
 	virtual void decode(void);
+	virtual SWCompress *clone() const;
 	virtual void setLevel(int l);
 };
 
@@ -63,7 +63,7 @@ public:
 	virtual void rawZFilter(SWBuf &buf, char direction = 0) const { rawFilter(buf, (SWKey *)(long)direction); }// hack, use key as direction for enciphering
 
 	// swcacher interface ----------------------
-	virtual void flush() { flushCache(); }
+	virtual void flush() { flushCache(); SWCom::flush(); }
 	// end swcacher interface ----------------------
 
 	virtual bool isLinked(const SWKey *k1, const SWKey *k2) const;
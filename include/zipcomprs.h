@@ -40,6 +40,7 @@ public:
 
 	virtual void encode(void);
 	virtual void decode(void);
+	virtual SWCompress *clone() const;
 
 	static char unTarGZ(int fd, const char *destPath);
 	static char unZip(const char *sourceZipPath, const char *destPath);
@@ -53,12 +53,14 @@ public:
 	virtual void setEntry(const char *inbuf, long len = -1);	// Modify current module entry
 	virtual void linkEntry(const SWKey *linkKey);	// Link current module entry to other module entry
 	virtual void deleteEntry();	// Delete current module entry
+	virtual void beginBulkLoad() { beginBuild(); }
+	virtual void endBulkLoad() { endBuild(); }
 	// end write interface ------------------------
 
 	virtual void rawZFilter(SWBuf &buf, char direction = 0) const { rawFilter(buf, (SWKey *)(long)direction); }// hack, use key as direction for enciphering
 
 	// swcacher interface ----------------------
-	virtual void flush() { flushCache(); }
+	virtual void flush() { flushBuild(); flushCache(); SWLD::flush(); }
 	// end swcacher interface ----------------------
 
 	virtual long getEntryCount() const;
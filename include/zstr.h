@@ -32,6 +32,7 @@ class SWCompress;
 class EntriesBlock;
 class FileDesc;
 class SWBuf;
+class BlockWriter;
 
 class SWDLLEXPORT zStr {
 
@@ -45,6 +46,12 @@ private:
 	mutable long lastoff;		// for caching and optimization
 	long blockCount;
 	SWCompress *compressor;
+	BlockWriter *writer;
+	struct Build;		// index entries collected while building
+	Build *build;
+	void addBuildText(const char *key, const char *buf, long len);
+	void writeBlock(long block, SWBuf &compressed) const;
+	static void commitBlock(const void *zstr, char testmt, long block, unsigned long size, SWBuf &compressed);
 
 protected:
 	FileDesc *idxfd;
@@ -55,7 +62,11 @@ protected:
 	static const int ZDXENTRYSIZE;
 
 	void getCompressedText(long block, long entry, char **buf) const;
-	void flushCache() const;
+	/** writes the block being filled
+	 * @param wait false to let it be compressed and written out while
+	 *	the next is filled, see BlockWriter
+	 */
+	void flushCache(bool wait = true) const;
 	void getKeyFromDatOffset(long ioffset, char **buf) const;
 	void getKeyFromIdxOffset(long ioffset, char **buf) const;
 
@@ -68,6 +79,20 @@ public:
 	void linkEntry(const char *destkey, const char *srckey);
 	virtual void rawZFilter(SWBuf &buf, char direction = 0) const { (void) buf; (void) direction; }
 	static signed char createModule (const char *path);
+
+	/** Starts building, e.g., for an importer adding many entries: each
+	 * entry set from now on goes into a block and the data file at once,
+	 * but its index entry is held back, and flushBuild() or endBuild()
+	 * merges them all into the index, sorted, in one pass, instead of
+	 * the index being shifted for every new key.  Held back entries
+	 * can't be looked up until then; deleting one flushes them first.
+	 * Keys set more than once are all kept, the latest first.
+	 */
+	void beginBuild();
+	/** writes the index entries held back since beginBuild() */
+	void flushBuild();
+	/** writes the index entries held back and stops building */
+	void endBuild();
 };
 
 SWORD_NAMESPACE_END
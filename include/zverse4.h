@@ -33,11 +33,20 @@ SWORD_NAMESPACE_START
 class FileDesc;
 class SWCompress;
 class SWBuf;
+class BlockPrefetcher;
+class BlockWriter;
 
 class SWDLLEXPORT zVerse4 {
 
 private:
 	SWCompress *compressor;
+	BlockPrefetcher *prefetcher;
+	BlockWriter *writer;
+
+	bool readBlock(char testmt, unsigned long buffnum, SWBuf &compressed) const;
+	static bool readAheadBlock(const void *zverse, char testmt, unsigned long buffnum, SWBuf &compressed);
+	void writeBlock(char testmt, long buffnum, unsigned long size, SWBuf &compressed) const;
+	static void commitBlock(const void *zverse, char testmt, long buffnum, unsigned long size, SWBuf &compressed);
 
 protected:
 	static int instance;		// number of instantiated zVerse4 objects or derivitives
@@ -48,7 +57,11 @@ protected:
 	char *path;
 	void doSetText(char testmt, long idxoff, const char *buf, long len = 0);
 	void doLinkEntry(char testmt, long destidxoff, long srcidxoff);
-	void flushCache() const;
+	/** writes the block being filled
+	 * @param wait false to let it be compressed and written out while
+	 *	the next is filled, see BlockWriter
+	 */
+	void flushCache(bool wait = true) const;
 	mutable char *cacheBuf;
 	mutable unsigned int cacheBufSize;
 	mutable char cacheTestament;
@@ -0,0 +1,254 @@
+/******************************************************************************
+ *
+ *  swmetrics.cpp -	SWMetrics: opt-in counters of what the engine does
+ *			for each module
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <swmetrics.h>
+#include <swlog.h>
+#include <swthread.h>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+#ifdef USECXX11TIME
+#include <chrono>
+#elif !defined(WIN32)
+#include <sys/time.h>
+#else
+#include <time.h>
+#endif
+
+SWORD_NAMESPACE_START
+
+
+namespace {
+
+	const char *counterNames[] = {
+		"entryReads",
+		"entryBytes",
+		"blockDecompressions",
+		"decompressMicros",
+		"cacheHits",
+		"cacheMisses",
+		"prefetchHits",
+		"searches",
+		"searchMicros"
+	};
+
+	struct FilterCounts {
+		unsigned long calls;
+		unsigned long micros;
+	};
+
+	struct OwnerCounts {
+		SWBuf owner;
+		unsigned long counters[SWMetrics::COUNTER_COUNT];
+		// keyed by the filter name pointer, which is cheaper than its text
+		std::map<const char *, FilterCounts> filters;
+	};
+
+	std::map<SWBuf, OwnerCounts> owners;
+
+	// guards everything here, so any thread may count
+	SWMutex lock;
+
+	// most counting comes in runs for one module; remember the last one
+	OwnerCounts *lastOwner = 0;
+
+	unsigned long reportInterval = 0;
+	unsigned long lastReport = 0;
+	unsigned int untilReportCheck = 0;
+
+	OwnerCounts &getOwnerCounts(const char *owner) {
+		if (!owner) owner = "";
+		if (lastOwner && lastOwner->owner == owner) return *lastOwner;
+
+		std::map<SWBuf, OwnerCounts>::iterator it = owners.find(owner);
+		if (it == owners.end()) {
+			OwnerCounts &counts = owners[owner];
+			counts.owner = owner;
+			memset(counts.counters, 0, sizeof(counts.counters));
+			lastOwner = &counts;
+		}
+		else lastOwner = &it->second;
+		return *lastOwner;
+	}
+
+	// a readable class name from a typeid().name()
+	SWBuf getFilterName(const char *name) {
+		SWBuf retVal = name;
+#ifdef __GNUC__
+		int status = 0;
+		char *demangled = abi::__cxa_demangle(name, 0, 0, &status);
+		if (demangled) {
+			if (!status) retVal = demangled;
+			free(demangled);
+		}
+#endif
+		if (retVal.startsWith("sword::")) retVal << 7;
+		if (retVal.startsWith("class sword::")) retVal << 13;
+		return retVal;
+	}
+
+	// whether the report is due to be logged; looked at only now and then
+	bool isReportDue() {
+		if (!reportInterval || untilReportCheck--) return false;
+		untilReportCheck = 255;
+		unsigned long now = SWMetrics::getMicroseconds() / 1000000;
+		if (now - lastReport < reportInterval) return false;
+		lastReport = now;
+		return true;
+	}
+
+	void logReport() {
+		SWLog::getSystemLog()->logInformation("SWMetrics:\n%s", SWMetrics::getReport().c_str());
+	}
+}
+
+
+bool SWMetrics::enabled = false;
+
+
+void SWMetrics::reset() {
+	SWMutex::Locker locker(lock);
+	owners.clear();
+	lastOwner = 0;
+}
+
+
+void SWMetrics::add(const char *owner, Counter counter, unsigned long n) {
+	bool reportDue;
+	{
+		SWMutex::Locker locker(lock);
+		getOwnerCounts(owner).counters[counter] += n;
+		reportDue = isReportDue();
+	}
+	if (reportDue) logReport();
+}
+
+
+void SWMetrics::addFilterCall(const char *owner, const char *filter, unsigned long micros) {
+	bool reportDue;
+	{
+		SWMutex::Locker locker(lock);
+		std::map<const char *, FilterCounts> &filters = getOwnerCounts(owner).filters;
+		std::map<const char *, FilterCounts>::iterator it = filters.find(filter);
+		if (it == filters.end()) {
+			FilterCounts counts = { 1, micros };
+			filters[filter] = counts;
+		}
+		else {
+			it->second.calls++;
+			it->second.micros += micros;
+		}
+		reportDue = isReportDue();
+	}
+	if (reportDue) logReport();
+}
+
+
+SWMetrics::Snapshot SWMetrics::getSnapshot() {
+	SWMutex::Locker locker(lock);
+	Snapshot retVal;
+	Sample sample;
+	for (std::map<SWBuf, OwnerCounts>::const_iterator it = owners.begin(); it != owners.end(); ++it) {
+		sample.owner = it->first;
+		sample.filter = "";
+		for (int i = 0; i < COUNTER_COUNT; ++i) {
+			if (!it->second.counters[i]) continue;
+			sample.name = counterNames[i];
+			sample.value = it->second.counters[i];
+			retVal.push_back(sample);
+		}
+
+		// the same class may be known by more than one name pointer
+		std::map<SWBuf, FilterCounts> filters;
+		for (std::map<const char *, FilterCounts>::const_iterator f = it->second.filters.begin(); f != it->second.filters.end(); ++f) {
+			SWBuf name = getFilterName(f->first);
+			std::map<SWBuf, FilterCounts>::iterator merged = filters.find(name);
+			if (merged == filters.end()) filters[name] = f->second;
+			else {
+				merged->second.calls += f->second.calls;
+				merged->second.micros += f->second.micros;
+			}
+		}
+		for (std::map<SWBuf, FilterCounts>::const_iterator f = filters.begin(); f != filters.end(); ++f) {
+			sample.filter = f->first;
+			sample.name = "calls";
+			sample.value = f->second.calls;
+			retVal.push_back(sample);
+			sample.name = "micros";
+			sample.value = f->second.micros;
+			retVal.push_back(sample);
+		}
+	}
+	return retVal;
+}
+
+
+SWBuf SWMetrics::getReport() {
+	SWBuf retVal;
+	Snapshot snapshot = getSnapshot();
+	for (Snapshot::const_iterator it = snapshot.begin(); it != snapshot.end(); ++it) {
+		retVal += it->owner;
+		if (it->filter.size()) {
+			retVal += "/";
+			retVal += it->filter;
+		}
+		retVal.appendFormatted(" %s=%lu\n", it->name.c_str(), it->value);
+	}
+	return retVal;
+}
+
+
+void SWMetrics::setReportInterval(unsigned long seconds) {
+	SWMutex::Locker locker(lock);
+	reportInterval = seconds;
+	lastReport = getMicroseconds() / 1000000;
+	untilReportCheck = 0;
+}
+
+
+unsigned long SWMetrics::getMicroseconds() {
+#ifdef USECXX11TIME
+	return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#elif !defined(WIN32)
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return (unsigned long)tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+	// Windows' clock() counts wall time
+	return (unsigned long)(clock() * (1000000.0 / CLOCKS_PER_SEC));
+#endif
+}
+
+
+const char *SWMetrics::getCounterName(Counter counter) {
+	return (counter >= 0 && counter < COUNTER_COUNT) ? counterNames[counter] : "";
+}
+
+
+SWORD_NAMESPACE_END
@@ -27,6 +27,8 @@
 #include <stdlib.h>
 #include <swkey.h>
 #include <listkey.h>
+#include <versekey.h>
+#include <verseposition.h>
 #include <string.h>
 
 SWORD_NAMESPACE_START
@@ -34,6 +36,35 @@ SWORD_NAMESPACE_START
 static const char *classes[] = {"ListKey", "SWKey", "SWObject", 0};
 static const SWClass classdef(classes);
 
+
+namespace {
+
+	// whether keys made like a and like b come out the same
+	bool isLike(const VerseKey *a, const VerseKey *b) {
+		if (!a || !b) return a == b;
+		return a->isIntros() == b->isIntros()
+			&& a->isAutoNormalize() == b->isAutoNormalize()
+			&& !strcmp(a->getLocale(), b->getLocale())
+			&& !strcmp(a->getVersificationSystem(), b->getVersificationSystem());
+	}
+
+
+	// a VerseKey at pos, made like like, if given
+	VerseKey *makeVerseKey(const VersePosition &pos, const VerseKey *like) {
+		if (!like) return new VerseKey(pos);
+
+		VerseKey *key = (VerseKey *)like->clone();
+		if (pos.isRange()) {
+			key->setVersePosition(makeVersePosition(pos.system, pos.end));
+			key->setUpperBound(*key);
+			key->setVersePosition(pos);
+			key->setLowerBound(*key);
+		}
+		key->setVersePosition(pos);
+		return key;
+	}
+}
+
 /******************************************************************************
  * ListKey Constructor - initializes instance of ListKey
  *
@@ -42,6 +73,8 @@ static const SWClass classdef(classes);
 
 ListKey::ListKey(const char *ikey): SWKey(ikey) {
 	arraymax = 0;
+	positions = 0;
+	versePrototype = 0;
 	clear();
 	init();
 }
@@ -52,8 +85,12 @@ ListKey::ListKey(ListKey const &k) : SWKey(k.keytext) {
 	arraypos = k.arraypos;
 	arraycnt = k.arraycnt;
 	array = (arraymax)?(SWKey **)malloc(k.arraymax * sizeof(SWKey *)):0;
-	for (int i = 0; i < arraycnt; i++)
-		array[i] = k.array[i]->clone();
+	positions = (k.positions)?(VersePosition *)malloc(k.arraymax * sizeof(VersePosition)):0;
+	for (int i = 0; i < arraycnt; i++) {
+		array[i] = (k.array[i]) ? k.array[i]->clone() : 0;
+		if (positions) positions[i] = k.positions[i];
+	}
+	versePrototype = (k.versePrototype) ? (VerseKey *)k.versePrototype->clone() : 0;
 	init();
 }
 
@@ -93,11 +130,15 @@ void ListKey::clear()
 			delete array[loop];
 
 		free(array);
+		free(positions);
 		arraymax  = 0;
 	}
 	arraycnt  = 0;
 	arraypos  = 0;
 	array     = 0;
+	positions = 0;
+	delete versePrototype;
+	versePrototype = 0;
 }
 
 
@@ -114,8 +155,12 @@ void ListKey::copyFrom(const ListKey &ikey) {
 	arraypos = ikey.arraypos;
 	arraycnt = ikey.arraycnt;
 	array = (arraymax)?(SWKey **)malloc(ikey.arraymax * sizeof(SWKey *)):0;
-	for (int i = 0; i < arraycnt; i++)
-		array[i] = ikey.array[i]->clone();
+	positions = (ikey.positions)?(VersePosition *)malloc(ikey.arraymax * sizeof(VersePosition)):0;
+	for (int i = 0; i < arraycnt; i++) {
+		array[i] = (ikey.array[i]) ? ikey.array[i]->clone() : 0;
+		if (positions) positions[i] = ikey.positions[i];
+	}
+	versePrototype = (ikey.versePrototype) ? (VerseKey *)ikey.versePrototype->clone() : 0;
 
 	setToElement(0);
 }
@@ -125,16 +170,74 @@ void ListKey::copyFrom(const ListKey &ikey) {
  * ListKey::add - Adds an element to the list
  */
 
-void ListKey::add(const SWKey &ikey) {
+void ListKey::grow() {
 	if (++arraycnt > arraymax) {
 		array = (SWKey **) ((array) ? realloc(array, (arraycnt + 32) * sizeof(SWKey *)) : calloc(arraycnt + 32, sizeof(SWKey *)));
+		if (positions) positions = (VersePosition *)realloc(positions, (arraycnt + 32) * sizeof(VersePosition));
 		arraymax = arraycnt + 32;
 	}
+}
+
+
+void ListKey::add(const SWKey &ikey) {
+	grow();
 	array[arraycnt-1] = ikey.clone();
 	setToElement(arraycnt-1);
 }
 
 
+void ListKey::add(const VersePosition &pos, const VerseKey *like) {
+	// a search adds all its hits like the same key, so this is usually
+	// one comparison; otherwise, the elements made like the last one
+	// become keys before it goes
+	if (!isLike(versePrototype, like)) {
+		makePendingKeys();
+		delete versePrototype;
+		versePrototype = 0;
+		if (like) {
+			versePrototype = (VerseKey *)like->clone();
+			versePrototype->clearBounds();
+		}
+	}
+	grow();
+	if (!positions) positions = (VersePosition *)malloc(arraymax * sizeof(VersePosition));
+	array[arraycnt-1] = 0;
+	positions[arraycnt-1] = pos;
+	arraypos = arraycnt-1;
+	error = 0;
+}
+
+
+void ListKey::makePendingKeys() {
+	for (int i = 0; i < arraycnt; ++i) getKeyAt(i);
+}
+
+
+SWKey *ListKey::getKeyAt(int i) const {
+	if (!array[i]) array[i] = makeVerseKey(positions[i], versePrototype);
+	return array[i];
+}
+
+
+bool ListKey::getVersePosition(VersePosition &pos, int element) const {
+	if (element < 0) element = arraypos;
+	if (element >= arraycnt) return false;
+
+	if (!array[element]) {
+		pos = positions[element];
+		return true;
+	}
+	const VerseKey *vk = SWDYNAMIC_CAST(const VerseKey, array[element]);
+	if (!vk) return false;
+	pos = vk->getVersePosition();
+	if (vk->isBoundSet()) {
+		pos.index = vk->getLowerBound().getIndex();
+		pos.end = vk->getUpperBound().getIndex();
+	}
+	return true;
+}
+
+
 
 /******************************************************************************
  * ListKey::setPosition(SW_POSITION)	- Positions this key
@@ -168,12 +271,13 @@ void ListKey::increment(int step) {
 	popError();		// clear error
 	for(; step && !popError(); step--) {
 		if (arraypos < arraycnt && arraycnt) {
-			if (array[arraypos]->isBoundSet())
-				(*(array[arraypos]))++;
-			if ((array[arraypos]->popError()) || (!array[arraypos]->isBoundSet())) {
+			SWKey *key = getKeyAt(arraypos);
+			if (key->isBoundSet())
+				(*key)++;
+			if ((key->popError()) || (!key->isBoundSet())) {
 				setToElement(arraypos+1);
 			}
-			else SWKey::setText((const char *)(*array[arraypos]));
+			else SWKey::setText((const char *)(*key));
 		}
 		else error = KEYERR_OUTOFBOUNDS;
 	}
@@ -192,12 +296,13 @@ void ListKey::decrement(int step) {
 	popError();		// clear error
 	for(; step && !popError(); step--) {
 		if (arraypos > -1 && arraycnt) {
-			if (array[arraypos]->isBoundSet())
-				(*(array[arraypos]))--;
-			if ((array[arraypos]->popError()) || (!array[arraypos]->isBoundSet())) {
+			SWKey *key = getKeyAt(arraypos);
+			if (key->isBoundSet())
+				(*key)--;
+			if ((key->popError()) || (!key->isBoundSet())) {
 				setToElement(arraypos-1, BOTTOM);
 			}
-			else SWKey::setText((const char *)(*array[arraypos]));
+			else SWKey::setText((const char *)(*key));
 		}
 		else error = KEYERR_OUTOFBOUNDS;
 	}
@@ -239,9 +344,10 @@ char ListKey::setToElement(int ielement, SW_POSITION pos) {
 	}
 	
 	if (arraycnt) {
-		if (array[arraypos]->isBoundSet())
-			(*array[arraypos]) = pos;
-		SWKey::setText((const char *)(*array[arraypos]));
+		SWKey *key = getKeyAt(arraypos);
+		if (key->isBoundSet())
+			(*key) = pos;
+		SWKey::setText((const char *)(*key));
 	}
 	else SWKey::setText("");
 	
@@ -264,7 +370,7 @@ const SWKey *ListKey::getElement(int pos) const {
 	if (pos >=arraycnt)
 		error = KEYERR_OUTOFBOUNDS;
 
-	return (error) ? 0:array[pos];
+	return (error) ? 0:getKeyAt(pos);
 }
 
 SWKey *ListKey::getElement(int pos) {
@@ -281,8 +387,10 @@ SWKey *ListKey::getElement(int pos) {
 void ListKey::remove() {
 	if ((arraypos > -1) && (arraypos < arraycnt)) {
 		delete array[arraypos];
-		if (arraypos < arraycnt - 1)
+		if (arraypos < arraycnt - 1) {
 			memmove(&array[arraypos], &array[arraypos+1], (arraycnt - arraypos - 1) * sizeof(SWKey *));
+			if (positions) memmove(&positions[arraypos], &positions[arraypos+1], (arraycnt - arraypos - 1) * sizeof(VersePosition));
+		}
 		arraycnt--;
 		
 		setToElement((arraypos)?arraypos-1:0);
@@ -298,7 +406,7 @@ const char *ListKey::getRangeText() const {
 	char *buf = new char[(arraycnt + 1) * 255];
 	buf[0] = 0;
 	for (int i = 0; i < arraycnt; i++) {
-		strcat(buf, array[i]->getRangeText());
+		strcat(buf, getKeyAt(i)->getRangeText());
 		if (i < arraycnt-1)
 			strcat(buf, "; ");
 	}
@@ -316,7 +424,7 @@ const char *ListKey::getOSISRefRangeText() const {
 	char *buf = new char[(arraycnt + 1) * 255];
 	buf[0] = 0;
 	for (int i = 0; i < arraycnt; i++) {
-		strcat(buf, array[i]->getOSISRefRangeText());
+		strcat(buf, getKeyAt(i)->getOSISRefRangeText());
 		if (i < arraycnt-1)
 			strcat(buf, ";");
 	}
@@ -333,7 +441,7 @@ const char *ListKey::getOSISRefRangeText() const {
 const char *ListKey::getShortRangeText() const {
 	SWBuf buf;
 	for (int i = 0; i < arraycnt; i++) {
-		buf += array[i]->getShortRangeText();
+		buf += getKeyAt(i)->getShortRangeText();
 		if (i < arraycnt-1)
 			buf += "; ";
 	}
@@ -348,13 +456,13 @@ const char *ListKey::getShortRangeText() const {
 
 const char *ListKey::getText() const {
 	int pos = arraypos;
-	SWKey *key = (pos >= arraycnt || !arraycnt) ? 0:array[pos];
+	SWKey *key = (pos >= arraycnt || !arraycnt) ? 0:getKeyAt(pos);
 	return (key) ? key->getText() : keytext;
 }
 
 const char *ListKey::getShortText() const {
 	int pos = arraypos;
-	SWKey *key = (pos >= arraycnt || !arraycnt) ? 0:array[pos];
+	SWKey *key = (pos >= arraycnt || !arraycnt) ? 0:getKeyAt(pos);
 	return (key) ? key->getShortText() : keytext;
 }
 
@@ -362,7 +470,7 @@ const char *ListKey::getShortText() const {
 void ListKey::setText(const char *ikey) {
 	// at least try to set the current element to this text
 	for (arraypos = 0; arraypos < arraycnt; arraypos++) {
-		SWKey *key = array[arraypos];
+		SWKey *key = getKeyAt(arraypos);
 		if (key) {
 			if (key->isTraversable() && key->isBoundSet()) {
 				key->setText(ikey);
@@ -387,10 +495,19 @@ void ListKey::setText(const char *ikey) {
 void ListKey::sort() {
 	for (int i = 0; i < arraycnt; i++) {
 		for (int j = i; j < arraycnt; j++) {
-			if (*array[j] < *array[i]) {
+			// positions not yet made into keys compare by index
+			bool less = (!array[i] && !array[j] && positions[i].system == positions[j].system)
+					? positions[j].index < positions[i].index
+					: *getKeyAt(j) < *getKeyAt(i);
+			if (less) {
 				SWKey *tmp = array[i];
 				array[i] = array[j];
 				array[j] = tmp;
+				if (positions) {
+					VersePosition tmpPos = positions[i];
+					positions[i] = positions[j];
+					positions[j] = tmpPos;
+				}
 			}
 		}
 	}
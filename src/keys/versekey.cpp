@@ -36,6 +36,7 @@
 #include <swlocale.h>
 #include <roman.h>
 #include <versificationmgr.h>
+#include <swthread.h>
 
 SWORD_NAMESPACE_START
 
@@ -117,6 +118,19 @@ VerseKey::VerseKey(VerseKey const &k) : SWKey(k)
 }
 
 
+VerseKey::VerseKey(const VersePosition &pos) : SWKey()
+{
+	init(pos.system->getName());
+	if (pos.isRange()) {
+		setIndex(pos.end);
+		setUpperBound(*this);
+		setIndex(pos.index);
+		setLowerBound(*this);
+	}
+	setVersePosition(pos);
+}
+
+
 /******************************************************************************
  * VerseKey::setFromOther - Positions this VerseKey to another VerseKey
  */
@@ -1251,19 +1265,16 @@ const char *VerseKey::getText() const {
 
 
 const char *VerseKey::getShortText() const {
-	static char *stext = 0;
-	char buf[2047];
 	freshtext();
 	if (book < 1) {
 		if (testament < 1)
-			sprintf(buf, "[ Module Heading ]");
-		else sprintf(buf, "[ Testament %d Heading ]", (int)testament);
+			shortText = "[ Module Heading ]";
+		else shortText.setFormatted("[ Testament %d Heading ]", (int)testament);
 	}
 	else {
-		sprintf(buf, "%s %d:%d", getBookAbbrev(), chapter, verse);
+		shortText.setFormatted("%s %d:%d", getBookAbbrev(), chapter, verse);
 	}
-	stdstr(&stext, buf);
-	return stext;
+	return shortText.c_str();
 }
 
 
@@ -1743,6 +1754,23 @@ void VerseKey::setIndex(long iindex)
 	checkBounds();
 }
 
+VersePosition VerseKey::getVersePosition() const {
+	return makeVersePosition(refSys, getIndex());
+}
+
+
+void VerseKey::setVersePosition(const VersePosition &pos) {
+	error = 0;
+	long index = (pos.system == refSys) ? pos.index : pos.system->translateVerse(refSys, pos).index;
+	if (index < 0) {
+		error = KEYERR_OUTOFBOUNDS;
+		return;
+	}
+	suffix = 0;
+	setIndex(index);
+}
+
+
 void VerseKey::checkBounds() {
 
 	long i = getIndex();
@@ -1819,8 +1847,9 @@ int VerseKey::_compare(const VerseKey &ivkey)
 
 
 const char *VerseKey::getOSISRef() const {
-	static char buf[5][254];
-	static int loop = 0;
+	// each thread rotates through buffers of its own
+	static SWTHREADLOCAL char buf[5][254];
+	static SWTHREADLOCAL int loop = 0;
 
 	if (loop > 4)
 		loop = 0;
@@ -29,6 +29,11 @@
 
 #include <swlog.h>
 
+#include <fcntl.h>
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
 
 SWORD_NAMESPACE_START
 
@@ -38,6 +43,7 @@ namespace {
 		const char *filename;
 		int fd;
 		SWBuf *destBuf;
+		bool append;
 	};
 
 
@@ -58,7 +64,9 @@ namespace {
 		struct FtpFile *out = (struct FtpFile *)stream;
 		if (out && !out->fd && !out->destBuf) {
 			/* open file for writing */
-			out->fd = FileMgr::createPathAndFile(out->filename);
+			out->fd = (out->append)
+				? FileMgr::openFile(out->filename, FileMgr::WRONLY|FileMgr::APPEND|O_BINARY, FileMgr::IREAD|FileMgr::IWRITE)
+				: FileMgr::createPathAndFile(out->filename);
 			if (out->fd < 0)
 				return -1; /* failure, can't open file to write */
 		}
@@ -133,9 +141,59 @@ CURLFTPTransport::~CURLFTPTransport() {
 }
 
 
+// the size and modification time of the file the last transfer was of
+SWBuf CURLFTPTransport::fileValidator() {
+	long fileTime = -1;
+	curl_easy_getinfo(session, CURLINFO_FILETIME, &fileTime);
+#if LIBCURL_VERSION_NUM >= 0x073700 // 7.55.0 or later
+	curl_off_t size = -1;
+	curl_easy_getinfo(session, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &size);
+#else
+	double size = -1;
+	curl_easy_getinfo(session, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &size);
+#endif
+	if (size < 0 || fileTime < 0) return "";
+	return SWBuf().setFormatted("%ld %ld", (long)size, fileTime);
+}
+
+
+RemoteTransport *CURLFTPTransport::clone() const {
+	RemoteTransport *retVal = new CURLFTPTransport(host, statusReporter);
+	copySettingsTo(retVal);
+	return retVal;
+}
+
+
 char CURLFTPTransport::getURL(const char *destPath, const char *sourceURL, SWBuf *destBuf) {
+	return transfer(destPath, sourceURL, destBuf, 0);
+}
+
+
+char CURLFTPTransport::resumeURL(const char *destPath, const char *sourceURL, long offset, const char *validator) {
+	// without a validator to check, we might append another file's tail
+	if (!validator || !*validator) return -1;
+	return transfer(destPath, sourceURL, 0, offset, 0, validator);
+}
+
+
+char CURLFTPTransport::getURLRange(const char *sourceURL, long offset, long length, SWBuf *destBuf) {
+	destBuf->size(0);
+	char retVal = transfer("", sourceURL, destBuf, offset, length);
+	if (retVal) return retVal;
+	// a server which ignores the range sends the whole resource
+	if ((long)destBuf->size() > length) {
+		if ((long)destBuf->size() < offset + length) return -1;
+		memmove(destBuf->getRawData(), destBuf->getRawData() + offset, length);
+		destBuf->size(length);
+	}
+	return ((long)destBuf->size() == length) ? 0 : -1;
+}
+
+
+char CURLFTPTransport::transfer(const char *destPath, const char *sourceURL, SWBuf *destBuf, long offset, long length, const char *resumeValidator) {
 	signed char retVal = 0;
-	struct FtpFile ftpfile = {destPath, 0, destBuf};
+	struct FtpFile ftpfile = {destPath, 0, destBuf, (offset > 0)};
+	validator = "";
 
 	CURLcode res;
 	
@@ -146,6 +204,11 @@ char CURLFTPTransport::getURL(const char *destPath, const char *sourceURL, SWBuf
 		pd.term = &term;
 
 		curl_easy_setopt(session, CURLOPT_URL, sourceURL);
+		// a range request, or REST over ftp; and none, for the next transfer
+		SWBuf range;
+		if (length > 0) range.setFormatted("%ld-%ld", offset, offset + length - 1);
+		curl_easy_setopt(session, CURLOPT_RANGE, (length > 0) ? range.c_str() : (const char *)0);
+		curl_easy_setopt(session, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)((length > 0) ? 0 : offset));
 	
 		SWBuf credentials = u + ":" + p;
 		curl_easy_setopt(session, CURLOPT_USERPWD, credentials.c_str());
@@ -185,11 +248,33 @@ SWLOGD("***** using CURLOPT_FTP_USE_EPRT\n");
 #endif
 
 
+		// MDTM, with SIZE, tells one version of a file from another
+		curl_easy_setopt(session, CURLOPT_FILETIME, 1L);
+
+		res = CURLE_OK;
+		if (resumeValidator) {
+			// ftp has no If-Range, so see first that the file is as it was
+			curl_easy_setopt(session, CURLOPT_NOBODY, 1L);
+			curl_easy_setopt(session, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+			res = curl_easy_perform(session);
+			curl_easy_setopt(session, CURLOPT_NOBODY, 0L);
+			curl_easy_setopt(session, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)offset);
+			if (CURLE_OK == res && fileValidator() != resumeValidator) {
+				curl_easy_setopt(session, CURLOPT_PROGRESSDATA, (void*)NULL);
+				return -1;
+			}
+		}
+
+		if (CURLE_OK == res) {
 SWLOGD("***** About to perform curl easy action. \n");
 SWLOGD("***** destPath: %s \n", destPath);
 SWLOGD("***** sourceURL: %s \n", sourceURL);
-		res = curl_easy_perform(session);
+			res = curl_easy_perform(session);
 SWLOGD("***** Finished performing curl easy action. \n");
+		}
+
+		// the size a resumed transfer reports is of what's left
+		validator = (resumeValidator) ? SWBuf(resumeValidator) : fileValidator();
 
 		// it seems CURL tries to use this option data later for some reason, so we unset here
 		curl_easy_setopt(session, CURLOPT_PROGRESSDATA, (void*)NULL);
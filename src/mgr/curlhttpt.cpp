@@ -28,10 +28,16 @@
 
 #include <swlog.h>
 #include <filemgr.h>
+#include <utilstr.h>
 #include <curlhttpt.h>
 
 using std::vector;
 
+#include <fcntl.h>
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
 
 SWORD_NAMESPACE_START
 
@@ -41,6 +47,7 @@ namespace {
 		const char *filename;
 		int fd;
 		SWBuf *destBuf;
+		bool append;
 	};
 
 
@@ -48,7 +55,9 @@ namespace {
 		struct FtpFile *out = (struct FtpFile *)stream;
 		if (out && !out->fd && !out->destBuf) {
 			/* open file for writing */
-			out->fd = FileMgr::createPathAndFile(out->filename);
+			out->fd = (out->append)
+				? FileMgr::openFile(out->filename, FileMgr::WRONLY|FileMgr::APPEND|O_BINARY, FileMgr::IREAD|FileMgr::IWRITE)
+				: FileMgr::createPathAndFile(out->filename);
 			if (out->fd < 0)
 				return -1; /* failure, can't open file to write */
 		}
@@ -66,6 +75,54 @@ namespace {
 		bool *term;
 	};
 
+
+	// what the headers of the last response say of the resource
+	struct ResponseHeaders {
+		long total;		// its size, or -1
+		SWBuf etag;
+		SWBuf lastModified;
+
+		void reset() { total = -1; etag = ""; lastModified = ""; }
+
+		// the size, and the ETag or failing that the Last-Modified date
+		SWBuf getValidator() const {
+			const SWBuf &tag = (etag.length()) ? etag : lastModified;
+			if (total < 0 || !tag.length()) return "";
+			return SWBuf().setFormatted("%ld %s", total, tag.c_str());
+		}
+	};
+
+
+	SWBuf headerValue(const char *line, size_t len, size_t nameLen) {
+		SWBuf value;
+		const char *start = line + nameLen;
+		const char *end = line + len;
+		while (start < end && (*start == ' ' || *start == '\t')) start++;
+		while (end > start && (end[-1] == '\r' || end[-1] == '\n' || end[-1] == ' ')) end--;
+		value.append(start, end - start);
+		return value;
+	}
+
+
+	static size_t my_httpheader(char *buffer, size_t size, size_t nitems, void *userdata) {
+		ResponseHeaders *headers = (ResponseHeaders *)userdata;
+		size_t len = size * nitems;
+		// each response, after a redirect say, starts afresh
+		if (len > 5 && !strncmp(buffer, "HTTP/", 5)) headers->reset();
+		else if (len > 5 && !strnicmp(buffer, "ETag:", 5)) headers->etag = headerValue(buffer, len, 5);
+		else if (len > 14 && !strnicmp(buffer, "Last-Modified:", 14)) headers->lastModified = headerValue(buffer, len, 14);
+		else if (len > 15 && !strnicmp(buffer, "Content-Length:", 15)) {
+			// a range's length isn't the size of the resource
+			if (headers->total < 0) headers->total = atol(headerValue(buffer, len, 15));
+		}
+		else if (len > 14 && !strnicmp(buffer, "Content-Range:", 14)) {
+			SWBuf range = headerValue(buffer, len, 14);
+			const char *slash = strchr(range.c_str(), '/');
+			headers->total = (slash && slash[1] != '*') ? atol(slash + 1) : -1;
+		}
+		return len;
+	}
+
 	static int my_httpfprogress(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow) {
 		if (clientp) {
 			MyProgressData *pd = (MyProgressData *)clientp;
@@ -121,9 +178,45 @@ CURLHTTPTransport::~CURLHTTPTransport() {
 }
 
 
+RemoteTransport *CURLHTTPTransport::clone() const {
+	RemoteTransport *retVal = new CURLHTTPTransport(host, statusReporter);
+	copySettingsTo(retVal);
+	return retVal;
+}
+
+
 char CURLHTTPTransport::getURL(const char *destPath, const char *sourceURL, SWBuf *destBuf) {
+	return transfer(destPath, sourceURL, destBuf, 0);
+}
+
+
+char CURLHTTPTransport::resumeURL(const char *destPath, const char *sourceURL, long offset, const char *validator) {
+	// without a validator to send, we might append another file's tail
+	if (!validator || !*validator) return -1;
+	return transfer(destPath, sourceURL, 0, offset, 0, validator);
+}
+
+
+char CURLHTTPTransport::getURLRange(const char *sourceURL, long offset, long length, SWBuf *destBuf) {
+	destBuf->size(0);
+	char retVal = transfer("", sourceURL, destBuf, offset, length);
+	if (retVal) return retVal;
+	// a server which ignores the range sends the whole resource
+	if ((long)destBuf->size() > length) {
+		if ((long)destBuf->size() < offset + length) return -1;
+		memmove(destBuf->getRawData(), destBuf->getRawData() + offset, length);
+		destBuf->size(length);
+	}
+	return ((long)destBuf->size() == length) ? 0 : -1;
+}
+
+
+char CURLHTTPTransport::transfer(const char *destPath, const char *sourceURL, SWBuf *destBuf, long offset, long length, const char *resumeValidator) {
 	signed char retVal = 0;
-	struct FtpFile ftpfile = {destPath, 0, destBuf};
+	struct FtpFile ftpfile = {destPath, 0, destBuf, (offset > 0)};
+	ResponseHeaders headers;
+	headers.reset();
+	validator = "";
 
 	CURLcode res;
 
@@ -134,6 +227,25 @@ char CURLHTTPTransport::getURL(const char *destPath, const char *sourceURL, SWBu
 		pd.term = &term;
 
 		curl_easy_setopt(session, CURLOPT_URL, sourceURL);
+		// a range request, or REST over ftp; and none, for the next transfer
+		SWBuf range;
+		if (length > 0) range.setFormatted("%ld-%ld", offset, offset + length - 1);
+		curl_easy_setopt(session, CURLOPT_RANGE, (length > 0) ? range.c_str() : (const char *)0);
+		curl_easy_setopt(session, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)((length > 0) ? 0 : offset));
+
+		// resume only the version we have the start of: a server whose
+		// file has changed since sends all of it, which curl refuses
+		long resumeTotal = -1;
+		struct curl_slist *ifRange = 0;
+		if (resumeValidator) {
+			char *tag = 0;
+			resumeTotal = strtol(resumeValidator, &tag, 10);
+			while (*tag == ' ') tag++;
+			ifRange = curl_slist_append(ifRange, (SWBuf("If-Range: ") + tag).c_str());
+		}
+		curl_easy_setopt(session, CURLOPT_HTTPHEADER, ifRange);
+		curl_easy_setopt(session, CURLOPT_HEADERFUNCTION, my_httpheader);
+		curl_easy_setopt(session, CURLOPT_HEADERDATA, &headers);
 
 		SWBuf credentials = u + ":" + p;
 		curl_easy_setopt(session, CURLOPT_USERPWD, credentials.c_str());
@@ -186,6 +298,17 @@ SWLOGD("***** sourceURL: %s \n", sourceURL);
 		res = curl_easy_perform(session);
 SWLOGD("***** Finished performing curl easy action. \n");
 
+		curl_easy_setopt(session, CURLOPT_HTTPHEADER, (struct curl_slist *)0);
+		curl_slist_free_all(ifRange);
+		validator = headers.getValidator();
+
+		// what we appended to must have been part of the same file
+		if (CURLE_OK == res && resumeValidator) {
+			long status = 0;
+			curl_easy_getinfo(session, CURLINFO_RESPONSE_CODE, &status);
+			if (status != 206 || headers.total != resumeTotal) retVal = -1;
+		}
+
 		if(CURLE_OK != res) {
 			if (CURLE_OPERATION_TIMEDOUT == res
 #ifdef CURLE_FTP_ACCEPT_TIMEOUT
@@ -32,6 +32,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <swbuf.h>
+#include <swmetrics.h>
 
 
 #if (defined(_WIN32) && !defined(_WIN32_WCE)) || !defined(__GNUC__)
@@ -118,6 +119,10 @@ long FileMgr::write(int fd, const void *buf, long count) {
 	return ::write(fd, buf, count);
 }
 
+long FileMgr::read(int fd, void *buf, long count) {
+	return ::read(fd, buf, count);
+}
+
 // --------------- end statics --------------
 
 
@@ -148,6 +153,8 @@ long FileDesc::seek(long offset, int whence) {
 
 
 long FileDesc::read(void *buf, long count) {
+	if (fd == -77) SWMETRICS_ADD("FileMgr", CACHE_MISSES, 1);
+	else SWMETRICS_ADD("FileMgr", CACHE_HITS, 1);
 	return ::read(getFd(), buf, count);
 }
 
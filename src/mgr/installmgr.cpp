@@ -25,6 +25,8 @@
 #endif
 
 #include <installmgr.h>
+#include <moddelta.h>
+#include <modcatalog.h>
 #include <filemgr.h>
 #include <utilstr.h>
 
@@ -101,11 +103,14 @@ InstallMgr::InstallMgr(const char *privatePath, StatusReporter *sr, SWBuf u, SWB
 	timeoutMillis = 10000;
 	unverifiedPeerAllowed = true;
 	forgetInstallSource = false;
+	maxTransfers = 4;
+	deltaUpdates = true;
 	statusReporter = sr;
 	this->u = u;
 	this->p = p;
 	this->privatePath = 0;
 	this->transport = 0;
+	idleTransport = 0;
 	installConf = 0;
 	stdstr(&(this->privatePath), privatePath);
 	if (this->privatePath) {
@@ -124,6 +129,7 @@ InstallMgr::InstallMgr(const char *privatePath, StatusReporter *sr, SWBuf u, SWB
 InstallMgr::~InstallMgr() {
 	delete [] privatePath;
 	delete installConf;
+	delete idleTransport;
 	clearSources();
 }
 
@@ -339,46 +345,49 @@ int InstallMgr::removeModule(SWMgr *manager, const char *moduleName) {
 }
 
 
-// TODO: rename to netCopy
-int InstallMgr::remoteCopy(InstallSource *is, const char *src, const char *dest, bool dirTransfer, const char *suffix) {
-SWLOGD("remoteCopy: %s, %s, %s, %c, %s", (is?is->source.c_str():"null"), src, (dest?dest:"null"), (dirTransfer?'t':'f'), (suffix?suffix:"null"));
-
-	// assert user disclaimer has been confirmed
-	if (!isUserDisclaimerConfirmed()) return -1;
-
-	int retVal = 0;
+RemoteTransport *InstallMgr::acquireTransport(InstallSource *is, SWBuf &urlPrefix) {
 	RemoteTransport *trans = 0;
-	if (is->type == "FTP" 
+	SWBuf user = (is->u.length()) ? is->u : u;
+	SWBuf passwd = (is->u.length()) ? is->p : p;
+
+	// the last transport, if it went to the same place, with its connections open
+	SWBuf transportKey = is->type + "://" + user + ":" + passwd + "@" + is->source;
+	if (idleTransport && idleTransportKey == transportKey) {
+		trans = idleTransport;
+		idleTransport = 0;
+	}
+	else {
+		delete idleTransport;
+		idleTransport = 0;
+
+		if (is->type == "FTP" 
 #ifdef CURLSFTPAVAILABLE
-		|| is->type == "SFTP"
+			|| is->type == "SFTP"
 #endif
-		) {
+			) {
 
-		trans = createFTPTransport(is->source, statusReporter);
-		trans->setPassive(passive);
-		trans->setTimeoutMillis(timeoutMillis);
-	}
-	else if (is->type == "HTTP" || is->type == "HTTPS") {
-		trans = createHTTPTransport(is->source, statusReporter);
+			trans = createFTPTransport(is->source, statusReporter);
+		}
+		else if (is->type == "HTTP" || is->type == "HTTPS") {
+			trans = createHTTPTransport(is->source, statusReporter);
+		}
 	}
 
 	// if no transport, then requested transport not available
-	if (!trans) return -9;
+	if (!trans) return 0;
 
+	if (is->type != "HTTP" && is->type != "HTTPS") {
+		trans->setPassive(passive);
+		trans->setTimeoutMillis(timeoutMillis);
+	}
 
 	transport = trans; // set classwide current transport for other thread terminate() call
-	if (is->u.length()) {
-		trans->setUser(is->u);
-		trans->setPasswd(is->p);
-	}
-	else {
-		trans->setUser(u);
-		trans->setPasswd(p);
-	}
+	trans->setUser(user);
+	trans->setPasswd(passwd);
 
 	trans->setUnverifiedPeerAllowed(unverifiedPeerAllowed);
+	trans->setMaxTransfers(maxTransfers);
 
-	SWBuf urlPrefix;
 	if (is->type == "HTTP") {
 		urlPrefix = (SWBuf) "http://";
 	}
@@ -395,6 +404,45 @@ SWLOGD("remoteCopy: %s, %s, %s, %c, %s", (is?is->source.c_str():"null"), src, (d
 	}
 	urlPrefix.append(is->source);
 
+	return trans;
+}
+
+
+void InstallMgr::releaseTransport(InstallSource *is, RemoteTransport *trans) {
+	SWTRY {
+		RemoteTransport *doneWith = trans;
+		// do this order for threadsafeness
+		// (see terminate())
+		trans = transport = 0;
+		// one told to terminate stays that way, so only keep the others
+		if (doneWith->isTerminated()) {
+			delete doneWith;
+		}
+		else {
+			SWBuf user = (is->u.length()) ? is->u : u;
+			SWBuf passwd = (is->u.length()) ? is->p : p;
+			idleTransport = doneWith;
+			idleTransportKey = is->type + "://" + user + ":" + passwd + "@" + is->source;
+		}
+	}
+	SWCATCH (...) {}
+}
+
+
+// TODO: rename to netCopy
+int InstallMgr::remoteCopy(InstallSource *is, const char *src, const char *dest, bool dirTransfer, const char *suffix) {
+SWLOGD("remoteCopy: %s, %s, %s, %c, %s", (is?is->source.c_str():"null"), src, (dest?dest:"null"), (dirTransfer?'t':'f'), (suffix?suffix:"null"));
+
+	// assert user disclaimer has been confirmed
+	if (!isUserDisclaimerConfirmed()) return -1;
+
+	int retVal = 0;
+	SWBuf urlPrefix;
+	RemoteTransport *trans = acquireTransport(is, urlPrefix);
+
+	// if no transport, then requested transport not available
+	if (!trans) return -9;
+
 	// let's be sure we can connect.  This seems to be necessary but sucks
 //	SWBuf url = urlPrefix + is->directory.c_str() + "/"; //dont forget the final slash
 //	if (trans->getURL("swdirlist.tmp", url.c_str())) {
@@ -418,7 +466,7 @@ SWLOGD("remoteCopy: dirTransfer: %s", dir.c_str());
 			SWBuf url = urlPrefix + is->directory.c_str();
 			removeTrailingSlash(url);
 			url += (SWBuf)"/" + src; //dont forget the final slash
-			retVal = trans->getURL(dest, url.c_str());
+			retVal = trans->downloadFile(dest, url.c_str());
 			if (retVal) {
 SWLOGD("netCopy: failed to get file %s", url.c_str());
 			}
@@ -427,14 +475,39 @@ SWLOGD("netCopy: failed to get file %s", url.c_str());
 			retVal = -1;
 		}
 	}
-	SWTRY {
-		RemoteTransport *deleteMe = trans;
-		// do this order for threadsafeness
-		// (see terminate())
-		trans = transport = 0;
-		delete deleteMe;
+	releaseTransport(is, trans);
+	return retVal;
+}
+
+
+int InstallMgr::deltaUpdate(InstallSource *is, const char *relativePath, const char *installedPath, const char *cachePath) {
+	SWBuf src = relativePath;
+	removeTrailingSlash(src);
+	SWBuf manifestPath = cachePath;
+	removeTrailingSlash(manifestPath);
+	manifestPath += (SWBuf)"/" + ModuleDelta::MANIFEST;
+
+	// the repository has no manifest for the module, most likely
+	int retVal = remoteCopy(is, src + "/" + ModuleDelta::MANIFEST, manifestPath, false);
+	if (!retVal) {
+		SWBuf urlPrefix;
+		RemoteTransport *trans = acquireTransport(is, urlPrefix);
+		if (!trans) return -9;
+		SWBuf dataURL = urlPrefix + is->directory.c_str();
+		removeTrailingSlash(dataURL);
+		dataURL += (SWBuf)"/" + src + "/";
+		SWTRY {
+			retVal = ModuleDelta::update(trans, dataURL, manifestPath, installedPath);
+		}
+		SWCATCH (...) {
+			retVal = -1;
+		}
+		// -3 from a transport can mean a refusal; we mean only a termination
+		if (retVal) retVal = (trans->isTerminated()) ? -3 : -1;
+		releaseTransport(is, trans);
 	}
-	SWCATCH (...) {}
+	else if (retVal == -1) retVal = -3;	// user aborted, as remoteCopy has it
+	FileMgr::removeFile(manifestPath);
 	return retVal;
 }
 
@@ -448,6 +521,7 @@ int InstallMgr::installModule(SWMgr *destMgr, const char *fromLocation, const ch
 	SWBuf sourceDir;
 	SWBuf buffer;
 	bool aborted = false;
+	bool updated = false;
 	bool cipher = false;
 	SWBuf modFile;
 	SWBuf sourceUID = "local";
@@ -567,6 +641,19 @@ SWLOGD("***** modName: %s \n", modName);
 		else {
 			// if we're copying remotely instead of locally
 			if (is) {
+
+				//
+				// If we have the module already, try to fetch only what changed
+				//
+				SWBuf installedPath = (SWBuf)destMgr->prefixPath + relativePath;
+				if (deltaUpdates && relativePath.length() && absolutePath.length() && FileMgr::existsDir(installedPath)) {
+SWLOGD("***** installModule: trying a delta update of: %s \n", installedPath.c_str());
+					int errorCode = deltaUpdate(is, relativePath, installedPath, absolutePath);
+					if (!errorCode) updated = true;
+					else if (errorCode == -3) aborted = true;	// user aborted
+				}
+			}
+			if (is && !updated && !aborted) {
 				
 				//
 				// First try to see if a single archive exists
@@ -630,7 +717,7 @@ SWLOGD("***** relativePath: %s \n", relativePath.c_str());
 		if (!aborted) {
 			// copy the tmp netCopied files (or local files) to real destination
 			SWBuf destPath = (SWBuf)destMgr->prefixPath + relativePath;
-			retVal = FileMgr::copyDir(absolutePath.c_str(), destPath.c_str());
+			if (!updated) retVal = FileMgr::copyDir(absolutePath.c_str(), destPath.c_str());
 
 			if (is) {		// delete tmp netCopied files
 //				mgr->deleteModule(modName);
@@ -704,6 +791,15 @@ int InstallMgr::refreshRemoteSource(InstallSource *is) {
 	SWBuf target = root + "/mods.d";
 	int errorCode = -1; //0 means successful
 
+	// a catalog lets us fetch only the .conf files which changed
+	if (!packagePreference) {
+		errorCode = refreshFromCatalog(is, root);
+		if (errorCode <= 0) return errorCode;
+		errorCode = -1;
+	}
+
+	SWBuf catalogPath = root + "/" + ModuleCatalog::FILENAME;
+	FileMgr::removeFile(catalogPath.c_str());
 	FileMgr::removeDir(target.c_str());
 
 	if (!FileMgr::existsDir(target))
@@ -735,11 +831,91 @@ int InstallMgr::refreshRemoteSource(InstallSource *is) {
 #endif
 	errorCode = remoteCopy(is, "mods.d", target.c_str(), true, ".conf"); //copy the whole directory
 
+	// catalog what we got, for getCatalog() and the next refresh
+	if (!errorCode) {
+		ModuleCatalog catalog;
+		if (!catalog.build(target)) catalog.save(catalogPath);
+	}
+
 	is->flush();
 	return errorCode;
 }
 
 
+int InstallMgr::refreshFromCatalog(InstallSource *is, const char *root) {
+	SWBuf target = (SWBuf)root + "/mods.d";
+	SWBuf catalogPath = (SWBuf)root + "/" + ModuleCatalog::FILENAME;
+	SWBuf newCatalogPath = catalogPath + ".new";
+
+	FileMgr::removeFile(newCatalogPath.c_str());
+	int errorCode = remoteCopy(is, ModuleCatalog::FILENAME, newCatalogPath.c_str(), false);
+	if (errorCode == -1) return -1;	// user aborted
+	ModuleCatalog remote;
+	if (errorCode || !remote.load(newCatalogPath)) {
+		FileMgr::removeFile(newCatalogPath.c_str());
+		return 1;
+	}
+
+	// what we have: as last catalogued, or failing that, as it is
+	ModuleCatalog local;
+	if (!FileMgr::existsDir(target)) local.clear();
+	else if (!local.load(catalogPath)) local.build(target);
+
+	map<SWBuf, SWBuf> have, want;
+	for (ModuleCatalog::EntryMap::const_iterator it = local.getEntries().begin(); it != local.getEntries().end(); ++it) {
+		have[it->second.confFile] = it->second.confHash;
+	}
+	for (ModuleCatalog::EntryMap::const_iterator it = remote.getEntries().begin(); it != remote.getEntries().end(); ++it) {
+		want[it->second.confFile] = it->second.confHash;
+	}
+
+	if (!FileMgr::existsDir(target))
+		FileMgr::createPathAndFile(target + "/globals.conf");
+
+	bool changed = false;
+	for (map<SWBuf, SWBuf>::const_iterator it = want.begin(); it != want.end() && !errorCode; ++it) {
+		map<SWBuf, SWBuf>::const_iterator old = have.find(it->first);
+		SWBuf confPath = target + "/" + it->first;
+		if (old != have.end() && old->second == it->second && FileMgr::existsFile(confPath)) continue;
+SWLOGD("refreshFromCatalog: fetching %s", it->first.c_str());
+		errorCode = remoteCopy(is, SWBuf("mods.d/") + it->first, confPath.c_str(), false);
+		if (errorCode == -1) break;	// user aborted
+
+		// the .conf must be the one the catalog describes
+		SWBuf contents;
+		FileDesc *fd = (errorCode) ? 0 : FileMgr::getSystemFileMgr()->open(confPath, FileMgr::RDONLY);
+		if (fd && fd->getFd() >= 0) {
+			long size = fd->seek(0, SEEK_END);
+			fd->seek(0, SEEK_SET);
+			contents.setSize(size > 0 ? size : 0);
+			if (size > 0 && fd->read(contents.getRawData(), size) != size) contents.size(0);
+		}
+		FileMgr::getSystemFileMgr()->close(fd);
+		if (!errorCode && ModuleCatalog::getConfHash(contents.c_str(), contents.size()) != it->second) errorCode = 1;
+		changed = true;
+	}
+	if (!errorCode) {
+		for (map<SWBuf, SWBuf>::const_iterator it = have.begin(); it != have.end(); ++it) {
+			if (want.find(it->first) == want.end()) {
+				FileMgr::removeFile((target + "/" + it->first).c_str());
+				changed = true;
+			}
+		}
+		FileMgr::removeFile(catalogPath.c_str());
+		if (rename(newCatalogPath.c_str(), catalogPath.c_str())) errorCode = 1;
+	}
+	FileMgr::removeFile(newCatalogPath.c_str());
+
+	if (changed) {
+		// remove any cache file which might exist
+		SWBuf modCache = target + "/modules-conf.cache";
+		FileMgr::removeFile(modCache.c_str());
+	}
+	if (changed || errorCode) is->flush();
+	return (errorCode == -1) ? -1 : (errorCode) ? 1 : 0;
+}
+
+
 bool InstallMgr::isDefaultModule(const char *modName) {
 	return defaultMods.count(modName);
 }
@@ -798,6 +974,39 @@ map<SWModule *, int> InstallMgr::getModuleStatus(const SWMgr &base, const SWMgr
 }
 
 
+map<SWBuf, int> InstallMgr::getModuleStatus(const SWMgr &base, const ModuleCatalog &other, bool utilModules) {
+	map<SWBuf, int> retVal;
+	SWBuf targetVersion;
+	SWBuf sourceVersion;
+	int modStat;
+
+	for (ModuleCatalog::EntryMap::const_iterator mod = other.getEntries().begin(); mod != other.getEntries().end(); ++mod) {
+		if (mod->second.isUtility() != utilModules) continue;
+
+		modStat = 0;
+
+		targetVersion = "0.0";
+		sourceVersion = "1.0";
+
+		if (mod->second.version.length()) sourceVersion = mod->second.version;
+
+		const SWModule *baseMod = base.getModule(mod->first);
+		if (baseMod) {
+			targetVersion = "1.0";
+			const char *v = baseMod->getConfigEntry("Version");
+			if (v) targetVersion = v;
+			modStat |= (SWVersion(sourceVersion.c_str()) > SWVersion(targetVersion.c_str())) ? MODSTAT_UPDATED : (SWVersion(sourceVersion.c_str()) < SWVersion(targetVersion.c_str())) ? MODSTAT_OLDER : MODSTAT_SAMEVERSION;
+		}
+		else modStat |= MODSTAT_NEW;
+
+		if (mod->second.ciphered) modStat |= MODSTAT_CIPHERED;
+		if (mod->second.keyPresent) modStat |= MODSTAT_CIPHERKEYPRESENT;
+		retVal[mod->first] = modStat;
+	}
+	return retVal;
+}
+
+
 /************************************************************************
  * refreshRemoteSourceConfiguration - grab master list of know remote
  * 	sources and integrate it with our configurations.
@@ -885,6 +1094,7 @@ int InstallMgr::refreshRemoteSourceConfiguration() {
 InstallSource::InstallSource(const char *type, const char *confEnt) : chainedSource(0), packagePreference(false) {
 	this->type = type;
 	mgr = 0;
+	catalog = 0;
 	userData = 0;
 	if (confEnt) {
 		SWBuf buf = confEnt;
@@ -905,6 +1115,7 @@ InstallSource::InstallSource(const char *type, const char *confEnt) : chainedSou
 InstallSource::~InstallSource() {
 	if (mgr)
 		delete mgr;
+	delete catalog;
 }
 
 
@@ -913,6 +1124,8 @@ void InstallSource::flush() {
 		delete mgr;
 		mgr = 0;
 	}
+	delete catalog;
+	catalog = 0;
 }
 
 
@@ -924,6 +1137,18 @@ SWMgr *InstallSource::getMgr() {
 }
 
 
+const ModuleCatalog *InstallSource::getCatalog() {
+	if (!catalog) {
+		catalog = new ModuleCatalog();
+		SWBuf root = localShadow;
+		removeTrailingSlash(root);
+		// a source refreshed before we kept catalogs has only its .conf files
+		if (!catalog->load(root + "/" + ModuleCatalog::FILENAME)) catalog->build(root + "/mods.d");
+	}
+	return catalog;
+}
+
+
 /** Override this and provide an input mechanism to allow your users
  *  to confirm that they understand this important disclaimer.
  *  This method will be called immediately before attempting to perform
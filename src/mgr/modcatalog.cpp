@@ -0,0 +1,246 @@
+/******************************************************************************
+ *
+ *  modcatalog.cpp -	class ModuleCatalog: a compact list of the modules
+ *			of a mods.d directory
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <modcatalog.h>
+#include <swconfig.h>
+#include <filemgr.h>
+#include <sysdata.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using std::vector;
+
+
+SWORD_NAMESPACE_START
+
+const char *ModuleCatalog::FILENAME = "mods.d.cat";
+
+namespace {
+
+	// file layout, all integers little endian:
+	//	"SWMC" version(4) entryCount(4)
+	//		{ name(str) confFile(str) confHash(str) version(str)
+	//		  category(str) lang(str) features(str) installSize(4) flags(4) }
+	//	str: length(4) bytes
+	const char MAGIC[] = "SWMC";
+	const SW_u32 VERSION = 1;
+
+	const SW_u32 CIPHERED = 1;
+	const SW_u32 KEYPRESENT = 2;
+
+	void putU32(SWBuf &out, SW_u32 val) {
+		val = archtosword32(val);
+		unsigned long size = out.length();
+		out.setSize(size + 4);
+		memcpy(out.getRawData() + size, &val, 4);
+	}
+
+	void putStr(SWBuf &out, const SWBuf &str) {
+		putU32(out, (SW_u32)str.length());
+		unsigned long size = out.length();
+		out.setSize(size + str.length());
+		memcpy(out.getRawData() + size, str.c_str(), str.length());
+	}
+
+	class Reader {
+		const char *pos, *end;
+	public:
+		bool ok;
+		Reader(const char *buf, unsigned long len) : pos(buf), end(buf + len), ok(true) {}
+
+		SW_u32 getU32() {
+			SW_u32 val = 0;
+			if (end - pos < 4) { ok = false; return 0; }
+			memcpy(&val, pos, 4);
+			pos += 4;
+			return swordtoarch32(val);
+		}
+
+		SWBuf getStr() {
+			SW_u32 len = getU32();
+			SWBuf str;
+			if (!ok || (unsigned long)(end - pos) < len) { ok = false; return str; }
+			str.setSize(len);
+			memcpy(str.getRawData(), pos, len);
+			pos += len;
+			return str;
+		}
+	};
+
+
+	bool readFile(const char *path, SWBuf &buf) {
+		buf.size(0);
+		FileDesc *fd = FileMgr::getSystemFileMgr()->open(path, FileMgr::RDONLY);
+		if (!fd || fd->getFd() < 0) {
+			FileMgr::getSystemFileMgr()->close(fd);
+			return false;
+		}
+		long size = fd->seek(0, SEEK_END);
+		fd->seek(0, SEEK_SET);
+		buf.setSize(size > 0 ? size : 0);
+		long got = (size > 0) ? fd->read(buf.getRawData(), size) : 0;
+		FileMgr::getSystemFileMgr()->close(fd);
+		return (got == size);
+	}
+}
+
+
+SWBuf ModuleCatalog::getConfHash(const char *data, unsigned long length) {
+	// 64-bit FNV-1a
+	SW_u64 hash = 0xcbf29ce484222325ULL;
+	const unsigned char *c = (const unsigned char *)data;
+	for (const unsigned char *end = c + length; c < end; ++c) {
+		hash ^= *c;
+		hash *= 0x100000001b3ULL;
+	}
+	SWBuf text;
+	text.setFormatted("%08x%08x", (SW_u32)(hash >> 32), (SW_u32)hash);
+	return text;
+}
+
+
+const ModuleCatalog::Entry *ModuleCatalog::getEntry(const char *name) const {
+	EntryMap::const_iterator it = entries.find(name);
+	return (it != entries.end()) ? &it->second : 0;
+}
+
+
+signed char ModuleCatalog::build(const char *modsDir) {
+	clear();
+	if (!FileMgr::existsDir(modsDir)) return -1;
+
+	SWBuf basePath = modsDir;
+	if (!basePath.endsWith("/") && !basePath.endsWith("\\")) basePath += "/";
+
+	vector<DirEntry> dirList = FileMgr::getDirList(modsDir);
+	for (unsigned int i = 0; i < dirList.size(); ++i) {
+		if (dirList[i].isDirectory || !dirList[i].name.endsWith(".conf")) continue;
+		SWBuf path = basePath + dirList[i].name;
+		SWBuf contents;
+		if (!readFile(path, contents)) return -1;
+		SWBuf confHash = getConfHash(contents.c_str(), contents.size());
+
+		SWConfig config(path);
+		for (SectionMap::iterator section = config.getSections().begin(); section != config.getSections().end(); ++section) {
+			// SWConfig's own record of comments and order
+			if (section->first.startsWith("_Conf")) continue;
+			ConfigEntMap &values = section->second;
+
+			Entry &entry = entries[section->first];
+			entry.name = section->first;
+			entry.confFile = dirList[i].name;
+			entry.confHash = confHash;
+			entry.version = values["Version"];
+			entry.category = values["Category"];
+			entry.lang = values["Lang"];
+			entry.features = "";
+			for (ConfigEntMap::iterator feature = values.lower_bound("Feature"); feature != values.upper_bound("Feature"); ++feature) {
+				if (entry.features.length()) entry.features += " ";
+				entry.features += feature->second;
+			}
+			entry.installSize = strtoul(values["InstallSize"], 0, 10);
+			ConfigEntMap::iterator cipherKey = values.find("CipherKey");
+			entry.ciphered = (cipherKey != values.end());
+			entry.keyPresent = entry.ciphered && cipherKey->second.length();
+		}
+	}
+	return 0;
+}
+
+
+bool ModuleCatalog::load(const char *path) {
+	clear();
+
+	SWBuf buf;
+	if (!FileMgr::existsFile(path) || !readFile(path, buf) || buf.size() < 8 || memcmp(buf.c_str(), MAGIC, 4)) return false;
+
+	Reader in(buf.c_str() + 4, buf.size() - 4);
+	if (in.getU32() != VERSION) return false;
+	SW_u32 count = in.getU32();
+	for (SW_u32 i = 0; in.ok && i < count; ++i) {
+		Entry entry;
+		entry.name = in.getStr();
+		entry.confFile = in.getStr();
+		entry.confHash = in.getStr();
+		entry.version = in.getStr();
+		entry.category = in.getStr();
+		entry.lang = in.getStr();
+		entry.features = in.getStr();
+		entry.installSize = in.getU32();
+		SW_u32 flags = in.getU32();
+		entry.ciphered = (flags & CIPHERED);
+		entry.keyPresent = (flags & KEYPRESENT);
+		// a catalog names only .conf files of the mods.d beside it
+		if (!entry.confFile.length() || strchr(entry.confFile, '/') || strchr(entry.confFile, '\\')) in.ok = false;
+		if (in.ok) entries[entry.name] = entry;
+	}
+	if (!in.ok) {
+		clear();
+		return false;
+	}
+	return true;
+}
+
+
+signed char ModuleCatalog::save(const char *path) const {
+	SWBuf out;
+	out.append(MAGIC);
+	putU32(out, VERSION);
+	putU32(out, (SW_u32)entries.size());
+	for (EntryMap::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+		const Entry &entry = it->second;
+		putStr(out, entry.name);
+		putStr(out, entry.confFile);
+		putStr(out, entry.confHash);
+		putStr(out, entry.version);
+		putStr(out, entry.category);
+		putStr(out, entry.lang);
+		putStr(out, entry.features);
+		putU32(out, (SW_u32)entry.installSize);
+		putU32(out, (entry.ciphered ? CIPHERED : 0) | (entry.keyPresent ? KEYPRESENT : 0));
+	}
+
+	// write aside and move into place so a reader never sees half a catalog
+	SWBuf tmpPath = SWBuf(path) + ".tmp";
+	FileMgr::createParent(tmpPath);
+	int fd = FileMgr::openFile(tmpPath, FileMgr::CREAT|FileMgr::WRONLY|FileMgr::TRUNC, FileMgr::IREAD|FileMgr::IWRITE);
+	if (fd < 0) return -1;
+	long written = FileMgr::write(fd, out.c_str(), out.length());
+	FileMgr::closeFile(fd);
+	if (written != (long)out.length()) {
+		FileMgr::removeFile(tmpPath);
+		return -1;
+	}
+	FileMgr::removeFile(path);
+	if (rename(tmpPath, path)) {
+		FileMgr::removeFile(tmpPath);
+		return -1;
+	}
+	return 0;
+}
+
+
+SWORD_NAMESPACE_END
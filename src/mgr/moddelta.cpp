@@ -0,0 +1,407 @@
+/******************************************************************************
+ *
+ *  moddelta.cpp -	class ModuleDelta: block checksums of a module's data
+ *			files, and updates which fetch only the changed blocks
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <moddelta.h>
+#include <remotetrans.h>
+#include <swconfig.h>
+#include <filemgr.h>
+#include <sysdata.h>
+#include <swlog.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+using std::vector;
+using std::map;
+
+
+SWORD_NAMESPACE_START
+
+
+const char *ModuleDelta::MANIFEST = "delta.conf";
+const unsigned long ModuleDelta::DEFAULT_CHUNK_SIZE = 65536;
+
+
+namespace {
+
+	struct Block {
+		unsigned long offset;
+		unsigned long length;
+		SWBuf hash;
+	};
+
+
+	// 64-bit FNV-1a, as text
+	SWBuf hashOf(const char *data, unsigned long length) {
+		SW_u64 hash = 0xcbf29ce484222325ULL;
+		const unsigned char *c = (const unsigned char *)data;
+		for (const unsigned char *end = c + length; c < end; ++c) {
+			hash ^= *c;
+			hash *= 0x100000001b3ULL;
+		}
+		SWBuf text;
+		text.setFormatted("%08x%08x", (SW_u32)(hash >> 32), (SW_u32)hash);
+		return text;
+	}
+
+
+	SWBuf trimmed(const char *path) {
+		SWBuf retVal = path;
+		while (retVal.size() > 1 && (retVal.endsWith("/") || retVal.endsWith("\\"))) retVal.size(retVal.size() - 1);
+		return retVal;
+	}
+
+
+	bool readFile(const char *path, SWBuf &buf) {
+		buf.size(0);
+		if (!FileMgr::existsFile(path)) return false;
+		FileDesc *fd = FileMgr::getSystemFileMgr()->open(path, FileMgr::RDONLY);
+		if (!fd || fd->getFd() < 0) {
+			FileMgr::getSystemFileMgr()->close(fd);
+			return false;
+		}
+		long size = fd->seek(0, SEEK_END);
+		fd->seek(0, SEEK_SET);
+		buf.setSize(size > 0 ? size : 0);
+		long got = (size > 0) ? fd->read(buf.getRawData(), size) : 0;
+		FileMgr::getSystemFileMgr()->close(fd);
+		if (got != size) {
+			buf.size(0);
+			return false;
+		}
+		return true;
+	}
+
+
+	bool writeFile(const char *path, const SWBuf &buf) {
+		FileMgr::removeFile(path);
+		int fd = FileMgr::createPathAndFile(path);
+		if (fd < 1) return false;
+		long written = buf.size() ? FileMgr::write(fd, buf.c_str(), buf.size()) : 0;
+		FileMgr::closeFile(fd);
+		return written == (long)buf.size();
+	}
+
+
+	// the index a data file's blocks are listed in, and the size of its
+	// records, each of which begins with the 32 bit start and size of one:
+	// ot.bzs for ot.bzz (zverse), dict.zdx for dict.zdt (zstr)
+	SWBuf getIndexName(const SWBuf &name, int &recordSize) {
+		SWBuf index;
+		recordSize = 0;
+		if (name.size() > 4 && name[name.size() - 4] == '.' && name.endsWith("zz")) {
+			index = name;
+			index[index.size() - 1] = 's';
+			recordSize = 12;
+		}
+		else if (name.endsWith(".zdt")) {
+			index = name;
+			index.size(index.size() - 1);
+			index += 'x';
+			recordSize = 8;
+		}
+		return index;
+	}
+
+
+	// cuts the data of file name in dir into blocks: where the blocks of
+	// its index begin and end, or every chunkSize bytes if it hasn't one
+	void cutFile(const SWBuf &dir, const SWBuf &name, const SWBuf &data, unsigned long chunkSize, vector<Block> &blocks, SWBuf *cutBy = 0) {
+		unsigned long size = data.size();
+		vector<unsigned long> cuts;
+		cuts.push_back(0);
+		cuts.push_back(size);
+
+		int recordSize;
+		SWBuf indexName = getIndexName(name, recordSize);
+		SWBuf index;
+		if (recordSize && readFile(dir + "/" + indexName, index)) {
+			for (unsigned long r = 0; r + recordSize <= index.size(); r += recordSize) {
+				SW_u32 start, length;
+				memcpy(&start, index.c_str() + r, 4);
+				memcpy(&length, index.c_str() + r + 4, 4);
+				start = swordtoarch32(start);
+				length = swordtoarch32(length);
+				if (start < size) cuts.push_back(start);
+				if ((unsigned long)start + length < size) cuts.push_back((unsigned long)start + length);
+			}
+			if (cutBy) cutBy->setFormatted("%s %d", indexName.c_str(), recordSize);
+		}
+		else {
+			for (unsigned long offset = chunkSize; offset < size; offset += chunkSize) {
+				cuts.push_back(offset);
+			}
+		}
+		std::sort(cuts.begin(), cuts.end());
+		cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+		blocks.clear();
+		for (unsigned int i = 0; i + 1 < cuts.size(); ++i) {
+			Block block;
+			block.offset = cuts[i];
+			block.length = cuts[i + 1] - cuts[i];
+			block.hash = hashOf(data.c_str() + block.offset, block.length);
+			blocks.push_back(block);
+		}
+	}
+
+
+	// a file to be brought up to date, as the manifest has it
+	struct FilePlan {
+		SWBuf name;
+		unsigned long size;
+		SWBuf hash;
+		vector<Block> blocks;
+		// where the installed copy of the file holds each block we have
+		map<SWBuf, Block> local;
+		bool unchanged;
+		unsigned long missing;
+	};
+
+
+	// where in local, the installed copy of the file, we have block; or 0
+	const Block *findLocal(const FilePlan &plan, const SWBuf &local, const Block &block) {
+		map<SWBuf, Block>::const_iterator have = plan.local.find(block.hash);
+		if (have == plan.local.end() || have->second.length != block.length || have->second.offset + block.length > local.size()) return 0;
+		return &have->second;
+	}
+
+
+	bool readPlan(ConfigEntMap &section, FilePlan &plan) {
+		plan.size = atol(section["Size"]);
+		plan.hash = section["Hash"];
+		plan.unchanged = false;
+		plan.missing = 0;
+		unsigned long end = 0;
+		ConfigEntMap::iterator it = section.lower_bound("Block");
+		ConfigEntMap::iterator last = section.upper_bound("Block");
+		for (; it != last; ++it) {
+			Block block;
+			char hash[32];
+			if (sscanf(it->second.c_str(), "%lu %lu %31s", &block.offset, &block.length, hash) != 3) return false;
+			block.hash = hash;
+			// the blocks must cover the file, in order
+			if (block.offset != end) return false;
+			end += block.length;
+			plan.blocks.push_back(block);
+		}
+		return (end == plan.size);
+	}
+
+
+	void moveDirectories(const SWBuf &from, const SWBuf &to, const vector<SWBuf> &names) {
+		for (unsigned int i = 0; i < names.size(); ++i) {
+			rename(from + "/" + names[i], to + "/" + names[i]);
+		}
+	}
+
+
+	// the directories SWModule::createSearchFramework() builds
+	bool isSearchFramework(const SWBuf &name) {
+		return name == "lucene" || name == "xapian";
+	}
+}
+
+
+signed char ModuleDelta::createManifest(const char *dataPath, unsigned long chunkSize) {
+	if (!chunkSize) chunkSize = DEFAULT_CHUNK_SIZE;
+	SWBuf dir = trimmed(dataPath);
+	if (!FileMgr::existsDir(dir)) return -1;
+
+	SWBuf manifestPath = dir + "/" + MANIFEST;
+	FileMgr::removeFile(manifestPath);
+	SWConfig manifest(manifestPath);
+	manifest.setValue("Delta", "Version", "1");
+	manifest.setValue("Delta", "ChunkSize", SWBuf().appendFormatted("%lu", chunkSize));
+
+	vector<DirEntry> entries = FileMgr::getDirList(dir);
+	for (unsigned int i = 0; i < entries.size(); ++i) {
+		if (entries[i].isDirectory || entries[i].name == MANIFEST) continue;
+		SWBuf data;
+		if (!readFile(dir + "/" + entries[i].name, data)) return -1;
+
+		vector<Block> blocks;
+		SWBuf cutBy;
+		cutFile(dir, entries[i].name, data, chunkSize, blocks, &cutBy);
+
+		ConfigEntMap &section = manifest[entries[i].name];
+		section["Size"] = SWBuf().appendFormatted("%lu", (unsigned long)data.size());
+		section["Hash"] = hashOf(data.c_str(), data.size());
+		if (cutBy.size()) section["CutBy"] = cutBy;
+		for (unsigned int b = 0; b < blocks.size(); ++b) {
+			section.insert(ConfigEntMap::value_type("Block", SWBuf().appendFormatted("%lu %lu %s", blocks[b].offset, blocks[b].length, blocks[b].hash.c_str())));
+		}
+	}
+	manifest.save();
+	return FileMgr::existsFile(manifestPath) ? 0 : -1;
+}
+
+
+signed char ModuleDelta::update(RemoteTransport *transport, const char *dataURL, const char *manifestPath, const char *installedPath, unsigned long *fetchedBytes) {
+	if (fetchedBytes) *fetchedBytes = 0;
+	SWBuf installed = trimmed(installedPath);
+	if (!FileMgr::existsFile(manifestPath) || !FileMgr::existsDir(installed)) return -1;
+
+	SWConfig manifest(manifestPath);
+	if (manifest["Delta"]["Version"] != "1") return -1;
+	unsigned long chunkSize = atol(manifest["Delta"]["ChunkSize"]);
+	if (!chunkSize) chunkSize = DEFAULT_CHUNK_SIZE;
+
+	SWBuf url = dataURL;
+	if (!url.endsWith("/")) url += "/";
+
+	// what we have of each file, and so what must be fetched
+	vector<FilePlan> plans;
+	unsigned long totalBytes = 0;
+	for (SectionMap::iterator it = manifest.getSections().begin(); it != manifest.getSections().end(); ++it) {
+		// all but our own section, and SWConfig's record of comments and order
+		if (it->first == "Delta" || it->first.startsWith("_Conf")) continue;
+		if (strchr(it->first, '/') || strchr(it->first, '\\') || it->first == "." || it->first == "..") return -1;
+		plans.push_back(FilePlan());
+		FilePlan &plan = plans.back();
+		plan.name = it->first;
+		if (!readPlan(it->second, plan)) {
+			SWLog::getSystemLog()->logWarning("ModuleDelta: bad manifest entry for %s\n", plan.name.c_str());
+			return -1;
+		}
+
+		SWBuf data;
+		if (readFile(installed + "/" + plan.name, data)) {
+			plan.unchanged = (data.size() == plan.size && hashOf(data.c_str(), data.size()) == plan.hash);
+			if (!plan.unchanged) {
+				vector<Block> blocks;
+				cutFile(installed, plan.name, data, chunkSize, blocks);
+				for (unsigned int b = 0; b < blocks.size(); ++b) {
+					plan.local[blocks[b].hash] = blocks[b];
+				}
+			}
+		}
+		if (!plan.unchanged) {
+			for (unsigned int b = 0; b < plan.blocks.size(); ++b) {
+				if (!findLocal(plan, data, plan.blocks[b])) plan.missing += plan.blocks[b].length;
+			}
+		}
+		totalBytes += plan.missing;
+	}
+
+	// progress is told of the whole update, not of each range fetched
+	StatusReporter *statusReporter = transport->getStatusReporter();
+	transport->setStatusReporter(0);
+
+	SWBuf staging = installed + ".delta";
+	FileMgr::removeDir(staging);
+	signed char retVal = (FileMgr::copyFile(manifestPath, staging + "/" + MANIFEST)) ? -1 : 0;
+	unsigned long completedBytes = 0;
+	for (unsigned int i = 0; i < plans.size() && !retVal; ++i) {
+		FilePlan &plan = plans[i];
+		SWBuf localPath = installed + "/" + plan.name;
+		SWBuf stagedPath = staging + "/" + plan.name;
+		if (plan.unchanged) {
+			if (FileMgr::copyFile(localPath, stagedPath)) retVal = -1;
+			continue;
+		}
+		if (statusReporter && plan.missing) {
+			SWBuf message;
+			message.setFormatted("Updating %s...", plan.name.c_str());
+			statusReporter->preStatus(totalBytes, completedBytes, message);
+		}
+SWLOGD("ModuleDelta: %s: fetching %lu of %lu bytes", plan.name.c_str(), plan.missing, plan.size);
+
+		SWBuf local;
+		if (plan.local.size()) readFile(localPath, local);
+		SWBuf data;
+		data.setSize(plan.size);
+		SWBuf range;
+		for (unsigned int b = 0; b < plan.blocks.size() && !retVal; ) {
+			const Block &block = plan.blocks[b];
+			const Block *have = findLocal(plan, local, block);
+			if (have) {
+				memcpy(data.getRawData() + block.offset, local.c_str() + have->offset, block.length);
+				++b;
+				continue;
+			}
+			// fetch this and the missing blocks which follow it, at once
+			unsigned long length = 0;
+			unsigned int next = b;
+			for (; next < plan.blocks.size() && !findLocal(plan, local, plan.blocks[next]); ++next) {
+				length += plan.blocks[next].length;
+			}
+			retVal = transport->getURLRange(url + plan.name, (long)block.offset, (long)length, &range);
+			if (!retVal) {
+				memcpy(data.getRawData() + block.offset, range.c_str(), length);
+				completedBytes += length;
+				if (statusReporter) statusReporter->update(totalBytes, completedBytes);
+			}
+			else if (transport->isTerminated()) retVal = -3;
+			b = next;
+		}
+		if (retVal) break;
+
+		if (hashOf(data.c_str(), data.size()) != plan.hash) {
+			SWLog::getSystemLog()->logWarning("ModuleDelta: %s doesn't match the manifest\n", plan.name.c_str());
+			retVal = -1;
+		}
+		else if (!writeFile(stagedPath, data)) retVal = -1;
+	}
+	transport->setStatusReporter(statusReporter);
+	if (fetchedBytes) *fetchedBytes = completedBytes;
+
+	if (retVal) {
+		FileMgr::removeDir(staging);
+		return retVal;
+	}
+
+	// other directories in the installed one go along with the files, but
+	// not a search framework: it indexes the old text.  It goes away with
+	// the old files, as do the entry attribute index and search journal,
+	// so the module reads as having no framework until one is built again
+	vector<SWBuf> directories;
+	vector<DirEntry> entries = FileMgr::getDirList(installed);
+	for (unsigned int i = 0; i < entries.size(); ++i) {
+		if (entries[i].isDirectory && !isSearchFramework(entries[i].name)) directories.push_back(entries[i].name);
+	}
+	moveDirectories(installed, staging, directories);
+
+	SWBuf old = installed + ".old";
+	FileMgr::removeDir(old);
+	if (rename(installed, old)) {
+		moveDirectories(staging, installed, directories);
+		FileMgr::removeDir(staging);
+		return -1;
+	}
+	if (rename(staging, installed)) {
+		rename(old, installed);
+		moveDirectories(staging, installed, directories);
+		FileMgr::removeDir(staging);
+		return -1;
+	}
+	FileMgr::removeDir(old);
+	return 0;
+}
+
+
+SWORD_NAMESPACE_END
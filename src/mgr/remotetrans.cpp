@@ -22,7 +22,9 @@
 
 #include <remotetrans.h>
 #include <filemgr.h>
+#include <swthread.h>
 
+#include <stdio.h>
 #include <fcntl.h>
 #include <dirent.h>
 #include <swlog.h>
@@ -41,6 +43,29 @@ SWORD_NAMESPACE_START
 
 namespace {
 
+	// transfers run on a pool's threads, so this and writeValidator() keep
+	// to FileMgr's static calls, which don't touch its shared file list
+	bool readValidator(const char *path, SWBuf &validator) {
+		validator = "";
+		int fd = FileMgr::openFileReadOnly(path);
+		if (fd < 0) return false;
+		char buf[256];
+		long got;
+		while ((got = FileMgr::read(fd, buf, sizeof(buf))) > 0) validator.append(buf, got);
+		FileMgr::closeFile(fd);
+		validator.trim();
+		return validator.length() > 0;
+	}
+
+
+	void writeValidator(const char *path, const SWBuf &validator) {
+		int fd = FileMgr::createPathAndFile(path);
+		if (fd < 1) return;
+		FileMgr::write(fd, validator.c_str(), validator.length());
+		FileMgr::closeFile(fd);
+	}
+
+
 	void removeTrailingSlash(SWBuf &buf) {
 		int len = buf.size();
 		if ((buf[len-1] == '/')
@@ -48,7 +73,228 @@ namespace {
 			buf.size(len-1);
 	}
 
-};
+
+	// one thing for a transfer pool to do: fetch url into destPath, or,
+	// with no destPath, list the directory at url
+	struct Transfer {
+		SWBuf url;
+		SWBuf destPath;
+		SWBuf name;
+		unsigned long size;
+		vector<struct DirEntry> listing;
+		char retVal;
+
+		Transfer(const SWBuf &url, const SWBuf &destPath = "", const SWBuf &name = "", unsigned long size = 0)
+			: url(url), destPath(destPath), name(name), size(size), retVal(0) {}
+	};
+
+
+	// what the threads of a transfer pool share; everything below lock
+	// is only touched while holding it
+	struct TransferPool {
+		vector<Transfer> *transfers;
+		RemoteTransport *primary;
+
+		// when set, the workers report progress themselves, as the pool
+		// is being run on the calling thread
+		StatusReporter *statusReporter;
+		unsigned long totalBytes;
+
+		SWMutex lock;
+		unsigned int next;
+		unsigned int finished;
+		bool failed;
+		unsigned long completedBytes;		// of the files finished
+		vector<unsigned long> inFlight;		// so far of each worker's current file
+		vector<unsigned int> started;		// files begun and not yet announced
+
+		unsigned long progress() const {
+			unsigned long bytes = completedBytes;
+			for (unsigned int i = 0; i < inFlight.size(); i++) bytes += inFlight[i];
+			return (bytes < totalBytes) ? bytes : totalBytes;
+		}
+	};
+
+
+	// takes the progress of one worker's current file into the pool's
+	class PoolStatusReporter : public StatusReporter {
+	public:
+		TransferPool *pool;
+		unsigned int worker;
+
+		virtual void update(unsigned long totalBytes, unsigned long completedBytes) {
+			unsigned long progress;
+			{
+				SWMutex::Locker locker(pool->lock);
+				pool->inFlight[worker] = completedBytes;
+				progress = pool->progress();
+			}
+			if (pool->statusReporter && pool->totalBytes) pool->statusReporter->update(pool->totalBytes, progress);
+		}
+	};
+
+
+	struct Worker {
+		TransferPool *pool;
+		RemoteTransport *transport;
+		PoolStatusReporter statusReporter;
+		SWThread thread;
+	};
+
+
+	SWBuf downloadingMessage(const vector<Transfer> &transfers, unsigned int i) {
+		SWBuf message;
+		message.setFormatted("Downloading (%d of %d): ", i + 1, (int)transfers.size());
+		message += transfers[i].name;
+		return message;
+	}
+
+
+	void runWorker(void *userData) {
+		Worker *worker = (Worker *)userData;
+		TransferPool *pool = worker->pool;
+		for (;;) {
+			unsigned int i;
+			{
+				SWMutex::Locker locker(pool->lock);
+				if (pool->failed || pool->primary->isTerminated() || pool->next == pool->transfers->size()) break;
+				i = pool->next++;
+				pool->started.push_back(i);
+			}
+			Transfer &transfer = (*pool->transfers)[i];
+			if (transfer.destPath.length()) {
+				if (pool->statusReporter) {
+					pool->statusReporter->preStatus(pool->totalBytes, pool->progress(), downloadingMessage(*pool->transfers, i));
+				}
+				FileMgr::createParent(transfer.destPath);	// make sure parent directory exists
+				SWTRY {
+					transfer.retVal = worker->transport->downloadFile(transfer.destPath, transfer.url);
+				}
+				SWCATCH (...) {
+					transfer.retVal = -1;
+				}
+				if (transfer.retVal) {
+					SWLog::getSystemLog()->logWarning("copyDirectory: failed to get file %s\n", transfer.url.c_str());
+				}
+			}
+			else {
+				transfer.listing = worker->transport->getDirList(transfer.url);
+			}
+
+			SWMutex::Locker locker(pool->lock);
+			pool->inFlight[worker->statusReporter.worker] = 0;
+			pool->completedBytes += transfer.size;
+			pool->finished++;
+			if (transfer.retVal) pool->failed = true;
+		}
+	}
+
+
+	// Runs transfers on up to getMaxTransfers() transports at once: primary
+	// and those in pool, which clones of primary are added to as needed.
+	// primary's StatusReporter hears of it all, on this thread.
+	int runTransfers(RemoteTransport *primary, vector<RemoteTransport *> &pool, vector<Transfer> &transfers, unsigned long totalBytes) {
+		if (!transfers.size()) return (primary->isTerminated()) ? -3 : 0;
+
+		unsigned int workerCount = (unsigned int)primary->getMaxTransfers();
+		if (workerCount > transfers.size()) workerCount = (unsigned int)transfers.size();
+		while (pool.size() + 1 < workerCount) {
+			RemoteTransport *helper = primary->clone();
+			if (!helper) break;
+			pool.push_back(helper);
+		}
+		if (workerCount > pool.size() + 1) workerCount = (unsigned int)pool.size() + 1;
+
+		StatusReporter *statusReporter = primary->getStatusReporter();
+		TransferPool shared;
+		shared.transfers = &transfers;
+		shared.primary = primary;
+		shared.statusReporter = 0;
+		shared.totalBytes = totalBytes;
+		shared.next = 0;
+		shared.finished = 0;
+		shared.failed = false;
+		shared.completedBytes = 0;
+		shared.inFlight.resize(workerCount, 0);
+
+		Worker *workers = new Worker[workerCount];
+		for (unsigned int i = 0; i < workerCount; i++) {
+			workers[i].pool = &shared;
+			workers[i].transport = (i) ? pool[i-1] : primary;
+			workers[i].statusReporter.pool = &shared;
+			workers[i].statusReporter.worker = i;
+			workers[i].transport->setStatusReporter(&workers[i].statusReporter);
+		}
+
+		unsigned int running = 0;
+		if (workerCount > 1) {
+			for (unsigned int i = 0; i < workerCount; i++) {
+				if (workers[i].thread.start(runWorker, &workers[i])) running++;
+			}
+		}
+
+		if (!running) {
+			// one at a time, right here
+			shared.statusReporter = statusReporter;
+			runWorker(&workers[0]);
+		}
+		else {
+			// pass on what the workers are up to until they are through
+			unsigned long reported = 0;
+			for (;;) {
+				vector<unsigned int> started;
+				unsigned long progress;
+				bool done;
+				{
+					SWMutex::Locker locker(shared.lock);
+					started.swap(shared.started);
+					progress = shared.progress();
+					done = (shared.finished == shared.next)
+						&& (shared.failed || primary->isTerminated() || shared.next == transfers.size());
+				}
+				if (statusReporter) {
+					for (unsigned int i = 0; i < started.size(); i++) {
+						if (transfers[started[i]].destPath.length()) {
+							statusReporter->preStatus(totalBytes, progress, downloadingMessage(transfers, started[i]));
+						}
+					}
+					if (totalBytes && progress != reported) {
+						statusReporter->update(totalBytes, progress);
+						reported = progress;
+					}
+				}
+				if (primary->isTerminated()) {
+					for (unsigned int i = 1; i < workerCount; i++) {
+						workers[i].transport->terminate();
+					}
+				}
+				if (done) break;
+				SWThread::sleep(20);
+			}
+			for (unsigned int i = 0; i < workerCount; i++) {
+				workers[i].thread.join();
+			}
+		}
+
+		for (unsigned int i = 0; i < workerCount; i++) {
+			workers[i].transport->setStatusReporter(statusReporter);
+		}
+		delete [] workers;
+
+		// a helper once told to terminate stays that way, so make new ones next time
+		if (primary->isTerminated()) {
+			for (unsigned int i = 0; i < pool.size(); i++) {
+				delete pool[i];
+			}
+			pool.clear();
+		}
+
+		for (unsigned int i = 0; i < transfers.size(); i++) {
+			if (transfers[i].retVal) return transfers[i].retVal;
+		}
+		return (primary->isTerminated()) ? -3 : 0;
+	}
+}
 
 
 void StatusReporter::preStatus(long totalBytes, long completedBytes, const char *message) {
@@ -66,11 +312,27 @@ RemoteTransport::RemoteTransport(const char *host, StatusReporter *statusReporte
 	p = "installmgr@user.com";
 	term = false;
 	passive = true;
+	timeoutMillis = 10000;
 	unverifiedPeerAllowed = true;
+	maxTransfers = 4;
 }
 
 
 RemoteTransport::~RemoteTransport() {
+	for (unsigned int i = 0; i < pool.size(); i++) {
+		delete pool[i];
+	}
+}
+
+
+void RemoteTransport::copySettingsTo(RemoteTransport *other) const {
+	other->statusReporter = statusReporter;
+	other->passive = passive;
+	other->timeoutMillis = timeoutMillis;
+	other->unverifiedPeerAllowed = unverifiedPeerAllowed;
+	other->maxTransfers = maxTransfers;
+	other->u = u;
+	other->p = p;
 }
 
 
@@ -89,6 +351,75 @@ char RemoteTransport::putURL(const char *destURL, const char *sourcePath, SWBuf
 }
 
 
+// override this method in your real transport class, if it can resume
+char RemoteTransport::resumeURL(const char *destPath, const char *sourceURL, long offset, const char *validator) {
+	FileMgr::removeFile(destPath);
+	return getURL(destPath, sourceURL);
+}
+
+
+// override this method in your real transport class, if it can fetch ranges
+char RemoteTransport::getURLRange(const char *sourceURL, long offset, long length, SWBuf *destBuf) {
+	destBuf->size(0);
+	char retVal = getURL("", sourceURL, destBuf);
+	if (retVal) return retVal;
+	if (offset < 0 || length < 0 || (long)destBuf->size() < offset + length) return -1;
+	memmove(destBuf->getRawData(), destBuf->getRawData() + offset, length);
+	destBuf->size(length);
+	return 0;
+}
+
+
+// override this method in your real transport class, if it can be copied
+RemoteTransport *RemoteTransport::clone() const {
+	return 0;
+}
+
+
+char RemoteTransport::downloadFile(const char *destPath, const char *sourceURL) {
+	SWBuf partPath = SWBuf(destPath) + ".part";
+	SWBuf validatorPath = partPath + ".validator";
+	long partSize = FileMgr::existsFile(partPath) ? FileMgr::getFileSize(partPath) : 0;
+	SWBuf partValidator;
+	// without a validator there's no telling what the part is part of
+	if (partSize > 0 && !readValidator(validatorPath, partValidator)) partSize = 0;
+
+	char retVal = -1;
+	if (partSize > 0) {
+SWLOGD("downloadFile: resuming %s from %ld", sourceURL, partSize);
+		retVal = resumeURL(partPath, sourceURL, partSize, partValidator);
+		// the server couldn't pick up where we left off, or the file has
+		// changed since; start again
+		if (retVal && !term) partSize = 0;
+	}
+	if (partSize <= 0) {
+		// the part file is written over in place, not truncated
+		FileMgr::removeFile(partPath);
+		FileMgr::removeFile(validatorPath);
+		validator = "";
+		retVal = getURL(partPath, sourceURL);
+		if (retVal && validator.length() && FileMgr::existsFile(partPath)) {
+			writeValidator(validatorPath, validator);
+		}
+	}
+	if (retVal) return retVal;
+
+	FileMgr::removeFile(validatorPath);
+	FileMgr::removeFile(destPath);
+	// an empty file is never written, so there may be no part to move
+	if (!FileMgr::existsFile(partPath)) {
+		int fd = FileMgr::createPathAndFile(destPath);
+		if (fd < 1) return -1;
+		FileMgr::closeFile(fd);
+	}
+	else if (rename(partPath, destPath)) {
+		SWLog::getSystemLog()->logWarning("downloadFile: couldn't move %s into place\n", partPath.c_str());
+		return -1;
+	}
+	return 0;
+}
+
+
 vector<struct DirEntry> RemoteTransport::getDirList(const char *dirURL) {
 
 SWLOGD("RemoteTransport::getDirList(%s)", dirURL);
@@ -134,17 +465,12 @@ SWLOGD("getDirList: got item %s\n", name.c_str());
 }
 
 
-/** network copy recursively a remote directly
- * @return error status 0: OK; -1: operation error, -2: connection error; -3: user requested termination
- */
 int RemoteTransport::copyDirectory(const char *urlPrefix, const char *dir, const char *dest, const char *suffix) {
 SWLOGD("RemoteTransport::copyDirectory");
-	int retVal = 0;
-
 	SWBuf url = SWBuf(urlPrefix) + SWBuf(dir);
 	removeTrailingSlash(url);
 	url += '/';
-	
+
 SWLOGD("NetTransport: getting dir %s\n", url.c_str());
 	vector<struct DirEntry> dirList = getDirList(url.c_str());
 
@@ -153,67 +479,46 @@ SWLOGD("NetTransport: getting dir %s\n", url.c_str());
 		return -1;
 	}
 
-	// append files in sub directories and calculate total download size
-	unsigned int i = 0;
-	long totalBytes = 0;
-	for (;;) {
-		if (i == dirList.size())
-			break;
+	// list sub directories a level at a time, all those of a level at once
+	vector<struct DirEntry> files;
+	while (dirList.size()) {
+		vector<Transfer> listings;
+		for (unsigned int i = 0; i < dirList.size(); i++) {
+			if (dirList[i].isDirectory) {
+				SWBuf name = dirList[i].name;
+				removeTrailingSlash(name);
+				listings.push_back(Transfer(url + name + '/', "", name));
+			}
+			else files.push_back(dirList[i]);
+		}
+		dirList.clear();
 
-		struct DirEntry &e = dirList.at(i);
+		int retVal = runTransfers(this, pool, listings, 0);
+		if (retVal) return retVal;
 
-		if (e.isDirectory) {
-			SWBuf name(e.name); // &e will be invalidated after first insertion
-			vector<struct DirEntry> sd = getDirList((url + name + '/').c_str());
-			for (unsigned int ii = 0; ii < sd.size(); ii++) {
-				sd[ii].name = name + '/' + sd[ii].name;
-				dirList.push_back(sd[ii]);
+		for (unsigned int i = 0; i < listings.size(); i++) {
+			for (unsigned int j = 0; j < listings[i].listing.size(); j++) {
+				listings[i].listing[j].name = listings[i].name + '/' + listings[i].listing[j].name;
+				dirList.push_back(listings[i].listing[j]);
 			}
-			dirList.erase(dirList.begin() + i);
 		}
-		else {
-			totalBytes += e.size;
-			i++;
-		}
-	}
-
-	long completedBytes = 0;
-	for (i = 0; i < dirList.size(); i++) {
-		struct DirEntry &dirEntry = dirList[i];
-		SWBuf buffer = (SWBuf)dest;
-		removeTrailingSlash(buffer);
-		buffer += "/";
-		buffer += dirEntry.name;
-		if (!strcmp(&buffer.c_str()[buffer.length()-strlen(suffix)], suffix)) {
-			SWBuf buffer2 = "Downloading (";
-			buffer2.appendFormatted("%d", i+1);
-			buffer2 += " of ";
-			buffer2.appendFormatted("%d", dirList.size());
-			buffer2 += "): ";
-			buffer2 += dirEntry.name;
-			if (statusReporter)
-				statusReporter->preStatus(totalBytes, completedBytes, buffer2.c_str());
-			FileMgr::createParent(buffer.c_str());	// make sure parent directory exists
-			SWTRY {
-				SWBuf url = (SWBuf)urlPrefix + (SWBuf)dir;
-				removeTrailingSlash(url);
-				url += "/";
-				url += dirEntry.name;
-				retVal = getURL(buffer.c_str(), url.c_str());
-				if (retVal) {
-					SWLog::getSystemLog()->logWarning("copyDirectory: failed to get file %s\n", url.c_str());
-					return retVal;
-				}
-				completedBytes += dirEntry.size;
-			}
-			SWCATCH (...) {}
-			if (term) {
-				retVal = -3;
-				break;
-			}
+	}
+
+	SWBuf destDir = dest;
+	removeTrailingSlash(destDir);
+	destDir += '/';
+
+	vector<Transfer> downloads;
+	unsigned long totalBytes = 0;
+	for (unsigned int i = 0; i < files.size(); i++) {
+		SWBuf destPath = destDir + files[i].name;
+		if (destPath.endsWith(suffix)) {
+			downloads.push_back(Transfer(url + files[i].name, destPath, files[i].name, files[i].size));
+			totalBytes += files[i].size;
 		}
 	}
-	return retVal;
+
+	return runTransfers(this, pool, downloads, totalBytes);
 }
 
 
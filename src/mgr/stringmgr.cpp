@@ -38,12 +38,10 @@
 
 #include <unicode/locid.h>
 
-#else
+#endif
 
 #include <swtoupperdata.h>
 
-#endif
-
 
 SWORD_NAMESPACE_START
 
@@ -139,6 +137,57 @@ namespace {
 
 		return ret;
 	}
+
+	inline SW_u32 upperUniChar(SW_u32 ch) {
+		return (ch < 0x10000) ? ch + toUpperDelta[toUpperPage[ch >> 8]][ch & 0xff] : ch;
+	}
+
+	// the next codepoint, upper cased; 0 at the end, which isn't passed
+	inline SW_u32 nextUpper(const unsigned char **from) {
+		if (**from < 0x80) {
+			if (!**from) return 0;
+			return upperUniChar(*(*from)++);
+		}
+		SW_u32 ch = getUniCharFromUTF8(from, true);
+		// if ch is bad, then convert to replacement char, as upperUTF8 does
+		return (ch && ch <= 0x10FFFF) ? upperUniChar(ch) : 0xFFFD;
+	}
+
+	// what getUTF8FromUniChar does, into a buffer known to have room
+	inline unsigned char *putUTF8(SW_u32 ch, unsigned char *to) {
+		if (ch > 0x10FFFF) ch = 0xFFFD;
+		if (ch < 0x80) {
+			*to++ = (unsigned char)ch;
+		}
+		else if (ch < 0x800) {
+			*to++ = (unsigned char)(0xc0 | (ch >> 6));
+			*to++ = (unsigned char)(0x80 | (ch & 0x3f));
+		}
+		else if (ch < 0x10000) {
+			*to++ = (unsigned char)(0xe0 | (ch >> 12));
+			*to++ = (unsigned char)(0x80 | ((ch >> 6) & 0x3f));
+			*to++ = (unsigned char)(0x80 | (ch & 0x3f));
+		}
+		else {
+			*to++ = (unsigned char)(0xf0 | (ch >> 18));
+			*to++ = (unsigned char)(0x80 | ((ch >> 12) & 0x3f));
+			*to++ = (unsigned char)(0x80 | ((ch >> 6) & 0x3f));
+			*to++ = (unsigned char)(0x80 | (ch & 0x3f));
+		}
+		return to;
+	}
+
+	inline long utf8Length(SW_u32 ch) {
+		return (ch < 0x80) ? 1 : (ch < 0x800) ? 2 : (ch < 0x10000 || ch > 0x10FFFF) ? 3 : 4;
+	}
+
+	// whether text starts with what's left of an upper cased pattern
+	bool startsWithUpper(const unsigned char *text, const unsigned char *pattern) {
+		while (*pattern) {
+			if (nextUpper(&text) != nextUpper(&pattern)) return false;
+		}
+		return true;
+	}
 }
 
 
@@ -214,7 +263,8 @@ StringMgr* StringMgr::getSystemStringMgr() {
  * If UTF8 support is desired, then a UTF8 StringMgr needs
  * to be used.
  *
- * Here we just do our best.
+ * Here we just do our best: each codepoint is upper cased by the tables
+ * in swtoupperdata.h, in place, unless it would then take more bytes.
  *
  * Converts the param to an upper case UTF8 string
  * @param t - The text encoded in utf8 which should be turned into an upper case string
@@ -222,49 +272,49 @@ StringMgr* StringMgr::getSystemStringMgr() {
  */	
 char *StringMgr::upperUTF8(char *t, unsigned int maxlen) const {
 
-#ifndef _ICU_
+	const short *asciiDelta = toUpperDelta[toUpperPage[0]];
+	const unsigned char *from = (const unsigned char *)t;
+	unsigned char *to = (unsigned char *)t;
 
-	SWBuf orig = t;
-	const unsigned char* from = (unsigned char*)orig.c_str();
-	SWBuf text = "";
-	std::map<SW_u32, SW_u32>::const_iterator it = toUpperData.end();
-	while (*from) {		
+	// in place, for as long as nothing upper cases to more bytes than it was
+	while (*from) {
+		if (*from < 0x80) {
+			*to++ = (unsigned char)(*from + asciiDelta[*from]);
+			from++;
+			continue;
+		}
+		const unsigned char *start = from;
 		SW_u32 ch = getUniCharFromUTF8(&from, true);
 		// should we skip conversion if we run into an invalid UTF8 character?
 		// maybe the string isn't intended to be UTF8
 		// Right now, if ch is bad, then convert to replacement char
 		if (!ch) ch = 0xFFFD;
-
-		it = toUpperData.find(ch);
-		getUTF8FromUniChar(it == toUpperData.end() ? ch : it->second, &text);
-	}
-	long len = maxlen ? (text.size() < maxlen ? text.size() : (maxlen - 1)) : text.size();
-	if (len) memcpy(t, text.c_str(), len);
-	t[len] = 0;
-#endif
-	return t;
-/* OLD
-	// try to decide if it's worth trying to toupper.  Do we have more
-	// characters which are probably lower latin than not?
-	// we still don't use isValidUTF8 optimally. what if we have 1 unicode
-	// character in the string?  should we not try to upper any of the string?
-	// dunno.  Best solution is to upper all other characters. Don't have
-	// time to write that before release.
-
-	long performOp = 0;
-	if (!isValidUTF8((unsigned char *)t)) {
-		performOp = 1;
-	}
-	else {
-		for (const char *ch = t; *ch; ch++) {
-			performOp += (*ch > 0) ? 1 : -1;
+		ch = upperUniChar(ch);
+		if (utf8Length(ch) > from - start) {
+			from = start;
+			break;
 		}
+		to = putUTF8(ch, to);
 	}
-
-	if (performOp > 0) {
-		return upperLatin1(t);
+	long len = (long)(to - (unsigned char *)t);
+
+	// and the rest, which grows, through a copy
+	if (*from) {
+		SWBuf text;
+		while (*from) {
+			SW_u32 ch = getUniCharFromUTF8(&from, true);
+			if (!ch) ch = 0xFFFD;
+			getUTF8FromUniChar(upperUniChar(ch), &text);
+		}
+		long rest = (long)text.size();
+		if (maxlen && len + rest > (long)maxlen - 1) rest = (long)maxlen - 1 - len;
+		if (rest > 0) {
+			memcpy(to, text.c_str(), rest);
+			len += rest;
+		}
 	}
-*/
+	if (maxlen && len > (long)maxlen - 1) len = (long)maxlen - 1;
+	t[len] = 0;
 
 	return t;
 }
@@ -344,6 +394,32 @@ bool StringMgr::supportsUnicode() const {
 }
 
 
+int stricmpUTF8(const char *s1, const char *s2) {
+	const unsigned char *from1 = (const unsigned char *)s1;
+	const unsigned char *from2 = (const unsigned char *)s2;
+	for (;;) {
+		SW_u32 ch1 = nextUpper(&from1);
+		SW_u32 ch2 = nextUpper(&from2);
+		if (ch1 != ch2) return (ch1 < ch2) ? -1 : 1;
+		if (!ch1) return 0;
+	}
+}
+
+
+const char *stristrUTF8(const char *s1, const char *s2) {
+	const unsigned char *pattern = (const unsigned char *)s2;
+	SW_u32 first = nextUpper(&pattern);
+	if (!first) return s1;
+
+	const unsigned char *from = (const unsigned char *)s1;
+	while (*from) {
+		const unsigned char *start = from;
+		if (nextUpper(&from) == first && startsWithUpper(from, pattern)) return (const char *)start;
+	}
+	return 0;
+}
+
+
 #ifdef _ICU_
 
 char *ICUStringMgr::upperUTF8(char *buf, unsigned int maxlen) const {
@@ -27,6 +27,7 @@
 #include <swconfig.h>
 #include <versekey.h>
 #include <versificationmgr.h>
+#include <swthread.h>
 
 
 SWORD_NAMESPACE_START
@@ -45,6 +46,9 @@ class SWLocale::Private {
 public:
 	LookupMap lookupTable;
 	LookupMap mergedAbbrevs;
+
+	/** guards the tables, which are filled in as they are asked for */
+	SWMutex lock;
 };
 
 
@@ -104,6 +108,7 @@ SWLocale::~SWLocale() {
 
 
 const char *SWLocale::translate(const char *text) {
+	SWMutex::Locker locker(p->lock);
 	LookupMap::iterator entry;
 
 	entry = p->lookupTable.find(text);
@@ -171,12 +176,14 @@ const char *SWLocale::getEncoding() {
 
 
 void SWLocale::augment(SWLocale &addFrom) {
+	SWMutex::Locker locker(p->lock);
 	*localeSource += *addFrom.localeSource;
 }
 
 
 const struct abbrev *SWLocale::getBookAbbrevs(int *retSize) {
 	static const char *nullstr = "";
+	SWMutex::Locker locker(p->lock);
 	if (!bookAbbrevs) {
 		// Assure all english abbrevs are present
 		for (int j = 0; builtin_abbrevs[j].osis[0]; j++) {
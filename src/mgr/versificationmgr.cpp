@@ -22,11 +22,13 @@
  */
 
 #include <versificationmgr.h>
+#include <verseposition.h>
 #include <vector>
 #include <map>
 #include <treekey.h>
 #include <canon.h>		// KJV internal versification system
 #include <swlog.h>
+#include <swthread.h>
 #include <algorithm>
 
 #include <canon_null.h>		// null v11n system
@@ -51,34 +53,92 @@
 
 using std::vector;
 using std::map;
-using std::distance;
-using std::lower_bound;
+using std::pair;
+using std::upper_bound;
+using std::stable_sort;
 
 
 SWORD_NAMESPACE_START
 
 
+namespace {
+
+	/** a versification system built into the library */
+	struct BuiltinSystem {
+		const char *name;
+		const sbook *ot;
+		const sbook *nt;
+		const int *chMax;
+		const unsigned char *mappings;
+	};
+
+	const BuiltinSystem builtinSystems[] = {
+		{ "KJV", otbooks, ntbooks, vm, 0 },
+		{ "Leningrad", otbooks_leningrad, ntbooks_null, vm_leningrad, 0 },
+		{ "MT", otbooks_mt, ntbooks_null, vm_mt, 0 },
+		{ "KJVA", otbooks_kjva, ntbooks, vm_kjva, 0 },
+		{ "NRSV", otbooks, ntbooks, vm_nrsv, mappings_nrsv },
+		{ "NRSVA", otbooks_nrsva, ntbooks, vm_nrsva, 0 },
+		{ "Synodal", otbooks_synodal, ntbooks_synodal, vm_synodal, mappings_synodal },
+		{ "SynodalProt", otbooks_synodalProt, ntbooks_synodal, vm_synodalProt, 0 },
+		{ "Vulg", otbooks_vulg, ntbooks_vulg, vm_vulg, mappings_vulg },
+		{ "German", otbooks_german, ntbooks, vm_german, 0 },
+		{ "Luther", otbooks_luther, ntbooks_luther, vm_luther, 0 },
+		{ "Catholic", otbooks_catholic, ntbooks, vm_catholic, 0 },
+		{ "Catholic2", otbooks_catholic2, ntbooks, vm_catholic2, 0 },
+		{ "LXX", otbooks_lxx, ntbooks, vm_lxx, 0 },
+		{ "Orthodox", otbooks_orthodox, ntbooks, vm_orthodox, 0 },
+		{ "Calvin", otbooks, ntbooks, vm_calvin, mappings_calvin },
+		{ "DarbyFr", otbooks, ntbooks, vm_darbyfr, mappings_darbyfr },
+		{ "Segond", otbooks, ntbooks, vm_segond, mappings_segond },
+		{ 0, 0, 0, 0, 0 }
+	};
+
+
+	typedef pair<const char *, int> OSISNameEntry;
+
+	struct OSISNameLess {
+		bool operator() (const OSISNameEntry &a, const OSISNameEntry &b) const { return strcmp(a.first, b.first) < 0; }
+		bool operator() (const char *a, const OSISNameEntry &b) const { return strcmp(a, b.first) < 0; }
+	};
+
+
+	/** where an offset falls: book is 1 based, or 0 for the module and
+	 * testament headings; chapter is 0 for a book heading
+	 */
+	struct OffsetEntry {
+		unsigned char book;
+		unsigned char chapter;
+	};
+}
+
+
+class VersificationMgr::Private {
+public:
+	Private() : builtins(false) {
+	}
+	map<SWBuf, System> systems;
+
+	/** true if builtinSystems are registered when first asked for */
+	bool builtins;
+
+	/** guards systems, which a first lookup may add to from any thread */
+	SWMutex lock;
+
+	System &add(const char *name, const sbook *ot, const sbook *nt, const int *chMax, const unsigned char *mappings) {
+		systems[name] = name;
+		System &s = systems[name];
+		s.loadFromSBook(ot, nt, chMax, mappings);
+		return s;
+	}
+};
+
+
 VersificationMgr *VersificationMgr::getSystemVersificationMgr() {
 	if (!systemVersificationMgr) {
 		systemVersificationMgr = new VersificationMgr();
-		systemVersificationMgr->registerVersificationSystem("KJV", otbooks, ntbooks, vm);
-		systemVersificationMgr->registerVersificationSystem("Leningrad", otbooks_leningrad, ntbooks_null, vm_leningrad);
-		systemVersificationMgr->registerVersificationSystem("MT", otbooks_mt, ntbooks_null, vm_mt);
-		systemVersificationMgr->registerVersificationSystem("KJVA", otbooks_kjva, ntbooks, vm_kjva);
-		systemVersificationMgr->registerVersificationSystem("NRSV", otbooks, ntbooks, vm_nrsv, mappings_nrsv);
-		systemVersificationMgr->registerVersificationSystem("NRSVA", otbooks_nrsva, ntbooks, vm_nrsva);
-		systemVersificationMgr->registerVersificationSystem("Synodal", otbooks_synodal, ntbooks_synodal, vm_synodal, mappings_synodal);
-		systemVersificationMgr->registerVersificationSystem("SynodalProt", otbooks_synodalProt, ntbooks_synodal, vm_synodalProt);
-		systemVersificationMgr->registerVersificationSystem("Vulg", otbooks_vulg, ntbooks_vulg, vm_vulg, mappings_vulg);
-		systemVersificationMgr->registerVersificationSystem("German", otbooks_german, ntbooks, vm_german);
-		systemVersificationMgr->registerVersificationSystem("Luther", otbooks_luther, ntbooks_luther, vm_luther);
-		systemVersificationMgr->registerVersificationSystem("Catholic", otbooks_catholic, ntbooks, vm_catholic);
-		systemVersificationMgr->registerVersificationSystem("Catholic2", otbooks_catholic2, ntbooks, vm_catholic2);
-		systemVersificationMgr->registerVersificationSystem("LXX", otbooks_lxx, ntbooks, vm_lxx);
-		systemVersificationMgr->registerVersificationSystem("Orthodox", otbooks_orthodox, ntbooks, vm_orthodox);
-		systemVersificationMgr->registerVersificationSystem("Calvin", otbooks, ntbooks, vm_calvin, mappings_calvin);
-		systemVersificationMgr->registerVersificationSystem("DarbyFr", otbooks, ntbooks, vm_darbyfr, mappings_darbyfr);
-		systemVersificationMgr->registerVersificationSystem("Segond", otbooks, ntbooks, vm_segond, mappings_segond);
+		// each is loaded the first time it is asked for by name
+		systemVersificationMgr->p->builtins = true;
 	}
 	return systemVersificationMgr;
 }
@@ -86,9 +146,17 @@ VersificationMgr *VersificationMgr::getSystemVersificationMgr() {
 
 class VersificationMgr::System::Private {
 public:
-	/** Array[chapmax] of maximum verses in chapters */
 	vector<Book> books;
-	map<SWBuf, int> osisLookup;
+
+	/** OSIS name and 1 based number of each book, sorted by name */
+	vector<OSISNameEntry> osisLookup;
+
+	/** offset of each chapter heading, book after book; Books point in here */
+	vector<long> chapterOffsets;
+
+	/** [offset] for every offset up to the last verse */
+	vector<OffsetEntry> offsets;
+
 	/** General mapping rule is that first verse of every chapter corresponds first
 		verse of another chapter in default intermediate canon(kjva), so mapping data
 		contains expections. Intermediate canon could not contain corresponding data.
@@ -105,59 +173,9 @@ public:
 	typedef vector<const unsigned char*> mappingRule;
 	vector<mappingRule> mappings;
 	vector<const char*> mappingsExtraBooks;
-
-	Private() {
-	}
-	Private(const VersificationMgr::System::Private &other) {
-		books = other.books;
-		osisLookup = other.osisLookup;
-	}
-	VersificationMgr::System::Private &operator =(const VersificationMgr::System::Private &other) {
-		books = other.books;
-		osisLookup = other.osisLookup;
-		return *this;
-	}
 };
 
 
-class VersificationMgr::Book::Private {
-friend struct BookOffsetLess;
-public:
-	/** Array[chapmax] of maximum verses in chapters */
-	vector<int> verseMax;
-	vector<long> offsetPrecomputed;
-
-	Private() {
-		verseMax.clear();
-	}
-	Private(const VersificationMgr::Book::Private &other) {
-		verseMax.clear();
-		verseMax = other.verseMax;
-		offsetPrecomputed = other.offsetPrecomputed;
-	}
-	VersificationMgr::Book::Private &operator =(const VersificationMgr::Book::Private &other) {
-		verseMax.clear();
-                int s = (int)other.verseMax.size();
-                if (s) verseMax = other.verseMax;
-		offsetPrecomputed = other.offsetPrecomputed;
-		return *this;
-	}
-};
-
-
-struct BookOffsetLess {
-	bool operator() (const VersificationMgr::Book &o1, const VersificationMgr::Book &o2) const { return o1.p->offsetPrecomputed[0] < o2.p->offsetPrecomputed[0]; }
-	bool operator() (const long &o1, const VersificationMgr::Book &o2) const { return o1 < o2.p->offsetPrecomputed[0]; }
-	bool operator() (const VersificationMgr::Book &o1, const long &o2) const { return o1.p->offsetPrecomputed[0] < o2; }
-	bool operator() (const long &o1, const long &o2) const { return o1 < o2; }
-};
-
-
-void VersificationMgr::Book::init() {
-	p = new Private();
-}
-
-
 void VersificationMgr::System::init() {
 	p = new Private();
 	BMAX[0] = 0;
@@ -173,6 +191,7 @@ VersificationMgr::System::System(const System &other) {
 	BMAX[1] = other.BMAX[1];
 	(*p) = *(other.p);
 	ntStartOffset = other.ntStartOffset;
+	bindBooks();
 }
 
 
@@ -182,6 +201,7 @@ VersificationMgr::System &VersificationMgr::System::operator =(const System &oth
 	BMAX[1] = other.BMAX[1];
 	(*p) = *(other.p);
 	ntStartOffset = other.ntStartOffset;
+	bindBooks();
 	return *this;
 }
 
@@ -191,31 +211,40 @@ VersificationMgr::System::~System() {
 }
 
 
+// points each Book at its chapters in our chapterOffsets
+void VersificationMgr::System::bindBooks() {
+	long chapter = 0;
+	for (unsigned int i = 0; i < p->books.size(); ++i) {
+		p->books[i].chapterOffsets = (p->books[i].chapMax) ? &(p->chapterOffsets[chapter]) : 0;
+		chapter += p->books[i].chapMax;
+	}
+}
+
+
 const VersificationMgr::Book *VersificationMgr::System::getBook(int number) const {
-	return (number < (signed int)p->books.size()) ? &(p->books[number]) : 0;
+	return ((number > -1) && (number < (signed int)p->books.size())) ? &(p->books[number]) : 0;
 }
 
 
 int VersificationMgr::System::getBookNumberByOSISName(const char *bookName) const {
-	map<SWBuf, int>::const_iterator it = p->osisLookup.find(bookName);
-	return (it != p->osisLookup.end()) ? it->second : -1;
+	// the last of any duplicates wins, as it did when this was a map
+	vector<OSISNameEntry>::const_iterator it = upper_bound(p->osisLookup.begin(), p->osisLookup.end(), bookName, OSISNameLess());
+	return ((it != p->osisLookup.begin()) && !strcmp((it-1)->first, bookName)) ? (it-1)->second : -1;
 }
 
 
-void VersificationMgr::System::loadFromSBook(const sbook *ot, const sbook *nt, int *chMax, const unsigned char *mappings) {
+void VersificationMgr::System::loadFromSBook(const sbook *ot, const sbook *nt, const int *chMax, const unsigned char *mappings) {
 	int chap = 0;
 	int book = 0;
 	long offset = 0;	// module heading
 	offset++;			// testament heading
 	while (ot->chapmax) {
-		p->books.push_back(Book(ot->name, ot->osis, ot->prefAbbrev, ot->chapmax));
+		p->books.push_back(Book(ot->name, ot->osis, ot->prefAbbrev, ot->chapmax, chMax + chap));
 		offset++;		// book heading
-		Book &b = p->books[p->books.size()-1];
-		p->osisLookup[b.getOSISName()] = (int)p->books.size();
+		p->osisLookup.push_back(OSISNameEntry(ot->osis, (int)p->books.size()));
 		for (int i = 0; i < ot->chapmax; i++) {
-			b.p->verseMax.push_back(chMax[chap]);
 			offset++;		// chapter heading
-			b.p->offsetPrecomputed.push_back(offset);
+			p->chapterOffsets.push_back(offset);
 			offset += chMax[chap++];
 		}
 		ot++;
@@ -227,14 +256,12 @@ void VersificationMgr::System::loadFromSBook(const sbook *ot, const sbook *nt, i
 	ntStartOffset = offset;
 	offset++;			// testament heading
 	while (nt->chapmax) {
-		p->books.push_back(Book(nt->name, nt->osis, nt->prefAbbrev, nt->chapmax));
+		p->books.push_back(Book(nt->name, nt->osis, nt->prefAbbrev, nt->chapmax, chMax + chap));
 		offset++;		// book heading
-		Book &b = p->books[p->books.size()-1];
-		p->osisLookup[b.getOSISName()] = (int)p->books.size();
+		p->osisLookup.push_back(OSISNameEntry(nt->osis, (int)p->books.size()));
 		for (int i = 0; i < nt->chapmax; i++) {
-			b.p->verseMax.push_back(chMax[chap]);
 			offset++;		// chapter heading
-			b.p->offsetPrecomputed.push_back(offset);
+			p->chapterOffsets.push_back(offset);
 			offset += chMax[chap++];
 		}
 		nt++;
@@ -243,7 +270,24 @@ void VersificationMgr::System::loadFromSBook(const sbook *ot, const sbook *nt, i
 
 	BMAX[1] = book;
 
-	// TODO: build offset speed array
+	bindBooks();
+	stable_sort(p->osisLookup.begin(), p->osisLookup.end(), OSISNameLess());
+
+	// where each offset falls, so getVerseFromOffset needn't search for it.
+	// Testament headings are left { 0, 0 } and told apart by offset.
+	OffsetEntry heading = { 0, 0 };
+	p->offsets.assign((BMAX[1] ? offset : ntStartOffset) + 1, heading);
+	for (unsigned int i = 0; i < p->books.size(); ++i) {
+		const Book &b = p->books[i];
+		OffsetEntry entry = { (unsigned char)(i + 1), 0 };
+		p->offsets[b.chapterOffsets[0] - 1] = entry;	// book heading
+		for (unsigned int c = 0; c < b.chapMax; ++c) {
+			entry.chapter = (unsigned char)(c + 1);
+			for (long o = b.chapterOffsets[c]; o <= b.chapterOffsets[c] + b.verseMax[c]; ++o) {
+				p->offsets[o] = entry;
+			}
+		}
+	}
 
 	// parse mappings
 	if (mappings != NULL) {
@@ -264,35 +308,9 @@ void VersificationMgr::System::loadFromSBook(const sbook *ot, const sbook *nt, i
 }
 
 
-VersificationMgr::Book::Book(const Book &other) {
-	longName = other.longName;
-	osisName = other.osisName;
-	prefAbbrev = other.prefAbbrev;
-	chapMax = other.chapMax;
-	init();
-	(*p) = *(other.p);
-}
-
-
-VersificationMgr::Book& VersificationMgr::Book::operator =(const Book &other) {
-	longName = other.longName;
-	osisName = other.osisName;
-	prefAbbrev = other.prefAbbrev;
-	chapMax = other.chapMax;
-	init();
-	(*p) = *(other.p);
-	return *this;
-}
-
-
-VersificationMgr::Book::~Book() {
-	delete p;
-}
-
-
 int VersificationMgr::Book::getVerseMax(int chapter) const {
 	chapter--;
-	return (p && (chapter < (signed int)p->verseMax.size()) && (chapter > -1)) ? p->verseMax[chapter] : -1;
+	return ((chapter < (signed int)chapMax) && (chapter > -1)) ? verseMax[chapter] : -1;
 }
 
 
@@ -308,9 +326,9 @@ long VersificationMgr::System::getOffsetFromVerse(int book, int chapter, int ver
 	const Book *b = getBook(book);
 
 	if (!b)                                        return -1;	// assert we have a valid book
-	if ((chapter > -1) && (chapter >= (signed int)b->p->offsetPrecomputed.size())) return -1;	// assert we have a valid chapter
+	if ((chapter > -1) && (chapter >= (signed int)b->chapMax)) return -1;	// assert we have a valid chapter
 
-	offset = b->p->offsetPrecomputed[(chapter > -1)?chapter:0];
+	offset = b->chapterOffsets[(chapter > -1)?chapter:0];
 	if (chapter < 0) offset--;
 
 /* old code
@@ -335,32 +353,28 @@ char VersificationMgr::System::getVerseFromOffset(long offset, int *book, int *c
 		return offset;	// < 0 = error
 	}
 
-	// binary search for book
-	vector<Book>::iterator b = lower_bound(p->books.begin(), p->books.end(), offset, BookOffsetLess());
-	if (b == p->books.end()) b--;
-	(*book)    = distance(p->books.begin(), b)+1;
-	if (offset < (*(b->p->offsetPrecomputed.begin()))-((((!(*book)) || (*book)==BMAX[0]+1))?2:1)) { // -1 for chapter headings
-		(*book)--;
-		if (b != p->books.begin()) {
-			b--;	
-		}
-	}
-	vector<long>::iterator c = lower_bound(b->p->offsetPrecomputed.begin(), b->p->offsetPrecomputed.end(), offset);
-
-	// if we're a book heading, we are lessthan chapter precomputes, but greater book.  This catches corner case.
-	if (c == b->p->offsetPrecomputed.end()) {
-		c--;
-	}
-	if ((offset < *c) && (c == b->p->offsetPrecomputed.begin())) {
-		(*chapter) = (offset - *c)+1;	// should be 0 or -1 (for testament heading)
+	// testament headings
+	if ((offset == 1) || (BMAX[1] && (offset == ntStartOffset + 1))) {
+		(*book) = (offset == 1) ? 0 : BMAX[0] + 1;
+		(*chapter) = -1;
 		(*verse) = 0;
+		return 0;
 	}
-	else {
-		if (offset < *c) c--;
-		(*chapter) = distance(b->p->offsetPrecomputed.begin(), c)+1;
-		(*verse)   = (offset - *c);
+
+	// past the last verse: count on from the last chapter
+	if (offset >= (long)p->offsets.size()) {
+		const Book &b = p->books.back();
+		(*book) = (int)p->books.size();
+		(*chapter) = b.chapMax;
+		(*verse) = offset - b.chapterOffsets[b.chapMax-1];
+		return KEYERR_OUTOFBOUNDS;
 	}
-	return ((*chapter > 0) && (*verse > b->getVerseMax(*chapter))) ? KEYERR_OUTOFBOUNDS : 0;
+
+	const OffsetEntry &entry = p->offsets[offset];
+	(*book) = entry.book;
+	(*chapter) = entry.chapter;
+	(*verse) = (entry.chapter) ? offset - p->books[entry.book-1].chapterOffsets[entry.chapter-1] : 0;
+	return 0;
 }
 
 
@@ -368,19 +382,6 @@ char VersificationMgr::System::getVerseFromOffset(long offset, int *book, int *c
  * VersificationMgr
  */
 
-class VersificationMgr::Private {
-public:
-	Private() {
-	}
-	Private(const VersificationMgr::Private &other) {
-		systems = other.systems;
-	}
-	VersificationMgr::Private &operator =(const VersificationMgr::Private &other) {
-		systems = other.systems;
-		return *this;
-	}
-	map<SWBuf, System> systems;
-};
 // ---------------- statics -----------------
 VersificationMgr *VersificationMgr::systemVersificationMgr = 0;
 
@@ -409,15 +410,24 @@ void VersificationMgr::setSystemVersificationMgr(VersificationMgr *newVersificat
 
 
 const VersificationMgr::System *VersificationMgr::getVersificationSystem(const char *name) const {
+	SWMutex::Locker locker(p->lock);
 	map<SWBuf, System>::const_iterator it = p->systems.find(name);
-	return (it != p->systems.end()) ? &(it->second) : 0;
+	if (it != p->systems.end()) return &(it->second);
+
+	if (p->builtins) {
+		for (const BuiltinSystem *b = builtinSystems; b->name; ++b) {
+			if (!strcmp(b->name, name)) {
+				return &(p->add(b->name, b->ot, b->nt, b->chMax, b->mappings));
+			}
+		}
+	}
+	return 0;
 }
 
 
-void VersificationMgr::registerVersificationSystem(const char *name, const sbook *ot, const sbook *nt, int *chMax, const unsigned char *mappings) {
-	p->systems[name] = name;
-	System &s = p->systems[name];
-	s.loadFromSBook(ot, nt, chMax, mappings);
+void VersificationMgr::registerVersificationSystem(const char *name, const sbook *ot, const sbook *nt, const int *chMax, const unsigned char *mappings) {
+	SWMutex::Locker locker(p->lock);
+	p->add(name, ot, nt, chMax, mappings);
 }
 
 
@@ -426,10 +436,19 @@ void VersificationMgr::registerVersificationSystem(const char *name, const TreeK
 
 
 const StringList VersificationMgr::getVersificationSystems() const {
+	SWMutex::Locker locker(p->lock);
 	StringList retVal;
 	for (map<SWBuf, System>::const_iterator it = p->systems.begin(); it != p->systems.end(); it++) {
 		retVal.push_back(it->first);
 	}
+	// and those built in which haven't been asked for yet
+	if (p->builtins) {
+		for (const BuiltinSystem *b = builtinSystems; b->name; ++b) {
+			retVal.push_back(b->name);
+		}
+		retVal.sort();
+		retVal.unique();
+	}
 	return retVal;
 }
 
@@ -480,7 +499,9 @@ void VersificationMgr::System::translateVerse(const System *dstSys, const char *
 					*verse_end = m[3];
 					if (*m >= dstSys->p->books.size()) {
 						SWLog::getSystemLog()->logWarning("map to extra books, possible bug source\n");
-						*book = dstSys->getBook(m[7]-1)->getOSISName();
+						// a rule for the last book has no 8th byte; leave the book alone
+						const Book *target = dstSys->getBook(m[7]-1);
+						if (target) *book = target->getOSISName();
 					}
 					return;
 				}
@@ -569,5 +590,56 @@ void VersificationMgr::System::translateVerse(const System *dstSys, const char *
 	}
 }
 
+
+VersePosition VersificationMgr::System::translateVerse(const System *dstSys, const VersePosition &pos) const {
+	VersePosition result = makeVersePosition(dstSys, pos.index);
+	if (dstSys == this) {
+		result.end = pos.end;
+		return result;
+	}
+
+	// module and testament headings are found in the same place in every system
+	if (pos.index < 2) return result;
+	if (pos.index == ntStartOffset + 1) {
+		result.index = dstSys->ntStartOffset + 1;
+		return result;
+	}
+
+	int book, chapter, verse;
+	getVerseFromOffset(pos.index, &book, &chapter, &verse);
+	const char *bookName = getBook(book-1)->getOSISName();
+	int verseEnd = verse;
+	translateVerse(dstSys, &bookName, &chapter, &verse, &verseEnd);
+
+	int dstBook = dstSys->getBookNumberByOSISName(bookName);
+	if (dstBook < 1) {
+		result.index = -1;
+		return result;
+	}
+
+	// keep within the destination book, as VerseKey does when it maps
+	const Book *b = dstSys->getBook(dstBook-1);
+	if (b->getChapterMax() < chapter) {
+		chapter = b->getChapterMax();
+		verse = b->getVerseMax(chapter);
+	}
+	else if ((chapter > 0) && (b->getVerseMax(chapter) < verse)) {
+		verse = b->getVerseMax(chapter);
+	}
+	result.index = dstSys->getOffsetFromVerse(dstBook-1, chapter, verse);
+	if ((chapter > 0) && (verse < verseEnd)) {
+		if (verseEnd > b->getVerseMax(chapter)) verseEnd = b->getVerseMax(chapter);
+		if (verse < verseEnd) result.end = dstSys->getOffsetFromVerse(dstBook-1, chapter, verseEnd);
+	}
+
+	// a range ends wherever its last verse does
+	if (pos.isRange()) {
+		VersePosition last = translateVerse(dstSys, makeVersePosition(this, pos.end));
+		long lastIndex = (last.isRange()) ? last.end : last.index;
+		if ((lastIndex > result.index) && (lastIndex > result.end)) result.end = lastIndex;
+	}
+	return result;
+}
+
 SWORD_NAMESPACE_END
 
@@ -32,6 +32,7 @@
 #include <hrefcom.h>
 #include <swbuf.h>
 #include <versekey.h>
+#include <swmetrics.h>
 
 SWORD_NAMESPACE_START
 
@@ -88,6 +89,7 @@ SWBuf &HREFCom::getRawEntryBuf() const {
 
 	if (key != (const VerseKey *)this->key)
 		delete key;
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
@@ -31,6 +31,7 @@
 #include <rawverse.h>
 #include <rawcom.h>
 #include <versekey.h>
+#include <swmetrics.h>
 
 SWORD_NAMESPACE_START
 
@@ -83,6 +84,7 @@ SWBuf &RawCom::getRawEntryBuf() const {
 
 //	if (!isUnicode())
 		prepText(entryBuf);
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
@@ -131,12 +133,14 @@ void RawCom::increment(int steps) {
 
 
 void RawCom::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 	VerseKey *key = &getVerseKey();
 	doSetText(key->getTestament(), key->getTestamentIndex(), inbuf, len);
 }
 
 
 void RawCom::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 	VerseKey *destkey = &getVerseKey();
 	const VerseKey *srckey = &getVerseKeyConst(inkey);
 
@@ -154,6 +158,7 @@ void RawCom::linkEntry(const SWKey *inkey) {
  */
 
 void RawCom::deleteEntry() {
+	EntryEdit edit(this);
 
 	VerseKey *key = &getVerseKey();
 	doSetText(key->getTestament(), key->getTestamentIndex(), "");
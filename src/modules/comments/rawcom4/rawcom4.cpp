@@ -30,6 +30,7 @@
 #include <rawverse4.h>
 #include <rawcom4.h>
 #include <versekey.h>
+#include <swmetrics.h>
 
 SWORD_NAMESPACE_START
 
@@ -82,6 +83,7 @@ SWBuf &RawCom4::getRawEntryBuf() const {
 
 //	if (!isUnicode())
 		prepText(entryBuf);
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
@@ -130,12 +132,14 @@ void RawCom4::increment(int steps) {
 
 
 void RawCom4::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 	VerseKey *key = &getVerseKey();
 	doSetText(key->getTestament(), key->getTestamentIndex(), inbuf, len);
 }
 
 
 void RawCom4::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 	VerseKey *destkey = &getVerseKey();
 	const VerseKey *srckey = &getVerseKeyConst(inkey);
 	doLinkEntry(destkey->getTestament(), destkey->getTestamentIndex(), srckey->getTestamentIndex());
@@ -149,6 +153,7 @@ void RawCom4::linkEntry(const SWKey *inkey) {
  */
 
 void RawCom4::deleteEntry() {
+	EntryEdit edit(this);
 
 	VerseKey *key = &getVerseKey();
 	doSetText(key->getTestament(), key->getTestamentIndex(), "");
@@ -30,6 +30,7 @@
 #include <filemgr.h>
 #include <versekey.h>
 #include <sysdata.h>
+#include <swmetrics.h>
 
 SWORD_NAMESPACE_START
 
@@ -98,6 +99,8 @@ SWBuf &RawFiles::getRawEntryBuf() const {
 		}
 		FileMgr::getSystemFileMgr()->close(datafile);
 	}
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
+
 	return entryBuf;
 }
 
@@ -108,6 +111,7 @@ SWBuf &RawFiles::getRawEntryBuf() const {
  */
 
 void RawFiles::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 	FileDesc *datafile;
 	long  start;
 	unsigned short size;
@@ -148,6 +152,7 @@ void RawFiles::setEntry(const char *inbuf, long len) {
  */
 
 void RawFiles::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 
 	long  start;
 	unsigned short size;
@@ -172,6 +177,7 @@ void RawFiles::linkEntry(const SWKey *inkey) {
  */
 
 void RawFiles::deleteEntry() {
+	EntryEdit edit(this);
 	VerseKey *key = &getVerseKey();
 	doSetText(key->getTestament(), key->getTestamentIndex(), "");
 }
@@ -30,6 +30,7 @@
 #include <versekey.h>
 #include <zcom4.h>
 #include <filemgr.h>
+#include <swmetrics.h>
 
 SWORD_NAMESPACE_START
 
@@ -89,6 +90,7 @@ SWBuf &zCom4::getRawEntryBuf() const {
 
 //	if (!isUnicode())
 		prepText(entryBuf);
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
@@ -113,12 +115,13 @@ bool zCom4::sameBlock(VerseKey *k1, VerseKey *k2) {
 }
 
 void zCom4::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 	VerseKey *key = &getVerseKey();
 
 	// see if we've jumped across blocks since last write
 	if (lastWriteKey) {
 		if (!sameBlock(lastWriteKey, key)) {
-			flushCache();
+			flushCache(false);	// compressed and written out while we go on
 		}
 		delete lastWriteKey;
 	}
@@ -130,6 +133,7 @@ void zCom4::setEntry(const char *inbuf, long len) {
 
 
 void zCom4::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 	VerseKey *destkey = &getVerseKey();
 	const VerseKey *srckey = &getVerseKeyConst(inkey);
 
@@ -146,6 +150,7 @@ void zCom4::linkEntry(const SWKey *inkey) {
  */
 
 void zCom4::deleteEntry() {
+	EntryEdit edit(this);
 
 	VerseKey *key = &getVerseKey();
 	doSetText(key->getTestament(), key->getTestamentIndex(), "");
@@ -0,0 +1,147 @@
+/******************************************************************************
+ *
+ *  blockprefetcher.cpp -	BlockPrefetcher: reads ahead of a compressed
+ *			module running forward through its blocks
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <blockprefetcher.h>
+#include <swcomprs.h>
+#include <swmetrics.h>
+
+#include <string.h>
+
+SWORD_NAMESPACE_START
+
+
+int BlockPrefetcher::depth = 2;
+
+
+BlockPrefetcher::BlockPrefetcher(const SWCompress *compressor) : lastTestament(0), lastBlock(0) {
+	decoder = (compressor) ? compressor->clone() : 0;
+}
+
+
+BlockPrefetcher::~BlockPrefetcher() {
+	thread.join();
+	delete decoder;
+}
+
+
+void BlockPrefetcher::setDepth(int count) {
+	depth = (count > 0) ? count : 0;
+}
+
+
+int BlockPrefetcher::getDepth() {
+	return depth;
+}
+
+
+void BlockPrefetcher::decodeBlocks(void *userData) {
+	BlockPrefetcher *self = (BlockPrefetcher *)userData;
+#ifndef STRIPMETRICS
+	const char *owner = (self->owner.length()) ? self->owner.c_str() : 0;
+#endif
+
+	for (std::list<Block>::iterator block = self->blocks.begin(); block != self->blocks.end(); ++block) {
+		if (block->decoded) continue;
+
+		SWMETRICS_START(decompressStart);
+		unsigned long len = block->data.length();
+		self->decoder->setCompressedBuf(&len, block->data.getRawData());
+		len = 0;
+		self->decoder->setUncompressedBuf(0, &len);
+
+		SWBuf text;
+		text.setSize(len);
+		memcpy(text.getRawData(), self->decoder->getUncompressedBuf(), len);
+		block->data = text;
+		block->decoded = true;
+		SWMETRICS_ADD(owner, BLOCK_DECOMPRESSIONS, 1);
+		SWMETRICS_ADD_SINCE(decompressStart, owner, DECOMPRESS_MICROS);
+	}
+}
+
+
+bool BlockPrefetcher::take(char testament, unsigned long block, SWBuf &text) {
+	// the prefetch thread changes only what's in the blocks, not which they are
+	for (std::list<Block>::iterator i = blocks.begin(); i != blocks.end(); ++i) {
+		if (i->testament == testament && i->number == block) {
+			thread.join();
+			if (!i->decoded || !i->data.length()) return false;
+			text = i->data;
+			blocks.erase(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void BlockPrefetcher::readAhead(char testament, unsigned long block, const char *owner, BlockReader reader, const void *source) {
+	bool forward = (testament == lastTestament) && (block == lastBlock + 1);
+	lastTestament = testament;
+	lastBlock = block;
+
+	if (!decoder || depth < 1) return;
+
+	thread.join();
+	if (!forward) {
+		blocks.clear();
+		return;
+	}
+
+	// what's behind us won't be asked for again
+	for (std::list<Block>::iterator i = blocks.begin(); i != blocks.end();) {
+		if (i->testament != testament || i->number <= block) i = blocks.erase(i);
+		else ++i;
+	}
+
+	bool added = false;
+	for (unsigned long next = block + 1; next <= block + depth; next++) {
+		bool held = false;
+		for (std::list<Block>::iterator i = blocks.begin(); i != blocks.end(); ++i) {
+			if (i->number == next) held = true;
+		}
+		if (held) continue;
+
+		Block ahead;
+		ahead.testament = testament;
+		ahead.number = next;
+		ahead.decoded = false;
+		if (!reader(source, testament, next, ahead.data)) break;
+		blocks.push_back(ahead);
+		added = true;
+	}
+
+	if (added) {
+		this->owner = (owner) ? owner : "";
+		if (!thread.start(decodeBlocks, this)) blocks.clear();
+	}
+}
+
+
+void BlockPrefetcher::clear() {
+	thread.join();
+	blocks.clear();
+}
+
+
+SWORD_NAMESPACE_END
@@ -0,0 +1,125 @@
+/******************************************************************************
+ *
+ *  blockwriter.cpp -	BlockWriter: compresses a module's blocks on threads
+ *			and writes them out in order
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <blockwriter.h>
+#include <swcomprs.h>
+
+#include <string.h>
+
+SWORD_NAMESPACE_START
+
+
+int BlockWriter::threads = 1;
+
+
+BlockWriter::BlockWriter(const SWCompress *compressor, BlockCommitter committer, const void *module) : compressor(compressor), committer(committer), module(module), slots(0), slotCount(0), next(0) {
+}
+
+
+BlockWriter::~BlockWriter() {
+	for (int i = 0; i < slotCount; i++) {
+		slots[i].thread.join();
+		delete slots[i].compressor;
+	}
+	delete [] slots;
+}
+
+
+void BlockWriter::setThreads(int count) {
+	threads = (count > 1) ? count : 1;
+}
+
+
+int BlockWriter::getThreads() {
+	return threads;
+}
+
+
+void BlockWriter::compressBlock(void *userData) {
+	Slot *slot = (Slot *)userData;
+
+	unsigned long len = slot->size;
+	slot->compressor->setUncompressedBuf(slot->data.c_str(), &len);
+	slot->compressor->getCompressedBuf(&len);
+
+	slot->data.setSize(len);
+	memcpy(slot->data.getRawData(), slot->compressor->getCompressedBuf(&len), len);
+}
+
+
+void BlockWriter::commit(Slot &slot) {
+	slot.thread.join();
+	committer(module, slot.testament, slot.block, slot.size, slot.data);
+	slot.used = false;
+}
+
+
+bool BlockWriter::add(char testament, long block, const char *data, unsigned long size) {
+	if (!slots) {
+		if (!compressor || threads < 2) return false;
+
+		SWCompress *copy = compressor->clone();
+		if (!copy) return false;
+
+		slotCount = threads;
+		slots = new Slot[slotCount];
+		for (int i = 0; i < slotCount; i++) {
+			slots[i].used = false;
+			slots[i].compressor = (i) ? compressor->clone() : copy;
+		}
+	}
+
+	Slot &slot = slots[next];
+	if (slot.used) commit(slot);
+
+	slot.testament = testament;
+	slot.block = block;
+	slot.size = size;
+	slot.data.setSize(size);
+	memcpy(slot.data.getRawData(), data, size);
+	slot.used = true;
+	next = (next + 1) % slotCount;
+
+	if (!slot.thread.start(compressBlock, &slot)) compressBlock(&slot);
+	return true;
+}
+
+
+long BlockWriter::getPending(char testament) const {
+	long pending = 0;
+	for (int i = 0; i < slotCount; i++) {
+		if (slots[i].used && slots[i].testament == testament) pending++;
+	}
+	return pending;
+}
+
+
+void BlockWriter::finish() {
+	for (int i = 0; i < slotCount; i++) {
+		Slot &slot = slots[(next + i) % slotCount];
+		if (slot.used) commit(slot);
+	}
+}
+
+
+SWORD_NAMESPACE_END
@@ -48,6 +48,17 @@ Bzip2Compress::~Bzip2Compress() {
 }
 
 
+/******************************************************************************
+ * Bzip2Compress::clone	- a compressor of the same kind, for another thread
+ */
+
+SWCompress *Bzip2Compress::clone() const {
+	Bzip2Compress *copy = new Bzip2Compress();
+	copy->setLevel(level);
+	return copy;
+}
+
+
 /******************************************************************************
  * Bzip2Compress::Encode - This function "encodes" the input stream into the
  *			output stream.
@@ -0,0 +1,381 @@
+/******************************************************************************
+ *
+ *  entryattridx.cpp -	EntryAttributeIndex: persisted attribute value to
+ *			module index postings for entry attribute searches
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <entryattridx.h>
+#include <searchjournal.h>
+#include <filemgr.h>
+#include <utilstr.h>
+#include <stringmgr.h>
+#include <sysdata.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <iterator>
+#include <fcntl.h>
+
+SWORD_NAMESPACE_START
+
+const char *EntryAttributeIndex::FILENAME = "entryattr.idx";
+
+namespace {
+
+	// file layout, all integers little endian:
+	//	"SWAI" version(4) signature(str) typeCount(4)
+	//		{ type(str) nameCount(4)
+	//			{ name(str) valueCount(4)
+	//				{ value(str) postingCount(4) postings(delta encoded varints) } } }
+	//	str: length(4) bytes
+	const char MAGIC[] = "SWAI";
+	const SW_u32 VERSION = 1;
+
+	void putU32(SWBuf &out, SW_u32 val) {
+		val = archtosword32(val);
+		unsigned long size = out.length();
+		out.setSize(size + 4);
+		memcpy(out.getRawData() + size, &val, 4);
+	}
+
+	void putStr(SWBuf &out, const SWBuf &str) {
+		putU32(out, (SW_u32)str.length());
+		unsigned long size = out.length();
+		out.setSize(size + str.length());
+		memcpy(out.getRawData() + size, str.c_str(), str.length());
+	}
+
+	void putVarint(SWBuf &out, unsigned long val) {
+		do {
+			unsigned char b = val & 0x7f;
+			val >>= 7;
+			if (val) b |= 0x80;
+			out.append((char)b);
+		} while (val);
+	}
+
+	class Reader {
+		const char *pos, *end;
+	public:
+		bool ok;
+		Reader(const char *buf, unsigned long len) : pos(buf), end(buf + len), ok(true) {}
+
+		SW_u32 getU32() {
+			SW_u32 val = 0;
+			if (end - pos < 4) { ok = false; return 0; }
+			memcpy(&val, pos, 4);
+			pos += 4;
+			return swordtoarch32(val);
+		}
+
+		SWBuf getStr() {
+			SW_u32 len = getU32();
+			SWBuf str;
+			if (!ok || (unsigned long)(end - pos) < len) { ok = false; return str; }
+			str.setSize(len);
+			memcpy(str.getRawData(), pos, len);
+			pos += len;
+			return str;
+		}
+
+		unsigned long getVarint() {
+			unsigned long val = 0;
+			int shift = 0;
+			for (;;) {
+				if (pos >= end || shift > 56) { ok = false; return 0; }
+				unsigned char b = (unsigned char)*pos++;
+				val |= (unsigned long)(b & 0x7f) << shift;
+				if (!(b & 0x80)) return val;
+				shift += 7;
+			}
+		}
+	};
+
+	struct SignatureEntry {
+		SWBuf name;
+		unsigned long size;
+		long mtime;
+		SWBuf content;
+		bool operator <(const SignatureEntry &other) const { return name < other.name; }
+	};
+
+	// files up to this size, the key indexes of every driver, add a hash
+	// of their content to the signature: an edit can leave a file's size
+	// and its mtime, to the second, as they were, but not its index entry
+	const unsigned long CONTENT_HASH_LIMIT = 1024 * 1024;
+
+	// 64-bit FNV-1a of a file's bytes, in hex
+	SWBuf hashContent(const char *path) {
+		SWBuf hashed;
+		int fd = FileMgr::openFileReadOnly(path);
+		if (fd < 0) return hashed;
+		SW_u64 hash = 0xcbf29ce484222325ULL;
+		unsigned char buf[16384];
+		long got;
+		while ((got = FileMgr::read(fd, buf, sizeof(buf))) > 0) {
+			for (long i = 0; i < got; ++i) {
+				hash ^= buf[i];
+				hash *= 0x100000001b3ULL;
+			}
+		}
+		FileMgr::closeFile(fd);
+		hashed.setFormatted("%08x%08x", (SW_u32)(hash >> 32), (SW_u32)hash);
+		return hashed;
+	}
+
+	// everything before the first '.', e.g., Lemma.2 -> Lemma
+	bool componentMatches(const SWBuf &name, const char *base) {
+		const char *dot = strchr(name.c_str(), '.');
+		size_t len = (dot) ? (size_t)(dot - name.c_str()) : name.length();
+		return (strlen(base) == len) && !strncmp(name.c_str(), base, len);
+	}
+
+	bool valueMatches(const SWBuf &candidate, const char *value, bool matchWholeEntry, bool icase) {
+		if (!value) return true;
+		if (!*value) return !candidate.length();
+		if (matchWholeEntry) return !(icase ? stricmpUTF8(candidate.c_str(), value) : strcmp(candidate.c_str(), value));
+		return (icase ? stristrUTF8(candidate.c_str(), value) : strstr(candidate.c_str(), value)) != 0;
+	}
+}
+
+
+EntryAttributeIndex::EntryAttributeIndex(const char *dataPath) : dataPath(dataPath) {
+	if (!this->dataPath.endsWith("/") && !this->dataPath.endsWith("\\")) {
+		this->dataPath.append('/');
+	}
+}
+
+
+SWBuf EntryAttributeIndex::getIndexPath(const char *dataPath) {
+	SWBuf path = dataPath;
+	if (!path.endsWith("/") && !path.endsWith("\\")) path.append('/');
+	return path + FILENAME;
+}
+
+
+SWBuf EntryAttributeIndex::getDataSignature(const char *dataPath) {
+	SWBuf basePath = dataPath;
+	if (!basePath.endsWith("/") && !basePath.endsWith("\\")) basePath.append('/');
+
+	SWBuf tmpName = FILENAME;
+	tmpName += ".tmp";
+
+	std::vector<SignatureEntry> files;
+	std::vector<DirEntry> dirList = FileMgr::getDirList(dataPath, true);
+	for (unsigned int i = 0; i < dirList.size(); ++i) {
+		if (dirList[i].isDirectory) continue;	// lucene, xapian, ...
+		if (dirList[i].name == FILENAME || dirList[i].name == tmpName) continue;
+		if (dirList[i].name == SearchJournal::FILENAME) continue;
+		SignatureEntry e;
+		e.name = dirList[i].name;
+		e.size = dirList[i].size;
+		struct stat st;
+		e.mtime = (!stat(basePath + e.name, &st)) ? (long)st.st_mtime : 0;
+		if (e.size <= CONTENT_HASH_LIMIT) e.content = hashContent(basePath + e.name);
+		files.push_back(e);
+	}
+	std::sort(files.begin(), files.end());
+
+	SWBuf signature;
+	for (unsigned int i = 0; i < files.size(); ++i) {
+		signature.appendFormatted("%s:%lu:%ld", files[i].name.c_str(), files[i].size, files[i].mtime);
+		if (files[i].content.length()) signature.appendFormatted(":%s", files[i].content.c_str());
+		signature += ";";
+	}
+	return signature;
+}
+
+
+void EntryAttributeIndex::add(const char *type, const char *name, const char *value, long index) {
+	Postings &postings = types[type][name][value];
+	if (postings.empty() || postings.back() < index) postings.push_back(index);
+	else {
+		// re-indexing an edited entry
+		Postings::iterator pos = std::lower_bound(postings.begin(), postings.end(), index);
+		if (pos == postings.end() || *pos != index) postings.insert(pos, index);
+	}
+}
+
+
+void EntryAttributeIndex::remove(const Postings &indices) {
+	for (TypeMap::iterator t = types.begin(); t != types.end();) {
+		for (NameMap::iterator n = t->second.begin(); n != t->second.end();) {
+			for (ValueMap::iterator v = n->second.begin(); v != n->second.end();) {
+				Postings &postings = v->second;
+				Postings kept;
+				kept.reserve(postings.size());
+				std::set_difference(postings.begin(), postings.end(), indices.begin(), indices.end(), std::back_inserter(kept));
+				if (kept.size() != postings.size()) postings.swap(kept);
+				if (postings.empty()) n->second.erase(v++);
+				else ++v;
+			}
+			if (n->second.empty()) t->second.erase(n++);
+			else ++n;
+		}
+		if (t->second.empty()) types.erase(t++);
+		else ++t;
+	}
+}
+
+
+void EntryAttributeIndex::clear() {
+	types.clear();
+	signature = "";
+}
+
+
+signed char EntryAttributeIndex::save() {
+	signature = getDataSignature(dataPath);
+
+	SWBuf out;
+	out.append(MAGIC);
+	putU32(out, VERSION);
+	putStr(out, signature);
+	putU32(out, (SW_u32)types.size());
+	for (TypeMap::const_iterator t = types.begin(); t != types.end(); ++t) {
+		putStr(out, t->first);
+		putU32(out, (SW_u32)t->second.size());
+		for (NameMap::const_iterator n = t->second.begin(); n != t->second.end(); ++n) {
+			putStr(out, n->first);
+			putU32(out, (SW_u32)n->second.size());
+			for (ValueMap::const_iterator v = n->second.begin(); v != n->second.end(); ++v) {
+				putStr(out, v->first);
+				putU32(out, (SW_u32)v->second.size());
+				long last = 0;
+				for (Postings::const_iterator p = v->second.begin(); p != v->second.end(); ++p) {
+					putVarint(out, (unsigned long)(*p - last));
+					last = *p;
+				}
+			}
+		}
+	}
+
+	// write aside and move into place so a reader never sees half an index
+	SWBuf path = getIndexPath(dataPath);
+	SWBuf tmpPath = path + ".tmp";
+	int fd = FileMgr::openFile(tmpPath, FileMgr::CREAT|FileMgr::WRONLY|FileMgr::TRUNC, FileMgr::IREAD|FileMgr::IWRITE);
+	if (fd < 0) return -1;
+	long written = FileMgr::write(fd, out.c_str(), out.length());
+	FileMgr::closeFile(fd);
+	if (written != (long)out.length()) {
+		FileMgr::removeFile(tmpPath);
+		return -1;
+	}
+	FileMgr::removeFile(path);
+	if (rename(tmpPath, path)) {
+		FileMgr::removeFile(tmpPath);
+		return -1;
+	}
+	return 0;
+}
+
+
+bool EntryAttributeIndex::load() {
+	clear();
+
+	SWBuf path = getIndexPath(dataPath);
+	if (!FileMgr::existsFile(path)) return false;
+
+	FileDesc *fd = FileMgr::getSystemFileMgr()->open(path, FileMgr::RDONLY);
+	if (!fd || fd->getFd() < 0) {
+		FileMgr::getSystemFileMgr()->close(fd);
+		return false;
+	}
+	long size = fd->seek(0, SEEK_END);
+	fd->seek(0, SEEK_SET);
+	SWBuf buf;
+	buf.setSize(size > 0 ? size : 0);
+	long got = (size > 0) ? fd->read(buf.getRawData(), size) : 0;
+	FileMgr::getSystemFileMgr()->close(fd);
+	if (got != size || size < 8 || memcmp(buf.c_str(), MAGIC, 4)) return false;
+
+	Reader in(buf.c_str() + 4, size - 4);
+	if (in.getU32() != VERSION) return false;
+	SWBuf sig = in.getStr();
+	SW_u32 typeCount = in.getU32();
+	for (SW_u32 t = 0; in.ok && t < typeCount; ++t) {
+		NameMap &names = types[in.getStr()];
+		SW_u32 nameCount = in.getU32();
+		for (SW_u32 n = 0; in.ok && n < nameCount; ++n) {
+			ValueMap &values = names[in.getStr()];
+			SW_u32 valueCount = in.getU32();
+			for (SW_u32 v = 0; in.ok && v < valueCount; ++v) {
+				Postings &postings = values[in.getStr()];
+				SW_u32 count = in.getU32();
+				if (!in.ok) break;
+				postings.reserve(count);
+				long last = 0;
+				for (SW_u32 p = 0; in.ok && p < count; ++p) {
+					last += (long)in.getVarint();
+					postings.push_back(last);
+				}
+			}
+		}
+	}
+	if (!in.ok) {
+		clear();
+		return false;
+	}
+	signature = sig;
+	return true;
+}
+
+
+bool EntryAttributeIndex::isCurrent() const {
+	return signature.length() && (signature == getDataSignature(dataPath));
+}
+
+
+void EntryAttributeIndex::find(const char *type, const char *name, bool includeComponents, const char *value, bool matchWholeEntry, bool icase, Postings &results) const {
+	results.clear();
+
+	TypeMap::const_iterator tStart = types.begin(), tEnd = types.end();
+	if (type && *type) {
+		tStart = types.find(type);
+		tEnd = tStart;
+		if (tEnd != types.end()) ++tEnd;
+	}
+	for (; tStart != tEnd; ++tStart) {
+		const NameMap &names = tStart->second;
+		NameMap::const_iterator nStart = names.begin(), nEnd = names.end();
+		if (name && *name && !includeComponents) {
+			nStart = names.find(name);
+			nEnd = nStart;
+			if (nEnd != names.end()) ++nEnd;
+		}
+		for (; nStart != nEnd; ++nStart) {
+			if (name && *name && includeComponents && !componentMatches(nStart->first, name)) continue;
+			const ValueMap &values = nStart->second;
+			for (ValueMap::const_iterator v = values.begin(); v != values.end(); ++v) {
+				if (valueMatches(v->first, value, matchWholeEntry, icase)) {
+					results.insert(results.end(), v->second.begin(), v->second.end());
+				}
+			}
+		}
+	}
+	std::sort(results.begin(), results.end());
+	results.erase(std::unique(results.begin(), results.end()), results.end());
+}
+
+
+SWORD_NAMESPACE_END
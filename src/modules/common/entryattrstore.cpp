@@ -0,0 +1,250 @@
+/******************************************************************************
+ *
+ *  entryattrstore.cpp -	EntryAttributeStore: the entry attributes of a
+ *				module's current entry
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <entryattrstore.h>
+
+#include <string.h>
+
+
+SWORD_NAMESPACE_START
+
+namespace {
+
+	// FNV-1a
+	unsigned int hashName(const char *text) {
+		unsigned int hash = 2166136261U;
+		for (const unsigned char *c = (const unsigned char *)text; *c; ++c) {
+			hash ^= *c;
+			hash *= 16777619U;
+		}
+		return hash;
+	}
+
+	unsigned int hashKey(int type, int item, int name) {
+		unsigned int hash = (unsigned int)type * 2654435761U;
+		hash ^= (unsigned int)item * 2246822519U;
+		hash ^= (unsigned int)name * 3266489917U;
+		return hash ^ (hash >> 15);
+	}
+}
+
+
+EntryAttributeStore::EntryAttributeStore() : slotCount(0), stamp(1) {
+}
+
+
+int EntryAttributeStore::lookUp(const char *text) const {
+	if (nameSlots.empty()) return -1;
+	unsigned long mask = nameSlots.size() - 1;
+	for (unsigned long i = hashName(text) & mask; ; i = (i + 1) & mask) {
+		int id = nameSlots[i] - 1;
+		if (id < 0) return -1;
+		if (!strcmp(names[id].c_str(), text)) return id;
+	}
+}
+
+
+int EntryAttributeStore::intern(const char *text) {
+	int id = lookUp(text);
+	if (id >= 0) return id;
+
+	if ((names.size() + 1) * 2 > nameSlots.size()) {
+		nameSlots.assign(nameSlots.size() ? nameSlots.size() * 2 : 64, 0);
+		unsigned long mask = nameSlots.size() - 1;
+		for (unsigned long n = 0; n < names.size(); ++n) {
+			unsigned long i = hashName(names[n].c_str()) & mask;
+			while (nameSlots[i]) i = (i + 1) & mask;
+			nameSlots[i] = (int)n + 1;
+		}
+	}
+
+	names.push_back(text);
+	unsigned long mask = nameSlots.size() - 1;
+	unsigned long i = hashName(text) & mask;
+	while (nameSlots[i]) i = (i + 1) & mask;
+	nameSlots[i] = (int)names.size();
+	return (int)names.size() - 1;
+}
+
+
+const EntryAttributeStore::Slot *EntryAttributeStore::findSlot(int type, int item, int name) const {
+	if (slots.empty()) return 0;
+	unsigned long mask = slots.size() - 1;
+	for (unsigned long i = hashKey(type, item, name) & mask; ; i = (i + 1) & mask) {
+		const Slot &slot = slots[i];
+		if (slot.stamp != stamp) return 0;
+		if (slot.type == type && slot.item == item && slot.name == name) return &slot;
+	}
+}
+
+
+// the table must have room; see set()
+void EntryAttributeStore::addSlot(int type, int item, int name, unsigned long index) {
+	unsigned long mask = slots.size() - 1;
+	unsigned long i = hashKey(type, item, name) & mask;
+	while (slots[i].stamp == stamp) i = (i + 1) & mask;
+	Slot &slot = slots[i];
+	slot.stamp = stamp;
+	slot.type = type;
+	slot.item = item;
+	slot.name = name;
+	slot.index = index;
+	++slotCount;
+}
+
+
+void EntryAttributeStore::growSlots() {
+	Slot empty;
+	empty.stamp = 0;
+	slots.assign(slots.size() ? slots.size() * 2 : 64, empty);
+	stamp = 1;
+	slotCount = 0;
+	for (unsigned long i = 0; i < attributes.size(); ++i) {
+		const Attribute &a = attributes[i];
+		addSlot(a.type, a.item, a.name, i);
+		if (a.firstOfItem) addSlot(a.type, a.item, -1, i);
+	}
+}
+
+
+unsigned long EntryAttributeStore::storeValue(const char *value, unsigned long length) {
+	unsigned long offset = values.size();
+	// the value may be one of ours, which growing the buffer could move
+	long from = (!values.empty() && value >= &values[0] && value < &values[0] + values.size()) ? (long)(value - &values[0]) : -1;
+	values.resize(offset + length + 1);
+	if (length) memmove(&values[offset], (from >= 0) ? &values[from] : value, length);
+	values[offset + length] = 0;
+	return offset;
+}
+
+
+void EntryAttributeStore::clear() {
+	attributes.clear();
+	values.clear();
+	slotCount = 0;
+	if (!++stamp) {
+		for (unsigned long i = 0; i < slots.size(); ++i) slots[i].stamp = 0;
+		stamp = 1;
+	}
+}
+
+
+void EntryAttributeStore::set(const char *type, const char *item, const char *name, const char *value, long length) {
+	if (!value) value = "";
+	unsigned long len = (length < 0) ? strlen(value) : (unsigned long)length;
+	int t = intern(type), it = intern(item), n = intern(name);
+
+	const Slot *slot = findSlot(t, it, n);
+	if (slot) {
+		Attribute &a = attributes[slot->index];
+		if (len <= a.length) {
+			memmove(&values[a.value], value, len);
+			values[a.value + len] = 0;
+		}
+		else a.value = storeValue(value, len);
+		a.length = len;
+		return;
+	}
+
+	// room for this attribute and perhaps its item
+	if ((slotCount + 2) * 2 > slots.size()) growSlots();
+
+	Attribute a;
+	a.type = t;
+	a.item = it;
+	a.name = n;
+	a.firstOfItem = !findSlot(t, it, -1);
+	a.value = storeValue(value, len);
+	a.length = len;
+	attributes.push_back(a);
+	addSlot(t, it, n, attributes.size() - 1);
+	if (a.firstOfItem) addSlot(t, it, -1, attributes.size() - 1);
+}
+
+
+void EntryAttributeStore::append(const char *type, const char *item, const char *name, const char *value, long length) {
+	if (!value) value = "";
+	unsigned long len = (length < 0) ? strlen(value) : (unsigned long)length;
+	int t = lookUp(type), it = lookUp(item), n = lookUp(name);
+	const Slot *slot = (t >= 0 && it >= 0 && n >= 0) ? findSlot(t, it, n) : 0;
+	if (!slot) {
+		set(type, item, name, value, (long)len);
+		return;
+	}
+
+	Attribute &a = attributes[slot->index];
+	if (a.value + a.length + 1 != values.size()) {
+		// not last in the buffer, so move it there first
+		a.value = storeValue(&values[a.value], a.length);
+	}
+	values.pop_back();	// its terminator
+	storeValue(value, len);
+	a.length += len;
+}
+
+
+const char *EntryAttributeStore::get(const char *type, const char *item, const char *name) const {
+	int t = lookUp(type), it = lookUp(item), n = lookUp(name);
+	if (t < 0 || it < 0 || n < 0) return 0;
+	const Slot *slot = findSlot(t, it, n);
+	return slot ? &values[attributes[slot->index].value] : 0;
+}
+
+
+unsigned long EntryAttributeStore::find(const char *type, const char *item, const char *name, unsigned long from) const {
+	int t = -1, it = -1, n = -1;
+	if ((type && (t = lookUp(type)) < 0) || (item && (it = lookUp(item)) < 0) || (name && (n = lookUp(name)) < 0)) {
+		return getCount();
+	}
+	for (unsigned long i = from; i < attributes.size(); ++i) {
+		const Attribute &a = attributes[i];
+		if ((t < 0 || a.type == t) && (it < 0 || a.item == it) && (n < 0 || a.name == n)) return i;
+	}
+	return getCount();
+}
+
+
+void EntryAttributeStore::copyTo(AttributeTypeList &map) const {
+	map.clear();
+	for (unsigned long i = 0; i < attributes.size(); ++i) {
+		const Attribute &a = attributes[i];
+		SWBuf &value = map[names[a.type]][names[a.item]][names[a.name]];
+		value.setSize(a.length);
+		if (a.length) memcpy(value.getRawData(), &values[a.value], a.length);
+	}
+}
+
+
+void EntryAttributeStore::assign(const AttributeTypeList &map) {
+	clear();
+	for (AttributeTypeList::const_iterator type = map.begin(); type != map.end(); ++type) {
+		for (AttributeList::const_iterator item = type->second.begin(); item != type->second.end(); ++item) {
+			for (AttributeValue::const_iterator name = item->second.begin(); name != item->second.end(); ++name) {
+				set(type->first, item->first, name->first, name->second.c_str(), (long)name->second.length());
+			}
+		}
+	}
+}
+
+
+SWORD_NAMESPACE_END
@@ -23,6 +23,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <vector>
 #include <lzsscomprs.h>
 
 // The following are constant sizes used by the compression algorithm.
@@ -49,79 +50,92 @@
 //
 // Note that the 12 bits used to store the position and the 4 bits
 // used to store the length equal a total of 16 bits, or 2 bytes.
+//
+// The compressed stream is a flag byte, whose bits (low bit first) say
+// whether each of the next eight units is a single unencoded byte (1) or
+// a <position,length> pair (0), then those units, and so on.  A position
+// is a place in the ring buffer of the original implementation: the ring
+// starts with N - F spaces and the first byte of text is written at
+// N - F.  Neither the encoder nor the decoder here keeps a ring; both
+// work on the whole text, and translate positions to and from distances
+// back from the current byte, so streams from either implementation read
+// the same with the other.
 
 #define N		4096
 #define F		18
 #define THRESHOLD	3
-#define NOT_USED	N
+
+// the farthest back a match is taken from, as the original encoder did
+#define MAX_DISTANCE	(N - F)
+
+#define HASH_BITS	13
+
+
+using std::vector;
 
 
 SWORD_NAMESPACE_START
 
-class LZSSCompress::Private {
-public:
-	static unsigned char m_ring_buffer[N + F - 1];
-	static short int m_match_position;
-	static short int m_match_length;
-	static short int m_lson[N + 1];
-	static short int m_rson[N + 257];
-	static short int m_dad[N + 1];
-	void InitTree();
-	void InsertNode(short int Pos);
-	void DeleteNode(short int Node);
-};
+namespace {
+
+	// reads everything getChars() gives into in, returning its length
+	unsigned long readAll(SWCompress *comp, vector<unsigned char> &in) {
+		const unsigned long CHUNK = 16384;
+		unsigned long len = 0;
+		for (;;) {
+			if (in.size() < len + CHUNK) in.resize((len + CHUNK) * 2);
+			unsigned long got = comp->getChars((char *)&in[len], CHUNK);
+			len += got;
+			if (got < CHUNK) break;
+		}
+		return len;
+	}
 
-/******************************************************************************
- * LZSSCompress Statics
- */
 
-// m_ring_buffer is a text buffer.  It contains "nodes" of
-// uncompressed text that can be indexed by position.  That is,
-// a substring of the ring buffer can be indexed by a position
-// and a length.  When decoding, the compressed text may contain
-// a position in the ring buffer and a count of the number of
-// bytes from the ring buffer that are to be moved into the
-// uncompressed buffer.  
-//
-// This ring buffer is not maintained as part of the compressed
-// text.  Instead, it is reconstructed dynamically.  That is,
-// it starts out empty and gets built as the text is decompressed.
-//
-// The ring buffer contain N bytes, with an additional F - 1 bytes
-// to facilitate string comparison.
+	inline unsigned int hash3(const unsigned char *c) {
+		return ((((unsigned int)c[0] << 16) | ((unsigned int)c[1] << 8) | c[2]) * 2654435761U) >> (32 - HASH_BITS);
+	}
 
-unsigned char LZSSCompress::Private::m_ring_buffer[N + F - 1];
 
-// m_match_position and m_match_length are set by InsertNode().
-//
-// These variables indicate the position in the ring buffer 
-// and the number of characters at that position that match
-// a given string.
+	// copies a match len bytes long from dist bytes back; from may overlap
+	// to, in which case bytes copied become the source of those after them.
+	// Writes up to 7 bytes past to + len.
+	inline void copyMatch(unsigned char *to, unsigned int dist, unsigned int len) {
+		const unsigned char *from = to - dist;
+		if (dist >= 8) {
+			for (unsigned int k = 0; k < len; k += 8) {
+				memcpy(to + k, from + k, 8);
+			}
+		}
+		else if (dist == 1) {
+			memset(to, *from, len);
+		}
+		else {
+			for (unsigned int k = 0; k < len; k++) {
+				to[k] = from[k];
+			}
+		}
+	}
+}
 
-short int LZSSCompress::Private::m_match_position;
-short int LZSSCompress::Private::m_match_length;
 
-// m_lson, m_rson, and m_dad are the Japanese way of referring to
-// a tree structure.  The dad is the parent and it has a right and
-// left son (child).
-//
-// For i = 0 to N-1, m_rson[i] and m_lson[i] will be the right 
-// and left children of node i.  
-//
-// For i = 0 to N-1, m_dad[i] is the parent of node i.
-//
-// For i = 0 to 255, rson[N + i + 1] is the root of the tree for 
-// strings that begin with the character i.  Note that this requires 
-// one byte characters.
-//
-// These nodes store values of 0...(N-1).  Memory requirements
-// can be reduces by using 2-byte integers instead of full 4-byte
-// integers (for 32-bit applications).  Therefore, these are 
-// defined as "short ints."
+class LZSSCompress::Private {
+public:
+	int searchDepth;
+
+	// kept between calls so a compressor used for many blocks allocates
+	// only as its blocks grow
+	vector<unsigned char> in;
+	vector<unsigned char> out;
 
-short int LZSSCompress::Private::m_lson[N + 1];
-short int LZSSCompress::Private::m_rson[N + 257];
-short int LZSSCompress::Private::m_dad[N + 1];
+	// hash chains for the encoder: head holds the latest position whose
+	// first THRESHOLD bytes hash to each value, and prev[pos & (N - 1)]
+	// the position before pos with the same hash, or -1
+	vector<int> head;
+	vector<int> prev;
+
+	Private() : searchDepth(0), head(1 << HASH_BITS), prev(N) {}
+};
 
 
 /******************************************************************************
@@ -144,213 +158,28 @@ LZSSCompress::~LZSSCompress() {
 
 
 /******************************************************************************
- * LZSSCompress::InitTree	- This function initializes the tree nodes to
- *							"empty" states. 
+ * LZSSCompress::clone	- a compressor of the same kind, for another thread
  */
 
-void LZSSCompress::Private::InitTree(void) {
-	int  i;
-
-	// For i = 0 to N - 1, m_rson[i] and m_lson[i] will be the right
-	// and left children of node i.  These nodes need not be
-	// initialized.  However, for debugging purposes, it is nice to
-	// have them initialized.  Since this is only used for compression
-	// (not decompression), I don't mind spending the time to do it.
-	//
-	// For the same range of i, m_dad[i] is the parent of node i.
-	// These are initialized to a known value that can represent
-	// a "not used" state.
-	
-	for (i = 0; i < N; i++) {
-		m_lson[i] = NOT_USED;
-		m_rson[i] = NOT_USED;
-		m_dad[i] = NOT_USED;
-	}
-
-	// For i = 0 to 255, m_rson[N + i + 1] is the root of the tree
-	// for strings that begin with the character i.  This is why
-	// the right child array is larger than the left child array.
-	// These are also initialzied to a "not used" state.
-	//
-	// Note that there are 256 of these, one for each of the possible
-	// 256 characters.
-
-	for (i = N + 1; i <= (N + 256); i++) {
-		m_rson[i] = NOT_USED;
-	}
+SWCompress *LZSSCompress::clone() const {
+	LZSSCompress *copy = new LZSSCompress();
+	copy->setLevel(level);
+	copy->setSearchDepth(p->searchDepth);
+	return copy;
 }
 
 
-/******************************************************************************
- * LZSSCompress::InsertNode	- This function inserts a string from the ring
- *							buffer into one of the trees.  It loads the
- *							match position and length member variables
- *							for the longest match.
- *	
- *							The string to be inserted is identified by
- *							the parameter Pos, A full F bytes are
- *							inserted.  So,
- *							m_ring_buffer[Pos ... Pos+F-1]
- *							are inserted.
- *
- *							If the matched length is exactly F, then an
- *							old node is removed in favor of the new one
- *							(because the old one will be deleted
- *							sooner).
- *
- *							Note that Pos plays a dual role.  It is
- *							used as both a position in the ring buffer
- *							and also as a tree node.
- *							m_ring_buffer[Pos] defines a character that
- *							is used to identify a tree node.
- *
- * ENT:	pos	- position in the buffer
- */
-
-void LZSSCompress::Private::InsertNode(short int Pos)
-{
-	short int i;
-	short int p;
-	int cmp;
-	unsigned char * key;
-
-/*
-	ASSERT(Pos >= 0);
-	ASSERT(Pos < N);
-*/
-
-	cmp = 1;
-	key = &(m_ring_buffer[Pos]);
-
-	// The last 256 entries in m_rson contain the root nodes for
-	// strings that begin with a letter.  Get an index for the
-	// first letter in this string.
-
-	p = (short int) (N + 1 + key[0]);
-
-	// Set the left and right tree nodes for this position to "not
-	// used."
-
-	m_lson[Pos] = NOT_USED;
-	m_rson[Pos] = NOT_USED;
-
-	// Haven't matched anything yet.
-
-	m_match_length = 0;
-
-	for ( ; ; ) {
-		if (cmp >= 0) {
-			if (m_rson[p] != NOT_USED) {
-				p = m_rson[p];
-			}
-			else {
-				m_rson[p] = Pos;
-				m_dad[Pos] = p;
-				return;
-			}
-		}
-		else {
-			if (m_lson[p] != NOT_USED) {
-				p = m_lson[p];
-			}
-			else {
-				m_lson[p] = Pos;
-				m_dad[Pos] = p;
-				return;
-			}
-		}
-
-		// Should we go to the right or the left to look for the
-		// next match?
-
-		for (i = 1; i < F; i++) {
-			cmp = key[i] - m_ring_buffer[p + i];
-			if (cmp != 0)
-				break;
-		}
-
-		if (i > m_match_length) {
-			m_match_position = p;
-			m_match_length = i;
-
-			if (i >= F)
-				break;
-		}
-	}
-
-	m_dad[Pos] = m_dad[p];
-	m_lson[Pos] = m_lson[p];
-	m_rson[Pos] = m_rson[p];
-
-	m_dad[ m_lson[p] ] = Pos;
-	m_dad[ m_rson[p] ] = Pos;
-
-	if (m_rson[ m_dad[p] ] == p) {
-		m_rson[ m_dad[p] ] = Pos;
-	}
-	else {
-		m_lson[ m_dad[p] ] = Pos;
-	}
-
-	// Remove "p"
-
-	m_dad[p] = NOT_USED;
+void LZSSCompress::setSearchDepth(int depth) {
+	p->searchDepth = (depth > 0) ? depth : 0;
 }
 
 
-/******************************************************************************
- * LZSSCompress::DeleteNode	- This function removes the node "Node" from the
- *							tree.
- *
- * ENT:	node	- node to be removed
- */
-
-void LZSSCompress::Private::DeleteNode(short int Node)
-{
-	short int  q;
-
-/*
-	ASSERT(Node >= 0);
-	ASSERT(Node < (N+1));
-*/
-
-	if (m_dad[Node] == NOT_USED) { // not in tree, nothing to do
-		return;
-	}
-
-	if (m_rson[Node] == NOT_USED) {
-		q = m_lson[Node];
-	}
-	else if (m_lson[Node] == NOT_USED) {
-		q = m_rson[Node];
-	}
-	else {
-		q = m_lson[Node];
-		if (m_rson[q] != NOT_USED) {
-			do {
-				q = m_rson[q];
-			} while (m_rson[q] != NOT_USED);
-
-			m_rson[ m_dad[q] ] = m_lson[q];
-			m_dad[ m_lson[q] ] = m_dad[q];
-			m_lson[q] = m_lson[Node];
-			m_dad[ m_lson[Node] ] = q;
-		}
-
-		m_rson[q] = m_rson[Node];
-		m_dad[ m_rson[Node] ] = q;
-	}
-
-	m_dad[q] = m_dad[Node];
-
-	if (m_rson[ m_dad[Node] ] == Node) {
-		m_rson[ m_dad[Node] ] = q;
-	}
-	else {
-		m_lson[ m_dad[Node] ] = q;
-	}
-
-	m_dad[Node] = NOT_USED;
+int LZSSCompress::getSearchDepth() const {
+	if (p->searchDepth) return p->searchDepth;
+	if (level < 1) return 4;
+	if (level <= 7) return 2 << level;
+	if (level == 8) return 1024;
+	return N;
 }
 
 
@@ -366,234 +195,82 @@ void LZSSCompress::Private::DeleteNode(short int Node)
 
 void LZSSCompress::encode(void)
 {
-	short int i;						// an iterator
-	short int r;						// node number in the binary tree
-	short int s;						// position in the ring buffer
-	unsigned short int len;			 // len of initial string
-	short int last_match_length;		// length of last match
-	short int code_buf_pos;			 // position in the output buffer
-	unsigned char code_buf[17];		 // the output buffer
-	unsigned char mask;				 // bit mask for byte 0 of out buf
-	unsigned char c;					// character read from string
-
-	// Start with a clean tree.
-
-	p->InitTree();
 	direct = 0;	// set direction needed by parent [Get|Send]Chars()
 
-	// code_buf[0] works as eight flags.  A "1" represents that the
-	// unit is an unencoded letter (1 byte), and a "0" represents
-	// that the next unit is a <position,length> pair (2 bytes).
-	//
-	// code_buf[1..16] stores eight units of code.  Since the best
-	// we can do is store eight <position,length> pairs, at most 16 
-	// bytes are needed to store this.
-	//
-	// This is why the maximum size of the code buffer is 17 bytes.
-
-	code_buf[0] = 0;
-	code_buf_pos = 1;
-
-	// Mask iterates over the 8 bits in the code buffer.  The first
-	// character ends up being stored in the low bit.
-	//
-	//  bit   8   7   6   5   4   3   2   1
-	//		|						   |
-	//		|			 first sequence in code buffer
-	//		|
-	//	  last sequence in code buffer		
-
-	mask = 1;
-
-	s = 0;
-	r = (short int) N - (short int) F;
-
-	// Initialize the ring buffer with spaces...
-
-	// Note that the last F bytes of the ring buffer are not filled.
-	// This is because those F bytes will be filled in immediately
-	// with bytes from the input stream.
-
-	memset(p->m_ring_buffer, ' ', N - F);
-	
-	// Read F bytes into the last F bytes of the ring buffer.
-	//
-	// This function loads the buffer with X characters and returns
-	// the actual amount loaded.
-
-	len = getChars((char *) &(p->m_ring_buffer[r]), F);
-
-	// Make sure there is something to be compressed.
-
-	if (len == 0)
-		return;
-
-	// Insert the F strings, each of which begins with one or more
-	// 'space' characters.  Note the order in which these strings
-	// are inserted.  This way, degenerate trees will be less likely
-	// to occur.
-
-	for (i = 1; i <= F; i++) {
-		p->InsertNode((short int) (r - i));
-	}
-
-	// Finally, insert the whole string just read.  The
-	// member variables match_length and match_position are set.
-
-	p->InsertNode(r);
-
-	// Now that we're preloaded, continue till done.
-
-	do {
-
-		// m_match_length may be spuriously long near the end of
-		// text.
-
-		if (p->m_match_length > len) {
-			p->m_match_length = len;
-		}
-
-		// Is it cheaper to store this as a single character?  If so,
-		// make it so.
-
-		if (p->m_match_length < THRESHOLD) {
-			// Send one character.  Remember that code_buf[0] is the
-			// set of flags for the next eight items.
-
-			p->m_match_length = 1;	 
-			code_buf[0] |= mask;  
-			code_buf[code_buf_pos++] = p->m_ring_buffer[r];
-		}
-
-		// Otherwise, we do indeed have a string that can be stored
-		// compressed to save space.
-
-		else {
-			// The next 16 bits need to contain the position (12 bits)
-			// and the length (4 bits).
-
-			code_buf[code_buf_pos++] = (unsigned char) p->m_match_position;
-			code_buf[code_buf_pos++] = (unsigned char) (
-				((p->m_match_position >> 4) & 0xf0) | 
-				(p->m_match_length - THRESHOLD) );
+	unsigned long len = readAll(this, p->in);
+	const unsigned char *text = &p->in[0];
+
+	// every eight units cost at most a flag byte and eight bytes more than
+	// the text they stand for
+	unsigned long outSize = len + len / 8 + 2;
+	if (p->out.size() < outSize) p->out.resize(outSize);
+	unsigned char *out = &p->out[0];
+	unsigned long outPos = 0;
+
+	int *head = &p->head[0];
+	int *prev = &p->prev[0];
+	memset(head, 0xff, sizeof(int) << HASH_BITS);	// all -1
+
+	const int depth = getSearchDepth();
+
+	unsigned long flagPos = 0;
+	unsigned char mask = 0;
+
+	unsigned long i = 0;
+	while (i < len) {
+		unsigned long maxLength = (len - i < F) ? len - i : F;
+		unsigned long matchLength = 0;
+		unsigned long matchPosition = 0;
+
+		if (maxLength >= THRESHOLD) {
+			const unsigned char *key = text + i;
+			unsigned int h = hash3(key);
+			long limit = (i > MAX_DISTANCE) ? (long)(i - MAX_DISTANCE) : 0;
+			int chain = depth;
+			for (long cand = head[h]; cand >= limit && chain--; cand = prev[cand & (N - 1)]) {
+				const unsigned char *c = text + cand;
+				// can't beat the best so far without matching one byte more
+				if (c[matchLength] != key[matchLength] || c[0] != key[0]) continue;
+				unsigned long l = 1;
+				while (l < maxLength && c[l] == key[l]) l++;
+				if (l > matchLength) {
+					matchLength = l;
+					matchPosition = cand;
+					if (l == maxLength) break;
+				}
+			}
 		}
 
-		// Shift the mask one bit to the left so that it will be ready
-		// to store the new bit.
-
-		mask = (unsigned char) (mask << 1);
-
-		// If the mask is now 0, then we know that we have a full set
-		// of flags and items in the code buffer.  These need to be
-		// output.
-
 		if (!mask) {
-			// code_buf is the buffer of characters to be output.
-			// code_buf_pos is the number of characters it contains.
-
-			sendChars((char *) code_buf, code_buf_pos);
-
-			// Reset for next buffer...
-
-			code_buf[0] = 0;
-			code_buf_pos = 1;
+			flagPos = outPos++;
+			out[flagPos] = 0;
 			mask = 1;
 		}
 
-		last_match_length = p->m_match_length;
-
-		// Delete old strings and read new bytes...
-
-		for (i = 0; i < last_match_length; i++) {
-			// Get next character...
-
-			if (getChars((char *) &c, 1) != 1)
-				break;
-
-			// Delete "old strings"
-
-			p->DeleteNode(s);
-
-			// Put this character into the ring buffer.
-			//		  
-			// The original comment here says "If the position is near
-			// the end of the buffer, extend the buffer to make
-			// string comparison easier."
-			//
-			// That's a little misleading, because the "end" of the 
-			// buffer is really what we consider to be the "beginning"
-			// of the buffer, that is, positions 0 through F.
-			//
-			// The idea is that the front end of the buffer is duplicated
-			// into the back end so that when you're looking at characters
-			// at the back end of the buffer, you can index ahead (beyond
-			// the normal end of the buffer) and see the characters
-			// that are at the front end of the buffer wihtout having
-			// to adjust the index.
-			//
-			// That is...
-			//
-			//	  1234xxxxxxxxxxxxxxxxxxxxxxxxxxxxx1234
-			//	  |							   |  |
-			//	  position 0		  end of buffer  |
-			//										 |
-			//				  duplicate of front of buffer
-
-			p->m_ring_buffer[s] = c;
-
-			if (s < F - 1) {
-				p->m_ring_buffer[s + N] = c;
-			}
-
-			// Increment the position, and wrap around when we're at
-			// the end.  Note that this relies on N being a power of 2.
-
-			s = (short int) ( (s + 1) & (N - 1) );
-			r = (short int) ( (r + 1) & (N - 1) );
-
-			// Register the string that is found in 
-			// m_ring_buffer[r..r+F-1].
-
-			p->InsertNode(r);
+		if (matchLength < THRESHOLD) {
+			matchLength = 1;
+			out[flagPos] |= mask;
+			out[outPos++] = text[i];
 		}
-
-		// If we didn't quit because we hit the last_match_length,
-		// then we must have quit because we ran out of characters
-		// to process.
-
-		while (i++ < last_match_length) {							  
-			p->DeleteNode(s);
-
-			s = (short int) ( (s + 1) & (N - 1) );
-			r = (short int) ( (r + 1) & (N - 1) );
-
-			// Note that len hitting 0 is the key that causes the
-			// do...while() to terminate.  This is the only place
-			// within the loop that len is modified.
-			//
-			// Its original value is F (or a number less than F for
-			// short strings).
-
-			if (--len) {
-				p->InsertNode(r);	   /* buffer may not be empty. */
+		else {
+			// where the original encoder's ring held the match
+			unsigned int position = (unsigned int)((matchPosition + N - F) & (N - 1));
+			out[outPos++] = (unsigned char)position;
+			out[outPos++] = (unsigned char)(((position >> 4) & 0xf0) | (matchLength - THRESHOLD));
+		}
+		mask = (unsigned char)(mask << 1);
+
+		// register each string the unit covered
+		for (unsigned long end = i + matchLength; i < end; i++) {
+			if (i + THRESHOLD <= len) {
+				unsigned int h = hash3(text + i);
+				prev[i & (N - 1)] = head[h];
+				head[h] = (int)i;
 			}
 		}
-
-		// End of do...while() loop.  Continue processing until there
-		// are no more characters to be compressed.  The variable
-		// "len" is used to signal this condition.
-	} while (len > 0);
-
-	// There could still be something in the output buffer.  Send it
-	// now.
-
-	if (code_buf_pos > 1) {
-		// code_buf is the encoded string to send.
-		// code_buf_ptr is the number of characters.
-
-		sendChars((char *) code_buf, code_buf_pos);
 	}
 
+	if (outPos) sendChars((char *)out, outPos);
 
 	// must set zlen for parent class to know length of compressed buffer
 	zlen = zpos;
@@ -610,123 +287,61 @@ void LZSSCompress::encode(void)
 
 void LZSSCompress::decode(void)
 {
-	int k;
-	int r;							  // node number
-	unsigned char c[F];				 // an array of chars
-	unsigned char flags;				// 8 bits of flags
-	int flag_count;					 // which flag we're on
-	short int pos;					  // position in the ring buffer
-	short int len;					  // number of chars in ring buffer
-	unsigned long totalLen = 0;
-
 	direct = 1;	// set direction needed by parent [Get|Send]Chars()
 
-	// Initialize the ring buffer with a common string.
-	//
-	// Note that the last F bytes of the ring buffer are not filled.
-
-	memset(p->m_ring_buffer, ' ', N - F);
-	
-	r = N - F;
-
-	flags = (char) 0;
-	flag_count = 0;
-
-	for ( ; ; ) {
-
-		// If there are more bits of interest in this flag, then
-		// shift that next interesting bit into the 1's position.
-		//
-		// If this flag has been exhausted, the next byte must 
-		// be a flag.
-
-		if (flag_count > 0) {
-			flags = (unsigned char) (flags >> 1);
-			flag_count--;
-		}
-		else {
-			// Next byte must be a flag.
-
-			if (getChars((char *) &flags, 1) != 1)
-				break;
-
-			// Set the flag counter.  While at first it might appear
-			// that this should be an 8 since there are 8 bits in the
-			// flag, it should really be a 7 because the shift must
-			// be performed 7 times in order to see all 8 bits.
-
-			flag_count = 7;
+	unsigned long len = readAll(this, p->in);
+	const unsigned char *in = &p->in[0];
+	const unsigned char *inEnd = in + len;
+
+	// the text is written after N bytes standing for the starting ring: a
+	// match reaching back before the text reads the N - F spaces the ring
+	// starts with, preceded by the F bytes at its end which are not yet
+	// written (0 here).  Room is kept after the text for a flag byte's
+	// worth of units and copyMatch()'s overrun.
+	const unsigned long SLACK = 8 * F + 8;
+	unsigned long capacity = len * 4 + SLACK;
+	if (p->out.size() < N + capacity) p->out.resize(N + capacity);
+	memset(&p->out[0], 0, F);
+	memset(&p->out[F], ' ', N - F);
+	unsigned char *text = &p->out[N];
+	unsigned long textLen = 0;
+
+	while (in < inEnd) {
+		if (textLen + SLACK > capacity) {
+			capacity *= 2;
+			p->out.resize(N + capacity);
+			text = &p->out[N];
 		}
 
-		// If the low order bit of the flag is now set, then we know
-		// that the next byte is a single, unencoded character.
-
-		if (flags & 1) {
-			if (getChars((char *) c, 1) != 1)
-				break;
-
-			if (sendChars((char *) c, 1) != 1) {
-				break;
-			}
-			totalLen++;
-
-			// Add to buffer, and increment to next spot. Wrap at end.
-
-			p->m_ring_buffer[r] = c[0];
-			r = (short int) ( (r + 1) & (N - 1) );
-		}
-
-		// Otherwise, we know that the next two bytes are a
-		// <position,length> pair.  The position is in 12 bits and
-		// the length is in 4 bits.
-
-		else {
-			// Original code:
-			//  if ((i = getc(infile)) == EOF)
-			//	  break;
-			//  if ((j = getc(infile)) == EOF)
-			//	  break;
-			//  i |= ((j & 0xf0) << 4);	
-			//  j = (j & 0x0f) + THRESHOLD;
-			//
-			// I've modified this to only make one input call, and
-			// have changed the variable names to something more
-			// obvious.
-
-			if (getChars((char *) c, 2) != 2)
-				break;
-
-			// Convert these two characters into the position and
-			// length.  Note that the length is always at least
-			// THRESHOLD, which is why we're able to get a length
-			// of 18 out of only 4 bits.
-
-			pos = (short int) ( c[0] | ((c[1] & 0xf0) << 4) );
-
-			len = (short int) ( (c[1] & 0x0f) + THRESHOLD );
-
-			// There are now "len" characters at position "pos" in
-			// the ring buffer that can be pulled out.  Note that
-			// len is never more than F.
-
-			for (k = 0; k < len; k++) {
-				c[k] = p->m_ring_buffer[(pos + k) & (N - 1)];
+		unsigned char flags = *in++;
 
-				// Add to buffer, and increment to next spot. Wrap at end.
-
-				p->m_ring_buffer[r] = c[k];
-				r = (short int) ( (r + 1) & (N - 1) );
+		for (int unit = 0; unit < 8; unit++, flags >>= 1) {
+			if (flags & 1) {
+				if (in >= inEnd) break;
+				text[textLen++] = *in++;
 			}
-
-			// Add the "len" :characters to the output stream.
-
-			if (sendChars((char *) c, len) != (unsigned int)len) {
-				break;
+			else {
+				if (inEnd - in < 2) {
+					in = inEnd;
+					break;
+				}
+				unsigned int position = in[0] | ((in[1] & 0xf0) << 4);
+				unsigned int matchLength = (in[1] & 0x0f) + THRESHOLD;
+				in += 2;
+
+				// back from where the original decoder's ring was
+				// about to be written; 0 is the byte it overwrites
+				unsigned int dist = (unsigned int)((textLen + N - F - position) & (N - 1));
+				if (!dist) dist = N;
+
+				copyMatch(text + textLen, dist, matchLength);
+				textLen += matchLength;
 			}
-			totalLen += len;
 		}
 	}
-	slen = totalLen;
+
+	if (textLen) sendChars((char *)text, textLen);
+	slen = textLen;
 }
 
 SWORD_NAMESPACE_END
@@ -37,6 +37,9 @@
 #include <swbuf.h>
 #include <stringmgr.h>
 
+#include <vector>
+#include <algorithm>
+
 SWORD_NAMESPACE_START
 
 /******************************************************************************
@@ -61,6 +64,7 @@ RawStr4::RawStr4(const char *ipath, int fileMode, bool caseSensitive) : caseSens
 	SWBuf buf;
 
 	lastoff = -1;
+	build = 0;
 	path = 0;
 	stdstr(&path, ipath);
 
@@ -90,6 +94,8 @@ SWLOGD("Couldn't open file: %s. errno: %d", buf.c_str(), errno);
 
 RawStr4::~RawStr4()
 {
+	endBuild();
+
 	if (path)
 		delete [] path;
 
@@ -389,6 +395,15 @@ void RawStr4::doSetText(const char *ikey, const char *buf, long len) {
 	char *outbuf = 0;
 	char *ch = 0;
 
+	if (build) {
+		len = (len < 0) ? strlen(buf) : len;
+		if (len > 0) {
+			addBuildText(ikey, buf, len);
+			return;
+		}
+		flushBuild();	// deleting works on the index as it stands
+	}
+
 	char errorStatus = findOffset(ikey, &start, &size, 0, &idxoff);
 	stdstr(&key, ikey, 3);
 	if (!caseSensitive) toupperstr_utf8(key, (unsigned int)(strlen(key)*3));
@@ -536,4 +551,135 @@ signed char RawStr4::createModule(const char *ipath)
 	return 0;
 }
 
+
+/******************************************************************************
+ * RawStr4::Build	- index entries held back while building
+ */
+
+struct RawStr4::Build {
+	struct Entry {
+		size_t key;		// offset of the key in keys
+		SW_u32 start;
+		SW_u32 size;
+	};
+	std::vector<char> keys;		// every key, 0 terminated
+	std::vector<Entry> entries;
+
+	struct KeyBefore {
+		const char *keys;
+		KeyBefore(const char *keys) : keys(keys) {}
+		bool operator ()(const Entry &a, const Entry &b) const { return strcmp(keys + a.key, keys + b.key) < 0; }
+	};
+	const char *getKey(const Entry &entry) const { return &keys[entry.key]; }
+};
+
+
+void RawStr4::beginBuild() {
+	if (!build) build = new Build();
+}
+
+
+void RawStr4::endBuild() {
+	flushBuild();
+	delete build;
+	build = 0;
+}
+
+
+/******************************************************************************
+ * RawStr4::addBuildText	- appends an entry to the data file, holding back
+ *				its index entry
+ */
+
+void RawStr4::addBuildText(const char *ikey, const char *buf, long len) {
+	char *key = 0;
+	stdstr(&key, ikey, 3);
+	if (!caseSensitive) toupperstr_utf8(key, (unsigned int)(strlen(key)*3));
+
+	char *outbuf = new char [ len + strlen(key) + 5 ];
+	sprintf(outbuf, "%s%c%c", key, 13, 10);
+	SW_u32 size = (SW_u32)strlen(outbuf);
+	memcpy(outbuf + size, buf, len);
+	size = size + (SW_u32)len;
+
+	Build::Entry entry;
+	entry.key = build->keys.size();
+	build->keys.insert(build->keys.end(), key, key + strlen(key) + 1);
+	entry.start = (SW_u32)datfd->seek(0, SEEK_END);
+	entry.size = size;
+	datfd->write(outbuf, (long)size);
+
+	// add a new line to make data file easier to read in an editor
+	datfd->write(&nl, 1);
+
+	build->entries.push_back(entry);
+
+	delete [] key;
+	delete [] outbuf;
+}
+
+
+/******************************************************************************
+ * RawStr4::flushBuild	- merges the index entries held back into the index
+ */
+
+void RawStr4::flushBuild() {
+	if (!build || build->entries.empty()) return;
+
+	// a key set again goes before the one already there, as with doSetText
+	std::vector<Build::Entry> &entries = build->entries;
+	std::reverse(entries.begin(), entries.end());
+	std::stable_sort(entries.begin(), entries.end(), Build::KeyBefore(&build->keys[0]));
+
+	// where each goes among the entries already in the index
+	long count = idxfd->seek(0, SEEK_END) / IDXENTRYSIZE;
+	std::vector<long> places(entries.size());
+	char *dbKey = 0;
+	long low = 0;
+	for (size_t i = 0; i < entries.size(); i++) {
+		long high = count;
+		while (low < high) {
+			long mid = low + (high - low) / 2;
+			getIDXBuf(mid * IDXENTRYSIZE, &dbKey);
+			if (strcmp(dbKey, build->getKey(entries[i])) < 0) low = mid + 1;
+			else high = mid;
+		}
+		places[i] = low;
+	}
+	if (dbKey)
+		free(dbKey);
+
+	// everything from the first new entry on is written again, at once
+	long first = places[0];
+	char *tail = new char [ (count - first) * IDXENTRYSIZE + 1 ];
+	idxfd->seek(first * IDXENTRYSIZE, SEEK_SET);
+	idxfd->read(tail, (count - first) * IDXENTRYSIZE);
+
+	char *idxBytes = new char [ (count - first + entries.size()) * IDXENTRYSIZE ];
+	char *out = idxBytes;
+	long copied = first;
+	for (size_t i = 0; i <= entries.size(); i++) {
+		long upTo = (i < entries.size()) ? places[i] : count;
+		memcpy(out, tail + (copied - first) * IDXENTRYSIZE, (upTo - copied) * IDXENTRYSIZE);
+		out += (upTo - copied) * IDXENTRYSIZE;
+		copied = upTo;
+		if (i < entries.size()) {
+			SW_u32 outstart = archtosword32(entries[i].start);
+			SW_u32 outsize = archtosword32(entries[i].size);
+			memcpy(out, &outstart, 4);
+			memcpy(out + 4, &outsize, 4);
+			out += IDXENTRYSIZE;
+		}
+	}
+	idxfd->seek(first * IDXENTRYSIZE, SEEK_SET);
+	idxfd->write(idxBytes, (long)(out - idxBytes));
+
+	delete [] tail;
+	delete [] idxBytes;
+	entries.clear();
+	build->keys.clear();
+	lastoff = -1;
+}
+
+
 SWORD_NAMESPACE_END
@@ -0,0 +1,176 @@
+/******************************************************************************
+ *
+ *  searchjournal.cpp -	SearchJournal: the entries edited since a module's
+ *			search framework was built
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <searchjournal.h>
+#include <entryattridx.h>
+#include <filemgr.h>
+#include <sysdata.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+SWORD_NAMESPACE_START
+
+const char *SearchJournal::FILENAME = "search.jnl";
+
+namespace {
+
+	// file layout, one line each:
+	//	"SWSJ2 " base
+	//	"+ " index " " keyText		an edit
+	//	"= " before " " after		seals the edits since the last seal
+	const char MAGIC[] = "SWSJ2 ";
+
+	// takes the next space delimited word from line
+	SWBuf nextWord(const char *&line) {
+		const char *end = strchr(line, ' ');
+		if (!end) end = line + strlen(line);
+		SWBuf word;
+		word.append(line, end - line);
+		line = (*end) ? end + 1 : end;
+		return word;
+	}
+
+	signed char writeLine(const char *dataPath, const SWBuf &line, bool create) {
+		int mode = (create) ? (FileMgr::CREAT|FileMgr::WRONLY|FileMgr::TRUNC) : (FileMgr::WRONLY|FileMgr::APPEND);
+		int fd = FileMgr::openFile(SearchJournal::getJournalPath(dataPath), mode, FileMgr::IREAD|FileMgr::IWRITE);
+		if (fd < 0) return -1;
+		long written = FileMgr::write(fd, line.c_str(), line.length());
+		FileMgr::closeFile(fd);
+		return (written == (long)line.length()) ? 0 : -1;
+	}
+}
+
+
+SearchJournal::SearchJournal(const char *dataPath) : dataPath(dataPath), continuous(false) {
+}
+
+
+SWBuf SearchJournal::getJournalPath(const char *dataPath) {
+	SWBuf path = dataPath;
+	if (!path.endsWith("/") && !path.endsWith("\\")) path.append('/');
+	return path + FILENAME;
+}
+
+
+bool SearchJournal::exists(const char *dataPath) {
+	return FileMgr::existsFile(getJournalPath(dataPath));
+}
+
+
+SWBuf SearchJournal::getStamp(const char *dataPath) {
+	return getSignatureStamp(EntryAttributeIndex::getDataSignature(dataPath));
+}
+
+
+SWBuf SearchJournal::getSignatureStamp(const SWBuf &signature) {
+	// 64-bit FNV-1a; the signature itself can run to kilobytes
+	SW_u64 hash = 0xcbf29ce484222325ULL;
+	for (const unsigned char *c = (const unsigned char *)signature.c_str(); *c; ++c) {
+		hash ^= *c;
+		hash *= 0x100000001b3ULL;
+	}
+	SWBuf stamp;
+	stamp.setFormatted("%08x%08x", (SW_u32)(hash >> 32), (SW_u32)hash);
+	return stamp;
+}
+
+
+signed char SearchJournal::start(const char *dataPath) {
+	SWBuf line = MAGIC;
+	line += getStamp(dataPath);
+	line += "\n";
+	return writeLine(dataPath, line, true);
+}
+
+
+void SearchJournal::record(const char *dataPath, long index, const char *keyText) {
+	if (!exists(dataPath)) return;
+
+	SWBuf line;
+	line.setFormatted("+ %ld %s\n", index, keyText);
+	writeLine(dataPath, line, false);
+}
+
+
+void SearchJournal::seal(const char *dataPath, const char *before, const char *after) {
+	if (!exists(dataPath)) return;
+
+	SWBuf line;
+	line.setFormatted("= %s %s\n", before, after);
+	writeLine(dataPath, line, false);
+}
+
+
+void SearchJournal::remove(const char *dataPath) {
+	FileMgr::removeFile(getJournalPath(dataPath));
+}
+
+
+bool SearchJournal::load() {
+	base = "";
+	last = "";
+	continuous = false;
+	edits.clear();
+
+	FileDesc *fd = FileMgr::getSystemFileMgr()->open(getJournalPath(dataPath), FileMgr::RDONLY);
+	if (!fd || fd->getFd() < 0) {
+		FileMgr::getSystemFileMgr()->close(fd);
+		return false;
+	}
+
+	SWBuf line;
+	bool ok = FileMgr::getLine(fd, line) && line.startsWith(MAGIC);
+	if (ok) {
+		base = line.c_str() + strlen(MAGIC);
+		last = base;
+		continuous = true;
+		bool sealed = true;
+		while (FileMgr::getLine(fd, line)) {
+			if (line.length() < 2) continue;
+			const char *pos = line.c_str() + 2;
+			if (line[0] == '+') {
+				Edit edit;
+				edit.index = atol(nextWord(pos));
+				edit.keyText = pos;
+				edits.push_back(edit);
+				sealed = false;
+			}
+			else if (line[0] == '=') {
+				SWBuf before = nextWord(pos);
+				if (before != last) continuous = false;
+				last = nextWord(pos);
+				sealed = true;
+			}
+		}
+		// edits still unsealed were made by a module which hasn't yet
+		// written them, or never did
+		if (!sealed) continuous = false;
+	}
+	FileMgr::getSystemFileMgr()->close(fd);
+	return ok;
+}
+
+
+SWORD_NAMESPACE_END
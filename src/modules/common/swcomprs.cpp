@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <swcomprs.h>
+#include <typeinfo>
 
 SWORD_NAMESPACE_START
 
@@ -54,6 +55,20 @@ SWCompress::~SWCompress()
 }
 
 
+/******************************************************************************
+ * SWCompress::clone	- a compressor of the same kind, for another thread
+ */
+
+SWCompress *SWCompress::clone() const {
+	// a subclass which doesn't say otherwise can't be assumed copyable
+	if (typeid(*this) != typeid(SWCompress)) return 0;
+
+	SWCompress *copy = new SWCompress();
+	copy->level = level;
+	return copy;
+}
+
+
 void SWCompress::init()
 {
 		if (buf)
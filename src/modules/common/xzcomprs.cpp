@@ -66,6 +66,17 @@ XzCompress::~XzCompress() {
 }
 
 
+/******************************************************************************
+ * XzCompress::clone	- a compressor of the same kind, for another thread
+ */
+
+SWCompress *XzCompress::clone() const {
+	XzCompress *copy = new XzCompress();
+	copy->setLevel(level);
+	return copy;
+}
+
+
 /******************************************************************************
  * XzCompress::Encode - This function "encodes" the input stream into the
  *			output stream.
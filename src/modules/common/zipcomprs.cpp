@@ -239,6 +239,17 @@ ZipCompress::~ZipCompress() {
 }
 
 
+/******************************************************************************
+ * ZipCompress::clone	- a compressor of the same kind, for another thread
+ */
+
+SWCompress *ZipCompress::clone() const {
+	ZipCompress *copy = new ZipCompress();
+	copy->setLevel(level);
+	return copy;
+}
+
+
 /******************************************************************************
  * ZipCompress::encode	- This function "encodes" the input stream into the
  *						output stream.
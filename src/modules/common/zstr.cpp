@@ -38,9 +38,28 @@
 #include <stringmgr.h>
 #include <filemgr.h>
 #include <swbuf.h>
+#include <swmodule.h>
+#include <swmetrics.h>
+#include <blockwriter.h>
+
+#include <vector>
+#include <algorithm>
 
 SWORD_NAMESPACE_START
 
+
+#ifndef STRIPMETRICS
+namespace {
+
+	// zStr is the backend of zLD; count its blocks against the module
+	const char *getMetricsOwner(const zStr *backend) {
+		const SWModule *module = SWDYNAMIC_CAST(const SWModule, backend);
+		return (module) ? module->getName() : 0;
+	}
+}
+#endif
+
+
 /******************************************************************************
  * zStr Statics
  */
@@ -61,10 +80,12 @@ zStr::zStr(const char *ipath, int fileMode, long blockCount, SWCompress *icomp,
 	SWBuf buf;
 
 	lastoff = -1;
+	build = 0;
 	path = 0;
 	stdstr(&path, ipath);
 
 	compressor = (icomp) ? icomp : new SWCompress();
+	writer = new BlockWriter(compressor, commitBlock, this);
 	this->blockCount = blockCount;
 
 	if (fileMode == -1) { // try read/write if possible
@@ -103,6 +124,7 @@ SWLOGD("Couldn't open file: %s. errno: %d", buf.c_str(), errno);
 
 zStr::~zStr() {
 
+	endBuild();
 	flushCache();
 
 	if (path)
@@ -116,6 +138,8 @@ zStr::~zStr() {
 	FileMgr::getSystemFileMgr()->close(zdtfd);
 
 
+	delete writer;
+
 	if (compressor)
 		delete compressor;
 
@@ -395,6 +419,8 @@ void zStr::getCompressedText(long block, long entry, char **buf) const {
 
 	if (cacheBlockIndex != block) {
 		SW_u32 start = 0;
+		SWMETRICS_ADD(getMetricsOwner(this), CACHE_MISSES, 1);
+		writer->finish();	// the block may not be written out yet
 
 		zdxfd->seek(block * ZDXENTRYSIZE, SEEK_SET);
 		zdxfd->read(&start, 4);
@@ -413,11 +439,15 @@ void zStr::getCompressedText(long block, long entry, char **buf) const {
 		buf.setSize(size);
 		rawZFilter(buf, 0); // 0 = decipher
 
+		SWMETRICS_START(decompressStart);
 		compressor->setCompressedBuf(&len, buf.getRawData());
 		char *rawBuf = compressor->getUncompressedBuf(&len);
+		SWMETRICS_ADD_SINCE(decompressStart, getMetricsOwner(this), DECOMPRESS_MICROS);
+		SWMETRICS_ADD(getMetricsOwner(this), BLOCK_DECOMPRESSIONS, 1);
 		cacheBlock = new EntriesBlock(rawBuf, len);
 		cacheBlockIndex = block;
 	}
+	else SWMETRICS_ADD(getMetricsOwner(this), CACHE_HITS, 1);
 	size = (SW_u32)cacheBlock->getEntrySize(entry);
 	*buf = (*buf) ? (char *)realloc(*buf, size*2 + 1) : (char *)malloc(size*2 + 1);
 	strcpy(*buf, cacheBlock->getEntry(entry));
@@ -449,6 +479,14 @@ void zStr::setText(const char *ikey, const char *buf, long len) {
 	char *ch = 0;
 
 	len = (len < 0) ? strlen(buf) : len;
+	if (build) {
+		if (len > 0) {
+			addBuildText(ikey, buf, len);
+			return;
+		}
+		flushBuild();	// deleting works on the index as it stands
+	}
+
 	stdstr(&key, ikey, 3);
 	if (!caseSensitive) toupperstr_utf8(key, (unsigned int)(strlen(key)*3));
 
@@ -514,14 +552,16 @@ void zStr::setText(const char *ikey, const char *buf, long len) {
 	size = (SW_u32)strlen(outbuf);
 	if (len > 0) {	// NOT a link
 		if (!cacheBlock) {
-			flushCache();
+			flushCache(false);	// compressed and written out while we go on
 			cacheBlock = new EntriesBlock();
-			cacheBlockIndex = (zdxfd->seek(0, SEEK_END) / ZDXENTRYSIZE);
+			// blocks still with the writer have the next numbers
+			cacheBlockIndex = (zdxfd->seek(0, SEEK_END) / ZDXENTRYSIZE) + writer->getPending(0);
 		}
 		else if (cacheBlock->getCount() >= blockCount) {
-			flushCache();
+			flushCache(false);	// compressed and written out while we go on
 			cacheBlock = new EntriesBlock();
-			cacheBlockIndex = (zdxfd->seek(0, SEEK_END) / ZDXENTRYSIZE);
+			// blocks still with the writer have the next numbers
+			cacheBlockIndex = (zdxfd->seek(0, SEEK_END) / ZDXENTRYSIZE) + writer->getPending(0);
 		}
 		SW_u32 entry = cacheBlock->addEntry(buf);
 		cacheDirty = true;
@@ -587,72 +627,101 @@ void zStr::linkEntry(const char *destkey, const char *srckey) {
 }
 
 
-void zStr::flushCache() const {
-
-	static const char nl[] = {13, 10};
+void zStr::flushCache(bool wait) const {
 
 	if (cacheBlock) {
 		if (cacheDirty) {
-			SW_u32 start = 0;
 			unsigned long size = 0;
-			SW_u32 outstart = 0, outsize = 0;
 
 			const char *rawBuf = cacheBlock->getRawData(&size);
-			compressor->setUncompressedBuf(rawBuf, &size);
-			compressor->getCompressedBuf(&size);
+			if (!writer->add(0, cacheBlockIndex, rawBuf, size)) {
+				compressor->setUncompressedBuf(rawBuf, &size);
+				compressor->getCompressedBuf(&size);
+
+				SWBuf buf;
+				buf.setSize(size + 5);
+				memcpy(buf.getRawData(), compressor->getCompressedBuf(&size), size);
+				buf.setSize(size);
+				writeBlock(cacheBlockIndex, buf);
+			}
+		}
+		delete cacheBlock;
+		cacheBlock = 0;
+	}
+	cacheBlockIndex = -1;
+	cacheDirty = false;
+	if (wait) writer->finish();
+}
 
-			SWBuf buf;
-			buf.setSize(size + 5);
-			memcpy(buf.getRawData(), compressor->getCompressedBuf(&size), size); // 1 = encipher
-			buf.setSize(size);
-			rawZFilter(buf, 1); // 1 = encipher
 
-			long zdxSize = zdxfd->seek(0, SEEK_END);
-			unsigned long zdtSize = zdtfd->seek(0, SEEK_END);
+/******************************************************************************
+ * zStr::writeBlock	- writes a compressed block to the zdt file and
+ *				records it in the zdx file
+ *
+ * ENT: block	- block number
+ *	buf	- the block, compressed; it is enciphered here
+ */
 
-			if ((cacheBlockIndex * ZDXENTRYSIZE) > (zdxSize - ZDXENTRYSIZE)) {	// New Block
-				start = (SW_u32)zdtSize;
-			}
-			else {
-				zdxfd->seek(cacheBlockIndex * ZDXENTRYSIZE, SEEK_SET);
-				zdxfd->read(&start, 4);
-				zdxfd->read(&outsize, 4);
-				start = swordtoarch32(start);
-				outsize = swordtoarch32(outsize);
-				if (start + outsize >= zdtSize) {	// last entry, just overwrite
-					// start is already set
-				}
-				else	if (size < outsize) {	// middle entry, but smaller, that's fine and let's preserve bigger size
-					size = outsize;
-				}
-				else {	// middle and bigger-- we have serious problems, for now let's put it at the end = lots of wasted space
-					start = (SW_u32)zdtSize;
-				}
-			}
+void zStr::writeBlock(long block, SWBuf &buf) const {
 
+	static const char nl[] = {13, 10};
 
+	SW_u32 start = 0;
+	unsigned long size = buf.length();
+	SW_u32 outstart = 0, outsize = 0;
 
-			outstart = archtosword32(start);
-			outsize  = archtosword32((SW_u32)size);
+	rawZFilter(buf, 1); // 1 = encipher
 
-			zdxfd->seek(cacheBlockIndex * ZDXENTRYSIZE, SEEK_SET);
-			zdtfd->seek(start, SEEK_SET);
-			zdtfd->write(buf, size);
+	long zdxSize = zdxfd->seek(0, SEEK_END);
+	unsigned long zdtSize = zdtfd->seek(0, SEEK_END);
 
-			// add a new line to make data file easier to read in an editor
-			zdtfd->write(&nl, 2);
-			
-			zdxfd->write(&outstart, 4);
-			zdxfd->write(&outsize, 4);
+	if ((block * ZDXENTRYSIZE) > (zdxSize - ZDXENTRYSIZE)) {	// New Block
+		start = (SW_u32)zdtSize;
+	}
+	else {
+		zdxfd->seek(block * ZDXENTRYSIZE, SEEK_SET);
+		zdxfd->read(&start, 4);
+		zdxfd->read(&outsize, 4);
+		start = swordtoarch32(start);
+		outsize = swordtoarch32(outsize);
+		if (start + outsize >= zdtSize) {	// last entry, just overwrite
+			// start is already set
+		}
+		else	if (size < outsize) {	// middle entry, but smaller, that's fine and let's preserve bigger size
+			size = outsize;
+		}
+		else {	// middle and bigger-- we have serious problems, for now let's put it at the end = lots of wasted space
+			start = (SW_u32)zdtSize;
 		}
-		delete cacheBlock;
-		cacheBlock = 0;
 	}
-	cacheBlockIndex = -1;
-	cacheDirty = false;
+
+
+
+	outstart = archtosword32(start);
+	outsize  = archtosword32((SW_u32)size);
+
+	zdxfd->seek(block * ZDXENTRYSIZE, SEEK_SET);
+	zdtfd->seek(start, SEEK_SET);
+	zdtfd->write(buf, size);
+
+	// add a new line to make data file easier to read in an editor
+	zdtfd->write(&nl, 2);
+	
+	zdxfd->write(&outstart, 4);
+	zdxfd->write(&outsize, 4);
 }
 
 
+/******************************************************************************
+ * zStr::commitBlock	- writes out a block our BlockWriter compressed
+ */
+
+void zStr::commitBlock(const void *zstr, char testmt, long block, unsigned long size, SWBuf &compressed) {
+	(void) testmt;
+	(void) size;
+	((const zStr *)zstr)->writeBlock(block, compressed);
+}
+
 /******************************************************************************
  * zLD::CreateModule	- Creates new module files
  *
@@ -699,4 +768,149 @@ signed char zStr::createModule(const char *ipath) {
 	return 0;
 }
 
+
+/******************************************************************************
+ * zStr::Build	- index entries held back while building
+ */
+
+struct zStr::Build {
+	struct Entry {
+		size_t key;		// offset of the key in keys
+		SW_u32 start;
+		SW_u32 size;
+	};
+	std::vector<char> keys;		// every key, 0 terminated
+	std::vector<Entry> entries;
+
+	struct KeyBefore {
+		const char *keys;
+		KeyBefore(const char *keys) : keys(keys) {}
+		bool operator ()(const Entry &a, const Entry &b) const { return strcmp(keys + a.key, keys + b.key) < 0; }
+	};
+	const char *getKey(const Entry &entry) const { return &keys[entry.key]; }
+};
+
+
+void zStr::beginBuild() {
+	if (!build) build = new Build();
+}
+
+
+void zStr::endBuild() {
+	flushBuild();
+	delete build;
+	build = 0;
+}
+
+
+/******************************************************************************
+ * zStr::addBuildText	- adds an entry to the block being filled and the
+ *				data file, holding back its index entry
+ */
+
+void zStr::addBuildText(const char *ikey, const char *buf, long len) {
+
+	static const char nl[] = {13, 10};
+
+	char *key = 0;
+	stdstr(&key, ikey, 3);
+	if (!caseSensitive) toupperstr_utf8(key, (unsigned int)(strlen(key)*3));
+
+	if ((!cacheBlock) || (cacheBlock->getCount() >= blockCount)) {
+		flushCache(false);
+		cacheBlock = new EntriesBlock();
+		cacheBlockIndex = (zdxfd->seek(0, SEEK_END) / ZDXENTRYSIZE) + writer->getPending(0);
+	}
+	SW_u32 entry = cacheBlock->addEntry(buf);
+	cacheDirty = true;
+
+	char *outbuf = new char [ strlen(key) + 11 ];
+	sprintf(outbuf, "%s%c%c", key, 13, 10);
+	SW_u32 size = (SW_u32)strlen(outbuf);
+	SW_u32 outblock = (SW_u32)archtosword32(cacheBlockIndex);
+	SW_u32 outentry = archtosword32(entry);
+	memcpy(outbuf + size, &outblock, sizeof(SW_u32));
+	memcpy(outbuf + size + sizeof(SW_u32), &outentry, sizeof(SW_u32));
+	size += (sizeof(SW_u32) * 2);
+
+	Build::Entry idxEntry;
+	idxEntry.key = build->keys.size();
+	build->keys.insert(build->keys.end(), key, key + strlen(key) + 1);
+	idxEntry.start = (SW_u32)datfd->seek(0, SEEK_END);
+	idxEntry.size = size;
+	datfd->write(outbuf, size);
+
+	// add a new line to make data file easier to read in an editor
+	datfd->write(&nl, 2);
+
+	build->entries.push_back(idxEntry);
+
+	delete [] key;
+	delete [] outbuf;
+}
+
+
+/******************************************************************************
+ * zStr::flushBuild	- merges the index entries held back into the index
+ */
+
+void zStr::flushBuild() {
+	if (!build || build->entries.empty()) return;
+
+	// a key set again goes before the one already there, as with setText
+	std::vector<Build::Entry> &entries = build->entries;
+	std::reverse(entries.begin(), entries.end());
+	std::stable_sort(entries.begin(), entries.end(), Build::KeyBefore(&build->keys[0]));
+
+	// where each goes among the entries already in the index
+	long count = idxfd->seek(0, SEEK_END) / IDXENTRYSIZE;
+	std::vector<long> places(entries.size());
+	char *dbKey = 0;
+	long low = 0;
+	for (size_t i = 0; i < entries.size(); i++) {
+		long high = count;
+		while (low < high) {
+			long mid = low + (high - low) / 2;
+			getKeyFromIdxOffset(mid * IDXENTRYSIZE, &dbKey);
+			if (strcmp(dbKey, build->getKey(entries[i])) < 0) low = mid + 1;
+			else high = mid;
+		}
+		places[i] = low;
+	}
+	if (dbKey)
+		free(dbKey);
+
+	// everything from the first new entry on is written again, at once
+	long first = places[0];
+	char *tail = new char [ (count - first) * IDXENTRYSIZE + 1 ];
+	idxfd->seek(first * IDXENTRYSIZE, SEEK_SET);
+	idxfd->read(tail, (count - first) * IDXENTRYSIZE);
+
+	char *idxBytes = new char [ (count - first + entries.size()) * IDXENTRYSIZE ];
+	char *out = idxBytes;
+	long copied = first;
+	for (size_t i = 0; i <= entries.size(); i++) {
+		long upTo = (i < entries.size()) ? places[i] : count;
+		memcpy(out, tail + (copied - first) * IDXENTRYSIZE, (upTo - copied) * IDXENTRYSIZE);
+		out += (upTo - copied) * IDXENTRYSIZE;
+		copied = upTo;
+		if (i < entries.size()) {
+			SW_u32 outstart = archtosword32(entries[i].start);
+			SW_u32 outsize = archtosword32(entries[i].size);
+			memcpy(out, &outstart, 4);
+			memcpy(out + 4, &outsize, 4);
+			out += IDXENTRYSIZE;
+		}
+	}
+	idxfd->seek(first * IDXENTRYSIZE, SEEK_SET);
+	idxfd->write(idxBytes, (long)(out - idxBytes));
+
+	delete [] tail;
+	delete [] idxBytes;
+	entries.clear();
+	build->keys.clear();
+	lastoff = -1;
+}
+
+
 SWORD_NAMESPACE_END
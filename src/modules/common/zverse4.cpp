@@ -36,10 +36,27 @@
 #include <swbuf.h>
 #include <filemgr.h>
 #include <swcomprs.h>
+#include <swmodule.h>
+#include <swmetrics.h>
+#include <blockprefetcher.h>
+#include <blockwriter.h>
 
 
 SWORD_NAMESPACE_START
 
+
+#ifndef STRIPMETRICS
+namespace {
+
+	// the module a block is read for, to count it against in SWMetrics
+	const char *getMetricsOwner(const zVerse4 *backend) {
+		const SWModule *module = SWDYNAMIC_CAST(const SWModule, backend);
+		return (module) ? module->getName() : 0;
+	}
+}
+#endif
+
+
 /******************************************************************************
  * zVerse4 Statics
  */
@@ -76,6 +93,8 @@ zVerse4::zVerse4(const char *ipath, int fileMode, int blockType, SWCompress *ico
 		path[strlen(path)-1] = 0;
 
 	compressor = (icomp) ? icomp : new SWCompress();
+	prefetcher = new BlockPrefetcher(compressor);
+	writer = new BlockWriter(compressor, commitBlock, this);
 
 	if (fileMode == -1) { // try read/write if possible
 		fileMode = FileMgr::RDWR;
@@ -119,6 +138,9 @@ zVerse4::~zVerse4()
 	if (path)
 		delete [] path;
 
+	delete prefetcher;
+	delete writer;
+
 	if (compressor)
 		delete compressor;
 
@@ -202,9 +224,6 @@ void zVerse4::findOffset(char testmt, long idxoff, long *start, unsigned long *s
  */
 
 void zVerse4::zReadText(char testmt, long start, unsigned long size, unsigned long ulBuffNum, SWBuf &inBuf) const {
-	SW_u32 ulCompOffset = 0;	       // compressed buffer start
-	SW_u32 ulCompSize   = 0;	             // buffer size compressed
-	SW_u32 ulUnCompSize = 0;	          // buffer size uncompressed
 
 	if (!testmt) {
 		testmt = ((idxfp[0]) ? 1:2);
@@ -217,63 +236,50 @@ void zVerse4::zReadText(char testmt, long start, unsigned long size, unsigned lo
 	if (size && 
 		!(((long) ulBuffNum == cacheBufIdx) && (testmt == cacheTestament) && (cacheBuf))) {
 		//fprintf(stderr, "Got buffer number{%ld} versestart{%ld} versesize{%d}\n", ulBuffNum, ulVerseStart, usVerseSize);
+		SWMETRICS_ADD(getMetricsOwner(this), CACHE_MISSES, 1);
+		writer->finish();	// the block may not be written out yet
 
-		if (idxfp[testmt-1]->seek(ulBuffNum*12, SEEK_SET)!=(long) ulBuffNum*12)
-		{
-			fprintf(stderr, "Error seeking compressed file index\n");
-			return;
-		}
-		if (idxfp[testmt-1]->read(&ulCompOffset, 4)<4)
-		{
-			fprintf(stderr, "Error reading ulCompOffset\n");
-			return;
-		}
-		if (idxfp[testmt-1]->read(&ulCompSize, 4)<4)
-		{
-			fprintf(stderr, "Error reading ulCompSize\n");
-			return;
-		}
-		if (idxfp[testmt-1]->read(&ulUnCompSize, 4)<4)
-		{
-			fprintf(stderr, "Error reading ulUnCompSize\n");
-			return;
-		}
-
-		ulCompOffset  = swordtoarch32(ulCompOffset);
-		ulCompSize  = swordtoarch32(ulCompSize);
-		ulUnCompSize  = swordtoarch32(ulUnCompSize);
-
-		if (textfp[testmt-1]->seek(ulCompOffset, SEEK_SET)!=(long)ulCompOffset)
-		{
-			fprintf(stderr, "Error: could not seek to right place in compressed text\n");
-			return;
+		SWBuf text;
+		if (prefetcher->take(testmt, ulBuffNum, text)) {
+			SWMETRICS_ADD(getMetricsOwner(this), PREFETCH_HITS, 1);
 		}
-		SWBuf pcCompText;
-		pcCompText.setSize(ulCompSize+5);
-
-		if (textfp[testmt-1]->read(pcCompText.getRawData(), ulCompSize)<(long)ulCompSize) {
-			fprintf(stderr, "Error reading compressed text\n");
-			return;
+		else {
+			SWBuf pcCompText;
+			if (!readBlock(testmt, ulBuffNum, pcCompText)) return;
+
+			SWMETRICS_START(decompressStart);
+			unsigned long bufSize = pcCompText.length();
+			compressor->setCompressedBuf(&bufSize, pcCompText.getRawData());
+
+			unsigned long len = 0;
+			compressor->setUncompressedBuf(0, &len);
+			text.setSize(len);
+			memcpy(text.getRawData(), compressor->getUncompressedBuf(), len);
+			SWMETRICS_ADD(getMetricsOwner(this), BLOCK_DECOMPRESSIONS, 1);
+			SWMETRICS_ADD_SINCE(decompressStart, getMetricsOwner(this), DECOMPRESS_MICROS);
 		}
-		pcCompText.setSize(ulCompSize);
-		rawZFilter(pcCompText, 0); // 0 = decipher
-		
-		unsigned long bufSize = ulCompSize;
-		compressor->setCompressedBuf(&bufSize, pcCompText.getRawData());
 
 		if (cacheBuf) {
 			flushCache();
 			free(cacheBuf);
 		}
 		
-		unsigned long len = 0;
-		compressor->setUncompressedBuf(0, &len);
-		cacheBuf = (char *)calloc(len + 1, 1);
-		memcpy(cacheBuf, compressor->getUncompressedBuf(), len);
+		cacheBuf = (char *)calloc(text.length() + 1, 1);
+		memcpy(cacheBuf, text.c_str(), text.length());
 		cacheBufSize = (int)strlen(cacheBuf);  // TODO: can we just use len?
 		cacheTestament = testmt;
 		cacheBufIdx = ulBuffNum;
+
+		// reading on through the blocks, the next ones are made ready while this one is used
+		prefetcher->readAhead(testmt, ulBuffNum,
+#ifndef STRIPMETRICS
+				getMetricsOwner(this),
+#else
+				0,
+#endif
+				readAheadBlock, this);
 	}	
+	else if (size) SWMETRICS_ADD(getMetricsOwner(this), CACHE_HITS, 1);
 	
 	inBuf = "";
 	if ((size > 0) && cacheBuf && ((unsigned)start < cacheBufSize)) {
@@ -285,6 +291,75 @@ void zVerse4::zReadText(char testmt, long start, unsigned long size, unsigned lo
 }
 
 
+/******************************************************************************
+ * zVerse4::readBlock	- reads a compressed block, deciphered
+ *
+ * ENT:	testmt	- testament file to read from (1 - Old; 2 - New)
+ *	ulBuffNum	- block to read
+ *	pcCompText	- buffer to store the block
+ *
+ * RET: false if the block could not be read
+ */
+
+bool zVerse4::readBlock(char testmt, unsigned long ulBuffNum, SWBuf &pcCompText) const {
+	SW_u32 ulCompOffset = 0;	       // compressed buffer start
+	SW_u32 ulCompSize   = 0;	             // buffer size compressed
+	SW_u32 ulUnCompSize = 0;	          // buffer size uncompressed
+
+	if (idxfp[testmt-1]->seek(ulBuffNum*12, SEEK_SET)!=(long) ulBuffNum*12)
+	{
+		fprintf(stderr, "Error seeking compressed file index\n");
+		return false;
+	}
+	if (idxfp[testmt-1]->read(&ulCompOffset, 4)<4)
+	{
+		fprintf(stderr, "Error reading ulCompOffset\n");
+		return false;
+	}
+	if (idxfp[testmt-1]->read(&ulCompSize, 4)<4)
+	{
+		fprintf(stderr, "Error reading ulCompSize\n");
+		return false;
+	}
+	if (idxfp[testmt-1]->read(&ulUnCompSize, 4)<4)
+	{
+		fprintf(stderr, "Error reading ulUnCompSize\n");
+		return false;
+	}
+
+	ulCompOffset  = swordtoarch32(ulCompOffset);
+	ulCompSize  = swordtoarch32(ulCompSize);
+	ulUnCompSize  = swordtoarch32(ulUnCompSize);
+
+	if (textfp[testmt-1]->seek(ulCompOffset, SEEK_SET)!=(long)ulCompOffset)
+	{
+		fprintf(stderr, "Error: could not seek to right place in compressed text\n");
+		return false;
+	}
+	pcCompText.setSize(ulCompSize+5);
+
+	if (textfp[testmt-1]->read(pcCompText.getRawData(), ulCompSize)<(long)ulCompSize) {
+		fprintf(stderr, "Error reading compressed text\n");
+		return false;
+	}
+	pcCompText.setSize(ulCompSize);
+	rawZFilter(pcCompText, 0); // 0 = decipher
+	return true;
+}
+
+
+/******************************************************************************
+ * zVerse4::readAheadBlock	- reads a block for our BlockPrefetcher; it
+ *				may ask for one past the last
+ */
+
+bool zVerse4::readAheadBlock(const void *zverse, char testmt, unsigned long ulBuffNum, SWBuf &compressed) {
+	const zVerse4 *self = (const zVerse4 *)zverse;
+	if (self->idxfp[testmt-1]->seek(0, SEEK_END) < (long)(ulBuffNum+1)*12) return false;
+	return self->readBlock(testmt, ulBuffNum, compressed);
+}
+
+
 /******************************************************************************
  * zVerse4::settext	- Sets text for current offset
  *
@@ -296,11 +371,13 @@ void zVerse4::zReadText(char testmt, long start, unsigned long size, unsigned lo
 
 void zVerse4::doSetText(char testmt, long idxoff, const char *buf, long len) {
 
+	prefetcher->clear();	// blocks read ahead may be about to change
 	len = (len < 0) ? strlen(buf) : len;
 	if (!testmt) 
 		testmt = ((idxfp[0]) ? 1:2);
 	if ((!dirtyCache) || (cacheBufIdx < 0)) {
-		cacheBufIdx = idxfp[testmt-1]->seek(0, SEEK_END) / 12;
+		// blocks still with the writer have the next numbers
+		cacheBufIdx = idxfp[testmt-1]->seek(0, SEEK_END) / 12 + writer->getPending(testmt);
 		cacheTestament = testmt;
 		if (cacheBuf)
 			free(cacheBuf);
@@ -334,47 +411,72 @@ void zVerse4::doSetText(char testmt, long idxoff, const char *buf, long len) {
 }
 
 
-void zVerse4::flushCache() const {
+void zVerse4::flushCache(bool wait) const {
 	if (dirtyCache) {
-		SW_u32 idxoff;
-		SW_u32 start, outstart;
-		SW_u32 size, outsize;
-		SW_u32 zsize, outzsize;
+		prefetcher->clear();
+		SW_u32 size;
 
-		idxoff = (SW_u32)cacheBufIdx * 12;
 		if (cacheBuf) {
-			size = outsize = zsize = outzsize = (SW_u32)strlen(cacheBuf);
-			if (size) {
+			size = (SW_u32)strlen(cacheBuf);
+			if (size && !writer->add(cacheTestament, cacheBufIdx, cacheBuf, size)) {
 				compressor->setUncompressedBuf(cacheBuf);
 				unsigned long tmpSize;
 				compressor->getCompressedBuf(&tmpSize);
-				outzsize = zsize = (SW_u32)tmpSize;
 
 				SWBuf buf;
-				buf.setSize(zsize + 5);
+				buf.setSize(tmpSize + 5);
 				memcpy(buf.getRawData(), compressor->getCompressedBuf(&tmpSize), tmpSize);
-				outzsize = zsize = (SW_u32)tmpSize;
-				buf.setSize(zsize);
-				rawZFilter(buf, 1); // 1 = encipher
-
-				start = outstart = (SW_u32)textfp[cacheTestament - 1]->seek(0, SEEK_END);
-
-				outstart  = archtosword32(start);
-				outsize   = archtosword32(size);
-				outzsize  = archtosword32(zsize);
-
-				textfp[cacheTestament-1]->write(buf, zsize);
-
-				idxfp[cacheTestament-1]->seek(idxoff, SEEK_SET);
-				idxfp[cacheTestament-1]->write(&outstart, 4);
-				idxfp[cacheTestament-1]->write(&outzsize, 4);
-				idxfp[cacheTestament-1]->write(&outsize, 4);
+				buf.setSize(tmpSize);
+				writeBlock(cacheTestament, cacheBufIdx, size, buf);
 			}
 			free(cacheBuf);
 			cacheBuf = 0;
 		}
 		dirtyCache = false;
 	}
+	if (wait) writer->finish();
+}
+
+
+/******************************************************************************
+ * zVerse4::writeBlock	- appends a compressed block to the text file and
+ *				records it in the block index
+ *
+ * ENT: testmt	- testament file to write to (1 - Old; 2 - New)
+ *	buffnum	- block number
+ *	size	- size of the block uncompressed
+ *	buf	- the block, compressed; it is enciphered here
+ */
+
+void zVerse4::writeBlock(char testmt, long buffnum, unsigned long size, SWBuf &buf) const {
+	SW_u32 start, outstart;
+	SW_u32 outsize;
+	SW_u32 zsize, outzsize;
+
+	zsize = (SW_u32)buf.length();
+	rawZFilter(buf, 1); // 1 = encipher
+
+	start = outstart = (SW_u32)textfp[testmt - 1]->seek(0, SEEK_END);
+
+	outstart  = archtosword32(start);
+	outsize   = archtosword32((SW_u32)size);
+	outzsize  = archtosword32(zsize);
+
+	textfp[testmt-1]->write(buf, zsize);
+
+	idxfp[testmt-1]->seek(buffnum * 12, SEEK_SET);
+	idxfp[testmt-1]->write(&outstart, 4);
+	idxfp[testmt-1]->write(&outzsize, 4);
+	idxfp[testmt-1]->write(&outsize, 4);
+}
+
+
+/******************************************************************************
+ * zVerse4::commitBlock	- writes out a block our BlockWriter compressed
+ */
+
+void zVerse4::commitBlock(const void *zverse, char testmt, long buffnum, unsigned long size, SWBuf &compressed) {
+	((const zVerse4 *)zverse)->writeBlock(testmt, buffnum, size, compressed);
 }
 
 /******************************************************************************
@@ -0,0 +1,178 @@
+/******************************************************************************
+ *
+ *  filterpipeline.cpp -	FilterPipeline: a module's option and strip
+ *				filters compiled into the passes actually
+ *				needed for the current option settings
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <filterpipeline.h>
+#include <swoptfilter.h>
+#include <utilstr.h>
+#include <swmodule.h>
+#include <swmetrics.h>
+#include <typeinfo>
+
+SWORD_NAMESPACE_START
+
+
+FilterPipeline::FilterPipeline() {
+	compiled = false;
+}
+
+
+void FilterPipeline::compile(const OptionFilterList *optionFilters, const FilterList *filters) {
+	sources.clear();
+	sourceOptions.clear();
+	for (OptionFilterList::const_iterator it = optionFilters->begin(); it != optionFilters->end(); ++it) {
+		sources.push_back(*it);
+		sourceOptions.push_back(*it);
+	}
+	for (FilterList::const_iterator it = filters->begin(); it != filters->end(); ++it) {
+		sources.push_back(*it);
+		sourceOptions.push_back(SWDYNAMIC_CAST(SWOptionFilter, *it));
+	}
+	activeSources.resize(sources.size());
+	for (unsigned int i = 0; i < sources.size(); ++i) {
+		activeSources[i] = !sourceOptions[i] || sourceOptions[i]->isActive();
+	}
+
+	stages.clear();
+	for (unsigned int i = 0; i < sources.size(); ++i) {
+		if (!activeSources[i]) continue;
+
+		SWOptionFilter *optionFilter = sourceOptions[i];
+		bool charFilter = optionFilter && optionFilter->isCharFilter();
+		bool tokenFilter = optionFilter && !charFilter && optionFilter->isTokenFilter();
+
+		// join the fused stage before us, if there is one of our kind
+		if (stages.size() && !stages.back().filter) {
+			if (charFilter && stages.back().charFilters.size()) {
+				stages.back().charFilters.push_back(optionFilter);
+				stages.back().reencodes |= optionFilter->isReencoding();
+				continue;
+			}
+			if (tokenFilter && stages.back().tokenFilters.size()) {
+				stages.back().tokenFilters.push_back(optionFilter);
+				continue;
+			}
+		}
+
+		Stage stage;
+		stage.filter = sources[i];
+		stage.reencodes = charFilter && optionFilter->isReencoding();
+		if (charFilter || tokenFilter) {
+			// look ahead: only fuse if we have company; alone, the filter's own pass is as good
+			unsigned int next = i + 1;
+			while (next < sources.size() && !activeSources[next]) ++next;
+			SWOptionFilter *nextFilter = (next < sources.size()) ? sourceOptions[next] : 0;
+			if (nextFilter && charFilter && nextFilter->isCharFilter()) {
+				stage.filter = 0;
+				stage.charFilters.push_back(optionFilter);
+			}
+			else if (nextFilter && tokenFilter && !nextFilter->isCharFilter() && nextFilter->isTokenFilter()) {
+				stage.filter = 0;
+				stage.tokenFilters.push_back(optionFilter);
+			}
+		}
+		stages.push_back(stage);
+	}
+	compiled = true;
+}
+
+
+bool FilterPipeline::isCurrent(const OptionFilterList *optionFilters, const FilterList *filters) const {
+	if (!compiled) return false;
+	if (sources.size() != optionFilters->size() + filters->size()) return false;
+
+	unsigned int i = 0;
+	for (OptionFilterList::const_iterator it = optionFilters->begin(); it != optionFilters->end(); ++it, ++i) {
+		if (sources[i] != *it) return false;
+	}
+	for (FilterList::const_iterator it = filters->begin(); it != filters->end(); ++it, ++i) {
+		if (sources[i] != *it) return false;
+	}
+	for (i = 0; i < sources.size(); ++i) {
+		if (sourceOptions[i] && activeSources[i] != sourceOptions[i]->isActive()) return false;
+	}
+	return true;
+}
+
+
+void FilterPipeline::processText(SWBuf &text, const SWKey *key, const SWModule *module) {
+	for (std::vector<Stage>::iterator stage = stages.begin(); stage != stages.end(); ++stage) {
+		if (stage->filter) {
+			SWMETRICS_START(filterStart);
+			stage->filter->processText(text, key, module);
+			SWMETRICS_FILTER_SINCE(filterStart, (module) ? module->getName() : 0, typeid(*stage->filter).name());
+			continue;
+		}
+
+		// token filters: split the markup once for all of them
+		if (stage->tokenFilters.size()) {
+			tokens.setText(text);
+			for (std::vector<SWOptionFilter *>::iterator it = stage->tokenFilters.begin(); it != stage->tokenFilters.end(); ++it) {
+				SWMETRICS_START(filterStart);
+				(*it)->processTokens(tokens, key, module);
+				SWMETRICS_FILTER_SINCE(filterStart, (module) ? module->getName() : 0, typeid(**it).name());
+			}
+			tokens.getText(text);
+			continue;
+		}
+
+		// fused character filters: decode each code point once, run it
+		// through every filter, and encode whatever survives
+		SWMETRICS_START(stageStart);
+		scratch.setSize(0);
+		const unsigned char *from = (const unsigned char *)text.c_str();
+		std::vector<const SWOptionFilter *>::const_iterator begin = stage->charFilters.begin(), end = stage->charFilters.end();
+		while (*from) {
+			// character filters leave ASCII alone; copy runs of it as is
+			const unsigned char *run = from;
+			while (*from && *from < 0x80) ++from;
+			if (from > run) scratch.append((const char *)run, from - run);
+			if (!*from) break;
+
+			const unsigned char *start = from;
+			SW_u32 ch = getUniCharFromUTF8(&from, true);
+			// what the filters leave alone comes out as their own passes
+			// would write it: encoded again if one of them does so, which
+			// makes bad bytes U+FFFD, else as the bytes it was
+			if (!ch) {
+				if (!stage->reencodes) {
+					scratch.append((const char *)start, from - start);
+					continue;
+				}
+				ch = 0xFFFD;
+			}
+			SW_u32 out = ch;
+			for (std::vector<const SWOptionFilter *>::const_iterator it = begin; out && it != end; ++it) {
+				out = (*it)->filterChar(out);
+			}
+			if (out == ch && !stage->reencodes) scratch.append((const char *)start, from - start);
+			else if (out) getUTF8FromUniChar(out, &scratch);
+		}
+		text.swap(scratch);
+		// the fused filters share one pass, so they are timed as one
+		SWMETRICS_FILTER_SINCE(stageStart, (module) ? module->getName() : 0, "FilterPipeline character filters");
+	}
+}
+
+
+SWORD_NAMESPACE_END
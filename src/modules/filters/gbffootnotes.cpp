@@ -103,15 +103,15 @@ char GBFFootnotes::processText (SWBuf &text, const SWKey *key, const SWModule *m
 							continue;
 						}
 					}
-					SWBuf fc = module->getEntryAttributes()["Footnote"]["count"]["value"];
-					footnoteNum = (fc.length()) ? atoi(fc.c_str()) : 0;
+					const char *fc = module->getEntryAttributeStore().get("Footnote", "count", "value");
+					footnoteNum = (fc) ? atoi(fc) : 0;
 					sprintf(buf, "%i", ++footnoteNum);
-					module->getEntryAttributes()["Footnote"]["count"]["value"] = buf;
+					module->getEntryAttributeStore().set("Footnote", "count", "value", buf);
 					StringList attributes = startTag.getAttributeNames();
 					for (StringList::const_iterator it = attributes.begin(); it != attributes.end(); it++) {
-						module->getEntryAttributes()["Footnote"][buf][it->c_str()] = startTag.getAttribute(it->c_str());
+						module->getEntryAttributeStore().set("Footnote", buf, it->c_str(), startTag.getAttribute(it->c_str()));
 					}
-					module->getEntryAttributes()["Footnote"][buf]["body"] = tagText;
+					module->getEntryAttributeStore().set("Footnote", buf, "body", tagText);
 					startTag.setAttribute("swordFootnote", buf);
 				}
 				hide = false;
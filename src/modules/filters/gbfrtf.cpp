@@ -90,7 +90,7 @@ char GBFRTF::processText(SWBuf &text, const SWKey *key, const SWModule *module)
 					else {
 						// verb morph
 						sprintf(wordstr, "%03d", word-1);
-						module->getEntryAttributes()["Word"][wordstr]["Morph"] = val;
+						module->getEntryAttributeStore().set("Word", wordstr, "Morph", val);
 					}
 					*/
 				}
@@ -111,7 +111,7 @@ char GBFRTF::processText(SWBuf &text, const SWKey *key, const SWModule *module)
 						else {
 							// verb morph
 							sprintf(wordstr, "%03d", word-1);
-							module->getEntryAttributes()["Word"][wordstr]["Morph"] = val;
+							module->getEntryAttributeStore().set("Word", wordstr, "Morph", val);
 						}
 						*/
 					}
@@ -89,19 +89,19 @@ char GBFStrongs::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 					if (atoi((!isdigit(*val))?val+1:val) < 5627) {
 						// normal strongs number
 						sprintf(wordstr, "%03d", word++);
-						module->getEntryAttributes()["Word"][wordstr]["PartsCount"] = "1";
-						module->getEntryAttributes()["Word"][wordstr]["Lemma"] = val;
-						module->getEntryAttributes()["Word"][wordstr]["LemmaClass"] = "strong";
+						module->getEntryAttributeStore().set("Word", wordstr, "PartsCount", "1");
+						module->getEntryAttributeStore().set("Word", wordstr, "Lemma", val);
+						module->getEntryAttributeStore().set("Word", wordstr, "LemmaClass", "strong");
 						tmp = "";
 						tmp.append(text.c_str()+textStart, (int)(textEnd - textStart));
-						module->getEntryAttributes()["Word"][wordstr]["Text"] = tmp;
+						module->getEntryAttributeStore().set("Word", wordstr, "Text", tmp);
 						newText = true;
 					}
 					else {
 						// verb morph
 						sprintf(wordstr, "%03d", word-1);
-						module->getEntryAttributes()["Word"][wordstr]["Morph"] = val;
-						module->getEntryAttributes()["Word"][wordstr]["MorphClass"] = "OLBMorph";
+						module->getEntryAttributeStore().set("Word", wordstr, "Morph", val);
+						module->getEntryAttributeStore().set("Word", wordstr, "MorphClass", "OLBMorph");
 					}
 				}
 
@@ -121,8 +121,8 @@ char GBFStrongs::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 						*valto++ = token[i];
 					*valto = 0;
 					sprintf(wordstr, "%03d", word-1);
-					module->getEntryAttributes()["Word"][wordstr]["MorphClass"] = "GBFMorph";
-					module->getEntryAttributes()["Word"][wordstr]["Morph"] = val;
+					module->getEntryAttributeStore().set("Word", wordstr, "MorphClass", "GBFMorph");
+					module->getEntryAttributeStore().set("Word", wordstr, "Morph", val);
 					newText = true;
 				}
 			}
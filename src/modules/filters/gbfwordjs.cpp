@@ -41,6 +41,11 @@ namespace {
 		static const StringList oVals(&choices[0], &choices[2]);
 		return &oVals;
 	}
+
+	const char *wordAttribute(const EntryAttributeStore &attributes, const char *word, const char *name) {
+		const char *value = attributes.get("Word", word, name);
+		return (value) ? value : "";
+	}
 }
 
 
@@ -70,7 +75,7 @@ char GBFWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modul
 		SWBuf tmp;
 		bool newText = false;
 		bool needWordOut = false;
-		AttributeValue *wordAttrs = 0;
+		const char *wordItem = 0;
 		SWBuf modName = (module)?module->getName():"";
 		SWBuf wordSrcPrefix = modName;
 		
@@ -99,23 +104,23 @@ char GBFWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modul
 						// normal strongs number
 						sprintf(wordstr, "%03d", word++);
 						needWordOut = (word > 2);
-						wordAttrs = &(module->getEntryAttributes()["Word"][wordstr]);
-						(*wordAttrs)["Lemma"] = val;
+						wordItem = wordstr;
+						module->getEntryAttributeStore().set("Word", wordItem, "Lemma", val);
 	//printf("Adding: [\"Word\"][%s][\"Strongs\"] = %s\n", wordstr, val);
 						tmp = "";
 						tmp.append(text.c_str()+textStart, (int)(textEnd - textStart));
-						(*wordAttrs)["Text"] = tmp;
+						module->getEntryAttributeStore().set("Word", wordItem, "Text", tmp);
 						text.append("</span>");
 						SWBuf ts;
 						ts.appendFormatted("%d", textStart);
-						(*wordAttrs)["TextStart"] = ts;
+						module->getEntryAttributeStore().set("Word", wordItem, "TextStart", ts);
 	//printf("Adding: [\"Word\"][%s][\"Text\"] = %s\n", wordstr, tmp.c_str());
 						newText = true;
 					}
 					else {
 						// verb morph
-						if (wordAttrs) {
-							(*wordAttrs)["Morph"] = val;
+						if (wordItem) {
+							module->getEntryAttributeStore().set("Word", wordItem, "Morph", val);
 						}
 	//printf("Adding: [\"Word\"][%s][\"Morph\"] = %s\n", wordstr, val);
 					}
@@ -126,9 +131,9 @@ char GBFWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modul
 						strcpy(val, token+2);
 					}
 					else strcpy(val, token+1);
-					if (wordAttrs) {
-						(*wordAttrs)["Morph"] = val;
-						(*wordAttrs)["MorphClass"] = "StrongsMorph";
+					if (wordItem) {
+						module->getEntryAttributeStore().set("Word", wordItem, "Morph", val);
+						module->getEntryAttributeStore().set("Word", wordItem, "MorphClass", "StrongsMorph");
 					}
 					newText = true;
 				}
@@ -139,13 +144,13 @@ char GBFWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modul
 				if (needWordOut) {
 					char wstr[12];
 					sprintf(wstr, "%03d", word-2);
-					AttributeValue *wAttrs = &(module->getEntryAttributes()["Word"][wstr]);
+					const EntryAttributeStore &wAttrs = module->getEntryAttributeStore();
 					needWordOut = false;
-					SWBuf strong = (*wAttrs)["Lemma"];
-					SWBuf morph = (*wAttrs)["Morph"];
-					SWBuf morphClass = (*wAttrs)["MorphClass"];
-					SWBuf wordText = (*wAttrs)["Text"];
-					SWBuf textSt = (*wAttrs)["TextStart"];
+					SWBuf strong = wordAttribute(wAttrs, wstr, "Lemma");
+					SWBuf morph = wordAttribute(wAttrs, wstr, "Morph");
+					SWBuf morphClass = wordAttribute(wAttrs, wstr, "MorphClass");
+					SWBuf wordText = wordAttribute(wAttrs, wstr, "Text");
+					SWBuf textSt = wordAttribute(wAttrs, wstr, "TextStart");
 					if (strong.size()) {
 						char gh = 0;
 						gh = isdigit(strong[0]) ? 0:strong[0];
@@ -236,13 +241,13 @@ char GBFWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modul
 
 		char wstr[12];
 		sprintf(wstr, "%03d", word-1);
-		AttributeValue *wAttrs = &(module->getEntryAttributes()["Word"][wstr]);
+		const EntryAttributeStore &wAttrs = module->getEntryAttributeStore();
 		needWordOut = false;
-		SWBuf strong = (*wAttrs)["Lemma"];
-		SWBuf morph = (*wAttrs)["Morph"];
-		SWBuf morphClass = (*wAttrs)["MorphClass"];
-		SWBuf wordText = (*wAttrs)["Text"];
-		SWBuf textSt = (*wAttrs)["TextStart"];
+		SWBuf strong = wordAttribute(wAttrs, wstr, "Lemma");
+		SWBuf morph = wordAttribute(wAttrs, wstr, "Morph");
+		SWBuf morphClass = wordAttribute(wAttrs, wstr, "MorphClass");
+		SWBuf wordText = wordAttribute(wAttrs, wstr, "Text");
+		SWBuf textSt = wordAttribute(wAttrs, wstr, "TextStart");
 		if (strong.size()) {
 			char gh = 0;
 			gh = isdigit(strong[0]) ? 0:strong[0];
@@ -69,7 +69,7 @@ char GreekLexAttribs::processText(SWBuf &text, const SWKey *key, const SWModule
 										*valto++ = from[i];
 									*valto = 0;
 									sprintf(wordstr, "%03d", number+1);
-									module->getEntryAttributes()["AVPhrase"][wordstr]["CompoundedWith"] = val;
+									module->getEntryAttributeStore().set("AVPhrase", wordstr, "CompoundedWith", val);
 									from += strlen(val);
 								}
 							}
@@ -89,13 +89,13 @@ char GreekLexAttribs::processText(SWBuf &text, const SWKey *key, const SWModule
 								phrase.erase(phrase.find_first_of("("), 1);
 								phrase.erase(phrase.find_first_of(")"), 1);
 								phrase.erase(0,phrase.find_first_not_of("\r\n\v\t ")); phrase.erase(phrase.find_last_not_of("\r\n\v\t ")+1);
-								module->getEntryAttributes()["AVPhrase"][wordstr]["Alt"] = phrase.c_str();
+								module->getEntryAttributeStore().set("AVPhrase", wordstr, "Alt", phrase.c_str());
 								phrase = tmp;
 							}
 							phrase.erase(0,phrase.find_first_not_of("\r\n\v\t ")); phrase.erase(phrase.find_last_not_of("\r\n\v\t ")+1);
 							freq.erase(0,freq.find_first_not_of("\r\n\v\t ")); freq.erase(freq.find_last_not_of("\r\n\v\t ")+1);
-							module->getEntryAttributes()["AVPhrase"][wordstr]["Phrase"] = phrase.c_str();
-							module->getEntryAttributes()["AVPhrase"][wordstr]["Frequency"] = freq.c_str();
+							module->getEntryAttributeStore().set("AVPhrase", wordstr, "Phrase", phrase.c_str());
+							module->getEntryAttributeStore().set("AVPhrase", wordstr, "Frequency", freq.c_str());
 							currentPhrase = 0;
 							currentPhraseEnd = 0;
 						}
@@ -23,8 +23,10 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <latin1utf8.h>
 #include <swmodule.h>
+#include <utilstr.h>
 
 
 SWORD_NAMESPACE_START
@@ -41,12 +43,20 @@ char Latin1UTF8::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 	if ((size_t)key < 2)	// hack, we're en(1)/de(0)ciphering
 		return (char)-1;
 
+	// ASCII is the same in both
+	unsigned long len = strlen(text.c_str());
+	unsigned long ascii = getASCIILength(text.c_str(), len);
+	if (ascii == text.length()) return 0;
+
 	SWBuf orig = text;
-	from = (const unsigned char *)orig.c_str();
+	from = (const unsigned char *)orig.c_str() + ascii;
+	const unsigned char *end = (const unsigned char *)orig.c_str() + len;
 
-	for (text = ""; *from; from++) {
+	for (text.setSize(ascii); *from; from++) {
 	  if (*from < 0x80) {
-	    text += *from;
+	    ascii = getASCIILength((const char *)from, end - from);
+	    text.append((const char *)from, ascii);
+	    from += ascii - 1;
 	  }
 	  else if (*from < 0xc0) {
                 switch(*from) {
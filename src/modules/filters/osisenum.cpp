@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <osisenum.h>
 #include <utilxml.h>
+#include <xmltokenlist.h>
 
 
 SWORD_NAMESPACE_START
@@ -50,47 +51,23 @@ OSISEnum::~OSISEnum() {
 
 
 char OSISEnum::processText(SWBuf &text, const SWKey *key, const SWModule *module) {
-	SWBuf token;
-	bool intoken = false;
+	if (!option) {
+		XMLTokenList tokens(text);
+		processTokens(tokens, key, module);
+		tokens.getText(text);
+	}
+	return 0;
+}
 
-	const SWBuf orig = text;
-	const char * from = orig.c_str();
 
-	if (!option) {
-		for (text = ""; *from; ++from) {
-			if (*from == '<') {
-				intoken = true;
-				token = "";
-				continue;
-			}
-			if (*from == '>') {	// process tokens
-				intoken = false;
-				if (token.startsWith("w ")) {	// Word
-					XMLTag wtag(token);
-					const char *l = wtag.getAttribute("n");
-					if (l) {
-						wtag.setAttribute("n", 0);
-						token = wtag;
-						token.trim();
-						// drop <>
-						token << 1;
-						token--;
-					}
-				}
-				
-				// keep token in text
-				text.append('<');
-				text.append(token);
-				text.append('>');
-				
-				continue;
-			}
-			if (intoken) {
-				token += *from;
-			}
-			else	{
-				text.append(*from);
-			}
+char OSISEnum::processTokens(XMLTokenList &tokens, const SWKey *key, const SWModule *module) {
+	for (int i = 0; i < tokens.getCount(); ++i) {
+		if (!tokens.isTag(i) || !tokens.startsWith(i, "w ")) continue;	// Word
+
+		XMLTag &wtag = tokens.getTag(i);
+		if (wtag.getAttribute("n")) {
+			wtag.setAttribute("n", 0);
+			tokens.tagChanged(i);
 		}
 	}
 	return 0;
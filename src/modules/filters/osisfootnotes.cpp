@@ -63,13 +63,8 @@ char OSISFootnotes::processText(SWBuf &text, const SWKey *key, const SWModule *m
 	SWBuf refs = "";
 	int footnoteNum = 1;
 	char buf[254];
-	SWKey *p = (module) ? module->createKey() : (key) ? key->clone() : new VerseKey();
-        VerseKey *parser = SWDYNAMIC_CAST(VerseKey, p);
-        if (!parser) {
-        	delete p;
-                parser = new VerseKey();
-        }
-        *parser = key->getText();
+	// only cross references need a key parsed, which is costly, so wait until we see one
+	VerseKey *parser = 0;
 
 	SWBuf orig = text;
 	const char *from = orig.c_str();
@@ -123,14 +118,24 @@ char OSISFootnotes::processText(SWBuf &text, const SWKey *key, const SWModule *m
 						sprintf(buf, "%i", footnoteNum++);
 						StringList attributes = startTag.getAttributeNames();
 						for (StringList::const_iterator it = attributes.begin(); it != attributes.end(); it++) {
-							module->getEntryAttributes()["Footnote"][buf][it->c_str()] = startTag.getAttribute(it->c_str());
+							module->getEntryAttributeStore().set("Footnote", buf, it->c_str(), startTag.getAttribute(it->c_str()));
 						}
-						module->getEntryAttributes()["Footnote"][buf]["body"] = tagText;
+						module->getEntryAttributeStore().set("Footnote", buf, "body", tagText);
 						startTag.setAttribute("swordFootnote", buf);
 						if ((startTag.getAttribute("type")) && (!strcmp(startTag.getAttribute("type"), "crossReference"))) {
-							if (!refs.length())
+							if (!refs.length()) {
+								if (!parser) {
+									SWKey *p = (module) ? module->createKey() : (key) ? key->clone() : new VerseKey();
+									parser = SWDYNAMIC_CAST(VerseKey, p);
+									if (!parser) {
+										delete p;
+										parser = new VerseKey();
+									}
+									*parser = key->getText();
+								}
 								refs = parser->parseVerseList(tagText.c_str(), *parser, true).getRangeText();
-							module->getEntryAttributes()["Footnote"][buf]["refList"] = refs.c_str();
+							}
+							module->getEntryAttributeStore().set("Footnote", buf, "refList", refs.c_str());
 						}
 					}
 					hide = false;
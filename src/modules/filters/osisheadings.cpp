@@ -114,16 +114,16 @@ bool OSISHeadings::handleToken(SWBuf &buf, const char *token, BasicFilterUserDat
 							heading += tag;
 						}
 						else heading = u->heading;
-						u->module->getEntryAttributes()["Heading"][(preverse)?"Preverse":"Interverse"][hn] = heading;
+						u->module->getEntryAttributeStore().set("Heading", (preverse)?"Preverse":"Interverse", hn, heading);
 
 						StringList attributes = u->currentHeadingTag.getAttributeNames();
 						for (StringList::const_iterator it = attributes.begin(); it != attributes.end(); it++) {
-							u->module->getEntryAttributes()["Heading"][hn][it->c_str()] = u->currentHeadingTag.getAttribute(it->c_str());
+							u->module->getEntryAttributeStore().set("Heading", hn, it->c_str(), u->currentHeadingTag.getAttribute(it->c_str()));
 						}
 						// if any title in the heading was canonical, then set canonical=true.
 						// TODO: split composite headings with both canonical and non-canonical headings
 						// into two heading attributes with proper canonical value on each
-						if (u->canonical) u->module->getEntryAttributes()["Heading"][hn]["canonical"] = "true";
+						if (u->canonical) u->module->getEntryAttributeStore().set("Heading", hn, "canonical", "true");
 					}
 
 					// do we want the heading in the body?
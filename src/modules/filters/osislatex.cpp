@@ -290,7 +290,8 @@ bool OSISLaTeX::handleToken(SWBuf &buf, const char *token, BasicFilterUserData *
 						SWBuf footnoteNumber = tag.getAttribute("swordFootnote");
 						SWBuf footnoteBody = "";
 						if (u->module){
-							footnoteBody += u->module->getEntryAttributes()["Footnote"][footnoteNumber]["body"];
+							const char *body = u->module->getEntryAttributeStore().get("Footnote", footnoteNumber, "body");
+							if (body) footnoteBody += body;
 						}
 						SWBuf noteName = tag.getAttribute("n");
 
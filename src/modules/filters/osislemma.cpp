@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <osislemma.h>
 #include <utilxml.h>
+#include <xmltokenlist.h>
 
 
 SWORD_NAMESPACE_START
@@ -50,65 +51,41 @@ OSISLemma::~OSISLemma() {
 
 
 char OSISLemma::processText(SWBuf &text, const SWKey *key, const SWModule *module) {
-	SWBuf token;
-	bool intoken = false;
+	if (!option) {
+		XMLTokenList tokens(text);
+		processTokens(tokens, key, module);
+		tokens.getText(text);
+	}
+	return 0;
+}
 
-	const SWBuf orig = text;
-	const char * from = orig.c_str();
 
-	if (!option) {
-		for (text = ""; *from; ++from) {
-			if (*from == '<') {
-				intoken = true;
-				token = "";
-				continue;
-			}
-			if (*from == '>') {	// process tokens
-				intoken = false;
-				if (token.startsWith("w ")) {	// Word
-					XMLTag wtag(token);
-
-					// always save off lemma if we haven't yet
-					if (!wtag.getAttribute("savlm")) {
-						const char *l = wtag.getAttribute("lemma");
-						if (l) {
-							wtag.setAttribute("savlm", l);
-						}
-					}
-
-					int count = wtag.getAttributePartCount("lemma", ' ');
-					for (int i = 0; i < count; i++) {
-						SWBuf a = wtag.getAttribute("lemma", i, ' ');
-						const char *prefix = a.stripPrefix(':');
-						if ((!prefix) || ((SWBuf)prefix).startsWith("lemma.")) {
-							// remove attribute part
-							wtag.setAttribute("lemma", 0, i, ' ');
-							i--;
-							count--;
-						}
-					}
-
-					token = wtag;
-					token.trim();
-					// drop <>
-					token << 1;
-					token--;
-				}
-				
-				// keep token in text
-				text.append('<');
-				text.append(token);
-				text.append('>');
-				
-				continue;
-			}
-			if (intoken) {
-				token += *from;
+char OSISLemma::processTokens(XMLTokenList &tokens, const SWKey *key, const SWModule *module) {
+	for (int t = 0; t < tokens.getCount(); ++t) {
+		if (!tokens.isTag(t) || !tokens.startsWith(t, "w ")) continue;	// Word
+
+		XMLTag &wtag = tokens.getTag(t);
+
+		// always save off lemma if we haven't yet
+		if (!wtag.getAttribute("savlm")) {
+			const char *l = wtag.getAttribute("lemma");
+			if (l) {
+				wtag.setAttribute("savlm", l);
 			}
-			else	{
-				text.append(*from);
+		}
+
+		int count = wtag.getAttributePartCount("lemma", ' ');
+		for (int i = 0; i < count; i++) {
+			SWBuf a = wtag.getAttribute("lemma", i, ' ');
+			const char *prefix = a.stripPrefix(':');
+			if ((!prefix) || ((SWBuf)prefix).startsWith("lemma.")) {
+				// remove attribute part
+				wtag.setAttribute("lemma", 0, i, ' ');
+				i--;
+				count--;
 			}
 		}
+		tokens.tagChanged(t);
 	}
 	return 0;
 }
@@ -23,6 +23,7 @@
 
 #include <stdlib.h>
 #include <osismorph.h>
+#include <xmltokenlist.h>
 
 SWORD_NAMESPACE_START
 
@@ -48,56 +49,29 @@ OSISMorph::~OSISMorph() {
 
 
 char OSISMorph::processText(SWBuf &text, const SWKey *key, const SWModule *module) {
-	if (!option) {	// if we don't want morph tags
-		char token[2048]; // cheese.  Fix.
-		int tokpos = 0;
-		bool intoken = false;
-		SWBuf orig = text;
-		const char *from = orig.c_str();
-		
-		//taken out of the loop for speed
-		const char* start = 0;
-		const char* end = 0;
-
-		for (text = ""; *from; ++from) {
-			if (*from == '<') {
-				intoken = true;
-				tokpos = 0;
-				token[0] = 0;
-				continue;
-			}
-			if (*from == '>') {	// process tokens
-				intoken = false;
-				
-				if ((*token == 'w') && (token[1] == ' ')) {
-					start = strstr(token+2, "morph=\""); //we leave out "w " at the start
-					end = start ? strchr(start+7, '"') : 0; //search the end of the morph value
-
-					if (start && end) { //start and end of the morph tag found
-						text.append('<');
-						text.append(token, start-token); //the text before the morph attr
-						text.append(end+1); //text after the morph attr
-						text.append('>');
-						
-						continue; //next loop
-					}
-				}
-				
-				text.append('<');
-				text.append(token);
-				text.append('>');
-				
-				continue;
-			}
-			if (intoken) {
-				if (tokpos < 2045) {
-					token[tokpos++] = *from;
-					token[tokpos] = 0;
-				}
-			}
-			else {
-				text.append(*from);
-			}
+	if (!option) {
+		XMLTokenList tokens(text);
+		processTokens(tokens, key, module);
+		tokens.getText(text);
+	}
+	return 0;
+}
+
+
+char OSISMorph::processTokens(XMLTokenList &tokens, const SWKey *key, const SWModule *module) {
+	SWBuf edited;
+	for (int i = 0; i < tokens.getCount(); ++i) {
+		if (!tokens.isTag(i) || !tokens.startsWith(i, "w ")) continue;
+
+		const char *token = tokens.getTokenText(i);
+		const char *start = strstr(token+2, "morph=\""); //we leave out "w " at the start
+		const char *end = start ? strchr(start+7, '"') : 0; //search the end of the morph value
+
+		if (start && end) { //start and end of the morph tag found
+			edited.setSize(0);
+			edited.append(token, start-token); //the text before the morph attr
+			edited.append(end+1); //text after the morph attr
+			tokens.setTokenText(i, edited);
 		}
 	}
 	return 0;
@@ -88,7 +88,7 @@ char OSISMorphSegmentation::processText(SWBuf &text, const SWKey * /*key*/, cons
 
 				if (tag.isEndTag() && inMorpheme) {
 						buf.setFormatted("%.3d", morphemeNum++);
-						module->getEntryAttributes()["Morpheme"][buf]["body"] = tagText;
+						module->getEntryAttributeStore().set("Morpheme", buf, "body", tagText);
 						inMorpheme = false;
 				}
 				if (hide) { //hides start and end tags as long as hide is set
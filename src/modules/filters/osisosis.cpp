@@ -156,8 +156,8 @@ bool OSISOSIS::handleToken(SWBuf &buf, const char *token, BasicFilterUserData *u
 				if (u->module) {
                                         XMLTag tag = token; 
                                         SWBuf swordFootnote = tag.getAttribute("swordFootnote");
-                                        SWBuf footnoteBody = u->module->getEntryAttributes()["Footnote"][swordFootnote]["body"];
-                                        buf.append(u->module->renderText(footnoteBody));
+                                        const char *footnoteBody = u->module->getEntryAttributeStore().get("Footnote", swordFootnote, "body");
+                                        buf.append(u->module->renderText(footnoteBody ? footnoteBody : ""));
                                 }
 			}
 			if (tag.isEndTag()) {
@@ -183,8 +183,8 @@ bool OSISPlain::handleToken(SWBuf &buf, const char *token, BasicFilterUserData *
 				if (u->module) {
 					XMLTag tag = token;
 					SWBuf swordFootnote = tag.getAttribute("swordFootnote");
-					SWBuf footnoteBody = u->module->getEntryAttributes()["Footnote"][swordFootnote]["body"];
-					buf.append(u->module->renderText(footnoteBody));
+					const char *footnoteBody = u->module->getEntryAttributeStore().get("Footnote", swordFootnote, "body");
+					buf.append(u->module->renderText(footnoteBody ? footnoteBody : ""));
 				}
 			}
 		else if (!strncmp(token, "/note", 5)) {
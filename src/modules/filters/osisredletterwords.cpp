@@ -23,6 +23,7 @@
 
 #include <stdlib.h>
 #include <osisredletterwords.h>
+#include <xmltokenlist.h>
 #include <swmodule.h>
 
 
@@ -52,52 +53,28 @@ OSISRedLetterWords::~OSISRedLetterWords() {
 char OSISRedLetterWords::processText(SWBuf &text, const SWKey *key, const SWModule *module) {
 	if (option) //leave in the red lettered words
 		return 0;
-	
-	SWBuf token;
-	bool intoken    = false;
-
-	SWBuf orig = text;
-	const char *from = orig.c_str();
-
-	//taken out of the loop
-	const char* start = 0;
-	const char* end = 0;
-		
-	for (text = ""; *from; from++) {
-		if (*from == '<') {
-			intoken = true;
-			token = "";
-			continue;
-		}
-		else if (*from == '>') {	// process tokens
-			intoken = false;
-
-			if ((token[0] == 'q') && (token[1] == ' ')) { //q tag
-				start = strstr(token.c_str(), " who=\"Jesus\"");
-				if (start && (strlen(start) >= 12)) { //we found a quote of Jesus Christ
-					end = start+12; //marks the end of the who attribute value
-					
-					text.append('<');
-					text.append(token, start - (token.c_str())); //the text before the who attr
-					text.append(end, token.c_str() + token.length() - end);  //text after the who attr
-					text.append('>');
-					
-					continue;
-				}
-			}
-			
-			//token not processed, append it. We don't want to alter the text
-			text.append('<');
-			text.append(token);
-			text.append('>');
-			continue;
-		}
-		
-		if (intoken) { //copy token
-			token.append(*from);
-		}
-		else { //copy text which is not inside a token
-			text.append(*from);
+
+	XMLTokenList tokens(text);
+	processTokens(tokens, key, module);
+	tokens.getText(text);
+	return 0;
+}
+
+
+char OSISRedLetterWords::processTokens(XMLTokenList &tokens, const SWKey *key, const SWModule *module) {
+	SWBuf edited;
+	for (int i = 0; i < tokens.getCount(); ++i) {
+		if (!tokens.isTag(i) || !tokens.startsWith(i, "q ")) continue; //q tag
+
+		const char *token = tokens.getTokenText(i);
+		const char *start = strstr(token, " who=\"Jesus\"");
+		if (start && (strlen(start) >= 12)) { //we found a quote of Jesus Christ
+			const char *end = start+12; //marks the end of the who attribute value
+
+			edited.setSize(0);
+			edited.append(token, start - token); //the text before the who attr
+			edited.append(end);  //text after the who attr
+			tokens.setTokenText(i, edited);
 		}
 	}
 	return 0;
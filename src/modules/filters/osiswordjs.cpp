@@ -99,19 +99,23 @@ char OSISWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 					SWBuf page;
 					SWBuf src;
 					char gh = 0;
-					page = module->getEntryAttributes()["Word"][wordstr]["Page"].c_str();
-					if (page.length()) page = (SWBuf)"p:" + page;
-					int count = atoi(module->getEntryAttributes()["Word"][wordstr]["PartCount"].c_str());
+					const EntryAttributeStore &attributes = module->getEntryAttributeStore();
+					const char *value = attributes.get("Word", wordstr, "Page");
+					if (value && *value) page = (SWBuf)"p:" + value;
+					value = attributes.get("Word", wordstr, "PartCount");
+					int count = value ? atoi(value) : 0;
 					for (int i = 0; i < count; i++) {
 
 						// for now, lemma class can just be equal to last lemma class in multi part word
 						SWBuf tmp = "LemmaClass";
 						if (count > 1) tmp.appendFormatted(".%d", i+1);
-						lemmaClass = module->getEntryAttributes()["Word"][wordstr][tmp];
+						value = attributes.get("Word", wordstr, tmp);
+						lemmaClass = value ? value : "";
 
 						tmp = "Lemma";
 						if (count > 1) tmp.appendFormatted(".%d", i+1);
-						tmp = (module->getEntryAttributes()["Word"][wordstr][tmp].c_str());
+						value = attributes.get("Word", wordstr, tmp);
+						tmp = value ? value : "";
 
 						// if we're strongs, 
 						if (lemmaClass == "strong") {
@@ -123,13 +127,15 @@ char OSISWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 
 						tmp = "Morph";
 						if (count > 1) tmp.appendFormatted(".%d", i+1);
-						tmp = (module->getEntryAttributes()["Word"][wordstr][tmp].c_str());
+						value = attributes.get("Word", wordstr, tmp);
+						tmp = value ? value : "";
 						if (morph.size()) morph += "|";
 						morph += tmp;
 
 						tmp = "Src";
 						if (count > 1) tmp.appendFormatted(".%d", i+1);
-						tmp = (module->getEntryAttributes()["Word"][wordstr][tmp].c_str());
+						value = attributes.get("Word", wordstr, tmp);
+						tmp = value ? value : "";
 						if (!tmp.length()) tmp.appendFormatted("%d", wordNum);
 						tmp.insert(0, wordSrcPrefix);
 						if (src.size()) src += "|";
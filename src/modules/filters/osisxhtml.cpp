@@ -207,7 +207,7 @@ void OSISXHTML::MyUserData::outputNewline(SWBuf &buf) {
 		// any newlines at the start of a verse should get appended to a preverse heading
 		// since preverse cause a newline, simply be sure we have a preverse
 		if (!buf.size() && vkey && vkey->getVerse() && module && module->isProcessEntryAttributes()) {
-			module->getEntryAttributes()["Heading"]["Preverse"]["0"] += "<div></div>";
+			module->getEntryAttributeStore().append("Heading", "Preverse", "0", "<div></div>");
 		}
 		else {
 			outText("<br />\n", buf, this);
@@ -241,7 +241,8 @@ bool TEILaTeX::handleToken(SWBuf &buf, const char *token, BasicFilterUserData *u
 				SWBuf noteName = tag.getAttribute("n");
 				SWBuf footnoteBody = "";
 				if (u->module){
-					footnoteBody += u->module->getEntryAttributes()["Footnote"][footnoteNumber]["body"];
+					const char *body = u->module->getEntryAttributeStore().get("Footnote", footnoteNumber, "body");
+					if (body) footnoteBody += body;
 				}
 										
 				buf.appendFormatted("\\swordfootnote{%s}{%s}{%s}{%s}{",
@@ -64,13 +64,8 @@ char ThMLFootnotes::processText(SWBuf &text, const SWKey *key, const SWModule *m
 	SWBuf refs = "";
 	int footnoteNum = 1;
 	char buf[254];
-	SWKey *p = (module) ? module->createKey() : (key) ? key->clone() : new VerseKey();
-        VerseKey *parser = SWDYNAMIC_CAST(VerseKey, p);
-        if (!parser) {
-        	delete p;
-                parser = new VerseKey();
-        }
-        *parser = key->getText();
+	// only cross references need a key parsed, which is costly, so wait until we see one
+	VerseKey *parser = 0;
 
 	SWBuf orig = text;
 	const char *from = orig.c_str();
@@ -97,20 +92,30 @@ char ThMLFootnotes::processText(SWBuf &text, const SWKey *key, const SWModule *m
 				}
 				if (hide && tag.isEndTag()) {
 					if (module->isProcessEntryAttributes()) {
-						SWBuf fc = module->getEntryAttributes()["Footnote"]["count"]["value"];
-						footnoteNum = (fc.length()) ? atoi(fc.c_str()) : 0;
+						const char *fc = module->getEntryAttributeStore().get("Footnote", "count", "value");
+						footnoteNum = (fc) ? atoi(fc) : 0;
 						sprintf(buf, "%i", ++footnoteNum);
-						module->getEntryAttributes()["Footnote"]["count"]["value"] = buf;
+						module->getEntryAttributeStore().set("Footnote", "count", "value", buf);
 						StringList attributes = startTag.getAttributeNames();
 						for (StringList::iterator it = attributes.begin(); it != attributes.end(); it++) {
-							module->getEntryAttributes()["Footnote"][buf][it->c_str()] = startTag.getAttribute(it->c_str());
+							module->getEntryAttributeStore().set("Footnote", buf, it->c_str(), startTag.getAttribute(it->c_str()));
 						}
-						module->getEntryAttributes()["Footnote"][buf]["body"] = tagText;
+						module->getEntryAttributeStore().set("Footnote", buf, "body", tagText);
 						startTag.setAttribute("swordFootnote", buf);
 						if ((startTag.getAttribute("type")) && (!strcmp(startTag.getAttribute("type"), "crossReference"))) {
-							if (!refs.length())
+							if (!refs.length()) {
+								if (!parser) {
+									SWKey *p = (module) ? module->createKey() : (key) ? key->clone() : new VerseKey();
+									parser = SWDYNAMIC_CAST(VerseKey, p);
+									if (!parser) {
+										delete p;
+										parser = new VerseKey();
+									}
+									*parser = key->getText();
+								}
 								refs = parser->parseVerseList(tagText.c_str(), *parser, true).getRangeText();
-							module->getEntryAttributes()["Footnote"][buf]["refList"] = refs.c_str();
+							}
+							module->getEntryAttributeStore().set("Footnote", buf, "refList", refs.c_str());
 						}
 					}
 					hide = false;
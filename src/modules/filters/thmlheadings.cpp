@@ -97,11 +97,11 @@ char ThMLHeadings::processText(SWBuf &text, const SWKey *key, const SWModule *mo
 						heading += tag;
 						if (preverse) {
 							sprintf(buf, "%i", pvHeaderNum++);
-							module->getEntryAttributes()["Heading"]["Preverse"][buf] = heading;
+							module->getEntryAttributeStore().set("Heading", "Preverse", buf, heading);
 						}
 						else {
 							sprintf(buf, "%i", headerNum++);
-							module->getEntryAttributes()["Heading"]["Interverse"][buf] = heading;
+							module->getEntryAttributeStore().set("Heading", "Interverse", buf, heading);
 							if (option) {	// we want the tag in the text
 								text.append(header);
 							}
@@ -109,7 +109,7 @@ char ThMLHeadings::processText(SWBuf &text, const SWKey *key, const SWModule *mo
 						
 						StringList attributes = startTag.getAttributeNames();
 						for (StringList::const_iterator it = attributes.begin(); it != attributes.end(); it++) {
-							module->getEntryAttributes()["Heading"][buf][it->c_str()] = startTag.getAttribute(it->c_str());
+							module->getEntryAttributeStore().set("Heading", buf, it->c_str(), startTag.getAttribute(it->c_str()));
 						}
 					}
 					
@@ -221,7 +221,8 @@ bool ThMLLaTeX::handleToken(SWBuf &buf, const char *token, BasicFilterUserData *
 					SWBuf noteName = tag.getAttribute("n");
 					SWBuf footnoteBody = "";
 					if (u->module){
-					        footnoteBody += u->module->getEntryAttributes()["Footnote"][footnoteNumber]["body"];
+					        const char *body = u->module->getEntryAttributeStore().get("Footnote", footnoteNumber, "body");
+					        if (body) footnoteBody += body;
                                         }
 					if (u->vkey) {
 						// leave this special osis type in for crossReference notes types?  Might thml use this some day? Doesn't hurt.
@@ -281,7 +282,8 @@ bool ThMLLaTeX::handleToken(SWBuf &buf, const char *token, BasicFilterUserData *
 					SWBuf noteName = tag.getAttribute("n");
 					SWBuf footnoteBody = "";
 					if (u->module){
-					        footnoteBody += u->module->getEntryAttributes()["Footnote"][footnoteNumber]["body"];
+					        const char *body = u->module->getEntryAttributeStore().get("Footnote", footnoteNumber, "body");
+					        if (body) footnoteBody += body;
                                         }
 					if (u->vkey) {
 						// leave this special osis type in for crossReference notes types?  Might thml use this some day? Doesn't hurt.
@@ -91,24 +91,24 @@ char ThMLStrongs::processText(SWBuf &text, const SWKey *key, const SWModule *mod
 					if (atoi((!isdigit(*val))?val+1:val) < 5627) {
 						// normal strongs number
 						sprintf(wordstr, "%03d", word);
-						module->getEntryAttributes()["Word"][wordstr]["PartCount"] = "1";
-						module->getEntryAttributes()["Word"][wordstr]["Lemma"] = val;
-						module->getEntryAttributes()["Word"][wordstr]["LemmaClass"] = "strong";
-						module->getEntryAttributes()["Word"][wordstr]["Lemma.1"] = val;
-						module->getEntryAttributes()["Word"][wordstr]["LemmaClass.1"] = "strong";
+						module->getEntryAttributeStore().set("Word", wordstr, "PartCount", "1");
+						module->getEntryAttributeStore().set("Word", wordstr, "Lemma", val);
+						module->getEntryAttributeStore().set("Word", wordstr, "LemmaClass", "strong");
+						module->getEntryAttributeStore().set("Word", wordstr, "Lemma.1", val);
+						module->getEntryAttributeStore().set("Word", wordstr, "LemmaClass.1", "strong");
 						tmp = "";
 						tmp.append(text.c_str()+textStart, (int)(textEnd - textStart));
-						module->getEntryAttributes()["Word"][wordstr]["Text"] = tmp;
+						module->getEntryAttributeStore().set("Word", wordstr, "Text", tmp);
 						newText = true;
 					}
 					else {
 /*
 						// verb morph
 						sprintf(wordstr, "%03d", word);
-						module->getEntryAttributes()["Word"][wordstr]["Morph"] = val;
-						module->getEntryAttributes()["Word"][wordstr]["MorphClass"] = "OLBMorph";
-						module->getEntryAttributes()["Word"][wordstr]["Morph.1"] = val;
-						module->getEntryAttributes()["Word"][wordstr]["MorphClass.1"] = "OLBMorph";
+						module->getEntryAttributeStore().set("Word", wordstr, "Morph", val);
+						module->getEntryAttributeStore().set("Word", wordstr, "MorphClass", "OLBMorph");
+						module->getEntryAttributeStore().set("Word", wordstr, "Morph.1", val);
+						module->getEntryAttributeStore().set("Word", wordstr, "MorphClass.1", "OLBMorph");
 */
 						word--;	// for now, completely ignore this word attribute.
 					}
@@ -136,8 +136,8 @@ char ThMLStrongs::processText(SWBuf &text, const SWKey *key, const SWModule *mod
 							if ((!stricmp(val, "Robinsons")) || (!stricmp(val, "Robinson"))) {
 								strcpy(val, "robinson");
 							}
-							module->getEntryAttributes()["Word"][wordstr]["MorphClass"] = val;
-							module->getEntryAttributes()["Word"][wordstr]["MorphClass.1"] = val;
+							module->getEntryAttributeStore().set("Word", wordstr, "MorphClass", val);
+							module->getEntryAttributeStore().set("Word", wordstr, "MorphClass.1", val);
 						}
 						if (!strncmp(ch, "value=\"", 7)) {
 							valto = val;
@@ -145,8 +145,8 @@ char ThMLStrongs::processText(SWBuf &text, const SWKey *key, const SWModule *mod
 								*valto++ = ch[i];
 							*valto = 0;
 							sprintf(wordstr, "%03d", word-1);
-							module->getEntryAttributes()["Word"][wordstr]["Morph"] = val;
-							module->getEntryAttributes()["Word"][wordstr]["Morph.1"] = val;
+							module->getEntryAttributeStore().set("Word", wordstr, "Morph", val);
+							module->getEntryAttributeStore().set("Word", wordstr, "Morph.1", val);
 						}
 					}
 					newText = true;
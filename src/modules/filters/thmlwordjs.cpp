@@ -42,6 +42,11 @@ namespace {
 		static const StringList oVals(&choices[0], &choices[2]);
 		return &oVals;
 	}
+
+	const char *wordAttribute(const EntryAttributeStore &attributes, const char *word, const char *name) {
+		const char *value = attributes.get("Word", word, name);
+		return (value) ? value : "";
+	}
 }
 
 
@@ -73,7 +78,7 @@ char ThMLWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 		SWBuf tmp;
 		bool newText = false;
 		bool needWordOut = false;
-		AttributeValue *wordAttrs = 0;
+		const char *wordItem = 0;
 		SWBuf modName = (module)?module->getName():"";
 		SWBuf wordSrcPrefix = modName;
 		
@@ -105,22 +110,24 @@ char ThMLWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 						// normal strongs number
 						sprintf(wordstr, "%03d", word++);
 						needWordOut = (word > 2);
-						wordAttrs = &(module->getEntryAttributes()["Word"][wordstr]);
-						(*wordAttrs)["Strongs"] = val;
+						wordItem = wordstr;
+						module->getEntryAttributeStore().set("Word", wordItem, "Strongs", val);
 	//printf("Adding: [\"Word\"][%s][\"Strongs\"] = %s\n", wordstr, val);
 						tmp = "";
 						tmp.append(text.c_str()+textStart, (int)(textEnd - textStart));
-						(*wordAttrs)["Text"] = tmp;
+						module->getEntryAttributeStore().set("Word", wordItem, "Text", tmp);
 						text.append("</span>");
 						SWBuf ts;
 						ts.appendFormatted("%d", textStart);
-						(*wordAttrs)["TextStart"] = ts;
+						module->getEntryAttributeStore().set("Word", wordItem, "TextStart", ts);
 	//printf("Adding: [\"Word\"][%s][\"Text\"] = %s\n", wordstr, tmp.c_str());
 						newText = true;
 					}
 					else {
 						// verb morph
-						(*wordAttrs)["Morph"] = val;
+						if (wordItem) {
+							module->getEntryAttributeStore().set("Word", wordItem, "Morph", val);
+						}
 	//printf("Adding: [\"Word\"][%s][\"Morph\"] = %s\n", wordstr, val);
 					}
 
@@ -132,7 +139,9 @@ char ThMLWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 							for (unsigned int i = 7; ch[i] != '\"' && i < 127; i++)
 								*valto++ = ch[i];
 							*valto = 0;
-							(*wordAttrs)["MorphClass"] = val;
+							if (wordItem) {
+								module->getEntryAttributeStore().set("Word", wordItem, "MorphClass", val);
+							}
 	//printf("Adding: [\"Word\"][%s][\"MorphClass\"] = %s\n", wordstr, val);
 						}
 						if (!strncmp(ch, "value=\"", 7)) {
@@ -140,7 +149,9 @@ char ThMLWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 							for (unsigned int i = 7; ch[i] != '\"' && i < 127; i++)
 								*valto++ = ch[i];
 							*valto = 0;
-							(*wordAttrs)["Morph"] = val;
+							if (wordItem) {
+								module->getEntryAttributeStore().set("Word", wordItem, "Morph", val);
+							}
 	//printf("Adding: [\"Word\"][%s][\"Morph\"] = %s\n", wordstr, val);
 						}
 					}
@@ -153,13 +164,13 @@ char ThMLWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 				if (needWordOut) {
 					char wstr[12];
 					sprintf(wstr, "%03d", word-2);
-					AttributeValue *wAttrs = &(module->getEntryAttributes()["Word"][wstr]);
+					const EntryAttributeStore &wAttrs = module->getEntryAttributeStore();
 					needWordOut = false;
-					SWBuf strong = (*wAttrs)["Strongs"];
-					SWBuf morph = (*wAttrs)["Morph"];
-					SWBuf morphClass = (*wAttrs)["MorphClass"];
-					SWBuf wordText = (*wAttrs)["Text"];
-					SWBuf textSt = (*wAttrs)["TextStart"];
+					SWBuf strong = wordAttribute(wAttrs, wstr, "Strongs");
+					SWBuf morph = wordAttribute(wAttrs, wstr, "Morph");
+					SWBuf morphClass = wordAttribute(wAttrs, wstr, "MorphClass");
+					SWBuf wordText = wordAttribute(wAttrs, wstr, "Text");
+					SWBuf textSt = wordAttribute(wAttrs, wstr, "TextStart");
 					if (strong.size()) {
 						char gh = 0;
 						gh = isdigit(strong[0]) ? 0:strong[0];
@@ -250,13 +261,13 @@ char ThMLWordJS::processText(SWBuf &text, const SWKey *key, const SWModule *modu
 
 		char wstr[12];
 		sprintf(wstr, "%03d", word-1);
-		AttributeValue *wAttrs = &(module->getEntryAttributes()["Word"][wstr]);
+		const EntryAttributeStore &wAttrs = module->getEntryAttributeStore();
 		needWordOut = false;
-		SWBuf strong = (*wAttrs)["Strongs"];
-		SWBuf morph = (*wAttrs)["Morph"];
-		SWBuf morphClass = (*wAttrs)["MorphClass"];
-		SWBuf wordText = (*wAttrs)["Text"];
-		SWBuf textSt = (*wAttrs)["TextStart"];
+		SWBuf strong = wordAttribute(wAttrs, wstr, "Strongs");
+		SWBuf morph = wordAttribute(wAttrs, wstr, "Morph");
+		SWBuf morphClass = wordAttribute(wAttrs, wstr, "MorphClass");
+		SWBuf wordText = wordAttribute(wAttrs, wstr, "Text");
+		SWBuf textSt = wordAttribute(wAttrs, wstr, "TextStart");
 		if (strong.size()) {
 			char gh = 0;
 			gh = isdigit(strong[0]) ? 0:strong[0];
@@ -186,4 +186,10 @@ char UTF8ArabicPoints::processText(SWBuf &text, const SWKey *, const SWModule *)
 	return 0;
 }
 
+
+SW_u32 UTF8ArabicPoints::filterChar(SW_u32 ch) const {
+	// the marks recognized by nextMark
+	return ((ch >= 0x064B && ch <= 0x0655) || (ch >= 0xFC5E && ch <= 0xFC63) || (ch >= 0xFE70 && ch <= 0xFE7F)) ? 0 : ch;
+}
+
 SWORD_NAMESPACE_END
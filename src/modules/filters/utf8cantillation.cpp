@@ -75,4 +75,10 @@ char UTF8Cantillation::processText(SWBuf &text, const SWKey *key, const SWModule
 	return 0;
 }
 
+
+SW_u32 UTF8Cantillation::filterChar(SW_u32 ch) const {
+	// U+0590 - U+05AF and U+05C4, as above
+	return ((ch >= 0x0590 && ch <= 0x05AF) || ch == 0x05C4) ? 0 : ch;
+}
+
 SWORD_NAMESPACE_END
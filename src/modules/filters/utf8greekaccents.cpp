@@ -367,4 +367,13 @@ char UTF8GreekAccents::processText(SWBuf &text, const SWKey *key, const SWModule
 }
 
 
+SW_u32 UTF8GreekAccents::filterChar(SW_u32 ch) const {
+	map<SW_u32, SWBuf>::const_iterator it = converters.find(ch);
+	if (it == converters.end()) return ch;
+	if (!it->second.size()) return 0;
+	const unsigned char *to = (const unsigned char *)it->second.c_str();
+	return getUniCharFromUTF8(&to, true);
+}
+
+
 SWORD_NAMESPACE_END
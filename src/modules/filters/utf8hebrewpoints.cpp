@@ -66,4 +66,10 @@ char UTF8HebrewPoints::processText(SWBuf &text, const SWKey *key, const SWModule
 }
 
 
+SW_u32 UTF8HebrewPoints::filterChar(SW_u32 ch) const {
+	// U+05B0 - U+05BF, less U+05BE (maqaf), as above
+	return (ch >= 0x05B0 && ch <= 0x05BF && ch != 0x05BE) ? 0 : ch;
+}
+
+
 SWORD_NAMESPACE_END
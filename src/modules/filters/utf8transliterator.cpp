@@ -134,12 +134,93 @@ SWCharString::~SWCharString() {
 #endif // _ICUSWORD_
 #endif // ICU_CUSTOM_RESOURCE_BUILDING
 
+namespace {
+
+	// a script from scriptEnum, or'd with SCRIPT_COMPAT for compatibility forms
+	const unsigned char SCRIPT_COMPAT = 0x80;
+
+	unsigned char scriptOfBlock(int block) {
+		switch (block) {
+		case UBLOCK_GREEK: return SE_GREEK;
+		case UBLOCK_HEBREW: return SE_HEBREW;
+		case UBLOCK_CYRILLIC: return SE_CYRILLIC;
+		case UBLOCK_ARABIC: return SE_ARABIC;
+		case UBLOCK_SYRIAC: return SE_SYRIAC;
+		case UBLOCK_KATAKANA: return SE_KATAKANA;
+		case UBLOCK_HIRAGANA: return SE_HIRAGANA;
+		case UBLOCK_HANGUL_SYLLABLES: return SE_HANGUL;
+		case UBLOCK_HANGUL_JAMO: return SE_JAMO;
+		case UBLOCK_DEVANAGARI: return SE_DEVANAGARI;
+		case UBLOCK_TAMIL: return SE_TAMIL;
+		case UBLOCK_BENGALI: return SE_BENGALI;
+		case UBLOCK_GURMUKHI: return SE_GURMUKHI;
+		case UBLOCK_GUJARATI: return SE_GUJARATI;
+		case UBLOCK_ORIYA: return SE_ORIYA;
+		case UBLOCK_TELUGU: return SE_TELUGU;
+		case UBLOCK_KANNADA: return SE_KANNADA;
+		case UBLOCK_MALAYALAM: return SE_MALAYALAM;
+		case UBLOCK_THAI: return SE_THAI;
+		case UBLOCK_GEORGIAN: return SE_GEORGIAN;
+		case UBLOCK_ARMENIAN: return SE_ARMENIAN;
+		case UBLOCK_ETHIOPIC: return SE_ETHIOPIC;
+		case UBLOCK_GOTHIC: return SE_GOTHIC;
+		case UBLOCK_UGARITIC: return SE_UGARITIC;
+//		case UBLOCK_MEROITIC: return SE_MEROITIC;
+		case UBLOCK_LINEAR_B_SYLLABARY: return SE_LINEARB;
+		case UBLOCK_CYPRIOT_SYLLABARY: return SE_CYPRIOT;
+		case UBLOCK_RUNIC: return SE_RUNIC;
+		case UBLOCK_OGHAM: return SE_OGHAM;
+		case UBLOCK_THAANA: return SE_THAANA;
+		case UBLOCK_GLAGOLITIC: return SE_GLAGOLITIC;
+		case UBLOCK_CHEROKEE: return SE_CHEROKEE;
+//		case UBLOCK_TENGWAR: return SE_TENGWAR;
+//		case UBLOCK_CIRTH: return SE_CIRTH;
+		case UBLOCK_CJK_RADICALS_SUPPLEMENT:
+		case UBLOCK_KANGXI_RADICALS:
+		case UBLOCK_IDEOGRAPHIC_DESCRIPTION_CHARACTERS:
+		case UBLOCK_CJK_SYMBOLS_AND_PUNCTUATION:
+		case UBLOCK_CJK_UNIFIED_IDEOGRAPHS_EXTENSION_A:
+		case UBLOCK_CJK_UNIFIED_IDEOGRAPHS:
+			return SE_HAN;
+		case UBLOCK_CJK_COMPATIBILITY:
+		case UBLOCK_CJK_COMPATIBILITY_IDEOGRAPHS:
+		case UBLOCK_CJK_COMPATIBILITY_FORMS:
+			return SE_HAN | SCRIPT_COMPAT;
+		case UBLOCK_HANGUL_COMPATIBILITY_JAMO:
+			return SE_HANGUL | SCRIPT_COMPAT;
+		}
+		return SE_OFF;
+	}
+
+	// Unicode blocks start and end on multiples of 16 code points, so the
+	// script of every BMP character is found by its 16 code point page
+	unsigned char bmpScripts[0x10000 >> 4];
+	bool bmpScriptsBuilt = false;
+	SWMutex bmpScriptsLock;
+
+	void buildScriptTable() {
+		SWMutex::Locker locker(bmpScriptsLock);
+		if (bmpScriptsBuilt) return;
+		for (unsigned int page = 0; page < sizeof(bmpScripts); page++) {
+			bmpScripts[page] = scriptOfBlock(ublock_getCode(page << 4));
+		}
+		bmpScriptsBuilt = true;
+	}
+
+	unsigned char scriptOf(SW_u32 ch) {
+		return (ch < 0x10000) ? bmpScripts[ch >> 4] : scriptOfBlock(ublock_getCode(ch));
+	}
+}
+
 UTF8Transliterator::UTF8Transliterator() {
 	option = 0;
         unsigned long i;
 	for (i = 0; i < NUMTARGETSCRIPTS; i++) {
 		options.push_back(optionstring[i]);
 	}
+	UErrorCode err = U_ZERO_ERROR;
+	conv = ucnv_open("UTF-8", &err);
+	buildScriptTable();
 #ifdef ICU_CUSTOM_RESOURCE_BUILDING
 #ifndef _ICUSWORD_
 	utf8status = U_ZERO_ERROR;
@@ -150,6 +231,10 @@ UTF8Transliterator::UTF8Transliterator() {
 
 
 UTF8Transliterator::~UTF8Transliterator() {
+	for (std::map<SWBuf, icu::Transliterator *>::iterator it = transCache.begin(); it != transCache.end(); ++it) {
+		delete it->second;
+	}
+	ucnv_close(conv);
 }
 
 #ifdef ICU_CUSTOM_RESOURCE_BUILDING
@@ -336,12 +421,34 @@ icu::Transliterator * UTF8Transliterator::createTrans(const icu::UnicodeString&
 	}
 }
 
+
+/******************************************************************************
+ * UTF8Transliterator::getTrans	- gets the transliterator for an ID, built
+ *					the first time it's asked for
+ *
+ * RET:	the transliterator, or 0 if ICU can't build one for ID
+ */
+
+icu::Transliterator *UTF8Transliterator::getTrans(const SWBuf &ID) {
+	SWMutex::Locker locker(lock);
+
+	std::map<SWBuf, icu::Transliterator *>::iterator it = transCache.find(ID);
+	if (it != transCache.end()) return it->second;
+
+	// failures are kept too, so they aren't tried again for every entry
+	UErrorCode err = U_ZERO_ERROR;
+	icu::Transliterator *trans = createTrans(icu::UnicodeString(ID), UTRANS_FORWARD, err);
+	transCache[ID] = trans;
+	return trans;
+}
+
+
 void UTF8Transliterator::setOptionValue(const char *ival)
 {
-	unsigned char i = option = NUMTARGETSCRIPTS;
-	while (i && stricmp(ival, optionstring[i])) {
-		i--;
-		option = i;
+	// optionstring[0], "Off", is what anything unknown gives
+	option = NUMTARGETSCRIPTS - 1;
+	while (option && stricmp(ival, optionstring[option])) {
+		option--;
 	}
 }
 
@@ -354,89 +461,28 @@ char UTF8Transliterator::processText(SWBuf &text, const SWKey *key, const SWModu
 {
 	if (option) {	// if we want transliteration
 		unsigned long i, j;
-                UErrorCode err = U_ZERO_ERROR;
-                UConverter * conv = NULL;
-                conv = ucnv_open("UTF-8", &err);
                 SWBuf ID;
 
                 bool compat = false;
 
-		// Convert UTF-8 string to UTF-16 (UChars)
-                j = strlen(text);
-                int32_t len = (j * 2) + 1;
-                UChar *source = new UChar[len];
-                err = U_ZERO_ERROR;
-                len = ucnv_toUChars(conv, source, len, text, j, &err);
-                source[len] = 0;
-
 		// Figure out which scripts are used in the string
 		unsigned char scripts[NUMSCRIPTS];
 
                 for (i = 0; i < NUMSCRIPTS; i++) {
                         scripts[i] = false;
                 }
+		if (text.length()) scripts[SE_LATIN] = true;
 
-                for (i = 0; i < (unsigned long)len; i++) {
-                        j = ublock_getCode(source[i]);
-			scripts[SE_LATIN] = true;
-			switch (j) {
-			//case UBLOCK_BASIC_LATIN: scripts[SE_LATIN] = true; break;
-			case UBLOCK_GREEK: scripts[SE_GREEK] = true; break;
-			case UBLOCK_HEBREW: scripts[SE_HEBREW] = true; break;
-			case UBLOCK_CYRILLIC: scripts[SE_CYRILLIC] = true; break;
-			case UBLOCK_ARABIC: scripts[SE_ARABIC] = true; break;
-			case UBLOCK_SYRIAC: scripts[SE_SYRIAC] = true; break;
-			case UBLOCK_KATAKANA: scripts[SE_KATAKANA] = true; break;
-			case UBLOCK_HIRAGANA: scripts[SE_HIRAGANA] = true; break;
-			case UBLOCK_HANGUL_SYLLABLES: scripts[SE_HANGUL] = true; break;
-			case UBLOCK_HANGUL_JAMO: scripts[SE_JAMO] = true; break;
-			case UBLOCK_DEVANAGARI: scripts[SE_DEVANAGARI] = true; break;
-			case UBLOCK_TAMIL: scripts[SE_TAMIL] = true; break;
-			case UBLOCK_BENGALI: scripts[SE_BENGALI] = true; break;
-			case UBLOCK_GURMUKHI: scripts[SE_GURMUKHI] = true; break;
-			case UBLOCK_GUJARATI: scripts[SE_GUJARATI] = true; break;
-			case UBLOCK_ORIYA: scripts[SE_ORIYA] = true; break;
-			case UBLOCK_TELUGU: scripts[SE_TELUGU] = true; break;
-			case UBLOCK_KANNADA: scripts[SE_KANNADA] = true; break;
-			case UBLOCK_MALAYALAM: scripts[SE_MALAYALAM] = true; break;
-			case UBLOCK_THAI: scripts[SE_THAI] = true; break;
-			case UBLOCK_GEORGIAN: scripts[SE_GEORGIAN] = true; break;
-			case UBLOCK_ARMENIAN: scripts[SE_ARMENIAN] = true; break;
-			case UBLOCK_ETHIOPIC: scripts[SE_ETHIOPIC] = true; break;
-			case UBLOCK_GOTHIC: scripts[SE_GOTHIC] = true; break;
-			case UBLOCK_UGARITIC: scripts[SE_UGARITIC] = true; break;
-//			case UBLOCK_MEROITIC: scripts[SE_MEROITIC] = true; break;
-			case UBLOCK_LINEAR_B_SYLLABARY: scripts[SE_LINEARB] = true; break;
-			case UBLOCK_CYPRIOT_SYLLABARY: scripts[SE_CYPRIOT] = true; break;
-			case UBLOCK_RUNIC: scripts[SE_RUNIC] = true; break;
-			case UBLOCK_OGHAM: scripts[SE_OGHAM] = true; break;
-			case UBLOCK_THAANA: scripts[SE_THAANA] = true; break;
-			case UBLOCK_GLAGOLITIC: scripts[SE_GLAGOLITIC] = true; break;
-                        case UBLOCK_CHEROKEE: scripts[SE_CHEROKEE] = true; break;
-//			case UBLOCK_TENGWAR: scripts[SE_TENGWAR] = true; break;
-//			case UBLOCK_CIRTH: scripts[SE_CIRTH] = true; break;
-			case UBLOCK_CJK_RADICALS_SUPPLEMENT:
-			case UBLOCK_KANGXI_RADICALS:
-			case UBLOCK_IDEOGRAPHIC_DESCRIPTION_CHARACTERS:
-			case UBLOCK_CJK_SYMBOLS_AND_PUNCTUATION:
-			case UBLOCK_CJK_UNIFIED_IDEOGRAPHS_EXTENSION_A:
-			case UBLOCK_CJK_UNIFIED_IDEOGRAPHS:
-                                scripts[SE_HAN] = true;
-                                break;
-			case UBLOCK_CJK_COMPATIBILITY:
-			case UBLOCK_CJK_COMPATIBILITY_IDEOGRAPHS:
-			case UBLOCK_CJK_COMPATIBILITY_FORMS:
-                                scripts[SE_HAN] = true;
-                                compat = true;
-        			break;
-			case UBLOCK_HANGUL_COMPATIBILITY_JAMO:
-                                scripts[SE_HANGUL] = true;
-                                compat = true;
-                                break;
-
-                        //default: scripts[SE_LATIN] = true;
+		for (const unsigned char *from = (const unsigned char *)text.c_str(); *from;) {
+			if (*from < 0x80) {	// Basic Latin
+				from++;
+				continue;
 			}
+			unsigned char script = scriptOf(getUniCharFromUTF8(&from));
+			if (script & SCRIPT_COMPAT) compat = true;
+			scripts[script & ~SCRIPT_COMPAT] = true;
 		}
+		scripts[SE_OFF] = false;
 		scripts[option] = false; //turn off the reflexive transliteration
 
 		//return if we have no transliteration to do for this text
@@ -445,7 +491,6 @@ char UTF8Transliterator::processText(SWBuf &text, const SWKey *key, const SWModu
 	        	if (scripts[i]) j++;
         	}
 	       	if (!j) {
-                        ucnv_close(conv);
                         return 0;
                 }
 
@@ -458,7 +503,7 @@ char UTF8Transliterator::processText(SWBuf &text, const SWKey *key, const SWModu
 
 		//Simple X to Latin transliterators
 		if (scripts[SE_GREEK]) {
-			if (strnicmp (((SWModule*)module)->getLanguage(), "cop", 3)) {
+			if (!module || strnicmp (((SWModule*)module)->getLanguage(), "cop", 3)) {
 				if (option == SE_SBL)
 					addTrans("Greek-Latin/SBL", &ID);
 				else if (option == SE_TC)
@@ -661,7 +706,7 @@ char UTF8Transliterator::processText(SWBuf &text, const SWKey *key, const SWModu
 		}
 
 		if (scripts[SE_HAN]) {
-	        	if (!strnicmp (((SWModule*)module)->getLanguage(), "ja", 2)) {
+	        	if (module && !strnicmp (((SWModule*)module)->getLanguage(), "ja", 2)) {
      				addTrans("Kanji-Romaji", &ID);
 			}
 			else {
@@ -901,17 +946,29 @@ char UTF8Transliterator::processText(SWBuf &text, const SWKey *key, const SWModu
 
                 addTrans("NFC", &ID);
 
-                err = U_ZERO_ERROR;
-                icu::Transliterator * trans = createTrans(icu::UnicodeString(ID), UTRANS_FORWARD, err);
-                if (trans && !U_FAILURE(err)) {
-                        icu::UnicodeString target = icu::UnicodeString(source);
+                icu::Transliterator *trans = getTrans(ID);
+                if (trans) {
+                        UErrorCode err = U_ZERO_ERROR;
+                        icu::UnicodeString target;
+                        {
+                                SWMutex::Locker locker(lock);
+                                target = icu::UnicodeString(text.c_str(), text.length(), conv, err);
+                        }
+			// transliterate() leaves the transliterator as it was, so
+			// threads may share it
 			trans->transliterate(target);
+
+                        SWMutex::Locker locker(lock);
 			text.setSize(text.size()*2);
-			len = ucnv_fromUChars(conv, text.getRawData(), text.size(), target.getBuffer(), target.length(), &err);
+			err = U_ZERO_ERROR;
+			int32_t len = target.extract(text.getRawData(), text.size(), conv, err);
+			if (err == U_BUFFER_OVERFLOW_ERROR) {
+				text.setSize(len);
+				err = U_ZERO_ERROR;
+				len = target.extract(text.getRawData(), text.size(), conv, err);
+			}
 			text.setSize(len);
-			delete trans;
                 }
-                ucnv_close(conv);
         }
 	return 0;
 }
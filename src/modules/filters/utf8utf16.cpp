@@ -22,6 +22,7 @@
 
 
 #include <utf8utf16.h>
+#include <string.h>
 #include <utilstr.h>
 #include <swbuf.h>
 
@@ -38,31 +39,33 @@ char UTF8UTF16::processText(SWBuf &text, const SWKey *key, const SWModule *modul
 	SWBuf orig = text;
 
 	from = (const unsigned char *)orig.c_str();
+	const unsigned char *end = from + strlen(orig.c_str());
 
 	// -------------------------------
-	text = "";
-	while (*from) {
+	// no more UTF-16 code units than bytes, and one for the terminator
+	text.setSize((end - from + 1) * 2);
+	SW_u16 *to = (SW_u16 *)text.getRawData();
+	while (from < end) {
+
+		unsigned long ascii = widenASCII((const char *)from, end - from, to);
+		from += ascii;
+		to += ascii;
+		if (from >= end) break;
 
 		SW_u32 ch = getUniCharFromUTF8(&from);
 
 		if (!ch) continue;	// invalid char
 
 		if (ch < 0x10000) {
-			text.setSize(text.size()+2);
-			*((SW_u16 *)(text.getRawData() + (text.size() - 2))) = (SW_u16)ch;
+			*to++ = (SW_u16)ch;
 		}
 		else {
-			SW_u16 utf16;
-			utf16 = (SW_s16)((ch - 0x10000) / 0x400 + 0xD800);
-			text.setSize(text.size()+4);
-			*((SW_u16 *)(text.getRawData() + (text.size() - 4))) = utf16;
-			utf16 = (SW_s16)((ch - 0x10000) % 0x400 + 0xDC00);
-			*((SW_u16 *)(text.getRawData() + (text.size() - 2))) = utf16;
+			*to++ = (SW_u16)((ch - 0x10000) / 0x400 + 0xD800);
+			*to++ = (SW_u16)((ch - 0x10000) % 0x400 + 0xDC00);
 		}
 	}
-	text.setSize(text.size()+2);
-	*((SW_u16 *)(text.getRawData() + (text.size() - 2))) = (SW_u16)0;
-	text.setSize(text.size()-2);
+	*to = 0;
+	text.setSize((char *)to - text.getRawData());
 	   
 	return 0;
 }
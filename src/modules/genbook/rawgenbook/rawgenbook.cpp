@@ -33,6 +33,7 @@
 #include <sysdata.h>
 #include <treekeyidx.h>
 #include <versetreekey.h>
+#include <swmetrics.h>
 
 SWORD_NAMESPACE_START
 
@@ -126,12 +127,14 @@ SWBuf &RawGenBook::getRawEntryBuf() const {
 //		   if (!isUnicode())
 			SWModule::prepText(entryBuf);
 	}
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
 
 
 void RawGenBook::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 
 	SW_u32 offset = (SW_u32)archtosword32(bdtfd->seek(0, SEEK_END));
 	SW_u32 size = 0;
@@ -153,6 +156,7 @@ void RawGenBook::setEntry(const char *inbuf, long len) {
 
 
 void RawGenBook::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 	const TreeKeyIdx *srcKey = 0;
 	TreeKeyIdx *tmpKey = 0;
 	TreeKeyIdx *key = ((TreeKeyIdx *)&(getTreeKey()));
@@ -183,6 +187,7 @@ void RawGenBook::linkEntry(const SWKey *inkey) {
  */
 
 void RawGenBook::deleteEntry() {
+	EntryEdit edit(this);
 	TreeKeyIdx *key = ((TreeKeyIdx *)&(getTreeKey()));
 	key->remove();
 }
@@ -27,6 +27,7 @@
 #include <rawstr.h>
 #include <rawld.h>
 #include <filemgr.h>
+#include <swmetrics.h>
 
 #include <stdio.h>
 
@@ -118,6 +119,7 @@ SWBuf &RawLD::getRawEntryBuf() const {
 			prepText(entryBuf);
 	}
 	else error = ret;
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
@@ -147,6 +149,7 @@ void RawLD::increment(int steps) {
 
 
 void RawLD::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 	char *buf = new char [ strlen(*key) + 6 ];
 	strcpy(buf, *key);
 
@@ -159,6 +162,7 @@ void RawLD::setEntry(const char *inbuf, long len) {
 
 
 void RawLD::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 	char *buf = new char [ strlen(*key) + 6 ];
 	strcpy(buf, *key);
 
@@ -177,6 +181,7 @@ void RawLD::linkEntry(const SWKey *inkey) {
  */
 
 void RawLD::deleteEntry() {
+	EntryEdit edit(this);
 	char *buf = new char [ strlen(*key) + 6 ];
 	strcpy(buf, *key);
 
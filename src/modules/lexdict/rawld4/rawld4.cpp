@@ -27,6 +27,7 @@
 #include <utilstr.h>
 #include <rawstr4.h>
 #include <rawld4.h>
+#include <swmetrics.h>
 
 #include <stdio.h>
 
@@ -116,6 +117,7 @@ SWBuf &RawLD4::getRawEntryBuf() const {
 			prepText(entryBuf);
 	}
 	else error = ret;
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
@@ -145,6 +147,7 @@ void RawLD4::increment(int steps) {
 
 
 void RawLD4::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 	char *buf = new char [ strlen(*key) + 6 ];
 	strcpy(buf, *key);
 
@@ -157,6 +160,7 @@ void RawLD4::setEntry(const char *inbuf, long len) {
 
 
 void RawLD4::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 	char *buf = new char [ strlen(*key) + 6 ];
 	strcpy(buf, *key);
 
@@ -175,6 +179,7 @@ void RawLD4::linkEntry(const SWKey *inkey) {
  */
 
 void RawLD4::deleteEntry() {
+	EntryEdit edit(this);
 	char *buf = new char [ strlen(*key) + 6 ];
 	strcpy(buf, *key);
 
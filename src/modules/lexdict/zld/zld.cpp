@@ -27,6 +27,7 @@
 #include <zstr.h>
 #include <zld.h>
 #include <filemgr.h>
+#include <swmetrics.h>
 
 #include <stdio.h>
 
@@ -115,6 +116,7 @@ SWBuf &zLD::getRawEntryBuf() const {
 	if (!getEntry() /*&& !isUnicode()*/) {
 		prepText(entryBuf);
 	}
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
@@ -144,6 +146,7 @@ void zLD::increment(int steps) {
 
 
 void zLD::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 	char *buf = new char [ strlen(*key) + 6 ];
 	strcpy(buf, *key);
 
@@ -156,6 +159,7 @@ void zLD::setEntry(const char *inbuf, long len) {
 
 
 void zLD::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 	char *buf = new char [ strlen(*key) + 6 ];
 	strcpy(buf, *key);
 
@@ -174,6 +178,7 @@ void zLD::linkEntry(const SWKey *inkey) {
  */
 
 void zLD::deleteEntry() {
+	EntryEdit edit(this);
 	char *buf = new char [ strlen(*key) + 6 ];
 	strcpy(buf, *key);
 
@@ -24,6 +24,7 @@
 
 
 #include <vector>
+#include <algorithm>
 
 #include <swlog.h>
 #include <sysdata.h>
@@ -35,6 +36,15 @@
 #include <swoptfilter.h>
 #include <filemgr.h>
 #include <stringmgr.h>
+#include <entryattridx.h>
+#include <searchjournal.h>
+#include <filterpipeline.h>
+#include <multimatcher.h>
+#include <swmetrics.h>
+#include <swthread.h>
+#include <swmgr.h>
+#include <localemgr.h>
+#include <typeinfo>
 #ifndef _MSC_VER
 #include <iostream>
 #endif
@@ -53,6 +63,15 @@
 #include <regex.h>	// GNU
 #endif
 
+#ifdef USECXX11TIME
+#include <chrono>
+#elif !defined(WIN32)
+#include <sys/time.h>
+#include <time.h>
+#else
+#include <time.h>
+#endif
+
 #if defined USEXAPIAN
 #include <xapian.h>
 #elif defined USELUCENE
@@ -90,6 +109,290 @@ const signed int SWModule::SEARCHTYPE_EXTERNAL  = -4;
 
 typedef std::list<SWBuf> StringList;
 
+namespace {
+
+	// milliseconds from some fixed point, for search time budgets; 64 bits
+	// wide, as a long of milliseconds since the epoch overflows 32
+	SW_s64 getMilliseconds() {
+#ifdef USECXX11TIME
+		return (SW_s64)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#elif !defined(WIN32)
+#ifdef CLOCK_MONOTONIC
+		// not moved by changes to the system clock
+		struct timespec ts;
+		if (!clock_gettime(CLOCK_MONOTONIC, &ts)) {
+			return (SW_s64)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+		}
+#endif
+		struct timeval tv;
+		gettimeofday(&tv, 0);
+		return (SW_s64)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+#else
+		// Windows' clock() counts wall time
+		return (SW_s64)clock() * 1000 / CLOCKS_PER_SEC;
+#endif
+	}
+
+	// adds the search hit at hit to the results.  A verse goes in as a
+	// VersePosition, so no VerseKey is made for it until it is looked at,
+	// and then like the module's key, from which vkCheck has just copied
+	// its locale and intros.
+	void addHit(ListKey &listKey, SWKey *resultKey, VerseKey *vkCheck, const SWKey *hit) {
+		// clearing bounds drops the bounds cache, so only do it after a range hit
+		if (resultKey->isBoundSet()) resultKey->clearBounds();
+		*resultKey = *hit;
+		if (vkCheck && !vkCheck->getSuffix()) listKey.add(vkCheck->getVersePosition(), vkCheck);
+		else listKey << *resultKey;
+	}
+
+	// adds a hit which took the text of lastKey and hit together
+	void addRangeHit(ListKey &listKey, SWKey *resultKey, VerseKey *vkCheck, SWKey *lastKey, const SWKey *hit) {
+		lastKey->clearBounds();
+		if (vkCheck) {
+			resultKey->clearBounds();
+			*resultKey = *hit;
+			if (!vkCheck->getSuffix()) {
+				listKey.add(makeVersePosition(vkCheck->getVersePosition().system, lastKey->getIndex(), vkCheck->getIndex()), vkCheck);
+				return;
+			}
+			vkCheck->setUpperBound(resultKey);
+			vkCheck->setLowerBound(lastKey);
+		}
+		else {
+			*resultKey = *lastKey;
+			resultKey->clearBounds();
+		}
+		listKey << *resultKey;
+	}
+
+	// how many threads createSearchFramework() strips entries on; 0 for one per processor
+	int indexThreads = 0;
+
+	// adds every attribute of one entry to the entry attribute index
+	void addEntryAttributes(EntryAttributeIndex *index, const EntryAttributeStore &attributes, long mindex) {
+		for (unsigned long i = 0; i < attributes.getCount(); ++i) {
+			index->add(attributes.getType(i), attributes.getName(i), attributes.getValue(i), mindex);
+		}
+	}
+
+#if defined USELUCENE || defined USEXAPIAN
+	// Bible entries are read and stripped about this many at a time
+	const size_t INDEX_BATCH = 1024;
+
+	// one entry's part of the search index
+	struct IndexEntry {
+		long index;
+		long proxEnd;		// for the first verse of a chapter, the index of its last; otherwise -1
+		SWBuf keyText;
+		SWBuf text;		// the raw entry, until it is stripped
+		SWBuf strong;
+		SWBuf morph;
+	};
+
+	// the text of a chapter, or of a run of book siblings, indexed for words near each other
+	struct ProxFields {
+		SWBuf text;
+		SWBuf lemma;
+		SWBuf morph;
+
+		void clear() {
+			text = "";
+			lemma = "";
+			morph = "";
+		}
+
+		void append(const IndexEntry &entry) {
+			if (!entry.text.length()) return;
+			text += entry.text;
+			text.append(' ');
+			lemma += entry.strong;
+			morph += entry.morph;
+			if (lemma.length()) {
+				lemma.append("\n");
+				morph.append("\n");
+			}
+		}
+	};
+
+	// builds the "strong" and "morph" fields from an entry's Word attributes
+	void getWordFields(const EntryAttributeStore &attributes, SWBuf &strong, SWBuf &morph) {
+		strong = "";
+		morph = "";
+		char name[32];
+
+		for (unsigned long w = attributes.find("Word"); w < attributes.getCount(); w = attributes.find("Word", 0, 0, w + 1)) {
+			if (!attributes.isFirstOfItem(w)) continue;
+			const char *word = attributes.getItem(w);
+			const char *partCountVal = attributes.get("Word", word, "PartCount");
+			int partCount = (partCountVal) ? atoi(partCountVal) : 0;
+			if (!partCount) partCount = 1;
+			for (int i = 0; i < partCount; i++) {
+				if (partCount > 1) sprintf(name, "Lemma.%d", i+1);
+				else strcpy(name, "Lemma");
+				const char *strongVal = attributes.get("Word", word, name);
+				if (strongVal) {
+					// cheeze.  skip empty article tags that weren't assigned to any text
+					if (!strcmp(strongVal, "G3588")) {
+						if (!attributes.get("Word", word, "Text"))
+							continue;	// no text? let's skip
+					}
+					strong.append(strongVal);
+					morph.append(strongVal);
+					morph.append('@');
+					if (partCount > 1) sprintf(name, "Morph.%d", i+1);
+					else strcpy(name, "Morph");
+					const char *morphVal = attributes.get("Word", word, name);
+					if (morphVal) {
+						morph.append(morphVal);
+					}
+					strong.append(' ');
+					morph.append(' ');
+				}
+			}
+		}
+	}
+
+	// a library holding nothing but a copy of one module
+	class IndexWorkerMgr : public SWMgr {
+	public:
+		IndexWorkerMgr(SWConfig *config, const char *prefixPath) : SWMgr(config, 0, false) {
+			stdstr(&this->prefixPath, prefixPath);
+			createAllModules();
+		}
+	};
+
+	// what one thread strips: every step'th entry, from first
+	struct IndexJob {
+		SWConfig config;
+		IndexWorkerMgr *mgr;
+		SWModule *module;
+		std::vector<IndexEntry> *entries;
+		size_t first;
+		size_t step;
+
+		IndexJob(const SWModule &source, size_t first, size_t step) : mgr(0), module(0), entries(0), first(first), step(step) {
+			ConfigEntMap::const_iterator prefixPath = source.getConfig().find("PrefixPath");
+			if (prefixPath == source.getConfig().end()) return;
+
+			config.getSections()[source.getName()] = source.getConfig();
+			mgr = new IndexWorkerMgr(&config, prefixPath->second);
+			module = mgr->getModule(source.getName());
+		}
+
+		~IndexJob() {
+			delete mgr;
+		}
+	};
+
+	// adds an entry, and any proximity text which begins with it, to the
+	// index; replacing, an entry with nothing left to index is removed
+#if defined USEXAPIAN
+	void addSearchDocument(Xapian::WritableDatabase &database, Xapian::TermGenerator &termGenerator, const IndexEntry &entry, const ProxFields &prox, bool includeKeyInSearch, bool replace) {
+		Xapian::Document doc;
+		termGenerator.set_document(doc);
+#elif defined USELUCENE
+	void addSearchDocument(IndexWriter *coreWriter, const IndexEntry &entry, const ProxFields &prox, bool includeKeyInSearch, bool replace) {
+		Document *doc = new Document();
+#endif
+		bool good = false;
+
+		if (entry.text.length()) {
+			good = true;
+
+			SWBuf content;
+			if (includeKeyInSearch) {
+				content = entry.keyText;
+				content += " ";
+			}
+			content += entry.text;
+
+#if defined USEXAPIAN
+			termGenerator.index_text(content.c_str());
+			termGenerator.index_text(content.c_str(), 1, "C");
+#elif defined USELUCENE
+			doc->add(*_CLNEW Field(_T("content"), (wchar_t *)utf8ToWChar(content).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED));
+#endif
+
+			if (entry.strong.length() > 0) {
+#if defined USEXAPIAN
+				termGenerator.index_text(entry.strong.c_str(), 1, "L");
+				termGenerator.index_text(entry.morph.c_str(), 1, "M");
+#elif defined USELUCENE
+				doc->add(*_CLNEW Field(_T("lemma"), (wchar_t *)utf8ToWChar(entry.strong).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED));
+				doc->add(*_CLNEW Field(_T("morph"), (wchar_t *)utf8ToWChar(entry.morph).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED));
+#endif
+			}
+		}
+
+		if (prox.text.length() > 0) {
+#if defined USEXAPIAN
+			termGenerator.index_text(prox.text.c_str(), 1, "P");
+#elif defined USELUCENE
+			doc->add(*_CLNEW Field(_T("prox"), (wchar_t *)utf8ToWChar(prox.text).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED));
+#endif
+			good = true;
+		}
+		if (prox.lemma.length() > 0) {
+#if defined USEXAPIAN
+			termGenerator.index_text(prox.lemma.c_str(), 1, "PL");
+			termGenerator.index_text(prox.morph.c_str(), 1, "PM");
+#elif defined USELUCENE
+			doc->add(*_CLNEW Field(_T("proxlem"), (wchar_t *)utf8ToWChar(prox.lemma).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED) );
+			doc->add(*_CLNEW Field(_T("proxmorph"), (wchar_t *)utf8ToWChar(prox.morph).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED) );
+#endif
+			good = true;
+		}
+
+#if defined USEXAPIAN
+		SWBuf idTerm;
+		idTerm.setFormatted("Q%ld", entry.index);
+#endif
+		if (good) {
+			// the key is also what a replaced document is found by
+#if defined USEXAPIAN
+			doc.set_data(entry.keyText.c_str());
+			doc.add_boolean_term(idTerm.c_str());
+			database.replace_document(idTerm.c_str(), doc);
+#elif defined USELUCENE
+			doc->add(*_CLNEW Field(_T("key"), (wchar_t *)utf8ToWChar(entry.keyText).getRawData(), Field::STORE_YES | Field::INDEX_UNTOKENIZED));
+			coreWriter->addDocument(doc);
+#endif
+		}
+#if defined USEXAPIAN
+		else if (replace) {
+			database.delete_document(idTerm.c_str());
+		}
+#elif defined USELUCENE
+		delete doc;
+#endif
+	}
+#endif
+}
+
+
+SearchCursor::SearchCursor(int maxHits, long timeBudget, bool (*hitCallback)(const SWKey &, void *), void *hitUserData)
+		: position(0), lastKey(0), highIndex(1), complete(false),
+		  hitCallback(hitCallback), hitUserData(hitUserData), maxHits(maxHits), timeBudget(timeBudget) {
+}
+
+
+SearchCursor::~SearchCursor() {
+	delete position;
+	delete lastKey;
+}
+
+
+void SearchCursor::reset() {
+	delete position;
+	position = 0;
+	delete lastKey;
+	lastKey = 0;
+	lastBuf = "";
+	highIndex = 1;
+	complete = false;
+}
+
+
 /******************************************************************************
  * SWModule Constructor - Initializes data for instance of SWModule
  *
@@ -124,8 +427,14 @@ SWModule::SWModule(const char *imodname, const char *imoddesc, SWDisplay *idisp,
 	renderFilters = new FilterList();
 	optionFilters = new OptionFilterList();
 	encodingFilters = new FilterList();
+	stripPipeline = new FilterPipeline();
+	renderPipeline = new FilterPipeline();
 	skipConsecutiveLinks = true;
 	procEntAttr = true;
+	entryAttributesCurrent = false;
+	entryAttributesHandedOut = false;
+	entryAttributesHeld = false;
+	attributeIndex = 0;
 }
 
 
@@ -135,6 +444,9 @@ SWModule::SWModule(const char *imodname, const char *imoddesc, SWDisplay *idisp,
 
 SWModule::~SWModule()
 {
+	// our drivers' destructors have written what they held back
+	sealJournal();
+
 	if (modname)
 		delete [] modname;
 	if (moddesc)
@@ -161,6 +473,9 @@ SWModule::~SWModule()
 	delete renderFilters;
 	delete optionFilters;
 	delete encodingFilters;
+	delete stripPipeline;
+	delete renderPipeline;
+	delete attributeIndex;
 }
 
 
@@ -316,6 +631,17 @@ char SWModule::setKey(const SWKey *ikey) {
 }
 
 
+char SWModule::setKey(const VersePosition &pos) {
+	VerseKey *vk = SWDYNAMIC_CAST(VerseKey, key);
+	if (vk) {
+		vk->setVersePosition(pos);
+		return error = vk->getError();
+	}
+	VerseKey tmp(pos);
+	return setKey(&tmp);
+}
+
+
 /******************************************************************************
  * SWModule::setPosition(SW_POSITION)	- Positions this modules to an entry
  *
@@ -395,6 +721,16 @@ void SWModule::decrement(int steps) {
  */
 
 ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *scope, bool *justCheckIfSupported, void (*percent)(char, void *), void *percentUserData) {
+	return search(istr, searchType, flags, scope, justCheckIfSupported, 0, percent, percentUserData);
+}
+
+
+ListKey &SWModule::search(SearchCursor &cursor, const char *istr, int searchType, int flags, SWKey *scope, void (*percent)(char, void *), void *percentUserData) {
+	return search(istr, searchType, flags, scope, 0, &cursor, percent, percentUserData);
+}
+
+
+ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *scope, bool *justCheckIfSupported, SearchCursor *cursor, void (*percent)(char, void *), void *percentUserData) {
 
 	listKey.clear();
 	SWBuf term = istr;
@@ -434,6 +770,28 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 #endif
 		return listKey;
 	}
+
+	if (cursor && cursor->complete) {
+		(*percent)(100, percentUserData);
+		return listKey;
+	}
+	bool resuming = (cursor && cursor->position);
+
+	// edits made through this api since the index was built are indexed first
+	const char *dataPath = getConfigEntry("AbsoluteDataPath");
+	if (!resuming && dataPath && (searchType == SEARCHTYPE_ENTRYATTR || searchType == SEARCHTYPE_EXTERNAL)) {
+		if (journalBefore.length()) flush();
+		SearchJournal journal(dataPath);
+		if (journal.load() && journal.getEdits().size() && journal.accountsFor(SearchJournal::getStamp(dataPath))) {
+			updateSearchFramework();
+		}
+	}
+
+	SWMETRICS_ADD(getName(), SEARCHES, 1);
+	SWMETRICS_TIMER(searchTimer, getName(), SEARCH_MICROS);
+	SW_s64 startTime = (cursor && cursor->timeBudget) ? getMilliseconds() : 0;
+	int reportedHits = 0;
+	bool exhausted = false;
 	
 	SWKey *saveKey   = 0;
 	SWKey *searchKey = 0;
@@ -455,6 +813,9 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 
 	vector<SWBuf> words;
 	vector<SWBuf> window;
+	MultiMatcher *wordMatcher = 0;
+	EntryAttributeIndex::Postings attributeHits;
+	bool useAttributeIndex = false;
 	const char *sres;
 	terminateSearch = false;
 	char perc = 1;
@@ -476,7 +837,7 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 	}
 	else	saveKey = key;
 
-	searchKey = (scope)?scope->clone():(key->isPersist())?key->clone():0;
+	searchKey = (resuming)?cursor->position->clone():(scope)?scope->clone():(key->isPersist())?key->clone():0;
 	if (searchKey) {
 		searchKey->setPersist(true);
 		setKey(*searchKey);
@@ -484,11 +845,20 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 
 	(*percent)(perc, percentUserData);
 
-	*this = BOTTOM;
-	long highIndex = key->getIndex();
-	if (!highIndex)
-		highIndex = 1;		// avoid division by zero errors.
-	*this = TOP;
+	long highIndex;
+	if (resuming) {
+		// pick up where the last page left off
+		highIndex = cursor->highIndex;
+		*lastKey = *cursor->lastKey;
+		lastBuf = cursor->lastBuf;
+	}
+	else {
+		*this = BOTTOM;
+		highIndex = key->getIndex();
+		if (!highIndex)
+			highIndex = 1;		// avoid division by zero errors.
+		*this = TOP;
+	}
 	if (searchType >= 0) {
 #ifdef USECXX11REGEX
 		preg = std::regex((SWBuf(".*")+istr+".*").c_str(), std::regex_constants::extended | searchType | flags);
@@ -622,8 +992,7 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 	switch (searchType) {
 
 	case SEARCHTYPE_PHRASE:
-		// let's see if we're told to ignore case.  If so, then we'll touppstr our term
-		if ((flags & REG_ICASE) == REG_ICASE) term.toUpper();
+		wordMatcher = new MultiMatcher(vector<SWBuf>(1, term), ((flags & REG_ICASE) == REG_ICASE));
 		break;
 
 	case SEARCHTYPE_MULTIWORD:
@@ -637,11 +1006,8 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 			}
 			words.push_back(word);
 		}
-		if ((flags & REG_ICASE) == REG_ICASE) {
-			for (unsigned int i = 0; i < words.size(); i++) {
-				words[i].toUpper();
-			}
-		}
+		// built once here, then each entry is read just once for all words, ignoring case as it goes
+		if (searchType == SEARCHTYPE_MULTIWORD) wordMatcher = new MultiMatcher(words, ((flags & REG_ICASE) == REG_ICASE));
 		break;
 
 	// entry attributes
@@ -663,6 +1029,21 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 			includeComponents = true;
 			words[2]--;
 		}
+
+		// the attribute index doesn't keep the level 2 key (e.g., which
+		// word in the verse), so only use it when that level isn't asked for
+		if (vkCheck && ((words.size() < 2) || (!words[1].length()))) {
+			EntryAttributeIndex *index = getCurrentEntryAttributeIndex();
+			if (index) {
+				bool hasValue = (words.size() > 3);
+				// without a value, the scan below accepts any attribute of the type
+				const char *name = (words.size() > 2 && (hasValue || !includeComponents)) ? words[2].c_str() : "";
+				index->find(words[0], name, includeComponents, hasValue ? words[3].c_str() : 0,
+						(flags & SEARCHFLAG_MATCHWHOLEENTRY), ((flags & REG_ICASE) == REG_ICASE), attributeHits);
+				useAttributeIndex = true;
+				setProcessEntryAttributes(false);
+			}
+		}
 		break;
 	}
 
@@ -672,7 +1053,11 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 	(*percent)(perc, percentUserData);
 
 	
-	while ((searchType != SEARCHTYPE_EXTERNAL) && !popError() && !terminateSearch) {
+	while ((searchType != SEARCHTYPE_EXTERNAL) && !terminateSearch) {
+		if (popError()) {
+			exhausted = true;
+			break;
+		}
 		long mindex = key->getIndex();
 		float per = (float)mindex / highIndex;
 		per *= 93;
@@ -701,9 +1086,7 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 #else
 			if (!regexec(&preg, textBuf, 0, 0, 0)) {
 #endif
-				*resultKey = *getKey();
-				resultKey->clearBounds();
-				listKey << *resultKey;
+				addHit(listKey, resultKey, vkCheck, getKey());
 				lastBuf = "";
 			}
 #ifdef USECXX11REGEX
@@ -717,18 +1100,7 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 #else
 			else if (!regexec(&preg, lastBuf + ' ' + textBuf, 0, 0, 0)) {
 #endif
-				lastKey->clearBounds();
-				if (vkCheck) {
-					resultKey->clearBounds();
-					*resultKey = *getKey();
-					vkCheck->setUpperBound(resultKey);
-					vkCheck->setLowerBound(lastKey);
-				}
-				else {
-					*resultKey = *lastKey;
-					resultKey->clearBounds();
-				}
-				listKey << *resultKey;
+				addRangeHit(listKey, resultKey, vkCheck, lastKey, getKey());
 				lastBuf = (windowSize > 1) ? textBuf.c_str() : "";
 			}
 			else {
@@ -745,12 +1117,8 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 
 			case SEARCHTYPE_PHRASE: {
 				textBuf = stripText();
-				if ((flags & REG_ICASE) == REG_ICASE) textBuf.toUpper();
-				sres = strstr(textBuf.c_str(), term.c_str());
-				if (sres) { //it's also in the stripText(), so we have a valid search result item now
-					*resultKey = *getKey();
-					resultKey->clearBounds();
-					listKey << *resultKey;
+				if (wordMatcher->matchesAny(textBuf)) { //it's also in the stripText(), so we have a valid search result item now
+					addHit(listKey, resultKey, vkCheck, getKey());
 				}
 				break;
 			}
@@ -758,7 +1126,7 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 			case SEARCHTYPE_MULTIWORD: { // enclose our allocations
 				int stripped = 0;
 				int multiVerse = 0;
-				unsigned int foundWords = 0;
+				bool foundWords = false;
 				textBuf = getRawEntry();
 				SWBuf testBuf;
 
@@ -779,39 +1147,21 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 					//
 					stripped = 0;
 					do {
-						if (stripped||specialStrips||multiVerse) {
+						if (stripped||specialStrips) {
 							testBuf = multiVerse ? lastBuf + ' ' + textBuf : textBuf;
-							if (stripped||specialStrips) testBuf = stripText(testBuf);
-						}
-						else testBuf.setSize(0);
-						foundWords = 0;
-
-						if ((flags & REG_ICASE) == REG_ICASE) testBuf.size() ? testBuf.toUpper() : textBuf.toUpper();
-						for (unsigned int i = 0; i < words.size(); i++) {
-							sres = strstr(testBuf.size() ? testBuf.c_str() : textBuf.c_str(), words[i].c_str());
-							if (!sres) {
-								break; //for loop
-							}
-							foundWords++;
+							testBuf = stripText(testBuf, (int)testBuf.length());
+							foundWords = wordMatcher->matchesAll(testBuf);
 						}
+						else foundWords = multiVerse ? wordMatcher->matchesAll(lastBuf, textBuf) : wordMatcher->matchesAll(textBuf);
 
 						++stripped;
-					} while ( (stripped < 2) && (foundWords == words.size()));
+					} while ( (stripped < 2) && foundWords);
 					++multiVerse;
-				} while ((windowSize > 1) && (multiVerse < 2) && (stripped != 2 || foundWords != words.size()));
-
-				if ((stripped == 2) && (foundWords == words.size())) { //we found the right words in both raw and stripped text, which means it's a valid result item
-					lastKey->clearBounds();
-					resultKey->clearBounds();
-					*resultKey = (multiVerse > 1 && !vkCheck) ? *lastKey : *getKey();
-					if (multiVerse > 1 && vkCheck) {
-						vkCheck->setUpperBound(resultKey);
-						vkCheck->setLowerBound(lastKey);
-					}
-					else {
-						resultKey->clearBounds();
-					}
-					listKey << *resultKey;
+				} while ((windowSize > 1) && (multiVerse < 2) && (stripped != 2 || !foundWords));
+
+				if ((stripped == 2) && foundWords) { //we found the right words in both raw and stripped text, which means it's a valid result item
+					if (multiVerse > 1) addRangeHit(listKey, resultKey, vkCheck, lastKey, getKey());
+					else addHit(listKey, resultKey, vkCheck, getKey());
 					lastBuf = "";
 					// if we're searching windowSize > 1 and we had a hit which required the current verse
 					// let's start the next window with our current verse in case we have another hit adjacent
@@ -826,95 +1176,57 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 			break;
 
 			case SEARCHTYPE_ENTRYATTR: {
-				renderText();	// force parse
-				AttributeTypeList &entryAttribs = getEntryAttributes();
-				AttributeTypeList::iterator i1Start, i1End;
-				AttributeList::iterator i2Start, i2End;
-				AttributeValue::iterator i3Start, i3End;
-
-				if ((words.size()) && (words[0].length())) {
-// cout << "Word: " << words[0] << endl;
-				for (i1Start = entryAttribs.begin(); i1Start != entryAttribs.end(); ++i1Start) {
-// cout << "stuff: " << i1Start->first.c_str() << endl;
-				}
-					i1Start = entryAttribs.find(words[0]);
-					i1End = i1Start;
-					if (i1End != entryAttribs.end()) {
-						i1End++;
+				if (useAttributeIndex) {
+					if (resultKey->isBoundSet()) resultKey->clearBounds();
+					*resultKey = *getKey();
+					if (std::binary_search(attributeHits.begin(), attributeHits.end(), resultKey->getIndex())) {
+						addHit(listKey, resultKey, vkCheck, getKey());
 					}
+					break;
 				}
-				else {
-					i1Start = entryAttribs.begin();
-					i1End   = entryAttribs.end();
-				}
-				for (;i1Start != i1End; i1Start++) {
-					if ((words.size()>1) && (words[1].length())) {
-						i2Start = i1Start->second.find(words[1]);
-						i2End = i2Start;
-						if (i2End != i1Start->second.end())
-							i2End++;
-					}
-					else {
-						i2Start = i1Start->second.begin();
-						i2End   = i1Start->second.end();
-					}
-					for (;i2Start != i2End; i2Start++) {
-						if ((words.size()>2) && (words[2].length()) && (!includeComponents)) {
-							i3Start = i2Start->second.find(words[2]);
-							i3End = i3Start;
-							if (i3End != i2Start->second.end())
-								i3End++;
+				renderText();	// force parse
+				const EntryAttributeStore &attributes = getEntryAttributeStore();
+				const char *type = ((words.size()) && (words[0].length())) ? words[0].c_str() : 0;
+				const char *item = ((words.size()>1) && (words[1].length())) ? words[1].c_str() : 0;
+				const char *name = ((words.size()>2) && (words[2].length()) && (!includeComponents)) ? words[2].c_str() : 0;
+
+				for (unsigned long i = attributes.find(type, item, name); i < attributes.getCount(); i = attributes.find(type, item, name, i + 1)) {
+					if (words.size() > 3) {
+						const char *value = attributes.getValue(i);
+						if (includeComponents) {
+							SWBuf key = attributes.getName(i);
+							key = key.stripPrefix('.', true);
+							// we're visiting all 3 level keys, so be sure we match our
+							// prefix (e.g., Lemma, Lemma.1, Lemma.2, etc.)
+							if (key != words[2]) continue;
 						}
-						else {
-							i3Start = i2Start->second.begin();
-							i3End   = i2Start->second.end();
+						// we only want 0 length entries as hits
+						if (!words[3].length()) {
+							sres = (!*value) ? value : 0;
 						}
-						for (;i3Start != i3End; i3Start++) {
-							if (words.size() > 3) {
-								if (includeComponents) {
-									SWBuf key = i3Start->first.c_str();
-									key = key.stripPrefix('.', true);
-									// we're iterating all 3 level keys, so be sure we match our
-									// prefix (e.g., Lemma, Lemma.1, Lemma.2, etc.)
-									if (key != words[2]) continue;
-								}
-								// we only want 0 length entries as hits
-								if (!words[3].length()) {
-									if (!i3Start->second.length()) sres = i3Start->second.c_str();
-								}
-								else if (flags & SEARCHFLAG_MATCHWHOLEENTRY) {
-									bool found = !(((flags & REG_ICASE) == REG_ICASE) ? sword::stricmp(i3Start->second.c_str(), words[3]) : strcmp(i3Start->second.c_str(), words[3]));
-									sres = (found) ? i3Start->second.c_str() : 0;
-								}
-								else {
-									sres = ((flags & REG_ICASE) == REG_ICASE) ? stristr(i3Start->second.c_str(), words[3]) : strstr(i3Start->second.c_str(), words[3]);
-								}
-								if (sres) {
-									*resultKey = *getKey();
-									resultKey->clearBounds();
-									listKey << *resultKey;
-									break;
-								}
-							}
-							// If we weren't provided a value for the Entry Attribute, then we simply return if present.
-							else {
-								*resultKey = *getKey();
-								resultKey->clearBounds();
-								listKey << *resultKey;
-								break;
-							}
+						else if (flags & SEARCHFLAG_MATCHWHOLEENTRY) {
+							bool found = !(((flags & REG_ICASE) == REG_ICASE) ? stricmpUTF8(value, words[3]) : strcmp(value, words[3]));
+							sres = (found) ? value : 0;
+						}
+						else {
+							sres = ((flags & REG_ICASE) == REG_ICASE) ? stristrUTF8(value, words[3]) : strstr(value, words[3]);
 						}
-						if (i3Start != i3End)
+						if (sres) {
+							addHit(listKey, resultKey, vkCheck, getKey());
 							break;
+						}
 					}
-					if (i2Start != i2End)
+					// If we weren't provided a value for the Entry Attribute, then we simply return if present.
+					else {
+						addHit(listKey, resultKey, vkCheck, getKey());
 						break;
+					}
 				}
 				break;
 			}
 			// NOT DONE
 			case -5:
-				AttributeList &words = getEntryAttributes()["Word"];
+				AttributeList &words = getEntryAttributesView()["Word"];
 				SWBuf kjvWord = "";
 				SWBuf bibWord = "";
 				for (AttributeList::iterator it = words.begin(); it != words.end(); it++) {
@@ -964,10 +1276,46 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 		}
 		*lastKey = *getKey();
 		(*this)++;
+
+		if (cursor) {
+			bool stop = false;
+			for (; reportedHits < listKey.getCount(); ++reportedHits) {
+				if (cursor->hitCallback && !(*cursor->hitCallback)(*listKey.getElement(reportedHits), cursor->hitUserData)) stop = true;
+			}
+			if (cursor->maxHits && listKey.getCount() >= cursor->maxHits) stop = true;
+			if (cursor->timeBudget && getMilliseconds() - startTime >= cursor->timeBudget) stop = true;
+			if (stop) break;
+		}
+	}
+
+	if (cursor) {
+		// external searches find everything at once
+		if (searchType == SEARCHTYPE_EXTERNAL) {
+			for (; reportedHits < listKey.getCount(); ++reportedHits) {
+				if (cursor->hitCallback && !(*cursor->hitCallback)(*listKey.getElement(reportedHits), cursor->hitUserData)) break;
+			}
+			exhausted = true;
+		}
+		// we may have stopped right at the end
+		if (!exhausted && popError()) exhausted = true;
+
+		delete cursor->position;
+		cursor->position = 0;
+		delete cursor->lastKey;
+		cursor->lastKey = 0;
+		cursor->lastBuf = "";
+		cursor->complete = exhausted;
+		if (!exhausted) {
+			cursor->position = getKey()->clone();
+			cursor->lastKey = lastKey->clone();
+			cursor->lastBuf = lastBuf;
+			cursor->highIndex = highIndex;
+		}
 	}
 	
 
 	// cleaup work
+	delete wordMatcher;
 	if (searchType >= 0) {
 #ifdef USECXX11REGEX
 		std::locale::global(oldLocale);
@@ -992,7 +1340,7 @@ ListKey &SWModule::search(const char *istr, int searchType, int flags, SWKey *sc
 	setProcessEntryAttributes(savePEA);
 
 
-	(*percent)(100, percentUserData);
+	if (!cursor || cursor->complete) (*percent)(100, percentUserData);
 
 
 	return listKey;
@@ -1027,6 +1375,47 @@ const char *SWModule::getRenderHeader() const {
 }
 
 
+/******************************************************************************
+ * SWModule::getEntryAttributeStore	- the current entry's attributes
+ */
+
+EntryAttributeStore &SWModule::getEntryAttributeStore() const {
+	// the view was handed out since the entry was rendered; take back
+	// any changes made to it before the store changes
+	if (entryAttributesHandedOut) {
+		entryAttributeStore.assign(entryAttributes);
+		entryAttributesHandedOut = false;
+	}
+	entryAttributesCurrent = false;
+	return entryAttributeStore;
+}
+
+
+/******************************************************************************
+ * SWModule::getEntryAttributes	- the current entry's attributes, as maps
+ */
+
+AttributeTypeList &SWModule::getEntryAttributes() const {
+	entryAttributesHeld = true;
+	return getEntryAttributesView();
+}
+
+
+/******************************************************************************
+ * SWModule::getEntryAttributesView	- the current entry's attributes, as
+ *					maps built on request
+ */
+
+AttributeTypeList &SWModule::getEntryAttributesView() const {
+	if (!entryAttributesCurrent) {
+		entryAttributeStore.copyTo(entryAttributes);
+		entryAttributesCurrent = true;
+	}
+	entryAttributesHandedOut = true;
+	return entryAttributes;
+}
+
+
 /******************************************************************************
  * SWModule::renderText 	- calls all renderfilters on current module
  *				position
@@ -1057,7 +1446,9 @@ SWBuf SWModule::renderText() {
 SWBuf SWModule::renderText(const char *buf, int len, bool render) const {
 	bool savePEA = isProcessEntryAttributes();
 	if (!buf) {
-		entryAttributes.clear();
+		entryAttributeStore.clear();
+		entryAttributesCurrent = false;
+		entryAttributesHandedOut = false;
 	}
 	else {
 		setProcessEntryAttributes(false);
@@ -1076,13 +1467,23 @@ SWBuf SWModule::renderText(const char *buf, int len, bool render) const {
 		if (size > 0) {
 			key = this->getKey();
 
-			optionFilter(tmpbuf, key);
-	
 			if (render) {
-				renderFilter(tmpbuf, key);
+				// same as optionFilter() then renderFilter(), but skipping
+				// idle filters and sharing one parse between token filters
+				if (!renderPipeline->isCurrent(optionFilters, renderFilters)) {
+					renderPipeline->compile(optionFilters, renderFilters);
+				}
+				renderPipeline->processText(tmpbuf, key, this);
 				encodingFilter(tmpbuf, key);
 			}
-			else	stripFilter(tmpbuf, key);
+			else {
+				// same as optionFilter() then stripFilter(), but skipping
+				// idle filters and fusing character and token filters
+				if (!stripPipeline->isCurrent(optionFilters, stripFilters)) {
+					stripPipeline->compile(optionFilters, stripFilters);
+				}
+				stripPipeline->processText(tmpbuf, key, this);
+			}
 		}
 	}
 	else {
@@ -1091,6 +1492,15 @@ SWBuf SWModule::renderText(const char *buf, int len, bool render) const {
 
 	setProcessEntryAttributes(savePEA);
 
+	// references from getEntryAttributes() show the entry just rendered,
+	// including anything a filter set through the view
+	if (!buf && entryAttributesHeld) {
+		if (entryAttributesHandedOut) entryAttributeStore.assign(entryAttributes);
+		entryAttributeStore.copyTo(entryAttributes);
+		entryAttributesCurrent = true;
+		entryAttributesHandedOut = false;
+	}
+
 	return tmpbuf;
 }
 
@@ -1195,12 +1605,19 @@ bool SWModule::hasSearchFramework() {
 }
 
 void SWModule::deleteSearchFramework() {
-#ifdef USELUCENE
-	SWBuf target = getConfigEntry("AbsoluteDataPath");
+	deleteEntryAttributeIndex();
+	const char *dataPath = getConfigEntry("AbsoluteDataPath");
+	if (dataPath) SearchJournal::remove(dataPath);
+#if defined USELUCENE || defined USEXAPIAN
+	SWBuf target = dataPath;
 	if (!target.endsWith("/") && !target.endsWith("\\")) {
 		target.append('/');
 	}
+#if defined USEXAPIAN
+	target.append("xapian");
+#else
 	target.append("lucene");
+#endif
 
 	FileMgr::removeDir(target.c_str());
 #else
@@ -1209,7 +1626,162 @@ void SWModule::deleteSearchFramework() {
 }
 
 
-signed char SWModule::createSearchFramework(void (*percent)(char, void *), void *percentUserData) {
+EntryAttributeIndex *SWModule::getCurrentEntryAttributeIndex() {
+	const char *dataPath = getConfigEntry("AbsoluteDataPath");
+	if (!dataPath) return 0;
+
+	if (!attributeIndex) {
+		if (!FileMgr::existsFile(EntryAttributeIndex::getIndexPath(dataPath))) return 0;
+		attributeIndex = new EntryAttributeIndex(dataPath);
+		if (!attributeIndex->load()) {
+			delete attributeIndex;
+			attributeIndex = 0;
+			return 0;
+		}
+	}
+	if (!attributeIndex->isCurrent()) {
+		// maybe someone rebuilt it since we loaded it
+		if (!attributeIndex->load() || !attributeIndex->isCurrent()) {
+			delete attributeIndex;
+			attributeIndex = 0;
+		}
+	}
+	return attributeIndex;
+}
+
+
+void SWModule::deleteEntryAttributeIndex() {
+	delete attributeIndex;
+	attributeIndex = 0;
+
+	const char *dataPath = getConfigEntry("AbsoluteDataPath");
+	if (dataPath) FileMgr::removeFile(EntryAttributeIndex::getIndexPath(dataPath));
+}
+
+
+signed char SWModule::createEntryAttributeIndex(void (*percent)(char, void *), void *percentUserData) {
+
+	const char *dataPath = getConfigEntry("AbsoluteDataPath");
+	if (!dataPath) return -1;
+
+	// LD and GenBook indexes aren't stable positions we can store
+	SWKey *textKey = createKey();
+	VerseKey *vkey = SWDYNAMIC_CAST(VerseKey, textKey);
+	if (!vkey) {
+		delete textKey;
+		return 1;
+	}
+	// index intros too, in case a search scope includes them
+	vkey->setIntros(true);
+	textKey->setPersist(true);
+
+	EntryAttributeIndex *index = new EntryAttributeIndex(dataPath);
+
+	SWKey *saveKey = 0;
+	if (!key->isPersist()) {
+		saveKey = createKey();
+		*saveKey = *key;
+	}
+	else	saveKey = key;
+
+	bool savePEA = isProcessEntryAttributes();
+	setProcessEntryAttributes(true);
+
+	setKey(*textKey);
+	*this = BOTTOM;
+	long highIndex = key->getIndex();
+	if (!highIndex)
+		highIndex = 1;		// avoid division by zero errors.
+	char perc = 0;
+	(*percent)(perc, percentUserData);
+
+	*this = TOP;
+	while (!popError()) {
+		long mindex = key->getIndex();
+		char newperc = (char)((float)mindex / highIndex * 99);
+		if (newperc > perc) {
+			perc = newperc;
+			(*percent)(perc, percentUserData);
+		}
+
+		renderText();	// force parse
+		addEntryAttributes(index, getEntryAttributeStore(), mindex);
+		(*this)++;
+	}
+
+	// reposition module back to where it was before we were called
+	setKey(*saveKey);
+	if (!saveKey->isPersist())
+		delete saveKey;
+	delete textKey;
+
+	setProcessEntryAttributes(savePEA);
+
+	signed char retVal = index->save();
+	delete attributeIndex;
+	attributeIndex = index;
+
+	(*percent)(100, percentUserData);
+
+	return retVal;
+}
+
+
+signed char SWModule::updateEntryAttributeIndex(const SWBuf &base, const std::vector<long> &edited) {
+	const char *dataPath = getConfigEntry("AbsoluteDataPath");
+
+	EntryAttributeIndex *index = new EntryAttributeIndex(dataPath);
+	if (!index->load()) {
+		delete index;
+		return 0;	// nothing to update
+	}
+	if (SearchJournal::getSignatureStamp(index->getSignature()) != base) {
+		// built apart from the rest of the framework
+		bool current = index->isCurrent();
+		delete index;
+		return (current) ? 0 : ((createEntryAttributeIndex() < 0) ? -1 : 0);
+	}
+
+	index->remove(edited);
+
+	SWKey *textKey = createKey();
+	((VerseKey *)textKey)->setIntros(true);
+	textKey->setPersist(true);
+
+	SWKey *saveKey = 0;
+	if (!key->isPersist()) {
+		saveKey = createKey();
+		*saveKey = *key;
+	}
+	else	saveKey = key;
+
+	bool savePEA = isProcessEntryAttributes();
+	setProcessEntryAttributes(true);
+
+	setKey(*textKey);
+	for (std::vector<long>::const_iterator i = edited.begin(); i != edited.end(); ++i) {
+		key->setIndex(*i);
+		renderText();	// force parse
+		addEntryAttributes(index, getEntryAttributeStore(), *i);
+	}
+
+	// reposition module back to where it was before we were called
+	setKey(*saveKey);
+	if (!saveKey->isPersist())
+		delete saveKey;
+	delete textKey;
+
+	setProcessEntryAttributes(savePEA);
+
+	signed char retVal = index->save();
+	delete attributeIndex;
+	attributeIndex = index;
+
+	return retVal;
+}
+
+
+signed char SWModule::indexEntries(const std::vector<long> *edited, void (*percent)(char, void *), void *percentUserData) {
 
 #if defined USELUCENE || defined USEXAPIAN
 	SWBuf target = getConfigEntry("AbsoluteDataPath");
@@ -1227,8 +1799,6 @@ signed char SWModule::createSearchFramework(void (*percent)(char, void *), void
 
 	SWKey *saveKey = 0;
 	SWKey *searchKey = 0;
-	SWKey textkey;
-	SWBuf c;
 
 
 	// turn all filters to default values
@@ -1308,304 +1878,153 @@ signed char SWModule::createSearchFramework(void (*percent)(char, void *), void
 	bool savePEA = isProcessEntryAttributes();
 	setProcessEntryAttributes(true);
 
-	// prox chapter blocks
+	// Bible entries are stripped by worker threads, each with its own copy
+	// of this module, set as we are, while this thread reads ahead and writes
+	std::vector<IndexJob *> jobs;
+	int threads = (vkcheck && !edited) ? getIndexThreads() : 1;
+	if (threads > 1) {
+		// what a worker would otherwise set up on first use, set up here
+		LocaleMgr::getSystemLocaleMgr();
+		StringMgr::getSystemStringMgr();
+		SWLog::getSystemLog();
+
+		for (int i = 0; i < threads; i++) {
+			IndexJob *job = new IndexJob(*this, i, threads);
+			if (!job->module) {
+				delete job;
+				break;
+			}
+			for (OptionFilterList::iterator workerFilter = job->module->optionFilters->begin(); workerFilter != job->module->optionFilters->end(); workerFilter++) {
+				for (OptionFilterList::iterator filter = optionFilters->begin(); filter != optionFilters->end(); filter++) {
+					if (!strcmp((*workerFilter)->getOptionName(), (*filter)->getOptionName())) {
+						(*workerFilter)->setOptionValue((*filter)->getOptionValue());
+					}
+				}
+			}
+			job->module->setProcessEntryAttributes(true);
+			((VerseKey *)job->module->getKey())->setIntros(true);
+			jobs.push_back(job);
+		}
+		// a copy we can't make leaves it all to this thread
+		if (jobs.size() < (size_t)threads) {
+			for (size_t i = 0; i < jobs.size(); i++) delete jobs[i];
+			jobs.clear();
+		}
+	}
+	SWThread *workers = (jobs.size()) ? new SWThread[jobs.size()] : 0;
+
+	std::vector<IndexEntry> entries;
+	ProxFields prox;
+#if defined USELUCENE
+	std::vector<SWBuf> replacedKeys;
+#endif
+
 	// position module at the beginning
 	*this = TOP;
 
-	SWBuf proxBuf;
-	SWBuf proxLem;
-	SWBuf proxMorph;
-	SWBuf strong;
-	SWBuf morph;
-
 	char err = popError();
 	while (!err) {
-		long mindex = key->getIndex();
-
-		proxBuf = "";
-		proxLem = "";
-		proxMorph = "";
-
-		// computer percent complete so we can report to our progress callback
-		float per = (float)mindex / highIndex;
-		// between 5%-98%
-		per *= 93; per += 5;
-		char newperc = (char)per;
-		if (newperc > perc) {
-			perc = newperc;
-			(*percent)(perc, percentUserData);
-		}
 
-		// get "content" field
-		SWBuf contentBuf = stripText();
-		const char *content = contentBuf;
+		// Bible entries are gathered a batch at a time, ending before a
+		// first verse, so each chapter's entries are together for its
+		// prox fields; other entries are written as they are read
+		entries.clear();
+		do {
+			long mindex = key->getIndex();
+
+			// computer percent complete so we can report to our progress callback
+			float per = (float)mindex / highIndex;
+			// between 5%-98%
+			per *= 93; per += 5;
+			char newperc = (char)per;
+			if (newperc > perc) {
+				perc = newperc;
+				(*percent)(perc, percentUserData);
+			}
 
-		bool good = false;
+			entries.push_back(IndexEntry());
+			IndexEntry &entry = entries.back();
+			entry.index = mindex;
+			entry.proxEnd = -1;
+			// get "key" field
+			entry.keyText = (vkcheck) ? vkcheck->getOSISRef() : getKeyText();
 
-		// start out entry
-#if defined USEXAPIAN
-		Xapian::Document doc;
-		termGenerator.set_document(doc);
-#elif defined USELUCENE
-		Document *doc = new Document();
-#endif
-		// get "key" field
-		SWBuf keyText = (vkcheck) ? vkcheck->getOSISRef() : getKeyText();
-		if (content && *content) {
-			good = true;
+			// get "content", "strong" and "morph" fields, now or by a worker
+			if (jobs.size()) entry.text = getRawEntryBuf();
+			else {
+				entry.text = stripText();
+				if (entry.text.length()) getWordFields(getEntryAttributeStore(), entry.strong, entry.morph);
+			}
 
+			// for VerseKeys prox is the chapter, for the first verse in it
+			if (vkcheck) {
+				if (vkcheck->getVerse() == 1) {
+					*chapMax = *vkcheck;
+					*chapMax = MAXVERSE;
+					entry.proxEnd = chapMax->getIndex();
+				}
+			}
 
-			// build "strong" field
-			AttributeTypeList::iterator words;
-			AttributeList::iterator word;
-			AttributeValue::iterator strongVal;
-			AttributeValue::iterator morphVal;
-
-			strong="";
-			morph="";
-			words = getEntryAttributes().find("Word");
-			if (words != getEntryAttributes().end()) {
-				for (word = words->second.begin();word != words->second.end(); word++) {
-					int partCount = atoi(word->second["PartCount"]);
-					if (!partCount) partCount = 1;
-					for (int i = 0; i < partCount; i++) {
-						SWBuf tmp = "Lemma";
-						if (partCount > 1) tmp.appendFormatted(".%d", i+1);
-						strongVal = word->second.find(tmp);
-						if (strongVal != word->second.end()) {
-							// cheeze.  skip empty article tags that weren't assigned to any text
-							if (strongVal->second == "G3588") {
-								if (word->second.find("Text") == word->second.end())
-									continue;	// no text? let's skip
-							}
-							strong.append(strongVal->second);
-							morph.append(strongVal->second);
-							morph.append('@');
-							SWBuf tmp = "Morph";
-							if (partCount > 1) tmp.appendFormatted(".%d", i+1);
-							morphVal = word->second.find(tmp);
-							if (morphVal != word->second.end()) {
-								morph.append(morphVal->second);
-							}
-							strong.append(' ');
-							morph.append(' ');
-						}
+			// for TreeKeys use siblings if we have no children
+			else {
+				prox.clear();
+				if (tkcheck && !tkcheck->hasChildren()) {
+					if (!tkcheck->previousSibling()) {
+						IndexEntry sibling;
+						do {
+							sibling.text = stripText();
+							if (sibling.text.length()) getWordFields(getEntryAttributeStore(), sibling.strong, sibling.morph);
+							prox.append(sibling);
+						} while (tkcheck->nextSibling());
+						tkcheck->parent();
+						tkcheck->firstChild();
 					}
+					else tkcheck->nextSibling();	// reposition from our previousSibling test
 				}
 			}
 
-#if defined USEXAPIAN
-			doc.set_data(keyText.c_str());
-#elif defined USELUCENE
-			doc->add(*_CLNEW Field(_T("key"), (wchar_t *)utf8ToWChar(keyText).getRawData(), Field::STORE_YES | Field::INDEX_UNTOKENIZED));
-#endif
+			(*this)++;
+			err = popError();
+		} while (!err && vkcheck && ((entries.size() < INDEX_BATCH) || (vkcheck->getVerse() != 1)));
 
-			if (includeKeyInSearch) {
-				c = keyText;
-				c += " ";
-				c += content;
-				content = c.c_str();
+		if (jobs.size()) {
+			for (size_t i = 0; i < jobs.size(); i++) {
+				jobs[i]->entries = &entries;
 			}
-
-#if defined USEXAPIAN
-			termGenerator.index_text(content);
-			termGenerator.index_text(content, 1, "C");
-#elif defined USELUCENE
-			doc->add(*_CLNEW Field(_T("content"), (wchar_t *)utf8ToWChar(content).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED));
-#endif
-
-			if (strong.length() > 0) {
-#if defined USEXAPIAN
-				termGenerator.index_text(strong.c_str(), 1, "L");
-				termGenerator.index_text(morph.c_str(), 1, "M");
-#elif defined USELUCENE
-				doc->add(*_CLNEW Field(_T("lemma"), (wchar_t *)utf8ToWChar(strong).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED));
-				doc->add(*_CLNEW Field(_T("morph"), (wchar_t *)utf8ToWChar(morph).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED));
-#endif
-//printf("setting fields (%s).\ncontent: %s\nlemma: %s\n", (const char *)*key, content, strong.c_str());
+			// this thread takes the first share
+			for (size_t i = 1; i < jobs.size(); i++) {
+				if (!workers[i].start(stripIndexEntries, jobs[i])) stripIndexEntries(jobs[i]);
 			}
-
-//printf("setting fields (%s).\n", (const char *)*key);
-//fflush(stdout);
-		}
-		// don't write yet, cuz we have to see if we're the first of a prox block (5:1 or chapter5/verse1
-
-		// for VerseKeys use chapter
-		if (vkcheck) {
-			*chapMax = *vkcheck;
-			// we're the first verse in a chapter
-			if (vkcheck->getVerse() == 1) {
-				*chapMax = MAXVERSE;
-				VerseKey saveKey = *vkcheck;
-				while ((!err) && (*vkcheck <= *chapMax)) {
-//printf("building proxBuf from (%s).\nproxBuf.c_str(): %s\n", (const char *)*key, proxBuf.c_str());
-//printf("building proxBuf from (%s).\n", (const char *)*key);
-
-					contentBuf = stripText();
-					content = contentBuf.c_str();
-					if (content && *content) {
-						// build "strong" field
-						strong = "";
-						morph = "";
-						AttributeTypeList::iterator words;
-						AttributeList::iterator word;
-						AttributeValue::iterator strongVal;
-						AttributeValue::iterator morphVal;
-
-						words = getEntryAttributes().find("Word");
-						if (words != getEntryAttributes().end()) {
-							for (word = words->second.begin();word != words->second.end(); word++) {
-								int partCount = atoi(word->second["PartCount"]);
-								if (!partCount) partCount = 1;
-								for (int i = 0; i < partCount; i++) {
-									SWBuf tmp = "Lemma";
-									if (partCount > 1) tmp.appendFormatted(".%d", i+1);
-									strongVal = word->second.find(tmp);
-									if (strongVal != word->second.end()) {
-										// cheeze.  skip empty article tags that weren't assigned to any text
-										if (strongVal->second == "G3588") {
-											if (word->second.find("Text") == word->second.end())
-												continue;	// no text? let's skip
-										}
-										strong.append(strongVal->second);
-										morph.append(strongVal->second);
-										morph.append('@');
-										SWBuf tmp = "Morph";
-										if (partCount > 1) tmp.appendFormatted(".%d", i+1);
-										morphVal = word->second.find(tmp);
-										if (morphVal != word->second.end()) {
-											morph.append(morphVal->second);
-										}
-										strong.append(' ');
-										morph.append(' ');
-									}
-								}
-							}
-						}
-						proxBuf += content;
-						proxBuf.append(' ');
-						proxLem += strong;
-						proxMorph += morph;
-						if (proxLem.length()) {
-							proxLem.append("\n");
-							proxMorph.append("\n");
-						}
-					}
-					(*this)++;
-					err = popError();
-				}
-				err = 0;
-				*vkcheck = saveKey;
+			stripIndexEntries(jobs[0]);
+			for (size_t i = 1; i < jobs.size(); i++) {
+				workers[i].join();
 			}
 		}
 
-		// for TreeKeys use siblings if we have no children
-		else if (tkcheck) {
-			if (!tkcheck->hasChildren()) {
-				if (!tkcheck->previousSibling()) {
-					do {
-//printf("building proxBuf from (%s).\n", (const char *)*key);
-//fflush(stdout);
-
-						contentBuf = stripText();
-						content = contentBuf.c_str();
-						if (content && *content) {
-							// build "strong" field
-							strong = "";
-							morph = "";
-							AttributeTypeList::iterator words;
-							AttributeList::iterator word;
-							AttributeValue::iterator strongVal;
-							AttributeValue::iterator morphVal;
-
-							words = getEntryAttributes().find("Word");
-							if (words != getEntryAttributes().end()) {
-								for (word = words->second.begin();word != words->second.end(); word++) {
-									int partCount = atoi(word->second["PartCount"]);
-									if (!partCount) partCount = 1;
-									for (int i = 0; i < partCount; i++) {
-										SWBuf tmp = "Lemma";
-										if (partCount > 1) tmp.appendFormatted(".%d", i+1);
-										strongVal = word->second.find(tmp);
-										if (strongVal != word->second.end()) {
-											// cheeze.  skip empty article tags that weren't assigned to any text
-											if (strongVal->second == "G3588") {
-												if (word->second.find("Text") == word->second.end())
-													continue;	// no text? let's skip
-											}
-											strong.append(strongVal->second);
-											morph.append(strongVal->second);
-											morph.append('@');
-											SWBuf tmp = "Morph";
-											if (partCount > 1) tmp.appendFormatted(".%d", i+1);
-											morphVal = word->second.find(tmp);
-											if (morphVal != word->second.end()) {
-												morph.append(morphVal->second);
-											}
-											strong.append(' ');
-											morph.append(' ');
-										}
-									}
-								}
-							}
+		for (size_t i = 0; i < entries.size(); i++) {
+			// updating, the chapter is read for its prox fields, but only
+			// what the edited entries changed is written
+			if (edited && (entries[i].proxEnd < 0) && !std::binary_search(edited->begin(), edited->end(), entries[i].index)) continue;
 
-							proxBuf += content;
-							proxBuf.append(' ');
-							proxLem += strong;
-							proxMorph += morph;
-							if (proxLem.length()) {
-								proxLem.append("\n");
-								proxMorph.append("\n");
-							}
-						}
-					} while (tkcheck->nextSibling());
-					tkcheck->parent();
-					tkcheck->firstChild();
+			if (vkcheck) {
+				prox.clear();
+				if (entries[i].proxEnd >= 0) {
+					for (size_t j = i; (j < entries.size()) && (entries[j].index <= entries[i].proxEnd); j++) {
+						prox.append(entries[j]);
+					}
 				}
-				else tkcheck->nextSibling();	// reposition from our previousSibling test
 			}
-		}
-
-		if (proxBuf.length() > 0) {
-
-#if defined USEXAPIAN
-			termGenerator.index_text(proxBuf.c_str(), 1, "P");
-#elif defined USELUCENE
-			doc->add(*_CLNEW Field(_T("prox"), (wchar_t *)utf8ToWChar(proxBuf).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED));
-#endif
-			good = true;
-		}
-		if (proxLem.length() > 0) {
 #if defined USEXAPIAN
-			termGenerator.index_text(proxLem.c_str(), 1, "PL");
-			termGenerator.index_text(proxMorph.c_str(), 1, "PM");
+			addSearchDocument(database, termGenerator, entries[i], prox, includeKeyInSearch, edited != 0);
 #elif defined USELUCENE
-			doc->add(*_CLNEW Field(_T("proxlem"), (wchar_t *)utf8ToWChar(proxLem).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED) );
-			doc->add(*_CLNEW Field(_T("proxmorph"), (wchar_t *)utf8ToWChar(proxMorph).getRawData(), Field::STORE_NO | Field::INDEX_TOKENIZED) );
+			if (edited) replacedKeys.push_back(entries[i].keyText);
+			addSearchDocument(coreWriter, entries[i], prox, includeKeyInSearch, edited != 0);
 #endif
-			good = true;
 		}
-		if (good) {
-//printf("writing (%s).\n", (const char *)*key);
-//fflush(stdout);
-#if defined USEXAPIAN
-			SWBuf idTerm;
-			idTerm.setFormatted("Q%ld", key->getIndex());
-			doc.add_boolean_term(idTerm.c_str());
-			database.replace_document(idTerm.c_str(), doc);
-#elif defined USELUCENE
-			coreWriter->addDocument(doc);
-#endif
-		}
-#if defined USEXAPIAN
-#elif defined USELUCENE
-		delete doc;
-#endif
-
-		(*this)++;
-		err = popError();
 	}
 
+	delete [] workers;
+	for (size_t i = 0; i < jobs.size(); i++) delete jobs[i];
 	// Optimizing automatically happens with the call to addIndexes
 	//coreWriter->optimize();
 #if defined USEXAPIAN
@@ -1622,6 +2041,17 @@ signed char SWModule::createSearchFramework(void (*percent)(char, void *), void
 		if (IndexReader::isLocked(d)) {
 			IndexReader::unlock(d);
 		}
+		// documents being replaced go first, found by their key
+		if (replacedKeys.size()) {
+			IndexReader *reader = IndexReader::open(d);
+			for (size_t i = 0; i < replacedKeys.size(); i++) {
+				Term *keyTerm = _CLNEW Term(_T("key"), (wchar_t *)utf8ToWChar(replacedKeys[i]).getRawData());
+				reader->deleteDocuments(keyTerm);
+				_CLDECDELETE(keyTerm);
+			}
+			reader->close();
+			_CLDELETE(reader);
+		}
 		fsWriter = new IndexWriter( d, an, false);
 	}
 	else {
@@ -1667,8 +2097,169 @@ signed char SWModule::createSearchFramework(void (*percent)(char, void *), void
 
 	return 0;
 #else
-	return SWSearchable::createSearchFramework(percent, percentUserData);
+	return 0;
+#endif
+}
+
+
+signed char SWModule::createSearchFramework(void (*percent)(char, void *), void *percentUserData) {
+
+#if defined USELUCENE || defined USEXAPIAN
+	if (indexEntries(0, percent, percentUserData)) return -1;
+	if (createEntryAttributeIndex() < 0) return -1;
+#else
+	createEntryAttributeIndex();
+	if (SWSearchable::createSearchFramework(percent, percentUserData)) return -1;
+#endif
+
+	// from here on, edits are journaled so the framework can be updated;
+	// what it was built from must be on disk for the journal's stamp
+	flush();
+	const char *dataPath = getConfigEntry("AbsoluteDataPath");
+	if (dataPath) SearchJournal::start(dataPath);
+
+	return 0;
+}
+
+
+signed char SWModule::updateSearchFramework(void (*percent)(char, void *), void *percentUserData) {
+	const char *dataPath = getConfigEntry("AbsoluteDataPath");
+	if (!dataPath) return -1;
+
+	// anything but our own edits since it was built means starting over
+	if (journalBefore.length()) flush();
+	SearchJournal journal(dataPath);
+	if (!journal.load() || !journal.accountsFor(SearchJournal::getStamp(dataPath))) {
+		deleteSearchFramework();
+		return createSearchFramework(percent, percentUserData);
+	}
+
+	signed char retVal = 0;
+	if (journal.getEdits().size()) {
+		SWKey *textKey = createKey();
+		VerseKey *vkey = SWDYNAMIC_CAST(VerseKey, textKey);
+
+		// LD and GenBook positions move as entries come and go; without an
+		// external index, there is nothing of theirs to update
+		if (!vkey) {
+			delete textKey;
+#if defined USELUCENE || defined USEXAPIAN
+			deleteSearchFramework();
+			return createSearchFramework(percent, percentUserData);
 #endif
+		}
+		else {
+			std::vector<long> edited;
+			for (SearchJournal::EditList::const_iterator edit = journal.getEdits().begin(); edit != journal.getEdits().end(); ++edit) {
+				edited.push_back(edit->index);
+			}
+			std::sort(edited.begin(), edited.end());
+			edited.erase(std::unique(edited.begin(), edited.end()), edited.end());
+
+#if defined USELUCENE || defined USEXAPIAN
+			// each edited entry's own document, and its chapter's prox document
+			vkey->setIntros(true);
+			std::map<long, long> ranges;
+			for (std::vector<long>::const_iterator i = edited.begin(); i != edited.end(); ++i) {
+				vkey->setIndex(*i);
+				if (vkey->getChapter() < 1 || vkey->getVerse() < 1) {
+					if (ranges.find(*i) == ranges.end()) ranges[*i] = *i;
+					continue;
+				}
+				vkey->setVerse(1);
+				long first = vkey->getIndex();
+				*vkey = MAXVERSE;
+				ranges[first] = vkey->getIndex();
+			}
+
+			SWKey *saveKey = 0;
+			if (!key->isPersist()) {
+				saveKey = createKey();
+				*saveKey = *key;
+			}
+			else	saveKey = key;
+
+			VerseKey *rangeKey = (VerseKey *)vkey->clone();
+			rangeKey->setPersist(true);
+			char perc = 0;
+			int done = 0;
+			for (std::map<long, long>::const_iterator range = ranges.begin(); !retVal && range != ranges.end(); ++range) {
+				char newperc = (char)((float)done++ / ranges.size() * 90);
+				if (newperc > perc) {
+					perc = newperc;
+					(*percent)(perc, percentUserData);
+				}
+				vkey->setIndex(range->first);
+				rangeKey->setLowerBound(*vkey);
+				vkey->setIndex(range->second);
+				rangeKey->setUpperBound(*vkey);
+				setKey(*rangeKey);
+				retVal = indexEntries(&edited, &nullPercent, 0);
+			}
+
+			// reposition module back to where it was before we were called
+			setKey(*saveKey);
+			if (!saveKey->isPersist())
+				delete saveKey;
+			delete rangeKey;
+#endif
+			delete textKey;
+
+			if (!retVal) retVal = updateEntryAttributeIndex(journal.getBase(), edited);
+		}
+	}
+
+	if (!retVal) retVal = SearchJournal::start(dataPath);
+
+	(*percent)(100, percentUserData);
+
+	return retVal;
+}
+
+
+bool SWModule::isSearchFrameworkCurrent() {
+	const char *dataPath = getConfigEntry("AbsoluteDataPath");
+	if (!dataPath) return false;
+
+	if (journalBefore.length()) flush();
+	SearchJournal journal(dataPath);
+	return journal.load() && journal.getEdits().empty() && journal.accountsFor(SearchJournal::getStamp(dataPath));
+}
+
+
+void SWModule::stripIndexEntries(void *userData) {
+#if defined USELUCENE || defined USEXAPIAN
+	IndexJob *job = (IndexJob *)userData;
+	SWModule *module = job->module;
+	VerseKey *key = (VerseKey *)module->getKey();
+	std::vector<IndexEntry> &entries = *job->entries;
+
+	// as stripText() would, but from the raw text we were given
+	for (size_t i = job->first; i < entries.size(); i += job->step) {
+		IndexEntry &entry = entries[i];
+		key->setIndex(entry.index);
+		module->entryAttributeStore.clear();
+		module->entryAttributesCurrent = false;
+		module->entryAttributesHandedOut = false;
+		if (entry.text.length()) {
+			if (!module->stripPipeline->isCurrent(module->optionFilters, module->stripFilters)) {
+				module->stripPipeline->compile(module->optionFilters, module->stripFilters);
+			}
+			module->stripPipeline->processText(entry.text, key, module);
+			if (entry.text.length()) getWordFields(module->entryAttributeStore, entry.strong, entry.morph);
+		}
+	}
+#endif
+}
+
+
+void SWModule::setIndexThreads(int count) {
+	indexThreads = (count > 0) ? count : 0;
+}
+
+
+int SWModule::getIndexThreads() {
+	return (indexThreads) ? indexThreads : SWThread::getProcessorCount();
 }
 
 /** OptionFilterBuffer a text buffer
@@ -1679,7 +2270,9 @@ signed char SWModule::createSearchFramework(void (*percent)(char, void *), void
 void SWModule::filterBuffer(OptionFilterList *filters, SWBuf &buf, const SWKey *key) const {
 	OptionFilterList::iterator it;
 	for (it = filters->begin(); it != filters->end(); it++) {
+		SWMETRICS_START(filterStart);
 		(*it)->processText(buf, key, this);
+		SWMETRICS_FILTER_SINCE(filterStart, getName(), typeid(**it).name());
 	}
 }
 
@@ -1691,7 +2284,9 @@ void SWModule::filterBuffer(OptionFilterList *filters, SWBuf &buf, const SWKey *
 void SWModule::filterBuffer(FilterList *filters, SWBuf &buf, const SWKey *key) const {
 	FilterList::iterator it;
 	for (it = filters->begin(); it != filters->end(); it++) {
+		SWMETRICS_START(filterStart);
 		(*it)->processText(buf, key, this);
+		SWMETRICS_FILTER_SINCE(filterStart, getName(), typeid(**it).name());
 	}
 }
 
@@ -1699,6 +2294,42 @@ signed char SWModule::createModule(const char*) {
 	return -1;
 }
 
+SWModule::EntryEdit::EntryEdit(SWModule *module) : module(module) {
+	const char *path = module->getConfigEntry("AbsoluteDataPath");
+	if (path && SearchJournal::exists(path)) {
+		dataPath = path;
+		if (!module->journalBefore.length()) {
+			module->journalBefore = SearchJournal::getStamp(dataPath);
+			module->journalDataPath = dataPath;
+		}
+	}
+}
+
+
+SWModule::EntryEdit::~EntryEdit() {
+	if (!dataPath.length()) return;
+
+	SWKey *editKey = module->createKey();
+	*editKey = *module->getKey();
+	VerseKey *vkey = SWDYNAMIC_CAST(VerseKey, editKey);
+	long index = (vkey) ? vkey->getIndex() : -1;
+	SearchJournal::record(dataPath, index, editKey->getText());
+	delete editKey;
+}
+
+
+void SWModule::flush() {
+	sealJournal();
+}
+
+
+void SWModule::sealJournal() {
+	if (!journalBefore.length()) return;
+	SearchJournal::seal(journalDataPath, journalBefore, SearchJournal::getStamp(journalDataPath));
+	journalBefore = "";
+}
+
+
 void SWModule::setEntry(const char*, long) {
 }
 
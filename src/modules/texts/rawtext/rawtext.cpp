@@ -32,6 +32,7 @@
 #include <filemgr.h>
 #include <versekey.h>
 #include <stringmgr.h>
+#include <swmetrics.h>
 
 #include <regex.h>	// GNU
 #include <map>
@@ -101,18 +102,21 @@ SWBuf &RawText::getRawEntryBuf() const {
 
 //	if (!isUnicode())
 		prepText(entryBuf);
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
 
 
 void RawText::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 	VerseKey &key = getVerseKey();
 	doSetText(key.getTestament(), key.getTestamentIndex(), inbuf, len);
 }
 
 
 void RawText::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 	VerseKey &destkey = getVerseKey();
 	const VerseKey *srckey = &getVerseKeyConst(inkey);
 	doLinkEntry(destkey.getTestament(), destkey.getTestamentIndex(), srckey->getTestamentIndex());
@@ -126,6 +130,7 @@ void RawText::linkEntry(const SWKey *inkey) {
  */
 
 void RawText::deleteEntry() {
+	EntryEdit edit(this);
 	VerseKey &key = getVerseKey();
 	doSetText(key.getTestament(), key.getTestamentIndex(), "");
 }
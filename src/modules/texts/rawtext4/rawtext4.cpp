@@ -32,6 +32,7 @@
 #include <filemgr.h>
 #include <versekey.h>
 #include <stringmgr.h>
+#include <swmetrics.h>
 
 SWORD_NAMESPACE_START
 
@@ -85,18 +86,21 @@ SWBuf &RawText4::getRawEntryBuf() const {
 
 //	if (!isUnicode())
 		prepText(entryBuf);
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
 
 
 void RawText4::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 	VerseKey &key = getVerseKey();
 	doSetText(key.getTestament(), key.getTestamentIndex(), inbuf, len);
 }
 
 
 void RawText4::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 	VerseKey &destkey = getVerseKey();
 	const VerseKey *srckey = &getVerseKeyConst(inkey);
 	doLinkEntry(destkey.getTestament(), destkey.getTestamentIndex(), srckey->getTestamentIndex());
@@ -110,6 +114,7 @@ void RawText4::linkEntry(const SWKey *inkey) {
  */
 
 void RawText4::deleteEntry() {
+	EntryEdit edit(this);
 	VerseKey &key = getVerseKey();
 	doSetText(key.getTestament(), key.getTestamentIndex(), "");
 }
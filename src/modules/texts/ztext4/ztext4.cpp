@@ -29,6 +29,7 @@
 #include <filemgr.h>
 
 #include <ztext4.h>
+#include <swmetrics.h>
 
 SWORD_NAMESPACE_START
 
@@ -89,6 +90,7 @@ SWBuf &zText4::getRawEntryBuf() const {
 
 //	if (!isUnicode())
 		prepText(entryBuf);
+	SWMETRICS_ENTRY_READ(getName(), entryBuf.size());
 
 	return entryBuf;
 }
@@ -114,12 +116,13 @@ bool zText4::sameBlock(VerseKey *k1, VerseKey *k2) {
 
 
 void zText4::setEntry(const char *inbuf, long len) {
+	EntryEdit edit(this);
 	VerseKey &key = getVerseKey();
 
 	// see if we've jumped across blocks since last write
 	if (lastWriteKey) {
 		if (!sameBlock(lastWriteKey, &key)) {
-			flushCache();
+			flushCache(false);	// compressed and written out while we go on
 		}
 		delete lastWriteKey;
 	}
@@ -131,6 +134,7 @@ void zText4::setEntry(const char *inbuf, long len) {
 
 
 void zText4::linkEntry(const SWKey *inkey) {
+	EntryEdit edit(this);
 	VerseKey &destkey = getVerseKey();
 	const VerseKey *srckey = &getVerseKeyConst(inkey);
 	doLinkEntry(destkey.getTestament(), destkey.getTestamentIndex(), srckey->getTestamentIndex());
@@ -143,6 +147,7 @@ void zText4::linkEntry(const SWKey *inkey) {
  */
 
 void zText4::deleteEntry() {
+	EntryEdit edit(this);
 
 	VerseKey &key = getVerseKey();
 
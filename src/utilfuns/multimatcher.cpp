@@ -0,0 +1,254 @@
+/******************************************************************************
+ *
+ *  multimatcher.cpp -	MultiMatcher: finds several strings in a text in
+ *			one pass, optionally ignoring case
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <multimatcher.h>
+#include <utilstr.h>
+#include <string.h>
+
+SWORD_NAMESPACE_START
+
+namespace {
+	const SW_u32 NOSTATE = 0xFFFFFFFF;
+	const SW_u32 OUTPUT  = 0x80000000;
+
+	inline unsigned char asciiUpper(unsigned char c) {
+		return (c >= 'a' && c <= 'z') ? (unsigned char)(c - ('a' - 'A')) : c;
+	}
+}
+
+
+MultiMatcher::MultiMatcher(const std::vector<SWBuf> &patterns, bool icase) : patterns(patterns), patternCount((int)patterns.size()), emptyPatterns(0), icase(icase), generation(0), lastFoldPage(0), lastFoldEntries(0) {
+
+	for (int p = 0; p < patternCount; ++p) {
+		if (!patterns[p].length()) ++emptyPatterns;
+	}
+
+	// the C library's strstr is hard to beat for a single pattern when no
+	// case folding is needed
+	if (!icase && patternCount < 2) return;
+
+	// build the trie
+	std::vector<std::vector<int> > stateOutputs(1);
+	transitions.assign(256, NOSTATE);
+	SWBuf folded;
+	for (int p = 0; p < patternCount; ++p) {
+		if (icase) fold(patterns[p], folded);
+		else folded = patterns[p];
+		if (!folded.length()) continue;
+		SW_u32 state = 0;
+		for (const unsigned char *b = (const unsigned char *)folded.c_str(); *b; ++b) {
+			SW_u32 &next = transitions[(state << 8) | *b];
+			if (next == NOSTATE) {
+				next = (SW_u32)stateOutputs.size();
+				stateOutputs.push_back(std::vector<int>());
+				transitions.resize(transitions.size() + 256, NOSTATE);
+			}
+			state = transitions[(state << 8) | *b];
+		}
+		stateOutputs[state].push_back(p);
+	}
+
+	// add failure transitions breadth first, so each state's failure state
+	// is complete before we need it
+	std::vector<SW_u32> failure(stateOutputs.size(), 0);
+	std::vector<SW_u32> queue;
+	for (int b = 0; b < 256; ++b) {
+		SW_u32 &next = transitions[b];
+		if (next == NOSTATE) next = 0;
+		else queue.push_back(next);
+	}
+	for (unsigned int q = 0; q < queue.size(); ++q) {
+		SW_u32 state = queue[q];
+		const std::vector<int> &inherited = stateOutputs[failure[state]];
+		stateOutputs[state].insert(stateOutputs[state].end(), inherited.begin(), inherited.end());
+		for (int b = 0; b < 256; ++b) {
+			SW_u32 &next = transitions[(state << 8) | b];
+			SW_u32 fallback = transitions[(failure[state] << 8) | b];
+			if (next == NOSTATE) next = fallback;
+			else {
+				failure[next] = fallback;
+				queue.push_back(next);
+			}
+		}
+	}
+
+	outputStart.reserve(stateOutputs.size() + 1);
+	for (unsigned int s = 0; s < stateOutputs.size(); ++s) {
+		outputStart.push_back((int)outputs.size());
+		outputs.insert(outputs.end(), stateOutputs[s].begin(), stateOutputs[s].end());
+	}
+	outputStart.push_back((int)outputs.size());
+
+	// store each target as its row offset, flagged if the state recognizes
+	// a pattern, so a step is a single lookup
+	for (unsigned int t = 0; t < transitions.size(); ++t) {
+		SW_u32 target = transitions[t];
+		transitions[t] = (target << 8) | ((outputStart[target + 1] > outputStart[target]) ? OUTPUT : 0);
+	}
+
+	seen.assign(patternCount, 0);
+}
+
+
+const std::vector<SW_u32> &MultiMatcher::getFoldPage(SW_u32 page) {
+	if (lastFoldEntries && page == lastFoldPage) return *lastFoldEntries;
+
+	std::map<SW_u32, std::vector<SW_u32> >::iterator it = foldPages.find(page);
+	if (it == foldPages.end()) {
+		std::vector<SW_u32> &entries = foldPages[page];
+		entries.resize(256);
+		SWBuf ch;
+		for (SW_u32 i = 0; i < 256; ++i) {
+			SW_u32 codePoint = (page << 8) | i;
+			ch.setSize(0);
+			if (codePoint) getUTF8FromUniChar(codePoint, &ch);
+			if (ch.length()) ch.toUpper();
+			entries[i] = ((SW_u32)foldText.length() << 8) | (SW_u32)ch.length();
+			foldText.append(ch.c_str(), ch.length());
+		}
+		it = foldPages.find(page);
+	}
+	lastFoldPage = page;
+	lastFoldEntries = &it->second;
+	return it->second;
+}
+
+
+void MultiMatcher::fold(const char *text, SWBuf &folded) {
+	folded.setSize(0);
+	const unsigned char *from = (const unsigned char *)text;
+	while (*from) {
+		if (*from < 0x80) {
+			folded.append((char)asciiUpper(*from++));
+			continue;
+		}
+		SW_u32 ch = getUniCharFromUTF8(&from, true);
+		// if ch is bad, then convert to replacement char
+		if (!ch) ch = 0xFFFD;
+		SW_u32 entry = getFoldPage(ch >> 8)[ch & 0xff];
+		folded.append(foldText.c_str() + (entry >> 8), entry & 0xff);
+	}
+}
+
+
+bool MultiMatcher::recognize(SW_u32 state, int &found, int needed) {
+	SW_u32 s = state >> 8;
+	for (int o = outputStart[s]; o < outputStart[s + 1]; ++o) {
+		unsigned long &patternSeen = seen[outputs[o]];
+		if (patternSeen != generation) {
+			patternSeen = generation;
+			if (++found >= needed) return true;
+		}
+	}
+	return false;
+}
+
+
+bool MultiMatcher::run(const char *text, SW_u32 &state, int &found, int needed) {
+	const SW_u32 *table = &transitions[0];
+	const unsigned char *from = (const unsigned char *)text;
+	SW_u32 s = state;
+	bool done = false;
+
+	if (!icase) {
+		while (*from && !done) {
+			s = table[s | *from++];
+			if ((s & OUTPUT) && recognize(s &= ~OUTPUT, found, needed)) done = true;
+			s &= ~OUTPUT;
+		}
+		state = s;
+		return done;
+	}
+
+	while (*from && !done) {
+		if (*from < 0x80) {
+			s = table[s | asciiUpper(*from++)];
+			if ((s & OUTPUT) && recognize(s &= ~OUTPUT, found, needed)) done = true;
+			s &= ~OUTPUT;
+			continue;
+		}
+		SW_u32 ch = getUniCharFromUTF8(&from, true);
+		// if ch is bad, then convert to replacement char
+		if (!ch) ch = 0xFFFD;
+		SW_u32 entry = getFoldPage(ch >> 8)[ch & 0xff];
+		const unsigned char *upper = (const unsigned char *)foldText.c_str() + (entry >> 8);
+		for (SW_u32 i = 0; i < (entry & 0xff) && !done; ++i) {
+			s = table[s | upper[i]];
+			if ((s & OUTPUT) && recognize(s &= ~OUTPUT, found, needed)) done = true;
+			s &= ~OUTPUT;
+		}
+	}
+	state = s;
+	return done;
+}
+
+
+bool MultiMatcher::matchesAll(const char *text) {
+	if (transitions.empty()) {
+		for (int p = 0; p < patternCount; ++p) {
+			if (!strstr(text, patterns[p])) return false;
+		}
+		return true;
+	}
+	int needed = patternCount - emptyPatterns;
+	if (needed <= 0) return true;
+	++generation;
+	SW_u32 state = 0;
+	int found = 0;
+	return run(text, state, found, needed);
+}
+
+
+bool MultiMatcher::matchesAll(const char *text1, const char *text2) {
+	if (transitions.empty()) {
+		for (int p = 0; p < patternCount; ++p) {
+			if (!strstr(text1, patterns[p]) && !strstr(text2, patterns[p])) return false;
+		}
+		return true;
+	}
+	int needed = patternCount - emptyPatterns;
+	if (needed <= 0) return true;
+	++generation;
+	SW_u32 state = 0;
+	int found = 0;
+	return run(text1, state, found, needed) || run(" ", state, found, needed) || run(text2, state, found, needed);
+}
+
+
+bool MultiMatcher::matchesAny(const char *text) {
+	if (emptyPatterns) return true;
+	if (transitions.empty()) {
+		for (int p = 0; p < patternCount; ++p) {
+			if (strstr(text, patterns[p])) return true;
+		}
+		return false;
+	}
+	if (!patternCount) return false;
+	++generation;
+	SW_u32 state = 0;
+	int found = 0;
+	return run(text, state, found, 1);
+}
+
+
+SWORD_NAMESPACE_END
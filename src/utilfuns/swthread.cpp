@@ -0,0 +1,173 @@
+/******************************************************************************
+ *
+ *  swthread.cpp -	SWMutex and SWThread, over POSIX or Windows threads
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <swthread.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+SWORD_NAMESPACE_START
+
+
+namespace {
+
+	// what a new thread is to run; freed by the thread
+	struct ThreadStart {
+		SWThread::Function function;
+		void *userData;
+	};
+
+#ifdef WIN32
+	DWORD WINAPI startThread(LPVOID arg) {
+#else
+	void *startThread(void *arg) {
+#endif
+		ThreadStart start = *(ThreadStart *)arg;
+		delete (ThreadStart *)arg;
+		start.function(start.userData);
+		return 0;
+	}
+}
+
+
+SWMutex::SWMutex() {
+#ifdef WIN32
+	CRITICAL_SECTION *section = new CRITICAL_SECTION;
+	InitializeCriticalSection(section);
+	handle = section;
+#else
+	pthread_mutex_t *mutex = new pthread_mutex_t;
+	pthread_mutex_init(mutex, 0);
+	handle = mutex;
+#endif
+}
+
+
+SWMutex::~SWMutex() {
+#ifdef WIN32
+	DeleteCriticalSection((CRITICAL_SECTION *)handle);
+	delete (CRITICAL_SECTION *)handle;
+#else
+	pthread_mutex_destroy((pthread_mutex_t *)handle);
+	delete (pthread_mutex_t *)handle;
+#endif
+}
+
+
+void SWMutex::lock() {
+#ifdef WIN32
+	EnterCriticalSection((CRITICAL_SECTION *)handle);
+#else
+	pthread_mutex_lock((pthread_mutex_t *)handle);
+#endif
+}
+
+
+void SWMutex::unlock() {
+#ifdef WIN32
+	LeaveCriticalSection((CRITICAL_SECTION *)handle);
+#else
+	pthread_mutex_unlock((pthread_mutex_t *)handle);
+#endif
+}
+
+
+SWThread::SWThread() : handle(0) {
+}
+
+
+SWThread::~SWThread() {
+	join();
+}
+
+
+bool SWThread::start(Function function, void *userData) {
+	if (handle) return false;
+
+	ThreadStart *start = new ThreadStart;
+	start->function = function;
+	start->userData = userData;
+#ifdef WIN32
+	HANDLE thread = CreateThread(0, 0, startThread, start, 0, 0);
+	if (!thread) {
+		delete start;
+		return false;
+	}
+	handle = thread;
+#else
+	pthread_t *thread = new pthread_t;
+	if (pthread_create(thread, 0, startThread, start)) {
+		delete thread;
+		delete start;
+		return false;
+	}
+	handle = thread;
+#endif
+	return true;
+}
+
+
+void SWThread::join() {
+	if (!handle) return;
+#ifdef WIN32
+	WaitForSingleObject((HANDLE)handle, INFINITE);
+	CloseHandle((HANDLE)handle);
+#else
+	pthread_join(*(pthread_t *)handle, 0);
+	delete (pthread_t *)handle;
+#endif
+	handle = 0;
+}
+
+
+int SWThread::getProcessorCount() {
+#ifdef WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int count = (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	int count = 1;
+#endif
+	return (count > 0) ? count : 1;
+}
+
+
+void SWThread::sleep(unsigned long millis) {
+#ifdef WIN32
+	Sleep((DWORD)millis);
+#else
+	struct timespec wait;
+	wait.tv_sec = (time_t)(millis / 1000);
+	wait.tv_nsec = (long)(millis % 1000) * 1000000;
+	nanosleep(&wait, 0);
+#endif
+}
+
+
+SWORD_NAMESPACE_END
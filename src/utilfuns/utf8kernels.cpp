@@ -0,0 +1,609 @@
+/******************************************************************************
+ *
+ *  utf8kernels.cpp -	the loops under utilstr's UTF-8 functions: ASCII
+ *			scanning, validation and widening/narrowing, in SSE4.1,
+ *			AVX2 and NEON, picked at run time, and plain C++
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <utilstr.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SWUTF8_X86
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define SWUTF8_NEON
+#include <arm_neon.h>
+#endif
+
+
+SWORD_NAMESPACE_START
+
+
+namespace {
+
+struct UTF8Kernels {
+	const char *name;
+	unsigned long (*asciiLength)(const unsigned char *buf, unsigned long len);
+	bool (*validate)(const unsigned char *buf, unsigned long len);
+	unsigned long (*widen16)(const unsigned char *buf, unsigned long len, SW_u16 *to);
+	unsigned long (*widen32)(const unsigned char *buf, unsigned long len, SW_u32 *to);
+	unsigned long (*narrow16)(const SW_u16 *buf, unsigned long len, unsigned char *to);
+	unsigned long (*narrow32)(const SW_u32 *buf, unsigned long len, unsigned char *to);
+};
+
+
+/******************************************************************************
+ * plain C++, for any other CPU, and for what's left over past the last full
+ * vector in the others
+ */
+
+unsigned long asciiLengthScalar(const unsigned char *buf, unsigned long len) {
+	unsigned long i = 0;
+	while (i < len && buf[i] < 0x80) i++;
+	return i;
+}
+
+
+// accepts just what getUniCharFromUTF8() does; note that includes the
+// surrogates, 0xD800-0xDFFF
+bool validateScalar(const unsigned char *buf, unsigned long len) {
+	const unsigned char *end = buf + len;
+	while (buf < end) {
+		unsigned char c = *buf;
+		if (c < 0x80) {
+			buf++;
+			continue;
+		}
+		int subsequent;
+		SW_u32 ch, least;
+		if (c < 0xC2) return false;	// a continuation, or an overlong 2 byte lead
+		else if (c < 0xE0) { subsequent = 1; ch = c & 0x1F; least = 0x80; }
+		else if (c < 0xF0) { subsequent = 2; ch = c & 0x0F; least = 0x800; }
+		else if (c < 0xF5) { subsequent = 3; ch = c & 0x07; least = 0x10000; }
+		else return false;
+		if (end - buf <= subsequent) return false;
+		for (int i = 1; i <= subsequent; i++) {
+			if ((buf[i] & 0xC0) != 0x80) return false;
+			ch = (ch << 6) | (buf[i] & 0x3F);
+		}
+		if (ch < least || ch > 0x10FFFF) return false;
+		buf += subsequent + 1;
+	}
+	return true;
+}
+
+
+template <class Wide>
+unsigned long widenScalar(const unsigned char *buf, unsigned long len, Wide *to) {
+	unsigned long i = 0;
+	for (; i < len && buf[i] < 0x80; i++) to[i] = buf[i];
+	return i;
+}
+
+
+template <class Wide>
+unsigned long narrowScalar(const Wide *buf, unsigned long len, unsigned char *to) {
+	unsigned long i = 0;
+	for (; i < len && buf[i] < 0x80; i++) to[i] = (unsigned char)buf[i];
+	return i;
+}
+
+
+const UTF8Kernels scalarKernels = {
+	"scalar",
+	asciiLengthScalar,
+	validateScalar,
+	widenScalar<SW_u16>,
+	widenScalar<SW_u32>,
+	narrowScalar<SW_u16>,
+	narrowScalar<SW_u32>
+};
+
+
+#if defined(SWUTF8_X86) || defined(SWUTF8_NEON)
+
+/******************************************************************************
+ * Validation classifies each byte by the high nibble of the byte before it,
+ * the low nibble of the byte before it, and its own high nibble, looking
+ * each up in a 16 entry table of the errors that nibble allows; a byte is
+ * in error when all three lookups share one.  Whether a byte must be a 2nd
+ * or 3rd continuation is found from the lead bytes 2 and 3 back.  See
+ * Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per
+ * Byte" (2021).  Surrogates are left out, as getUniCharFromUTF8() allows
+ * them.
+ */
+
+const unsigned char TOO_SHORT      = 1 << 0;	// lead, then not a continuation
+const unsigned char TOO_LONG       = 1 << 1;	// ASCII, then a continuation
+const unsigned char OVERLONG_3     = 1 << 2;	// E0, then 80-9F
+const unsigned char TOO_LARGE      = 1 << 3;	// F4, then 90-BF; or F5-FF
+const unsigned char OVERLONG_2     = 1 << 5;	// C0 or C1
+const unsigned char TOO_LARGE_1000 = 1 << 6;	// F5-FF, then 80-8F
+const unsigned char OVERLONG_4     = 1 << 6;	// F0, then 80-8F
+const unsigned char TWO_CONTS      = 1 << 7;	// continuation, then continuation
+const unsigned char CARRY          = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+const unsigned char byte1High[16] = {
+	TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+	TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+	TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+	TOO_SHORT | OVERLONG_2,
+	TOO_SHORT,
+	TOO_SHORT | OVERLONG_3,
+	TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+};
+
+const unsigned char byte1Low[16] = {
+	CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+	CARRY | OVERLONG_2,
+	CARRY,
+	CARRY,
+	CARRY | TOO_LARGE,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000
+};
+
+const unsigned char byte2High[16] = {
+	TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+	TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+	TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+	TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+	TOO_LONG | OVERLONG_2 | TWO_CONTS | TOO_LARGE,
+	TOO_LONG | OVERLONG_2 | TWO_CONTS | TOO_LARGE,
+	TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+};
+
+// what the last 3 bytes of a block may be and not need the next block:
+// no lead at all in the last, no 3 or 4 byte lead before it, ...
+const unsigned char blockEndMax[32] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+};
+
+#endif
+
+
+#ifdef SWUTF8_X86
+
+/******************************************************************************
+ * SSE4.1, 16 bytes at a time
+ */
+
+__attribute__((target("sse4.1")))
+unsigned long asciiLengthSSE(const unsigned char *buf, unsigned long len) {
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		int high = _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(buf + i)));
+		if (high) return i + __builtin_ctz(high);
+	}
+	return i + asciiLengthScalar(buf + i, len - i);
+}
+
+
+__attribute__((target("sse4.1")))
+inline __m128i checkBlockSSE(__m128i in, __m128i prev) {
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	__m128i prev1 = _mm_alignr_epi8(in, prev, 15);
+	__m128i prev2 = _mm_alignr_epi8(in, prev, 14);
+	__m128i prev3 = _mm_alignr_epi8(in, prev, 13);
+
+	__m128i special = _mm_and_si128(
+		_mm_and_si128(
+			_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)byte1High), _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+			_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)byte1Low), _mm_and_si128(prev1, nibble))),
+		_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)byte2High), _mm_and_si128(_mm_srli_epi16(in, 4), nibble)));
+
+	__m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+	__m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+	__m128i mustContinue = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8((char)0x80));
+
+	return _mm_xor_si128(mustContinue, special);
+}
+
+
+__attribute__((target("sse4.1")))
+bool validateSSE(const unsigned char *buf, unsigned long len) {
+	const __m128i endMax = _mm_loadu_si128((const __m128i *)(blockEndMax + 16));
+	__m128i prev = _mm_setzero_si128();
+	__m128i error = _mm_setzero_si128();
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		__m128i in = _mm_loadu_si128((const __m128i *)(buf + i));
+		if (!_mm_movemask_epi8(in)) {
+			// all ASCII: just make sure the last block didn't leave a sequence open
+			error = _mm_or_si128(error, _mm_subs_epu8(prev, endMax));
+		}
+		else error = _mm_or_si128(error, checkBlockSSE(in, prev));
+		prev = in;
+	}
+	// what's left, padded with NULs, which close off any sequence still open
+	unsigned char last[16];
+	memset(last, 0, sizeof(last));
+	memcpy(last, buf + i, len - i);
+	error = _mm_or_si128(error, checkBlockSSE(_mm_loadu_si128((const __m128i *)last), prev));
+
+	return _mm_testz_si128(error, error);
+}
+
+
+__attribute__((target("sse4.1")))
+unsigned long widen16SSE(const unsigned char *buf, unsigned long len, SW_u16 *to) {
+	const __m128i zero = _mm_setzero_si128();
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		__m128i in = _mm_loadu_si128((const __m128i *)(buf + i));
+		if (_mm_movemask_epi8(in)) break;
+		_mm_storeu_si128((__m128i *)(to + i), _mm_unpacklo_epi8(in, zero));
+		_mm_storeu_si128((__m128i *)(to + i + 8), _mm_unpackhi_epi8(in, zero));
+	}
+	return i + widenScalar(buf + i, len - i, to + i);
+}
+
+
+__attribute__((target("sse4.1")))
+unsigned long widen32SSE(const unsigned char *buf, unsigned long len, SW_u32 *to) {
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		__m128i in = _mm_loadu_si128((const __m128i *)(buf + i));
+		if (_mm_movemask_epi8(in)) break;
+		_mm_storeu_si128((__m128i *)(to + i), _mm_cvtepu8_epi32(in));
+		_mm_storeu_si128((__m128i *)(to + i + 4), _mm_cvtepu8_epi32(_mm_srli_si128(in, 4)));
+		_mm_storeu_si128((__m128i *)(to + i + 8), _mm_cvtepu8_epi32(_mm_srli_si128(in, 8)));
+		_mm_storeu_si128((__m128i *)(to + i + 12), _mm_cvtepu8_epi32(_mm_srli_si128(in, 12)));
+	}
+	return i + widenScalar(buf + i, len - i, to + i);
+}
+
+
+__attribute__((target("sse4.1")))
+unsigned long narrow16SSE(const SW_u16 *buf, unsigned long len, unsigned char *to) {
+	const __m128i high = _mm_set1_epi16((short)0xFF80);
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(buf + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(buf + i + 8));
+		if (!_mm_testz_si128(_mm_or_si128(a, b), high)) break;
+		_mm_storeu_si128((__m128i *)(to + i), _mm_packus_epi16(a, b));
+	}
+	return i + narrowScalar(buf + i, len - i, to + i);
+}
+
+
+__attribute__((target("sse4.1")))
+unsigned long narrow32SSE(const SW_u32 *buf, unsigned long len, unsigned char *to) {
+	const __m128i high = _mm_set1_epi32((int)0xFFFFFF80);
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(buf + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(buf + i + 4));
+		__m128i c = _mm_loadu_si128((const __m128i *)(buf + i + 8));
+		__m128i d = _mm_loadu_si128((const __m128i *)(buf + i + 12));
+		if (!_mm_testz_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), high)) break;
+		_mm_storeu_si128((__m128i *)(to + i), _mm_packus_epi16(_mm_packus_epi32(a, b), _mm_packus_epi32(c, d)));
+	}
+	return i + narrowScalar(buf + i, len - i, to + i);
+}
+
+
+const UTF8Kernels sseKernels = {
+	"sse4.1",
+	asciiLengthSSE,
+	validateSSE,
+	widen16SSE,
+	widen32SSE,
+	narrow16SSE,
+	narrow32SSE
+};
+
+
+/******************************************************************************
+ * AVX2, 32 bytes at a time, for scanning and validation; widening and
+ * narrowing are bound by the stores, so they're left to SSE
+ */
+
+__attribute__((target("avx2")))
+unsigned long asciiLengthAVX2(const unsigned char *buf, unsigned long len) {
+	unsigned long i = 0;
+	for (; i + 32 <= len; i += 32) {
+		unsigned int high = (unsigned int)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)(buf + i)));
+		if (high) return i + __builtin_ctz(high);
+	}
+	return i + asciiLengthScalar(buf + i, len - i);
+}
+
+
+__attribute__((target("avx2")))
+inline __m256i checkBlockAVX2(__m256i in, __m256i prev) {
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	// the upper half of prev and the lower half of in, to shift in from
+	__m256i carried = _mm256_permute2x128_si256(prev, in, 0x21);
+	__m256i prev1 = _mm256_alignr_epi8(in, carried, 15);
+	__m256i prev2 = _mm256_alignr_epi8(in, carried, 14);
+	__m256i prev3 = _mm256_alignr_epi8(in, carried, 13);
+
+	__m256i special = _mm256_and_si256(
+		_mm256_and_si256(
+			_mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)byte1High)), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+			_mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)byte1Low)), _mm256_and_si256(prev1, nibble))),
+		_mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)byte2High)), _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble)));
+
+	__m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80)));
+	__m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80)));
+	__m256i mustContinue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char)0x80));
+
+	return _mm256_xor_si256(mustContinue, special);
+}
+
+
+__attribute__((target("avx2")))
+bool validateAVX2(const unsigned char *buf, unsigned long len) {
+	const __m256i endMax = _mm256_loadu_si256((const __m256i *)blockEndMax);
+	__m256i prev = _mm256_setzero_si256();
+	__m256i error = _mm256_setzero_si256();
+	unsigned long i = 0;
+	for (; i + 32 <= len; i += 32) {
+		__m256i in = _mm256_loadu_si256((const __m256i *)(buf + i));
+		if (!_mm256_movemask_epi8(in)) {
+			error = _mm256_or_si256(error, _mm256_subs_epu8(prev, endMax));
+		}
+		else error = _mm256_or_si256(error, checkBlockAVX2(in, prev));
+		prev = in;
+	}
+	unsigned char last[32];
+	memset(last, 0, sizeof(last));
+	memcpy(last, buf + i, len - i);
+	error = _mm256_or_si256(error, checkBlockAVX2(_mm256_loadu_si256((const __m256i *)last), prev));
+
+	return _mm256_testz_si256(error, error);
+}
+
+
+const UTF8Kernels avx2Kernels = {
+	"avx2",
+	asciiLengthAVX2,
+	validateAVX2,
+	widen16SSE,
+	widen32SSE,
+	narrow16SSE,
+	narrow32SSE
+};
+
+#endif // SWUTF8_X86
+
+
+#ifdef SWUTF8_NEON
+
+/******************************************************************************
+ * NEON, 16 bytes at a time
+ */
+
+unsigned long asciiLengthNEON(const unsigned char *buf, unsigned long len) {
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		if (vmaxvq_u8(vld1q_u8(buf + i)) >= 0x80) break;
+	}
+	return i + asciiLengthScalar(buf + i, len - i);
+}
+
+
+inline uint8x16_t checkBlockNEON(uint8x16_t in, uint8x16_t prev) {
+	const uint8x16_t nibble = vdupq_n_u8(0x0F);
+	uint8x16_t prev1 = vextq_u8(prev, in, 15);
+	uint8x16_t prev2 = vextq_u8(prev, in, 14);
+	uint8x16_t prev3 = vextq_u8(prev, in, 13);
+
+	uint8x16_t special = vandq_u8(
+		vandq_u8(
+			vqtbl1q_u8(vld1q_u8(byte1High), vshrq_n_u8(prev1, 4)),
+			vqtbl1q_u8(vld1q_u8(byte1Low), vandq_u8(prev1, nibble))),
+		vqtbl1q_u8(vld1q_u8(byte2High), vshrq_n_u8(in, 4)));
+
+	uint8x16_t third = vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80));
+	uint8x16_t fourth = vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80));
+	uint8x16_t mustContinue = vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80));
+
+	return veorq_u8(mustContinue, special);
+}
+
+
+bool validateNEON(const unsigned char *buf, unsigned long len) {
+	const uint8x16_t endMax = vld1q_u8(blockEndMax + 16);
+	uint8x16_t prev = vdupq_n_u8(0);
+	uint8x16_t error = vdupq_n_u8(0);
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		uint8x16_t in = vld1q_u8(buf + i);
+		if (vmaxvq_u8(in) < 0x80) {
+			error = vorrq_u8(error, vqsubq_u8(prev, endMax));
+		}
+		else error = vorrq_u8(error, checkBlockNEON(in, prev));
+		prev = in;
+	}
+	unsigned char last[16];
+	memset(last, 0, sizeof(last));
+	memcpy(last, buf + i, len - i);
+	error = vorrq_u8(error, checkBlockNEON(vld1q_u8(last), prev));
+
+	return !vmaxvq_u8(error);
+}
+
+
+unsigned long widen16NEON(const unsigned char *buf, unsigned long len, SW_u16 *to) {
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		uint8x16_t in = vld1q_u8(buf + i);
+		if (vmaxvq_u8(in) >= 0x80) break;
+		vst1q_u16(to + i, vmovl_u8(vget_low_u8(in)));
+		vst1q_u16(to + i + 8, vmovl_high_u8(in));
+	}
+	return i + widenScalar(buf + i, len - i, to + i);
+}
+
+
+unsigned long widen32NEON(const unsigned char *buf, unsigned long len, SW_u32 *to) {
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		uint8x16_t in = vld1q_u8(buf + i);
+		if (vmaxvq_u8(in) >= 0x80) break;
+		uint16x8_t low = vmovl_u8(vget_low_u8(in));
+		uint16x8_t high = vmovl_high_u8(in);
+		vst1q_u32(to + i, vmovl_u16(vget_low_u16(low)));
+		vst1q_u32(to + i + 4, vmovl_high_u16(low));
+		vst1q_u32(to + i + 8, vmovl_u16(vget_low_u16(high)));
+		vst1q_u32(to + i + 12, vmovl_high_u16(high));
+	}
+	return i + widenScalar(buf + i, len - i, to + i);
+}
+
+
+unsigned long narrow16NEON(const SW_u16 *buf, unsigned long len, unsigned char *to) {
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		uint16x8_t a = vld1q_u16(buf + i);
+		uint16x8_t b = vld1q_u16(buf + i + 8);
+		if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) break;
+		vst1q_u8(to + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+	}
+	return i + narrowScalar(buf + i, len - i, to + i);
+}
+
+
+unsigned long narrow32NEON(const SW_u32 *buf, unsigned long len, unsigned char *to) {
+	unsigned long i = 0;
+	for (; i + 16 <= len; i += 16) {
+		uint32x4_t a = vld1q_u32(buf + i);
+		uint32x4_t b = vld1q_u32(buf + i + 4);
+		uint32x4_t c = vld1q_u32(buf + i + 8);
+		uint32x4_t d = vld1q_u32(buf + i + 12);
+		if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80) break;
+		uint16x8_t low = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+		uint16x8_t high = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+		vst1q_u8(to + i, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+	}
+	return i + narrowScalar(buf + i, len - i, to + i);
+}
+
+
+const UTF8Kernels neonKernels = {
+	"neon",
+	asciiLengthNEON,
+	validateNEON,
+	widen16NEON,
+	widen32NEON,
+	narrow16NEON,
+	narrow32NEON
+};
+
+#endif // SWUTF8_NEON
+
+
+// the best first
+const UTF8Kernels *getSupportedKernels(int i) {
+	const UTF8Kernels *supported[4];
+	int count = 0;
+#ifdef SWUTF8_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) supported[count++] = &avx2Kernels;
+	if (__builtin_cpu_supports("sse4.1")) supported[count++] = &sseKernels;
+#endif
+#ifdef SWUTF8_NEON
+	supported[count++] = &neonKernels;
+#endif
+	supported[count++] = &scalarKernels;
+	return (i < count) ? supported[i] : 0;
+}
+
+
+const UTF8Kernels *kernels = 0;
+
+inline const UTF8Kernels *getKernels() {
+	if (!kernels) kernels = getSupportedKernels(0);
+	return kernels;
+}
+
+// pick them as the library loads, rather than racing to on first use
+const UTF8Kernels *pickedAtLoad = getKernels();
+
+}
+
+
+const char *getUTF8Kernels() {
+	return getKernels()->name;
+}
+
+
+bool setUTF8Kernels(const char *name) {
+	if (!name) {
+		kernels = getSupportedKernels(0);
+		return true;
+	}
+	for (int i = 0; getSupportedKernels(i); i++) {
+		if (!strcmp(getSupportedKernels(i)->name, name)) {
+			kernels = getSupportedKernels(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+
+unsigned long getASCIILength(const char *buf, unsigned long len) {
+	return getKernels()->asciiLength((const unsigned char *)buf, len);
+}
+
+
+bool isValidUTF8(const char *buf, unsigned long len) {
+	return getKernels()->validate((const unsigned char *)buf, len);
+}
+
+
+unsigned long widenASCII(const char *buf, unsigned long len, SW_u16 *to) {
+	return getKernels()->widen16((const unsigned char *)buf, len, to);
+}
+
+
+unsigned long widenASCII(const char *buf, unsigned long len, SW_u32 *to) {
+	return getKernels()->widen32((const unsigned char *)buf, len, to);
+}
+
+
+unsigned long narrowASCII(const SW_u16 *buf, unsigned long len, char *to) {
+	return getKernels()->narrow16(buf, len, (unsigned char *)to);
+}
+
+
+unsigned long narrowASCII(const SW_u32 *buf, unsigned long len, char *to) {
+	return getKernels()->narrow32(buf, len, (unsigned char *)to);
+}
+
+
+SWORD_NAMESPACE_END
@@ -23,6 +23,7 @@
 #include <utilstr.h>
 #include <ctype.h>
 #include <string.h>
+#include <wchar.h>
 
 #include <sysdata.h>
 #include <swlog.h>
@@ -206,16 +207,26 @@ int stricmp(const char *s1, const char *s2) {
 
 SWBuf assureValidUTF8(const char *buf) {
 
-	SWBuf myCopy = buf;
+	SWBuf fixed;
+	if (assureValidUTF8(buf, fixed) == buf) fixed = buf;
+	return fixed;
+}
+
+
+const char *assureValidUTF8(const char *buf, SWBuf &fixed) {
+
+	if (!buf) return "";
+	if (isValidUTF8(buf, strlen(buf))) return buf;
+
+	SWBuf &myCopy = fixed;
+	myCopy = buf;
 	const unsigned char *b = (const unsigned char *)myCopy.c_str();
 	const unsigned char *q = 0;
-	bool invalidChar = false;
 	while (*b) {
 		q = b;
 		if (!getUniCharFromUTF8(&b)) {
 			long len = b - q;
 			if (len) {
-				invalidChar = true;
 				for (long start = q - (const unsigned char *)myCopy.c_str(); len; len--) {
 					myCopy[start+len-1] = 0x1a;	// unicode replacement character
 				}
@@ -223,10 +234,8 @@ SWBuf assureValidUTF8(const char *buf) {
 			}
 		}
 	}
-	if (invalidChar) {
-//		SWLog::getSystemLog()->logWarning("Changing invalid UTF-8 string (%s) to (%s)\n", buf, myCopy.c_str());
-	}
-	return myCopy;
+//	SWLog::getSystemLog()->logWarning("Changing invalid UTF-8 string (%s) to (%s)\n", buf, myCopy.c_str());
+	return myCopy.c_str();
 }
 
 
@@ -239,19 +248,32 @@ SWBuf assureValidUTF8(const char *buf) {
 SWBuf utf8ToWChar(const char *buf) {
 
 	const char *q = 0;
+	const char *end = buf + strlen(buf);
 	SWBuf wcharBuf;
-	while (*buf) {
+	// no more wchar_ts than bytes, and one for the terminator
+	wcharBuf.setSize((end - buf + 1) * sizeof(wchar_t));
+	wchar_t *to = (wchar_t *)wcharBuf.getRawData();
+	while (buf < end) {
+		unsigned long ascii = (sizeof(wchar_t) == 2)
+				? widenASCII(buf, end - buf, (SW_u16 *)to)
+				: widenASCII(buf, end - buf, (SW_u32 *)to);
+		buf += ascii;
+		to += ascii;
+		if (buf >= end) break;
+
 		q = buf;
 		wchar_t wc = getUniCharFromUTF8((const unsigned char **)&buf);
 		if (!wc) {
 			// if my buffer was advanced but nothing was converted, I had invalid data
 			if (buf - q) {
 				// invalid bytes in UTF8 stream
-				wcharBuf.append((wchar_t)0x1a);		// unicode replacement character
+				*to++ = (wchar_t)0x1a;		// unicode replacement character
 			}
 		}
-		else wcharBuf.append(wc);
+		else *to++ = wc;
 	}
+	*to = 0;
+	wcharBuf.setSize((char *)to - wcharBuf.getRawData());
 	return wcharBuf;
 }
 
@@ -264,9 +286,28 @@ SWBuf wcharToUTF8(const wchar_t *buf) {
 
 	SWBuf utf8Buf;
 	if (buf) {
-		while (*buf) {
-			getUTF8FromUniChar(*buf++, &utf8Buf);
+		unsigned long len = wcslen(buf);
+		// room for it all, were it all 4 byte sequences; grown just once,
+		// as setSize clears what it grows by
+		utf8Buf.setSize(len * 4);
+		char *out = utf8Buf.getRawData();
+		SWBuf one;
+		while (len) {
+			unsigned long ascii = (sizeof(wchar_t) == 2)
+					? narrowASCII((const SW_u16 *)buf, len, out)
+					: narrowASCII((const SW_u32 *)buf, len, out);
+			buf += ascii;
+			len -= ascii;
+			out += ascii;
+			if (len) {
+				one.setSize(0);
+				getUTF8FromUniChar(*buf++, &one);
+				memcpy(out, one.c_str(), one.size());
+				out += one.size();
+				len--;
+			}
 		}
+		utf8Buf.setSize(out - utf8Buf.getRawData());
 	}
 	return utf8Buf;
 }
@@ -0,0 +1,163 @@
+/******************************************************************************
+ *
+ *  xmltokenlist.cpp -	XMLTokenList: markup split once into tags and text,
+ *			to be edited by several filters in turn
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <xmltokenlist.h>
+#include <string.h>
+
+SWORD_NAMESPACE_START
+
+
+XMLTokenList::XMLTokenList(const char *text) : editCount(0) {
+	if (text) setText(text);
+}
+
+
+XMLTokenList::~XMLTokenList() {
+	for (unsigned int i = 0; i < edits.size(); ++i) {
+		delete edits[i];
+	}
+}
+
+
+void XMLTokenList::setText(const char *text) {
+	source = text;
+	tokens.clear();
+	editCount = 0;
+
+	// each token ends where the next '<' or '>' is; NUL terminate it there
+	char *buf = source.getRawData();
+	unsigned long len = source.length();
+	unsigned long start = 0;
+	bool inTag = false;
+	Token t;
+	t.edit = -1;
+	for (unsigned long i = 0; i < len; ++i) {
+		if (buf[i] == '<') {
+			// like the filters, forget a tag left open when a new one starts
+			if (!inTag && i > start) {
+				t.offset = start;
+				t.length = i - start;
+				t.isTag = false;
+				tokens.push_back(t);
+			}
+			buf[i] = 0;
+			start = i + 1;
+			inTag = true;
+		}
+		else if (buf[i] == '>' && inTag) {
+			t.offset = start;
+			t.length = i - start;
+			t.isTag = true;
+			tokens.push_back(t);
+			buf[i] = 0;
+			start = i + 1;
+			inTag = false;
+		}
+	}
+	// a tag still open at the end is dropped, as the filters drop it
+	if (!inTag && len > start) {
+		t.offset = start;
+		t.length = len - start;
+		t.isTag = false;
+		tokens.push_back(t);
+	}
+}
+
+
+void XMLTokenList::getText(SWBuf &text, int start, int end) {
+	if (end < 0 || end > (int)tokens.size()) end = (int)tokens.size();
+	text.setSize(0);
+	for (int i = start; i < end; ++i) {
+		const char *tokenText = getTokenText(i);
+		unsigned long length = (tokens[i].edit < 0 || !edits[tokens[i].edit]->hasText) ? tokens[i].length : edits[tokens[i].edit]->text.length();
+		if (tokens[i].isTag) {
+			text.append('<');
+			text.append(tokenText, length);
+			text.append('>');
+		}
+		else text.append(tokenText, length);
+	}
+}
+
+
+XMLTokenList::Edit &XMLTokenList::getEdit(int i) {
+	if (tokens[i].edit < 0) {
+		if (editCount == (int)edits.size()) edits.push_back(new Edit());
+		Edit &edit = *edits[editCount];
+		edit.hasText = false;
+		edit.tagValid = false;
+		edit.tagDirty = false;
+		tokens[i].edit = editCount++;
+	}
+	return *edits[tokens[i].edit];
+}
+
+
+const char *XMLTokenList::getTokenText(int i) {
+	if (tokens[i].edit < 0) return source.c_str() + tokens[i].offset;
+
+	Edit &edit = *edits[tokens[i].edit];
+	if (edit.tagDirty) {
+		edit.text = edit.tag.toString();
+		edit.text.trim();
+		// drop <>
+		edit.text << 1;
+		edit.text--;
+		edit.hasText = true;
+		edit.tagDirty = false;
+	}
+	return (edit.hasText) ? edit.text.c_str() : source.c_str() + tokens[i].offset;
+}
+
+
+bool XMLTokenList::startsWith(int i, const char *prefix) {
+	return !strncmp(getTokenText(i), prefix, strlen(prefix));
+}
+
+
+void XMLTokenList::setTokenText(int i, const char *text) {
+	Edit &edit = getEdit(i);
+	edit.text = text;
+	edit.hasText = true;
+	edit.tagValid = false;
+	edit.tagDirty = false;
+}
+
+
+XMLTag &XMLTokenList::getTag(int i) {
+	Edit &edit = getEdit(i);
+	if (!edit.tagValid) {
+		edit.tag.setText(getTokenText(i));
+		edit.tagValid = true;
+	}
+	return edit.tag;
+}
+
+
+void XMLTokenList::tagChanged(int i) {
+	Edit &edit = getEdit(i);
+	if (edit.tagValid) edit.tagDirty = true;
+}
+
+
+SWORD_NAMESPACE_END
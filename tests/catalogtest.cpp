@@ -0,0 +1,183 @@
+/******************************************************************************
+ *
+ *  catalogtest.cpp -	refreshes a remote source from a stand-in repository,
+ *			first without a catalog, then by its catalog as .conf
+ *			files change, and checks the module status the catalog
+ *			gives against the one an SWMgr of the source gives
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdio.h>
+#include <string.h>
+
+#include <installmgr.h>
+#include <modcatalog.h>
+#include <filemgr.h>
+#include <swmgr.h>
+#include <swmodule.h>
+#include <swbuf.h>
+
+#include "standinserver.h"
+
+using namespace sword;
+using namespace std;
+
+
+// the .conf files of the repository which were fetched
+SWBuf confsFetched(StandInServer &server) {
+	set<SWBuf> names;
+	for (unsigned int i = 0; i < server.requests.size(); i++) {
+		if (server.requests[i].startsWith("/repo/mods.d/") && server.requests[i].endsWith(".conf")) {
+			names.insert(server.requests[i].c_str() + 13);
+		}
+	}
+	SWBuf list;
+	for (set<SWBuf>::const_iterator it = names.begin(); it != names.end(); ++it) {
+		if (list.length()) list += " ";
+		list += *it;
+	}
+	return list.length() ? list : SWBuf("none");
+}
+
+
+bool fetched(StandInServer &server, const char *path) {
+	return find(server.requests.begin(), server.requests.end(), SWBuf(path)) != server.requests.end();
+}
+
+
+const char *statusText(int status) {
+	static SWBuf text;
+	text = (status & InstallMgr::MODSTAT_NEW) ? "new" : (status & InstallMgr::MODSTAT_UPDATED) ? "updated" : (status & InstallMgr::MODSTAT_OLDER) ? "older" : "same version";
+	if (status & InstallMgr::MODSTAT_CIPHERED) text += ", ciphered";
+	if (status & InstallMgr::MODSTAT_CIPHERKEYPRESENT) text += ", key present";
+	return text;
+}
+
+
+// the status of each module by the catalog, and whether an SWMgr agrees
+void report(StandInServer &server, InstallSource &is, const SWBuf &tmp, int retVal) {
+	cout << "  returned " << retVal << "\n";
+	cout << "  .conf files fetched: " << confsFetched(server) << "\n";
+
+	SWMgr installed(tmp + "/installed");
+	const ModuleCatalog *catalog = is.getCatalog();
+	bool same = true;
+	for (int util = 0; util < 2; util++) {
+		map<SWBuf, int> byCatalog = InstallMgr::getModuleStatus(installed, *catalog, util);
+		map<SWModule *, int> byMgr = InstallMgr::getModuleStatus(installed, *is.getMgr(), util);
+		for (map<SWBuf, int>::const_iterator it = byCatalog.begin(); it != byCatalog.end(); ++it) {
+			const ModuleCatalog::Entry *entry = catalog->getEntry(it->first);
+			cout << "  " << it->first << " " << entry->version << ": " << statusText(it->second);
+			if (entry->features.length()) cout << " (" << entry->features << ")";
+			cout << (util ? " [utility]" : "") << "\n";
+		}
+		if (byCatalog.size() != byMgr.size()) same = false;
+		for (map<SWModule *, int>::const_iterator it = byMgr.begin(); it != byMgr.end(); ++it) {
+			map<SWBuf, int>::const_iterator other = byCatalog.find(it->first->getName());
+			if (other == byCatalog.end() || other->second != it->second) same = false;
+		}
+	}
+	cout << "  same as by an SWMgr of the source: " << (same ? "yes" : "no") << "\n";
+}
+
+
+void writeConf(const SWBuf &path, const char *text) {
+	FileMgr::removeFile(path);
+	int fd = FileMgr::createPathAndFile(path);
+	FileMgr::write(fd, text, strlen(text));
+	FileMgr::closeFile(fd);
+}
+
+
+// what mkcatalog does, after a change to the repository
+void publish(StandInServer &server, const SWBuf &tmp) {
+	ModuleCatalog catalog;
+	catalog.build(tmp + "/repo/mods.d");
+	catalog.save(tmp + "/repo/" + ModuleCatalog::FILENAME);
+	server.files.clear();
+	server.addDirectory("/repo", tmp + "/repo");
+}
+
+
+int main(int argc, char **argv) {
+	SWBuf tmp = (argc > 1) ? argv[1] : "tmp/catalog";
+
+	StandInServer server;
+	server.addDirectory("/repo", tmp + "/repo");
+
+	SWBuf host;
+	host.setFormatted("127.0.0.1:%d", server.port);
+
+	InstallMgr installMgr(tmp + "/installmgr");
+	installMgr.setUserDisclaimerConfirmed(true);
+	InstallSource is("HTTP");
+	is.caption = "Stand-in";
+	is.source = host;
+	is.directory = "/repo";
+	is.uid = "standin";
+	is.localShadow = tmp + "/installmgr/standin";
+
+	cout << "a repository without a catalog:\n";
+	server.files.erase(SWBuf("/repo/") + ModuleCatalog::FILENAME);
+	int retVal = installMgr.refreshRemoteSource(&is);
+	report(server, is, tmp, retVal);
+	cout << "  fetched mods.d.tar.gz: " << (fetched(server, "/repo/mods.d.tar.gz") ? "yes" : "no") << "\n";
+
+	cout << "the repository's catalog, for the same .conf files:\n";
+	server.addDirectory("/repo", tmp + "/repo");
+	server.resetCounts();
+	retVal = installMgr.refreshRemoteSource(&is);
+	report(server, is, tmp, retVal);
+
+	cout << "one changed, one new, one gone:\n";
+	writeConf(tmp + "/repo/mods.d/web.conf", "[WEB]\nDataPath=./modules/texts/ztext/web/\nModDrv=zText\nLang=en\nVersion=1.2\n");
+	writeConf(tmp + "/repo/mods.d/new.conf", "[New]\nDataPath=./modules/texts/ztext/new/\nModDrv=zText\nLang=fr\nVersion=1.0\n");
+	FileMgr::removeFile(tmp + "/repo/mods.d/strongsgreek.conf");
+	publish(server, tmp);
+	server.resetCounts();
+	retVal = installMgr.refreshRemoteSource(&is);
+	report(server, is, tmp, retVal);
+	cout << "  strongsgreek.conf removed: " << (!FileMgr::existsFile(tmp + "/installmgr/standin/mods.d/strongsgreek.conf") ? "yes" : "no") << "\n";
+
+	cout << "a cached .conf file lost:\n";
+	FileMgr::removeFile(tmp + "/installmgr/standin/mods.d/kjv.conf");
+	server.resetCounts();
+	retVal = installMgr.refreshRemoteSource(&is);
+	report(server, is, tmp, retVal);
+
+	cout << "a .conf file which doesn't match the catalog:\n";
+	writeConf(tmp + "/repo/mods.d/new.conf", "[New]\nDataPath=./modules/texts/ztext/new/\nModDrv=zText\nLang=fr\nVersion=1.1\n");
+	publish(server, tmp);
+	server.files["/repo/mods.d/new.conf"] = "[New]\nDataPath=./modules/texts/ztext/new/\nModDrv=zText\nLang=fr\nVersion=9.9\n";
+	server.resetCounts();
+	retVal = installMgr.refreshRemoteSource(&is);
+	cout << "  returned " << retVal << "\n";
+	cout << "  fell back to mods.d.tar.gz: " << (fetched(server, "/repo/mods.d.tar.gz") ? "yes" : "no") << "\n";
+	bool agrees = (is.getCatalog()->getEntries().size() == is.getMgr()->getModules().size() + is.getMgr()->getUtilModules().size());
+	for (ModMap::const_iterator it = is.getMgr()->getModules().begin(); it != is.getMgr()->getModules().end(); ++it) {
+		if (!is.getCatalog()->getEntry(it->first)) agrees = false;
+	}
+	cout << "  catalog agrees with the .conf files: " << (agrees ? "yes" : "no") << "\n";
+
+	return 0;
+}
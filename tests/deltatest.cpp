@@ -0,0 +1,250 @@
+/******************************************************************************
+ *
+ *  deltatest.cpp -	brings installed copies of a module up to date with a
+ *			newer version in a stand-in repository, which offers
+ *			the manifest mkdelta wrote, and checks that only the
+ *			changed blocks were fetched
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <set>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+#include <installmgr.h>
+#include <entryattridx.h>
+#include <moddelta.h>
+#include <searchjournal.h>
+#include <filemgr.h>
+#include <swmgr.h>
+#include <swmodule.h>
+#include <swbuf.h>
+#include <listkey.h>
+
+#include "standinserver.h"
+
+using namespace sword;
+using namespace std;
+
+
+const char *DATAPATH = "modules/texts/ztext/osisreference";
+
+
+SWBuf readFile(const char *path) {
+	SWBuf contents;
+	FILE *file = fopen(path, "rb");
+	if (file) {
+		char buf[4096];
+		size_t got;
+		// append() would stop at a 0
+		while ((got = fread(buf, 1, sizeof(buf), file)) > 0) {
+			unsigned long size = contents.size();
+			contents.setSize(size + got);
+			memcpy(contents.getRawData() + size, buf, got);
+		}
+		fclose(file);
+	}
+	return contents;
+}
+
+
+// the installed data files are those of the repository, and no others
+bool sameFiles(const SWBuf &repoDir, const SWBuf &installedDir) {
+	bool same = true;
+	set<SWBuf> names;
+	vector<DirEntry> entries = FileMgr::getDirList(repoDir);
+	for (unsigned int i = 0; i < entries.size(); i++) {
+		names.insert(entries[i].name);
+		SWBuf expected = readFile(repoDir + "/" + entries[i].name);
+		SWBuf got = readFile(installedDir + "/" + entries[i].name);
+		if (!FileMgr::existsFile(installedDir + "/" + entries[i].name) || got.length() != expected.length() || memcmp(got.c_str(), expected.c_str(), got.length())) {
+			cout << "  " << entries[i].name << " differs\n";
+			same = false;
+		}
+	}
+	entries = FileMgr::getDirList(installedDir);
+	for (unsigned int i = 0; i < entries.size(); i++) {
+		if (!entries[i].isDirectory && names.find(entries[i].name) == names.end()) {
+			cout << "  " << entries[i].name << " left over\n";
+			same = false;
+		}
+	}
+	return same;
+}
+
+
+// the files ranges were asked of, and how many bytes they came to
+SWBuf rangesAsked(StandInServer &server, unsigned long &bytes) {
+	set<SWBuf> names;
+	bytes = 0;
+	for (unsigned int i = 0; i < server.ranges.size(); i++) {
+		const char *range = server.ranges[i].c_str();
+		const char *space = strrchr(range, ' ');
+		const char *slash = strrchr(range, '/');
+		long first = 0, last = -1;
+		if (!space || !slash || sscanf(space + 1, "%ld-%ld", &first, &last) != 2) continue;
+		SWBuf name;
+		name.append(slash + 1, space - slash - 1);
+		names.insert(name);
+		bytes += last - first + 1;
+	}
+	SWBuf list;
+	for (set<SWBuf>::const_iterator it = names.begin(); it != names.end(); ++it) {
+		if (list.length()) list += " ";
+		list += *it;
+	}
+	return list.length() ? list : SWBuf("none");
+}
+
+
+unsigned long dataSize(const SWBuf &dir) {
+	unsigned long size = 0;
+	vector<DirEntry> entries = FileMgr::getDirList(dir);
+	for (unsigned int i = 0; i < entries.size(); i++) {
+		if (entries[i].name != ModuleDelta::MANIFEST) size += FileMgr::getFileSize(dir + "/" + entries[i].name);
+	}
+	return size;
+}
+
+
+// the keys a search of module finds, or "none"
+SWBuf searchHits(SWModule *module, int searchType, const char *query) {
+	if (!module) return "no module";
+	SWBuf hits;
+	ListKey &results = module->search(query, searchType, 0);
+	for (results = TOP; !results.popError(); results++) {
+		if (hits.length()) hits += ", ";
+		hits += results.getShortText();
+	}
+	return hits.length() ? hits : SWBuf("none");
+}
+
+
+// installs the repository's module over a copy of the old version
+int update(InstallMgr &installMgr, InstallSource &is, StandInServer &server, const SWBuf &tmp, const char *name) {
+	SWBuf root = tmp + "/" + name;
+	FileMgr::copyDir(tmp + "/v1", root);
+	SWMgr destMgr(root);
+	server.resetCounts();
+	return installMgr.installModule(&destMgr, 0, "OSISReference", &is);
+}
+
+
+void report(StandInServer &server, const SWBuf &tmp, const char *name, int retVal) {
+	SWBuf installedDir = tmp + "/" + name + "/" + DATAPATH;
+	unsigned long fetched;
+	SWBuf asked = rangesAsked(server, fetched);
+	cout << "  returned " << retVal << "\n";
+	cout << "  files match the new version: " << (sameFiles(tmp + "/v2/" + DATAPATH, installedDir) ? "yes" : "no") << "\n";
+	cout << "  ranges asked of: " << asked << "\n";
+	cout << "  fetched less than the module: " << ((fetched < dataSize(installedDir)) ? "yes" : "no") << "\n";
+	cout << "  nothing left beside it: " << ((!FileMgr::existsDir(installedDir + ".delta") && !FileMgr::existsDir(installedDir + ".old")) ? "yes" : "no") << "\n";
+}
+
+
+int main(int argc, char **argv) {
+	SWBuf tmp = (argc > 1) ? argv[1] : "tmp/delta";
+
+	StandInServer server;
+	server.addDirectory("/repo", tmp + "/v2");
+
+	SWBuf host;
+	host.setFormatted("127.0.0.1:%d", server.port);
+
+	InstallMgr installMgr(tmp + "/installmgr");
+	installMgr.setUserDisclaimerConfirmed(true);
+	InstallSource is("HTTP");
+	is.caption = "Stand-in";
+	is.source = host;
+	is.directory = "/repo";
+	is.uid = "standin";
+	if (installMgr.refreshRemoteSource(&is)) {
+		cout << "couldn't list the stand-in repository\n";
+		return 1;
+	}
+
+	cout << "an update to the next version:\n";
+	// the old version has a search framework, which indexes the old text
+	SWBuf updatedDir = tmp + "/updated/" + DATAPATH;
+	FileMgr::copyDir(tmp + "/v1", tmp + "/updated");
+	{
+		SWMgr mgr(tmp + "/updated");
+		SWModule *module = mgr.getModule("OSISReference");
+		if (module) module->createSearchFramework();
+	}
+	SWBuf lucene = updatedDir + "/lucene/segments";
+	int fd = FileMgr::createPathAndFile(lucene);
+	FileMgr::closeFile(fd);
+	bool built = FileMgr::existsFile(SearchJournal::getJournalPath(updatedDir)) && FileMgr::existsFile(EntryAttributeIndex::getIndexPath(updatedDir));
+	int retVal = update(installMgr, is, server, tmp, "updated");
+	report(server, tmp, "updated", retVal);
+	cout << "  old search framework dropped: " << ((built && !FileMgr::existsDir(updatedDir + "/lucene") && !FileMgr::existsFile(SearchJournal::getJournalPath(updatedDir)) && !FileMgr::existsFile(EntryAttributeIndex::getIndexPath(updatedDir))) ? "yes" : "no") << "\n";
+	{
+		SWMgr mgr(tmp + "/updated");
+		SWModule *module = mgr.getModule("OSISReference");
+		if (module) module->setKey("Gen 1:1");
+		cout << "  reads the new text: " << ((module && strstr(module->stripText(), "In the very beginning")) ? "yes" : "no") << "\n";
+		cout << "  search framework current: " << ((module && module->isSearchFrameworkCurrent()) ? "yes" : "no") << "\n";
+		cout << "  search finds the new text: " << searchHits(module, SWModule::SEARCHTYPE_PHRASE, "very beginning") << "\n";
+		if (module) module->updateSearchFramework();
+		cout << "  rebuilt, search framework current: " << ((module && module->isSearchFrameworkCurrent()) ? "yes" : "no") << "\n";
+		cout << "  search finds the new text: " << searchHits(module, SWModule::SEARCHTYPE_PHRASE, "very beginning") << "\n";
+		cout << "  and not the old: " << searchHits(module, SWModule::SEARCHTYPE_PHRASE, "In the beginning") << "\n";
+	}
+
+	cout << "again, with nothing changed:\n";
+	{
+		SWMgr destMgr(tmp + "/updated");
+		server.resetCounts();
+		retVal = installMgr.installModule(&destMgr, 0, "OSISReference", &is);
+	}
+	report(server, tmp, "updated", retVal);
+
+	cout << "a server which ignores ranges:\n";
+	server.refuseRanges = true;
+	retVal = update(installMgr, is, server, tmp, "refused");
+	report(server, tmp, "refused", retVal);
+	server.refuseRanges = false;
+
+	cout << "delta updates turned off:\n";
+	installMgr.setDeltaUpdates(false);
+	retVal = update(installMgr, is, server, tmp, "off");
+	report(server, tmp, "off", retVal);
+	installMgr.setDeltaUpdates(true);
+
+	cout << "a repository without a manifest:\n";
+	server.files.erase(SWBuf("/repo/") + DATAPATH + "/" + ModuleDelta::MANIFEST);
+	retVal = update(installMgr, is, server, tmp, "whole");
+	SWBuf installedDir = tmp + "/whole/" + DATAPATH;
+	cout << "  returned " << retVal << "\n";
+	vector<DirEntry> entries = FileMgr::getDirList(tmp + "/v2/" + DATAPATH);
+	bool same = true;
+	for (unsigned int i = 0; i < entries.size(); i++) {
+		if (entries[i].name == ModuleDelta::MANIFEST) continue;
+		SWBuf expected = readFile(tmp + "/v2/" + DATAPATH + "/" + entries[i].name);
+		SWBuf got = readFile(installedDir + "/" + entries[i].name);
+		if (got.length() != expected.length() || memcmp(got.c_str(), expected.c_str(), got.length())) same = false;
+	}
+	cout << "  files match the new version: " << (same ? "yes" : "no") << "\n";
+	cout << "  range requests: " << server.ranges.size() << "\n";
+
+	return 0;
+}
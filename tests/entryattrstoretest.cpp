@@ -0,0 +1,191 @@
+/******************************************************************************
+ *
+ *  entryattrstoretest.cpp -	exercises EntryAttributeStore, then, given a
+ *				module, checks that getEntryAttributes() shows
+ *				what the filters put in the store for each entry
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <entryattrstore.h>
+#include <swmgr.h>
+#include <swmodule.h>
+
+using namespace std;
+using namespace sword;
+
+
+int failures = 0;
+
+void expect(bool ok, const char *what) {
+	cout << what << ": " << (ok ? "ok" : "FAILED") << "\n";
+	if (!ok) ++failures;
+}
+
+
+bool valueIs(const char *value, const char *expected) {
+	return value && !strcmp(value, expected);
+}
+
+
+void testStore() {
+	EntryAttributeStore store;
+
+	store.set("Word", "001", "Lemma", "G2316");
+	store.set("Word", "001", "Morph", "N-NSM");
+	store.set("Footnote", "1", "body", "a note");
+	store.set("Word", "002", "Lemma", "G3588");
+	expect(store.getCount() == 4 && valueIs(store.get("Word", "001", "Morph"), "N-NSM"), "set and get");
+	expect(!store.get("Word", "003", "Lemma") && !store.get("Word", "001", "Text") && !store.get("Heading", "001", "Lemma"), "absent attributes are 0");
+
+	store.set("Word", "001", "Lemma", "G26");
+	store.set("Word", "002", "Lemma", "a lemma longer than it was");
+	expect(store.getCount() == 4 && valueIs(store.get("Word", "001", "Lemma"), "G26") && valueIs(store.get("Word", "002", "Lemma"), "a lemma longer than it was"), "set replaces");
+
+	store.append("Word", "001", "Lemma", " G25");
+	store.append("Heading", "Preverse", "0", "<div>");
+	store.append("Heading", "Preverse", "0", "</div>");
+	expect(valueIs(store.get("Word", "001", "Lemma"), "G26 G25") && valueIs(store.get("Heading", "Preverse", "0"), "<div></div>"), "append");
+
+	store.set("Word", "003", "Text", store.get("Word", "002", "Lemma"), 8);
+	expect(valueIs(store.get("Word", "003", "Text"), "a lemma "), "set from a value of the store");
+
+	store.set("Footnote", "2", "body", "with\0nul", 8);
+	expect(store.getValueLength(store.find("Footnote", "2", "body")) == 8, "values may hold nul");
+
+	SWBuf visited;
+	for (unsigned long i = store.find("Word"); i < store.getCount(); i = store.find("Word", 0, 0, i + 1)) {
+		if (store.isFirstOfItem(i)) visited.appendFormatted("%s ", store.getItem(i));
+	}
+	expect(visited == "001 002 003 ", "find and isFirstOfItem visit each item once, in order");
+	expect(store.find("Word", 0, "Morph") == 1 && store.find("Word", 0, "Morph", 2) == store.getCount() && store.find("Nothing") == store.getCount(), "find by name");
+
+	AttributeTypeList map;
+	store.copyTo(map);
+	expect(map.size() == 3 && map["Word"].size() == 3 && map["Word"]["001"]["Lemma"] == "G26 G25" && map["Footnote"]["2"]["body"].length() == 8, "copyTo");
+
+	map["Word"]["004"]["Lemma"] = "H430";
+	EntryAttributeStore other;
+	other.assign(map);
+	AttributeTypeList back;
+	other.copyTo(back);
+	expect(back == map && valueIs(other.get("Word", "004", "Lemma"), "H430"), "assign");
+
+	const char *type = store.getType(0);
+	store.clear();
+	expect(!store.getCount() && !store.get("Word", "001", "Lemma") && store.find("Word") == store.getCount(), "clear");
+	expect(!strcmp(type, "Word"), "names outlive clear");
+
+	// enough entries that the tables grow, and clear() runs many times
+	bool many = true;
+	char item[16], value[32];
+	for (int entry = 0; entry < 50; entry++) {
+		store.clear();
+		int words = 1 + entry * 7;
+		for (int w = 1; w <= words; w++) {
+			sprintf(item, "%.3d", w);
+			sprintf(value, "G%d", entry * 1000 + w);
+			store.set("Word", item, "Lemma", value);
+			store.set("Word", item, "PartCount", "1");
+		}
+		if (store.getCount() != (unsigned long)words * 2) many = false;
+		for (int w = 1; w <= words; w++) {
+			sprintf(item, "%.3d", w);
+			sprintf(value, "G%d", entry * 1000 + w);
+			if (!valueIs(store.get("Word", item, "Lemma"), value)) many = false;
+		}
+		sprintf(item, "%.3d", words + 1);
+		if (store.get("Word", item, "Lemma")) many = false;
+	}
+	expect(many, "many entries");
+}
+
+
+// the store's attributes, in its order
+SWBuf listAttributes(const EntryAttributeStore &store) {
+	SWBuf list;
+	for (unsigned long i = 0; i < store.getCount(); i++) {
+		list.appendFormatted("%s/%s/%s=%s;", store.getType(i), store.getItem(i), store.getName(i), store.getValue(i));
+	}
+	return list;
+}
+
+
+void testModule(SWModule *module) {
+	int entries = 0, attributes = 0, mismatches = 0, rebuilt = 0, unsorted = 0;
+
+	AttributeTypeList &held = module->getEntryAttributes();
+	for ((*module) = TOP; !module->popError(); (*module)++) {
+		module->renderText();
+		EntryAttributeStore &store = module->getEntryAttributeStore();
+		SWBuf rendered = listAttributes(store);
+		AttributeTypeList expected;
+		store.copyTo(expected);
+		// held first: the render alone should have brought it up to date
+		if (expected != held || expected != module->getEntryAttributes() || expected != module->getEntryAttributesView()) ++mismatches;
+		attributes += (int)store.getCount();
+		++entries;
+
+		// with the view handed out, render again: the store should be
+		// left as the filters made it, not rebuilt from the view, which
+		// would put it in the view's order
+		EntryAttributeStore sorted;
+		sorted.assign(expected);
+		if (listAttributes(sorted) != rendered) ++unsorted;
+		module->renderText();
+		if (listAttributes(module->getEntryAttributeStore()) != rendered) ++rebuilt;
+	}
+	cout << "entries: " << entries << ", attributes: " << attributes << ", entries not in the view's order: " << unsorted << "\n";
+	expect(!mismatches, "a held getEntryAttributes() matches the store after each render");
+	expect(unsorted && !rebuilt, "the store isn't rebuilt from a view handed out before the render");
+
+	(*module) = TOP;
+	module->renderText();
+	module->getEntryAttributes()["Test"]["1"]["value"] = "set through the view";
+	expect(valueIs(module->getEntryAttributeStore().get("Test", "1", "value"), "set through the view"), "the store sees changes made to the view");
+
+	module->getEntryAttributeStore().set("Test", "2", "value", "set in the store");
+	expect(module->getEntryAttributes()["Test"]["2"]["value"] == "set in the store" && held["Test"]["1"]["value"] == "set through the view", "the view sees changes made to the store");
+
+	(*module)++;
+	module->renderText();
+	expect(held.find("Test") == held.end(), "a held view shows the entry rendered last");
+	expect(!module->getEntryAttributeStore().get("Test", "1", "value"), "changes made to the view are dropped by the next render");
+}
+
+
+int main(int argc, char **argv) {
+	testStore();
+
+	if (argc > 1) {
+		SWMgr library;
+		SWModule *module = library.getModule(argv[1]);
+		if (!module) {
+			cerr << "couldn't find module: " << argv[1] << "\n";
+			exit(-1);
+		}
+		testModule(module);
+	}
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+/******************************************************************************
+ *
+ *  entryattrtest.cpp -	runs entry attribute searches against a module,
+ *			first by scanning the module and then again using
+ *			the entry attribute index, so the two can be compared
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <regex.h>
+
+#include <swmgr.h>
+#include <swmodule.h>
+#include <versekey.h>
+#include <listkey.h>
+
+using namespace std;
+using namespace sword;
+
+
+void runSearches(SWModule *module, int argc, char **argv) {
+	const int flagSets[] = { 0, REG_ICASE, SWModule::SEARCHFLAG_MATCHWHOLEENTRY };
+	const char *flagNames[] = { "substring", "icase", "whole entry" };
+
+	for (int i = 2; i < argc; ++i) {
+		for (int f = 0; f < 3; ++f) {
+			ListKey &results = module->search(argv[i], SWModule::SEARCHTYPE_ENTRYATTR, flagSets[f]);
+			cout << argv[i] << " (" << flagNames[f] << "): ";
+			for (results = TOP; !results.popError(); results++) {
+				cout << results.getShortText() << "; ";
+			}
+			cout << "\n";
+		}
+	}
+}
+
+
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		cerr << "usage: " << *argv << " <modName> <attribute search> [<attribute search> ...]\n";
+		exit(-1);
+	}
+
+	SWMgr library;
+	SWModule *module = library.getModule(argv[1]);
+	if (!module) {
+		cerr << "Couldn't find module: " << argv[1] << "\n";
+		exit(-2);
+	}
+
+	module->deleteEntryAttributeIndex();
+	cout << "-- scan (index present: " << module->hasEntryAttributeIndex() << ")\n";
+	runSearches(module, argc, argv);
+
+	cout << "-- build index: " << (int)module->createEntryAttributeIndex() << "\n";
+	cout << "-- index (index present: " << module->hasEntryAttributeIndex() << ")\n";
+	runSearches(module, argc, argv);
+
+	module->deleteEntryAttributeIndex();
+
+	return 0;
+}
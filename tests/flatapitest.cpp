@@ -0,0 +1,133 @@
+/******************************************************************************
+ *
+ *  flatapitest.cpp -	calls the flat C api as a binding would, checking the
+ *			table form of results against the arrays, and that a
+ *			call builds its result in the storage the last one left
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <string.h>
+
+#include <swbuf.h>
+
+extern "C" {
+#include <flatapi.h>
+}
+
+using sword::SWBuf;
+using namespace std;
+
+
+const char *yesNo(bool b) { return b ? "yes" : "no"; }
+
+
+// the table holds just the strings of the array, in the same storage
+bool sameStrings(const char **array, const org_crosswire_sword_StringTable *table) {
+	int i = 0;
+	for (; array[i]; ++i) {
+		if (i >= table->count || array[i] != table->strings + table->offsets[i]) return false;
+	}
+	return (i == table->count);
+}
+
+
+void printArray(const char *label, const char **array) {
+	cout << label << ":";
+	for (int i = 0; array && array[i]; ++i) cout << " " << array[i];
+	cout << "\n";
+}
+
+
+int main(int argc, char **argv) {
+	const char *path = (argc > 1) ? argv[1] : "tmp/flatapi";
+	SWHANDLE mgr = org_crosswire_sword_SWMgr_newWithPath(path);
+
+	cout << "modules:\n";
+	const org_crosswire_sword_ModInfo *infos = org_crosswire_sword_SWMgr_getModInfoList(mgr);
+	for (int i = 0; infos[i].name; ++i) {
+		cout << "  " << infos[i].name << " (" << infos[i].category << ", " << infos[i].language << ", version " << infos[i].version << ")";
+		cout << (infos[i].cipherKey ? " ciphered" : "");
+		for (int j = 0; infos[i].features[j]; ++j) cout << " " << infos[i].features[j];
+		cout << "\n";
+	}
+	const char *firstName = infos[0].name;
+	const org_crosswire_sword_ModInfo *again = org_crosswire_sword_SWMgr_getModInfoList(mgr);
+	cout << "  same storage the next time: " << yesNo(again == infos && again[0].name == firstName) << "\n";
+
+	SWHANDLE module = org_crosswire_sword_SWMgr_getModuleByName(mgr, "OSISReference");
+
+	cout << "search:\n";
+	const org_crosswire_sword_SearchHit *hits = org_crosswire_sword_SWModule_search(module, "the", -1, 0, 0, 0);
+	int count = 0;
+	cout << " ";
+	for (; hits[count].modName; ++count) cout << " " << hits[count].key;
+	cout << "\n";
+	const org_crosswire_sword_SearchHitTable *hitTable = org_crosswire_sword_SWModule_getSearchHitTable(module);
+	bool same = (hitTable->keys.count == count);
+	for (int i = 0; same && i < count; ++i) {
+		same = (hits[i].key == hitTable->keys.strings + hitTable->keys.offsets[i]) && (hits[i].score == hitTable->scores[i]) && !strcmp(hits[i].modName, hitTable->modName);
+	}
+	cout << "  table of " << hitTable->keys.count << " hits, in the array's storage: " << yesNo(same) << "\n";
+	const char *keys = hitTable->keys.strings;
+	org_crosswire_sword_SWModule_search(module, "the", -1, 0, 0, 0);
+	cout << "  same storage the next time: " << yesNo(org_crosswire_sword_SWModule_getSearchHitTable(module)->keys.strings == keys) << "\n";
+	hits = org_crosswire_sword_SWModule_search(module, "no such words", -1, 0, 0, 0);
+	hitTable = org_crosswire_sword_SWModule_getSearchHitTable(module);
+	cout << "  none found: " << yesNo(!hits[0].modName && !hitTable->keys.count) << "\n";
+
+	cout << "parseKeyList:\n";
+	const org_crosswire_sword_StringTable *table = org_crosswire_sword_SWModule_parseKeyListTable(module, "Gen 1:1-3; Ps 3:2");
+	cout << " ";
+	for (int i = 0; i < table->count; ++i) cout << " " << table->strings + table->offsets[i];
+	cout << "\n";
+	const char **array = org_crosswire_sword_SWModule_parseKeyList(module, "Gen-Rev");
+	table = org_crosswire_sword_SWModule_parseKeyListTable(module, "Gen-Rev");
+	cout << "  Gen-Rev: " << table->count << " verses, " << table->strings + table->offsets[table->count - 1] << " last; table matches the array: " << yesNo(sameStrings(array, table)) << "\n";
+
+	org_crosswire_sword_SWModule_setKeyText(module, "Gen 1:1");
+
+	cout << "getEntryAttribute:\n";
+	array = org_crosswire_sword_SWModule_getEntryAttribute(module, "Word", "", "Lemma", 0);
+	printArray(" ", array);
+	table = org_crosswire_sword_SWModule_getEntryAttributeTable(module, "Word", "", "Lemma", 0);
+	cout << "  table matches the array: " << yesNo(sameStrings(array, table)) << "\n";
+
+	printArray("getKeyChildren", org_crosswire_sword_SWModule_getKeyChildren(module));
+
+	cout << "stripText:\n";
+	const char *text = org_crosswire_sword_SWModule_stripText(module);
+	cout << "  " << text << "\n";
+	cout << "  same storage the next time: " << yesNo(org_crosswire_sword_SWModule_stripText(module) == text) << "\n";
+	cout << "  unknown config entry: " << (org_crosswire_sword_SWModule_getConfigEntry(module, "NoSuchEntry") ? "found" : "null") << "\n";
+
+	cout << "SWConfig:\n";
+	SWBuf confPath = SWBuf(path) + "/invalid.conf";
+	const char *value = org_crosswire_sword_SWConfig_getKeyValue(confPath, "Section", "Key");
+	cout << "  invalid UTF-8 replaced: ";
+	for (const char *c = value; c && *c; ++c) {
+		if (*c == 0x1a) cout << "<0x1a>";
+		else cout << *c;
+	}
+	cout << "\n";
+	cout << "  missing key: " << (org_crosswire_sword_SWConfig_getKeyValue(confPath, "Section", "None") ? "found" : "null") << "\n";
+
+	org_crosswire_sword_SWMgr_delete(mgr);
+	return 0;
+}
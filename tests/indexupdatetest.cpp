@@ -0,0 +1,142 @@
+/******************************************************************************
+ *
+ *  indexupdatetest.cpp -	edits a module which has a search framework and
+ *			shows the framework kept up to date with the edits,
+ *			and rebuilt when the data changes behind its back
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#include <swmgr.h>
+#include <swmodule.h>
+#include <listkey.h>
+#include <searchjournal.h>
+
+using namespace std;
+using namespace sword;
+
+
+void report(SWModule *module, const char *what) {
+	const char *dataPath = module->getConfigEntry("AbsoluteDataPath");
+	// writes out, and seals, pending edits
+	bool current = module->isSearchFrameworkCurrent();
+	SearchJournal journal(dataPath);
+	journal.load();
+	cout << "-- " << what << " (current: " << current
+		<< ", journaled edits: " << journal.getEdits().size()
+		<< ", attribute index: " << module->hasEntryAttributeIndex() << ")\n";
+}
+
+
+void search(SWModule *module, const char *query) {
+	ListKey &results = module->search(query, SWModule::SEARCHTYPE_ENTRYATTR);
+	cout << query << ": ";
+	for (results = TOP; !results.popError(); results++) {
+		cout << results.getShortText() << "; ";
+	}
+	cout << "\n";
+}
+
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		cerr << "usage: " << *argv << " <modName>\n";
+		exit(-1);
+	}
+
+	SWMgr library;
+	SWModule *module = library.getModule(argv[1]);
+	if (!module) {
+		cerr << "Couldn't find module: " << argv[1] << "\n";
+		exit(-2);
+	}
+	const char *query = "Word//Lemma./G2316";
+
+	module->deleteSearchFramework();
+	report(module, "no framework");
+
+	cout << "-- build: " << (int)module->createSearchFramework() << "\n";
+	report(module, "built");
+	search(module, query);
+
+	module->setKey("Gen 1:1");
+	module->setEntry("<w lemma=\"strong:G2316\">God</w> made it all");
+	module->setKey("Matt 2:5");
+	module->setEntry("<w lemma=\"strong:G2316\">God</w> said so");
+	report(module, "edited Gen 1:1 and Matt 2:5");
+	search(module, query);
+	report(module, "searched");
+
+	module->setKey("Mark 1:14");
+	module->deleteEntry();
+	report(module, "deleted Mark 1:14");
+	cout << "-- update: " << (int)module->updateSearchFramework() << "\n";
+	report(module, "updated");
+	search(module, query);
+
+	// a change the module didn't make
+	SWBuf extra = module->getConfigEntry("AbsoluteDataPath");
+	extra += "/extra.txt";
+	FILE *f = fopen(extra, "w");
+	fputs("not module data", f);
+	fclose(f);
+	module->setKey("Acts 2:21");
+	module->deleteEntry();
+	report(module, "changed behind its back, then deleted Acts 2:21");
+	search(module, query);
+	cout << "-- update: " << (int)module->updateSearchFramework() << "\n";
+	report(module, "rebuilt");
+	search(module, query);
+
+	// many edits in one block, which a compressed driver holds back until
+	// it's flushed, sealed in the journal together
+	for (int verse = 2; verse <= 20; ++verse) {
+		SWBuf ref, text;
+		ref.setFormatted("Gen 1:%d", verse);
+		text.setFormatted("<w lemma=\"strong:G2316\">God</w> saw verse %d", verse);
+		module->setKey(ref.c_str());
+		module->setEntry(text);
+	}
+	report(module, "edited Gen 1:2-20");
+	cout << "-- update: " << (int)module->updateSearchFramework() << "\n";
+	report(module, "updated");
+	search(module, query);
+
+	// a change behind its back which leaves size and modification time
+	struct stat st;
+	stat(extra, &st);
+	f = fopen(extra, "w");
+	fputs("NOT module data", f);
+	fclose(f);
+	struct utimbuf times;
+	times.actime = st.st_atime;
+	times.modtime = st.st_mtime;
+	utime(extra, &times);
+	report(module, "changed behind its back, same size and time");
+
+	module->deleteSearchFramework();
+	report(module, "deleted framework");
+
+	return 0;
+}
@@ -0,0 +1,187 @@
+/******************************************************************************
+ *
+ *  ldbuildtest.cpp -	adds the same entries, out of order and with keys
+ *			set again, to RawLD, RawLD4 and zLD modules once in
+ *			a bulk load and once with plain setEntry() calls,
+ *			and checks that both leave the same index behind
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <rawld.h>
+#include <rawld4.h>
+#include <zld.h>
+#include <lzsscomprs.h>
+#include <filemgr.h>
+
+using namespace std;
+using namespace sword;
+
+
+int failures = 0;
+
+void expect(bool ok, const char *what) {
+	cout << what << ": " << (ok ? "ok" : "FAILED") << "\n";
+	if (!ok) ++failures;
+}
+
+
+// already in the module before the bulk load
+const char *existing[] = { "Delta", "Alpha", "Kappa", "Eta", 0 };
+
+// then, with a flush before "--": out of order, and merged in among them
+const char *distinct[] = { "Gamma", "Beta", "Zeta", "Aleph", "--", "Epsilon", "Theta", "Omega", "Iota", 0 };
+
+// the same with keys set twice in the load, keys already in the module,
+// and keys differing only in case
+const char *repeated[] = { "Gamma", "Beta", "Alpha", "gamma", "Zeta", "Beta", "--", "Epsilon", "Kappa", "Beta", "Theta", "Aleph", "Gamma", 0 };
+
+
+enum Driver { RAWLD, RAWLD4, ZLD };
+
+SWModule *open(Driver driver, const char *path) {
+	switch (driver) {
+	case RAWLD: return new RawLD(path);
+	case RAWLD4: return new RawLD4(path);
+	default: return new zLD(path, 0, 0, 4, new LZSSCompress());
+	}
+}
+
+void create(Driver driver, const char *path) {
+	switch (driver) {
+	case RAWLD: RawLD::createModule(path); break;
+	case RAWLD4: RawLD4::createModule(path); break;
+	default: zLD::createModule(path); break;
+	}
+}
+
+
+void fill(Driver driver, const char *path, const char **loaded, bool bulk) {
+	create(driver, path);
+	SWModule *module = open(driver, path);
+	int n = 0;
+	for (const char **key = existing; *key; ++key) {
+		module->setKey(*key);
+		module->setEntry(SWBuf().setFormatted("%s, entry %d", *key, ++n));
+	}
+	delete module;
+
+	module = open(driver, path);
+	SWLD *ld = (SWLD *)module;
+	if (bulk) ld->beginBulkLoad();
+	for (const char **key = loaded; *key; ++key) {
+		if (!strcmp(*key, "--")) {
+			module->flush();
+			continue;
+		}
+		module->setKey(*key);
+		module->setEntry(SWBuf().setFormatted("%s, entry %d", *key, ++n));
+	}
+	if (bulk) ld->endBulkLoad();
+	delete module;
+}
+
+
+// every key and entry, in order
+typedef vector<pair<SWBuf, SWBuf> > EntryList;
+
+EntryList listEntries(Driver driver, const char *path) {
+	EntryList entries;
+	SWModule *module = open(driver, path);
+	for ((*module) = TOP; !module->popError(); (*module)++) {
+		entries.push_back(make_pair(SWBuf(module->getKeyText()), SWBuf(module->getRawEntry())));
+	}
+	delete module;
+	return entries;
+}
+
+
+SWBuf show(const EntryList &entries) {
+	SWBuf shown;
+	for (EntryList::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+		shown.appendFormatted("%s=%s; ", it->first.c_str(), it->second.c_str());
+	}
+	return shown;
+}
+
+
+bool sameFile(const SWBuf &a, const SWBuf &b) {
+	FileDesc *fa = FileMgr::getSystemFileMgr()->open(a, FileMgr::RDONLY);
+	FileDesc *fb = FileMgr::getSystemFileMgr()->open(b, FileMgr::RDONLY);
+	bool same = (fa->getFd() >= 0 && fb->getFd() >= 0);
+	char ba[4096], bb[4096];
+	while (same) {
+		long ga = fa->read(ba, sizeof(ba));
+		long gb = fb->read(bb, sizeof(bb));
+		if (ga != gb || (ga > 0 && memcmp(ba, bb, ga))) same = false;
+		if (ga <= 0) break;
+	}
+	FileMgr::getSystemFileMgr()->close(fa);
+	FileMgr::getSystemFileMgr()->close(fb);
+	return same;
+}
+
+
+void test(Driver driver, const char *name, const char *dir, const char **extensions) {
+	SWBuf path = SWBuf(dir) + "/" + name;
+	fill(driver, path + "-plain", distinct, false);
+	fill(driver, path + "-bulk", distinct, true);
+
+	EntryList entries = listEntries(driver, path + "-plain");
+	cout << name << ": " << show(entries) << "\n";
+	expect(entries == listEntries(driver, path + "-bulk"), SWBuf(name) + " entries read back alike");
+	for (const char **extension = extensions; *extension; ++extension) {
+		expect(sameFile(path + "-plain" + *extension, path + "-bulk" + *extension), SWBuf(name) + " " + *extension + " files alike");
+	}
+
+	// setEntry() puts a key set again before whichever entry of that key
+	// its binary search meets first, and a lookup finds one the same way,
+	// so among a key's entries only the bulk load's order, newest first,
+	// is fixed; both must hold the same entries under the same keys
+	fill(driver, path + "-plain-repeated", repeated, false);
+	fill(driver, path + "-bulk-repeated", repeated, true);
+
+	EntryList plain = listEntries(driver, path + "-plain-repeated");
+	EntryList bulk = listEntries(driver, path + "-bulk-repeated");
+	cout << name << ", keys repeated: " << show(bulk) << "\n";
+	stable_sort(plain.begin(), plain.end());
+	stable_sort(bulk.begin(), bulk.end());
+	expect(plain == bulk, SWBuf(name) + " repeated keys hold the same entries");
+}
+
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		cerr << "usage: " << *argv << " <directory>\n";
+		exit(-1);
+	}
+
+	const char *raw[] = { ".idx", ".dat", 0 };
+	const char *compressed[] = { ".idx", ".dat", ".zdx", ".zdt", 0 };
+	test(RAWLD, "RawLD", argv[1], raw);
+	test(RAWLD4, "RawLD4", argv[1], raw);
+	test(ZLD, "zLD", argv[1], compressed);
+
+	return failures ? 1 : 0;
+}
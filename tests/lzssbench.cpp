@@ -0,0 +1,168 @@
+/******************************************************************************
+ *
+ *  lzssbench.cpp -	compares LZSSCompress's throughput and compressed
+ *			size at several levels against the ring buffer and
+ *			binary tree codec it used to be, on files cut into
+ *			blocks as a compressed module stores them
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+
+#include <lzsscomprs.h>
+
+#include "lzsslegacy.h"
+
+using namespace sword;
+
+using std::vector;
+
+typedef vector<unsigned char> Bytes;
+
+
+void usage(const char *app) {
+	fprintf(stderr, "usage: %s [-p passes] [-b blockSize] <file>...\n", app);
+	fprintf(stderr, "\teach file is cut into blocks of blockSize bytes (default 16384) which are\n");
+	fprintf(stderr, "\tcompressed and decompressed passes times (default 3)\n");
+	exit(-1);
+}
+
+
+double elapsed(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+bool readFile(const char *path, Bytes &contents) {
+	FILE *f = fopen(path, "rb");
+	if (!f) return false;
+	unsigned char chunk[65536];
+	size_t got;
+	while ((got = fread(chunk, 1, sizeof(chunk), f)) > 0) contents.insert(contents.end(), chunk, chunk + got);
+	fclose(f);
+	return true;
+}
+
+
+void bench(const char *path, const vector<Bytes> &blocks, unsigned long bytes, int passes) {
+	const int levels[] = { 1, 6, 9 };
+	const int levelCount = sizeof(levels) / sizeof(levels[0]);
+	double mb = (double)bytes * passes / (1024 * 1024);
+
+	LegacyLZSS *legacy = new LegacyLZSS();
+	vector<Bytes> oldStreams(blocks.size());
+	double oldEncode = 0, oldDecode = 0;
+	unsigned long oldSize = 0;
+	Bytes text;
+	for (int pass = 0; pass < passes; ++pass) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < blocks.size(); ++i) {
+			legacy->encode(&blocks[i][0], blocks[i].size(), oldStreams[i]);
+		}
+		oldEncode += elapsed(start);
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < blocks.size(); ++i) {
+			legacy->decode(&oldStreams[i][0], oldStreams[i].size(), text);
+		}
+		oldDecode += elapsed(start);
+	}
+	for (unsigned int i = 0; i < blocks.size(); ++i) oldSize += oldStreams[i].size();
+
+	printf("%s: %lu blocks, %.2f MiB\n", path, (unsigned long)blocks.size(), (double)bytes / (1024 * 1024));
+	printf("  old      encode %8.2f MiB/s  decode %8.2f MiB/s  ratio %.3f\n", mb / oldEncode, mb / oldDecode, (double)oldSize / bytes);
+
+	LZSSCompress comp;
+	for (int l = 0; l < levelCount; ++l) {
+		comp.setLevel(levels[l]);
+		vector<Bytes> streams(blocks.size());
+		double newEncode = 0, newDecode = 0;
+		unsigned long newSize = 0;
+		int mismatches = 0;
+		for (int pass = 0; pass < passes; ++pass) {
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (unsigned int i = 0; i < blocks.size(); ++i) {
+				unsigned long len = blocks[i].size();
+				comp.setUncompressedBuf((const char *)&blocks[i][0], &len);
+				const char *z = comp.getCompressedBuf(&len);
+				streams[i].assign(z, z + len);
+			}
+			newEncode += elapsed(start);
+			start = std::chrono::steady_clock::now();
+			for (unsigned int i = 0; i < blocks.size(); ++i) {
+				unsigned long len = streams[i].size();
+				comp.setCompressedBuf(&len, (char *)&streams[i][0]);
+				const char *out = comp.getUncompressedBuf(&len);
+				if (!pass && (len != blocks[i].size() || memcmp(out, &blocks[i][0], len))) ++mismatches;
+			}
+			newDecode += elapsed(start);
+		}
+		for (unsigned int i = 0; i < blocks.size(); ++i) {
+			newSize += streams[i].size();
+			legacy->decode(&streams[i][0], streams[i].size(), text);
+			if (text != blocks[i]) ++mismatches;
+		}
+		printf("  level %d  encode %8.2f MiB/s  decode %8.2f MiB/s  ratio %.3f  search depth %4d  x%.2f encode  x%.2f decode  mismatches %d\n",
+				levels[l], mb / newEncode, mb / newDecode, (double)newSize / bytes, comp.getSearchDepth(),
+				oldEncode / newEncode, oldDecode / newDecode, mismatches);
+	}
+	delete legacy;
+}
+
+
+int main(int argc, char **argv) {
+	vector<const char *> paths;
+	int passes = 3;
+	unsigned long blockSize = 16384;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "-p")) {
+			if (i + 1 >= argc) usage(*argv);
+			passes = atoi(argv[++i]);
+			if (passes < 1) usage(*argv);
+		}
+		else if (!strcmp(argv[i], "-b")) {
+			if (i + 1 >= argc) usage(*argv);
+			blockSize = strtoul(argv[++i], 0, 10);
+			if (blockSize < 1) usage(*argv);
+		}
+		else if (argv[i][0] == '-') usage(*argv);
+		else paths.push_back(argv[i]);
+	}
+	if (paths.empty()) usage(*argv);
+
+	for (unsigned int p = 0; p < paths.size(); ++p) {
+		Bytes contents;
+		if (!readFile(paths[p], contents) || contents.empty()) {
+			fprintf(stderr, "%s: couldn't read %s\n", *argv, paths[p]);
+			continue;
+		}
+		vector<Bytes> blocks;
+		for (unsigned long start = 0; start < contents.size(); start += blockSize) {
+			unsigned long end = (start + blockSize < contents.size()) ? start + blockSize : contents.size();
+			blocks.push_back(Bytes(contents.begin() + start, contents.begin() + end));
+		}
+		bench(paths[p], blocks, contents.size(), passes);
+	}
+
+	return 0;
+}
@@ -0,0 +1,217 @@
+/******************************************************************************
+ *
+ *  lzsslegacy.h -	class LegacyLZSS: the ring buffer and binary tree
+ *			LZSS codec LZSSCompress used to be, kept as the
+ *			reference the tests and benchmark of LZSSCompress
+ *			compare against.  Its state is per instance, and the
+ *			unwritten end of the decoder's ring is 0, rather than
+ *			whatever the last stream left in the shared statics.
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef LZSSLEGACY_H
+#define LZSSLEGACY_H
+
+#include <vector>
+#include <string.h>
+
+
+class LegacyLZSS {
+	enum { N = 4096, F = 18, THRESHOLD = 3, NOT_USED = N };
+
+	unsigned char ring[N + F - 1];
+	short matchPosition;
+	short matchLength;
+	short lson[N + 1];
+	short rson[N + 257];
+	short dad[N + 1];
+
+	void initTree() {
+		for (int i = 0; i < N; i++) lson[i] = rson[i] = dad[i] = NOT_USED;
+		for (int i = N + 1; i <= N + 256; i++) rson[i] = NOT_USED;
+	}
+
+	void insertNode(short pos) {
+		int cmp = 1;
+		unsigned char *key = &ring[pos];
+		short p = (short)(N + 1 + key[0]);
+		lson[pos] = rson[pos] = NOT_USED;
+		matchLength = 0;
+		for (;;) {
+			if (cmp >= 0) {
+				if (rson[p] != NOT_USED) p = rson[p];
+				else { rson[p] = pos; dad[pos] = p; return; }
+			}
+			else {
+				if (lson[p] != NOT_USED) p = lson[p];
+				else { lson[p] = pos; dad[pos] = p; return; }
+			}
+			short i;
+			for (i = 1; i < F; i++) {
+				if ((cmp = key[i] - ring[p + i]) != 0) break;
+			}
+			if (i > matchLength) {
+				matchPosition = p;
+				matchLength = i;
+				if (i >= F) break;
+			}
+		}
+		dad[pos] = dad[p];
+		lson[pos] = lson[p];
+		rson[pos] = rson[p];
+		dad[lson[p]] = pos;
+		dad[rson[p]] = pos;
+		if (rson[dad[p]] == p) rson[dad[p]] = pos;
+		else lson[dad[p]] = pos;
+		dad[p] = NOT_USED;
+	}
+
+	void deleteNode(short node) {
+		short q;
+		if (dad[node] == NOT_USED) return;
+		if (rson[node] == NOT_USED) q = lson[node];
+		else if (lson[node] == NOT_USED) q = rson[node];
+		else {
+			q = lson[node];
+			if (rson[q] != NOT_USED) {
+				do { q = rson[q]; } while (rson[q] != NOT_USED);
+				rson[dad[q]] = lson[q];
+				dad[lson[q]] = dad[q];
+				lson[q] = lson[node];
+				dad[lson[node]] = q;
+			}
+			rson[q] = rson[node];
+			dad[rson[node]] = q;
+		}
+		dad[q] = dad[node];
+		if (rson[dad[node]] == node) rson[dad[node]] = q;
+		else lson[dad[node]] = q;
+		dad[node] = NOT_USED;
+	}
+
+public:
+	LegacyLZSS() {
+		memset(ring, 0, sizeof(ring));
+	}
+
+	void encode(const unsigned char *text, unsigned long textLen, std::vector<unsigned char> &out) {
+		out.clear();
+		unsigned long textPos = 0;
+		unsigned char codeBuf[17];
+		short codeBufPos = 1;
+		unsigned char mask = 1;
+		short s = 0;
+		short r = N - F;
+
+		initTree();
+		codeBuf[0] = 0;
+		memset(ring, ' ', N - F);
+
+		unsigned short len = (unsigned short)((textLen < F) ? textLen : F);
+		memcpy(&ring[r], text, len);
+		textPos = len;
+		if (!len) return;
+
+		for (short i = 1; i <= F; i++) insertNode((short)(r - i));
+		insertNode(r);
+
+		do {
+			if (matchLength > len) matchLength = len;
+			if (matchLength < THRESHOLD) {
+				matchLength = 1;
+				codeBuf[0] |= mask;
+				codeBuf[codeBufPos++] = ring[r];
+			}
+			else {
+				codeBuf[codeBufPos++] = (unsigned char)matchPosition;
+				codeBuf[codeBufPos++] = (unsigned char)(((matchPosition >> 4) & 0xf0) | (matchLength - THRESHOLD));
+			}
+			mask = (unsigned char)(mask << 1);
+			if (!mask) {
+				out.insert(out.end(), codeBuf, codeBuf + codeBufPos);
+				codeBuf[0] = 0;
+				codeBufPos = 1;
+				mask = 1;
+			}
+
+			short lastMatchLength = matchLength;
+			short i;
+			for (i = 0; i < lastMatchLength; i++) {
+				if (textPos >= textLen) break;
+				unsigned char c = text[textPos++];
+				deleteNode(s);
+				ring[s] = c;
+				if (s < F - 1) ring[s + N] = c;
+				s = (short)((s + 1) & (N - 1));
+				r = (short)((r + 1) & (N - 1));
+				insertNode(r);
+			}
+			while (i++ < lastMatchLength) {
+				deleteNode(s);
+				s = (short)((s + 1) & (N - 1));
+				r = (short)((r + 1) & (N - 1));
+				if (--len) insertNode(r);
+			}
+		} while (len > 0);
+
+		if (codeBufPos > 1) out.insert(out.end(), codeBuf, codeBuf + codeBufPos);
+	}
+
+	void decode(const unsigned char *in, unsigned long inLen, std::vector<unsigned char> &out) {
+		out.clear();
+		const unsigned char *inEnd = in + inLen;
+		unsigned char flags = 0;
+		int flagCount = 0;
+		int r = N - F;
+
+		memset(ring, ' ', N - F);
+
+		for (;;) {
+			if (flagCount > 0) {
+				flags = (unsigned char)(flags >> 1);
+				flagCount--;
+			}
+			else {
+				if (in >= inEnd) break;
+				flags = *in++;
+				flagCount = 7;
+			}
+			if (flags & 1) {
+				if (in >= inEnd) break;
+				out.push_back(*in);
+				ring[r] = *in++;
+				r = (r + 1) & (N - 1);
+			}
+			else {
+				if (inEnd - in < 2) break;
+				int pos = in[0] | ((in[1] & 0xf0) << 4);
+				int len = (in[1] & 0x0f) + THRESHOLD;
+				in += 2;
+				for (int k = 0; k < len; k++) {
+					unsigned char c = ring[(pos + k) & (N - 1)];
+					out.push_back(c);
+					ring[r] = c;
+					r = (r + 1) & (N - 1);
+				}
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,201 @@
+/******************************************************************************
+ *
+ *  lzsstest.cpp -	round trips generated texts through LZSSCompress at
+ *			each level, checks its streams against the old ring
+ *			buffer codec in both directions, and that both
+ *			decoders read arbitrary bytes alike
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lzsscomprs.h>
+
+#include "lzsslegacy.h"
+
+using namespace sword;
+using namespace std;
+
+typedef vector<unsigned char> Bytes;
+
+
+// xorshift, so every run tests the same texts
+unsigned int seed = 2463534242U;
+unsigned int next() {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+
+const char *words[] = { "In", "the", "beginning", "God", "created", "heaven", "and", "earth", "was", "without", "form", "void", "darkness", "upon", "face", "of", "deep", "Spirit", "moved", "waters", ",", ".", " ", "\n" };
+
+
+// one of several kinds of text, from incompressible to one byte repeated
+Bytes generate(int kind, unsigned long len) {
+	Bytes text;
+	text.reserve(len);
+	switch (kind) {
+	case 0:		// random bytes
+		while (text.size() < len) text.push_back((unsigned char)next());
+		break;
+	case 1:		// few symbols
+		while (text.size() < len) text.push_back("ab \0"[next() % 4]);
+		break;
+	case 2:		// runs
+		while (text.size() < len) {
+			unsigned char c = (unsigned char)next();
+			for (unsigned long run = next() % 40; run && text.size() < len; run--) text.push_back(c);
+		}
+		break;
+	case 3:		// words
+		while (text.size() < len) {
+			const char *word = words[next() % (sizeof(words) / sizeof(words[0]))];
+			text.insert(text.end(), word, word + strlen(word));
+			if (text.size() < len) text.push_back(' ');
+		}
+		text.resize(len);
+		break;
+	case 4: {	// a block repeated at about the window size
+		unsigned long period = 4070 + next() % 40;
+		while (text.size() < len) text.push_back(text.size() < period ? (unsigned char)next() : text[text.size() - period]);
+		break;
+	}
+	default:	// spaces, which the old encoder matched against its starting ring
+		while (text.size() < len) text.push_back((next() % 16) ? ' ' : 'x');
+		break;
+	}
+	return text;
+}
+
+
+Bytes compress(LZSSCompress &comp, const Bytes &text) {
+	unsigned long len = text.size();
+	comp.setUncompressedBuf(text.size() ? (const char *)&text[0] : "", &len);
+	unsigned long zlen = 0;
+	const char *z = comp.getCompressedBuf(&zlen);
+	return Bytes(z, z + (z ? zlen : 0));
+}
+
+
+Bytes decompress(LZSSCompress &comp, const Bytes &z) {
+	unsigned long zlen = z.size();
+	char none = 0;
+	comp.setCompressedBuf(&zlen, z.size() ? (char *)&z[0] : &none);
+	unsigned long len = 0;
+	const char *text = comp.getUncompressedBuf(&len);
+	return Bytes(text, text + len);
+}
+
+
+struct Check {
+	const char *name;
+	int failures;
+	Check(const char *name) : name(name), failures(0) {}
+	void expect(bool ok, int kind, unsigned long len, int level) {
+		if (!ok && !failures++) cout << "  first failure: " << name << ", kind " << kind << ", " << len << " bytes, level " << level << "\n";
+	}
+	void report() {
+		cout << name << ": " << (failures ? "FAILED" : "ok") << "\n";
+	}
+};
+
+
+int main(int argc, char **argv) {
+	int cases = (argc > 1) ? atoi(argv[1]) : 600;
+
+	LZSSCompress encoder, decoder;
+	LegacyLZSS *legacy = new LegacyLZSS();
+
+	Check roundTrip("round trip"), oldReadsNew("old decoder reads new streams"), newReadsOld("new decoder reads old streams"), garbage("decoders agree on arbitrary bytes");
+
+	for (int i = 0; i < cases; i++) {
+		int kind = i % 6;
+		int level = 1 + (i / 6) % 9;
+		unsigned long len;
+		switch (next() % 8) {
+		case 0: len = next() % 20; break;
+		case 1: len = next() % 300; break;
+		case 7: len = next() % 70000; break;
+		default: len = next() % 12000; break;
+		}
+		Bytes text = generate(kind, len);
+
+		encoder.setLevel(level);
+		Bytes z = compress(encoder, text);
+		roundTrip.expect(decompress(decoder, z) == text, kind, len, level);
+
+		Bytes old;
+		legacy->decode(z.size() ? &z[0] : 0, z.size(), old);
+		oldReadsNew.expect(old == text, kind, len, level);
+
+		legacy->encode(text.size() ? &text[0] : 0, text.size(), old);
+		newReadsOld.expect(decompress(decoder, old) == text, kind, len, level);
+
+		// anything, or a stream cut short, decodes as the old decoder
+		// did: matches reaching before the text read its starting ring
+		Bytes junk = (i % 2) ? generate(0, next() % 3000) : Bytes(z.begin(), z.begin() + z.size() / 2);
+		Bytes expected;
+		LegacyLZSS *fresh = new LegacyLZSS();
+		fresh->decode(junk.size() ? &junk[0] : 0, junk.size(), expected);
+		delete fresh;
+		garbage.expect(decompress(decoder, junk) == expected, kind, junk.size(), 0);
+	}
+
+	roundTrip.report();
+	oldReadsNew.report();
+	newReadsOld.report();
+	garbage.report();
+
+	// greedy parsing of the longest match either way, so at full depth
+	// only ties and the old encoder's matches into its starting spaces
+	// make a difference
+	Bytes text = generate(3, 200000);
+	Bytes old;
+	legacy->encode(&text[0], text.size(), old);
+	cout << "sizes of " << text.size() << " bytes of words: old encoder " << old.size() << ", levels 1-9:";
+	for (int level = 1; level <= 9; level++) {
+		encoder.setLevel(level);
+		cout << " " << compress(encoder, text).size();
+	}
+	cout << "\n";
+
+	LZSSCompress tuned;
+	tuned.setLevel(3);
+	tuned.setSearchDepth(40);
+	SWCompress *copy = tuned.clone();
+	LZSSCompress *lzssCopy = dynamic_cast<LZSSCompress *>(copy);
+	cout << "clone keeps level and search depth: " << ((lzssCopy && copy->getLevel() == 3 && lzssCopy->getSearchDepth() == 40) ? "yes" : "no") << "\n";
+	delete copy;
+
+	cout << "search depth by level:";
+	for (int level = 1; level <= 9; level++) {
+		LZSSCompress byLevel;
+		byLevel.setLevel(level);
+		cout << " " << byLevel.getSearchDepth();
+	}
+	cout << "\n";
+
+	delete legacy;
+	return (roundTrip.failures || oldReadsNew.failures || newReadsOld.failures || garbage.failures) ? 1 : 0;
+}
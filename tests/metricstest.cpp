@@ -0,0 +1,90 @@
+/******************************************************************************
+ *
+ *  metricstest.cpp -	reads and searches a module with SWMetrics counting,
+ *			and prints what was counted
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <swmgr.h>
+#include <swmodule.h>
+#include <swmetrics.h>
+#include <listkey.h>
+
+using namespace std;
+using namespace sword;
+
+
+// times vary from run to run, so only say whether any were taken
+void printSnapshot() {
+	SWMetrics::Snapshot snapshot = SWMetrics::getSnapshot();
+	for (SWMetrics::Snapshot::const_iterator it = snapshot.begin(); it != snapshot.end(); ++it) {
+		// which file handles were still open varies with the platform
+		if (it->owner == "FileMgr") continue;
+		cout << "\t" << it->owner;
+		if (it->filter.size()) cout << "/" << it->filter;
+		cout << " " << it->name << "=";
+		if (it->name.endsWith("icros")) cout << "(time)";
+		else cout << it->value;
+		cout << "\n";
+	}
+}
+
+
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		cerr << "usage: " << *argv << " <modName> <key> [<search term>]\n";
+		exit(-1);
+	}
+
+	SWMgr library;
+	SWModule *module = library.getModule(argv[1]);
+	if (!module) {
+		cerr << "couldn't find module: " << argv[1] << "\n";
+		exit(-2);
+	}
+
+	// nothing is counted until asked for
+	module->setKey(argv[2]);
+	module->renderText();
+	cout << "disabled: " << SWMetrics::getSnapshot().size() << " samples\n";
+
+	SWMetrics::setEnabled(true);
+	module->setKey(argv[2]);
+	module->renderText();
+	module->stripText();
+	cout << "read " << argv[2] << ":\n";
+	printSnapshot();
+
+	if (argc > 3) {
+		SWMetrics::reset();
+		module->search(argv[3], -1);
+		cout << "search " << argv[3] << ":\n";
+		printSnapshot();
+	}
+
+	SWMetrics::setEnabled(false);
+	SWMetrics::reset();
+	cout << "reset: " << SWMetrics::getSnapshot().size() << " samples\n";
+	cout << "\n";
+
+	return 0;
+}
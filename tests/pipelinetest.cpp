@@ -0,0 +1,111 @@
+/******************************************************************************
+ *
+ *  pipelinetest.cpp -	runs text, good and bad UTF-8, through character
+ *			filters fused by a FilterPipeline and through each
+ *			filter's own pass, and checks the two agree
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <stdio.h>
+
+#include <filterpipeline.h>
+#include <utf8greekaccents.h>
+#include <utf8hebrewpoints.h>
+#include <utf8cantillation.h>
+#include <utf8arabicpoints.h>
+
+using namespace std;
+using namespace sword;
+
+
+int failures = 0;
+
+// the bytes of text, non-ASCII ones in hex
+SWBuf show(const SWBuf &text) {
+	SWBuf shown;
+	for (unsigned long i = 0; i < text.length(); ++i) {
+		unsigned char c = (unsigned char)text[i];
+		if (c < 0x80) shown += (char)c;
+		else shown.appendFormatted("<%.2X>", c);
+	}
+	return shown;
+}
+
+
+void test(const char *name, const OptionFilterList &filters, const char *text) {
+	FilterList none;
+	FilterPipeline pipeline;
+	pipeline.compile(&filters, &none);
+
+	SWBuf fused = text;
+	pipeline.processText(fused);
+
+	SWBuf separate = text;
+	for (OptionFilterList::const_iterator it = filters.begin(); it != filters.end(); ++it) {
+		(*it)->processText(separate);
+	}
+
+	cout << name << ", " << pipeline.getPassCount() << " pass: " << show(text) << " -> " << show(fused);
+	if (fused != separate) {
+		cout << " DIFFERS from " << show(separate);
+		++failures;
+	}
+	cout << "\n";
+}
+
+
+int main(int argc, char **argv) {
+	UTF8GreekAccents accents;
+	UTF8HebrewPoints points;
+	UTF8Cantillation cantillation;
+	UTF8ArabicPoints arabicPoints;
+	accents.setOptionValue("Off");
+	points.setOptionValue("Off");
+	cantillation.setOptionValue("Off");
+	arabicPoints.setOptionValue("Off");
+
+	// these pass bytes which aren't UTF-8 through
+	OptionFilterList hebrew;
+	hebrew.push_back(&cantillation);
+	hebrew.push_back(&points);
+	hebrew.push_back(&arabicPoints);
+
+	// the accent filter writes U+FFFD for them
+	OptionFilterList greek;
+	greek.push_back(&points);
+	greek.push_back(&accents);
+
+	const char *texts[] = {
+		"\xD7\x91\xD6\xB0\xD6\x91\xD7\xA8\xD6\xB5\xD7\x90\xD7\xA9\xD7\x81\xD6\xB4\xD7\x99\xD7\xAA",	// bereshit, pointed
+		"\xE1\xBC\x90\xCE\xBD \xE1\xBC\x80\xCF\x81\xCF\x87\xE1\xBF\x87",	// en arche, accented
+		"\xD7\x91\xD6\xB0 \xFF bad \xFE\xD6\xB0",	// bytes never in UTF-8
+		"\x80\xBF lone continuations \xD6\xB0\x80",
+		"cut short \xD7",
+		"cut short \xE1\xBC before a letter",
+		"overlong \xC0\xAF slash",
+		0
+	};
+	for (const char **text = texts; *text; ++text) {
+		test("hebrew", hebrew, *text);
+		test("greek", greek, *text);
+	}
+
+	return failures ? 1 : 0;
+}
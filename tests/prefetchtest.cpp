@@ -0,0 +1,152 @@
+/******************************************************************************
+ *
+ *  prefetchtest.cpp -	reads a compressed module forward, backward and
+ *			at random, with blocks read ahead, and checks each
+ *			entry against a read with reading ahead turned off
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+
+#include <swmgr.h>
+#include <swmodule.h>
+#include <swmetrics.h>
+#include <versekey.h>
+#include <blockprefetcher.h>
+
+using namespace std;
+using namespace sword;
+
+
+int failures = 0;
+
+void expect(bool ok, const char *what) {
+	cout << what << ": " << (ok ? "ok" : "FAILED") << "\n";
+	if (!ok) ++failures;
+}
+
+
+// each entry of the module, in order, and where it is
+struct Entry {
+	long index;
+	SWBuf text;
+};
+
+
+void readAll(const char *name, vector<Entry> &entries) {
+	SWMgr library;
+	SWModule *module = library.getModule(name);
+	if (!module) return;
+	for ((*module) = TOP; !module->popError(); (*module)++) {
+		Entry entry;
+		entry.index = module->getIndex();
+		entry.text = module->getRawEntry();
+		entries.push_back(entry);
+	}
+}
+
+
+unsigned long prefetchHits(const char *name) {
+	SWMetrics::Snapshot snapshot = SWMetrics::getSnapshot();
+	for (SWMetrics::Snapshot::const_iterator it = snapshot.begin(); it != snapshot.end(); ++it) {
+		if (it->owner == name && !it->filter.size() && it->name == SWMetrics::getCounterName(SWMetrics::PREFETCH_HITS)) return it->value;
+	}
+	return 0;
+}
+
+
+int testModule(const char *name) {
+	int depth = BlockPrefetcher::getDepth();
+	vector<Entry> expected;
+	BlockPrefetcher::setDepth(0);
+	readAll(name, expected);
+	BlockPrefetcher::setDepth(depth);
+	if (expected.empty()) {
+		cerr << "couldn't read module: " << name << "\n";
+		return -1;
+	}
+	cout << name << ": " << expected.size() << " entries\n";
+
+	SWMetrics::reset();
+	SWMetrics::setEnabled(true);
+
+	SWMgr library;
+	SWModule *module = library.getModule(name);
+	VerseKey *key = (VerseKey *)module->getKey();
+
+	// forward, as a search or an export reads
+	unsigned int i = 0;
+	int mismatches = 0;
+	for ((*module) = TOP; !module->popError() && i < expected.size(); (*module)++, ++i) {
+		if (module->getIndex() != expected[i].index || expected[i].text != module->getRawEntry()) ++mismatches;
+	}
+	expect(!mismatches && i == expected.size(), "forward");
+	unsigned long forwardHits = prefetchHits(name);
+	expect(forwardHits > 0, "blocks read ahead were used");
+
+	// backward, which never reads ahead
+	i = (unsigned int)expected.size();
+	mismatches = 0;
+	for ((*module) = BOTTOM; !module->popError() && i > 0; (*module)--) {
+		--i;
+		if (module->getIndex() != expected[i].index || expected[i].text != module->getRawEntry()) ++mismatches;
+	}
+	expect(!mismatches && !i, "backward");
+
+	// jumps to entries with text, each followed by a short run through
+	// the next ones, so reading ahead starts and is dropped again and again
+	vector<unsigned int> filled;
+	for (i = 0; i < expected.size(); ++i) {
+		if (expected[i].text.length()) filled.push_back(i);
+	}
+	unsigned long seed = 1;
+	mismatches = 0;
+	for (int jump = 0; jump < 500; ++jump) {
+		seed = seed * 1103515245 + 12345;
+		unsigned int f = (unsigned int)((seed >> 8) % filled.size());
+		unsigned int end = f + (unsigned int)((seed >> 4) % 8);
+		for (; f <= end && f < filled.size(); ++f) {
+			i = filled[f];
+			key->setIndex(expected[i].index);
+			if (module->getIndex() != expected[i].index || expected[i].text != module->getRawEntry()) ++mismatches;
+		}
+	}
+	expect(!mismatches, "random jumps");
+	expect(prefetchHits(name) > forwardHits, "blocks read ahead were used after jumps");
+
+	SWMetrics::setEnabled(false);
+	cout << "\n";
+	return 0;
+}
+
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		cerr << "usage: " << *argv << " <modName>...\n";
+		exit(-1);
+	}
+
+	for (int i = 1; i < argc; ++i) {
+		if (testModule(argv[i])) return 1;
+	}
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,246 @@
+/******************************************************************************
+ *
+ *  remotetranstest.cpp -	runs the transfers of RemoteTransport and
+ *				InstallMgr against a stand-in HTTP server on
+ *				the loopback interface: pooled, reused, resumed
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <remotetrans.h>
+#include <installmgr.h>
+#include <filemgr.h>
+#include <swbuf.h>
+
+#include "standinserver.h"
+
+using namespace sword;
+using namespace std;
+
+
+// gathers what a copy reports
+class Reporter : public StatusReporter {
+public:
+	int preStatusCount;
+	unsigned long lastTotal, lastCompleted;
+	bool backwards;
+
+	Reporter() { reset(); }
+	void reset() { preStatusCount = 0; lastTotal = lastCompleted = 0; backwards = false; }
+
+	virtual void preStatus(long totalBytes, long completedBytes, const char *message) {
+		preStatusCount++;
+	}
+	virtual void update(unsigned long totalBytes, unsigned long completedBytes) {
+		if (completedBytes < lastCompleted) backwards = true;
+		lastTotal = totalBytes;
+		lastCompleted = completedBytes;
+	}
+};
+
+
+// only to get at the transports InstallMgr makes
+class TestInstallMgr : public InstallMgr {
+public:
+	TestInstallMgr(const char *privatePath) : InstallMgr(privatePath) {}
+	RemoteTransport *newHTTPTransport(const char *host, StatusReporter *statusReporter) {
+		return createHTTPTransport(host, statusReporter);
+	}
+};
+
+
+SWBuf someBytes(unsigned long len, unsigned long seed) {
+	SWBuf bytes;
+	bytes.setSize(len);
+	for (unsigned long i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		bytes[i] = (char)(seed >> 16);
+	}
+	return bytes;
+}
+
+
+bool sameFiles(StandInServer &server, const SWBuf &dir, const char *localDir) {
+	bool same = true;
+	for (map<SWBuf, SWBuf>::const_iterator it = server.files.begin(); it != server.files.end(); ++it) {
+		SWBuf localPath = SWBuf(localDir) + (it->first.c_str() + dir.length());
+		SWBuf contents;
+		FILE *file = fopen(localPath, "rb");
+		if (file) {
+			char buf[4096];
+			size_t got;
+			// append() would stop at a 0
+			while ((got = fread(buf, 1, sizeof(buf), file)) > 0) {
+				unsigned long size = contents.size();
+				contents.setSize(size + got);
+				memcpy(contents.getRawData() + size, buf, got);
+			}
+			fclose(file);
+		}
+		if (contents.length() != it->second.length() || memcmp(contents.c_str(), it->second.c_str(), contents.length())) {
+			cout << "  " << localPath << " differs\n";
+			same = false;
+		}
+		if (FileMgr::existsFile(localPath + ".part")) {
+			cout << "  " << localPath << ".part left behind\n";
+			same = false;
+		}
+	}
+	return same;
+}
+
+
+int main(int argc, char **argv) {
+	SWBuf tmp = (argc > 1) ? argv[1] : "tmp/remotetrans";
+
+	StandInServer server;
+	const SWBuf dir = "/repo/modules/texts/ztext/test/";
+	server.files[dir + "ot.bzs"] = someBytes(120000, 1);
+	server.files[dir + "ot.bzv"] = someBytes(40000, 2);
+	server.files[dir + "ot.bzz"] = someBytes(250000, 3);
+	server.files[dir + "nt.bzs"] = someBytes(3, 4);
+	server.files[dir + "nt.bzv"] = "";
+	server.files[dir + "extra/notes.dat"] = someBytes(90000, 5);
+	server.files[dir + "extra/more/deeper.dat"] = someBytes(1000, 6);
+	unsigned long totalBytes = 0;
+	for (map<SWBuf, SWBuf>::const_iterator it = server.files.begin(); it != server.files.end(); ++it) {
+		totalBytes += it->second.length();
+	}
+
+	SWBuf host;
+	host.setFormatted("127.0.0.1:%d", server.port);
+	SWBuf urlPrefix = SWBuf("http://") + host;
+
+	TestInstallMgr installMgr(tmp + "/installmgr");
+	installMgr.setUserDisclaimerConfirmed(true);
+
+	Reporter reporter;
+	RemoteTransport *transport = installMgr.newHTTPTransport(host, &reporter);
+	if (!transport) {
+		cout << "no HTTP transport in this build\n";
+		return 1;
+	}
+
+	cout << "four at once:\n";
+	int retVal = transport->copyDirectory(urlPrefix, "/repo/modules/texts/ztext/test", tmp + "/pooled", "");
+	cout << "  returned " << retVal << "\n";
+	bool same = sameFiles(server, dir, tmp + "/pooled/");
+	cout << "  files match: " << (same ? "yes" : "no") << "\n";
+	cout << "  more than one at once: " << ((server.maxInFlight > 1) ? "yes" : "no") << "\n";
+	cout << "  no more than four at once: " << ((server.maxInFlight <= 4) ? "yes" : "no") << "\n";
+	cout << "  connections: " << server.connectionCount << "\n";
+	cout << "  announced: " << reporter.preStatusCount << "\n";
+	cout << "  progress reached the total: " << ((reporter.lastTotal == totalBytes && reporter.lastCompleted == totalBytes) ? "yes" : "no") << "\n";
+	cout << "  progress never went back: " << (!reporter.backwards ? "yes" : "no") << "\n";
+
+	cout << "again, on the same connections:\n";
+	int connections = server.connectionCount;
+	retVal = transport->copyDirectory(urlPrefix, "/repo/modules/texts/ztext/test", tmp + "/again", "");
+	cout << "  returned " << retVal << "\n";
+	same = sameFiles(server, dir, tmp + "/again/");
+	cout << "  files match: " << (same ? "yes" : "no") << "\n";
+	cout << "  new connections: " << server.connectionCount - connections << "\n";
+
+	cout << "cut off, then resumed:\n";
+	server.resetCounts();
+	server.breakPath = dir + "ot.bzz";
+	retVal = transport->copyDirectory(urlPrefix, "/repo/modules/texts/ztext/test", tmp + "/resumed", "");
+	cout << "  first try failed: " << (retVal ? "yes" : "no") << "\n";
+	cout << "  part left: " << FileMgr::getFileSize(tmp + "/resumed/ot.bzz.part") << "\n";
+	retVal = transport->copyDirectory(urlPrefix, "/repo/modules/texts/ztext/test", tmp + "/resumed", "");
+	cout << "  returned " << retVal << "\n";
+	for (unsigned int i = 0; i < server.ranges.size(); i++) {
+		cout << "  asked for " << server.ranges[i].c_str() + dir.length() << "\n";
+	}
+	same = sameFiles(server, dir, tmp + "/resumed/");
+	cout << "  files match: " << (same ? "yes" : "no") << "\n";
+
+	cout << "cut off, then the file changed before resuming:\n";
+	server.resetCounts();
+	server.breakPath = dir + "ot.bzz";
+	retVal = transport->copyDirectory(urlPrefix, "/repo/modules/texts/ztext/test", tmp + "/changed", "");
+	cout << "  first try failed: " << (retVal ? "yes" : "no") << "\n";
+	cout << "  part left: " << FileMgr::getFileSize(tmp + "/changed/ot.bzz.part") << "\n";
+	cout << "  validator kept: " << (FileMgr::existsFile(tmp + "/changed/ot.bzz.part.validator") ? "yes" : "no") << "\n";
+	SWBuf original = server.files[dir + "ot.bzz"];
+	server.files[dir + "ot.bzz"] = someBytes(260000, 7);
+	server.resetCounts();
+	retVal = transport->copyDirectory(urlPrefix, "/repo/modules/texts/ztext/test", tmp + "/changed", "");
+	cout << "  returned " << retVal << "\n";
+	for (unsigned int i = 0; i < server.ranges.size(); i++) {
+		cout << "  asked for " << server.ranges[i].c_str() + dir.length() << "\n";
+	}
+	same = sameFiles(server, dir, tmp + "/changed/");
+	cout << "  files match the new version: " << (same ? "yes" : "no") << "\n";
+	cout << "  validator left behind: " << (FileMgr::existsFile(tmp + "/changed/ot.bzz.part.validator") ? "yes" : "no") << "\n";
+	server.files[dir + "ot.bzz"] = original;
+
+	cout << "a part with nothing to say what it's part of:\n";
+	server.resetCounts();
+	FileMgr::removeFile(tmp + "/changed/ot.bzz");
+	FileMgr::copyFile(tmp + "/resumed/ot.bzz", tmp + "/changed/ot.bzz.part");
+	retVal = transport->copyDirectory(urlPrefix, "/repo/modules/texts/ztext/test", tmp + "/changed", "");
+	cout << "  returned " << retVal << "\n";
+	cout << "  range requests: " << server.ranges.size() << "\n";
+	same = sameFiles(server, dir, tmp + "/changed/");
+	cout << "  files match: " << (same ? "yes" : "no") << "\n";
+
+	cout << "a server that won't resume:\n";
+	server.resetCounts();
+	server.refuseRanges = true;
+	server.breakPath = dir + "ot.bzs";
+	transport->copyDirectory(urlPrefix, "/repo/modules/texts/ztext/test", tmp + "/refused", "");
+	retVal = transport->copyDirectory(urlPrefix, "/repo/modules/texts/ztext/test", tmp + "/refused", "");
+	cout << "  returned " << retVal << "\n";
+	cout << "  range requests: " << server.ranges.size() << "\n";
+	same = sameFiles(server, dir, tmp + "/refused/");
+	cout << "  files match: " << (same ? "yes" : "no") << "\n";
+	server.refuseRanges = false;
+
+	cout << "one at a time:\n";
+	server.resetCounts();
+	reporter.reset();
+	transport->setMaxTransfers(1);
+	retVal = transport->copyDirectory(urlPrefix, "/repo/modules/texts/ztext/test", tmp + "/serial", ".bzs");
+	cout << "  returned " << retVal << "\n";
+	cout << "  at once: " << server.maxInFlight << "\n";
+	cout << "  announced: " << reporter.preStatusCount << "\n";
+	cout << "  got ot.bzs and nt.bzs only: " << ((FileMgr::existsFile(tmp + "/serial/ot.bzs") && FileMgr::existsFile(tmp + "/serial/nt.bzs") && !FileMgr::existsFile(tmp + "/serial/ot.bzv")) ? "yes" : "no") << "\n";
+	delete transport;
+
+	cout << "InstallMgr, copy after copy:\n";
+	InstallSource is("HTTP");
+	is.source = host;
+	is.directory = "/repo";
+	connections = server.connectionCount;
+	retVal = installMgr.remoteCopy(&is, "modules/texts/ztext/test/ot.bzv", tmp + "/installmgr/ot.bzv");
+	retVal |= installMgr.remoteCopy(&is, "modules/texts/ztext/test/nt.bzs", tmp + "/installmgr/nt.bzs");
+	retVal |= installMgr.remoteCopy(&is, "modules/texts/ztext/test/extra", tmp + "/installmgr/extra", true);
+	cout << "  returned " << retVal << "\n";
+	cout << "  new connections: " << server.connectionCount - connections << "\n";
+	cout << "  notes.dat matches: " << ((FileMgr::getFileSize(tmp + "/installmgr/extra/notes.dat") == 90000) ? "yes" : "no") << "\n";
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+/******************************************************************************
+ *
+ *  searchpagetest.cpp -	runs searches against a module in one go and
+ *			then again a few hits at a time with a SearchCursor,
+ *			so the two can be compared
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <regex.h>
+
+#include <swmgr.h>
+#include <swmodule.h>
+#include <listkey.h>
+
+using namespace std;
+using namespace sword;
+
+
+bool printHit(const SWKey &hit, void *userData) {
+	cout << hit.getShortText() << "; ";
+	++*(int *)userData;
+	return true;
+}
+
+
+int main(int argc, char **argv) {
+	if (argc < 5) {
+		cerr << "usage: " << *argv << " <modName> <searchType>[i] <pageSize> <search term>...\n";
+		cerr << "\ta searchType ending with i ignores case\n";
+		exit(-1);
+	}
+
+	SWMgr library;
+	SWModule *module = library.getModule(argv[1]);
+	if (!module) {
+		cerr << "couldn't find module: " << argv[1] << "\n";
+		exit(-2);
+	}
+	int searchType = atoi(argv[2]);
+	int flags = (argv[2][strlen(argv[2])-1] == 'i') ? REG_ICASE : 0;
+	int pageSize = atoi(argv[3]);
+
+	for (int i = 4; i < argc; ++i) {
+		SWBuf all;
+		ListKey &results = module->search(argv[i], searchType, flags);
+		for (results = TOP; !results.popError(); results++) {
+			all += results.getShortText();
+			all += "; ";
+		}
+		cout << argv[i] << ": " << all << "\n";
+
+		SWBuf paged;
+		int streamed = 0;
+		SearchCursor cursor(pageSize, 0, &printHit, &streamed);
+		for (int page = 1; !cursor.isComplete(); ++page) {
+			cout << "\tpage " << page << ": ";
+			ListKey &pageResults = module->search(cursor, argv[i], searchType, flags);
+			for (pageResults = TOP; !pageResults.popError(); pageResults++) {
+				paged += pageResults.getShortText();
+				paged += "; ";
+			}
+			cout << "\n";
+		}
+		cout << "\t" << streamed << " streamed; " << ((paged == all) ? "pages match" : "pages DIFFER") << "\n";
+	}
+
+	return 0;
+}
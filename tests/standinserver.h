@@ -0,0 +1,287 @@
+/******************************************************************************
+ *
+ *  standinserver.h -	class StandInServer: a small HTTP server on the
+ *			loopback interface, standing in for a remote module
+ *			repository in the tests of RemoteTransport and
+ *			InstallMgr
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef STANDINSERVER_H
+#define STANDINSERVER_H
+
+#include <map>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <filemgr.h>
+#include <swthread.h>
+#include <swbuf.h>
+
+
+// Serves files from memory over HTTP/1.1 with keep-alive, byte ranges,
+// ETags and If-Range, and directory listings like Apache's.  It holds each body back a little, so
+// transfers run at once really do overlap, and counts what it is asked.
+class StandInServer {
+
+	struct Connection {
+		StandInServer *server;
+		int fd;
+		sword::SWThread thread;
+	};
+
+	int listenFd;
+	bool stopping;
+	sword::SWThread acceptThread;
+	std::vector<Connection *> connections;
+
+public:
+	std::map<sword::SWBuf, sword::SWBuf> files;
+	unsigned short port;
+
+	sword::SWMutex lock;
+	int connectionCount;
+	int inFlight;
+	int maxInFlight;
+	std::vector<sword::SWBuf> ranges;		// "path from offset", or "path first-last", for each range asked for
+	unsigned long bytesSent;	// of bodies, for files and ranges of them
+	std::vector<sword::SWBuf> requests;	// the path of each request
+	sword::SWBuf breakPath;		// the next plain GET of this is cut off half way
+	bool refuseRanges;		// answer range requests with the whole file
+
+	StandInServer() : stopping(false), connectionCount(0), inFlight(0), maxInFlight(0), bytesSent(0), refuseRanges(false) {
+		listenFd = socket(AF_INET, SOCK_STREAM, 0);
+		int on = 1;
+		setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+		bind(listenFd, (struct sockaddr *)&addr, sizeof(addr));
+		socklen_t len = sizeof(addr);
+		getsockname(listenFd, (struct sockaddr *)&addr, &len);
+		port = ntohs(addr.sin_port);
+		listen(listenFd, 16);
+		acceptThread.start(acceptLoop, this);
+	}
+
+	~StandInServer() {
+		stopping = true;
+		acceptThread.join();
+		for (unsigned int i = 0; i < connections.size(); i++) {
+			shutdown(connections[i]->fd, SHUT_RDWR);
+			connections[i]->thread.join();
+			close(connections[i]->fd);
+			delete connections[i];
+		}
+		close(listenFd);
+	}
+
+	void resetCounts() {
+		sword::SWMutex::Locker locker(lock);
+		maxInFlight = 0;
+		bytesSent = 0;
+		ranges.clear();
+		requests.clear();
+	}
+
+	/** serves the files under localDir, and its subdirectories, as urlDir */
+	void addDirectory(const char *urlDir, const char *localDir) {
+		std::vector<sword::DirEntry> entries = sword::FileMgr::getDirList(localDir);
+		for (unsigned int i = 0; i < entries.size(); i++) {
+			sword::SWBuf localPath = sword::SWBuf(localDir) + "/" + entries[i].name;
+			sword::SWBuf urlPath = sword::SWBuf(urlDir) + "/" + entries[i].name;
+			if (entries[i].isDirectory) {
+				addDirectory(urlPath, localPath);
+				continue;
+			}
+			sword::SWBuf &contents = files[urlPath];
+			contents = "";
+			FILE *file = fopen(localPath, "rb");
+			if (!file) continue;
+			char buf[4096];
+			size_t got;
+			while ((got = fread(buf, 1, sizeof(buf), file)) > 0) {
+				unsigned long size = contents.size();
+				contents.setSize(size + got);
+				memcpy(contents.getRawData() + size, buf, got);
+			}
+			fclose(file);
+		}
+	}
+
+private:
+	static void acceptLoop(void *userData) {
+		StandInServer *server = (StandInServer *)userData;
+		while (!server->stopping) {
+			fd_set readable;
+			FD_ZERO(&readable);
+			FD_SET(server->listenFd, &readable);
+			struct timeval wait = { 0, 50000 };
+			if (select(server->listenFd + 1, &readable, 0, 0, &wait) < 1) continue;
+			int fd = accept(server->listenFd, 0, 0);
+			if (fd < 0) continue;
+			Connection *connection = new Connection;
+			connection->server = server;
+			connection->fd = fd;
+			{
+				sword::SWMutex::Locker locker(server->lock);
+				server->connectionCount++;
+				server->connections.push_back(connection);
+			}
+			connection->thread.start(serve, connection);
+		}
+	}
+
+	// differs, as a real server's would, when the contents do
+	static sword::SWBuf etag(const sword::SWBuf &body) {
+		unsigned int hash = 2166136261U;
+		for (unsigned long i = 0; i < body.length(); i++) {
+			hash ^= (unsigned char)body[i];
+			hash *= 16777619U;
+		}
+		return sword::SWBuf().setFormatted("\"%lx-%x\"", (unsigned long)body.length(), hash);
+	}
+
+	static bool sendAll(int fd, const char *buf, unsigned long len) {
+		while (len) {
+			long sent = send(fd, buf, len, MSG_NOSIGNAL);
+			if (sent <= 0) return false;
+			buf += sent;
+			len -= sent;
+		}
+		return true;
+	}
+
+	sword::SWBuf listing(const sword::SWBuf &dir) {
+		sword::SWBuf html = "<html><body><table>\n";
+		std::map<sword::SWBuf, unsigned long> entries;
+		for (std::map<sword::SWBuf, sword::SWBuf>::const_iterator it = files.begin(); it != files.end(); ++it) {
+			if (!it->first.startsWith(dir)) continue;
+			sword::SWBuf rest = it->first.c_str() + dir.length();
+			const char *slash = strchr(rest.c_str(), '/');
+			if (slash) {
+				sword::SWBuf subDir;
+				subDir.append(rest.c_str(), slash - rest.c_str() + 1);
+				entries[subDir] = 0;
+			}
+			else entries[rest] = it->second.length();
+		}
+		for (std::map<sword::SWBuf, unsigned long>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+			html.appendFormatted("<tr><td><a href=\"%s\">%s</a></td><td>2026-01-01 00:00</td><td>%lu</td></tr>\n", it->first.c_str(), it->first.c_str(), it->second);
+		}
+		html += "</table></body></html>\n";
+		return html;
+	}
+
+	static void serve(void *userData) {
+		Connection *connection = (Connection *)userData;
+		StandInServer *server = connection->server;
+		sword::SWBuf pending;
+		char buf[4096];
+		for (;;) {
+			// a whole request, headers and all
+			const char *end;
+			while (!(end = strstr(pending.c_str(), "\r\n\r\n"))) {
+				long got = recv(connection->fd, buf, sizeof(buf), 0);
+				if (got <= 0) return;
+				pending.append(buf, got);
+			}
+			sword::SWBuf request;
+			request.append(pending.c_str(), end - pending.c_str());
+			pending = end + 4;
+
+			char path[1024] = "";
+			sscanf(request.c_str(), "GET %1023s", path);
+			long from = -1, to = -1;
+			const char *range = strstr(request.c_str(), "Range: bytes=");
+			if (range) sscanf(range + 13, "%ld-%ld", &from, &to);
+			char ifRange[256] = "";
+			const char *ifRangeHeader = strstr(request.c_str(), "If-Range: ");
+			if (ifRangeHeader) sscanf(ifRangeHeader + 10, "%255[^\r]", ifRange);
+
+			sword::SWBuf body;
+			bool found = true;
+			bool cutOff = false;
+			if (sword::SWBuf(path).endsWith("/")) body = server->listing(path);
+			else if (server->files.find(path) != server->files.end()) body = server->files[path];
+			else found = false;
+
+			{
+				sword::SWMutex::Locker locker(server->lock);
+				server->requests.push_back(path);
+				if (range && to < 0) server->ranges.push_back(sword::SWBuf().setFormatted("%s from %ld", path, from));
+				else if (range) server->ranges.push_back(sword::SWBuf().setFormatted("%s %ld-%ld", path, from, to));
+				if (from < 0 && server->breakPath == path) {
+					server->breakPath = "";
+					cutOff = true;
+				}
+				if (++server->inFlight > server->maxInFlight) server->maxInFlight = server->inFlight;
+			}
+			usleep(30000);
+
+			sword::SWBuf header;
+			unsigned long offset = 0;
+			unsigned long last = body.length();
+			if (!found) {
+				header = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+				body = "";
+			}
+			else if (from >= 0 && !server->refuseRanges && (!ifRangeHeader || etag(body) == ifRange)) {
+				if ((unsigned long)from >= body.length()) {
+					header.setFormatted("HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */%lu\r\nContent-Length: 0\r\n\r\n", (unsigned long)body.length());
+					body = "";
+				}
+				else {
+					offset = from;
+					if (to >= from && (unsigned long)to < body.length()) last = to + 1;
+					header.setFormatted("HTTP/1.1 206 Partial Content\r\nETag: %s\r\nContent-Range: bytes %lu-%lu/%lu\r\nContent-Length: %lu\r\n\r\n",
+						etag(body).c_str(), offset, last - 1, (unsigned long)body.length(), last - offset);
+				}
+			}
+			else header.setFormatted("HTTP/1.1 200 OK\r\nETag: %s\r\nContent-Length: %lu\r\n\r\n", etag(body).c_str(), (unsigned long)body.length());
+
+			bool sent = sendAll(connection->fd, header.c_str(), header.length());
+			if (cutOff) last = body.length() / 2;
+			if (sent) sendAll(connection->fd, body.c_str() + offset, last - offset);
+
+			{
+				sword::SWMutex::Locker locker(server->lock);
+				server->inFlight--;
+				if (sent) server->bytesSent += last - offset;
+			}
+			if (!sent || cutOff) {
+				shutdown(connection->fd, SHUT_RDWR);
+				return;
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,161 @@
+/******************************************************************************
+ *
+ *  stripbench.cpp -	compares stripText() throughput of the compiled
+ *			filter pipeline against running each option and
+ *			strip filter as its own pass, as stripText() used to
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <chrono>
+
+#include <swmgr.h>
+#include <swmodule.h>
+#include <filterpipeline.h>
+
+using namespace sword;
+
+using std::vector;
+
+
+void usage(const char *app) {
+	fprintf(stderr, "usage: %s [-o \"option name\" value]... [-p passes] [modName]...\n", app);
+	fprintf(stderr, "\twithout modName, every installed OSIS, ThML and GBF module is measured\n");
+	fprintf(stderr, "\te.g., %s -o \"Greek Accents\" Off -o \"Hebrew Vowel Points\" Off\n", app);
+	exit(-1);
+}
+
+
+// what stripText() did before the filter pipeline
+SWBuf legacyStripText(SWModule *module, const char *buf) {
+	bool savePEA = module->isProcessEntryAttributes();
+	module->setProcessEntryAttributes(false);
+	SWBuf local = buf;
+	module->optionFilter(local, module->getKey());
+	module->stripFilter(local, module->getKey());
+	module->setProcessEntryAttributes(savePEA);
+	return local;
+}
+
+
+double elapsed(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+void bench(SWModule *module, int passes) {
+	vector<SWBuf> entries;
+	unsigned long bytes = 0;
+
+	module->setProcessEntryAttributes(false);
+	for ((*module) = TOP; !module->popError(); (*module)++) {
+		// stripText() doesn't filter empty entries at all; leave them out so we compare filtering alone
+		SWBuf raw = module->getRawEntry();
+		if (!raw.length()) continue;
+		entries.push_back(raw);
+		bytes += raw.length();
+	}
+	if (entries.empty()) return;
+
+	// the old way: every filter is a full pass, idle or not
+	double oldTime = 0;
+	vector<SWBuf> oldResults(entries.size());
+	for (int pass = 0; pass < passes; ++pass) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < entries.size(); ++i) {
+			oldResults[i] = legacyStripText(module, entries[i].c_str());
+		}
+		oldTime += elapsed(start);
+	}
+
+	double newTime = 0;
+	vector<SWBuf> newResults(entries.size());
+	for (int pass = 0; pass < passes; ++pass) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < entries.size(); ++i) {
+			newResults[i] = module->stripText(entries[i].c_str(), (int)entries[i].length());
+		}
+		newTime += elapsed(start);
+	}
+
+	int mismatches = 0;
+	for (unsigned int i = 0; i < entries.size(); ++i) {
+		if (newResults[i] != oldResults[i]) ++mismatches;
+	}
+
+	FilterPipeline pipeline;
+	OptionFilterList options = module->getOptionFilters();
+	FilterList none;
+	pipeline.compile(&options, &none);
+
+	double mb = (double)bytes * passes / (1024 * 1024);
+	printf("%-16s %-5s %7lu entries %8.2f MiB  old %8.2f MiB/s  new %8.2f MiB/s  x%.2f  option passes %d of %lu  mismatches %d\n",
+			module->getName(), module->getConfigEntry("SourceType") ? module->getConfigEntry("SourceType") : "?",
+			(unsigned long)entries.size(), (double)bytes / (1024 * 1024),
+			mb / oldTime, mb / newTime, oldTime / newTime,
+			pipeline.getPassCount(), (unsigned long)options.size(), mismatches);
+}
+
+
+int main(int argc, char **argv) {
+	SWMgr library;
+	vector<SWBuf> modNames;
+	int passes = 3;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "-o")) {
+			if (i + 2 >= argc) usage(*argv);
+			library.setGlobalOption(argv[i+1], argv[i+2]);
+			i += 2;
+		}
+		else if (!strcmp(argv[i], "-p")) {
+			if (i + 1 >= argc) usage(*argv);
+			passes = atoi(argv[++i]);
+			if (passes < 1) usage(*argv);
+		}
+		else if (argv[i][0] == '-') usage(*argv);
+		else modNames.push_back(argv[i]);
+	}
+
+	if (modNames.empty()) {
+		for (ModMap::iterator it = library.Modules.begin(); it != library.Modules.end(); ++it) {
+			SWBuf sourceType = it->second->getConfigEntry("SourceType");
+			if (sourceType == "OSIS" || sourceType == "ThML" || sourceType == "GBF") {
+				modNames.push_back(it->first);
+			}
+		}
+	}
+	if (modNames.empty()) {
+		fprintf(stderr, "%s: no OSIS, ThML or GBF modules found\n", *argv);
+		usage(*argv);
+	}
+
+	for (vector<SWBuf>::iterator it = modNames.begin(); it != modNames.end(); ++it) {
+		SWModule *module = library.getModule(*it);
+		if (!module) {
+			fprintf(stderr, "%s: couldn't find module: %s\n", *argv, it->c_str());
+			continue;
+		}
+		bench(module, passes);
+	}
+
+	return 0;
+}
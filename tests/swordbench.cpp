@@ -0,0 +1,396 @@
+/******************************************************************************
+ *
+ *  swordbench.cpp -	times verse lookup, chapter rendering, searching,
+ *			verse parsing, UTF-8 conversion and SWMgr startup
+ *			against the modules in a directory, and writes the
+ *			results as JSON.
+ *			swordbench.sh builds a module for each driver from
+ *			the testsuite's sources and runs this over them.
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+
+#include <swmgr.h>
+#include <swmodule.h>
+#include <swversion.h>
+#include <markupfiltmgr.h>
+#include <versekey.h>
+#include <listkey.h>
+#include <utilstr.h>
+
+using namespace sword;
+
+using std::vector;
+
+
+void usage(const char *app) {
+	fprintf(stderr, "usage: %s [-p passes] [-o output.json] <modulesPath>\n", app);
+	fprintf(stderr, "\tmodulesPath holds mods.d/ and the modules to measure; see swordbench.sh\n");
+	fprintf(stderr, "\teach measurement is taken passes times (default 5) and the best is kept\n");
+	exit(-1);
+}
+
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsed(Clock::time_point start) {
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+
+// the same "random" verses on every run, so runs can be compared
+unsigned long nextRandom(unsigned long &seed) {
+	seed = seed * 1103515245 + 12345;
+	return (seed / 65536) % 32768;
+}
+
+
+SWBuf jsonString(const char *text) {
+	SWBuf retVal = "\"";
+	for (const unsigned char *c = (const unsigned char *)text; *c; ++c) {
+		if (*c == '"' || *c == '\\') retVal.appendFormatted("\\%c", *c);
+		else if (*c < 0x20) retVal.appendFormatted("\\u%04x", *c);
+		else retVal.append((char)*c);
+	}
+	retVal += "\"";
+	return retVal;
+}
+
+
+/**
+ * Collects results and writes them out.  A benchmark is named by what it
+ * does ("lookup.random"), what it did it to (a module, or "" for none), and
+ * a variant (a markup, a search type), and reports how many operations one
+ * pass did and how long the best pass took.
+ */
+class Results {
+	struct Result {
+		SWBuf name;
+		SWBuf module;
+		SWBuf driver;
+		SWBuf variant;
+		unsigned long ops;
+		double seconds;
+		double meanSeconds;
+	};
+	vector<Result> results;
+
+public:
+	int passes;
+
+	Results() : passes(5) {}
+
+	template <class Work>
+	void run(const char *name, SWModule *module, const char *variant, Work work) {
+		Result result;
+		result.name = name;
+		result.module = (module) ? module->getName() : "";
+		result.driver = (module && module->getConfigEntry("ModDrv")) ? module->getConfigEntry("ModDrv") : "";
+		result.variant = variant;
+		result.ops = 0;
+		result.seconds = 0;
+		double total = 0;
+		for (int pass = 0; pass < passes; ++pass) {
+			Clock::time_point start = Clock::now();
+			result.ops = work();
+			double seconds = elapsed(start);
+			total += seconds;
+			if (!pass || seconds < result.seconds) result.seconds = seconds;
+		}
+		result.meanSeconds = total / passes;
+		results.push_back(result);
+		fprintf(stderr, "%-22s %-16s %-10s %8lu ops %10.6f s\n", name, result.module.c_str(), variant, result.ops, result.seconds);
+	}
+
+	void add(const char *name, const char *variant, unsigned long ops, double seconds) {
+		Result result;
+		result.name = name;
+		result.variant = variant;
+		result.ops = ops;
+		result.seconds = seconds;
+		result.meanSeconds = seconds;
+		results.push_back(result);
+		fprintf(stderr, "%-22s %-16s %-10s %8lu ops %10.6f s\n", name, "", variant, ops, seconds);
+	}
+
+	void write(FILE *out) const {
+		fprintf(out, "{\n");
+		fprintf(out, "\t\"swordVersion\": %s,\n", jsonString(SWVersion::currentVersion.getText()).c_str());
+		fprintf(out, "\t\"passes\": %d,\n", passes);
+		fprintf(out, "\t\"benchmarks\": [\n");
+		for (unsigned int i = 0; i < results.size(); ++i) {
+			const Result &r = results[i];
+			fprintf(out, "\t\t{ \"name\": %s, \"module\": %s, \"driver\": %s, \"variant\": %s, \"ops\": %lu, \"seconds\": %.9f, \"meanSeconds\": %.9f, \"opsPerSecond\": %.1f }%s\n",
+					jsonString(r.name).c_str(), jsonString(r.module).c_str(), jsonString(r.driver).c_str(), jsonString(r.variant).c_str(),
+					r.ops, r.seconds, r.meanSeconds, (r.seconds > 0) ? r.ops / r.seconds : 0.0,
+					(i + 1 < results.size()) ? "," : "");
+		}
+		fprintf(out, "\t]\n");
+		fprintf(out, "}\n");
+	}
+};
+
+
+// every key of a module, as text, in module order
+vector<SWBuf> getKeys(SWModule *module) {
+	vector<SWBuf> keys;
+	for ((*module) = TOP; !module->popError(); (*module)++) {
+		keys.push_back(module->getKeyText());
+	}
+	return keys;
+}
+
+
+void benchLookup(Results &results, SWModule *module) {
+	results.run("lookup.sequential", module, "", [module]() {
+		unsigned long ops = 0;
+		for ((*module) = TOP; !module->popError(); (*module)++) {
+			module->getRawEntryBuf();
+			++ops;
+		}
+		return ops;
+	});
+
+	// verses by index, others by the text of their key
+	VerseKey *vk = SWDYNAMIC_CAST(VerseKey, module->getKey());
+	vector<SWBuf> keys;
+	long lowIndex = 0, highIndex = 0;
+	if (vk) {
+		module->setPosition(TOP);
+		lowIndex = vk->getIndex();
+		module->setPosition(BOTTOM);
+		highIndex = vk->getIndex();
+	}
+	else keys = getKeys(module);
+	const unsigned long lookups = 10000;
+
+	results.run("lookup.random", module, "", [module, vk, &keys, lowIndex, highIndex, lookups]() {
+		unsigned long seed = 1;
+		for (unsigned long i = 0; i < lookups; ++i) {
+			unsigned long r = nextRandom(seed) * 32768 + nextRandom(seed);
+			if (vk) vk->setIndex(lowIndex + (long)(r % (highIndex - lowIndex + 1)));
+			else if (keys.size()) module->setKey(keys[r % keys.size()].c_str());
+			module->getRawEntryBuf();
+		}
+		return lookups;
+	});
+}
+
+
+void benchRender(Results &results, const char *modulesPath) {
+	static const struct { char markup; const char *name; } markups[] = {
+		{ FMT_PLAIN, "plain" },
+		{ FMT_THML, "thml" },
+		{ FMT_GBF, "gbf" },
+		{ FMT_HTML, "html" },
+		{ FMT_HTMLHREF, "htmlhref" },
+		{ FMT_RTF, "rtf" },
+		{ FMT_OSIS, "osis" },
+		{ FMT_WEBIF, "webif" },
+		{ FMT_TEI, "tei" },
+		{ FMT_XHTML, "xhtml" },
+		{ FMT_LATEX, "latex" },
+		{ 0, 0 }
+	};
+
+	for (int i = 0; markups[i].name; ++i) {
+		SWMgr library(modulesPath, true, new MarkupFilterMgr(markups[i].markup));
+		library.setGlobalOption("Footnotes", "On");
+		library.setGlobalOption("Strong's Numbers", "On");
+		library.setGlobalOption("Morphological Tags", "On");
+		library.setGlobalOption("Headings", "On");
+		library.setGlobalOption("Words of Christ in Red", "On");
+		for (ModMap::iterator it = library.getModules().begin(); it != library.getModules().end(); ++it) {
+			SWModule *module = it->second;
+			if (!SWDYNAMIC_CAST(VerseKey, module->getKey())) continue;
+			results.run("render.chapter", module, markups[i].name, [module]() {
+				unsigned long ops = 0;
+				const char *chapters[] = { "Gen 1", "Ps 3", "Acts 2", 0 };
+				for (int c = 0; chapters[c]; ++c) {
+					// setting a key from text may replace the module's key
+					module->setKey(chapters[c]);
+					VerseKey *vk = (VerseKey *)module->getKey();
+					int chapter = vk->getChapter();
+					for (; !module->popError() && vk->getChapter() == chapter; (*module)++) {
+						module->renderText();
+						++ops;
+					}
+				}
+				return ops;
+			});
+		}
+	}
+}
+
+
+void benchSearch(Results &results, SWModule *module) {
+	static const struct { int type; const char *name; const char *term; } searches[] = {
+		{ SWModule::SEARCHTYPE_REGEX, "regex", "[Ll]ight" },
+		{ SWModule::SEARCHTYPE_PHRASE, "phrase", "God said" },
+		{ SWModule::SEARCHTYPE_MULTIWORD, "multiword", "God light" },
+		{ SWModule::SEARCHTYPE_ENTRYATTR, "entryattr", "Word//Lemma./G2316" },
+		{ SWModule::SEARCHTYPE_EXTERNAL, "external", "God" },
+		{ 0, 0, 0 }
+	};
+
+	for (int i = 0; searches[i].name; ++i) {
+		bool supported = false;
+		module->search(searches[i].term, searches[i].type, 0, 0, &supported);
+		if (!supported) continue;
+		const char *term = searches[i].term;
+		int type = searches[i].type;
+		results.run("search", module, searches[i].name, [module, term, type]() {
+			module->search(term, type);
+			return (unsigned long)1;
+		});
+	}
+}
+
+
+void benchParse(Results &results) {
+	static const char *refs[] = {
+		"Gen 1:1", "John 3:16", "1 Cor 13:4-7", "Ps 23", "Rom 8:28; 12:1-2", "Mt 5:3-12,14",
+		"Isaiah 53", "Rev 22:21", "Jas 1:2-4; 1 Pet 1:3", "Luke 2:1-20", 0
+	};
+	VerseKey parser;
+	results.run("parse.verseList", 0, "", [&parser]() {
+		unsigned long ops = 0;
+		for (int pass = 0; pass < 100; ++pass) {
+			for (int i = 0; refs[i]; ++i) {
+				ListKey list = parser.parseVerseList(refs[i], "Gen 1:1", true);
+				++ops;
+			}
+		}
+		return ops;
+	});
+
+	VerseKey key;
+	results.run("parse.setText", 0, "", [&key]() {
+		unsigned long ops = 0;
+		for (int pass = 0; pass < 100; ++pass) {
+			for (int i = 0; refs[i]; ++i) {
+				key.setText(refs[i]);
+				++ops;
+			}
+		}
+		return ops;
+	});
+}
+
+// each set of UTF-8 kernels the CPU can run; "scalar" is how it was done before
+void benchUTF8(Results &results) {
+	static const char *kernelNames[] = { "avx2", "sse4.1", "neon", "scalar", 0 };
+	static const struct { const char *name; const char *text; } samples[] = {
+		{ "ascii", "In the beginning God created the heaven and the earth. " },
+		{ "greek", "\xe1\xbc\x98\xce\xbd \xe1\xbc\x80\xcf\x81\xcf\x87\xe1\xbf\x87 \xe1\xbc\xa6\xce\xbd \xe1\xbd\x81 \xce\xbb\xe1\xbd\xb9\xce\xb3\xce\xbf\xcf\x82 " },
+		{ "mixed", "<w lemma=\"strong:G3056\">\xce\xbb\xe1\xbd\xb9\xce\xb3\xce\xbf\xcf\x82</w> <note>word</note> " },
+		{ 0, 0 }
+	};
+
+	for (int s = 0; samples[s].name; ++s) {
+		SWBuf text;
+		while (text.length() < 64 * 1024) text += samples[s].text;
+		SWBuf wide = utf8ToWChar(text);
+
+		for (int k = 0; kernelNames[k]; ++k) {
+			if (!setUTF8Kernels(kernelNames[k])) continue;
+			SWBuf variant;
+			variant.appendFormatted("%s/%s", samples[s].name, kernelNames[k]);
+
+			results.run("utf8.validate", 0, variant, [&text]() {
+				SWBuf fixed;
+				for (int pass = 0; pass < 100; ++pass) assureValidUTF8(text.c_str(), fixed);
+				return (unsigned long)100;
+			});
+			results.run("utf8.toWChar", 0, variant, [&text]() {
+				for (int pass = 0; pass < 100; ++pass) utf8ToWChar(text.c_str());
+				return (unsigned long)100;
+			});
+			results.run("utf8.fromWChar", 0, variant, [&wide]() {
+				for (int pass = 0; pass < 100; ++pass) wcharToUTF8((const wchar_t *)wide.getRawData());
+				return (unsigned long)100;
+			});
+		}
+	}
+	setUTF8Kernels(0);
+}
+
+
+int main(int argc, char **argv) {
+	Results results;
+	const char *modulesPath = 0;
+	const char *outputPath = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "-p")) {
+			if (i + 1 >= argc) usage(*argv);
+			results.passes = atoi(argv[++i]);
+			if (results.passes < 1) usage(*argv);
+		}
+		else if (!strcmp(argv[i], "-o")) {
+			if (i + 1 >= argc) usage(*argv);
+			outputPath = argv[++i];
+		}
+		else if (argv[i][0] == '-' || modulesPath) usage(*argv);
+		else modulesPath = argv[i];
+	}
+	if (!modulesPath) usage(*argv);
+
+	// the first SWMgr in a process also loads locales and versifications
+	Clock::time_point start = Clock::now();
+	SWMgr *cold = new SWMgr(modulesPath);
+	results.add("startup.cold", "", 1, elapsed(start));
+	int moduleCount = (int)cold->getModules().size();
+	delete cold;
+	if (!moduleCount) {
+		fprintf(stderr, "%s: no modules found in %s\n", *argv, modulesPath);
+		exit(-2);
+	}
+
+	results.run("startup.warm", 0, "", [modulesPath]() {
+		SWMgr library(modulesPath);
+		return (unsigned long)1;
+	});
+
+	SWMgr library(modulesPath);
+	for (ModMap::iterator it = library.getModules().begin(); it != library.getModules().end(); ++it) {
+		benchLookup(results, it->second);
+	}
+	benchRender(results, modulesPath);
+	for (ModMap::iterator it = library.getModules().begin(); it != library.getModules().end(); ++it) {
+		if (SWDYNAMIC_CAST(VerseKey, it->second->getKey())) benchSearch(results, it->second);
+	}
+	benchParse(results);
+	benchUTF8(results);
+
+	FILE *out = (outputPath) ? fopen(outputPath, "w") : stdout;
+	if (!out) {
+		fprintf(stderr, "%s: couldn't write %s\n", *argv, outputPath);
+		exit(-3);
+	}
+	results.write(out);
+	if (outputPath) fclose(out);
+
+	return 0;
+}
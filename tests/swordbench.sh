@@ -0,0 +1,95 @@
+#!/bin/sh
+#******************************************************************************
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+
+#
+# Builds a small module for each driver from the testsuite's sources and
+# runs swordbench over them.
+#
+# usage: swordbench.sh <utilities dir> <swordbench> <testsuite dir> <work dir> [swordbench options]
+#
+
+if [ $# -lt 4 ]; then
+	echo "usage: $0 <utilities dir> <swordbench> <testsuite dir> <work dir> [swordbench options]" >&2
+	exit 1
+fi
+
+HERE=`pwd`
+UTILITIES=`cd "$1" && pwd`
+SWORDBENCH=`cd \`dirname "$2"\` && pwd`/`basename "$2"`
+TESTSUITE=`cd "$3" && pwd`
+WORK="$4"
+shift 4
+
+rm -rf "$WORK/mods.d" "$WORK/modules"
+mkdir -p "$WORK/mods.d" "$WORK/modules"
+WORK=`cd "$WORK" && pwd`
+
+# name, driver, data path, source type, and anything else the driver needs
+conf() {
+	cat > "$WORK/mods.d/$1.conf" <<!
+[$1]
+DataPath=$3
+ModDrv=$2
+Encoding=UTF-8
+SourceType=$4
+Lang=en
+$5
+!
+}
+
+OSISOPTIONS="GlobalOptionFilter=OSISStrongs
+GlobalOptionFilter=OSISMorph
+GlobalOptionFilter=OSISFootnotes
+GlobalOptionFilter=OSISHeadings
+GlobalOptionFilter=OSISRedLetterWords"
+ZOPTIONS="BlockType=BOOK
+CompressType=ZIP"
+
+build() {
+	"$@" > "$WORK/build.log" 2>&1 || { echo "$0: failed: $*" >&2; cat "$WORK/build.log" >&2; exit 1; }
+}
+
+cd "$WORK"
+mkdir -p modules/rawtext modules/rawtext4 modules/ztext modules/ztext4
+
+conf BenchRawText RawText ./modules/rawtext/ OSIS "$OSISOPTIONS"
+build "$UTILITIES/osis2mod" modules/rawtext/ "$TESTSUITE/osisReference.xml"
+conf BenchRawText4 RawText4 ./modules/rawtext4/ OSIS "$OSISOPTIONS"
+build "$UTILITIES/osis2mod" modules/rawtext4/ "$TESTSUITE/osisReference.xml" -s 4
+conf BenchzText zText ./modules/ztext/ OSIS "$OSISOPTIONS
+$ZOPTIONS"
+build "$UTILITIES/osis2mod" modules/ztext/ "$TESTSUITE/osisReference.xml" -z z
+conf BenchzText4 zText4 ./modules/ztext4/ OSIS "$OSISOPTIONS
+$ZOPTIONS"
+build "$UTILITIES/osis2mod" modules/ztext4/ "$TESTSUITE/osisReference.xml" -z z -s 4
+
+conf BenchRawLD RawLD ./modules/rawld Plain
+build "$UTILITIES/imp2ld" "$TESTSUITE/gbsReference.imp" -o modules/rawld
+conf BenchRawLD4 RawLD4 ./modules/rawld4 Plain
+build "$UTILITIES/imp2ld" "$TESTSUITE/gbsReference.imp" -4 -o modules/rawld4
+conf BenchzLD zLD ./modules/zld Plain "CompressType=ZIP"
+build "$UTILITIES/imp2ld" "$TESTSUITE/gbsReference.imp" -z z -o modules/zld
+
+conf BenchRawGenBook RawGenBook ./modules/rawgenbook Plain
+build "$UTILITIES/imp2gbs" "$TESTSUITE/gbsReference.imp" -o modules/rawgenbook
+
+rm -f build.log
+
+cd "$HERE" && exec "$SWORDBENCH" "$@" "$WORK"
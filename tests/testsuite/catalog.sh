@@ -0,0 +1,87 @@
+#!/bin/sh
+#******************************************************************************
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+
+# a repository of a few modules, with mods.d.tar.gz and a catalog, and a
+# library with some of them, older and newer, installed
+rm -rf tmp/catalog
+mkdir -p tmp/catalog/repo/mods.d tmp/catalog/installed/mods.d
+
+cat > tmp/catalog/repo/mods.d/kjv.conf <<!
+[KJV]
+DataPath=./modules/texts/ztext/kjv/
+ModDrv=zText
+Lang=en
+Version=2.0
+InstallSize=4300000
+Feature=StrongsNumbers
+!
+cat > tmp/catalog/repo/mods.d/web.conf <<!
+[WEB]
+DataPath=./modules/texts/ztext/web/
+ModDrv=zText
+Lang=en
+Version=1.1
+!
+cat > tmp/catalog/repo/mods.d/strongsgreek.conf <<!
+[StrongsGreek]
+DataPath=./modules/lexdict/rawld4/strongsgreek/
+ModDrv=RawLD4
+Lang=en
+Category=Lexicons / Dictionaries
+Version=1.2
+Feature=GreekDef
+Feature=GreekParse
+!
+cat > tmp/catalog/repo/mods.d/locked.conf <<!
+[Locked]
+DataPath=./modules/texts/ztext/locked/
+ModDrv=zText
+Lang=de
+CipherKey=
+!
+cat > tmp/catalog/repo/mods.d/helper.conf <<!
+[Helper]
+DataPath=./modules/genbook/rawgenbook/helper/helper
+ModDrv=RawGenBook
+Category=Utility
+!
+(cd tmp/catalog/repo && tar czf mods.d.tar.gz mods.d)
+../../utilities/mkcatalog tmp/catalog/repo
+
+cat > tmp/catalog/installed/mods.d/kjv.conf <<!
+[KJV]
+DataPath=./modules/texts/ztext/kjv/
+ModDrv=zText
+Version=1.5
+!
+cat > tmp/catalog/installed/mods.d/strongsgreek.conf <<!
+[StrongsGreek]
+DataPath=./modules/lexdict/rawld4/strongsgreek/
+ModDrv=RawLD4
+Version=1.4
+!
+cat > tmp/catalog/installed/mods.d/web.conf <<!
+[WEB]
+DataPath=./modules/texts/ztext/web/
+ModDrv=zText
+Version=1.1
+!
+
+../catalogtest tmp/catalog
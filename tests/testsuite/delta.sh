@@ -0,0 +1,45 @@
+#!/bin/sh
+#******************************************************************************
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+
+# builds two versions of a module, the second with one verse changed, and
+# has mkdelta describe the second for updates from the first
+rm -rf tmp/delta
+for v in 1 2; do
+	mkdir -p tmp/delta/v$v/mods.d
+	mkdir -p tmp/delta/v$v/modules/texts/ztext/osisreference
+	cat > tmp/delta/v$v/mods.d/osisreference.conf <<!
+[OSISReference]
+DataPath=./modules/texts/ztext/osisreference/
+ModDrv=zText
+Encoding=UTF-8
+BlockType=VERSE
+CompressType=ZIP
+SourceType=OSIS
+Lang=en
+!
+done
+sed 's/In the beginning/In the very beginning/' osisReference.xml > tmp/delta.xml
+../../utilities/osis2mod tmp/delta/v1/modules/texts/ztext/osisreference/ osisReference.xml -z z -b 2 > /dev/null 2>&1
+../../utilities/osis2mod tmp/delta/v2/modules/texts/ztext/osisreference/ tmp/delta.xml -z z -b 2 > /dev/null 2>&1
+rm tmp/delta.xml
+../../utilities/mkdelta tmp/delta/v2/modules/texts/ztext/osisreference
+(cd tmp/delta/v2 && tar czf mods.d.tar.gz mods.d)
+
+../deltatest tmp/delta
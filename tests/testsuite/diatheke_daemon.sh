@@ -0,0 +1,86 @@
+#!/bin/sh
+#******************************************************************************
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+
+# a diatheke daemon must answer queries, with whatever options they ask
+# for, just as diatheke run on its own does
+rm -rf tmp/diatheke_daemon/
+mkdir -p tmp/diatheke_daemon/mods.d
+mkdir -p tmp/diatheke_daemon/modules
+
+cat > tmp/diatheke_daemon/mods.d/osisreference.conf <<!
+[OSISReference]
+DataPath=./modules/
+ModDrv=zText
+Encoding=UTF-8
+BlockType=BOOK
+CompressType=ZIP
+SourceType=OSIS
+Lang=en
+GlobalOptionFilter=OSISLemma
+GlobalOptionFilter=OSISStrongs
+GlobalOptionFilter=OSISMorph
+GlobalOptionFilter=OSISFootnotes
+GlobalOptionFilter=OSISHeadings
+GlobalOptionFilter=OSISRedLetterWords
+Feature=StrongsNumbers
+!
+
+../../utilities/osis2mod tmp/diatheke_daemon/modules/ osisReference.xml -z > /dev/null 2>&1
+
+cd tmp/diatheke_daemon
+socket=`pwd`/daemon.sock
+../../../../utilities/diatheke/diatheke -D $socket &
+daemon=$!
+
+# wait for it to listen
+tries=0
+until ../../../../utilities/diatheke/diathekec -S $socket -b system -k localelist > /dev/null 2>&1; do
+	tries=$((tries + 1))
+	if [ $tries -gt 100 ]; then
+		echo "the daemon didn't start"
+		kill $daemon
+		exit 1
+	fi
+	sleep 0.1
+done
+
+query() {
+	echo "-- $*"
+	../../../../utilities/diatheke/diathekec -S $socket "$@" > daemon.out 2>&1
+	../../../../utilities/diatheke/diatheke "$@" > alone.out 2>&1
+	cat daemon.out
+	if ! cmp -s daemon.out alone.out; then
+		echo "DIFFERS from diatheke on its own:"
+		cat alone.out
+	fi
+}
+
+query -b OSISReference -f plain -k "Acts 2:19-20"
+query -b OSISReference -f plain -o n -k "Acts 2:19-20"
+query -b OSISReference -f plain -o fnmh -k "Acts 2:19-20"
+query -b OSISReference -f plain -o b -k "Acts 2:19-20"
+query -b OSISReference -f plain -o w -k "Matt 2:5"
+query -b OSISReference -f plain -k "Acts 2:19-20"
+query -b OSISReference -f RTF -o r -k "Acts 2:21"
+query -b OSISReference -s phrase -k "wonders"
+
+kill $daemon
+wait $daemon
+echo "-- stopped: $?"
@@ -0,0 +1,28 @@
+#!/bin/sh
+
+rm -rf tmp/entryattr/
+mkdir -p tmp/entryattr/mods.d
+mkdir -p tmp/entryattr/modules
+
+cat > tmp/entryattr/mods.d/osisreference.conf <<!
+[OSISReference]
+DataPath=./modules/
+ModDrv=zText
+Encoding=UTF-8
+BlockType=BOOK
+CompressType=ZIP
+SourceType=OSIS
+Lang=en
+GlobalOptionFilter=OSISLemma
+GlobalOptionFilter=OSISStrongs
+GlobalOptionFilter=OSISMorph
+GlobalOptionFilter=OSISFootnotes
+GlobalOptionFilter=OSISHeadings
+GlobalOptionFilter=OSISRedLetterWords
+Feature=StrongsNumbers
+!
+
+../../utilities/osis2mod tmp/entryattr/modules/ osisReference.xml -z 2>&1 | grep -v \$Rev | grep -v WARN
+
+cd tmp/entryattr
+../../../entryattrtest OSISReference "Word//Lemma" "Word//Lemma./G2316" "Word//Lemma./g2316" "Word//Lemma.1/H" "Word//Morph" "Footnote" "Word///G" "Word//Lemma./"
@@ -0,0 +1,46 @@
+#!/bin/sh
+#******************************************************************************
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+
+rm -rf tmp/entryattrstore/
+mkdir -p tmp/entryattrstore/mods.d
+mkdir -p tmp/entryattrstore/modules
+
+cat > tmp/entryattrstore/mods.d/osisreference.conf <<!
+[OSISReference]
+DataPath=./modules/
+ModDrv=zText
+Encoding=UTF-8
+BlockType=BOOK
+CompressType=ZIP
+SourceType=OSIS
+Lang=en
+GlobalOptionFilter=OSISLemma
+GlobalOptionFilter=OSISStrongs
+GlobalOptionFilter=OSISMorph
+GlobalOptionFilter=OSISFootnotes
+GlobalOptionFilter=OSISHeadings
+GlobalOptionFilter=OSISRedLetterWords
+Feature=StrongsNumbers
+!
+
+../../utilities/osis2mod tmp/entryattrstore/modules/ osisReference.xml -z 2>&1 | grep -v \$Rev | grep -v WARN
+
+cd tmp/entryattrstore
+../../../entryattrstoretest OSISReference
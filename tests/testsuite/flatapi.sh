@@ -0,0 +1,44 @@
+#!/bin/sh
+#******************************************************************************
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+
+rm -rf tmp/flatapi/
+mkdir -p tmp/flatapi/mods.d
+mkdir -p tmp/flatapi/modules
+
+cat > tmp/flatapi/mods.d/osisreference.conf <<!
+[OSISReference]
+DataPath=./modules/
+ModDrv=zText
+Encoding=UTF-8
+BlockType=BOOK
+CompressType=ZIP
+SourceType=OSIS
+Lang=en
+Version=1.2
+Feature=StrongsNumbers
+GlobalOptionFilter=OSISStrongs
+GlobalOptionFilter=OSISFootnotes
+GlobalOptionFilter=OSISHeadings
+!
+printf '[Section]\nKey=in\377valid\n' > tmp/flatapi/invalid.conf
+
+../../utilities/osis2mod tmp/flatapi/modules/ osisReference.xml -z > /dev/null 2>&1
+
+../flatapitest tmp/flatapi
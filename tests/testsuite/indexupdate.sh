@@ -0,0 +1,35 @@
+#!/bin/sh
+
+rm -rf tmp/indexupdate/
+mkdir -p tmp/indexupdate/mods.d
+mkdir -p tmp/indexupdate/modules/raw
+mkdir -p tmp/indexupdate/modules/z
+
+cat > tmp/indexupdate/mods.d/osisreference.conf <<!
+[RawReference]
+DataPath=./modules/raw/
+ModDrv=RawText
+Encoding=UTF-8
+SourceType=OSIS
+Lang=en
+GlobalOptionFilter=OSISStrongs
+Feature=StrongsNumbers
+
+[ZReference]
+DataPath=./modules/z/
+ModDrv=zText
+Encoding=UTF-8
+BlockType=BOOK
+CompressType=ZIP
+SourceType=OSIS
+Lang=en
+GlobalOptionFilter=OSISStrongs
+Feature=StrongsNumbers
+!
+
+../../utilities/osis2mod tmp/indexupdate/modules/raw/ osisReference.xml 2>&1 | grep -v \$Rev | grep -v WARN | grep -v SUCCESS | grep -v LINK
+../../utilities/osis2mod tmp/indexupdate/modules/z/ osisReference.xml -z 2>&1 | grep -v \$Rev | grep -v WARN | grep -v SUCCESS | grep -v LINK
+
+cd tmp/indexupdate
+../../../indexupdatetest RawReference
+../../../indexupdatetest ZReference
@@ -0,0 +1,83 @@
+#!/bin/sh
+#******************************************************************************
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+
+# mod2zmod compressing on several threads must write the same files as on
+# one, for a zText and a zLD, with LZSS and with ZIP
+rm -rf tmp/mod2zmod_threads/
+mkdir -p tmp/mod2zmod_threads/mods.d
+mkdir -p tmp/mod2zmod_threads/modules/text
+mkdir -p tmp/mod2zmod_threads/modules/dict
+
+cat > tmp/mod2zmod_threads/mods.d/text.conf <<!
+[Text]
+DataPath=./modules/text/
+ModDrv=RawText
+Encoding=UTF-8
+SourceType=OSIS
+Lang=en
+!
+
+cat > tmp/mod2zmod_threads/mods.d/dict.conf <<!
+[Dict]
+DataPath=./modules/dict/dict
+ModDrv=RawLD
+Encoding=UTF-8
+SourceType=Plain
+Lang=en
+!
+
+../../utilities/osis2mod tmp/mod2zmod_threads/modules/text/ osisReference.xml > /dev/null 2>&1
+
+# enough entries, of differing lengths, for many blocks
+i=1
+while [ $i -le 400 ]; do
+	echo "\$\$\$entry $i"
+	echo "Body of entry $i,"
+	j=0
+	while [ $j -lt $((i % 13)) ]; do
+		echo "which goes on for line $j of entry $i"
+		j=$((j + 1))
+	done
+	i=$((i + 1))
+done > tmp/mod2zmod_threads/dict.imp
+../../utilities/imp2ld tmp/mod2zmod_threads/dict.imp -o tmp/mod2zmod_threads/modules/dict/dict > /dev/null 2>&1
+
+cd tmp/mod2zmod_threads
+for module in Text Dict; do
+	for compress in 1 2; do
+		for threads in 1 4; do
+			# a zLD's data path names its files, not a directory
+			out=out/$module-$compress-$threads/
+			mkdir -p $out
+			if [ $module = Dict ]; then out=${out}dict; fi
+			../../../../utilities/mod2zmod -t $threads $module $out 2 $compress > /dev/null 2>&1
+		done
+		for file in out/$module-$compress-1/*; do
+			name=`basename $file`
+			if [ ! -s $file ]; then
+				echo "$module, compress type $compress, $name: empty"
+			elif cmp -s $file out/$module-$compress-4/$name; then
+				echo "$module, compress type $compress, $name: identical"
+			else
+				echo "$module, compress type $compress, $name: DIFFERS"
+			fi
+		done
+	done
+done
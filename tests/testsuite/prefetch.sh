@@ -0,0 +1,44 @@
+#!/bin/sh
+#******************************************************************************
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+
+# a zText in a block per verse, so reading runs across many blocks, once
+# compressed with ZIP and once with LZSS
+rm -rf tmp/prefetch/
+mkdir -p tmp/prefetch/mods.d
+
+for compress in ZIP LZSS; do
+	mkdir -p tmp/prefetch/modules/$compress
+	cat > tmp/prefetch/mods.d/$compress.conf <<!
+[$compress]
+DataPath=./modules/$compress/
+ModDrv=zText
+Encoding=UTF-8
+BlockType=VERSE
+CompressType=$compress
+SourceType=OSIS
+Lang=en
+!
+done
+
+../../utilities/osis2mod tmp/prefetch/modules/ZIP/ osisReference.xml -z z -b 2 > /dev/null 2>&1
+../../utilities/osis2mod tmp/prefetch/modules/LZSS/ osisReference.xml -z l -b 2 > /dev/null 2>&1
+
+cd tmp/prefetch
+../../../prefetchtest ZIP LZSS
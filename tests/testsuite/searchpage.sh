@@ -0,0 +1,32 @@
+#!/bin/sh
+
+rm -rf tmp/searchpage/
+mkdir -p tmp/searchpage/mods.d
+mkdir -p tmp/searchpage/modules
+
+cat > tmp/searchpage/mods.d/osisreference.conf <<!
+[OSISReference]
+DataPath=./modules/
+ModDrv=zText
+Encoding=UTF-8
+BlockType=BOOK
+CompressType=ZIP
+SourceType=OSIS
+Lang=en
+GlobalOptionFilter=OSISStrongs
+GlobalOptionFilter=OSISFootnotes
+GlobalOptionFilter=OSISHeadings
+!
+
+../../utilities/osis2mod tmp/searchpage/modules/ osisReference.xml -z > /dev/null 2>&1
+
+cd tmp/searchpage
+# phrase, multiword and regex, 2 hits a page
+../../../searchpagetest OSISReference -1 2 "God" "the"
+../../../searchpagetest OSISReference -2 1 "wilderness prison" "God said"
+../../../searchpagetest OSISReference 0 3 "[Ll]ight"
+# ignoring case
+../../../searchpagetest OSISReference -1i 2 "the KINGDOM of god"
+../../../searchpagetest OSISReference -2i 2 "god KINGDOM" "jesus GALILEE"
+# entry attributes, 1 hit a page
+../../../searchpagetest OSISReference -3 1 "Word//Lemma./G2316"
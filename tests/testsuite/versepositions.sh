@@ -0,0 +1,27 @@
+#!/bin/sh
+#******************************************************************************
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+
+# verses which map to other places, to headings, to ranges and nowhere
+../versepositiontest KJV Synodal Ps.3.1 Ps.23.1 Rom.16.25 Gen.0.0 Num.13.1
+../versepositiontest Synodal KJV Ps.3.2 Ps.3.1 3Macc.1.1 Rom.14.24
+../versepositiontest KJV Leningrad Mal.4.1 Gen.1.1 Matt.1.1
+
+# keys made from positions keep the locale and intros of the key they came from
+../versepositiontest -l de KJV Gen.0.0 Gen.1.0 Jas.1.19 Rev.22.21
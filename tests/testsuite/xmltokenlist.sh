@@ -0,0 +1,29 @@
+#!/bin/sh
+#******************************************************************************
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+
+# Just let it run the default
+../xmltokenlisttest
+
+# and what the filters see in the wild
+../xmltokenlisttest "plain text, no markup"
+../xmltokenlisttest "a > b <w gloss=\"x\"/> c"
+../xmltokenlisttest "<w gloss=\"x\">unclosed <w gloss=\"y\""
+../xmltokenlisttest "<w <w gloss=\"x\">restarted</w>"
+../xmltokenlisttest "<><w gloss=\"\">empty</w>"
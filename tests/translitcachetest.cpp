@@ -0,0 +1,108 @@
+/******************************************************************************
+ *
+ *  translitcachetest.cpp -	transliterates BMP and non-BMP text through
+ *				one UTF8Transliterator, and its cache, from two
+ *				threads, and checks it against a new filter for
+ *				each text
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <swthread.h>
+#include <utf8transliterator.h>
+
+using namespace std;
+using namespace sword;
+
+
+int failures = 0;
+
+void expect(bool ok, const char *what) {
+	cout << what << ": " << (ok ? "ok" : "FAILED") << "\n";
+	if (!ok) ++failures;
+}
+
+
+const char *texts[] = {
+	"\xE1\xBC\x90\xCE\xBD \xE1\xBC\x80\xCF\x81\xCF\x87\xE1\xBF\x87",	// Greek, en arche
+	"\xD7\x91\xD7\xA8\xD7\x90\xD7\xA9\xD7\x99\xD7\xAA",	// Hebrew, bereshit
+	"\xD0\x92 \xD0\xBD\xD0\xB0\xD1\x87\xD0\xB0\xD0\xBB\xD0\xB5",	// Cyrillic, v nachale
+	"\xF0\x90\x8C\xB2\xF0\x90\x8C\xBF\xF0\x90\x8C\xB8",	// Gothic, guth
+	"\xF0\x90\x8E\x80\xF0\x90\x8E\x81\xF0\x90\x8E\x82",	// Ugaritic
+	"\xF0\x90\x80\x80\xF0\x90\x80\x81",	// Linear B
+	"\xCE\xB8\xCE\xB5\xCF\x8C\xCF\x82 \xD0\x91\xD0\xBE\xD0\xB3 \xD7\x90\xD7\x9C",	// Greek, Cyrillic and Hebrew
+	"plain Latin",
+	0
+};
+
+
+// each text as a filter of its own, with nothing cached, renders it
+SWBuf uncached(const char *text) {
+	UTF8Transliterator filter;
+	filter.setOptionValue("Latin");
+	SWBuf result = text;
+	filter.processText(result);
+	return result;
+}
+
+
+struct Worker {
+	UTF8Transliterator *filter;
+	const vector<SWBuf> *expected;
+	int mismatches;
+};
+
+void work(void *userData) {
+	Worker *worker = (Worker *)userData;
+	for (int round = 0; round < 200; ++round) {
+		for (int i = 0; texts[i]; ++i) {
+			SWBuf result = texts[i];
+			worker->filter->processText(result);
+			if (result != (*worker->expected)[i]) ++worker->mismatches;
+		}
+	}
+}
+
+
+int main(int argc, char **argv) {
+	vector<SWBuf> expected;
+	for (int i = 0; texts[i]; ++i) {
+		expected.push_back(uncached(texts[i]));
+		cout << texts[i] << " -> " << expected.back() << "\n";
+	}
+
+	UTF8Transliterator shared;
+	shared.setOptionValue("Latin");
+
+	Worker workers[2];
+	SWThread threads[2];
+	for (int t = 0; t < 2; ++t) {
+		workers[t].filter = &shared;
+		workers[t].expected = &expected;
+		workers[t].mismatches = 0;
+		threads[t].start(work, &workers[t]);
+	}
+	for (int t = 0; t < 2; ++t) threads[t].join();
+
+	expect(!workers[0].mismatches && !workers[1].mismatches, "two threads sharing the cache match new filters");
+
+	return failures ? 1 : 0;
+}
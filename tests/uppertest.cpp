@@ -0,0 +1,205 @@
+/******************************************************************************
+ *
+ *  uppertest.cpp -	checks StringMgr's own upperUTF8, stricmpUTF8 and
+ *			stristrUTF8 against upper casing each codepoint by
+ *			the toUpperData pairs, on hand picked and random input
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <map>
+#include <string.h>
+
+#include <stringmgr.h>
+#include <swtoupperdata.h>
+#include <swbuf.h>
+
+using namespace sword;
+using namespace std;
+
+
+// the StringMgr used without ICU, whatever this library was built with
+class PlainStringMgr : public StringMgr {
+public:
+	PlainStringMgr() {}
+};
+
+
+map<SW_u32, SW_u32> upperOf;
+
+
+// how upperUTF8 always did it: a codepoint at a time, through a copy
+SWBuf referenceUpper(const char *text, unsigned int maxlen = 0) {
+	const unsigned char *from = (const unsigned char *)text;
+	SWBuf upper;
+	while (*from) {
+		SW_u32 ch = getUniCharFromUTF8(&from, true);
+		if (!ch) ch = 0xFFFD;
+		map<SW_u32, SW_u32>::const_iterator it = upperOf.find(ch);
+		getUTF8FromUniChar(it == upperOf.end() ? ch : it->second, &upper);
+	}
+	if (maxlen && upper.size() > maxlen - 1) upper.setSize(maxlen - 1);
+	return upper;
+}
+
+
+SWBuf escaped(const char *text) {
+	SWBuf retVal;
+	for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+		if (*c < 0x20 || *c > 0x7e) retVal.appendFormatted("\\x%02x", *c);
+		else retVal.append((char)*c);
+	}
+	return retVal;
+}
+
+
+unsigned long nextRandom(unsigned long &seed) {
+	seed = seed * 1103515245 + 12345;
+	return (seed / 65536) % 32768;
+}
+
+
+// mostly letters which have an upper case, and a little that isn't UTF-8
+SWBuf randomText(unsigned long &seed, int maxLen) {
+	static const unsigned char odd[] = { 0x80, 0xBF, 0xC0, 0xC3, 0xE0, 0xED, 0xF0, 0xF8, 0xFE, 0xFF };
+	SWBuf text;
+	int len = (int)(nextRandom(seed) % maxLen);
+	while ((int)text.length() < len) {
+		unsigned long r = nextRandom(seed) % 100;
+		if (r < 40) text.append((char)(1 + nextRandom(seed) % 0x7F));
+		else if (r < 80) getUTF8FromUniChar(toUpperData[nextRandom(seed) % (sizeof(toUpperData) / sizeof(toUpperData[0]))][nextRandom(seed) % 2], &text);
+		else if (r < 95) getUTF8FromUniChar(0x80 + (nextRandom(seed) * 32768 + nextRandom(seed)) % 0x10FF80, &text);
+		else text.append((char)odd[nextRandom(seed) % sizeof(odd)]);
+	}
+	return text;
+}
+
+
+int sign(int value) {
+	return (value > 0) - (value < 0);
+}
+
+
+// a piece of valid UTF-8 text, starting and ending on whole characters
+SWBuf pieceOf(const SWBuf &text, unsigned long &seed) {
+	if (!text.length()) return "";
+	unsigned long start = nextRandom(seed) % text.length();
+	unsigned long end = start + nextRandom(seed) % 8;
+	if (end > text.length()) end = text.length();
+	while (start < end && (text[start] & 0xC0) == 0x80) start++;
+	while (end < text.length() && (text[end] & 0xC0) == 0x80) end++;
+	SWBuf piece;
+	piece.append(text.c_str() + start, end - start);
+	return piece;
+}
+
+
+int check(StringMgr &mgr, const SWBuf &text, const SWBuf &other, unsigned long &seed) {
+	int wrong = 0;
+
+	static const unsigned int maxlens[] = { 0, 1, 2, 5, 16 };
+	for (unsigned int m = 0; m < sizeof(maxlens) / sizeof(maxlens[0]); m++) {
+		unsigned int maxlen = maxlens[m];
+		SWBuf buf;
+		buf.setSize(text.size() * 3 + 1);
+		strcpy(buf.getRawData(), text.c_str());
+		mgr.upperUTF8(buf.getRawData(), maxlen ? maxlen : (unsigned int)text.size() * 3);
+		if (strcmp(buf.c_str(), referenceUpper(text, maxlen ? maxlen : (unsigned int)text.size() * 3))) {
+			cout << "upperUTF8 wrong for " << escaped(text) << " (" << maxlen << "): " << escaped(buf) << "\n";
+			wrong++;
+		}
+	}
+
+	SWBuf upper = referenceUpper(text);
+	SWBuf otherUpper = referenceUpper(other);
+	if (sign(stricmpUTF8(text, other)) != sign(strcmp(upper, otherUpper))) {
+		cout << "stricmpUTF8 wrong for " << escaped(text) << ", " << escaped(other) << "\n";
+		wrong++;
+	}
+	if (stricmpUTF8(text, text.c_str())) {
+		cout << "stricmpUTF8 wrong for " << escaped(text) << " itself\n";
+		wrong++;
+	}
+
+	// a piece of the text, upper cased, or of the other text
+	SWBuf pattern = (nextRandom(seed) % 4) ? pieceOf(upper, seed) : pieceOf(other, seed);
+	const char *found = stristrUTF8(text, pattern);
+	const char *expected = strstr(upper, referenceUpper(pattern));
+	SWBuf before;
+	if (found) before.append(text.c_str(), found - text.c_str());
+	if (!found != !expected || (found && referenceUpper(before).length() != (unsigned long)(expected - upper.c_str()))) {
+		cout << "stristrUTF8 wrong for " << escaped(pattern) << " in " << escaped(text) << "\n";
+		wrong++;
+	}
+	return wrong;
+}
+
+
+int main(int argc, char **argv) {
+	for (unsigned int i = 0; i < sizeof(toUpperData) / sizeof(toUpperData[0]); i++) {
+		upperOf[toUpperData[i][0]] = toUpperData[i][1];
+	}
+
+	int wrong = 0;
+
+	// the generated tables say what the pairs say
+	for (SW_u32 ch = 0; ch < 0x10000; ch++) {
+		map<SW_u32, SW_u32>::const_iterator it = upperOf.find(ch);
+		if ((SW_u32)(ch + toUpperDelta[toUpperPage[ch >> 8]][ch & 0xff]) != (it == upperOf.end() ? ch : it->second)) {
+			cout << "tables wrong for " << ch << "\n";
+			wrong++;
+		}
+	}
+
+	PlainStringMgr mgr;
+	unsigned long seed = 1;
+
+	static const char *cases[] = {
+		"In the beginning God created",
+		"\xe1\xbc\x90\xce\xbd \xe1\xbc\x80\xcf\x81\xcf\x87\xe1\xbf\x87 \xe1\xbc\xa6\xce\xbd \xe1\xbd\x81 \xce\xbb\xe1\xbd\xb9\xce\xb3\xce\xbf\xcf\x82",	// Greek
+		"\xd0\xb2 \xd0\xbd\xd0\xb0\xd1\x87\xd0\xb0\xd0\xbb\xd0\xb5",	// Cyrillic
+		"d\xc4\xb1\xc5\x9f",	// dotless i upper cases to fewer bytes
+		"stray \x80 continuation",	// and the replacement character to more
+		"cut short \xc3",
+		"\xef\xbd\x81\xef\xbd\x82\xef\xbd\x83 fullwidth",
+		0
+	};
+	for (int i = 0; cases[i]; i++) {
+		SWBuf buf;
+		buf.setSize(strlen(cases[i]) * 3 + 1);
+		strcpy(buf.getRawData(), cases[i]);
+		mgr.upperUTF8(buf.getRawData(), (unsigned int)strlen(cases[i]) * 3);
+		cout << escaped(buf) << "\n";
+		wrong += check(mgr, cases[i], cases[(i + 1) % 7], seed);
+	}
+
+	cout << sign(stricmpUTF8("\xce\xb1\xce\xb2\xce\xb3", "\xce\x91\xce\x92\xce\x93")) << " "
+		<< sign(stricmpUTF8("abc", "ABD")) << " "
+		<< sign(stricmpUTF8("\xce\xb2", "\xce\x91")) << "\n";
+	const char *found = stristrUTF8("\xe1\xbc\x90\xce\xbd \xe1\xbc\x80\xcf\x81\xcf\x87\xe1\xbf\x87", "\xce\xa1\xcf\x87");
+	cout << (found ? escaped(found).c_str() : "(not found)") << "\n";
+
+	for (int i = 0; i < 20000; i++) {
+		SWBuf text = randomText(seed, 60);
+		wrong += check(mgr, text, randomText(seed, 60), seed);
+	}
+
+	cout << "mismatches: " << wrong << "\n";
+	return 0;
+}
@@ -0,0 +1,213 @@
+/******************************************************************************
+ *
+ *  utf8kerneltest.cpp -	checks the UTF-8 validation, ASCII scanning and
+ *			widening/narrowing each CPU's kernels do against
+ *			getUniCharFromUTF8, on hand picked and random input
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <utilstr.h>
+#include <swbuf.h>
+
+using namespace sword;
+using namespace std;
+
+
+const char *kernelNames[] = { "avx2", "sse4.1", "neon", "scalar", 0 };
+
+
+// what getUniCharFromUTF8 makes of it
+bool referenceValid(const SWBuf &text) {
+	const unsigned char *b = (const unsigned char *)text.c_str();
+	while (*b) {
+		if (!getUniCharFromUTF8(&b)) return false;
+	}
+	return true;
+}
+
+
+unsigned long referenceASCIILength(const SWBuf &text) {
+	unsigned long i = 0;
+	while (i < text.length() && !(text[i] & 0x80)) i++;
+	return i;
+}
+
+
+SWBuf escaped(const char *text) {
+	SWBuf retVal;
+	for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+		if (*c < 0x20 || *c > 0x7e) retVal.appendFormatted("\\x%02x", *c);
+		else retVal.append((char)*c);
+	}
+	return retVal;
+}
+
+
+unsigned long nextRandom(unsigned long &seed) {
+	seed = seed * 1103515245 + 12345;
+	return (seed / 65536) % 32768;
+}
+
+
+// mostly well formed, with a little of everything that isn't
+SWBuf randomText(unsigned long &seed) {
+	static const unsigned char odd[] = { 0x80, 0xBF, 0xC0, 0xC1, 0xC2, 0xDF, 0xE0, 0xED, 0xEF, 0xF0, 0xF4, 0xF5, 0xF8, 0xFE, 0xFF };
+	SWBuf text;
+	unsigned long len = nextRandom(seed) % 100;
+	while (text.length() < len) {
+		unsigned long r = nextRandom(seed) % 100;
+		if (r < 50) text.append((char)(1 + nextRandom(seed) % 0x7F));
+		else if (r < 90) {
+			SW_u32 ch;
+			switch (nextRandom(seed) % 4) {
+			case 0: ch = 0x80 + nextRandom(seed) % 0x780; break;
+			case 1: ch = 0x800 + nextRandom(seed) % 0xF800; break;
+			case 2: ch = 0x10000 + (nextRandom(seed) * 32768 + nextRandom(seed)) % 0x100000; break;
+			default: ch = 0xD800 + nextRandom(seed) % 0x800; break;	// surrogates, which count as valid
+			}
+			getUTF8FromUniChar(ch, &text);
+		}
+		else text.append((char)odd[nextRandom(seed) % sizeof(odd)]);
+	}
+	return text;
+}
+
+
+// checks one input against every kernel the CPU can run; returns how many disagreed
+int check(const SWBuf &text) {
+	int wrong = 0;
+	bool valid = referenceValid(text);
+	unsigned long ascii = referenceASCIILength(text);
+
+	for (int k = 0; kernelNames[k]; k++) {
+		if (!setUTF8Kernels(kernelNames[k])) continue;
+
+		if (isValidUTF8(text.c_str(), text.length()) != valid) {
+			cout << kernelNames[k] << ": isValidUTF8 wrong for " << escaped(text) << "\n";
+			wrong++;
+		}
+		if (getASCIILength(text.c_str(), text.length()) != ascii) {
+			cout << kernelNames[k] << ": getASCIILength wrong for " << escaped(text) << "\n";
+			wrong++;
+		}
+
+		vector<SW_u16> wide16(text.length() + 1);
+		vector<SW_u32> wide32(text.length() + 1);
+		SWBuf narrowed;
+		narrowed.setSize(text.length());
+		unsigned long w16 = widenASCII(text.c_str(), text.length(), &wide16[0]);
+		unsigned long w32 = widenASCII(text.c_str(), text.length(), &wide32[0]);
+		bool same = (w16 == ascii && w32 == ascii);
+		for (unsigned long i = 0; same && i < ascii; i++) {
+			same = (wide16[i] == (unsigned char)text[i] && wide32[i] == (unsigned char)text[i]);
+		}
+		// a code unit past the ASCII ones stops narrowing there
+		wide16[ascii] = 0x100;
+		wide32[ascii] = 0x10000;
+		if (narrowASCII(&wide16[0], ascii + 1, narrowed.getRawData()) != ascii || memcmp(narrowed.c_str(), text.c_str(), ascii)) same = false;
+		if (narrowASCII(&wide32[0], ascii + 1, narrowed.getRawData()) != ascii || memcmp(narrowed.c_str(), text.c_str(), ascii)) same = false;
+		if (!same) {
+			cout << kernelNames[k] << ": widenASCII/narrowASCII wrong for " << escaped(text) << "\n";
+			wrong++;
+		}
+	}
+	setUTF8Kernels(0);
+	return wrong;
+}
+
+
+int main(int argc, char **argv) {
+	static const char *cases[] = {
+		"plain ASCII",
+		"\xce\x95\xce\xbd \xe1\xbc\x80\xcf\x81\xcf\x87\xe1\xbf\x87",	// Greek
+		"\xd7\x91\xd6\xb0\xd6\xbc\xd7\xa8\xd6\xb5\xd7\x90\xd7\xa9\xd7\x81\xd7\x99\xd7\xaa",	// Hebrew, pointed
+		"\xf0\x9f\x98\x80 \xf4\x8f\xbf\xbf",	// 4 byte sequences, up to U+10FFFF
+		"\xed\xa0\x80 surrogate",
+		"stray \x80 continuation",
+		"overlong \xc0\xaf slash",
+		"overlong \xe0\x80\xaf slash",
+		"overlong \xf0\x80\x80\xaf slash",
+		"too large \xf4\x90\x80\x80",
+		"too large \xf5\x80\x80\x80",
+		"5 bytes \xf8\x88\x80\x80\x80",
+		"cut short \xe1\x80",
+		"cut short at the end \xe1",
+		"0123456789abcde\xce\x95 lead on a block edge",
+		"0123456789abcdefghijklmnopqrstu\xe1\xbc\x80 lead on a wide block edge",
+		"0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\xe1",
+		0
+	};
+
+	int wrong = 0;
+	for (int i = 0; cases[i]; i++) {
+		SWBuf fixed;
+		const char *checked = assureValidUTF8(cases[i], fixed);
+		cout << ((checked == cases[i]) ? "valid:   " : "fixed:   ") << escaped(checked) << "\n";
+		wrong += check(cases[i]);
+	}
+
+	// every length around the vector widths, with a bad byte at each place
+	for (unsigned long len = 1; len < 70; len++) {
+		for (unsigned long at = 0; at < len; at++) {
+			SWBuf text;
+			text.setSize(len);
+			memset(text.getRawData(), 'a', len);
+			text[at] = (char)0xC3;	// wants one continuation
+			wrong += check(text);
+			if (at + 1 < len) {
+				text[at + 1] = (char)0xA9;
+				wrong += check(text);
+			}
+		}
+	}
+
+	unsigned long seed = 1;
+	for (int i = 0; i < 20000; i++) {
+		wrong += check(randomText(seed));
+	}
+
+	// and each line of a file, e.g., UTF-8-test.txt
+	if (argc > 1) {
+		FILE *f = fopen(argv[1], "rb");
+		if (!f) {
+			cerr << "couldn't open " << argv[1] << "\n";
+			return -1;
+		}
+		SWBuf line;
+		int c;
+		while ((c = fgetc(f)) != EOF) {
+			if (c == '\n') {
+				wrong += check(line);
+				line = "";
+			}
+			else if (c) line.append((char)c);
+		}
+		wrong += check(line);
+		fclose(f);
+	}
+
+	cout << "mismatches: " << wrong << "\n";
+	return 0;
+}
@@ -58,6 +58,13 @@ int main(int argc, char **argv) {
 		cout << offset << ": " << book << ", " << chapter << ", " << verse << "\n";
 	}
 	
+	cout << "\nVersification Systems:";
+	StringList systems = vmgr->getVersificationSystems();
+	for (StringList::const_iterator it = systems.begin(); it != systems.end(); ++it) {
+		cout << " " << *it;
+	}
+	cout << "\n";
+
 	cout << endl;
 
 	return 0;
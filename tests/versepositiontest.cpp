@@ -0,0 +1,139 @@
+/******************************************************************************
+ *
+ *  versepositiontest.cpp -	maps verses between versification systems both as
+ *			VerseKeys and as VersePositions, so the two can be
+ *			compared, and keeps positions in a ListKey, whose
+ *			keys are made like the key the positions came from
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#include <versekey.h>
+#include <verseposition.h>
+#include <listkey.h>
+
+using namespace sword;
+using namespace std;
+
+
+// versepositiontest -l <locale> <v11n> <verse>...: positions from a key with
+// a locale and intros become keys which print as that key would
+int testLocale(int argc, char **argv) {
+	VerseKey from;
+	from.setVersificationSystem(argv[3]);
+	from.setIntros(true);
+	from.setLocale(argv[2]);
+
+	ListKey positions;
+	ListKey keys;
+	for (int i = 4; i < argc; ++i) {
+		from.setText(argv[i]);
+		positions.add(from.getVersePosition(), &from);
+		keys << from;
+	}
+	// and a range, which takes the first two verses
+	from.setText(argv[4]);
+	VersePosition range = from.getVersePosition();
+	range.end = range.index + 1;
+	positions.add(range, &from);
+	from.setLowerBound(from);
+	from++;
+	from.setUpperBound(from);
+	keys << from;
+
+	for (int i = 0; i < keys.getCount(); ++i) {
+		SWBuf viaPosition = positions.getElement(i)->getShortRangeText();
+		SWBuf viaKey = keys.getElement(i)->getShortRangeText();
+		cout << viaPosition << "; VerseKey: " << viaKey << " " << ((viaPosition == viaKey) ? "matches" : "DIFFERS") << "\n";
+	}
+	cout << "\n";
+
+	return 0;
+}
+
+
+int main(int argc, char **argv) {
+	if (argc < 4 || (!strcmp(argv[1], "-l") && argc < 5)) {
+		cerr << "usage: " << *argv << " <fromV11n> <toV11n> <verse>...\n";
+		cerr << "       " << *argv << " -l <locale> <v11n> <verse>...\n";
+		exit(-1);
+	}
+	if (!strcmp(argv[1], "-l")) return testLocale(argc, argv);
+
+	VerseKey from;
+	from.setVersificationSystem(argv[1]);
+	from.setIntros(true);
+	VerseKey to;
+	to.setVersificationSystem(argv[2]);
+	to.setIntros(true);
+
+	ListKey positions;
+	for (int i = 3; i < argc; ++i) {
+		from.setText(argv[i]);
+		VersePosition pos = from.getVersePosition();
+		positions.add(pos, &from);
+
+		to.positionFrom(from);
+		VersePosition mapped = pos.system->translateVerse(to.getVersePosition().system, pos);
+
+		cout << from.getOSISRef() << " (" << pos.index << ") -> ";
+		if (mapped.index < 0) cout << "[not in " << argv[2] << "]";
+		else {
+			VerseKey viaPosition(to);
+			viaPosition.setVersePosition(mapped);
+			cout << viaPosition.getOSISRef();
+			if (mapped.isRange()) {
+				viaPosition.setVersePosition(makeVersePosition(mapped.system, mapped.end));
+				cout << "-" << viaPosition.getOSISRef();
+			}
+		}
+		cout << "; VerseKey: " << to.getOSISRef() << " ";
+		cout << (((mapped.index < 0) || (to.getIndex() == mapped.index)) ? "matches" : "DIFFERS") << "\n";
+	}
+
+	// positions stay positions until they are visited
+	positions.sort();
+	cout << "sorted: " << positions.getShortRangeText() << "\n";
+	for (positions = TOP; !positions.popError(); positions++) {
+		cout << "\t" << positions.getText() << "\n";
+	}
+	VersePosition first;
+	if (positions.getVersePosition(first, 0)) cout << "first: " << first.index << "\n";
+
+	// and a range positions a module key like a bounded VerseKey
+	from.setText(argv[3]);
+	VersePosition range = from.getVersePosition();
+	range.end = range.index + 2;
+	VerseKey bounded(range);
+	cout << "range: " << bounded.getRangeText() << "\n";
+	for (bounded = TOP; !bounded.popError(); bounded++) {
+		cout << "\t" << bounded.getText() << "\n";
+	}
+	VersePosition mappedRange = range.system->translateVerse(to.getVersePosition().system, range);
+	if (mappedRange.index >= 0) {
+		VerseKey mappedKey(mappedRange);
+		cout << "mapped: " << mappedKey.getRangeText() << "\n";
+	}
+	cout << "\n";
+
+	return 0;
+}
@@ -0,0 +1,70 @@
+/******************************************************************************
+ *
+ *  xmltokenlisttest.cpp -	splits markup into an XMLTokenList, edits a few
+ *			tokens the way the OSIS word filters do, and joins
+ *			it back together
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <xmltokenlist.h>
+#include <utilxml.h>
+#include <swbuf.h>
+#include <iostream>
+
+using namespace sword;
+using namespace std;
+
+int main(int argc, char **argv) {
+
+	const char *xml = "<q who=\"Jesus\"><w lemma=\"strong:G3588\" morph=\"robinson:T-NSM\">The</w> <w gloss='word' lemma=\"strong:G3056\">Word</w></q>";
+	cout << ((argc > 1) ? argv[1]: xml) << "\n";
+
+	XMLTokenList tokens((argc > 1) ? argv[1] : xml);
+
+	SWBuf text;
+	tokens.getText(text);
+	cout << text << "\n";
+
+	for (int i = 0; i < tokens.getCount(); ++i) {
+		cout << " " << i << ((tokens.isTag(i)) ? " tag: [" : " text: [") << tokens.getTokenText(i) << "]\n";
+	}
+
+	// a tag edit, a text edit, and a tag edit on top of a text edit
+	for (int i = 0; i < tokens.getCount(); ++i) {
+		if (!tokens.isTag(i)) continue;
+		if (tokens.startsWith(i, "w ")) {
+			XMLTag &tag = tokens.getTag(i);
+			if (tag.getAttribute("gloss")) {
+				tag.setAttribute("gloss", 0);
+				tokens.tagChanged(i);
+			}
+		}
+		if (tokens.startsWith(i, "q ")) {
+			tokens.setTokenText(i, "q marker=\"\" who=\"Jesus\"");
+			XMLTag &tag = tokens.getTag(i);
+			tag.setAttribute("who", 0);
+			tokens.tagChanged(i);
+		}
+	}
+	tokens.getText(text);
+	cout << text << "\n";
+	tokens.getText(text, 1, tokens.getCount() - 1);
+	cout << text << "\n";
+	cout << "\n";
+}
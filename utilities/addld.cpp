@@ -102,7 +102,9 @@ int main(int argc, char **argv) {
       else infile = stdin;
       
       entrysize = fread(buffer, sizeof(char), sizeof(buffer), infile);
+      mod.beginBulkLoad();
       mod.setEntry(buffer, entrysize);	// save text to module at current position
+      mod.endBulkLoad();
     }
     else if (compress) {
 #ifndef EXCLUDEZLIB
@@ -122,7 +124,9 @@ int main(int argc, char **argv) {
       else infile = stdin;
       
       entrysize = fread(buffer, sizeof(char), sizeof(buffer), infile);
+      mod.beginBulkLoad();
       mod.setEntry(buffer, entrysize);	// save text to module at current position
+      mod.endBulkLoad();
 #else
       fprintf(stderr, "error: %s: SWORD library not built with ZIP compression support.\n", argv[0]);
       exit(-3);
@@ -145,7 +149,9 @@ int main(int argc, char **argv) {
       else infile = stdin;
       
       entrysize = fread(buffer, sizeof(char), sizeof(buffer), infile);
+      mod.beginBulkLoad();
       mod.setEntry(buffer, entrysize);	// save text to module at current position
+      mod.endBulkLoad();
     }
     
   }
@@ -160,7 +166,9 @@ int main(int argc, char **argv) {
       *key = argv[3];
 	 mod.setKey(*key);
       SWKey tmpkey = argv[4];
+      mod.beginBulkLoad();
       mod << &(tmpkey);
+      mod.endBulkLoad();
     }
     else if (compress) {
       zLD mod(argv[2]);	// open our datapath with our RawText driver.
@@ -171,7 +179,9 @@ int main(int argc, char **argv) {
 	 mod.setKey(*key);
       
       SWKey tmpkey = argv[4];
+      mod.beginBulkLoad();
       mod << &(tmpkey);
+      mod.endBulkLoad();
     }
     else {
       RawLD mod(argv[2]);	// open our datapath with our RawText driver.
@@ -182,7 +192,9 @@ int main(int argc, char **argv) {
 	 mod.setKey(*key);
       
       SWKey tmpkey = argv[4];
+      mod.beginBulkLoad();
       mod << &(tmpkey);
+      mod.endBulkLoad();
     }
   }
   else if ((mode == 'd') && argc == 4) {
@@ -37,8 +37,27 @@ using std::cout;
 using std::endl;
 using std::ostream;
 
-void systemquery(const char * key, ostream* output){
-	DiathekeMgr manager;
+
+namespace {
+	// a query sets the module's key, and -o i turns intros on in it;
+	// put the key back as it was, so a module a daemon keeps open starts
+	// each query the same (the global options are all set per query)
+	class ModuleKeyRestorer {
+		SWModule *module;
+		SWKey *saved;
+	public:
+		ModuleKeyRestorer(SWModule *module) : module(module), saved(module->getKey()->clone()) {
+			// so setKey() copies it, rather than keeping what we delete
+			saved->setPersist(false);
+		}
+		~ModuleKeyRestorer() {
+			module->setKey(saved);
+			delete saved;
+		}
+	};
+}
+
+void systemquery(DiathekeMgr &manager, const char * key, ostream* output){
 	ModMap::iterator it;
 
 	SWModule *target;
@@ -98,10 +117,241 @@ void systemquery(const char * key, ostream* output){
 }
 
 
+DiathekeQuery::DiathekeQuery() {
+	maxverses = -1;
+	outputformat = FMT_INTERNAL;
+	searchtype = ST_NONE;
+	outputencoding = ENC_UTF8;
+	optionfilters = OP_NONE;
+	variants = 0;
+	runquery = 0;
+}
+
+
+/******************************************************************************
+ * parsequery - fills query from diatheke command line arguments.  Shared by
+ *	the command line front end and the daemon, which receives the same
+ *	arguments one request per line.
+ *
+ * argc, argv	- arguments, not including the program name
+ * errors	- where to report a bad search type
+ *
+ * RET: PQ_OK, PQ_SYNTAX (caller should show usage) or PQ_BADSEARCH
+ */
+
+int parsequery(int argc, const char * const *argv, DiathekeQuery &query, ostream* errors) {
+	for (int i = 0; i < argc; ++i) {
+		if (!::stricmp("-b", argv[i])) {
+			if (i+1 < argc) {
+				++i;
+				query.text = argv[i];
+				query.runquery |= RQ_BOOK;
+			}
+		}
+		else if (!::stricmp("-s", argv[i])) {
+			if (i+1 < argc) {
+				++i;
+				if (!::stricmp("phrase", argv[i])) {
+					query.searchtype = ST_PHRASE;
+				}
+				else if (!::stricmp("regex", argv[i])) {
+					query.searchtype = ST_REGEX;
+				}
+				else if (!::stricmp("multiword", argv[i])) {
+					query.searchtype = ST_MULTIWORD;
+				}
+				else if (!::stricmp("lucene", argv[i])) {
+					query.searchtype = ST_CLUCENE;
+				}
+				else if (!::stricmp("attribute", argv[i])) {
+					query.searchtype = ST_ENTRYATTRIB;
+				}
+				else if (!::stricmp("multilemma", argv[i])) {
+					query.searchtype = ST_MULTILEMMA;
+				}
+				else {
+					*errors << "Unknown search_type: " << argv[i] << "\n";
+					*errors << "Try diatheke --help\n";
+					return PQ_BADSEARCH;
+				}
+			}
+		}
+ 		else if (!::stricmp("-r", argv[i])) {
+ 			if (i+1 < argc) {
+				++i;
+ 				query.range = argv[i];
+ 			}	
+ 		}
+		else if (!::stricmp("-l", argv[i])) {
+			if (i+1 < argc) {
+				++i;
+				query.locale = argv[i];
+			}
+		}
+		else if (!::stricmp("-m", argv[i])) {
+			if (i+1 < argc) {
+				++i;
+				query.maxverses = atoi(argv[i]);
+			}
+		}
+		else if (!::stricmp("-o", argv[i])) {
+			if (i+1 < argc) {
+				++i;
+				if (strchr(argv[i], 'f'))
+					query.optionfilters |= OP_FOOTNOTES;
+				if (strchr(argv[i], 'n'))
+					query.optionfilters |= OP_STRONGS;
+				if (strchr(argv[i], 'h'))
+					query.optionfilters |= OP_HEADINGS;
+				if (strchr(argv[i], 'm'))
+					query.optionfilters |= OP_MORPH;
+				if (strchr(argv[i], 'c'))
+					query.optionfilters |= OP_CANTILLATION;
+				if (strchr(argv[i], 'v'))
+					query.optionfilters |= OP_HEBREWPOINTS;
+				if (strchr(argv[i], 'a'))
+					query.optionfilters |= OP_GREEKACCENTS;
+				if (strchr(argv[i], 'l'))
+					query.optionfilters |= OP_LEMMAS;
+				if (strchr(argv[i], 's'))
+					query.optionfilters |= OP_SCRIPREF;
+				if (strchr(argv[i], 'r'))
+					query.optionfilters |= OP_ARSHAPE;
+				if (strchr(argv[i], 'b'))
+					query.optionfilters |= OP_BIDI;
+				if (strchr(argv[i], 'w'))
+					query.optionfilters |= OP_REDLETTERWORDS;
+				if (strchr(argv[i], 'p'))
+					query.optionfilters |= OP_ARABICPOINTS;
+				if (strchr(argv[i], 'g'))
+					query.optionfilters |= OP_GLOSSES;
+				if (strchr(argv[i], 'x'))
+					query.optionfilters |= OP_XLIT;
+				if (strchr(argv[i], 'e'))
+					query.optionfilters |= OP_ENUM;
+				if (strchr(argv[i], 'i'))
+					query.optionfilters |= OP_INTROS;
+				if (strchr(argv[i], 't'))
+					query.optionfilters |= OP_TRANSLITERATOR;
+				if (strchr(argv[i], 'M'))
+					query.optionfilters |= OP_MORPHSEG;
+			}
+		}
+		else if (!::stricmp("-f", argv[i])) {
+			if (i+1 < argc) {
+				++i;
+				if (!::stricmp("thml", argv[i])) {
+					query.outputformat = FMT_THML;
+				}
+				else if (!::stricmp("cgi", argv[i])) {
+					query.outputformat = FMT_CGI;
+				}
+				else if (!::stricmp("gbf", argv[i])) {
+					query.outputformat = FMT_GBF;
+				}
+				else if (!::stricmp("htmlhref", argv[i])) {
+					query.outputformat = FMT_HTMLHREF;
+				}
+				else if (!::stricmp("html", argv[i])) {
+					query.outputformat = FMT_HTML;
+				}
+				else if (!::stricmp("xhtml", argv[i])) {
+					query.outputformat = FMT_XHTML;
+				}
+				else if (!::stricmp("rtf", argv[i])) {
+					query.outputformat = FMT_RTF;
+				}
+				else if (!::stricmp("osis", argv[i])) {
+					query.outputformat = FMT_OSIS;
+				}
+				else if (!::stricmp("latex", argv[i])) {
+					query.outputformat = FMT_LATEX;
+				}
+				else if (!::stricmp("plain", argv[i])) {
+					query.outputformat = FMT_PLAIN;
+				}
+				else if (!::stricmp("webif", argv[i])) {
+					query.outputformat = FMT_WEBIF;
+				}
+				else if (!::stricmp("internal", argv[i])) {
+					query.outputformat = FMT_INTERNAL;
+				}
+			}
+		}
+		else if (!::stricmp("-e", argv[i])) {
+			if (i+1 < argc) {
+				++i;
+				if (!::stricmp("utf8", argv[i])) {
+					query.outputencoding = ENC_UTF8;
+				}
+				else if (!::stricmp("rtf", argv[i])) {
+					query.outputencoding = ENC_RTF;
+				}
+				else if (!::stricmp("html", argv[i])) {
+					query.outputencoding = ENC_HTML;
+				}
+				else if (!::stricmp("latin1", argv[i])) {
+					query.outputencoding = ENC_LATIN1;
+				}
+				else if (!::stricmp("utf16", argv[i])) {
+					query.outputencoding = ENC_UTF16;
+				}
+				else if (!::stricmp("scsu", argv[i])) {
+					query.outputencoding = ENC_SCSU;
+				}
+			}
+		}
+		else if (!::stricmp("-k", argv[i])) {
+			++i;	
+			if (i < argc) {
+				SWBuf key = argv[i];
+				++i;
+				for (; i < argc; ++i) {
+					if (!::stricmp("-h", argv[i]) || !::stricmp("--help", argv[i]))
+						return PQ_SYNTAX;
+					key = key + " " + argv[i];
+				}
+				query.ref = key;
+				if (query.ref.length())
+					query.runquery |= RQ_REF;
+			}
+		}
+		else if (!::stricmp("-v", argv[i])) {
+			if (i+1 < argc) {
+				++i;
+				query.variants = atoi(argv[i]);
+				query.optionfilters |= OP_VARIANTS;
+			}
+		}
+		/*
+		else if (!::stricmp("-t", argv[i])) {
+			if (i+1 < argc) {
+				++i;
+				script = argv[i];
+				optionfilters |= OP_TRANSLITERATOR;
+			}
+		}
+		*/
+		else {
+			// unexpected argument, so print the syntax
+			// -h, --help, /?, etc. will trigger this
+			return PQ_SYNTAX;
+		}
+	}
+	return PQ_OK;
+}
+
+
 void doquery(unsigned long maxverses = -1, unsigned char outputformat = FMT_PLAIN, unsigned char outputencoding = ENC_UTF8, unsigned long optionfilters = 0, unsigned char searchtype = ST_NONE, const char *range = 0, const char *text = 0, const char *locale = 0, const char *ref = 0, ostream* output = &cout, const char *script = 0, signed char variants = 0) {
 
 	static DiathekeMgr manager(NULL, NULL, false, outputencoding, outputformat, ((OP_BIDI & optionfilters) == OP_BIDI), ((OP_ARSHAPE & optionfilters) == OP_ARSHAPE));
 
+	doquery(manager, maxverses, outputformat, outputencoding, optionfilters, searchtype, range, text, locale, ref, output, script, variants);
+}
+
+
+void doquery(DiathekeMgr &manager, unsigned long maxverses, unsigned char outputformat, unsigned char outputencoding, unsigned long optionfilters, unsigned char searchtype, const char *range, const char *text, const char *locale, const char *ref, ostream* output, const char *script, signed char variants) {
+
 	ListKey listkey;
 	const char *DEFAULT_FONT = "Gentium";
 	SWModule *target;
@@ -123,14 +373,22 @@ void doquery(unsigned long maxverses = -1, unsigned char outputformat = FMT_PLAI
 	syslocale = SWBuf(locale);
 	syslocale.append(".en");
 	LocaleMgr *lom = LocaleMgr::getSystemLocaleMgr();
-	lom->setDefaultLocaleName(syslocale);
+	// the default locale is process wide; a warm daemon shares it between
+	// worker threads, so leave it alone unless it really changes
+	if (strcmp(lom->getDefaultLocaleName(), syslocale)) {
+		lom->setDefaultLocaleName(syslocale);
+	}
 	syslanguage = lom->translate(syslocale, "locales");
+
+	// a warm manager may have rendered the last query in another markup or encoding
+	manager.Markup(outputformat);
+	manager.setEncoding(outputencoding);
 	
 	
 	//deal with queries to "system"
 	if (!::stricmp(text, "system")) {
 		querytype = QT_SYSTEM;
-		systemquery(ref, output);
+		systemquery(manager, ref, output);
 	}
 	if (!strnicmp(text, "info", 4)) {
 	        querytype = QT_INFO;
@@ -139,6 +397,7 @@ void doquery(unsigned long maxverses = -1, unsigned char outputformat = FMT_PLAI
 	//otherwise, we have a real book
 	target = manager.getModule(text);
 	if (!target) return;
+	ModuleKeyRestorer restorer(target);
 
 	if (target->getLanguage()) {
 		modlocale = target->getLanguage();
@@ -69,9 +69,34 @@
 #define ST_CLUCENE 5 // -4
 #define ST_MULTILEMMA 6 // -5
 
+#define RQ_REF 1
+#define RQ_BOOK 2
+
+#define PQ_OK 0
+#define PQ_SYNTAX 1
+#define PQ_BADSEARCH 2
 
 
 using namespace std;
 
+// the parsed form of a single diatheke command line (or daemon request line)
+struct DiathekeQuery {
+	int maxverses;
+	unsigned char outputformat;
+	unsigned char searchtype;
+	unsigned char outputencoding;
+	unsigned long optionfilters;
+	SWBuf text;
+	SWBuf locale;
+	SWBuf ref;
+	SWBuf range;
+	signed short variants;
+	char runquery;	// RQ_* bits; a legal query needs (RQ_BOOK | RQ_REF)
+
+	DiathekeQuery();
+};
+
 int hasalpha (char * string);
+int parsequery(int argc, const char * const *argv, DiathekeQuery &query, ostream* errors);
 void doquery(unsigned long maxverses, unsigned char outputformat, unsigned char outputencoding, unsigned long optionfilters, unsigned char searchtype, const char *range, const char *text, const char *locale, const char *ref, ostream* output, const char* script, signed char variants); 
+void doquery(DiathekeMgr &manager, unsigned long maxverses, unsigned char outputformat, unsigned char outputencoding, unsigned long optionfilters, unsigned char searchtype, const char *range, const char *text, const char *locale, const char *ref, ostream* output, const char* script, signed char variants); 
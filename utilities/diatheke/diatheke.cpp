@@ -28,14 +28,14 @@
 #include "corediatheke.h"
 #include "diathekemgr.h"
 #include "diafiltmgr.h"
+#include "diathekeserver.h"
+#include "diathekeproto.h"
+#include <signal.h>
 #include <utilstr.h>
 #include <swversion.h>
 
 using std::cout;
 
-#define RQ_REF 1
-#define RQ_BOOK 2
-
 void printsyntax() { 
 	//if we got this far without exiting, something went wrong, so print syntax
 	fprintf (stderr, "Diatheke command-line SWORD frontend Version 4.8 (SWORD: %s)\n", SWVersion::currentVersion.getText());
@@ -46,6 +46,11 @@ void printsyntax() {
 	fprintf (stderr, "    [-o option_filters] [-m maximum_verses] [-f output_format]\n");
 	fprintf (stderr, "    [-e output_encoding] [-v variant#(-1=all|0|1)]\n");
 	fprintf (stderr, "    [-l locale] <-k query_key>\n");
+	fprintf (stderr, "        diatheke -D [socket_path] [-l locale]\n");
+	fprintf (stderr, "\n");
+	fprintf (stderr, "With -D diatheke runs as a daemon, keeping its modules loaded and answering\n");
+	fprintf (stderr, "  queries sent with diathekec on a Unix domain socket (default: $%s\n", DIATHEKE_SOCKET_ENV);
+	fprintf (stderr, "  or %s).\n", DIATHEKE_DEFAULT_SOCKET);
 	fprintf (stderr, "\n");
 	fprintf (stderr, "If <book> is \"system\" you may use these system keys: \"modulelist\",\n");
 	fprintf (stderr, "\"modulelistnames\", \"bibliography\", and \"localelist\".");
@@ -75,225 +80,60 @@ void printsyntax() {
 	fprintf (stderr, "  diatheke -b KJV -o fmnx -k Jn 3:16\n");
 	fprintf (stderr, "  diatheke -b WHNU -t Latin -o mn -k Mt 24\n");
 	fprintf (stderr, "  diatheke -b KJV -s phrase -r Mt -k love\n");
+	fprintf (stderr, "  diatheke -D /tmp/diatheke.sock &  diathekec -b KJV -k Jn 3:16\n");
 
 	exit(EXIT_FAILURE);
 }
 
-int main(int argc, char **argv)
-{
-	int maxverses = -1;
-	unsigned char outputformat = FMT_INTERNAL, searchtype = ST_NONE, outputencoding = ENC_UTF8;
-	unsigned long optionfilters = OP_NONE;
- 	char *text = 0, *locale = 0, *ref = 0, *range = 0;
-	char script[] = "Latin"; // for the moment, only this target script is supported
-	signed short variants = 0;
+DiathekeServer *daemonServer = 0;
+
+void stopdaemon(int) {
+	if (daemonServer) daemonServer->stop();
+}
+
+int rundaemon(int argc, char **argv) {
+	const char *socketPath = 0, *locale = 0;
 
-	char runquery = 0; // used to check that we have enough arguments to perform a legal query
-	// (a querytype & text = 1 and a ref = 2)
-	
 	for (int i = 1; i < argc; ++i) {
-		if (!::stricmp("-b", argv[i])) {
-			if (i+1 <= argc) {
-				++i;
-				text = argv[i];
-				runquery |= RQ_BOOK;
-			}
-		}
-		else if (!::stricmp("-s", argv[i])) {
-			if (i+1 <= argc) {
-				++i;
-				if (!::stricmp("phrase", argv[i])) {
-					searchtype = ST_PHRASE;
-				}
-				else if (!::stricmp("regex", argv[i])) {
-					searchtype = ST_REGEX;
-				}
-				else if (!::stricmp("multiword", argv[i])) {
-					searchtype = ST_MULTIWORD;
-				}
-				else if (!::stricmp("lucene", argv[i])) {
-					searchtype = ST_CLUCENE;
-				}
-				else if (!::stricmp("attribute", argv[i])) {
-					searchtype = ST_ENTRYATTRIB;
-				}
-				else if (!::stricmp("multilemma", argv[i])) {
-					searchtype = ST_MULTILEMMA;
-				}
-				else {
-					fprintf (stderr, "Unknown search_type: %s\n", argv[i]);
-					fprintf (stderr, "Try diatheke --help\n");
-					return 0;
-				}
-			}
-		}
- 		else if (!::stricmp("-r", argv[i])) {
- 			if (i+1 <= argc) {
-				++i;
- 				range = argv[i];
- 			}	
- 		}
-		else if (!::stricmp("-l", argv[i])) {
-			if (i+1 <= argc) {
-				++i;
-				locale = argv[i];
-			}
-		}
-		else if (!::stricmp("-m", argv[i])) {
-			if (i+1 <= argc) {
-				++i;
-				maxverses = atoi(argv[i]);
-			}
-		}
-		else if (!::stricmp("-o", argv[i])) {
-			if (i+1 <= argc) {
-				++i;
-				if (strchr(argv[i], 'f'))
-					optionfilters |= OP_FOOTNOTES;
-				if (strchr(argv[i], 'n'))
-					optionfilters |= OP_STRONGS;
-				if (strchr(argv[i], 'h'))
-					optionfilters |= OP_HEADINGS;
-				if (strchr(argv[i], 'm'))
-					optionfilters |= OP_MORPH;
-				if (strchr(argv[i], 'c'))
-					optionfilters |= OP_CANTILLATION;
-				if (strchr(argv[i], 'v'))
-					optionfilters |= OP_HEBREWPOINTS;
-				if (strchr(argv[i], 'a'))
-					optionfilters |= OP_GREEKACCENTS;
-				if (strchr(argv[i], 'l'))
-					optionfilters |= OP_LEMMAS;
-				if (strchr(argv[i], 's'))
-					optionfilters |= OP_SCRIPREF;
-				if (strchr(argv[i], 'r'))
-					optionfilters |= OP_ARSHAPE;
-				if (strchr(argv[i], 'b'))
-					optionfilters |= OP_BIDI;
-				if (strchr(argv[i], 'w'))
-					optionfilters |= OP_REDLETTERWORDS;
-				if (strchr(argv[i], 'p'))
-					optionfilters |= OP_ARABICPOINTS;
-				if (strchr(argv[i], 'g'))
-					optionfilters |= OP_GLOSSES;
-				if (strchr(argv[i], 'x'))
-					optionfilters |= OP_XLIT;
-				if (strchr(argv[i], 'e'))
-					optionfilters |= OP_ENUM;
-				if (strchr(argv[i], 'i'))
-					optionfilters |= OP_INTROS;
-				if (strchr(argv[i], 't'))
-					optionfilters |= OP_TRANSLITERATOR;
-				if (strchr(argv[i], 'M'))
-					optionfilters |= OP_MORPHSEG;
-			}
-		}
-		else if (!::stricmp("-f", argv[i])) {
-			if (i+1 <= argc) {
-				++i;
-				if (!::stricmp("thml", argv[i])) {
-					outputformat = FMT_THML;
-				}
-				else if (!::stricmp("cgi", argv[i])) {
-					outputformat = FMT_CGI;
-				}
-				else if (!::stricmp("gbf", argv[i])) {
-					outputformat = FMT_GBF;
-				}
-				else if (!::stricmp("htmlhref", argv[i])) {
-					outputformat = FMT_HTMLHREF;
-				}
-				else if (!::stricmp("html", argv[i])) {
-					outputformat = FMT_HTML;
-				}
-				else if (!::stricmp("xhtml", argv[i])) {
-					outputformat = FMT_XHTML;
-				}
-				else if (!::stricmp("rtf", argv[i])) {
-					outputformat = FMT_RTF;
-				}
-				else if (!::stricmp("osis", argv[i])) {
-					outputformat = FMT_OSIS;
-				}
-				else if (!::stricmp("latex", argv[i])) {
-					outputformat = FMT_LATEX;
-				}
-				else if (!::stricmp("plain", argv[i])) {
-					outputformat = FMT_PLAIN;
-				}
-				else if (!::stricmp("webif", argv[i])) {
-					outputformat = FMT_WEBIF;
-				}
-				else if (!::stricmp("internal", argv[i])) {
-					outputformat = FMT_INTERNAL;
-				}
-			}
-		}
-		else if (!::stricmp("-e", argv[i])) {
-			if (i+1 <= argc) {
-				++i;
-				if (!::stricmp("utf8", argv[i])) {
-					outputencoding = ENC_UTF8;
-				}
-				else if (!::stricmp("rtf", argv[i])) {
-					outputencoding = ENC_RTF;
-				}
-				else if (!::stricmp("html", argv[i])) {
-					outputencoding = ENC_HTML;
-				}
-				else if (!::stricmp("latin1", argv[i])) {
-					outputencoding = ENC_LATIN1;
-				}
-				else if (!::stricmp("utf16", argv[i])) {
-					outputencoding = ENC_UTF16;
-				}
-				else if (!::stricmp("scsu", argv[i])) {
-					outputencoding = ENC_SCSU;
-				}
-			}
+		if (!::stricmp("-D", argv[i])) {
+			if (i+1 < argc && *argv[i+1] != '-') socketPath = argv[++i];
 		}
-		else if (!::stricmp("-k", argv[i])) {
-			++i;	
-			if (i < argc) {
-				SWBuf key = argv[i];
-				++i;
-				for (; i < argc; ++i) {
-					if (!::stricmp("-h", argv[i]) || !::stricmp("--help", argv[i]))
-						printsyntax();
-					key = key + " " + argv[i];
-				}
-				ref = new char[key.length() + 1];
-				strcpy (ref, key.c_str());
-				if (strlen(ref))
-					runquery |= RQ_REF;
-			}
-		}
-		else if (!::stricmp("-v", argv[i])) {
-			if (i+1 <= argc) {
-				++i;
-				variants = atoi(argv[i]);
-				optionfilters |= OP_VARIANTS;
-			}
-		}
-		/*
-		else if (!::stricmp("-t", argv[i])) {
-			if (i+1 <= argc) {
-				++i;
-				script = argv[i];
-				optionfilters |= OP_TRANSLITERATOR;
-			}
-		}
-		*/
-		else {
-			// unexpected argument, so print the syntax
-			// -h, --help, /?, etc. will trigger this
-			printsyntax();
+		else if (!::stricmp("-l", argv[i]) && i+1 < argc) {
+			locale = argv[++i];
 		}
+		else printsyntax();
+	}
+
+	DiathekeServer server(diathekeSocketPath(socketPath), locale);
+	daemonServer = &server;
+	signal(SIGINT, stopdaemon);
+	signal(SIGTERM, stopdaemon);
+#ifndef _WIN32
+	signal(SIGPIPE, SIG_IGN);
+#endif
+	int retVal = server.run();
+	daemonServer = 0;
+	return retVal ? EXIT_FAILURE : 0;
+}
+
+int main(int argc, char **argv)
+{
+	char script[] = "Latin"; // for the moment, only this target script is supported
+
+	if (argc > 1 && !::stricmp("-D", argv[1])) {
+		return rundaemon(argc, argv);
+	}
+
+	DiathekeQuery query;
+	switch (parsequery(argc - 1, argv + 1, query, &std::cerr)) {
+	case PQ_SYNTAX: printsyntax(); break;
+	case PQ_BADSEARCH: return 0;
 	}
 	
-	
-	if (runquery == (RQ_BOOK | RQ_REF)) {
- 	    doquery(maxverses, outputformat, outputencoding, optionfilters, searchtype, range, text, locale, ref, &cout, script, variants);
+	if (query.runquery == (RQ_BOOK | RQ_REF)) {
+ 	    doquery(query.maxverses, query.outputformat, query.outputencoding, query.optionfilters, query.searchtype,
+			query.range.length() ? query.range.c_str() : 0, query.text, query.locale.length() ? query.locale.c_str() : 0,
+			query.ref, &cout, script, query.variants);
 	}
 	//if we got this far without exiting, something went wrong, so print syntax
 	else printsyntax();
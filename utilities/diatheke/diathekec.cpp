@@ -0,0 +1,77 @@
+/******************************************************************************
+ *
+ *  diathekec.cpp -	thin client for a diatheke daemon (diatheke -D).
+ *			Takes the same arguments as diatheke and prints the
+ *			same output, so it can replace it in scripts.
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "diathekeproto.h"
+
+
+void usage(const char *app) {
+	fprintf(stderr, "usage: %s [-S socket_path] <diatheke arguments>\n", app);
+	fprintf(stderr, "\tsends the query to a running diatheke daemon (diatheke -D)\n");
+	fprintf(stderr, "\tsocket_path defaults to $%s or %s\n", DIATHEKE_SOCKET_ENV, DIATHEKE_DEFAULT_SOCKET);
+	exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char **argv) {
+#ifdef _WIN32
+	fprintf(stderr, "%s: the diatheke daemon needs Unix domain sockets, which this platform lacks\n", argv[0]);
+	return EXIT_FAILURE;
+#else
+	const char *socketPath = 0;
+	int i = 1;
+	if (i + 1 < argc && !strcmp("-S", argv[i])) {
+		socketPath = argv[i+1];
+		i += 2;
+	}
+	if (i >= argc) usage(argv[0]);
+
+	SWBuf request;
+	for (; i < argc; ++i) {
+		diathekeQuoteArg(request, argv[i]);
+	}
+
+	socketPath = diathekeSocketPath(socketPath);
+	int fd = diathekeConnect(socketPath);
+	if (fd < 0) {
+		fprintf(stderr, "%s: cannot connect to diatheke daemon at %s\n", argv[0], socketPath);
+		return EXIT_FAILURE;
+	}
+
+	DiathekeReader reader(fd);
+	SWBuf response;
+	int status = diathekeTransact(fd, reader, request, response);
+	diathekeWriteAll(fd, "quit\n", 5);
+	close(fd);
+
+	if (status < 0) {
+		fprintf(stderr, "%s: lost connection to diatheke daemon\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	fwrite(response.c_str(), 1, response.length(), status ? stderr : stdout);
+	return status ? EXIT_FAILURE : 0;
+#endif
+}
@@ -0,0 +1,179 @@
+/******************************************************************************
+ *
+ *  diathekeload.cpp -	load test harness for the diatheke daemon.
+ *			Opens a number of concurrent connections, replays
+ *			request lines against the daemon and reports
+ *			throughput and latency percentiles.
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+#include "diathekeproto.h"
+
+using std::vector;
+
+
+void usage(const char *app) {
+	fprintf(stderr, "usage: %s [-S socket_path] [-c clients] [-n requests_per_client] [-q request_file] [-m module]\n", app);
+	fprintf(stderr, "\trequest_file holds one daemon request per line, e.g.\n");
+	fprintf(stderr, "\t\t-b KJV -f plain -k Jn 3:16\n");
+	fprintf(stderr, "\twithout one, a small mix of lookups and searches against module (def KJV) is used\n");
+	exit(EXIT_FAILURE);
+}
+
+
+#ifndef _WIN32
+
+struct ClientResult {
+	vector<double> latencies;	// milliseconds
+	int errors;
+	unsigned long bytes;
+	ClientResult() : errors(0), bytes(0) {}
+};
+
+
+void runClient(const char *socketPath, const vector<SWBuf> *requests, int count, int offset, ClientResult *result) {
+	int fd = diathekeConnect(socketPath);
+	if (fd < 0) {
+		result->errors = count;
+		return;
+	}
+	DiathekeReader reader(fd);
+	SWBuf response;
+	for (int i = 0; i < count; ++i) {
+		const SWBuf &request = (*requests)[(offset + i) % requests->size()];
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		int status = diathekeTransact(fd, reader, request, response);
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		if (status < 0) {
+			result->errors += count - i;
+			break;
+		}
+		if (status) ++result->errors;
+		result->latencies.push_back(elapsed.count());
+		result->bytes += response.length();
+	}
+	diathekeWriteAll(fd, "quit\n", 5);
+	close(fd);
+}
+
+
+double percentile(const vector<double> &sorted, double p) {
+	if (sorted.empty()) return 0;
+	size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+	return sorted[i];
+}
+
+#endif
+
+
+int main(int argc, char **argv) {
+#ifdef _WIN32
+	fprintf(stderr, "%s: the diatheke daemon needs Unix domain sockets, which this platform lacks\n", argv[0]);
+	return EXIT_FAILURE;
+#else
+	const char *socketPath = 0, *requestFile = 0, *module = "KJV";
+	int clients = 4, perClient = 100;
+
+	for (int i = 1; i < argc; ++i) {
+		if (i + 1 >= argc) usage(argv[0]);
+		if (!strcmp("-S", argv[i])) socketPath = argv[++i];
+		else if (!strcmp("-c", argv[i])) clients = atoi(argv[++i]);
+		else if (!strcmp("-n", argv[i])) perClient = atoi(argv[++i]);
+		else if (!strcmp("-q", argv[i])) requestFile = argv[++i];
+		else if (!strcmp("-m", argv[i])) module = argv[++i];
+		else usage(argv[0]);
+	}
+	if (clients < 1 || perClient < 1) usage(argv[0]);
+	socketPath = diathekeSocketPath(socketPath);
+
+	vector<SWBuf> requests;
+	if (requestFile) {
+		FILE *f = fopen(requestFile, "r");
+		if (!f) {
+			fprintf(stderr, "%s: cannot open %s\n", argv[0], requestFile);
+			return EXIT_FAILURE;
+		}
+		char line[4096];
+		while (fgets(line, sizeof(line), f)) {
+			SWBuf request = line;
+			request.trim();
+			if (request.length() && request[0] != '#') requests.push_back(request);
+		}
+		fclose(f);
+	}
+	else {
+		const char *defaults[] = {
+			"-f plain -k Jn 3:16",
+			"-f html -o fmnh -k Gen 1",
+			"-f plain -k Ps 119:1-40",
+			"-f osis -o n -k Rom 8",
+			"-s phrase -r Mt-Jn -k in the beginning",
+			"-s multiword -k faith hope love",
+			0
+		};
+		for (int i = 0; defaults[i]; ++i) {
+			SWBuf request;
+			diathekeQuoteArg(request, "-b");
+			diathekeQuoteArg(request, module);
+			request += ' ';
+			request += defaults[i];
+			requests.push_back(request);
+		}
+	}
+	if (requests.empty()) usage(argv[0]);
+
+	vector<ClientResult> results(clients);
+	vector<std::thread> threads;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < clients; ++i) {
+		threads.push_back(std::thread(runClient, socketPath, &requests, perClient, i, &results[i]));
+	}
+	for (vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it) {
+		it->join();
+	}
+	std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+	vector<double> all;
+	int errors = 0;
+	unsigned long bytes = 0;
+	for (vector<ClientResult>::iterator it = results.begin(); it != results.end(); ++it) {
+		all.insert(all.end(), it->latencies.begin(), it->latencies.end());
+		errors += it->errors;
+		bytes  += it->bytes;
+	}
+	std::sort(all.begin(), all.end());
+
+	printf("clients:      %d\n", clients);
+	printf("requests:     %lu (%d errors)\n", (unsigned long)all.size(), errors);
+	printf("wall time:    %.3f s\n", wall.count());
+	printf("throughput:   %.1f requests/s, %.1f KiB/s\n", all.size() / wall.count(), bytes / 1024.0 / wall.count());
+	printf("latency (ms): p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+			percentile(all, 0.50), percentile(all, 0.90), percentile(all, 0.99), all.size() ? all.back() : 0);
+
+	return errors ? EXIT_FAILURE : 0;
+#endif
+}
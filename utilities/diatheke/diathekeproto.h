@@ -0,0 +1,219 @@
+/******************************************************************************
+ *
+ *  diathekeproto.h -	wire protocol shared by the diatheke daemon, its
+ *			client and the load test harness
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+/******************************************************************************
+ * A request is one line holding the same arguments the diatheke command line
+ * takes (-b, -s, -r, -o, -f, -e, -m, -v, -k), separated by blanks.  Arguments
+ * containing blanks, quotes or backslashes are wrapped in double quotes with
+ * \" and \\ escapes.  The line "quit" closes the connection.
+ *
+ * Each request is answered by a header line "OK <bytes>" or "ERR <bytes>"
+ * followed by exactly <bytes> bytes of output, so a connection can carry any
+ * number of requests.
+ */
+
+#ifndef DIATHEKEPROTO_H
+#define DIATHEKEPROTO_H
+
+#include <vector>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include <swbuf.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#ifndef NO_SWORD_NAMESPACE
+using namespace sword;
+#endif
+
+#define DIATHEKE_DEFAULT_SOCKET "/tmp/diatheke.sock"
+#define DIATHEKE_SOCKET_ENV "DIATHEKE_SOCKET"
+
+
+inline const char *diathekeSocketPath(const char *path = 0) {
+	if (!path) path = getenv(DIATHEKE_SOCKET_ENV);
+	return (path && *path) ? path : DIATHEKE_DEFAULT_SOCKET;
+}
+
+
+// append one argument to a request line, quoting it when needed
+inline void diathekeQuoteArg(SWBuf &line, const char *arg) {
+	if (line.length()) line += ' ';
+	bool quote = !*arg || strpbrk(arg, " \t\"\\");
+	if (!quote) {
+		line += arg;
+		return;
+	}
+	line += '"';
+	for (; *arg; ++arg) {
+		if (*arg == '"' || *arg == '\\') line += '\\';
+		line += *arg;
+	}
+	line += '"';
+}
+
+
+// split a request line back into its arguments
+inline std::vector<SWBuf> diathekeSplitArgs(const char *line) {
+	std::vector<SWBuf> args;
+	const char *p = line;
+	while (*p) {
+		while (*p == ' ' || *p == '\t') ++p;
+		if (!*p) break;
+		SWBuf arg;
+		bool quoted = false;
+		for (; *p; ++p) {
+			if (quoted) {
+				if (*p == '\\' && p[1]) arg += *(++p);
+				else if (*p == '"') quoted = false;
+				else arg += *p;
+			}
+			else if (*p == '"') quoted = true;
+			else if (*p == ' ' || *p == '\t') break;
+			else arg += *p;
+		}
+		args.push_back(arg);
+	}
+	return args;
+}
+
+
+#ifndef _WIN32
+
+// write all of len bytes, retrying short writes; false on error
+inline bool diathekeWriteAll(int fd, const char *buf, size_t len) {
+	while (len) {
+		ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			return false;
+		}
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+
+/** Buffered line/block reader over a socket
+ */
+class DiathekeReader {
+	int fd;
+	char buf[4096];
+	size_t start, end;
+
+	bool fill() {
+		if (start == end) start = end = 0;
+		ssize_t n;
+		do {
+			n = recv(fd, buf + end, sizeof(buf) - end, 0);
+		} while (n < 0 && errno == EINTR);
+		if (n <= 0) return false;
+		end += n;
+		return true;
+	}
+
+public:
+	DiathekeReader(int fd) : fd(fd), start(0), end(0) {}
+
+	/** reads up to (not including) the next newline; a trailing \r is dropped
+	 * @return false on EOF or error before a complete line was read
+	 */
+	bool readLine(SWBuf &line) {
+		line = "";
+		for (;;) {
+			for (; start < end; ++start) {
+				if (buf[start] == '\n') {
+					++start;
+					if (line.length() && line[line.length()-1] == '\r') line.setSize(line.length()-1);
+					return true;
+				}
+				line += buf[start];
+			}
+			if (!fill()) return false;
+		}
+	}
+
+	/** reads exactly len bytes
+	 */
+	bool readBlock(SWBuf &block, unsigned long len) {
+		block = "";
+		while (block.length() < len) {
+			if (start == end && !fill()) return false;
+			unsigned long take = end - start;
+			if (take > len - block.length()) take = len - block.length();
+			// not append(), output may be UTF-16 and contain nulls
+			unsigned long have = block.length();
+			block.setSize(have + take);
+			memcpy(block.getRawData() + have, buf + start, take);
+			start += take;
+		}
+		return true;
+	}
+};
+
+
+// connect to the daemon listening on path; -1 on failure
+inline int diathekeConnect(const char *path) {
+	struct sockaddr_un addr;
+	if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) return -1;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr))) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+
+/** sends one request and reads its answer
+ * @return 0 for OK, 1 for ERR, -1 when the connection failed
+ */
+inline int diathekeTransact(int fd, DiathekeReader &reader, const SWBuf &request, SWBuf &response) {
+	SWBuf line = request;
+	line += '\n';
+	if (!diathekeWriteAll(fd, line.c_str(), line.length())) return -1;
+	SWBuf header;
+	if (!reader.readLine(header)) return -1;
+	int status;
+	if (!strncmp(header.c_str(), "OK ", 3)) status = 0;
+	else if (!strncmp(header.c_str(), "ERR ", 4)) status = 1;
+	else return -1;
+	unsigned long len = strtoul(header.c_str() + (status ? 4 : 3), 0, 10);
+	if (!reader.readBlock(response, len)) return -1;
+	return status;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,221 @@
+/******************************************************************************
+ *
+ *  diathekeserver.cpp -	DiathekeServer: keeps a warm DiathekeMgr and
+ *				answers diatheke queries over a local socket
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#include <sstream>
+#include <signal.h>
+
+#include "corediatheke.h"
+#include "diathekeserver.h"
+#include "diathekeproto.h"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/stat.h>
+#endif
+
+using std::vector;
+using std::ostringstream;
+
+
+namespace {
+	volatile sig_atomic_t stopRequested = 0;
+}
+
+
+DiathekeServer::DiathekeServer(const char *socketPath, const char *locale)
+		: socketPath(socketPath), locale(locale ? locale : "en") {
+
+	listenFD = -1;
+	for (int i = 0; i < 4; ++i) managers[i] = 0;
+}
+
+
+DiathekeServer::~DiathekeServer() {
+	for (int i = 0; i < 4; ++i) delete managers[i];
+}
+
+
+DiathekeMgr &DiathekeServer::getManager(bool bidi, bool shape) {
+	DiathekeMgr *&manager = managers[(bidi ? 1 : 0) | (shape ? 2 : 0)];
+	if (!manager) manager = new DiathekeMgr(NULL, NULL, false, ENC_UTF8, FMT_INTERNAL, bidi, shape);
+	return *manager;
+}
+
+
+void DiathekeServer::stop() {
+	stopRequested = 1;
+}
+
+
+#ifdef _WIN32
+
+int DiathekeServer::run() {
+	fprintf(stderr, "diatheke: daemon mode needs Unix domain sockets, which this platform lacks\n");
+	return -1;
+}
+
+bool DiathekeServer::serve(Client &client) { return false; }
+
+#else
+
+int DiathekeServer::run() {
+	struct sockaddr_un addr;
+	if (socketPath.length() >= sizeof(addr.sun_path)) {
+		fprintf(stderr, "diatheke: socket path too long: %s\n", socketPath.c_str());
+		return -1;
+	}
+
+	listenFD = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listenFD < 0) {
+		perror("diatheke: socket");
+		return -1;
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, socketPath.c_str());
+
+	// replace a socket left behind by a previous daemon, but only if nobody answers on it
+	int probe = diathekeConnect(socketPath);
+	if (probe >= 0) {
+		close(probe);
+		fprintf(stderr, "diatheke: a daemon is already listening on %s\n", socketPath.c_str());
+		close(listenFD);
+		return -1;
+	}
+	unlink(socketPath);
+
+	if (bind(listenFD, (struct sockaddr *)&addr, sizeof(addr)) || listen(listenFD, 64)) {
+		perror("diatheke: bind");
+		close(listenFD);
+		return -1;
+	}
+
+	// warm up: load configs, locales and modules once for the life of the daemon
+	SWBuf syslocale = locale;
+	syslocale.append(".en");
+	LocaleMgr::getSystemLocaleMgr()->setDefaultLocaleName(syslocale);
+	getManager(false, false);
+
+	vector<struct pollfd> polled;
+	while (!stopRequested) {
+		polled.resize(clients.size() + 1);
+		polled[0].fd = listenFD;
+		polled[0].events = POLLIN;
+		for (size_t i = 0; i < clients.size(); ++i) {
+			polled[i+1].fd = clients[i].fd;
+			polled[i+1].events = POLLIN;
+		}
+		// wake up now and then to notice stop()
+		if (poll(&polled[0], polled.size(), 250) <= 0) continue;
+
+		// clients first, as accepting one changes the list
+		for (size_t i = clients.size(); i > 0; --i) {
+			if (!polled[i].revents) continue;
+			if (!serve(clients[i-1])) {
+				close(clients[i-1].fd);
+				clients.erase(clients.begin() + (i-1));
+			}
+		}
+		if (polled[0].revents & POLLIN) {
+			Client client;
+			client.fd = accept(listenFD, 0, 0);
+			if (client.fd >= 0) clients.push_back(client);
+		}
+	}
+
+	for (vector<Client>::iterator it = clients.begin(); it != clients.end(); ++it) {
+		close(it->fd);
+	}
+	clients.clear();
+	close(listenFD);
+	unlink(socketPath);
+	return 0;
+}
+
+
+bool DiathekeServer::serve(Client &client) {
+	char buf[4096];
+	ssize_t got;
+	do {
+		got = recv(client.fd, buf, sizeof(buf), 0);
+	} while (got < 0 && errno == EINTR);
+	if (got <= 0) return false;
+	client.partial.append(buf, got);
+
+	const char *line = client.partial.c_str();
+	const char *newline;
+	SWBuf request, response;
+	while ((newline = strchr(line, '\n'))) {
+		request = "";
+		request.append(line, newline - line);
+		line = newline + 1;
+		request.trim();
+		if (!request.length()) continue;
+		if (request == "quit") return false;
+
+		bool ok;
+		answer(request, response, ok);
+
+		SWBuf header;
+		header.setFormatted("%s %lu\n", ok ? "OK" : "ERR", response.length());
+		if (!diathekeWriteAll(client.fd, header.c_str(), header.length())) return false;
+		if (!diathekeWriteAll(client.fd, response.c_str(), response.length())) return false;
+	}
+	client.partial = SWBuf(line);
+	return true;
+}
+
+#endif
+
+
+void DiathekeServer::answer(const SWBuf &request, SWBuf &response, bool &ok) {
+	vector<SWBuf> args = diathekeSplitArgs(request);
+	vector<const char *> argv;
+	for (vector<SWBuf>::iterator it = args.begin(); it != args.end(); ++it) {
+		argv.push_back(it->c_str());
+	}
+
+	ostringstream output;
+	DiathekeQuery query;
+	int status = parsequery((int)argv.size(), argv.size() ? &argv[0] : 0, query, &output);
+
+	ok = false;
+	if (status == PQ_SYNTAX || (status == PQ_OK && query.runquery != (RQ_BOOK | RQ_REF))) {
+		output << "usage: <-b module_name> [-s search_type] [-r search_range] [-o option_filters]\n"
+			"    [-m maximum_verses] [-f output_format] [-e output_encoding] [-v variant] <-k query_key>\n";
+	}
+	else if (status == PQ_OK && query.locale.length() && query.locale != locale) {
+		output << "the locale is fixed when the daemon starts (" << locale.c_str() << ")\n";
+	}
+	else if (status == PQ_OK) {
+		char script[] = "Latin";
+		DiathekeMgr &manager = getManager((query.optionfilters & OP_BIDI) == OP_BIDI, (query.optionfilters & OP_ARSHAPE) == OP_ARSHAPE);
+		doquery(manager, query.maxverses, query.outputformat, query.outputencoding, query.optionfilters, query.searchtype,
+				query.range.length() ? query.range.c_str() : 0, query.text, locale, query.ref, &output, script, query.variants);
+		ok = true;
+	}
+
+	const std::string &out = output.str();
+	response.setSize(out.size());
+	memcpy(response.getRawData(), out.data(), out.size());
+}
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *
+ *  diathekeserver.h -	DiathekeServer: keeps a warm DiathekeMgr and answers
+ *			diatheke queries over a local socket
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifndef DIATHEKESERVER_H
+#define DIATHEKESERVER_H
+
+#include <vector>
+
+#include <swbuf.h>
+
+#ifndef NO_SWORD_NAMESPACE
+using namespace sword;
+#endif
+
+class DiathekeMgr;
+
+/** Serves diatheke queries (see diathekeproto.h) on a Unix domain socket.
+ * The manager, its configs, locales and opened modules are created once and
+ * reused for every request; one manager is kept for each combination of
+ * the -o b and -o r options, since bidi reordering and Arabic shaping are
+ * render filters fixed when a manager loads its modules.  Queries are run one
+ * at a time on a single thread, as the library singletons (FileMgr,
+ * LocaleMgr) and the modules' current position are not thread safe; the
+ * connections are polled together, so an idle client doesn't hold up the
+ * others.
+ */
+class DiathekeServer {
+	SWBuf socketPath;
+	SWBuf locale;
+	int listenFD;
+
+	DiathekeMgr *managers[4];	// indexed by getManager()'s bidi and shape
+
+	// the manager for queries with these options, made on first use
+	DiathekeMgr &getManager(bool bidi, bool shape);
+
+	// a connection and what it has sent of a request not yet complete
+	struct Client {
+		int fd;
+		SWBuf partial;
+	};
+	std::vector<Client> clients;
+
+	// reads what a client has sent and answers each complete request;
+	// false once the connection should be closed
+	bool serve(Client &client);
+	void answer(const SWBuf &request, SWBuf &response, bool &ok);
+
+public:
+	/**
+	 * @param socketPath where to listen; an existing stale socket is replaced
+	 * @param locale interface locale; it is process wide, so it is fixed
+	 *	for the life of the server
+	 */
+	DiathekeServer(const char *socketPath, const char *locale = 0);
+	~DiathekeServer();
+
+	/** Binds the socket and serves until stop() is called
+	 * @return 0 on a clean shutdown, non-zero if the socket could not be set up
+	 */
+	int run();
+
+	/** Asks a running server to shut down.  Safe to call from a signal handler.
+	 */
+	void stop();
+};
+
+#endif
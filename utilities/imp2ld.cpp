@@ -153,7 +153,7 @@ int main(int argc, char **argv) {
 		exit(-2);
 	}
 
-	SWModule *mod = 0;
+	SWLD *mod = 0;
 	SWKey *key, *linkKey;
 
 	if (compType == "LZSS") {
@@ -204,8 +204,8 @@ int main(int argc, char **argv) {
 	}
 	else {
 		mod = (!fourByteSize)
-			? (SWModule *)new RawLD (outPath, 0, 0, 0, ENC_UNKNOWN, DIRECTION_LTR, FMT_UNKNOWN, 0, caseSensitive, strongsPadding)
-			: (SWModule *)new RawLD4(outPath, 0, 0, 0, ENC_UNKNOWN, DIRECTION_LTR, FMT_UNKNOWN, 0, caseSensitive, strongsPadding);
+			? (SWLD *)new RawLD (outPath, 0, 0, 0, ENC_UNKNOWN, DIRECTION_LTR, FMT_UNKNOWN, 0, caseSensitive, strongsPadding)
+			: (SWLD *)new RawLD4(outPath, 0, 0, 0, ENC_UNKNOWN, DIRECTION_LTR, FMT_UNKNOWN, 0, caseSensitive, strongsPadding);
 	}
 
 
@@ -216,6 +216,9 @@ int main(int argc, char **argv) {
 	key->setPersist(true);
 	mod->setKey(key);
 
+	// entries come in file order; sort the index once at the end
+	mod->beginBulkLoad();
+
 	while (!infile.eof()) {
 		std::getline(infile, linebuffer);
 		if (linebuffer.size() > 3 && linebuffer.substr(0,3) == "$$$") {
@@ -261,6 +264,7 @@ int main(int argc, char **argv) {
 
 	infile.close();
 
+	mod->endBulkLoad();
 	delete linkKey;
 	delete mod;
 	delete key;
@@ -0,0 +1,64 @@
+/******************************************************************************
+ *
+ *  mkcatalog.cpp -	writes the catalog (mods.d.cat) of a repository's
+ *			mods.d directory, which lets InstallMgr refresh the
+ *			repository by fetching only the .conf files which
+ *			changed; run in a repository after each change to mods.d
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifdef _MSC_VER
+	#pragma warning( disable: 4251 )
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <modcatalog.h>
+#include <swbuf.h>
+
+#ifndef NO_SWORD_NAMESPACE
+using sword::ModuleCatalog;
+using sword::SWBuf;
+#endif
+
+
+int main(int argc, char **argv)
+{
+	if (argc != 2) {
+		fprintf(stderr, "usage: %s <repository directory>\n", argv[0]);
+		fprintf(stderr, "\twrites <repository directory>/%s from the .conf files in\n", ModuleCatalog::FILENAME);
+		fprintf(stderr, "\t<repository directory>/mods.d\n");
+		exit(-1);
+	}
+
+	SWBuf root = argv[1];
+	if (!root.endsWith("/") && !root.endsWith("\\")) root += "/";
+
+	ModuleCatalog catalog;
+	if (catalog.build(root + "mods.d")) {
+		fprintf(stderr, "%s: couldn't read %smods.d\n", *argv, root.c_str());
+		exit(-2);
+	}
+	if (catalog.save(root + ModuleCatalog::FILENAME)) {
+		fprintf(stderr, "%s: couldn't write %s%s (permissions?)\n", *argv, root.c_str(), ModuleCatalog::FILENAME);
+		exit(-2);
+	}
+	printf("%d modules\n", (int)catalog.getEntries().size());
+	return 0;
+}
@@ -0,0 +1,59 @@
+/******************************************************************************
+ *
+ *  mkdelta.cpp -	writes the block checksums of a module's data files
+ *			(delta.conf) which let installed copies of the module
+ *			be updated by fetching only the blocks which changed;
+ *			run in a repository after each new version of a module
+ *
+ * $Id$
+ *
+ * Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+ *	CrossWire Bible Society
+ *	P. O. Box 2528
+ *	Tempe, AZ  85280-2528
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ */
+
+#ifdef _MSC_VER
+	#pragma warning( disable: 4251 )
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <moddelta.h>
+
+#ifndef NO_SWORD_NAMESPACE
+using sword::ModuleDelta;
+#endif
+
+
+int main(int argc, char **argv)
+{
+	if (argc < 2 || argc > 3) {
+		fprintf(stderr, "usage: %s <module data directory> [chunk size]\n", argv[0]);
+		fprintf(stderr, "\twrites <module data directory>/%s; files without an index are\n", ModuleDelta::MANIFEST);
+		fprintf(stderr, "\tcut into blocks of chunk size bytes (default %lu)\n", ModuleDelta::DEFAULT_CHUNK_SIZE);
+		exit(-1);
+	}
+
+	unsigned long chunkSize = (argc > 2) ? strtoul(argv[2], 0, 10) : ModuleDelta::DEFAULT_CHUNK_SIZE;
+	if (!chunkSize) {
+		fprintf(stderr, "%s: chunk size must be a number of bytes\n", *argv);
+		exit(-1);
+	}
+
+	if (ModuleDelta::createManifest(argv[1], chunkSize)) {
+		fprintf(stderr, "%s: couldn't write %s in %s (no such directory, or permissions?)\n", *argv, ModuleDelta::MANIFEST, argv[1]);
+		exit(-2);
+	}
+	return 0;
+}
@@ -78,15 +78,26 @@ int main(int argc, char **argv)
 	}
 	target = it->second;
 
+	char lineLen = 70;
 	if (!target->hasSearchFramework()) {
-		fprintf(stderr, "%s: error: %s does not support a search framework.\n", *argv, it->second->getName());
-		exit(-2);
+		// we can still spare entry attribute searches from rendering every entry
+		printf("No search framework compiled in; building entry attribute index only, please wait...\n");
+		printf("[0=================================50==============================100]\n ");
+		char error = target->createEntryAttributeIndex(&percentUpdate, &lineLen);
+		printf("\n");
+		if (error > 0) {
+			fprintf(stderr, "%s: error: %s does not support a search framework.\n", *argv, it->second->getName());
+			exit(-2);
+		}
+		if (error) {
+			fprintf(stderr, "%s: couldn't create entry attribute index (permissions?)\n", *argv);
+		}
+		return 0;
 	}
 
 	printf("Deleting any existing framework...\n");
 	target->deleteSearchFramework();
 	printf("Building framework, please wait...\n");
-	char lineLen = 70;
 	printf("[0=================================50==============================100]\n ");
 	char error = target->createSearchFramework(&percentUpdate, &lineLen);
 	if (error) {
@@ -55,6 +55,7 @@
 #include <versekey.h>
 #include <stdio.h>
 #include <cipherfil.h>
+#include <blockwriter.h>
 
 #ifndef NO_SWORD_NAMESPACE
 using namespace sword;
@@ -67,7 +68,8 @@ using std::cout;
 void errorOutHelp(char *appName) {
 	cerr << appName << " - a tool to create compressed Sword modules\n";
 	cerr << "version 0.1\n\n";
-	cerr << "usage: "<< appName << " <modname> <datapath> [blockType [compressType [compressLevel [cipherKey]]]]\n\n";
+	cerr << "usage: "<< appName << " [-t threads] <modname> <datapath> [blockType [compressType [compressLevel [cipherKey]]]]\n\n";
+	cerr << "-t threads: how many blocks to compress at once (default 1)\n";
 	cerr << "datapath: the directory in which to write the zModule\n";
 	cerr << "blockType  : (default 4)\n\t2 - verses\n\t3 - chapters\n\t4 - books\n";
 	cerr << "compressType: (default 1):\n\t1 - LZSS\n\t2 - Zip\n\t3 - bzip2\n\t4 - xz\n";
@@ -87,6 +89,15 @@ int main(int argc, char **argv)
 	SWModule *outModule    = 0;
 	int compLevel = 0;
 
+	if (argc > 2 && !strcmp(argv[1], "-t")) {
+		int threads = atoi(argv[2]);
+		if (threads < 1) errorOutHelp(argv[0]);
+		BlockWriter::setThreads(threads);
+		argv[2] = argv[0];
+		argv += 2;
+		argc -= 2;
+	}
+
 	if ((argc < 3) || (argc > 7)) {
 		errorOutHelp(argv[0]);
 	}
@@ -59,6 +59,7 @@
 #include <xzcomprs.h>
 #endif
 #include <cipherfil.h>
+#include <blockwriter.h>
 
 #ifdef _ICU_
 #include <utf8nfc.h>
@@ -1770,6 +1771,7 @@ void usage(const char *app, const char *error = 0, const bool verboseHelp = fals
 	fprintf(stderr, "\t\t\t\t 2 - verse; 3 - chapter; 4 - book\n");
 	fprintf(stderr, "  -l <1-9>\t\t compression level (default varies by compression type)\n");
 	fprintf(stderr, "  -c <cipher_key>\t encipher a compressed module using supplied key\n");
+	fprintf(stderr, "  -t <threads>\t\t compress this many blocks at once (default: 1)\n");
 	fprintf(stderr, "\t\t\t\t (default no enciphering)\n");
 
 #ifdef _ICU_
@@ -2669,6 +2671,16 @@ int main(int argc, char **argv) {
 		else if (!strcmp(argv[i], "-C")) {
 			isCommentary = true;
 		}
+		else if (!strcmp(argv[i], "-t")) {
+			if (i+1 < argc) {
+				int threads = atoi(argv[++i]);
+				if (threads > 0) {
+					BlockWriter::setThreads(threads);
+					continue;
+				}
+			}
+			usage(*argv, "-t requires a number of threads");
+		}
 		else if (!strcmp(argv[i], "-d")) {
 			if (i+1 < argc) debug |= atoi(argv[++i]);
 			else usage(*argv, "-d requires <flags>");
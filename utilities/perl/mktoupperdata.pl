@@ -0,0 +1,89 @@
+#!/usr/bin/perl
+#******************************************************************************
+#
+#  mktoupperdata.pl -	regenerates the lookup tables at the end of
+#			include/swtoupperdata.h from the toUpperData pairs
+#			above them.  Run it after changing those pairs.
+#
+# $Id$
+#
+# Copyright 2026 CrossWire Bible Society (http://www.crosswire.org)
+#	CrossWire Bible Society
+#	P. O. Box 2528
+#	Tempe, AZ  85280-2528
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation version 2.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# usage: mktoupperdata.pl [include/swtoupperdata.h]
+#
+
+use strict;
+
+my $file = $ARGV[0] || 'include/swtoupperdata.h';
+my $marker = '// generated by utilities/perl/mktoupperdata.pl';
+
+open(my $in, '<', $file) or die "couldn't read $file: $!\n";
+my @lines = <$in>;
+close($in);
+
+# everything up to the tables, which we write anew
+my @head;
+foreach (@lines) {
+	last if (index($_, $marker) == 0);
+	push(@head, $_);
+}
+pop(@head) while (@head && $head[-1] =~ /^\s*$/);
+pop(@head) while (@head && $head[-1] =~ /^(\s*$|SWORD_NAMESPACE_END|#endif)/);
+pop(@head) while (@head && $head[-1] =~ /^\s*$/);
+
+my %upper;
+foreach (@head) {
+	if (/\{\s*0x([0-9A-Fa-f]+),\s*0x([0-9A-Fa-f]+)\s*\}/) {
+		my ($lower, $up) = (hex($1), hex($2));
+		die sprintf("U+%04X is mapped twice\n", $lower) if (exists($upper{$lower}));
+		die sprintf("U+%04X is outside the tables\n", $lower) if ($lower > 0xFFFF);
+		my $delta = $up - $lower;
+		die sprintf("U+%04X maps too far\n", $lower) if ($delta < -32768 || $delta > 32767);
+		$upper{$lower} = $up;
+	}
+}
+die "no toUpperData pairs found in $file\n" unless (%upper);
+
+# page 0 of the deltas is all zeros, for every block nothing in changes
+my @pageOf = (0) x 256;
+my @pages = ([ (0) x 256 ]);
+foreach my $block (0 .. 255) {
+	my @deltas = map { exists($upper{$block * 256 + $_}) ? $upper{$block * 256 + $_} - ($block * 256 + $_) : 0 } (0 .. 255);
+	next unless (grep { $_ } @deltas);
+	$pageOf[$block] = scalar(@pages);
+	push(@pages, \@deltas);
+}
+die "too many pages\n" if (@pages > 256);
+
+open(my $out, '>', $file) or die "couldn't write $file: $!\n";
+print $out @head;
+print $out "\n\n$marker from toUpperData; don't edit.\n";
+print $out "// A codepoint ch below 0x10000 upper cases to\n";
+print $out "// ch + toUpperDelta[toUpperPage[ch >> 8]][ch & 0xff]\n";
+print $out "static const unsigned char toUpperPage[256] = {\n";
+foreach my $row (0 .. 15) {
+	print $out "\t" . join(', ', @pageOf[$row * 16 .. $row * 16 + 15]) . ",\n";
+}
+print $out "};\n\n";
+printf $out "static const short toUpperDelta[%d][256] = {\n", scalar(@pages);
+foreach my $page (@pages) {
+	print $out "\t{\n";
+	foreach my $row (0 .. 15) {
+		print $out "\t\t" . join(', ', @{$page}[$row * 16 .. $row * 16 + 15]) . ",\n";
+	}
+	print $out "\t},\n";
+}
+print $out "};\n\n\nSWORD_NAMESPACE_END\n#endif\n";
+close($out);
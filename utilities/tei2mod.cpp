@@ -541,6 +541,9 @@ int main(int argc, char **argv) {
 
 	(*module) = TOP;
 
+	// entries come in document order; sort the index once at the end
+	module->beginBulkLoad();
+
 	SWBuf token;
 	SWBuf text;
 	bool intoken = false;
@@ -587,6 +590,7 @@ int main(int argc, char **argv) {
 	//text = "";
 	//writeEntry(*currentKey, text);
 
+	module->endBulkLoad();
 	delete module;
 	delete currentKey;
 	if (cipherFilter)